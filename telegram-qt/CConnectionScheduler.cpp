@@ -0,0 +1,124 @@
+/*
+   Copyright (C) 2014-2015 Alexandr Akulich <akulichalexander@gmail.com>
+
+   This file is a part of TelegramQt library.
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+ */
+#include "CConnectionScheduler.hpp"
+
+#include "CTelegramConnection.hpp"
+#include "Utils.hpp"
+
+#include <QMetaObject>
+#include <QMutexLocker>
+
+CConnectionScheduler::CConnectionScheduler() :
+    m_maximumAttempts(DefaultMaximumAttempts)
+{
+}
+
+CConnectionScheduler *CConnectionScheduler::instance()
+{
+    static CConnectionScheduler scheduler;
+    return &scheduler;
+}
+
+int CConnectionScheduler::maximumAttempts() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_maximumAttempts;
+}
+
+void CConnectionScheduler::setMaximumAttempts(int maximum)
+{
+    QMutexLocker locker(&m_mutex);
+    m_maximumAttempts = qMax(1, maximum);
+
+    while (!m_pending.isEmpty() && (m_active.count() < m_maximumAttempts)) {
+        CTelegramConnection *connection = m_pending.takeFirst();
+        m_active.append(connection);
+        QMetaObject::invokeMethod(connection, "connectToDc", Qt::QueuedConnection);
+    }
+}
+
+int CConnectionScheduler::activeAttempts() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_active.count();
+}
+
+int CConnectionScheduler::pendingAttempts() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_pending.count();
+}
+
+bool CConnectionScheduler::acquire(CTelegramConnection *connection)
+{
+    QMutexLocker locker(&m_mutex);
+
+    if (m_active.contains(connection)) {
+        // The slot can be handed over by release()
+        return true;
+    }
+
+    if (m_active.count() < m_maximumAttempts) {
+        m_active.append(connection);
+        return true;
+    }
+
+    if (!m_pending.contains(connection)) {
+        m_pending.append(connection);
+    }
+
+    return false;
+}
+
+void CConnectionScheduler::release(CTelegramConnection *connection)
+{
+    QMutexLocker locker(&m_mutex);
+
+    m_pending.removeOne(connection);
+
+    if (!m_active.removeOne(connection)) {
+        return;
+    }
+
+    if (!m_pending.isEmpty()) {
+        // Hand the slot over to the next queued connection. The connection can not be destructed meanwhile,
+        // because its destructor waits for the mutex to drop the connection from the queue.
+        CTelegramConnection *next = m_pending.takeFirst();
+        m_active.append(next);
+        QMetaObject::invokeMethod(next, "connectToDc", Qt::QueuedConnection);
+    }
+}
+
+quint32 CConnectionScheduler::nextReconnectionDelay(quint32 previousDelay)
+{
+    quint64 random;
+    Utils::randomBytes(&random);
+
+    if (!previousDelay) {
+        // The first attempt goes almost immediately, but still spread over the base delay.
+        return random % (BaseReconnectionDelay + 1);
+    }
+
+    // Decorrelated jitter: random delay between the base and the triple of the previous one.
+    const quint32 upperBound = qMin<quint32>(MaximumReconnectionDelay, previousDelay * 3);
+
+    if (upperBound <= BaseReconnectionDelay) {
+        return BaseReconnectionDelay;
+    }
+
+    return BaseReconnectionDelay + random % (upperBound - BaseReconnectionDelay + 1);
+}
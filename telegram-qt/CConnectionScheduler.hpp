@@ -0,0 +1,66 @@
+/*
+   Copyright (C) 2014-2015 Alexandr Akulich <akulichalexander@gmail.com>
+
+   This file is a part of TelegramQt library.
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+ */
+#ifndef CCONNECTIONSCHEDULER_HPP
+#define CCONNECTIONSCHEDULER_HPP
+
+#include <QList>
+#include <QMutex>
+
+class CTelegramConnection;
+
+// Process-wide limiter of the simultaneous connection attempts (TCP connect and the handshake).
+// A connection which can not get a slot is queued and its connectToDc() is invoked (queued, so it is
+// safe across threads) as soon as one of the active attempts is finished.
+// Also provides the reconnection delays: exponential backoff with "decorrelated jitter", so the
+// connections, which were dropped at the same moment, do not come back in lockstep.
+class CConnectionScheduler
+{
+public:
+    enum {
+        DefaultMaximumAttempts = 8,
+        BaseReconnectionDelay = 500, // ms
+        MaximumReconnectionDelay = 60 * 1000 // ms
+    };
+
+    static CConnectionScheduler *instance();
+
+    int maximumAttempts() const;
+    void setMaximumAttempts(int maximum);
+
+    int activeAttempts() const;
+    int pendingAttempts() const;
+
+    // Returns true if the connection can connect right now; otherwise the connection is queued.
+    bool acquire(CTelegramConnection *connection);
+
+    // Finishes the attempt (or drops the queued one) of the connection. Safe to call for any connection.
+    void release(CTelegramConnection *connection);
+
+    // Returns the delay (in ms) before the next reconnection attempt. Zero previous delay means the first attempt.
+    static quint32 nextReconnectionDelay(quint32 previousDelay);
+
+protected:
+    CConnectionScheduler();
+
+    mutable QMutex m_mutex;
+    int m_maximumAttempts;
+    QList<CTelegramConnection *> m_active;
+    QList<CTelegramConnection *> m_pending;
+
+};
+
+#endif // CCONNECTIONSCHEDULER_HPP
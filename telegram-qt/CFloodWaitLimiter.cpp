@@ -0,0 +1,101 @@
+/*
+   Copyright (C) 2014-2015 Alexandr Akulich <akulichalexander@gmail.com>
+
+   This file is a part of TelegramQt library.
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+ */
+#include "CFloodWaitLimiter.hpp"
+
+CFloodWaitLimiter::CFloodWaitLimiter()
+{
+}
+
+quint32 CFloodWaitLimiter::acquire(quint64 key, quint64 secondaryKey, qint64 time)
+{
+    const quint32 wait = qMax(waitTime(key, time), waitTime(secondaryKey, time));
+
+    if (wait) {
+        return wait;
+    }
+
+    takeToken(key, time);
+    takeToken(secondaryKey, time);
+
+    return 0;
+}
+
+void CFloodWaitLimiter::processFloodWait(quint64 key, quint32 seconds, qint64 time)
+{
+    Bucket &bucket = m_buckets[key];
+
+    if (bucket.interval) {
+        bucket.interval = qMin<quint32>(bucket.interval * 2, MaximumTokenInterval);
+    } else {
+        bucket.interval = MinimumTokenInterval;
+    }
+
+    bucket.blockedUntil = qMax(bucket.blockedUntil, time + qint64(seconds) * 1000);
+    bucket.lastFloodTime = time;
+
+    // No burst right after the block: the tolerance is restored by the quiet time only.
+    bucket.theoreticalTime = bucket.blockedUntil + qint64(Burst - 1) * bucket.interval;
+}
+
+quint32 CFloodWaitLimiter::floodWaitTime(qint64 time) const
+{
+    qint64 result = 0;
+
+    foreach (const Bucket &bucket, m_buckets) {
+        result = qMax(result, bucket.blockedUntil - time);
+    }
+
+    return result;
+}
+
+quint32 CFloodWaitLimiter::waitTime(quint64 key, qint64 time)
+{
+    if (!key || !m_buckets.contains(key)) {
+        return 0;
+    }
+
+    Bucket &bucket = m_buckets[key];
+
+    while ((time - bucket.lastFloodTime >= RelaxationPeriod) && (bucket.blockedUntil <= time)) {
+        bucket.interval /= 2;
+        bucket.lastFloodTime += RelaxationPeriod;
+
+        if (bucket.interval < MinimumTokenInterval) {
+            m_buckets.remove(key);
+            return 0;
+        }
+    }
+
+    const qint64 wait = qMax(bucket.blockedUntil - time,
+                             bucket.theoreticalTime - qint64(Burst - 1) * bucket.interval - time);
+
+    if (wait <= 0) {
+        return 0;
+    }
+
+    return wait;
+}
+
+void CFloodWaitLimiter::takeToken(quint64 key, qint64 time)
+{
+    if (!key || !m_buckets.contains(key)) {
+        return;
+    }
+
+    Bucket &bucket = m_buckets[key];
+    bucket.theoreticalTime = qMax(bucket.theoreticalTime, time) + bucket.interval;
+}
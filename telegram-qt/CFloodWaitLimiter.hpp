@@ -0,0 +1,89 @@
+/*
+   Copyright (C) 2014-2015 Alexandr Akulich <akulichalexander@gmail.com>
+
+   This file is a part of TelegramQt library.
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+ */
+#ifndef CFLOODWAITLIMITER_HPP
+#define CFLOODWAITLIMITER_HPP
+
+#include <QHash>
+
+// Per-key (a method or a method and a peer) rate limiter, which learns from the FLOOD_WAIT_X answers.
+// A key is not limited until the server complains about it. The complaint blocks the key for the
+// requested time and turns on a token bucket (implemented as GCRA: a request conforms if the
+// theoretical arrival time is not ahead of the current time by more than the burst tolerance).
+// Each next complaint doubles the token interval, each quiet relaxation period halves it back,
+// and the key becomes unlimited again once the interval falls below the minimum.
+class CFloodWaitLimiter
+{
+public:
+    enum {
+        Burst = 3,
+        MinimumTokenInterval = 1000, // ms
+        MaximumTokenInterval = 5 * 60 * 1000, // ms
+        RelaxationPeriod = 10 * 60 * 1000 // ms
+    };
+
+    CFloodWaitLimiter();
+
+    static quint64 methodKey(quint32 method);
+    static quint64 peerKey(quint32 method, quint32 peerType, quint32 peerId);
+
+    // Returns zero and takes a token from every passed key if the request can be sent at the given time.
+    // Otherwise returns the time (in ms) to wait. Zero key is ignored.
+    quint32 acquire(quint64 key, quint64 secondaryKey, qint64 time);
+
+    void processFloodWait(quint64 key, quint32 seconds, qint64 time);
+
+    bool isLimited(quint64 key) const { return m_buckets.contains(key); }
+    quint32 tokenInterval(quint64 key) const { return m_buckets.value(key).interval; }
+
+    // The greatest remaining block time (in ms) among all keys.
+    quint32 floodWaitTime(qint64 time) const;
+
+    void clear() { m_buckets.clear(); }
+
+protected:
+    struct Bucket {
+        Bucket() :
+            blockedUntil(0),
+            theoreticalTime(0),
+            lastFloodTime(0),
+            interval(0) { }
+
+        qint64 blockedUntil;
+        qint64 theoreticalTime;
+        qint64 lastFloodTime; // Or the time of the last relaxation
+        quint32 interval;
+    };
+
+    quint32 waitTime(quint64 key, qint64 time);
+    void takeToken(quint64 key, qint64 time);
+
+    QHash<quint64, Bucket> m_buckets;
+
+};
+
+inline quint64 CFloodWaitLimiter::methodKey(quint32 method)
+{
+    return method;
+}
+
+inline quint64 CFloodWaitLimiter::peerKey(quint32 method, quint32 peerType, quint32 peerId)
+{
+    // The method and the peer type constructors are different, so the high part is never zero.
+    return (quint64(method ^ peerType) << 32) | peerId;
+}
+
+#endif // CFLOODWAITLIMITER_HPP
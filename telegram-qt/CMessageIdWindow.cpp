@@ -0,0 +1,146 @@
+/*
+   Copyright (C) 2014-2015 Alexandr Akulich <akulichalexander@gmail.com>
+
+   This file is a part of TelegramQt library.
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+ */
+#include "CMessageIdWindow.hpp"
+
+#include <string.h>
+
+CMessageIdWindow::CMessageIdWindow()
+{
+    reset();
+}
+
+void CMessageIdWindow::reset()
+{
+    memset(m_bitmap, 0, sizeof(m_bitmap));
+    memset(m_messageIds, 0, sizeof(m_messageIds));
+    m_base = 0;
+    m_greatestMessageId = 0;
+    m_empty = true;
+    m_overflow.clear();
+}
+
+bool CMessageIdWindow::accept(quint64 messageId, quint32 sequenceNumber)
+{
+    if (!isContentRelated(sequenceNumber)) {
+        // Service messages are not counted and their repeated processing is harmless.
+        if (messageId > m_greatestMessageId) {
+            m_greatestMessageId = messageId;
+        }
+        return true;
+    }
+
+    const quint32 counter = sequenceNumber >> 1;
+
+    if (m_empty || ((messageId > m_greatestMessageId) && (counter < m_base) && (m_base - counter >= WindowSize))) {
+        // First message or the server started the session over: new message id, but an old counter.
+        // (The reused counters within the bitmap are told apart by the message id.)
+        reset();
+        m_empty = false;
+        m_base = counter;
+    } else if (counter > m_base) {
+        advance(counter - m_base);
+    } else if (m_base - counter < WindowSize) {
+        // The counter is reused only by a newer message; the older one is a resent duplicate.
+        if (testBit(m_base - counter) && (messageId <= m_messageIds[counter % WindowSize])) {
+            return false;
+        }
+    } else if (!m_overflow.removeOne(counter)) {
+        return false;
+    }
+
+    if (counter <= m_base && (m_base - counter < WindowSize)) {
+        setBit(m_base - counter);
+        m_messageIds[counter % WindowSize] = messageId;
+    }
+
+    if (messageId > m_greatestMessageId) {
+        m_greatestMessageId = messageId;
+    }
+
+    return true;
+}
+
+bool CMessageIdWindow::testBit(quint32 index) const
+{
+    return m_bitmap[index / 64] & (quint64(1) << (index % 64));
+}
+
+void CMessageIdWindow::setBit(quint32 index)
+{
+    m_bitmap[index / 64] |= quint64(1) << (index % 64);
+}
+
+void CMessageIdWindow::advance(quint32 shift)
+{
+    // Remember the counters, which are going to leave the bitmap without being received.
+    const quint32 leaving = qMin<quint32>(shift, WindowSize);
+    for (quint32 i = 0; i < leaving; ++i) {
+        const quint32 index = WindowSize - 1 - i;
+        if ((index <= m_base) && !testBit(index)) {
+            addToOverflow(m_base - index);
+        }
+    }
+
+    if (shift > WindowSize) {
+        // The counters, which have been skipped over completely.
+        quint32 first = m_base + 1;
+        const quint32 end = m_base + shift - WindowSize + 1;
+
+        if (end - first > MaxOverflowCount) {
+            first = end - MaxOverflowCount;
+        }
+
+        for (quint32 counter = first; counter < end; ++counter) {
+            addToOverflow(counter);
+        }
+    }
+
+    m_base += shift;
+
+    if (shift >= WindowSize) {
+        memset(m_bitmap, 0, sizeof(m_bitmap));
+        return;
+    }
+
+    const int words = WindowSize / 64;
+    const int wordShift = shift / 64;
+    const int bitShift = shift % 64;
+
+    for (int i = words - 1; i >= 0; --i) {
+        quint64 value = 0;
+
+        if (i - wordShift >= 0) {
+            value = m_bitmap[i - wordShift] << bitShift;
+
+            if (bitShift && (i - wordShift - 1 >= 0)) {
+                value |= m_bitmap[i - wordShift - 1] >> (64 - bitShift);
+            }
+        }
+
+        m_bitmap[i] = value;
+    }
+}
+
+void CMessageIdWindow::addToOverflow(quint32 counter)
+{
+    m_overflow.append(counter);
+
+    if (m_overflow.count() > MaxOverflowCount) {
+        // The oldest one is the least likely to arrive.
+        m_overflow.removeFirst();
+    }
+}
@@ -0,0 +1,60 @@
+/*
+   Copyright (C) 2014-2015 Alexandr Akulich <akulichalexander@gmail.com>
+
+   This file is a part of TelegramQt library.
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+ */
+#ifndef CMESSAGEIDWINDOW_HPP
+#define CMESSAGEIDWINDOW_HPP
+
+#include <QList>
+
+// Sliding window over the received messages of a session, used to drop the resent duplicates.
+// Content-related messages are counted by the sequence number (seqNo = 2 * counter + 1), the window is
+// a bitmap relative to the greatest received counter and the counters, which left the bitmap without
+// being received, are kept in a small overflow list to accept the late messages.
+// The message id is kept next to each received counter, so a new message, which reuses the counter
+// (e.g. after the server restarts the session), is not taken for a duplicate.
+class CMessageIdWindow
+{
+public:
+    enum {
+        WindowSize = 256,
+        MaxOverflowCount = 64
+    };
+
+    CMessageIdWindow();
+
+    void reset();
+
+    // Returns false if the message was already received.
+    bool accept(quint64 messageId, quint32 sequenceNumber);
+
+    static inline bool isContentRelated(quint32 sequenceNumber) { return sequenceNumber & 1; }
+
+protected:
+    bool testBit(quint32 index) const;
+    void setBit(quint32 index);
+    void advance(quint32 shift);
+    void addToOverflow(quint32 counter);
+
+    quint64 m_bitmap[WindowSize / 64]; // Bit "i" stands for the (m_base - i) counter
+    quint64 m_messageIds[WindowSize]; // The message id of the received counter at (counter % WindowSize)
+    quint32 m_base;
+    quint64 m_greatestMessageId;
+    bool m_empty;
+    QList<quint32> m_overflow; // Sorted
+
+};
+
+#endif // CMESSAGEIDWINDOW_HPP
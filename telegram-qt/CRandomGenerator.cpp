@@ -0,0 +1,170 @@
+/*
+   Copyright (C) 2014-2015 Alexandr Akulich <akulichalexander@gmail.com>
+
+   This file is a part of TelegramQt library.
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+ */
+
+#include "CRandomGenerator.hpp"
+
+#include <openssl/rand.h>
+
+#include <string.h>
+
+#include <QThreadStorage>
+#include <QtEndian>
+
+static QThreadStorage<CRandomGenerator *> s_generators;
+
+static const quint32 s_zeroNonce[3] = { 0, 0, 0 };
+
+static inline quint32 rotateLeft(quint32 value, int count)
+{
+    return (value << count) | (value >> (32 - count));
+}
+
+static inline void quarterRound(quint32 *x, int a, int b, int c, int d)
+{
+    x[a] += x[b]; x[d] = rotateLeft(x[d] ^ x[a], 16);
+    x[c] += x[d]; x[b] = rotateLeft(x[b] ^ x[c], 12);
+    x[a] += x[b]; x[d] = rotateLeft(x[d] ^ x[a], 8);
+    x[c] += x[d]; x[b] = rotateLeft(x[b] ^ x[c], 7);
+}
+
+CRandomGenerator::CRandomGenerator() :
+    m_available(0),
+    m_bytesSinceReseed(0),
+    m_seeded(false)
+{
+    memset(m_key, 0, sizeof(m_key));
+    memset(m_buffer, 0, sizeof(m_buffer));
+}
+
+CRandomGenerator::~CRandomGenerator()
+{
+    memset(m_key, 0, sizeof(m_key));
+    memset(m_buffer, 0, sizeof(m_buffer));
+}
+
+CRandomGenerator *CRandomGenerator::instance()
+{
+    if (!s_generators.hasLocalData()) {
+        s_generators.setLocalData(new CRandomGenerator());
+    }
+
+    return s_generators.localData();
+}
+
+int CRandomGenerator::generate(char *buffer, int count)
+{
+    if (!m_seeded && !reseed()) {
+        return 0;
+    }
+
+    while (count > 0) {
+        if (!m_available) {
+            refill();
+        }
+
+        const int chunkSize = qMin(count, m_available);
+        uchar *source = m_buffer + BufferSize - m_available;
+
+        memcpy(buffer, source, chunkSize);
+        memset(source, 0, chunkSize);
+
+        m_available -= chunkSize;
+        m_bytesSinceReseed += chunkSize;
+        buffer += chunkSize;
+        count -= chunkSize;
+    }
+
+    if (m_bytesSinceReseed >= ReseedInterval) {
+        // The generator is still safe to use if OpenSSL is temporarily unable to provide the entropy.
+        reseed();
+    }
+
+    return 1;
+}
+
+void CRandomGenerator::chaCha20Block(const quint32 *key, quint32 counter, const quint32 *nonce, uchar *output)
+{
+    quint32 input[16];
+    input[0] = 0x61707865;
+    input[1] = 0x3320646e;
+    input[2] = 0x79622d32;
+    input[3] = 0x6b206574;
+
+    for (int i = 0; i < 8; ++i) {
+        input[4 + i] = key[i];
+    }
+
+    input[12] = counter;
+    input[13] = nonce[0];
+    input[14] = nonce[1];
+    input[15] = nonce[2];
+
+    quint32 x[16];
+    memcpy(x, input, sizeof(x));
+
+    for (int i = 0; i < 10; ++i) {
+        quarterRound(x, 0, 4,  8, 12);
+        quarterRound(x, 1, 5,  9, 13);
+        quarterRound(x, 2, 6, 10, 14);
+        quarterRound(x, 3, 7, 11, 15);
+        quarterRound(x, 0, 5, 10, 15);
+        quarterRound(x, 1, 6, 11, 12);
+        quarterRound(x, 2, 7,  8, 13);
+        quarterRound(x, 3, 4,  9, 14);
+    }
+
+    for (int i = 0; i < 16; ++i) {
+        qToLittleEndian<quint32>(x[i] + input[i], output + i * 4);
+    }
+}
+
+bool CRandomGenerator::reseed()
+{
+    uchar seed[KeySize];
+
+    if (RAND_bytes(seed, KeySize) != 1) {
+        return false;
+    }
+
+    for (int i = 0; i < KeySize / 4; ++i) {
+        m_key[i] ^= qFromLittleEndian<quint32>(seed + i * 4);
+    }
+
+    memset(seed, 0, sizeof(seed));
+
+    // Drop the keystream generated with the previous key.
+    memset(m_buffer, 0, sizeof(m_buffer));
+    m_available = 0;
+    m_bytesSinceReseed = 0;
+    m_seeded = true;
+
+    return true;
+}
+
+void CRandomGenerator::refill()
+{
+    for (int i = 0; i < BlocksPerRefill; ++i) {
+        chaCha20Block(m_key, i, s_zeroNonce, m_buffer + i * BlockSize);
+    }
+
+    for (int i = 0; i < KeySize / 4; ++i) {
+        m_key[i] = qFromLittleEndian<quint32>(m_buffer + i * 4);
+    }
+
+    memset(m_buffer, 0, KeySize);
+    m_available = BufferSize - KeySize;
+}
@@ -0,0 +1,62 @@
+/*
+   Copyright (C) 2014-2015 Alexandr Akulich <akulichalexander@gmail.com>
+
+   This file is a part of TelegramQt library.
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+ */
+
+#ifndef CRANDOMGENERATOR_HPP
+#define CRANDOMGENERATOR_HPP
+
+#include <qglobal.h>
+
+// ChaCha20-based deterministic random bit generator.
+// The key is seeded (and periodically reseeded) from OpenSSL RAND_bytes(),
+// keystream is generated by blocks and the first bytes of every block batch
+// replace the key ("fast key erasure"), so the served bytes can not be recovered
+// from the generator state. Instances are per-thread and need no locking.
+class CRandomGenerator
+{
+public:
+    enum {
+        KeySize = 32,
+        BlockSize = 64,
+        BlocksPerRefill = 16,
+        BufferSize = BlockSize * BlocksPerRefill,
+        ReseedInterval = 1024 * 1024
+    };
+
+    ~CRandomGenerator();
+
+    static CRandomGenerator *instance();
+
+    // Returns 1 on success and 0 on failure, just like RAND_bytes() does.
+    int generate(char *buffer, int count);
+
+    static void chaCha20Block(const quint32 *key, quint32 counter, const quint32 *nonce, uchar *output);
+
+protected:
+    CRandomGenerator();
+
+    bool reseed();
+    void refill();
+
+    quint32 m_key[KeySize / 4];
+    uchar m_buffer[BufferSize];
+    int m_available;
+    quint32 m_bytesSinceReseed;
+    bool m_seeded;
+
+};
+
+#endif // CRANDOMGENERATOR_HPP
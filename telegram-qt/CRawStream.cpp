@@ -26,34 +26,63 @@ template CRawStream &CRawStream::operator>>(TLNumber256 &v);
 template CRawStream &CRawStream::operator<<(const TLNumber128 &v);
 template CRawStream &CRawStream::operator<<(const TLNumber256 &v);
 
+// The views (see QByteArray::fromRawData()) do not own the data, so they must not outlive the stream.
+static bool isRawData(QByteArray &data)
+{
+#if QT_VERSION >= 0x050000
+    return !data.isEmpty() && !data.data_ptr()->isMutable();
+#else
+    return data.data_ptr()->data != data.data_ptr()->array;
+#endif
+}
+
 CRawStream::CRawStream(QByteArray *data, bool write) :
-    m_device(new QBuffer(data)),
+    m_device(0),
     m_ownDevice(true),
-    m_error(false)
+    m_ownData(false),
+    m_error(false),
+    m_position(0),
+    m_end(0)
 {
     if (write) {
+        m_device = new QBuffer(data);
         m_device->open(QIODevice::Append);
     } else {
-        m_device->open(QIODevice::ReadOnly);
+        m_data = *data;
+        m_ownData = !isRawData(m_data);
+        m_position = m_data.constData();
+        m_end = m_position + m_data.size();
     }
 }
 
 CRawStream::CRawStream(const QByteArray &data) :
     m_device(0),
-    m_ownDevice(true),
-    m_error(false)
+    m_ownDevice(false),
+    m_error(false),
+    m_data(data),
+    m_position(m_data.constData()),
+    m_end(m_position + m_data.size())
 {
-    QBuffer *buffer = new QBuffer();
-    buffer->setData(data);
-    m_device = buffer;
+    m_ownData = !isRawData(m_data);
+}
 
-    m_device->open(QIODevice::ReadOnly);
+CRawStream::CRawStream(const char *data, int size) :
+    m_device(0),
+    m_ownDevice(false),
+    m_ownData(false),
+    m_error(false),
+    m_position(data),
+    m_end(data + size)
+{
 }
 
 CRawStream::CRawStream(QIODevice *d) :
     m_device(d),
     m_ownDevice(false),
-    m_error(false)
+    m_ownData(false),
+    m_error(false),
+    m_position(0),
+    m_end(0)
 {
 }
 
@@ -73,6 +102,12 @@ void CRawStream::setDevice(QIODevice *newDevice)
     }
 
     m_device = newDevice;
+    m_ownDevice = false;
+
+    m_data.clear();
+    m_ownData = false;
+    m_position = 0;
+    m_end = 0;
 }
 
 void CRawStream::unsetDevice()
@@ -80,17 +115,7 @@ void CRawStream::unsetDevice()
     setDevice(0);
 }
 
-bool CRawStream::atEnd() const
-{
-    return m_device ? m_device->atEnd() : true;
-}
-
-int CRawStream::bytesRemaining() const
-{
-    return m_device->bytesAvailable();
-}
-
-bool CRawStream::read(void *data, qint64 size)
+bool CRawStream::readFromDevice(void *data, qint64 size)
 {
     m_error = m_error || m_device->read((char *) data, size) != size;
     return m_error;
@@ -98,33 +123,77 @@ bool CRawStream::read(void *data, qint64 size)
 
 bool CRawStream::write(const void *data, qint64 size)
 {
+    if (!m_device) {
+        m_error = true;
+        return m_error;
+    }
+
     m_error = m_error || m_device->write((const char *) data, size) != size;
     return m_error;
 }
 
+int CRawStream::takeBytes(int count)
+{
+    // Moves the position in the memory block and returns the number of taken bytes.
+    const int available = qBound(0, count, int(m_end - m_position));
+
+    m_error = m_error || available != count;
+    m_position += available;
+
+    return available;
+}
+
 QByteArray CRawStream::readBytes(int count)
 {
+    if (!m_device) {
+        const char *data = m_position;
+        return QByteArray(data, takeBytes(count));
+    }
+
     QByteArray result = m_device->read(count);
     m_error = m_error || result.size() != count;
     return result;
 }
 
-CRawStream &CRawStream::operator>>(qint32 &i)
+QByteArray CRawStream::readBytesView(int count)
 {
-    read(&i, 4);
-    return *this;
+    if (!m_device) {
+        const char *data = m_position;
+        return QByteArray::fromRawData(data, takeBytes(count));
+    }
+
+    return readBytes(count);
 }
 
-CRawStream &CRawStream::operator>>(qint64 &i)
+QByteArray CRawStream::peekRemainingBytes() const
 {
-    read(&i, 8);
-    return *this;
+    if (!m_device) {
+        return QByteArray::fromRawData(m_position, m_end - m_position);
+    }
+
+    return m_device->peek(m_device->bytesAvailable());
 }
 
-CRawStream &CRawStream::operator>>(double &d)
+QByteArray CRawStream::sharedData(int *position) const
 {
-    read(&d, 8);
-    return *this;
+    if (m_device || !m_ownData) {
+        return QByteArray();
+    }
+
+    *position = m_position - m_data.constData();
+
+    return m_data;
+}
+
+bool CRawStream::skipBytes(int count)
+{
+    if (!m_device) {
+        takeBytes(count);
+        return m_error;
+    }
+
+    m_error = m_error || (count < 0) || m_device->read(count).size() != count;
+    return m_error;
 }
 
 CRawStream &CRawStream::operator<<(qint32 i)
@@ -147,7 +216,7 @@ CRawStream &CRawStream::operator<<(const double &d)
 
 CRawStream &CRawStream::operator<<(const QByteArray &data)
 {
-    m_error = m_error || m_device->write(data) != data.size();
+    m_error = m_error || !m_device || m_device->write(data) != data.size();
 
     return *this;
 }
@@ -21,19 +21,17 @@
 #include <qglobal.h>
 
 #include <QByteArray>
+#include <QIODevice>
 
 #include "TLNumbers.hpp"
 #include "TLValues.hpp"
 
-QT_BEGIN_NAMESPACE
-class QIODevice;
-QT_END_NAMESPACE
-
 class CRawStream
 {
 public:
     explicit CRawStream(QByteArray *data, bool write);
     explicit CRawStream(const QByteArray &data);
+    explicit CRawStream(const char *data, int size);
 
     explicit CRawStream(QIODevice *d = 0);
 
@@ -51,8 +49,21 @@ public:
 
     QByteArray readBytes(int count);
 
+    // Returns the next count bytes without a copy (if the stream reads a memory block).
+    // The result is valid as long as the stream data exists.
+    QByteArray readBytesView(int count);
+
+    bool skipBytes(int count);
+
     QByteArray readRemainingBytes();
 
+    // Returns the remaining bytes without moving the position (a view, if the stream reads a memory block).
+    QByteArray peekRemainingBytes() const;
+
+    // Returns the memory block of the stream and the current position in it, if the block is owned by the stream
+    // (so it can be shared instead of a copy). Returns a null array, if the stream reads a device or a view.
+    QByteArray sharedData(int *position) const;
+
     CRawStream &operator>>(qint32 &i);
     CRawStream &operator>>(quint32 &i);
     CRawStream &operator>>(qint64 &i);
@@ -84,10 +95,19 @@ protected:
     bool write(const void *data, qint64 size);
 
 private:
+    bool readFromDevice(void *data, qint64 size);
+    int takeBytes(int count);
+
     QIODevice *m_device;
     bool m_ownDevice;
+    bool m_ownData;
     bool m_error;
 
+    // Read-only memory block; it is used instead of QIODevice, if there is no device.
+    QByteArray m_data; // Keeps the block alive, if the stream is constructed from a QByteArray (but not from a view)
+    const char *m_position;
+    const char *m_end;
+
 };
 
 inline void CRawStream::resetError()
@@ -95,11 +115,65 @@ inline void CRawStream::resetError()
     m_error = false;
 }
 
+inline bool CRawStream::atEnd() const
+{
+    if (m_device) {
+        return m_device->atEnd();
+    }
+
+    return m_position == m_end;
+}
+
+inline int CRawStream::bytesRemaining() const
+{
+    if (m_device) {
+        return m_device->bytesAvailable();
+    }
+
+    return m_end - m_position;
+}
+
 inline QByteArray CRawStream::readRemainingBytes()
 {
     return readBytes(bytesRemaining());
 }
 
+inline bool CRawStream::read(void *data, qint64 size)
+{
+    if (m_device) {
+        return readFromDevice(data, size);
+    }
+
+    if (size > m_end - m_position) {
+        m_position = m_end;
+        m_error = true;
+        return m_error;
+    }
+
+    memcpy(data, m_position, size);
+    m_position += size;
+
+    return m_error;
+}
+
+inline CRawStream &CRawStream::operator>>(qint32 &i)
+{
+    read(&i, 4);
+    return *this;
+}
+
+inline CRawStream &CRawStream::operator>>(qint64 &i)
+{
+    read(&i, 8);
+    return *this;
+}
+
+inline CRawStream &CRawStream::operator>>(double &d)
+{
+    read(&d, 8);
+    return *this;
+}
+
 inline CRawStream &CRawStream::operator>>(quint32 &i)
 {
     return *this >> reinterpret_cast<qint32&>(i);
@@ -19,6 +19,8 @@
 
 #include <QDebug>
 
+#include <QCryptographicHash>
+
 #include <QDateTime>
 #include <QStringList>
 #include <QTimer>
@@ -39,6 +41,7 @@ QString formatTLValue(const TLValue &val)
 #endif
 
 #include "CAppInformation.hpp"
+#include "CConnectionScheduler.hpp"
 #include "CTelegramStream.hpp"
 #include "CTcpTransport.hpp"
 #include "Utils.hpp"
@@ -46,6 +49,20 @@ QString formatTLValue(const TLValue &val)
 
 using namespace TelegramUtils;
 
+static const quint32 s_futureSaltsRequestCount = 32;
+static const int s_futureSaltsRequestThreshold = 4; // Request the next salts when the schedule is about to run out.
+static const quint32 s_serverSaltExpirationMargin = 60; // Switch to the next salt a minute before the current one expires.
+static const int s_futureSaltsRequestDelay = 5000; // 5 sec
+static const int s_clockOffsetRaiseFactor = 2; // Samples can only be late, so the larger ones are trusted more.
+static const int s_clockOffsetDropFactor = 16;
+static const int s_roundTripTimeFactor = 8;
+static const quint32 s_keepAliveDisconnectFactor = 3; // The server closes the connection if it gets no ping during three intervals.
+static const quint32 s_keepAliveProbeSuccessCount = 3; // Successful probes before the next (longer) interval is tried.
+static const quint32 s_keepAliveMaximumFactor = 8; // The interval is never probed beyond this times of the configured one.
+static const int s_containerMaximumMessages = 64;
+static const int s_containerMaximumSize = 32 * 1024; // Bigger packages (such as file parts) are sent alone.
+static const quint32 s_floodWaitMaximumDelay = 5 * 60; // Requests which have to wait longer (in seconds) are dropped.
+
 CTelegramConnection::CTelegramConnection(const CAppInformation *appInfo, QObject *parent) :
     QObject(parent),
     m_status(ConnectionStatusDisconnected),
@@ -53,10 +70,15 @@ CTelegramConnection::CTelegramConnection(const CAppInformation *appInfo, QObject
     m_transport(0),
     m_pingTimer(0),
     m_ackTimer(new QTimer(this)),
+    m_serverSaltTimer(new QTimer(this)),
+    m_reconnectionTimer(new QTimer(this)),
+    m_idleTimer(new QTimer(this)),
+    m_delayedPackagesTimer(new QTimer(this)),
     m_authState(AuthStateNone),
     m_authId(0),
     m_authKeyAuxHash(0),
     m_serverSalt(0),
+    m_futureSaltsRequestId(0),
     m_sessionId(0),
     m_lastMessageId(0),
     m_lastSentPingId(0),
@@ -64,8 +86,20 @@ CTelegramConnection::CTelegramConnection(const CAppInformation *appInfo, QObject
     m_contentRelatedMessages(0),
     m_pingInterval(0),
     m_serverDisconnectionExtraTime(0),
-    m_deltaTime(0),
-    m_deltaTimeHeuristicState(DeltaTimeIsOk),
+    m_keepAliveInterval(0),
+    m_keepAliveGoodInterval(0),
+    m_keepAliveCeiling(0),
+    m_keepAliveProbeSuccesses(0),
+    m_keepAliveProbe(false),
+    m_idleTimeout(0),
+    m_compressionThreshold(0),
+    m_lastReceivedPackageTime(0),
+    m_clockOffset(0),
+    m_lastClockOffsetSample(0),
+    m_clockOffsetSamplesCount(0),
+    m_roundTripTime(0),
+    m_lastPlainPackageTime(0),
+    m_reconnectionDelay(0),
     m_serverPublicFingersprint(0)
   #ifdef NETWORK_LOGGING
   , m_logFile(0)
@@ -76,6 +110,23 @@ CTelegramConnection::CTelegramConnection(const CAppInformation *appInfo, QObject
     m_ackTimer->setInterval(90 * 1000);
     m_ackTimer->setSingleShot(true);
     connect(m_ackTimer, SIGNAL(timeout()), SLOT(whenItsTimeToAckMessages()));
+
+    m_serverSaltTimer->setSingleShot(true);
+    connect(m_serverSaltTimer, SIGNAL(timeout()), SLOT(whenItsTimeToUpdateServerSalt()));
+
+    m_reconnectionTimer->setSingleShot(true);
+    connect(m_reconnectionTimer, SIGNAL(timeout()), SLOT(connectToDc()));
+
+    m_idleTimer->setSingleShot(true);
+    connect(m_idleTimer, SIGNAL(timeout()), SLOT(whenConnectionIsIdle()));
+
+    m_delayedPackagesTimer->setSingleShot(true);
+    connect(m_delayedPackagesTimer, SIGNAL(timeout()), SLOT(whenItsTimeToSendDelayedPackages()));
+}
+
+CTelegramConnection::~CTelegramConnection()
+{
+    CConnectionScheduler::instance()->release(this);
 }
 
 void CTelegramConnection::setDcInfo(const TLDcOption &newDcInfo)
@@ -89,6 +140,14 @@ void CTelegramConnection::connectToDc()
         return;
     }
 
+    m_reconnectionTimer->stop();
+
+    if (!CConnectionScheduler::instance()->acquire(this)) {
+        // The scheduler calls the method again as soon as there is a free slot.
+        qDebug() << Q_FUNC_INFO << "Too many simultaneous connection attempts; dc" << m_dcInfo.id << "is queued.";
+        return;
+    }
+
 #ifdef DEVELOPER_BUILD
     qDebug() << Q_FUNC_INFO << m_dcInfo.id << m_dcInfo.ipAddress << m_dcInfo.port;
 #endif
@@ -99,6 +158,21 @@ void CTelegramConnection::connectToDc()
     m_transport->connectToHost(m_dcInfo.ipAddress, m_dcInfo.port);
 }
 
+void CTelegramConnection::scheduleReconnection()
+{
+    if (m_status != ConnectionStatusDisconnected) {
+        return;
+    }
+
+    m_reconnectionDelay = CConnectionScheduler::nextReconnectionDelay(m_reconnectionDelay);
+
+#ifdef DEVELOPER_BUILD
+    qDebug() << Q_FUNC_INFO << m_dcInfo.id << "reconnect in" << m_reconnectionDelay << "ms";
+#endif
+
+    m_reconnectionTimer->start(m_reconnectionDelay);
+}
+
 void CTelegramConnection::setTransport(CTelegramTransport *newTransport)
 {
     m_transport = newTransport;
@@ -115,9 +189,119 @@ void CTelegramConnection::setAuthKey(const QByteArray &newAuthKey)
     m_authKeyAuxHash = Utils::getFingersprint(m_authKey, /* lower-order */ false);
 }
 
-void CTelegramConnection::setDeltaTime(const qint32 newDt)
+void CTelegramConnection::setServerSalts(const TLVector<TLFutureSalt> &salts)
+{
+    m_serverSalts = salts;
+}
+
+QByteArray CTelegramConnection::sessionState() const
+{
+    if (!m_sessionId) {
+        return QByteArray();
+    }
+
+    QByteArray output;
+    CTelegramStream outputStream(&output, /* write */ true);
+
+    outputStream << m_sessionId;
+    outputStream << m_lastMessageId;
+    outputStream << m_contentRelatedMessages;
+    outputStream << m_messagesToAck;
+    outputStream << m_messagesToAckSequenceNumbers;
+    outputStream << quint32(m_submittedPackages.count());
+
+    foreach (const quint64 id, m_submittedPackages.keys()) {
+        // The message id is zero for the request, which is not sent yet.
+        const quint64 messageId = m_packageMessageIds.value(id);
+
+        outputStream << id;
+        outputStream << messageId;
+        outputStream << m_sentPackages.value(messageId).sequenceNumber;
+        outputStream << m_submittedPackages.value(id);
+    }
+
+    return output;
+}
+
+bool CTelegramConnection::restoreSessionState(const QByteArray &state)
+{
+    CTelegramStream inputStream(state);
+
+    quint64 sessionId;
+    quint64 lastMessageId;
+    quint32 contentRelatedMessages;
+    TLVector<quint64> messagesToAck;
+    TLVector<quint32> messagesToAckSequenceNumbers;
+    quint32 packagesCount;
+    QMap<quint64, QByteArray> submittedPackages;
+    QMap<quint64, SentPackage> sentPackages;
+
+    inputStream >> sessionId;
+    inputStream >> lastMessageId;
+    inputStream >> contentRelatedMessages;
+    inputStream >> messagesToAck;
+    inputStream >> messagesToAckSequenceNumbers;
+    inputStream >> packagesCount;
+
+    for (quint32 i = 0; (i < packagesCount) && !inputStream.error(); ++i) {
+        quint64 id;
+        quint64 messageId;
+        quint32 sequenceNumber;
+        QByteArray data;
+        inputStream >> id;
+        inputStream >> messageId;
+        inputStream >> sequenceNumber;
+        inputStream >> data;
+        submittedPackages.insert(id, data);
+
+        if (messageId) {
+            sentPackages.insert(messageId, SentPackage(id, sequenceNumber));
+        }
+    }
+
+    if (inputStream.error() || !sessionId || (messagesToAck.count() != messagesToAckSequenceNumbers.count())) {
+        qDebug() << Q_FUNC_INFO << "Invalid session state data.";
+        return false;
+    }
+
+    m_sessionId = sessionId;
+    m_lastMessageId = lastMessageId;
+    m_contentRelatedMessages = contentRelatedMessages;
+    m_messagesToAck = messagesToAck;
+    m_messagesToAckSequenceNumbers = messagesToAckSequenceNumbers;
+    m_submittedPackages = submittedPackages;
+    m_sentPackages.clear();
+    m_packageMessageIds.clear();
+    m_pendingPackages.clear();
+
+    // The sent requests keep their messages, so they are sent again with the same ids and the results are matched.
+    QMap<quint64, SentPackage>::const_iterator it = sentPackages.constBegin();
+    for ( ; it != sentPackages.constEnd(); ++it) {
+        setPackageMessage(it.value().requestId, it.key(), it.value().sequenceNumber);
+    }
+
+    foreach (const quint64 id, m_submittedPackages.keys()) {
+        if (!m_packageMessageIds.contains(id)) {
+            m_pendingPackages.append(id);
+        }
+    }
+
+    // The server resends the messages, which are not acknowledged yet, so they are the expected duplicates.
+    m_receivedMessages.reset();
+    for (int i = 0; i < m_messagesToAck.count(); ++i) {
+        m_receivedMessages.accept(m_messagesToAck.at(i), m_messagesToAckSequenceNumbers.at(i));
+    }
+
+    if (!m_messagesToAck.isEmpty()) {
+        m_ackTimer->start();
+    }
+
+    return true;
+}
+
+void CTelegramConnection::setClockOffset(qint64 offset)
 {
-    m_deltaTime = newDt;
+    m_clockOffset = offset;
 
     // Message id depends on time, so if we fix time, we need to reset message id.
     m_lastMessageId = 0;
@@ -195,13 +379,28 @@ void CTelegramConnection::setKeepAliveSettings(quint32 interval, quint32 serverD
     }
 
     m_pingInterval = interval;
+    m_keepAliveInterval = interval;
+    m_keepAliveGoodInterval = interval;
+    m_keepAliveCeiling = interval * s_keepAliveMaximumFactor;
+    m_keepAliveProbeSuccesses = 0;
+
+    if (m_pingTimer) {
+        m_pingTimer->stop();
+    }
 
-    if (interval) {
+    if (interval && (m_authState >= AuthStateHaveAKey)) {
         startPingTimer();
+    }
+}
+
+void CTelegramConnection::setIdleTimeout(quint32 timeout)
+{
+    m_idleTimeout = timeout;
+
+    if (timeout && (m_status >= ConnectionStatusConnected)) {
+        m_idleTimer->start(timeout);
     } else {
-        if (m_pingTimer) {
-            m_pingTimer->stop();
-        }
+        m_idleTimer->stop();
     }
 }
 
@@ -232,23 +431,39 @@ void CTelegramConnection::downloadFile(const TLInputFileLocation &inputLocation,
         return;
     }
 
-    const quint64 messageId = uploadGetFile(inputLocation, offset, limit);
+    const quint64 id = uploadGetFile(inputLocation, offset, limit);
 
-    m_requestedFilesIds.insert(messageId, requestId);
+    m_requestedFilesIds.insert(id, requestId);
 }
 
 void CTelegramConnection::uploadFile(quint64 fileId, quint32 filePart, const QByteArray &bytes, quint32 requestId)
 {
     qDebug() << Q_FUNC_INFO << "id" << fileId << "part" << filePart << "size" << bytes.count() << "request" << requestId;
-    const quint64 messageId = uploadSaveFilePart(fileId, filePart, bytes);
+    const quint64 id = uploadSaveFilePart(fileId, filePart, bytes);
 
-    m_requestedFilesIds.insert(messageId, requestId);
+    m_requestedFilesIds.insert(id, requestId);
 }
 
-quint64 CTelegramConnection::sendMessage(const TLInputPeer &peer, const QString &message)
+void CTelegramConnection::cancelFileRequest(quint32 requestId)
 {
-    quint64 randomMessageId;
-    Utils::randomBytes(&randomMessageId);
+    foreach (quint64 id, m_requestedFilesIds.keys(requestId)) {
+        m_requestedFilesIds.remove(id);
+
+        const TLValue request = TLValue::firstFromArray(m_submittedPackages.value(id));
+        const quint64 messageId = m_packageMessageIds.value(id);
+
+        if (removeSubmittedPackage(id) && (request == TLValue::UploadGetFile) && isReadyToSendEncryptedPackages()) {
+            // The part is requested already; do not waste the bandwidth on the answer.
+            rpcDropAnswer(messageId);
+        }
+    }
+}
+
+quint64 CTelegramConnection::sendMessage(const TLInputPeer &peer, const QString &message, quint64 randomMessageId)
+{
+    if (!randomMessageId) {
+        Utils::randomBytes(&randomMessageId);
+    }
 
     // Probably we have to implement GZip packing to fix this bug.
     if (message.length() > 400) {
@@ -279,7 +494,13 @@ quint64 CTelegramConnection::sendMedia(const TLInputPeer &peer, const TLInputMed
 // Generated Telegram API methods implementation
 quint64 CTelegramConnection::accountChangePhone(const QString &phoneNumber, const QString &phoneCodeHash, const QString &phoneCode)
 {
+    int outputSize = CTelegramStream::serializedSize(TLValue::AccountChangePhone);
+    outputSize += CTelegramStream::serializedSize(phoneNumber);
+    outputSize += CTelegramStream::serializedSize(phoneCodeHash);
+    outputSize += CTelegramStream::serializedSize(phoneCode);
+
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
 
     outputStream << TLValue::AccountChangePhone;
@@ -292,7 +513,11 @@ quint64 CTelegramConnection::accountChangePhone(const QString &phoneNumber, cons
 
 quint64 CTelegramConnection::accountCheckUsername(const QString &username)
 {
+    int outputSize = CTelegramStream::serializedSize(TLValue::AccountCheckUsername);
+    outputSize += CTelegramStream::serializedSize(username);
+
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
 
     outputStream << TLValue::AccountCheckUsername;
@@ -303,7 +528,11 @@ quint64 CTelegramConnection::accountCheckUsername(const QString &username)
 
 quint64 CTelegramConnection::accountDeleteAccount(const QString &reason)
 {
+    int outputSize = CTelegramStream::serializedSize(TLValue::AccountDeleteAccount);
+    outputSize += CTelegramStream::serializedSize(reason);
+
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
 
     outputStream << TLValue::AccountDeleteAccount;
@@ -314,7 +543,10 @@ quint64 CTelegramConnection::accountDeleteAccount(const QString &reason)
 
 quint64 CTelegramConnection::accountGetAccountTTL()
 {
+    int outputSize = CTelegramStream::serializedSize(TLValue::AccountGetAccountTTL);
+
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
 
     outputStream << TLValue::AccountGetAccountTTL;
@@ -324,7 +556,10 @@ quint64 CTelegramConnection::accountGetAccountTTL()
 
 quint64 CTelegramConnection::accountGetAuthorizations()
 {
+    int outputSize = CTelegramStream::serializedSize(TLValue::AccountGetAuthorizations);
+
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
 
     outputStream << TLValue::AccountGetAuthorizations;
@@ -334,7 +569,11 @@ quint64 CTelegramConnection::accountGetAuthorizations()
 
 quint64 CTelegramConnection::accountGetNotifySettings(const TLInputNotifyPeer &peer)
 {
+    int outputSize = CTelegramStream::serializedSize(TLValue::AccountGetNotifySettings);
+    outputSize += CTelegramStream::serializedSize(peer);
+
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
 
     outputStream << TLValue::AccountGetNotifySettings;
@@ -345,7 +584,10 @@ quint64 CTelegramConnection::accountGetNotifySettings(const TLInputNotifyPeer &p
 
 quint64 CTelegramConnection::accountGetPassword()
 {
+    int outputSize = CTelegramStream::serializedSize(TLValue::AccountGetPassword);
+
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
 
     outputStream << TLValue::AccountGetPassword;
@@ -355,7 +597,11 @@ quint64 CTelegramConnection::accountGetPassword()
 
 quint64 CTelegramConnection::accountGetPasswordSettings(const QByteArray &currentPasswordHash)
 {
+    int outputSize = CTelegramStream::serializedSize(TLValue::AccountGetPasswordSettings);
+    outputSize += CTelegramStream::serializedSize(currentPasswordHash);
+
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
 
     outputStream << TLValue::AccountGetPasswordSettings;
@@ -366,7 +612,11 @@ quint64 CTelegramConnection::accountGetPasswordSettings(const QByteArray &curren
 
 quint64 CTelegramConnection::accountGetPrivacy(const TLInputPrivacyKey &key)
 {
+    int outputSize = CTelegramStream::serializedSize(TLValue::AccountGetPrivacy);
+    outputSize += CTelegramStream::serializedSize(key);
+
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
 
     outputStream << TLValue::AccountGetPrivacy;
@@ -377,7 +627,10 @@ quint64 CTelegramConnection::accountGetPrivacy(const TLInputPrivacyKey &key)
 
 quint64 CTelegramConnection::accountGetWallPapers()
 {
+    int outputSize = CTelegramStream::serializedSize(TLValue::AccountGetWallPapers);
+
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
 
     outputStream << TLValue::AccountGetWallPapers;
@@ -387,7 +640,17 @@ quint64 CTelegramConnection::accountGetWallPapers()
 
 quint64 CTelegramConnection::accountRegisterDevice(quint32 tokenType, const QString &token, const QString &deviceModel, const QString &systemVersion, const QString &appVersion, bool appSandbox, const QString &langCode)
 {
+    int outputSize = CTelegramStream::serializedSize(TLValue::AccountRegisterDevice);
+    outputSize += CTelegramStream::serializedSize(tokenType);
+    outputSize += CTelegramStream::serializedSize(token);
+    outputSize += CTelegramStream::serializedSize(deviceModel);
+    outputSize += CTelegramStream::serializedSize(systemVersion);
+    outputSize += CTelegramStream::serializedSize(appVersion);
+    outputSize += CTelegramStream::serializedSize(appSandbox);
+    outputSize += CTelegramStream::serializedSize(langCode);
+
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
 
     outputStream << TLValue::AccountRegisterDevice;
@@ -404,7 +667,11 @@ quint64 CTelegramConnection::accountRegisterDevice(quint32 tokenType, const QStr
 
 quint64 CTelegramConnection::accountResetAuthorization(quint64 hash)
 {
+    int outputSize = CTelegramStream::serializedSize(TLValue::AccountResetAuthorization);
+    outputSize += CTelegramStream::serializedSize(hash);
+
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
 
     outputStream << TLValue::AccountResetAuthorization;
@@ -415,7 +682,10 @@ quint64 CTelegramConnection::accountResetAuthorization(quint64 hash)
 
 quint64 CTelegramConnection::accountResetNotifySettings()
 {
+    int outputSize = CTelegramStream::serializedSize(TLValue::AccountResetNotifySettings);
+
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
 
     outputStream << TLValue::AccountResetNotifySettings;
@@ -425,7 +695,11 @@ quint64 CTelegramConnection::accountResetNotifySettings()
 
 quint64 CTelegramConnection::accountSendChangePhoneCode(const QString &phoneNumber)
 {
+    int outputSize = CTelegramStream::serializedSize(TLValue::AccountSendChangePhoneCode);
+    outputSize += CTelegramStream::serializedSize(phoneNumber);
+
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
 
     outputStream << TLValue::AccountSendChangePhoneCode;
@@ -436,7 +710,11 @@ quint64 CTelegramConnection::accountSendChangePhoneCode(const QString &phoneNumb
 
 quint64 CTelegramConnection::accountSetAccountTTL(const TLAccountDaysTTL &ttl)
 {
+    int outputSize = CTelegramStream::serializedSize(TLValue::AccountSetAccountTTL);
+    outputSize += CTelegramStream::serializedSize(ttl);
+
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
 
     outputStream << TLValue::AccountSetAccountTTL;
@@ -447,7 +725,12 @@ quint64 CTelegramConnection::accountSetAccountTTL(const TLAccountDaysTTL &ttl)
 
 quint64 CTelegramConnection::accountSetPrivacy(const TLInputPrivacyKey &key, const TLVector<TLInputPrivacyRule> &rules)
 {
+    int outputSize = CTelegramStream::serializedSize(TLValue::AccountSetPrivacy);
+    outputSize += CTelegramStream::serializedSize(key);
+    outputSize += CTelegramStream::serializedSize(rules);
+
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
 
     outputStream << TLValue::AccountSetPrivacy;
@@ -459,7 +742,12 @@ quint64 CTelegramConnection::accountSetPrivacy(const TLInputPrivacyKey &key, con
 
 quint64 CTelegramConnection::accountUnregisterDevice(quint32 tokenType, const QString &token)
 {
+    int outputSize = CTelegramStream::serializedSize(TLValue::AccountUnregisterDevice);
+    outputSize += CTelegramStream::serializedSize(tokenType);
+    outputSize += CTelegramStream::serializedSize(token);
+
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
 
     outputStream << TLValue::AccountUnregisterDevice;
@@ -471,7 +759,11 @@ quint64 CTelegramConnection::accountUnregisterDevice(quint32 tokenType, const QS
 
 quint64 CTelegramConnection::accountUpdateDeviceLocked(quint32 period)
 {
+    int outputSize = CTelegramStream::serializedSize(TLValue::AccountUpdateDeviceLocked);
+    outputSize += CTelegramStream::serializedSize(period);
+
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
 
     outputStream << TLValue::AccountUpdateDeviceLocked;
@@ -482,7 +774,12 @@ quint64 CTelegramConnection::accountUpdateDeviceLocked(quint32 period)
 
 quint64 CTelegramConnection::accountUpdateNotifySettings(const TLInputNotifyPeer &peer, const TLInputPeerNotifySettings &settings)
 {
+    int outputSize = CTelegramStream::serializedSize(TLValue::AccountUpdateNotifySettings);
+    outputSize += CTelegramStream::serializedSize(peer);
+    outputSize += CTelegramStream::serializedSize(settings);
+
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
 
     outputStream << TLValue::AccountUpdateNotifySettings;
@@ -494,7 +791,12 @@ quint64 CTelegramConnection::accountUpdateNotifySettings(const TLInputNotifyPeer
 
 quint64 CTelegramConnection::accountUpdatePasswordSettings(const QByteArray &currentPasswordHash, const TLAccountPasswordInputSettings &newSettings)
 {
+    int outputSize = CTelegramStream::serializedSize(TLValue::AccountUpdatePasswordSettings);
+    outputSize += CTelegramStream::serializedSize(currentPasswordHash);
+    outputSize += CTelegramStream::serializedSize(newSettings);
+
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
 
     outputStream << TLValue::AccountUpdatePasswordSettings;
@@ -506,7 +808,12 @@ quint64 CTelegramConnection::accountUpdatePasswordSettings(const QByteArray &cur
 
 quint64 CTelegramConnection::accountUpdateProfile(const QString &firstName, const QString &lastName)
 {
+    int outputSize = CTelegramStream::serializedSize(TLValue::AccountUpdateProfile);
+    outputSize += CTelegramStream::serializedSize(firstName);
+    outputSize += CTelegramStream::serializedSize(lastName);
+
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
 
     outputStream << TLValue::AccountUpdateProfile;
@@ -518,7 +825,11 @@ quint64 CTelegramConnection::accountUpdateProfile(const QString &firstName, cons
 
 quint64 CTelegramConnection::accountUpdateStatus(bool offline)
 {
+    int outputSize = CTelegramStream::serializedSize(TLValue::AccountUpdateStatus);
+    outputSize += CTelegramStream::serializedSize(offline);
+
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
 
     outputStream << TLValue::AccountUpdateStatus;
@@ -529,7 +840,11 @@ quint64 CTelegramConnection::accountUpdateStatus(bool offline)
 
 quint64 CTelegramConnection::accountUpdateUsername(const QString &username)
 {
+    int outputSize = CTelegramStream::serializedSize(TLValue::AccountUpdateUsername);
+    outputSize += CTelegramStream::serializedSize(username);
+
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
 
     outputStream << TLValue::AccountUpdateUsername;
@@ -540,7 +855,14 @@ quint64 CTelegramConnection::accountUpdateUsername(const QString &username)
 
 quint64 CTelegramConnection::authBindTempAuthKey(quint64 permAuthKeyId, quint64 nonce, quint32 expiresAt, const QByteArray &encryptedMessage)
 {
+    int outputSize = CTelegramStream::serializedSize(TLValue::AuthBindTempAuthKey);
+    outputSize += CTelegramStream::serializedSize(permAuthKeyId);
+    outputSize += CTelegramStream::serializedSize(nonce);
+    outputSize += CTelegramStream::serializedSize(expiresAt);
+    outputSize += CTelegramStream::serializedSize(encryptedMessage);
+
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
 
     outputStream << TLValue::AuthBindTempAuthKey;
@@ -554,7 +876,11 @@ quint64 CTelegramConnection::authBindTempAuthKey(quint64 permAuthKeyId, quint64
 
 quint64 CTelegramConnection::authCheckPassword(const QByteArray &passwordHash)
 {
+    int outputSize = CTelegramStream::serializedSize(TLValue::AuthCheckPassword);
+    outputSize += CTelegramStream::serializedSize(passwordHash);
+
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
 
     outputStream << TLValue::AuthCheckPassword;
@@ -565,7 +891,11 @@ quint64 CTelegramConnection::authCheckPassword(const QByteArray &passwordHash)
 
 quint64 CTelegramConnection::authCheckPhone(const QString &phoneNumber)
 {
+    int outputSize = CTelegramStream::serializedSize(TLValue::AuthCheckPhone);
+    outputSize += CTelegramStream::serializedSize(phoneNumber);
+
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
 
     outputStream << TLValue::AuthCheckPhone;
@@ -576,7 +906,11 @@ quint64 CTelegramConnection::authCheckPhone(const QString &phoneNumber)
 
 quint64 CTelegramConnection::authExportAuthorization(quint32 dcId)
 {
+    int outputSize = CTelegramStream::serializedSize(TLValue::AuthExportAuthorization);
+    outputSize += CTelegramStream::serializedSize(dcId);
+
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
 
     outputStream << TLValue::AuthExportAuthorization;
@@ -587,7 +921,12 @@ quint64 CTelegramConnection::authExportAuthorization(quint32 dcId)
 
 quint64 CTelegramConnection::authImportAuthorization(quint32 id, const QByteArray &bytes)
 {
+    int outputSize = CTelegramStream::serializedSize(TLValue::AuthImportAuthorization);
+    outputSize += CTelegramStream::serializedSize(id);
+    outputSize += CTelegramStream::serializedSize(bytes);
+
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
 
     outputStream << TLValue::AuthImportAuthorization;
@@ -599,7 +938,10 @@ quint64 CTelegramConnection::authImportAuthorization(quint32 id, const QByteArra
 
 quint64 CTelegramConnection::authLogOut()
 {
+    int outputSize = CTelegramStream::serializedSize(TLValue::AuthLogOut);
+
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
 
     outputStream << TLValue::AuthLogOut;
@@ -609,7 +951,11 @@ quint64 CTelegramConnection::authLogOut()
 
 quint64 CTelegramConnection::authRecoverPassword(const QString &code)
 {
+    int outputSize = CTelegramStream::serializedSize(TLValue::AuthRecoverPassword);
+    outputSize += CTelegramStream::serializedSize(code);
+
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
 
     outputStream << TLValue::AuthRecoverPassword;
@@ -620,7 +966,10 @@ quint64 CTelegramConnection::authRecoverPassword(const QString &code)
 
 quint64 CTelegramConnection::authRequestPasswordRecovery()
 {
+    int outputSize = CTelegramStream::serializedSize(TLValue::AuthRequestPasswordRecovery);
+
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
 
     outputStream << TLValue::AuthRequestPasswordRecovery;
@@ -630,7 +979,10 @@ quint64 CTelegramConnection::authRequestPasswordRecovery()
 
 quint64 CTelegramConnection::authResetAuthorizations()
 {
+    int outputSize = CTelegramStream::serializedSize(TLValue::AuthResetAuthorizations);
+
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
 
     outputStream << TLValue::AuthResetAuthorizations;
@@ -640,7 +992,12 @@ quint64 CTelegramConnection::authResetAuthorizations()
 
 quint64 CTelegramConnection::authSendCall(const QString &phoneNumber, const QString &phoneCodeHash)
 {
+    int outputSize = CTelegramStream::serializedSize(TLValue::AuthSendCall);
+    outputSize += CTelegramStream::serializedSize(phoneNumber);
+    outputSize += CTelegramStream::serializedSize(phoneCodeHash);
+
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
 
     outputStream << TLValue::AuthSendCall;
@@ -652,7 +1009,15 @@ quint64 CTelegramConnection::authSendCall(const QString &phoneNumber, const QStr
 
 quint64 CTelegramConnection::authSendCode(const QString &phoneNumber, quint32 smsType, quint32 apiId, const QString &apiHash, const QString &langCode)
 {
+    int outputSize = CTelegramStream::serializedSize(TLValue::AuthSendCode);
+    outputSize += CTelegramStream::serializedSize(phoneNumber);
+    outputSize += CTelegramStream::serializedSize(smsType);
+    outputSize += CTelegramStream::serializedSize(apiId);
+    outputSize += CTelegramStream::serializedSize(apiHash);
+    outputSize += CTelegramStream::serializedSize(langCode);
+
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
 
     outputStream << TLValue::AuthSendCode;
@@ -667,7 +1032,12 @@ quint64 CTelegramConnection::authSendCode(const QString &phoneNumber, quint32 sm
 
 quint64 CTelegramConnection::authSendInvites(const TLVector<QString> &phoneNumbers, const QString &message)
 {
+    int outputSize = CTelegramStream::serializedSize(TLValue::AuthSendInvites);
+    outputSize += CTelegramStream::serializedSize(phoneNumbers);
+    outputSize += CTelegramStream::serializedSize(message);
+
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
 
     outputStream << TLValue::AuthSendInvites;
@@ -679,7 +1049,12 @@ quint64 CTelegramConnection::authSendInvites(const TLVector<QString> &phoneNumbe
 
 quint64 CTelegramConnection::authSendSms(const QString &phoneNumber, const QString &phoneCodeHash)
 {
+    int outputSize = CTelegramStream::serializedSize(TLValue::AuthSendSms);
+    outputSize += CTelegramStream::serializedSize(phoneNumber);
+    outputSize += CTelegramStream::serializedSize(phoneCodeHash);
+
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
 
     outputStream << TLValue::AuthSendSms;
@@ -691,7 +1066,13 @@ quint64 CTelegramConnection::authSendSms(const QString &phoneNumber, const QStri
 
 quint64 CTelegramConnection::authSignIn(const QString &phoneNumber, const QString &phoneCodeHash, const QString &phoneCode)
 {
+    int outputSize = CTelegramStream::serializedSize(TLValue::AuthSignIn);
+    outputSize += CTelegramStream::serializedSize(phoneNumber);
+    outputSize += CTelegramStream::serializedSize(phoneCodeHash);
+    outputSize += CTelegramStream::serializedSize(phoneCode);
+
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
 
     outputStream << TLValue::AuthSignIn;
@@ -704,7 +1085,15 @@ quint64 CTelegramConnection::authSignIn(const QString &phoneNumber, const QStrin
 
 quint64 CTelegramConnection::authSignUp(const QString &phoneNumber, const QString &phoneCodeHash, const QString &phoneCode, const QString &firstName, const QString &lastName)
 {
+    int outputSize = CTelegramStream::serializedSize(TLValue::AuthSignUp);
+    outputSize += CTelegramStream::serializedSize(phoneNumber);
+    outputSize += CTelegramStream::serializedSize(phoneCodeHash);
+    outputSize += CTelegramStream::serializedSize(phoneCode);
+    outputSize += CTelegramStream::serializedSize(firstName);
+    outputSize += CTelegramStream::serializedSize(lastName);
+
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
 
     outputStream << TLValue::AuthSignUp;
@@ -719,7 +1108,11 @@ quint64 CTelegramConnection::authSignUp(const QString &phoneNumber, const QStrin
 
 quint64 CTelegramConnection::contactsBlock(const TLInputUser &id)
 {
+    int outputSize = CTelegramStream::serializedSize(TLValue::ContactsBlock);
+    outputSize += CTelegramStream::serializedSize(id);
+
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
 
     outputStream << TLValue::ContactsBlock;
@@ -730,7 +1123,11 @@ quint64 CTelegramConnection::contactsBlock(const TLInputUser &id)
 
 quint64 CTelegramConnection::contactsDeleteContact(const TLInputUser &id)
 {
+    int outputSize = CTelegramStream::serializedSize(TLValue::ContactsDeleteContact);
+    outputSize += CTelegramStream::serializedSize(id);
+
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
 
     outputStream << TLValue::ContactsDeleteContact;
@@ -741,7 +1138,11 @@ quint64 CTelegramConnection::contactsDeleteContact(const TLInputUser &id)
 
 quint64 CTelegramConnection::contactsDeleteContacts(const TLVector<TLInputUser> &id)
 {
+    int outputSize = CTelegramStream::serializedSize(TLValue::ContactsDeleteContacts);
+    outputSize += CTelegramStream::serializedSize(id);
+
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
 
     outputStream << TLValue::ContactsDeleteContacts;
@@ -752,7 +1153,10 @@ quint64 CTelegramConnection::contactsDeleteContacts(const TLVector<TLInputUser>
 
 quint64 CTelegramConnection::contactsExportCard()
 {
+    int outputSize = CTelegramStream::serializedSize(TLValue::ContactsExportCard);
+
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
 
     outputStream << TLValue::ContactsExportCard;
@@ -762,7 +1166,12 @@ quint64 CTelegramConnection::contactsExportCard()
 
 quint64 CTelegramConnection::contactsGetBlocked(quint32 offset, quint32 limit)
 {
+    int outputSize = CTelegramStream::serializedSize(TLValue::ContactsGetBlocked);
+    outputSize += CTelegramStream::serializedSize(offset);
+    outputSize += CTelegramStream::serializedSize(limit);
+
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
 
     outputStream << TLValue::ContactsGetBlocked;
@@ -774,7 +1183,11 @@ quint64 CTelegramConnection::contactsGetBlocked(quint32 offset, quint32 limit)
 
 quint64 CTelegramConnection::contactsGetContacts(const QString &hash)
 {
+    int outputSize = CTelegramStream::serializedSize(TLValue::ContactsGetContacts);
+    outputSize += CTelegramStream::serializedSize(hash);
+
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
 
     outputStream << TLValue::ContactsGetContacts;
@@ -785,7 +1198,10 @@ quint64 CTelegramConnection::contactsGetContacts(const QString &hash)
 
 quint64 CTelegramConnection::contactsGetStatuses()
 {
+    int outputSize = CTelegramStream::serializedSize(TLValue::ContactsGetStatuses);
+
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
 
     outputStream << TLValue::ContactsGetStatuses;
@@ -795,7 +1211,11 @@ quint64 CTelegramConnection::contactsGetStatuses()
 
 quint64 CTelegramConnection::contactsGetSuggested(quint32 limit)
 {
+    int outputSize = CTelegramStream::serializedSize(TLValue::ContactsGetSuggested);
+    outputSize += CTelegramStream::serializedSize(limit);
+
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
 
     outputStream << TLValue::ContactsGetSuggested;
@@ -806,7 +1226,11 @@ quint64 CTelegramConnection::contactsGetSuggested(quint32 limit)
 
 quint64 CTelegramConnection::contactsImportCard(const TLVector<quint32> &exportCard)
 {
+    int outputSize = CTelegramStream::serializedSize(TLValue::ContactsImportCard);
+    outputSize += CTelegramStream::serializedSize(exportCard);
+
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
 
     outputStream << TLValue::ContactsImportCard;
@@ -817,7 +1241,12 @@ quint64 CTelegramConnection::contactsImportCard(const TLVector<quint32> &exportC
 
 quint64 CTelegramConnection::contactsImportContacts(const TLVector<TLInputContact> &contacts, bool replace)
 {
+    int outputSize = CTelegramStream::serializedSize(TLValue::ContactsImportContacts);
+    outputSize += CTelegramStream::serializedSize(contacts);
+    outputSize += CTelegramStream::serializedSize(replace);
+
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
 
     outputStream << TLValue::ContactsImportContacts;
@@ -829,7 +1258,11 @@ quint64 CTelegramConnection::contactsImportContacts(const TLVector<TLInputContac
 
 quint64 CTelegramConnection::contactsResolveUsername(const QString &username)
 {
+    int outputSize = CTelegramStream::serializedSize(TLValue::ContactsResolveUsername);
+    outputSize += CTelegramStream::serializedSize(username);
+
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
 
     outputStream << TLValue::ContactsResolveUsername;
@@ -840,7 +1273,12 @@ quint64 CTelegramConnection::contactsResolveUsername(const QString &username)
 
 quint64 CTelegramConnection::contactsSearch(const QString &q, quint32 limit)
 {
+    int outputSize = CTelegramStream::serializedSize(TLValue::ContactsSearch);
+    outputSize += CTelegramStream::serializedSize(q);
+    outputSize += CTelegramStream::serializedSize(limit);
+
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
 
     outputStream << TLValue::ContactsSearch;
@@ -852,7 +1290,11 @@ quint64 CTelegramConnection::contactsSearch(const QString &q, quint32 limit)
 
 quint64 CTelegramConnection::contactsUnblock(const TLInputUser &id)
 {
+    int outputSize = CTelegramStream::serializedSize(TLValue::ContactsUnblock);
+    outputSize += CTelegramStream::serializedSize(id);
+
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
 
     outputStream << TLValue::ContactsUnblock;
@@ -863,7 +1305,13 @@ quint64 CTelegramConnection::contactsUnblock(const TLInputUser &id)
 
 quint64 CTelegramConnection::messagesAcceptEncryption(const TLInputEncryptedChat &peer, const QByteArray &gB, quint64 keyFingerprint)
 {
+    int outputSize = CTelegramStream::serializedSize(TLValue::MessagesAcceptEncryption);
+    outputSize += CTelegramStream::serializedSize(peer);
+    outputSize += CTelegramStream::serializedSize(gB);
+    outputSize += CTelegramStream::serializedSize(keyFingerprint);
+
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
 
     outputStream << TLValue::MessagesAcceptEncryption;
@@ -876,7 +1324,13 @@ quint64 CTelegramConnection::messagesAcceptEncryption(const TLInputEncryptedChat
 
 quint64 CTelegramConnection::messagesAddChatUser(quint32 chatId, const TLInputUser &userId, quint32 fwdLimit)
 {
+    int outputSize = CTelegramStream::serializedSize(TLValue::MessagesAddChatUser);
+    outputSize += CTelegramStream::serializedSize(chatId);
+    outputSize += CTelegramStream::serializedSize(userId);
+    outputSize += CTelegramStream::serializedSize(fwdLimit);
+
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
 
     outputStream << TLValue::MessagesAddChatUser;
@@ -889,7 +1343,11 @@ quint64 CTelegramConnection::messagesAddChatUser(quint32 chatId, const TLInputUs
 
 quint64 CTelegramConnection::messagesCheckChatInvite(const QString &hash)
 {
+    int outputSize = CTelegramStream::serializedSize(TLValue::MessagesCheckChatInvite);
+    outputSize += CTelegramStream::serializedSize(hash);
+
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
 
     outputStream << TLValue::MessagesCheckChatInvite;
@@ -900,7 +1358,12 @@ quint64 CTelegramConnection::messagesCheckChatInvite(const QString &hash)
 
 quint64 CTelegramConnection::messagesCreateChat(const TLVector<TLInputUser> &users, const QString &title)
 {
+    int outputSize = CTelegramStream::serializedSize(TLValue::MessagesCreateChat);
+    outputSize += CTelegramStream::serializedSize(users);
+    outputSize += CTelegramStream::serializedSize(title);
+
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
 
     outputStream << TLValue::MessagesCreateChat;
@@ -912,7 +1375,12 @@ quint64 CTelegramConnection::messagesCreateChat(const TLVector<TLInputUser> &use
 
 quint64 CTelegramConnection::messagesDeleteChatUser(quint32 chatId, const TLInputUser &userId)
 {
+    int outputSize = CTelegramStream::serializedSize(TLValue::MessagesDeleteChatUser);
+    outputSize += CTelegramStream::serializedSize(chatId);
+    outputSize += CTelegramStream::serializedSize(userId);
+
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
 
     outputStream << TLValue::MessagesDeleteChatUser;
@@ -924,7 +1392,12 @@ quint64 CTelegramConnection::messagesDeleteChatUser(quint32 chatId, const TLInpu
 
 quint64 CTelegramConnection::messagesDeleteHistory(const TLInputPeer &peer, quint32 offset)
 {
+    int outputSize = CTelegramStream::serializedSize(TLValue::MessagesDeleteHistory);
+    outputSize += CTelegramStream::serializedSize(peer);
+    outputSize += CTelegramStream::serializedSize(offset);
+
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
 
     outputStream << TLValue::MessagesDeleteHistory;
@@ -936,7 +1409,11 @@ quint64 CTelegramConnection::messagesDeleteHistory(const TLInputPeer &peer, quin
 
 quint64 CTelegramConnection::messagesDeleteMessages(const TLVector<quint32> &id)
 {
+    int outputSize = CTelegramStream::serializedSize(TLValue::MessagesDeleteMessages);
+    outputSize += CTelegramStream::serializedSize(id);
+
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
 
     outputStream << TLValue::MessagesDeleteMessages;
@@ -947,7 +1424,11 @@ quint64 CTelegramConnection::messagesDeleteMessages(const TLVector<quint32> &id)
 
 quint64 CTelegramConnection::messagesDiscardEncryption(quint32 chatId)
 {
+    int outputSize = CTelegramStream::serializedSize(TLValue::MessagesDiscardEncryption);
+    outputSize += CTelegramStream::serializedSize(chatId);
+
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
 
     outputStream << TLValue::MessagesDiscardEncryption;
@@ -958,7 +1439,12 @@ quint64 CTelegramConnection::messagesDiscardEncryption(quint32 chatId)
 
 quint64 CTelegramConnection::messagesEditChatPhoto(quint32 chatId, const TLInputChatPhoto &photo)
 {
+    int outputSize = CTelegramStream::serializedSize(TLValue::MessagesEditChatPhoto);
+    outputSize += CTelegramStream::serializedSize(chatId);
+    outputSize += CTelegramStream::serializedSize(photo);
+
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
 
     outputStream << TLValue::MessagesEditChatPhoto;
@@ -970,7 +1456,12 @@ quint64 CTelegramConnection::messagesEditChatPhoto(quint32 chatId, const TLInput
 
 quint64 CTelegramConnection::messagesEditChatTitle(quint32 chatId, const QString &title)
 {
+    int outputSize = CTelegramStream::serializedSize(TLValue::MessagesEditChatTitle);
+    outputSize += CTelegramStream::serializedSize(chatId);
+    outputSize += CTelegramStream::serializedSize(title);
+
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
 
     outputStream << TLValue::MessagesEditChatTitle;
@@ -982,7 +1473,11 @@ quint64 CTelegramConnection::messagesEditChatTitle(quint32 chatId, const QString
 
 quint64 CTelegramConnection::messagesExportChatInvite(quint32 chatId)
 {
+    int outputSize = CTelegramStream::serializedSize(TLValue::MessagesExportChatInvite);
+    outputSize += CTelegramStream::serializedSize(chatId);
+
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
 
     outputStream << TLValue::MessagesExportChatInvite;
@@ -993,7 +1488,13 @@ quint64 CTelegramConnection::messagesExportChatInvite(quint32 chatId)
 
 quint64 CTelegramConnection::messagesForwardMessage(const TLInputPeer &peer, quint32 id, quint64 randomId)
 {
+    int outputSize = CTelegramStream::serializedSize(TLValue::MessagesForwardMessage);
+    outputSize += CTelegramStream::serializedSize(peer);
+    outputSize += CTelegramStream::serializedSize(id);
+    outputSize += CTelegramStream::serializedSize(randomId);
+
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
 
     outputStream << TLValue::MessagesForwardMessage;
@@ -1006,7 +1507,13 @@ quint64 CTelegramConnection::messagesForwardMessage(const TLInputPeer &peer, qui
 
 quint64 CTelegramConnection::messagesForwardMessages(const TLInputPeer &peer, const TLVector<quint32> &id, const TLVector<quint64> &randomId)
 {
+    int outputSize = CTelegramStream::serializedSize(TLValue::MessagesForwardMessages);
+    outputSize += CTelegramStream::serializedSize(peer);
+    outputSize += CTelegramStream::serializedSize(id);
+    outputSize += CTelegramStream::serializedSize(randomId);
+
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
 
     outputStream << TLValue::MessagesForwardMessages;
@@ -1019,7 +1526,11 @@ quint64 CTelegramConnection::messagesForwardMessages(const TLInputPeer &peer, co
 
 quint64 CTelegramConnection::messagesGetAllStickers(const QString &hash)
 {
+    int outputSize = CTelegramStream::serializedSize(TLValue::MessagesGetAllStickers);
+    outputSize += CTelegramStream::serializedSize(hash);
+
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
 
     outputStream << TLValue::MessagesGetAllStickers;
@@ -1030,7 +1541,11 @@ quint64 CTelegramConnection::messagesGetAllStickers(const QString &hash)
 
 quint64 CTelegramConnection::messagesGetChats(const TLVector<quint32> &id)
 {
+    int outputSize = CTelegramStream::serializedSize(TLValue::MessagesGetChats);
+    outputSize += CTelegramStream::serializedSize(id);
+
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
 
     outputStream << TLValue::MessagesGetChats;
@@ -1041,7 +1556,12 @@ quint64 CTelegramConnection::messagesGetChats(const TLVector<quint32> &id)
 
 quint64 CTelegramConnection::messagesGetDhConfig(quint32 version, quint32 randomLength)
 {
+    int outputSize = CTelegramStream::serializedSize(TLValue::MessagesGetDhConfig);
+    outputSize += CTelegramStream::serializedSize(version);
+    outputSize += CTelegramStream::serializedSize(randomLength);
+
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
 
     outputStream << TLValue::MessagesGetDhConfig;
@@ -1053,7 +1573,13 @@ quint64 CTelegramConnection::messagesGetDhConfig(quint32 version, quint32 random
 
 quint64 CTelegramConnection::messagesGetDialogs(quint32 offset, quint32 maxId, quint32 limit)
 {
+    int outputSize = CTelegramStream::serializedSize(TLValue::MessagesGetDialogs);
+    outputSize += CTelegramStream::serializedSize(offset);
+    outputSize += CTelegramStream::serializedSize(maxId);
+    outputSize += CTelegramStream::serializedSize(limit);
+
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
 
     outputStream << TLValue::MessagesGetDialogs;
@@ -1066,7 +1592,11 @@ quint64 CTelegramConnection::messagesGetDialogs(quint32 offset, quint32 maxId, q
 
 quint64 CTelegramConnection::messagesGetFullChat(quint32 chatId)
 {
+    int outputSize = CTelegramStream::serializedSize(TLValue::MessagesGetFullChat);
+    outputSize += CTelegramStream::serializedSize(chatId);
+
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
 
     outputStream << TLValue::MessagesGetFullChat;
@@ -1077,7 +1607,14 @@ quint64 CTelegramConnection::messagesGetFullChat(quint32 chatId)
 
 quint64 CTelegramConnection::messagesGetHistory(const TLInputPeer &peer, quint32 offset, quint32 maxId, quint32 limit)
 {
+    int outputSize = CTelegramStream::serializedSize(TLValue::MessagesGetHistory);
+    outputSize += CTelegramStream::serializedSize(peer);
+    outputSize += CTelegramStream::serializedSize(offset);
+    outputSize += CTelegramStream::serializedSize(maxId);
+    outputSize += CTelegramStream::serializedSize(limit);
+
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
 
     outputStream << TLValue::MessagesGetHistory;
@@ -1091,7 +1628,11 @@ quint64 CTelegramConnection::messagesGetHistory(const TLInputPeer &peer, quint32
 
 quint64 CTelegramConnection::messagesGetMessages(const TLVector<quint32> &id)
 {
+    int outputSize = CTelegramStream::serializedSize(TLValue::MessagesGetMessages);
+    outputSize += CTelegramStream::serializedSize(id);
+
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
 
     outputStream << TLValue::MessagesGetMessages;
@@ -1102,7 +1643,11 @@ quint64 CTelegramConnection::messagesGetMessages(const TLVector<quint32> &id)
 
 quint64 CTelegramConnection::messagesGetStickerSet(const TLInputStickerSet &stickerset)
 {
+    int outputSize = CTelegramStream::serializedSize(TLValue::MessagesGetStickerSet);
+    outputSize += CTelegramStream::serializedSize(stickerset);
+
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
 
     outputStream << TLValue::MessagesGetStickerSet;
@@ -1113,7 +1658,12 @@ quint64 CTelegramConnection::messagesGetStickerSet(const TLInputStickerSet &stic
 
 quint64 CTelegramConnection::messagesGetStickers(const QString &emoticon, const QString &hash)
 {
+    int outputSize = CTelegramStream::serializedSize(TLValue::MessagesGetStickers);
+    outputSize += CTelegramStream::serializedSize(emoticon);
+    outputSize += CTelegramStream::serializedSize(hash);
+
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
 
     outputStream << TLValue::MessagesGetStickers;
@@ -1125,7 +1675,11 @@ quint64 CTelegramConnection::messagesGetStickers(const QString &emoticon, const
 
 quint64 CTelegramConnection::messagesGetWebPagePreview(const QString &message)
 {
+    int outputSize = CTelegramStream::serializedSize(TLValue::MessagesGetWebPagePreview);
+    outputSize += CTelegramStream::serializedSize(message);
+
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
 
     outputStream << TLValue::MessagesGetWebPagePreview;
@@ -1136,7 +1690,11 @@ quint64 CTelegramConnection::messagesGetWebPagePreview(const QString &message)
 
 quint64 CTelegramConnection::messagesImportChatInvite(const QString &hash)
 {
+    int outputSize = CTelegramStream::serializedSize(TLValue::MessagesImportChatInvite);
+    outputSize += CTelegramStream::serializedSize(hash);
+
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
 
     outputStream << TLValue::MessagesImportChatInvite;
@@ -1147,7 +1705,11 @@ quint64 CTelegramConnection::messagesImportChatInvite(const QString &hash)
 
 quint64 CTelegramConnection::messagesInstallStickerSet(const TLInputStickerSet &stickerset)
 {
+    int outputSize = CTelegramStream::serializedSize(TLValue::MessagesInstallStickerSet);
+    outputSize += CTelegramStream::serializedSize(stickerset);
+
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
 
     outputStream << TLValue::MessagesInstallStickerSet;
@@ -1158,7 +1720,12 @@ quint64 CTelegramConnection::messagesInstallStickerSet(const TLInputStickerSet &
 
 quint64 CTelegramConnection::messagesReadEncryptedHistory(const TLInputEncryptedChat &peer, quint32 maxDate)
 {
+    int outputSize = CTelegramStream::serializedSize(TLValue::MessagesReadEncryptedHistory);
+    outputSize += CTelegramStream::serializedSize(peer);
+    outputSize += CTelegramStream::serializedSize(maxDate);
+
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
 
     outputStream << TLValue::MessagesReadEncryptedHistory;
@@ -1170,7 +1737,13 @@ quint64 CTelegramConnection::messagesReadEncryptedHistory(const TLInputEncrypted
 
 quint64 CTelegramConnection::messagesReadHistory(const TLInputPeer &peer, quint32 maxId, quint32 offset)
 {
+    int outputSize = CTelegramStream::serializedSize(TLValue::MessagesReadHistory);
+    outputSize += CTelegramStream::serializedSize(peer);
+    outputSize += CTelegramStream::serializedSize(maxId);
+    outputSize += CTelegramStream::serializedSize(offset);
+
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
 
     outputStream << TLValue::MessagesReadHistory;
@@ -1183,7 +1756,11 @@ quint64 CTelegramConnection::messagesReadHistory(const TLInputPeer &peer, quint3
 
 quint64 CTelegramConnection::messagesReadMessageContents(const TLVector<quint32> &id)
 {
+    int outputSize = CTelegramStream::serializedSize(TLValue::MessagesReadMessageContents);
+    outputSize += CTelegramStream::serializedSize(id);
+
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
 
     outputStream << TLValue::MessagesReadMessageContents;
@@ -1194,7 +1771,11 @@ quint64 CTelegramConnection::messagesReadMessageContents(const TLVector<quint32>
 
 quint64 CTelegramConnection::messagesReceivedMessages(quint32 maxId)
 {
+    int outputSize = CTelegramStream::serializedSize(TLValue::MessagesReceivedMessages);
+    outputSize += CTelegramStream::serializedSize(maxId);
+
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
 
     outputStream << TLValue::MessagesReceivedMessages;
@@ -1205,7 +1786,11 @@ quint64 CTelegramConnection::messagesReceivedMessages(quint32 maxId)
 
 quint64 CTelegramConnection::messagesReceivedQueue(quint32 maxQts)
 {
+    int outputSize = CTelegramStream::serializedSize(TLValue::MessagesReceivedQueue);
+    outputSize += CTelegramStream::serializedSize(maxQts);
+
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
 
     outputStream << TLValue::MessagesReceivedQueue;
@@ -1216,7 +1801,13 @@ quint64 CTelegramConnection::messagesReceivedQueue(quint32 maxQts)
 
 quint64 CTelegramConnection::messagesRequestEncryption(const TLInputUser &userId, quint32 randomId, const QByteArray &gA)
 {
+    int outputSize = CTelegramStream::serializedSize(TLValue::MessagesRequestEncryption);
+    outputSize += CTelegramStream::serializedSize(userId);
+    outputSize += CTelegramStream::serializedSize(randomId);
+    outputSize += CTelegramStream::serializedSize(gA);
+
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
 
     outputStream << TLValue::MessagesRequestEncryption;
@@ -1229,7 +1820,18 @@ quint64 CTelegramConnection::messagesRequestEncryption(const TLInputUser &userId
 
 quint64 CTelegramConnection::messagesSearch(const TLInputPeer &peer, const QString &q, const TLMessagesFilter &filter, quint32 minDate, quint32 maxDate, quint32 offset, quint32 maxId, quint32 limit)
 {
+    int outputSize = CTelegramStream::serializedSize(TLValue::MessagesSearch);
+    outputSize += CTelegramStream::serializedSize(peer);
+    outputSize += CTelegramStream::serializedSize(q);
+    outputSize += CTelegramStream::serializedSize(filter);
+    outputSize += CTelegramStream::serializedSize(minDate);
+    outputSize += CTelegramStream::serializedSize(maxDate);
+    outputSize += CTelegramStream::serializedSize(offset);
+    outputSize += CTelegramStream::serializedSize(maxId);
+    outputSize += CTelegramStream::serializedSize(limit);
+
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
 
     outputStream << TLValue::MessagesSearch;
@@ -1247,7 +1849,14 @@ quint64 CTelegramConnection::messagesSearch(const TLInputPeer &peer, const QStri
 
 quint64 CTelegramConnection::messagesSendBroadcast(const TLVector<TLInputUser> &contacts, const TLVector<quint64> &randomId, const QString &message, const TLInputMedia &media)
 {
+    int outputSize = CTelegramStream::serializedSize(TLValue::MessagesSendBroadcast);
+    outputSize += CTelegramStream::serializedSize(contacts);
+    outputSize += CTelegramStream::serializedSize(randomId);
+    outputSize += CTelegramStream::serializedSize(message);
+    outputSize += CTelegramStream::serializedSize(media);
+
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
 
     outputStream << TLValue::MessagesSendBroadcast;
@@ -1261,7 +1870,13 @@ quint64 CTelegramConnection::messagesSendBroadcast(const TLVector<TLInputUser> &
 
 quint64 CTelegramConnection::messagesSendEncrypted(const TLInputEncryptedChat &peer, quint64 randomId, const QByteArray &data)
 {
+    int outputSize = CTelegramStream::serializedSize(TLValue::MessagesSendEncrypted);
+    outputSize += CTelegramStream::serializedSize(peer);
+    outputSize += CTelegramStream::serializedSize(randomId);
+    outputSize += CTelegramStream::serializedSize(data);
+
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
 
     outputStream << TLValue::MessagesSendEncrypted;
@@ -1274,7 +1889,14 @@ quint64 CTelegramConnection::messagesSendEncrypted(const TLInputEncryptedChat &p
 
 quint64 CTelegramConnection::messagesSendEncryptedFile(const TLInputEncryptedChat &peer, quint64 randomId, const QByteArray &data, const TLInputEncryptedFile &file)
 {
+    int outputSize = CTelegramStream::serializedSize(TLValue::MessagesSendEncryptedFile);
+    outputSize += CTelegramStream::serializedSize(peer);
+    outputSize += CTelegramStream::serializedSize(randomId);
+    outputSize += CTelegramStream::serializedSize(data);
+    outputSize += CTelegramStream::serializedSize(file);
+
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
 
     outputStream << TLValue::MessagesSendEncryptedFile;
@@ -1288,7 +1910,13 @@ quint64 CTelegramConnection::messagesSendEncryptedFile(const TLInputEncryptedCha
 
 quint64 CTelegramConnection::messagesSendEncryptedService(const TLInputEncryptedChat &peer, quint64 randomId, const QByteArray &data)
 {
+    int outputSize = CTelegramStream::serializedSize(TLValue::MessagesSendEncryptedService);
+    outputSize += CTelegramStream::serializedSize(peer);
+    outputSize += CTelegramStream::serializedSize(randomId);
+    outputSize += CTelegramStream::serializedSize(data);
+
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
 
     outputStream << TLValue::MessagesSendEncryptedService;
@@ -1301,7 +1929,17 @@ quint64 CTelegramConnection::messagesSendEncryptedService(const TLInputEncrypted
 
 quint64 CTelegramConnection::messagesSendMedia(quint32 flags, const TLInputPeer &peer, quint32 replyToMsgId, const TLInputMedia &media, quint64 randomId)
 {
+    int outputSize = CTelegramStream::serializedSize(TLValue::MessagesSendMedia);
+    outputSize += CTelegramStream::serializedSize(flags);
+    outputSize += CTelegramStream::serializedSize(peer);
+    if (flags & 1 << 0) {
+        outputSize += CTelegramStream::serializedSize(replyToMsgId);
+    }
+    outputSize += CTelegramStream::serializedSize(media);
+    outputSize += CTelegramStream::serializedSize(randomId);
+
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
 
     outputStream << TLValue::MessagesSendMedia;
@@ -1318,7 +1956,17 @@ quint64 CTelegramConnection::messagesSendMedia(quint32 flags, const TLInputPeer
 
 quint64 CTelegramConnection::messagesSendMessage(quint32 flags, const TLInputPeer &peer, quint32 replyToMsgId, const QString &message, quint64 randomId)
 {
+    int outputSize = CTelegramStream::serializedSize(TLValue::MessagesSendMessage);
+    outputSize += CTelegramStream::serializedSize(flags);
+    outputSize += CTelegramStream::serializedSize(peer);
+    if (flags & 1 << 0) {
+        outputSize += CTelegramStream::serializedSize(replyToMsgId);
+    }
+    outputSize += CTelegramStream::serializedSize(message);
+    outputSize += CTelegramStream::serializedSize(randomId);
+
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
 
     outputStream << TLValue::MessagesSendMessage;
@@ -1335,7 +1983,12 @@ quint64 CTelegramConnection::messagesSendMessage(quint32 flags, const TLInputPee
 
 quint64 CTelegramConnection::messagesSetEncryptedTyping(const TLInputEncryptedChat &peer, bool typing)
 {
+    int outputSize = CTelegramStream::serializedSize(TLValue::MessagesSetEncryptedTyping);
+    outputSize += CTelegramStream::serializedSize(peer);
+    outputSize += CTelegramStream::serializedSize(typing);
+
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
 
     outputStream << TLValue::MessagesSetEncryptedTyping;
@@ -1347,7 +2000,12 @@ quint64 CTelegramConnection::messagesSetEncryptedTyping(const TLInputEncryptedCh
 
 quint64 CTelegramConnection::messagesSetTyping(const TLInputPeer &peer, const TLSendMessageAction &action)
 {
+    int outputSize = CTelegramStream::serializedSize(TLValue::MessagesSetTyping);
+    outputSize += CTelegramStream::serializedSize(peer);
+    outputSize += CTelegramStream::serializedSize(action);
+
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
 
     outputStream << TLValue::MessagesSetTyping;
@@ -1359,7 +2017,11 @@ quint64 CTelegramConnection::messagesSetTyping(const TLInputPeer &peer, const TL
 
 quint64 CTelegramConnection::messagesUninstallStickerSet(const TLInputStickerSet &stickerset)
 {
+    int outputSize = CTelegramStream::serializedSize(TLValue::MessagesUninstallStickerSet);
+    outputSize += CTelegramStream::serializedSize(stickerset);
+
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
 
     outputStream << TLValue::MessagesUninstallStickerSet;
@@ -1370,7 +2032,13 @@ quint64 CTelegramConnection::messagesUninstallStickerSet(const TLInputStickerSet
 
 quint64 CTelegramConnection::updatesGetDifference(quint32 pts, quint32 date, quint32 qts)
 {
+    int outputSize = CTelegramStream::serializedSize(TLValue::UpdatesGetDifference);
+    outputSize += CTelegramStream::serializedSize(pts);
+    outputSize += CTelegramStream::serializedSize(date);
+    outputSize += CTelegramStream::serializedSize(qts);
+
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
 
     outputStream << TLValue::UpdatesGetDifference;
@@ -1383,7 +2051,10 @@ quint64 CTelegramConnection::updatesGetDifference(quint32 pts, quint32 date, qui
 
 quint64 CTelegramConnection::updatesGetState()
 {
+    int outputSize = CTelegramStream::serializedSize(TLValue::UpdatesGetState);
+
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
 
     outputStream << TLValue::UpdatesGetState;
@@ -1393,7 +2064,13 @@ quint64 CTelegramConnection::updatesGetState()
 
 quint64 CTelegramConnection::uploadGetFile(const TLInputFileLocation &location, quint32 offset, quint32 limit)
 {
+    int outputSize = CTelegramStream::serializedSize(TLValue::UploadGetFile);
+    outputSize += CTelegramStream::serializedSize(location);
+    outputSize += CTelegramStream::serializedSize(offset);
+    outputSize += CTelegramStream::serializedSize(limit);
+
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
 
     outputStream << TLValue::UploadGetFile;
@@ -1406,7 +2083,14 @@ quint64 CTelegramConnection::uploadGetFile(const TLInputFileLocation &location,
 
 quint64 CTelegramConnection::uploadSaveBigFilePart(quint64 fileId, quint32 filePart, quint32 fileTotalParts, const QByteArray &bytes)
 {
+    int outputSize = CTelegramStream::serializedSize(TLValue::UploadSaveBigFilePart);
+    outputSize += CTelegramStream::serializedSize(fileId);
+    outputSize += CTelegramStream::serializedSize(filePart);
+    outputSize += CTelegramStream::serializedSize(fileTotalParts);
+    outputSize += CTelegramStream::serializedSize(bytes);
+
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
 
     outputStream << TLValue::UploadSaveBigFilePart;
@@ -1420,7 +2104,13 @@ quint64 CTelegramConnection::uploadSaveBigFilePart(quint64 fileId, quint32 fileP
 
 quint64 CTelegramConnection::uploadSaveFilePart(quint64 fileId, quint32 filePart, const QByteArray &bytes)
 {
+    int outputSize = CTelegramStream::serializedSize(TLValue::UploadSaveFilePart);
+    outputSize += CTelegramStream::serializedSize(fileId);
+    outputSize += CTelegramStream::serializedSize(filePart);
+    outputSize += CTelegramStream::serializedSize(bytes);
+
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
 
     outputStream << TLValue::UploadSaveFilePart;
@@ -1433,7 +2123,11 @@ quint64 CTelegramConnection::uploadSaveFilePart(quint64 fileId, quint32 filePart
 
 quint64 CTelegramConnection::usersGetFullUser(const TLInputUser &id)
 {
+    int outputSize = CTelegramStream::serializedSize(TLValue::UsersGetFullUser);
+    outputSize += CTelegramStream::serializedSize(id);
+
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
 
     outputStream << TLValue::UsersGetFullUser;
@@ -1444,7 +2138,11 @@ quint64 CTelegramConnection::usersGetFullUser(const TLInputUser &id)
 
 quint64 CTelegramConnection::usersGetUsers(const TLVector<TLInputUser> &id)
 {
+    int outputSize = CTelegramStream::serializedSize(TLValue::UsersGetUsers);
+    outputSize += CTelegramStream::serializedSize(id);
+
     QByteArray output;
+    output.reserve(outputSize);
     CTelegramStream outputStream(&output, /* write */ true);
 
     outputStream << TLValue::UsersGetUsers;
@@ -1455,1726 +2153,3540 @@ quint64 CTelegramConnection::usersGetUsers(const TLVector<TLInputUser> &id)
 
 // End of generated Telegram API methods implementation
 
-quint64 CTelegramConnection::ping()
+// Generated RPC result readers implementation
+TLValue CTelegramConnection::readAccountChangePhoneResult(CTelegramStream &stream, quint64 id)
 {
-//    qDebug() << Q_FUNC_INFO;
-    QByteArray output;
-    CTelegramStream outputStream(&output, /* write */ true);
+    TLShared<TLUser> result;
+    stream >> result;
+    const TLValue resultType = result->tlType;
 
-    outputStream << TLValue::Ping;
-    outputStream << ++m_lastSentPingId;
+    if (isRpcResultPayload(resultType) && !stream.error()) {
+        emit accountChangePhoneResultReceived(id, result);
+    }
 
-    return sendEncryptedPackage(output);
+    return resultType;
 }
 
-quint64 CTelegramConnection::pingDelayDisconnect(quint32 disconnectInSec)
+TLValue CTelegramConnection::readAccountDeleteAccountResult(CTelegramStream &stream, quint64 id)
 {
-//    qDebug() << Q_FUNC_INFO << disconnectInSec;
-    QByteArray output;
-    CTelegramStream outputStream(&output, /* write */ true);
+    TLValue result;
+    stream >> result;
 
-    outputStream << TLValue::PingDelayDisconnect;
-    outputStream << ++m_lastSentPingId;
-    outputStream << disconnectInSec;
+    if ((result == TLValue::BoolTrue) || (result == TLValue::BoolFalse)) {
+        emit accountDeleteAccountResultReceived(id, result == TLValue::BoolTrue);
+    }
 
-    return sendEncryptedPackage(output);
+    return result;
 }
 
-quint64 CTelegramConnection::acknowledgeMessages(const TLVector<quint64> &idsVector)
+TLValue CTelegramConnection::readAccountGetAccountTTLResult(CTelegramStream &stream, quint64 id)
 {
-//    qDebug() << Q_FUNC_INFO << idsVector;
-
-    QByteArray output;
-    CTelegramStream outputStream(&output, /* write */ true);
+    TLShared<TLAccountDaysTTL> result;
+    stream >> result;
+    const TLValue resultType = result->tlType;
 
-    outputStream << TLValue::MsgsAck;
-    outputStream << idsVector;
+    if (isRpcResultPayload(resultType) && !stream.error()) {
+        emit accountGetAccountTTLResultReceived(id, result);
+    }
 
-    return sendEncryptedPackage(output, /* save package */ false);
+    return resultType;
 }
 
-bool CTelegramConnection::answerPqAuthorization(const QByteArray &payload)
+TLValue CTelegramConnection::readAccountGetAuthorizationsResult(CTelegramStream &stream, quint64 id)
 {
-    CTelegramStream inputStream(payload);
-
-    TLValue responsePqValue;
-    inputStream >> responsePqValue;
+    TLShared<TLAccountAuthorizations> result;
+    stream >> result;
+    const TLValue resultType = result->tlType;
 
-    if (responsePqValue != TLValue::ResPQ) {
-        qDebug() << "Error: Unexpected operation code";
-        return false;
+    if (isRpcResultPayload(resultType) && !stream.error()) {
+        emit accountGetAuthorizationsResultReceived(id, result);
     }
 
-    TLNumber128 clientNonce;
-    TLNumber128 serverNonce;
+    return resultType;
+}
 
-    inputStream >> clientNonce;
+TLValue CTelegramConnection::readAccountGetNotifySettingsResult(CTelegramStream &stream, quint64 id)
+{
+    TLShared<TLPeerNotifySettings> result;
+    stream >> result;
+    const TLValue resultType = result->tlType;
 
-    if (clientNonce != m_clientNonce) {
-        qDebug() << "Error: Client nonce in incoming package is different from our own.";
-        return false;
+    if (isRpcResultPayload(resultType) && !stream.error()) {
+        emit accountGetNotifySettingsResultReceived(id, result);
     }
 
-    inputStream >> serverNonce;
+    return resultType;
+}
 
-    m_serverNonce = serverNonce;
+TLValue CTelegramConnection::readAccountGetPasswordResult(CTelegramStream &stream, quint64 id)
+{
+    TLShared<TLAccountPassword> result;
+    stream >> result;
+    const TLValue resultType = result->tlType;
 
-    QByteArray pq;
+    if (isRpcResultPayload(resultType) && !stream.error()) {
+        emit accountGetPasswordResultReceived(id, result);
+    }
 
-    inputStream >> pq;
+    return resultType;
+}
 
-    if (pq.size() != 8) {
-        qDebug() << "Error: PQ should be 8 bytes in length";
-        return false;
+TLValue CTelegramConnection::readAccountGetPasswordSettingsResult(CTelegramStream &stream, quint64 id)
+{
+    TLShared<TLAccountPasswordSettings> result;
+    stream >> result;
+    const TLValue resultType = result->tlType;
+
+    if (isRpcResultPayload(resultType) && !stream.error()) {
+        emit accountGetPasswordSettingsResultReceived(id, result);
     }
 
-    m_pq = qFromBigEndian<quint64>((uchar *) pq.data());
+    return resultType;
+}
 
-    quint64 div1 = Utils::findDivider(m_pq);
+TLValue CTelegramConnection::readAccountGetPrivacyResult(CTelegramStream &stream, quint64 id)
+{
+    TLShared<TLAccountPrivacyRules> result;
+    stream >> result;
+    const TLValue resultType = result->tlType;
 
-    if (div1 == 1) {
-        qDebug() << "Error: Can not solve PQ.";
-        return false;
+    if (isRpcResultPayload(resultType) && !stream.error()) {
+        emit accountGetPrivacyResultReceived(id, result);
     }
-    quint64 div2 = m_pq / div1;
 
-    if (div1 < div2) {
-        m_p = div1;
-        m_q = div2;
-    } else {
-        m_p = div2;
-        m_q = div1;
-    }
-
-    TLVector<quint64> fingersprints;
+    return resultType;
+}
 
-    inputStream >> fingersprints;
+TLValue CTelegramConnection::readAccountGetWallPapersResult(CTelegramStream &stream, quint64 id)
+{
+    TLVector<TLWallPaper> result;
+    stream >> result;
 
-    if (fingersprints.count() != 1) {
-        qDebug() << "Error: Unexpected Server RSA Fingersprints vector.";
-        return false;
+    if (isRpcResultPayload(result.tlType) && !stream.error()) {
+        emit accountGetWallPapersResultReceived(id, result);
     }
 
-    m_serverPublicFingersprint = fingersprints.at(0);
+    return result.tlType;
+}
 
-    if (m_rsaKey.fingersprint != m_serverPublicFingersprint) {
-        qDebug() << "Error: Server RSA Fingersprint does not match to loaded key";
-        return false;
+TLValue CTelegramConnection::readAccountRegisterDeviceResult(CTelegramStream &stream, quint64 id)
+{
+    TLValue result;
+    stream >> result;
+
+    if ((result == TLValue::BoolTrue) || (result == TLValue::BoolFalse)) {
+        emit accountRegisterDeviceResultReceived(id, result == TLValue::BoolTrue);
     }
 
-    return true;
+    return result;
 }
 
-void CTelegramConnection::requestDhParameters()
+TLValue CTelegramConnection::readAccountResetAuthorizationResult(CTelegramStream &stream, quint64 id)
 {
-    Utils::randomBytes(m_newNonce.data, m_newNonce.size());
+    TLValue result;
+    stream >> result;
 
-    QByteArray bigEndianNumber;
-    bigEndianNumber.fill(char(0), 8);
+    if ((result == TLValue::BoolTrue) || (result == TLValue::BoolFalse)) {
+        emit accountResetAuthorizationResultReceived(id, result == TLValue::BoolTrue);
+    }
 
-    QByteArray encryptedPackage;
-    {
-        static const int requestedEncryptedPackageLength = 255;
-        QByteArray innerData;
-        CTelegramStream encryptedStream(&innerData, /* write */ true);
+    return result;
+}
 
-        encryptedStream << TLValue::PQInnerData;
+TLValue CTelegramConnection::readAccountResetNotifySettingsResult(CTelegramStream &stream, quint64 id)
+{
+    TLValue result;
+    stream >> result;
 
-        qToBigEndian(m_pq, (uchar *) bigEndianNumber.data());
-        encryptedStream << bigEndianNumber;
+    if ((result == TLValue::BoolTrue) || (result == TLValue::BoolFalse)) {
+        emit accountResetNotifySettingsResultReceived(id, result == TLValue::BoolTrue);
+    }
 
-        bigEndianNumber.fill(char(0), 4);
-        qToBigEndian(m_p, (uchar *) bigEndianNumber.data());
-        encryptedStream << bigEndianNumber;
+    return result;
+}
 
-        qToBigEndian(m_q, (uchar *) bigEndianNumber.data());
-        encryptedStream << bigEndianNumber;
+TLValue CTelegramConnection::readAccountSendChangePhoneCodeResult(CTelegramStream &stream, quint64 id)
+{
+    TLShared<TLAccountSentChangePhoneCode> result;
+    stream >> result;
+    const TLValue resultType = result->tlType;
 
-        encryptedStream << m_clientNonce;
-        encryptedStream << m_serverNonce;
-        encryptedStream << m_newNonce;
+    if (isRpcResultPayload(resultType) && !stream.error()) {
+        emit accountSendChangePhoneCodeResultReceived(id, result);
+    }
 
-        QByteArray sha = Utils::sha1(innerData);
-        QByteArray randomPadding;
-        randomPadding.resize(requestedEncryptedPackageLength - (sha.length() + innerData.length()));
-        Utils::randomBytes(&randomPadding);
+    return resultType;
+}
 
-        encryptedPackage = Utils::rsa(sha + innerData + randomPadding, m_rsaKey);
-    }
+TLValue CTelegramConnection::readAccountSetAccountTTLResult(CTelegramStream &stream, quint64 id)
+{
+    TLValue result;
+    stream >> result;
 
-    QByteArray output;
-    CTelegramStream outputStream(&output, /* write */ true);
+    if ((result == TLValue::BoolTrue) || (result == TLValue::BoolFalse)) {
+        emit accountSetAccountTTLResultReceived(id, result == TLValue::BoolTrue);
+    }
 
-    outputStream << TLValue::ReqDHParams;
-    outputStream << m_clientNonce;
-    outputStream << m_serverNonce;
+    return result;
+}
 
-    bigEndianNumber.fill(char(0), 4);
-    qToBigEndian(m_p, (uchar *) bigEndianNumber.data());
-    outputStream << bigEndianNumber;
+TLValue CTelegramConnection::readAccountSetPrivacyResult(CTelegramStream &stream, quint64 id)
+{
+    TLShared<TLAccountPrivacyRules> result;
+    stream >> result;
+    const TLValue resultType = result->tlType;
 
-    qToBigEndian(m_q, (uchar *) bigEndianNumber.data());
-    outputStream << bigEndianNumber;
+    if (isRpcResultPayload(resultType) && !stream.error()) {
+        emit accountSetPrivacyResultReceived(id, result);
+    }
 
-    outputStream << m_serverPublicFingersprint;
+    return resultType;
+}
 
-    outputStream << encryptedPackage;
+TLValue CTelegramConnection::readAccountUnregisterDeviceResult(CTelegramStream &stream, quint64 id)
+{
+    TLValue result;
+    stream >> result;
 
-    sendPlainPackage(output);
+    if ((result == TLValue::BoolTrue) || (result == TLValue::BoolFalse)) {
+        emit accountUnregisterDeviceResultReceived(id, result == TLValue::BoolTrue);
+    }
 
-    setAuthState(AuthStateDhRequested);
+    return result;
 }
 
-bool CTelegramConnection::answerDh(const QByteArray &payload)
+TLValue CTelegramConnection::readAccountUpdateDeviceLockedResult(CTelegramStream &stream, quint64 id)
 {
-    CTelegramStream inputStream(payload);
-
-    TLValue responseTLValue;
-    inputStream >> responseTLValue;
+    TLValue result;
+    stream >> result;
 
-    if (responseTLValue != TLValue::ServerDHParamsOk) {
-        qDebug() << "Error: Server did not accept our DH params.";
-        return false;
+    if ((result == TLValue::BoolTrue) || (result == TLValue::BoolFalse)) {
+        emit accountUpdateDeviceLockedResultReceived(id, result == TLValue::BoolTrue);
     }
 
-    TLNumber128 clientNonce;
-    TLNumber128 serverNonce;
+    return result;
+}
 
-    inputStream >> clientNonce;
+TLValue CTelegramConnection::readAccountUpdateNotifySettingsResult(CTelegramStream &stream, quint64 id)
+{
+    TLValue result;
+    stream >> result;
 
-    if (clientNonce != m_clientNonce) {
-        qDebug() << "Error: Client nonce in incoming package is different from our own.";
-        return false;
+    if ((result == TLValue::BoolTrue) || (result == TLValue::BoolFalse)) {
+        emit accountUpdateNotifySettingsResultReceived(id, result == TLValue::BoolTrue);
     }
 
-    inputStream >> serverNonce;
+    return result;
+}
 
-    if (serverNonce != m_serverNonce) {
-        qDebug() << "Error: Server nonce in incoming package is different from known early.";
-        return false;
+TLValue CTelegramConnection::readAccountUpdatePasswordSettingsResult(CTelegramStream &stream, quint64 id)
+{
+    TLValue result;
+    stream >> result;
+
+    if ((result == TLValue::BoolTrue) || (result == TLValue::BoolFalse)) {
+        emit accountUpdatePasswordSettingsResultReceived(id, result == TLValue::BoolTrue);
     }
 
-    QByteArray encryptedAnswer;
+    return result;
+}
 
-    inputStream >> encryptedAnswer;
+TLValue CTelegramConnection::readAccountUpdateProfileResult(CTelegramStream &stream, quint64 id)
+{
+    TLShared<TLUser> result;
+    stream >> result;
+    const TLValue resultType = result->tlType;
 
-    m_tmpAesKey = generateTmpAesKey();
+    if (isRpcResultPayload(resultType) && !stream.error()) {
+        emit accountUpdateProfileResultReceived(id, result);
+    }
 
-    QByteArray answer = Utils::aesDecrypt(encryptedAnswer, m_tmpAesKey);
+    return resultType;
+}
 
-    QByteArray sha1OfAnswer = answer.mid(0, 20);
-    answer = answer.mid(20, 564);
+TLValue CTelegramConnection::readAuthBindTempAuthKeyResult(CTelegramStream &stream, quint64 id)
+{
+    TLValue result;
+    stream >> result;
 
-    if (Utils::sha1(answer) != sha1OfAnswer) {
-        qDebug() << "Error: SHA1 of encrypted answer is different from announced.";
-        return false;
+    if ((result == TLValue::BoolTrue) || (result == TLValue::BoolFalse)) {
+        emit authBindTempAuthKeyResultReceived(id, result == TLValue::BoolTrue);
     }
 
-    CTelegramStream encryptedInputStream(answer);
+    return result;
+}
 
-    encryptedInputStream >> responseTLValue;
+TLValue CTelegramConnection::readAuthCheckPasswordResult(CTelegramStream &stream, quint64 id)
+{
+    TLShared<TLAuthAuthorization> result;
+    stream >> result;
+    const TLValue resultType = result->tlType;
 
-    if (responseTLValue != TLValue::ServerDHInnerData) {
-        qDebug() << "Error: Unexpected TL Value in encrypted answer.";
-        return false;
+    if (isRpcResultPayload(resultType) && !stream.error()) {
+        emit authCheckPasswordResultReceived(id, result);
     }
 
-    encryptedInputStream >> clientNonce;
+    return resultType;
+}
 
-    if (clientNonce != m_clientNonce) {
-        qDebug() << "Error: Client nonce in incoming package is different from our own.";
-        return false;
+TLValue CTelegramConnection::readAuthRecoverPasswordResult(CTelegramStream &stream, quint64 id)
+{
+    TLShared<TLAuthAuthorization> result;
+    stream >> result;
+    const TLValue resultType = result->tlType;
+
+    if (isRpcResultPayload(resultType) && !stream.error()) {
+        emit authRecoverPasswordResultReceived(id, result);
     }
 
-    encryptedInputStream >> serverNonce;
+    return resultType;
+}
 
-    if (serverNonce != m_serverNonce) {
-        qDebug() << "Error: Server nonce in incoming package is different from known early.";
-        return false;
+TLValue CTelegramConnection::readAuthRequestPasswordRecoveryResult(CTelegramStream &stream, quint64 id)
+{
+    TLShared<TLAuthPasswordRecovery> result;
+    stream >> result;
+    const TLValue resultType = result->tlType;
+
+    if (isRpcResultPayload(resultType) && !stream.error()) {
+        emit authRequestPasswordRecoveryResultReceived(id, result);
     }
 
-    encryptedInputStream >> m_g;
-    encryptedInputStream >> m_dhPrime;
-    encryptedInputStream >> m_gA;
+    return resultType;
+}
 
-    if ((m_g < 2) || (m_g > 7)) {
-        qDebug() << "Error: Received 'g' number is out of acceptable range [2-7].";
-        return false;
-    }
+TLValue CTelegramConnection::readAuthResetAuthorizationsResult(CTelegramStream &stream, quint64 id)
+{
+    TLValue result;
+    stream >> result;
 
-    if (m_dhPrime.length() != 2048 / 8) {
-        qDebug() << "Error: Received dhPrime number length is not correct." << m_dhPrime.length() << 2048 / 8;
-        return false;
+    if ((result == TLValue::BoolTrue) || (result == TLValue::BoolFalse)) {
+        emit authResetAuthorizationsResultReceived(id, result == TLValue::BoolTrue);
     }
 
-    if (!(m_dhPrime.at(0) & 128)) {
-        qDebug() << "Error: Received dhPrime is too small.";
-        return false;
-    }
+    return result;
+}
 
-    quint32 serverTime;
+TLValue CTelegramConnection::readAuthSendCallResult(CTelegramStream &stream, quint64 id)
+{
+    TLValue result;
+    stream >> result;
 
-    encryptedInputStream >> serverTime;
+    if ((result == TLValue::BoolTrue) || (result == TLValue::BoolFalse)) {
+        emit authSendCallResultReceived(id, result == TLValue::BoolTrue);
+    }
+
+    return result;
+}
 
-    setDeltaTime(qint64(serverTime) - (QDateTime::currentMSecsSinceEpoch() / 1000));
-    m_deltaTimeHeuristicState = DeltaTimeIsOk;
+TLValue CTelegramConnection::readAuthSendInvitesResult(CTelegramStream &stream, quint64 id)
+{
+    TLValue result;
+    stream >> result;
 
-    m_b.resize(256);
-    Utils::randomBytes(&m_b);
+    if ((result == TLValue::BoolTrue) || (result == TLValue::BoolFalse)) {
+        emit authSendInvitesResultReceived(id, result == TLValue::BoolTrue);
+    }
 
-    return true;
+    return result;
 }
 
-void CTelegramConnection::requestDhGenerationResult()
+TLValue CTelegramConnection::readContactsBlockResult(CTelegramStream &stream, quint64 id)
 {
-    QByteArray output;
-    CTelegramStream outputStream(&output, /* write */ true);
+    TLValue result;
+    stream >> result;
 
-    outputStream << TLValue::SetClientDHParams;
-    outputStream << m_clientNonce;
-    outputStream << m_serverNonce;
+    if ((result == TLValue::BoolTrue) || (result == TLValue::BoolFalse)) {
+        emit contactsBlockResultReceived(id, result == TLValue::BoolTrue);
+    }
 
-    QByteArray encryptedPackage;
-    {
-        QByteArray innerData;
-        CTelegramStream encryptedStream(&innerData, /* write */ true);
+    return result;
+}
 
-        encryptedStream << TLValue::ClientDHInnerData;
+TLValue CTelegramConnection::readContactsDeleteContactResult(CTelegramStream &stream, quint64 id)
+{
+    TLShared<TLContactsLink> result;
+    stream >> result;
+    const TLValue resultType = result->tlType;
 
-        encryptedStream << m_clientNonce;
-        encryptedStream << m_serverNonce;
-        encryptedStream << m_authRetryId;
+    if (isRpcResultPayload(resultType) && !stream.error()) {
+        emit contactsDeleteContactResultReceived(id, result);
+    }
 
-        QByteArray binNumber;
-        binNumber.resize(sizeof(m_g));
-        qToBigEndian(m_g, (uchar *) binNumber.data());
+    return resultType;
+}
 
-        binNumber = Utils::binaryNumberModExp(binNumber, m_dhPrime, m_b);
+TLValue CTelegramConnection::readContactsExportCardResult(CTelegramStream &stream, quint64 id)
+{
+    TLVector<quint32> result;
+    stream >> result;
 
-        encryptedStream << binNumber;
+    if (isRpcResultPayload(result.tlType) && !stream.error()) {
+        emit contactsExportCardResultReceived(id, result);
+    }
 
-        QByteArray sha = Utils::sha1(innerData);
-        QByteArray randomPadding;
+    return result.tlType;
+}
 
-        int packageLength = sha.length() + innerData.length();
-        if ((packageLength) % 16) {
-            randomPadding.resize(16 - (packageLength % 16));
-            Utils::randomBytes(&randomPadding);
+TLValue CTelegramConnection::readContactsGetBlockedResult(CTelegramStream &stream, quint64 id)
+{
+    TLShared<TLContactsBlocked> result;
+    stream >> result;
+    const TLValue resultType = result->tlType;
 
-            packageLength += randomPadding.size();
-        }
+    if (isRpcResultPayload(resultType) && !stream.error()) {
+        emit contactsGetBlockedResultReceived(id, result);
+    }
 
-        encryptedPackage = Utils::aesEncrypt(sha + innerData + randomPadding, m_tmpAesKey);
+    return resultType;
+}
 
-        encryptedPackage.truncate(packageLength);
-    }
+TLValue CTelegramConnection::readContactsGetStatusesResult(CTelegramStream &stream, quint64 id)
+{
+    TLVector<TLContactStatus> result;
+    stream >> result;
 
-    outputStream << encryptedPackage;
+    if (isRpcResultPayload(result.tlType) && !stream.error()) {
+        emit contactsGetStatusesResultReceived(id, result);
+    }
 
-    sendPlainPackage(output);
-    setAuthState(AuthStateDhGenerationResultRequested);
+    return result.tlType;
 }
 
-bool CTelegramConnection::processServersDHAnswer(const QByteArray &payload)
+TLValue CTelegramConnection::readContactsGetSuggestedResult(CTelegramStream &stream, quint64 id)
 {
-    CTelegramStream inputStream(payload);
+    TLShared<TLContactsSuggested> result;
+    stream >> result;
+    const TLValue resultType = result->tlType;
 
-    TLValue responseTLValue;
-    inputStream >> responseTLValue;
+    if (isRpcResultPayload(resultType) && !stream.error()) {
+        emit contactsGetSuggestedResultReceived(id, result);
+    }
 
-    TLNumber128 clientNonce;
-    TLNumber128 serverNonce;
+    return resultType;
+}
 
-    inputStream >> clientNonce;
+TLValue CTelegramConnection::readContactsImportCardResult(CTelegramStream &stream, quint64 id)
+{
+    TLShared<TLUser> result;
+    stream >> result;
+    const TLValue resultType = result->tlType;
 
-    if (clientNonce != m_clientNonce) {
-        qDebug() << "Error: Client nonce in incoming package is different from our own.";
-        return false;
+    if (isRpcResultPayload(resultType) && !stream.error()) {
+        emit contactsImportCardResultReceived(id, result);
     }
 
-    inputStream >> serverNonce;
+    return resultType;
+}
 
-    if (serverNonce != m_serverNonce) {
-        qDebug() << "Error: Server nonce in incoming package is different from known early.";
-        return false;
+TLValue CTelegramConnection::readContactsResolveUsernameResult(CTelegramStream &stream, quint64 id)
+{
+    TLShared<TLUser> result;
+    stream >> result;
+    const TLValue resultType = result->tlType;
+
+    if (isRpcResultPayload(resultType) && !stream.error()) {
+        emit contactsResolveUsernameResultReceived(id, result);
     }
 
-    TLNumber128 newNonceHashLower128;
+    return resultType;
+}
 
-    inputStream >> newNonceHashLower128;
+TLValue CTelegramConnection::readContactsSearchResult(CTelegramStream &stream, quint64 id)
+{
+    TLShared<TLContactsFound> result;
+    stream >> result;
+    const TLValue resultType = result->tlType;
 
-    QByteArray readedHashPart(newNonceHashLower128.data, newNonceHashLower128.size());
+    if (isRpcResultPayload(resultType) && !stream.error()) {
+        emit contactsSearchResultReceived(id, result);
+    }
 
-    QByteArray expectedHashData(m_newNonce.data, m_newNonce.size());
+    return resultType;
+}
 
-    QByteArray newAuthKey = Utils::binaryNumberModExp(m_gA, m_dhPrime, m_b);
+TLValue CTelegramConnection::readContactsUnblockResult(CTelegramStream &stream, quint64 id)
+{
+    TLValue result;
+    stream >> result;
 
-    expectedHashData.append(Utils::sha1(newAuthKey).left(8));
+    if ((result == TLValue::BoolTrue) || (result == TLValue::BoolFalse)) {
+        emit contactsUnblockResultReceived(id, result == TLValue::BoolTrue);
+    }
 
-    if (responseTLValue == TLValue::DhGenOk) {
-//        qDebug() << "Answer OK";
+    return result;
+}
 
-        expectedHashData.insert(32, char(1));
-        if (Utils::sha1(expectedHashData).mid(4) != readedHashPart) {
-            qDebug() << "Error: Server (newNonce + auth key) hash is not correct.";
-            return false;
-        }
+TLValue CTelegramConnection::readMessagesAcceptEncryptionResult(CTelegramStream &stream, quint64 id)
+{
+    TLShared<TLEncryptedChat> result;
+    stream >> result;
+    const TLValue resultType = result->tlType;
 
-        setAuthKey(newAuthKey);
-        m_serverSalt = m_serverNonce.parts[0] ^ m_newNonce.parts[0];
+    if (isRpcResultPayload(resultType) && !stream.error()) {
+        emit messagesAcceptEncryptionResultReceived(id, result);
+    }
 
-        setAuthState(AuthStateHaveAKey);
-        return true;
-    } else if (responseTLValue == TLValue::DhGenRetry) {
-        qDebug() << "Answer RETRY";
+    return resultType;
+}
 
-        expectedHashData.insert(32, char(2));
-        if (Utils::sha1(expectedHashData).mid(4) != readedHashPart) {
-            qDebug() << "Error: Server (newNonce + auth key) hash is not correct.";
-            return false;
-        }
-    } else if (responseTLValue == TLValue::DhGenFail) {
-        qDebug() << "Answer FAIL";
+TLValue CTelegramConnection::readMessagesAddChatUserResult(CTelegramStream &stream, quint64 id)
+{
+    TLShared<TLUpdates> result;
+    stream >> result;
+    const TLValue resultType = result->tlType;
 
-        expectedHashData.insert(32, char(3));
-        if (Utils::sha1(expectedHashData).mid(4) != readedHashPart) {
-            qDebug() << "Error: Server (newNonce + auth key) hash is not correct.";
-            return false;
-        }
+    if (isRpcResultPayload(resultType) && !stream.error()) {
+        emit messagesAddChatUserResultReceived(id, result);
     }
 
-    qDebug() << "Error: Unexpected server response.";
-
-    return false;
+    return resultType;
 }
 
-void CTelegramConnection::processRedirectedPackage(const QByteArray &data)
+TLValue CTelegramConnection::readMessagesCheckChatInviteResult(CTelegramStream &stream, quint64 id)
 {
-    sendEncryptedPackage(data);
+    TLShared<TLChatInvite> result;
+    stream >> result;
+    const TLValue resultType = result->tlType;
+
+    if (isRpcResultPayload(resultType) && !stream.error()) {
+        emit messagesCheckChatInviteResultReceived(id, result);
+    }
+
+    return resultType;
 }
 
-TLValue CTelegramConnection::processRpcQuery(const QByteArray &data)
+TLValue CTelegramConnection::readMessagesCreateChatResult(CTelegramStream &stream, quint64 id)
 {
-    CTelegramStream stream(data);
-
-    bool isUpdate;
-    TLValue value = processUpdate(stream, &isUpdate); // Doubtfully that this approach will work in next time.
+    TLShared<TLUpdates> result;
+    stream >> result;
+    const TLValue resultType = result->tlType;
 
-    if (isUpdate) {
-        return value;
+    if (isRpcResultPayload(resultType) && !stream.error()) {
+        emit messagesCreateChatResultReceived(id, result);
     }
 
-    switch (value) {
-    case TLValue::NewSessionCreated:
-        processSessionCreated(stream);
-        break;
-    case TLValue::MsgContainer:
-        processContainer(stream);
-        break;
-    case TLValue::RpcResult:
-        processRpcResult(stream);
-        break;
-    case TLValue::MsgsAck:
-        processMessageAck(stream);
-        break;
-    case TLValue::BadMsgNotification:
-    case TLValue::BadServerSalt:
-        processIgnoredMessageNotification(stream);
-        break;
-    case TLValue::GzipPacked:
-        processGzipPackedRpcQuery(stream);
-        break;
-    case TLValue::Pong:
-        processPingPong(stream);
-        break;
-    default:
-        qDebug() << Q_FUNC_INFO << "value:" << value.toString();
-        break;
-    }
+    return resultType;
+}
 
-    if ((value != TLValue::BadMsgNotification) && (m_deltaTimeHeuristicState != DeltaTimeIsOk)) {
-        // If we have no bad message notification, then time is synced.
-        m_deltaTimeHeuristicState = DeltaTimeIsOk;
-    }
+TLValue CTelegramConnection::readMessagesDeleteChatUserResult(CTelegramStream &stream, quint64 id)
+{
+    TLShared<TLUpdates> result;
+    stream >> result;
+    const TLValue resultType = result->tlType;
 
-    if (stream.error()) {
-        qWarning() << Q_FUNC_INFO << "Read of RPC result caused error. RPC type:" << value.toString() << "(read from the package -> can be misleading)";
+    if (isRpcResultPayload(resultType) && !stream.error()) {
+        emit messagesDeleteChatUserResultReceived(id, result);
     }
 
-    return value;
+    return resultType;
 }
 
-void CTelegramConnection::processSessionCreated(CTelegramStream &stream)
+TLValue CTelegramConnection::readMessagesDeleteHistoryResult(CTelegramStream &stream, quint64 id)
 {
-    // https://core.telegram.org/mtproto/service_messages#new-session-creation-notification
-    quint64 n;
+    TLShared<TLMessagesAffectedHistory> result;
+    stream >> result;
+    const TLValue resultType = result->tlType;
 
-    stream >> n;
-    stream >> n;
-    stream >> n;
+    if (isRpcResultPayload(resultType) && !stream.error()) {
+        emit messagesDeleteHistoryResultReceived(id, result);
+    }
+
+    return resultType;
 }
 
-void CTelegramConnection::processContainer(CTelegramStream &stream)
+TLValue CTelegramConnection::readMessagesDeleteMessagesResult(CTelegramStream &stream, quint64 id)
 {
-    // https://core.telegram.org/mtproto/service_messages#simple-container
-    quint32 itemsCount;
-
-    stream >> itemsCount;
-
-    for (quint32 i = 0; i < itemsCount; ++i) {
-        quint64 id;
-        stream >> id;
-        //todo: ack
+    TLShared<TLMessagesAffectedMessages> result;
+    stream >> result;
+    const TLValue resultType = result->tlType;
 
-        quint32 seqNo;
-        stream >> seqNo;
+    if (isRpcResultPayload(resultType) && !stream.error()) {
+        emit messagesDeleteMessagesResultReceived(id, result);
+    }
 
-        quint32 size;
+    return resultType;
+}
 
-        stream >> size;
+TLValue CTelegramConnection::readMessagesDiscardEncryptionResult(CTelegramStream &stream, quint64 id)
+{
+    TLValue result;
+    stream >> result;
 
-        processRpcQuery(stream.readBytes(size));
+    if ((result == TLValue::BoolTrue) || (result == TLValue::BoolFalse)) {
+        emit messagesDiscardEncryptionResultReceived(id, result == TLValue::BoolTrue);
     }
+
+    return result;
 }
 
-void CTelegramConnection::processRpcResult(CTelegramStream &stream, quint64 idHint)
+TLValue CTelegramConnection::readMessagesEditChatPhotoResult(CTelegramStream &stream, quint64 id)
 {
-    quint64 id = idHint;
+    TLShared<TLUpdates> result;
+    stream >> result;
+    const TLValue resultType = result->tlType;
 
-    if (!id) {
-        stream >> id;
+    if (isRpcResultPayload(resultType) && !stream.error()) {
+        emit messagesEditChatPhotoResultReceived(id, result);
     }
 
-    TLValue request;
-
-    const QByteArray &requestData = m_submittedPackages.value(id);
+    return resultType;
+}
 
-    if (!requestData.isEmpty()) {
-        CTelegramStream storedStream(requestData);
-        TLValue processingResult;
+TLValue CTelegramConnection::readMessagesEditChatTitleResult(CTelegramStream &stream, quint64 id)
+{
+    TLShared<TLUpdates> result;
+    stream >> result;
+    const TLValue resultType = result->tlType;
 
-        storedStream >> request;
+    if (isRpcResultPayload(resultType) && !stream.error()) {
+        emit messagesEditChatTitleResultReceived(id, result);
+    }
 
-        if (storedStream.error()) {
-            qWarning() << Q_FUNC_INFO << "Unable to read request type from the saved package. Package with id" << id << "ignored.";
-            return;
-        }
+    return resultType;
+}
 
-        switch (request) {
-        case TLValue::ContactsGetContacts:
-            processingResult = processContactsGetContacts(stream, id);
-            break;
-        case TLValue::ContactsImportContacts:
-            processingResult = processContactsImportContacts(stream, id);
-            break;
-        case TLValue::ContactsDeleteContacts:
-            processingResult = processContactsDeleteContacts(stream, id);
-            break;
-        case TLValue::UpdatesGetState:
-            processingResult = processUpdatesGetState(stream, id);
-            break;
-        case TLValue::UpdatesGetDifference:
-            processingResult = processUpdatesGetDifference(stream, id);
-            break;
-        case TLValue::UploadGetFile:
-            processingResult = processUploadGetFile(stream, id);
-            break;
-        case TLValue::UploadSaveFilePart:
-        case TLValue::UploadSaveBigFilePart:
-            processingResult = processUploadSaveFilePart(stream, id);
-            break;
-        case TLValue::UsersGetUsers:
-            processingResult = processUsersGetUsers(stream, id);
-            break;
-        case TLValue::UsersGetFullUser:
-            processingResult = processUsersGetFullUser(stream, id);
-            break;
-        case TLValue::AuthImportAuthorization:
-        case TLValue::AuthSignIn:
-        case TLValue::AuthSignUp:
-            processingResult = processAuthSign(stream, id);
-            break;
-        case TLValue::AuthLogOut:
-            processingResult = processAuthLogOut(stream, id);
-            break;
-        case TLValue::HelpGetConfig:
-            processingResult = processHelpGetConfig(stream, id);
-            break;
-        case TLValue::AuthCheckPhone:
-            processingResult = processAuthCheckPhone(stream, id);
-            break;
-        case TLValue::AuthExportAuthorization:
-            processingResult = processAuthExportAuthorization(stream, id);
-            break;
-        case TLValue::AuthSendCode:
-            processingResult = processAuthSendCode(stream, id);
-            break;
-        case TLValue::AuthSendSms:
-            processingResult = processAuthSendSms(stream, id);
-            break;
-        case TLValue::MessagesSendMessage:
-            processingResult = processMessagesSendMessage(stream, id);
-            break;
-        case TLValue::MessagesSetTyping:
-            processingResult = processMessagesSetTyping(stream, id);
-            break;
-        case TLValue::MessagesReadHistory:
-            processingResult = processMessagesReadHistory(stream, id);
-            break;
-        case TLValue::MessagesReceivedMessages:
-            processingResult = processMessagesReceivedMessages(stream, id);
-            break;
-        case TLValue::MessagesGetHistory:
-            processingResult = processMessagesGetHistory(stream, id);
-            break;
-        case TLValue::MessagesGetChats:
-            processingResult = processMessagesGetChats(stream, id);
-            break;
-        case TLValue::MessagesGetFullChat:
-            processingResult = processMessagesGetFullChat(stream, id);
-            break;
-        case TLValue::AccountCheckUsername:
-            processingResult = processAccountCheckUsername(stream, id);
-            break;
-        case TLValue::AccountUpdateStatus:
-            processingResult = processAccountUpdateStatus(stream, id);
-            break;
-        case TLValue::AccountUpdateUsername:
-            processingResult = processAccountUpdateUsername(stream, id);
-            break;
-        default:
-            qDebug() << "Unknown outgoing RPC type:" << request.toString();
-            break;
-        case TLValue::Ping:
-            break;
-        }
+TLValue CTelegramConnection::readMessagesExportChatInviteResult(CTelegramStream &stream, quint64 id)
+{
+    TLShared<TLExportedChatInvite> result;
+    stream >> result;
+    const TLValue resultType = result->tlType;
 
-        switch (processingResult) {
-        case TLValue::RpcError:
-            processRpcError(stream, id, request);
-            break;
-        case TLValue::GzipPacked:
-            processGzipPackedRpcResult(stream, id);
-            break;
-        default:
-            // Any other results considered as success
-            m_submittedPackages.remove(id);
-            addMessageToAck(id);
-            break;
-        }
-        if (stream.error()) {
-            qWarning() << Q_FUNC_INFO << "Read of RPC result caused an error. RPC type:" << request.toString() << "Package id:" << id;
-        }
-    } else {
-        stream >> request;
-        qDebug() << "Unexpected RPC message:" << request.toString() << "id" << id;
+    if (isRpcResultPayload(resultType) && !stream.error()) {
+        emit messagesExportChatInviteResultReceived(id, result);
     }
+
+    return resultType;
 }
 
-void CTelegramConnection::processGzipPackedRpcQuery(CTelegramStream &stream)
+TLValue CTelegramConnection::readMessagesForwardMessageResult(CTelegramStream &stream, quint64 id)
 {
-    QByteArray packedData;
-    stream >> packedData;
-
-    const QByteArray data = Utils::unpackGZip(packedData);
+    TLShared<TLUpdates> result;
+    stream >> result;
+    const TLValue resultType = result->tlType;
 
-    if (!data.isEmpty()) {
-        processRpcQuery(data);
+    if (isRpcResultPayload(resultType) && !stream.error()) {
+        emit messagesForwardMessageResultReceived(id, result);
     }
+
+    return resultType;
 }
 
-void CTelegramConnection::processGzipPackedRpcResult(CTelegramStream &stream, quint64 id)
+TLValue CTelegramConnection::readMessagesForwardMessagesResult(CTelegramStream &stream, quint64 id)
 {
-    QByteArray packedData;
-    stream >> packedData;
-
-    const QByteArray data = Utils::unpackGZip(packedData);
+    TLShared<TLUpdates> result;
+    stream >> result;
+    const TLValue resultType = result->tlType;
 
-    if (!data.isEmpty()) {
-        CTelegramStream unpackedStream(data);
-        processRpcResult(unpackedStream, id);
+    if (isRpcResultPayload(resultType) && !stream.error()) {
+        emit messagesForwardMessagesResultReceived(id, result);
     }
+
+    return resultType;
 }
 
-bool CTelegramConnection::processRpcError(CTelegramStream &stream, quint64 id, TLValue request)
+TLValue CTelegramConnection::readMessagesGetAllStickersResult(CTelegramStream &stream, quint64 id)
 {
-    quint32 errorCode;
-    stream >> errorCode;
-
-    QString errorMessage;
-    stream >> errorMessage;
+    TLShared<TLMessagesAllStickers> result;
+    stream >> result;
+    const TLValue resultType = result->tlType;
 
-    qDebug() << Q_FUNC_INFO << QString(QLatin1String("RPC Error %1: %2 for message %3 %4 (dc %5|%6:%7)"))
-                .arg(errorCode).arg(errorMessage).arg(id).arg(request.toString()).arg(m_dcInfo.id).arg(m_dcInfo.ipAddress).arg(m_dcInfo.port);
+    if (isRpcResultPayload(resultType) && !stream.error()) {
+        emit messagesGetAllStickersResultReceived(id, result);
+    }
 
-    switch (errorCode) {
-    case 303: // ERROR_SEE_OTHER
-        if (processErrorSeeOther(errorMessage, id)) {
-            return true;
-        }
-        break;
-    case 400: // BAD_REQUEST
-        switch (request) {
-        case TLValue::AuthCheckPhone:
-        case TLValue::AuthSendCode:
-        case TLValue::AuthSendCall:
-        case TLValue::AuthSignIn:
-        case TLValue::AuthSignUp:
-            if (errorMessage == QLatin1String("API_ID_INVALID")) {
-                emit authSignErrorReceived(TelegramNamespace::AuthSignErrorAppIdIsInvalid, errorMessage);
-            } else if (errorMessage == QLatin1String("PHONE_NUMBER_INVALID")) {
-                emit authSignErrorReceived(TelegramNamespace::AuthSignErrorPhoneNumberIsInvalid, errorMessage);
-            } else if (errorMessage == QLatin1String("PHONE_NUMBER_OCCUPIED")) {
-                emit authSignErrorReceived(TelegramNamespace::AuthSignErrorPhoneNumberIsOccupied, errorMessage);
-            } else if (errorMessage == QLatin1String("PHONE_NUMBER_UNOCCUPIED")) {
-                emit authSignErrorReceived(TelegramNamespace::AuthSignErrorPhoneNumberIsUnoccupied, errorMessage);
-            } else if (errorMessage == QLatin1String("PHONE_CODE_INVALID")) {
-                emit authSignErrorReceived(TelegramNamespace::AuthSignErrorPhoneCodeIsInvalid, errorMessage);
-            } else if (errorMessage == QLatin1String("PHONE_CODE_EXPIRED")) {
-                emit authSignErrorReceived(TelegramNamespace::AuthSignErrorPhoneCodeIsExpired, errorMessage);
-            } else if (errorMessage == QLatin1String("FIRSTNAME_INVALID")) {
-                emit authSignErrorReceived(TelegramNamespace::AuthSignErrorFirstNameIsInvalid, errorMessage);
-            } else if (errorMessage == QLatin1String("LASTNAME_INVALID")) {
-                emit authSignErrorReceived(TelegramNamespace::AuthSignErrorLastNameIsInvalid, errorMessage);
-            } else {
-                emit authSignErrorReceived(TelegramNamespace::AuthSignErrorUnknown, errorMessage);
-            }
+    return resultType;
+}
 
-            return true;
-        case TLValue::AccountCheckUsername:
-        case TLValue::AccountUpdateUsername: {
-            const QString userName = userNameFromPackage(id);
+TLValue CTelegramConnection::readMessagesGetDhConfigResult(CTelegramStream &stream, quint64 id)
+{
+    TLShared<TLMessagesDhConfig> result;
+    stream >> result;
+    const TLValue resultType = result->tlType;
 
-            if (errorMessage == QLatin1String("USERNAME_INVALID")) {
-                emit userNameStatusUpdated(userName, TelegramNamespace::AccountUserNameStatusIsInvalid);
-            } else if (errorMessage == QLatin1String("USERNAME_OCCUPIED")) {
-                emit userNameStatusUpdated(userName, TelegramNamespace::AccountUserNameStatusIsOccupied);
-            } else if (errorMessage == QLatin1String("USERNAME_NOT_MODIFIED")) {
-                emit userNameStatusUpdated(userName, TelegramNamespace::AccountUserNameStatusIsNotModified);
-            } else {
-                emit userNameStatusUpdated(userName, TelegramNamespace::AccountUserNameStatusUnknown);
-            }
-        }
-            break;
-        default:
-            break;
-        }
-        break;
-    case 401: // UNAUTHORIZED
-        emit authorizationErrorReceived();
-        break;
-    default:
-        qDebug() << "RPC Error can not be handled.";
-        break;
+    if (isRpcResultPayload(resultType) && !stream.error()) {
+        emit messagesGetDhConfigResultReceived(id, result);
     }
 
-    return false;
+    return resultType;
 }
 
-void CTelegramConnection::processMessageAck(CTelegramStream &stream)
+TLValue CTelegramConnection::readMessagesGetDialogsResult(CTelegramStream &stream, quint64 id)
 {
-    TLVector<quint64> idsVector;
-
-    stream >> idsVector;
+    TLShared<TLMessagesDialogs> result;
+    stream >> result;
+    const TLValue resultType = result->tlType;
 
-    foreach (quint64 id, idsVector) {
-        qDebug() << Q_FUNC_INFO << "Package" << id << "acked";
-//        m_submittedPackages.remove(id);
+    if (isRpcResultPayload(resultType) && !stream.error()) {
+        emit messagesGetDialogsResultReceived(id, result);
     }
+
+    return resultType;
 }
 
-void CTelegramConnection::processIgnoredMessageNotification(CTelegramStream &stream)
+TLValue CTelegramConnection::readMessagesGetMessagesResult(CTelegramStream &stream, quint64 id)
 {
-    // https://core.telegram.org/mtproto/service_messages_about_messages#notice-of-ignored-error-message
-    quint64 id;
-    stream >> id;
+    TLShared<TLMessagesMessages> result;
+    stream >> result;
+    const TLValue resultType = result->tlType;
 
-    quint32 seqNo;
-    stream >> seqNo;
+    if (isRpcResultPayload(resultType) && !stream.error()) {
+        emit messagesGetMessagesResultReceived(id, result);
+    }
 
-    quint32 errorCode;
-    stream >> errorCode;
+    return resultType;
+}
 
-    QString errorText;
-    switch (errorCode) {
-    case 16:
-        errorText = QLatin1String("Id too low");
-        break;
-    case 17:
-        errorText = QLatin1String("Id too high");
-        break;
-    case 18:
-        errorText = QLatin1String("Incorrect two lower order id bits");
-        break;
-    case 19:
-        errorText = QLatin1String("Container id is the same as id of a previously received message");
-        break;
-    case 20:
-        errorText = QLatin1String("Message too old, and it cannot be verified whether the server has received a message with this id or not");
-        break;
-    case 32:
-        errorText = QLatin1String("Sequence number too low");
-        break;
-    case 33:
-        errorText = QLatin1String("Sequence number too high");
-        break;
-    case 34:
-        errorText = QLatin1String("An even sequence number expected");
-        break;
-    case 35:
-        errorText = QLatin1String("Odd sequence number expected");
-        break;
-    case 48:
-        errorText = QLatin1String("Incorrect server salt");
-        break;
-    case 64:
-        errorText = QLatin1String("Invalid container");
-        break;
-    default:
-        errorText = QLatin1String("Unknown error code");
-        break;
+TLValue CTelegramConnection::readMessagesGetStickerSetResult(CTelegramStream &stream, quint64 id)
+{
+    TLShared<TLMessagesStickerSet> result;
+    stream >> result;
+    const TLValue resultType = result->tlType;
+
+    if (isRpcResultPayload(resultType) && !stream.error()) {
+        emit messagesGetStickerSetResultReceived(id, result);
     }
-    qDebug() << QString(QLatin1String("Bad message %1/%2: Code %3 (%4).")).arg(id).arg(seqNo).arg(errorCode).arg(errorText);
 
-    if (errorCode == 16) {
-        if (m_deltaTimeHeuristicState == DeltaTimeIsOk) {
-            m_deltaTimeHeuristicState = DeltaTimeCorrectionForward;
-        }
+    return resultType;
+}
 
-        if (m_deltaTimeHeuristicState == DeltaTimeCorrectionForward) {
-            setDeltaTime(deltaTime() + 1000);
-        } else {
-            setDeltaTime(deltaTime() + 100);
-        }
+TLValue CTelegramConnection::readMessagesGetStickersResult(CTelegramStream &stream, quint64 id)
+{
+    TLShared<TLMessagesStickers> result;
+    stream >> result;
+    const TLValue resultType = result->tlType;
 
-        sendEncryptedPackageAgain(id);
-        qDebug() << "DeltaTime factor increased to" << deltaTime();
-    } else if (errorCode == 17) {
-        if (m_deltaTimeHeuristicState == DeltaTimeIsOk) {
-            m_deltaTimeHeuristicState = DeltaTimeCorrectionBackward;
-        }
+    if (isRpcResultPayload(resultType) && !stream.error()) {
+        emit messagesGetStickersResultReceived(id, result);
+    }
 
-        if (m_deltaTimeHeuristicState == DeltaTimeCorrectionBackward) {
-            setDeltaTime(deltaTime() - 1000);
-        } else {
-            setDeltaTime(deltaTime() - 100);
-        }
+    return resultType;
+}
 
-        sendEncryptedPackageAgain(id);
-        qDebug() << "DeltaTime factor reduced to" << deltaTime();
-    } else if (errorCode == 48) {
-        m_serverSalt = m_receivedServerSalt;
-        sendEncryptedPackageAgain(id);
-        qDebug() << "Local serverSalt fixed to" << m_serverSalt;
+TLValue CTelegramConnection::readMessagesGetWebPagePreviewResult(CTelegramStream &stream, quint64 id)
+{
+    TLShared<TLMessageMedia> result;
+    stream >> result;
+    const TLValue resultType = result->tlType;
+
+    if (isRpcResultPayload(resultType) && !stream.error()) {
+        emit messagesGetWebPagePreviewResultReceived(id, result);
     }
+
+    return resultType;
 }
 
-void CTelegramConnection::processPingPong(CTelegramStream &stream)
+TLValue CTelegramConnection::readMessagesImportChatInviteResult(CTelegramStream &stream, quint64 id)
 {
-    quint64 pid;
-    quint64 msgId;
-    stream >> msgId;
-    stream >> pid;
+    TLShared<TLUpdates> result;
+    stream >> result;
+    const TLValue resultType = result->tlType;
 
-    m_lastReceivedPingId = pid;
-    m_lastReceivedPingTime = QDateTime::currentMSecsSinceEpoch();
+    if (isRpcResultPayload(resultType) && !stream.error()) {
+        emit messagesImportChatInviteResultReceived(id, result);
+    }
 
-//    qDebug() << Q_FUNC_INFO << m_lastReceivedPingId << m_lastReceivedPingTime;
+    return resultType;
 }
 
-TLValue CTelegramConnection::processHelpGetConfig(CTelegramStream &stream, quint64 id)
+TLValue CTelegramConnection::readMessagesInstallStickerSetResult(CTelegramStream &stream, quint64 id)
 {
-    Q_UNUSED(id);
-
-    TLConfig result;
+    TLValue result;
     stream >> result;
 
-    if (result.tlType == TLValue::Config) {
-        m_dcConfiguration = result.dcOptions;
+    if ((result == TLValue::BoolTrue) || (result == TLValue::BoolFalse)) {
+        emit messagesInstallStickerSetResultReceived(id, result == TLValue::BoolTrue);
+    }
 
-        if (m_dcInfo.id != result.thisDc) {
-            emit actualDcIdReceived(m_dcInfo.id, result.thisDc);
-        }
+    return result;
+}
 
-        emit dcConfigurationReceived(m_dcInfo.id);
+TLValue CTelegramConnection::readMessagesReadEncryptedHistoryResult(CTelegramStream &stream, quint64 id)
+{
+    TLValue result;
+    stream >> result;
+
+    if ((result == TLValue::BoolTrue) || (result == TLValue::BoolFalse)) {
+        emit messagesReadEncryptedHistoryResultReceived(id, result == TLValue::BoolTrue);
     }
 
-    return result.tlType;
+    return result;
 }
 
-TLValue CTelegramConnection::processContactsGetContacts(CTelegramStream &stream, quint64 id)
+TLValue CTelegramConnection::readMessagesReadMessageContentsResult(CTelegramStream &stream, quint64 id)
 {
-    Q_UNUSED(id);
-
-    TLContactsContacts result;
+    TLShared<TLMessagesAffectedMessages> result;
     stream >> result;
+    const TLValue resultType = result->tlType;
 
-    if (result.tlType == TLValue::ContactsContacts) {
-        emit usersReceived(result.users);
+    if (isRpcResultPayload(resultType) && !stream.error()) {
+        emit messagesReadMessageContentsResultReceived(id, result);
+    }
 
-        QVector<quint32> contactList;
-        foreach (const TLUser &user, result.users) {
-            contactList.append(user.id);
-        }
+    return resultType;
+}
 
-        emit contactListReceived(contactList);
+TLValue CTelegramConnection::readMessagesReceivedQueueResult(CTelegramStream &stream, quint64 id)
+{
+    TLVector<quint64> result;
+    stream >> result;
+
+    if (isRpcResultPayload(result.tlType) && !stream.error()) {
+        emit messagesReceivedQueueResultReceived(id, result);
     }
 
     return result.tlType;
 }
 
-TLValue CTelegramConnection::processContactsImportContacts(CTelegramStream &stream, quint64 id)
+TLValue CTelegramConnection::readMessagesRequestEncryptionResult(CTelegramStream &stream, quint64 id)
 {
-    Q_UNUSED(id);
-
-    TLContactsImportedContacts result;
+    TLShared<TLEncryptedChat> result;
     stream >> result;
+    const TLValue resultType = result->tlType;
 
-    if (result.tlType == TLValue::ContactsImportedContacts) {
-        emit usersReceived(result.users);
+    if (isRpcResultPayload(resultType) && !stream.error()) {
+        emit messagesRequestEncryptionResultReceived(id, result);
+    }
 
-        QVector<quint32> addedList;
-        foreach (const TLUser &user, result.users) {
-            addedList.append(user.id);
-        }
+    return resultType;
+}
 
-        emit contactListChanged(addedList, QVector<quint32>());
+TLValue CTelegramConnection::readMessagesSearchResult(CTelegramStream &stream, quint64 id)
+{
+    TLShared<TLMessagesMessages> result;
+    stream >> result;
+    const TLValue resultType = result->tlType;
+
+    if (isRpcResultPayload(resultType) && !stream.error()) {
+        emit messagesSearchResultReceived(id, result);
     }
 
-    return result.tlType;
+    return resultType;
 }
 
-TLValue CTelegramConnection::processContactsDeleteContacts(CTelegramStream &stream, quint64 id)
+TLValue CTelegramConnection::readMessagesSendBroadcastResult(CTelegramStream &stream, quint64 id)
 {
-    Q_UNUSED(id);
-
-    TLValue result;
+    TLShared<TLUpdates> result;
     stream >> result;
+    const TLValue resultType = result->tlType;
 
-    return result;
+    if (isRpcResultPayload(resultType) && !stream.error()) {
+        emit messagesSendBroadcastResultReceived(id, result);
+    }
+
+    return resultType;
 }
 
-TLValue CTelegramConnection::processUpdatesGetState(CTelegramStream &stream, quint64 id)
+TLValue CTelegramConnection::readMessagesSendEncryptedResult(CTelegramStream &stream, quint64 id)
 {
-    Q_UNUSED(id);
-
-    TLUpdatesState result;
+    TLShared<TLMessagesSentEncryptedMessage> result;
     stream >> result;
+    const TLValue resultType = result->tlType;
 
-    switch (result.tlType) {
-    case TLValue::UpdatesState:
-        emit updatesStateReceived(result);
-        break;
-    default:
-        break;
+    if (isRpcResultPayload(resultType) && !stream.error()) {
+        emit messagesSendEncryptedResultReceived(id, result);
     }
 
-    return result.tlType;
+    return resultType;
 }
 
-TLValue CTelegramConnection::processUpdatesGetDifference(CTelegramStream &stream, quint64 id)
+TLValue CTelegramConnection::readMessagesSendEncryptedFileResult(CTelegramStream &stream, quint64 id)
 {
-    Q_UNUSED(id);
+    TLShared<TLMessagesSentEncryptedMessage> result;
+    stream >> result;
+    const TLValue resultType = result->tlType;
+
+    if (isRpcResultPayload(resultType) && !stream.error()) {
+        emit messagesSendEncryptedFileResultReceived(id, result);
+    }
+
+    return resultType;
+}
 
-    TLUpdatesDifference result;
+TLValue CTelegramConnection::readMessagesSendEncryptedServiceResult(CTelegramStream &stream, quint64 id)
+{
+    TLShared<TLMessagesSentEncryptedMessage> result;
     stream >> result;
+    const TLValue resultType = result->tlType;
 
-    switch (result.tlType) {
-    case TLValue::UpdatesDifference:
-    case TLValue::UpdatesDifferenceSlice:
-    case TLValue::UpdatesDifferenceEmpty:
-        emit updatesDifferenceReceived(result);
-        break;
-    default:
-        break;
+    if (isRpcResultPayload(resultType) && !stream.error()) {
+        emit messagesSendEncryptedServiceResultReceived(id, result);
     }
 
-    return result.tlType;
+    return resultType;
 }
 
-TLValue CTelegramConnection::processAuthCheckPhone(CTelegramStream &stream, quint64 id)
+TLValue CTelegramConnection::readMessagesSendMediaResult(CTelegramStream &stream, quint64 id)
 {
-    TLAuthCheckedPhone result;
+    TLShared<TLUpdates> result;
     stream >> result;
+    const TLValue resultType = result->tlType;
 
-    if (result.tlType == TLValue::AuthCheckedPhone) {
-        const QByteArray data = m_submittedPackages.value(id);
+    if (isRpcResultPayload(resultType) && !stream.error()) {
+        emit messagesSendMediaResultReceived(id, result);
+    }
 
-        if (data.isEmpty()) {
+    return resultType;
+}
+
+TLValue CTelegramConnection::readMessagesSetEncryptedTypingResult(CTelegramStream &stream, quint64 id)
+{
+    TLValue result;
+    stream >> result;
+
+    if ((result == TLValue::BoolTrue) || (result == TLValue::BoolFalse)) {
+        emit messagesSetEncryptedTypingResultReceived(id, result == TLValue::BoolTrue);
+    }
+
+    return result;
+}
+
+TLValue CTelegramConnection::readMessagesUninstallStickerSetResult(CTelegramStream &stream, quint64 id)
+{
+    TLValue result;
+    stream >> result;
+
+    if ((result == TLValue::BoolTrue) || (result == TLValue::BoolFalse)) {
+        emit messagesUninstallStickerSetResultReceived(id, result == TLValue::BoolTrue);
+    }
+
+    return result;
+}
+
+// End of generated RPC result readers implementation
+
+// Generated RPC result readers table
+const CTelegramConnection::RpcResultReader CTelegramConnection::s_rpcResultReaders[] = {
+    { TLValue::AuthSendCall, &CTelegramConnection::readAuthSendCallResult },
+    { TLValue::MessagesReceivedMessages, &CTelegramConnection::processMessagesReceivedMessages },
+    { TLValue::MessagesSearch, &CTelegramConnection::readMessagesSearchResult },
+    { TLValue::AccountGetAccountTTL, &CTelegramConnection::readAccountGetAccountTTLResult },
+    { TLValue::MessagesCreateChat, &CTelegramConnection::readMessagesCreateChatResult },
+    { TLValue::UpdatesGetDifference, &CTelegramConnection::processUpdatesGetDifference },
+    { TLValue::AuthCheckPassword, &CTelegramConnection::readAuthCheckPasswordResult },
+    { TLValue::ContactsResolveUsername, &CTelegramConnection::readContactsResolveUsernameResult },
+    { TLValue::UsersGetUsers, &CTelegramConnection::processUsersGetUsers },
+    { TLValue::AuthSendSms, &CTelegramConnection::processAuthSendSms },
+    { TLValue::ContactsSearch, &CTelegramConnection::readContactsSearchResult },
+    { TLValue::AccountGetNotifySettings, &CTelegramConnection::readAccountGetNotifySettingsResult },
+    { TLValue::AuthSignUp, &CTelegramConnection::processAuthSignUp },
+    { TLValue::ContactsGetContacts, &CTelegramConnection::processContactsGetContacts },
+    { TLValue::AccountSetAccountTTL, &CTelegramConnection::readAccountSetAccountTTLResult },
+    { TLValue::MessagesGetWebPagePreview, &CTelegramConnection::readMessagesGetWebPagePreviewResult },
+    { TLValue::MessagesGetStickerSet, &CTelegramConnection::readMessagesGetStickerSetResult },
+    { TLValue::MessagesGetDhConfig, &CTelegramConnection::readMessagesGetDhConfigResult },
+    { TLValue::AccountCheckUsername, &CTelegramConnection::processAccountCheckUsername },
+    { TLValue::MessagesSendMedia, &CTelegramConnection::readMessagesSendMediaResult },
+    { TLValue::MessagesSendEncryptedService, &CTelegramConnection::readMessagesSendEncryptedServiceResult },
+    { TLValue::ContactsBlock, &CTelegramConnection::readContactsBlockResult },
+    { TLValue::MessagesForwardMessage, &CTelegramConnection::readMessagesForwardMessageResult },
+    { TLValue::MessagesReadMessageContents, &CTelegramConnection::readMessagesReadMessageContentsResult },
+    { TLValue::AccountUpdateDeviceLocked, &CTelegramConnection::readAccountUpdateDeviceLockedResult },
+    { TLValue::MessagesGetFullChat, &CTelegramConnection::processMessagesGetFullChat },
+    { TLValue::MessagesGetChats, &CTelegramConnection::processMessagesGetChats },
+    { TLValue::MessagesAcceptEncryption, &CTelegramConnection::readMessagesAcceptEncryptionResult },
+    { TLValue::AccountUpdateUsername, &CTelegramConnection::processAccountUpdateUsername },
+    { TLValue::MessagesCheckChatInvite, &CTelegramConnection::readMessagesCheckChatInviteResult },
+    { TLValue::AccountDeleteAccount, &CTelegramConnection::readAccountDeleteAccountResult },
+    { TLValue::MessagesGetMessages, &CTelegramConnection::readMessagesGetMessagesResult },
+    { TLValue::AccountRegisterDevice, &CTelegramConnection::readAccountRegisterDeviceResult },
+    { TLValue::AuthRecoverPassword, &CTelegramConnection::readAuthRecoverPasswordResult },
+    { TLValue::ContactsImportCard, &CTelegramConnection::readContactsImportCardResult },
+    { TLValue::AccountGetPassword, &CTelegramConnection::readAccountGetPasswordResult },
+    { TLValue::MessagesReceivedQueue, &CTelegramConnection::readMessagesReceivedQueueResult },
+    { TLValue::MessagesForwardMessages, &CTelegramConnection::readMessagesForwardMessagesResult },
+    { TLValue::AuthLogOut, &CTelegramConnection::processAuthLogOut },
+    { TLValue::ContactsDeleteContacts, &CTelegramConnection::processContactsDeleteContacts },
+    { TLValue::AccountUnregisterDevice, &CTelegramConnection::readAccountUnregisterDeviceResult },
+    { TLValue::AccountUpdateStatus, &CTelegramConnection::processAccountUpdateStatus },
+    { TLValue::MessagesImportChatInvite, &CTelegramConnection::readMessagesImportChatInviteResult },
+    { TLValue::AuthCheckPhone, &CTelegramConnection::processAuthCheckPhone },
+    { TLValue::AccountChangePhone, &CTelegramConnection::readAccountChangePhoneResult },
+    { TLValue::AuthSendCode, &CTelegramConnection::processAuthSendCode },
+    { TLValue::AuthSendInvites, &CTelegramConnection::readAuthSendInvitesResult },
+    { TLValue::MessagesSetEncryptedTyping, &CTelegramConnection::readMessagesSetEncryptedTypingResult },
+    { TLValue::MessagesExportChatInvite, &CTelegramConnection::readMessagesExportChatInviteResult },
+    { TLValue::MessagesReadEncryptedHistory, &CTelegramConnection::readMessagesReadEncryptedHistoryResult },
+    { TLValue::AccountUpdateNotifySettings, &CTelegramConnection::readAccountUpdateNotifySettingsResult },
+    { TLValue::ContactsExportCard, &CTelegramConnection::readContactsExportCardResult },
+    { TLValue::ContactsDeleteContact, &CTelegramConnection::readContactsDeleteContactResult },
+    { TLValue::MessagesGetHistory, &CTelegramConnection::processMessagesGetHistory },
+    { TLValue::MessagesSendEncryptedFile, &CTelegramConnection::readMessagesSendEncryptedFileResult },
+    { TLValue::MessagesSendMessage, &CTelegramConnection::processMessagesSendMessage },
+    { TLValue::AuthResetAuthorizations, &CTelegramConnection::readAuthResetAuthorizationsResult },
+    { TLValue::MessagesSetTyping, &CTelegramConnection::processMessagesSetTyping },
+    { TLValue::AccountSendChangePhoneCode, &CTelegramConnection::readAccountSendChangePhoneCodeResult },
+    { TLValue::MessagesDeleteMessages, &CTelegramConnection::readMessagesDeleteMessagesResult },
+    { TLValue::MessagesSendEncrypted, &CTelegramConnection::readMessagesSendEncryptedResult },
+    { TLValue::MessagesGetAllStickers, &CTelegramConnection::readMessagesGetAllStickersResult },
+    { TLValue::MessagesGetStickers, &CTelegramConnection::readMessagesGetStickersResult },
+    { TLValue::MessagesReadHistory, &CTelegramConnection::processMessagesReadHistory },
+    { TLValue::UploadSaveFilePart, &CTelegramConnection::processUploadSaveFilePart },
+    { TLValue::AccountGetPasswordSettings, &CTelegramConnection::readAccountGetPasswordSettingsResult },
+    { TLValue::AuthSignIn, &CTelegramConnection::processAuthSignIn },
+    { TLValue::MessagesSendBroadcast, &CTelegramConnection::readMessagesSendBroadcastResult },
+    { TLValue::AccountGetWallPapers, &CTelegramConnection::readAccountGetWallPapersResult },
+    { TLValue::ContactsGetStatuses, &CTelegramConnection::readContactsGetStatusesResult },
+    { TLValue::HelpGetConfig, &CTelegramConnection::processHelpGetConfig },
+    { TLValue::AccountSetPrivacy, &CTelegramConnection::readAccountSetPrivacyResult },
+    { TLValue::UsersGetFullUser, &CTelegramConnection::processUsersGetFullUser },
+    { TLValue::MessagesEditChatPhoto, &CTelegramConnection::readMessagesEditChatPhotoResult },
+    { TLValue::ContactsGetSuggested, &CTelegramConnection::readContactsGetSuggestedResult },
+    { TLValue::AuthBindTempAuthKey, &CTelegramConnection::readAuthBindTempAuthKeyResult },
+    { TLValue::AuthRequestPasswordRecovery, &CTelegramConnection::readAuthRequestPasswordRecoveryResult },
+    { TLValue::ContactsImportContacts, &CTelegramConnection::processContactsImportContacts },
+    { TLValue::AccountGetPrivacy, &CTelegramConnection::readAccountGetPrivacyResult },
+    { TLValue::AccountResetNotifySettings, &CTelegramConnection::readAccountResetNotifySettingsResult },
+    { TLValue::MessagesEditChatTitle, &CTelegramConnection::readMessagesEditChatTitleResult },
+    { TLValue::UploadSaveBigFilePart, &CTelegramConnection::processUploadSaveBigFilePart },
+    { TLValue::AccountResetAuthorization, &CTelegramConnection::readAccountResetAuthorizationResult },
+    { TLValue::MessagesDeleteChatUser, &CTelegramConnection::readMessagesDeleteChatUserResult },
+    { TLValue::AccountGetAuthorizations, &CTelegramConnection::readAccountGetAuthorizationsResult },
+    { TLValue::UploadGetFile, &CTelegramConnection::processUploadGetFile },
+    { TLValue::AuthImportAuthorization, &CTelegramConnection::processAuthImportAuthorization },
+    { TLValue::ContactsUnblock, &CTelegramConnection::readContactsUnblockResult },
+    { TLValue::AuthExportAuthorization, &CTelegramConnection::processAuthExportAuthorization },
+    { TLValue::MessagesGetDialogs, &CTelegramConnection::readMessagesGetDialogsResult },
+    { TLValue::UpdatesGetState, &CTelegramConnection::processUpdatesGetState },
+    { TLValue::MessagesDiscardEncryption, &CTelegramConnection::readMessagesDiscardEncryptionResult },
+    { TLValue::MessagesInstallStickerSet, &CTelegramConnection::readMessagesInstallStickerSetResult },
+    { TLValue::AccountUpdateProfile, &CTelegramConnection::readAccountUpdateProfileResult },
+    { TLValue::MessagesDeleteHistory, &CTelegramConnection::readMessagesDeleteHistoryResult },
+    { TLValue::ContactsGetBlocked, &CTelegramConnection::readContactsGetBlockedResult },
+    { TLValue::MessagesRequestEncryption, &CTelegramConnection::readMessagesRequestEncryptionResult },
+    { TLValue::MessagesUninstallStickerSet, &CTelegramConnection::readMessagesUninstallStickerSetResult },
+    { TLValue::MessagesAddChatUser, &CTelegramConnection::readMessagesAddChatUserResult },
+    { TLValue::AccountUpdatePasswordSettings, &CTelegramConnection::readAccountUpdatePasswordSettingsResult },
+};
+
+const int CTelegramConnection::s_rpcResultReadersCount = sizeof(CTelegramConnection::s_rpcResultReaders) / sizeof(CTelegramConnection::s_rpcResultReaders[0]);
+// End of generated RPC result readers table
+
+const CTelegramConnection::RpcResultReader *CTelegramConnection::rpcResultReader(TLValue method)
+{
+    int first = 0;
+    int last = s_rpcResultReadersCount - 1;
+
+    while (first <= last) {
+        const int middle = (first + last) / 2;
+        const quint32 middleMethod = s_rpcResultReaders[middle].method;
+
+        if (middleMethod < method) {
+            first = middle + 1;
+        } else if (middleMethod > method) {
+            last = middle - 1;
+        } else {
+            return &s_rpcResultReaders[middle];
+        }
+    }
+
+    return 0;
+}
+
+quint64 CTelegramConnection::ping()
+{
+//    qDebug() << Q_FUNC_INFO;
+    QByteArray output;
+    CTelegramStream outputStream(&output, /* write */ true);
+
+    outputStream << TLValue::Ping;
+    outputStream << ++m_lastSentPingId;
+
+    return sendEncryptedPackage(output);
+}
+
+quint64 CTelegramConnection::pingDelayDisconnect(quint32 disconnectInSec)
+{
+//    qDebug() << Q_FUNC_INFO << disconnectInSec;
+    QByteArray output;
+    CTelegramStream outputStream(&output, /* write */ true);
+
+    outputStream << TLValue::PingDelayDisconnect;
+    outputStream << ++m_lastSentPingId;
+    outputStream << disconnectInSec;
+
+    return sendEncryptedPackage(output);
+}
+
+quint64 CTelegramConnection::acknowledgeMessages(const TLVector<quint64> &idsVector)
+{
+//    qDebug() << Q_FUNC_INFO << idsVector;
+
+    QByteArray output;
+    CTelegramStream outputStream(&output, /* write */ true);
+
+    outputStream << TLValue::MsgsAck;
+    outputStream << idsVector;
+
+    return sendEncryptedPackage(output, /* save package */ false);
+}
+
+quint64 CTelegramConnection::rpcDropAnswer(quint64 requestMessageId)
+{
+    QByteArray output;
+    CTelegramStream outputStream(&output, /* write */ true);
+
+    outputStream << TLValue::RpcDropAnswer;
+    outputStream << requestMessageId;
+
+    return sendEncryptedPackage(output);
+}
+
+quint64 CTelegramConnection::getFutureSalts(quint32 count)
+{
+    qDebug() << Q_FUNC_INFO << count;
+
+    QByteArray output;
+    CTelegramStream outputStream(&output, /* write */ true);
+
+    outputStream << TLValue::GetFutureSalts;
+    outputStream << count;
+
+    return sendEncryptedPackage(output);
+}
+
+bool CTelegramConnection::answerPqAuthorization(const QByteArray &payload)
+{
+    CTelegramStream inputStream(payload);
+
+    TLValue responsePqValue;
+    inputStream >> responsePqValue;
+
+    if (responsePqValue != TLValue::ResPQ) {
+        qDebug() << "Error: Unexpected operation code";
+        return false;
+    }
+
+    TLNumber128 clientNonce;
+    TLNumber128 serverNonce;
+
+    inputStream >> clientNonce;
+
+    if (clientNonce != m_clientNonce) {
+        qDebug() << "Error: Client nonce in incoming package is different from our own.";
+        return false;
+    }
+
+    inputStream >> serverNonce;
+
+    m_serverNonce = serverNonce;
+
+    QByteArray pq;
+
+    inputStream >> pq;
+
+    if (pq.size() != 8) {
+        qDebug() << "Error: PQ should be 8 bytes in length";
+        return false;
+    }
+
+    m_pq = qFromBigEndian<quint64>((uchar *) pq.data());
+
+    quint64 div1 = Utils::findDivider(m_pq);
+
+    if (div1 == 1) {
+        qDebug() << "Error: Can not solve PQ.";
+        return false;
+    }
+    quint64 div2 = m_pq / div1;
+
+    if (div1 < div2) {
+        m_p = div1;
+        m_q = div2;
+    } else {
+        m_p = div2;
+        m_q = div1;
+    }
+
+    TLVector<quint64> fingersprints;
+
+    inputStream >> fingersprints;
+
+    if (fingersprints.count() != 1) {
+        qDebug() << "Error: Unexpected Server RSA Fingersprints vector.";
+        return false;
+    }
+
+    m_serverPublicFingersprint = fingersprints.at(0);
+
+    if (m_rsaKey.fingersprint != m_serverPublicFingersprint) {
+        qDebug() << "Error: Server RSA Fingersprint does not match to loaded key";
+        return false;
+    }
+
+    return true;
+}
+
+void CTelegramConnection::requestDhParameters()
+{
+    Utils::randomBytes(m_newNonce.data, m_newNonce.size());
+
+    QByteArray bigEndianNumber;
+    bigEndianNumber.fill(char(0), 8);
+
+    QByteArray encryptedPackage;
+    {
+        static const int requestedEncryptedPackageLength = 255;
+        QByteArray innerData;
+        CTelegramStream encryptedStream(&innerData, /* write */ true);
+
+        encryptedStream << TLValue::PQInnerData;
+
+        qToBigEndian(m_pq, (uchar *) bigEndianNumber.data());
+        encryptedStream << bigEndianNumber;
+
+        bigEndianNumber.fill(char(0), 4);
+        qToBigEndian(m_p, (uchar *) bigEndianNumber.data());
+        encryptedStream << bigEndianNumber;
+
+        qToBigEndian(m_q, (uchar *) bigEndianNumber.data());
+        encryptedStream << bigEndianNumber;
+
+        encryptedStream << m_clientNonce;
+        encryptedStream << m_serverNonce;
+        encryptedStream << m_newNonce;
+
+        QByteArray sha = Utils::sha1(innerData);
+        QByteArray randomPadding;
+        randomPadding.resize(requestedEncryptedPackageLength - (sha.length() + innerData.length()));
+        Utils::randomBytes(&randomPadding);
+
+        encryptedPackage = Utils::rsa(sha + innerData + randomPadding, m_rsaKey);
+    }
+
+    QByteArray output;
+    CTelegramStream outputStream(&output, /* write */ true);
+
+    outputStream << TLValue::ReqDHParams;
+    outputStream << m_clientNonce;
+    outputStream << m_serverNonce;
+
+    bigEndianNumber.fill(char(0), 4);
+    qToBigEndian(m_p, (uchar *) bigEndianNumber.data());
+    outputStream << bigEndianNumber;
+
+    qToBigEndian(m_q, (uchar *) bigEndianNumber.data());
+    outputStream << bigEndianNumber;
+
+    outputStream << m_serverPublicFingersprint;
+
+    outputStream << encryptedPackage;
+
+    sendPlainPackage(output);
+
+    setAuthState(AuthStateDhRequested);
+}
+
+bool CTelegramConnection::answerDh(const QByteArray &payload)
+{
+    CTelegramStream inputStream(payload);
+
+    TLValue responseTLValue;
+    inputStream >> responseTLValue;
+
+    if (responseTLValue != TLValue::ServerDHParamsOk) {
+        qDebug() << "Error: Server did not accept our DH params.";
+        return false;
+    }
+
+    TLNumber128 clientNonce;
+    TLNumber128 serverNonce;
+
+    inputStream >> clientNonce;
+
+    if (clientNonce != m_clientNonce) {
+        qDebug() << "Error: Client nonce in incoming package is different from our own.";
+        return false;
+    }
+
+    inputStream >> serverNonce;
+
+    if (serverNonce != m_serverNonce) {
+        qDebug() << "Error: Server nonce in incoming package is different from known early.";
+        return false;
+    }
+
+    QByteArray encryptedAnswer;
+
+    inputStream >> encryptedAnswer;
+
+    m_tmpAesKey = generateTmpAesKey();
+
+    QByteArray answer = Utils::aesDecrypt(encryptedAnswer, m_tmpAesKey);
+
+    QByteArray sha1OfAnswer = answer.mid(0, 20);
+    answer = answer.mid(20, 564);
+
+    if (Utils::sha1(answer) != sha1OfAnswer) {
+        qDebug() << "Error: SHA1 of encrypted answer is different from announced.";
+        return false;
+    }
+
+    CTelegramStream encryptedInputStream(answer);
+
+    encryptedInputStream >> responseTLValue;
+
+    if (responseTLValue != TLValue::ServerDHInnerData) {
+        qDebug() << "Error: Unexpected TL Value in encrypted answer.";
+        return false;
+    }
+
+    encryptedInputStream >> clientNonce;
+
+    if (clientNonce != m_clientNonce) {
+        qDebug() << "Error: Client nonce in incoming package is different from our own.";
+        return false;
+    }
+
+    encryptedInputStream >> serverNonce;
+
+    if (serverNonce != m_serverNonce) {
+        qDebug() << "Error: Server nonce in incoming package is different from known early.";
+        return false;
+    }
+
+    encryptedInputStream >> m_g;
+    encryptedInputStream >> m_dhPrime;
+    encryptedInputStream >> m_gA;
+
+    if ((m_g < 2) || (m_g > 7)) {
+        qDebug() << "Error: Received 'g' number is out of acceptable range [2-7].";
+        return false;
+    }
+
+    if (m_dhPrime.length() != 2048 / 8) {
+        qDebug() << "Error: Received dhPrime number length is not correct." << m_dhPrime.length() << 2048 / 8;
+        return false;
+    }
+
+    if (!(m_dhPrime.at(0) & 128)) {
+        qDebug() << "Error: Received dhPrime is too small.";
+        return false;
+    }
+
+    quint32 serverTime;
+
+    encryptedInputStream >> serverTime;
+
+    if (!m_clockOffsetSamplesCount) {
+        // The plain message id is more precise, so this is only a fallback for the case of the message id absence.
+        setDeltaTime(qint64(serverTime) - (QDateTime::currentMSecsSinceEpoch() / 1000));
+    }
+
+    m_b.resize(256);
+    Utils::randomBytes(&m_b);
+
+    return true;
+}
+
+void CTelegramConnection::requestDhGenerationResult()
+{
+    QByteArray output;
+    CTelegramStream outputStream(&output, /* write */ true);
+
+    outputStream << TLValue::SetClientDHParams;
+    outputStream << m_clientNonce;
+    outputStream << m_serverNonce;
+
+    QByteArray encryptedPackage;
+    {
+        QByteArray innerData;
+        CTelegramStream encryptedStream(&innerData, /* write */ true);
+
+        encryptedStream << TLValue::ClientDHInnerData;
+
+        encryptedStream << m_clientNonce;
+        encryptedStream << m_serverNonce;
+        encryptedStream << m_authRetryId;
+
+        QByteArray binNumber;
+        binNumber.resize(sizeof(m_g));
+        qToBigEndian(m_g, (uchar *) binNumber.data());
+
+        binNumber = Utils::binaryNumberModExp(binNumber, m_dhPrime, m_b);
+
+        encryptedStream << binNumber;
+
+        QByteArray sha = Utils::sha1(innerData);
+        QByteArray randomPadding;
+
+        int packageLength = sha.length() + innerData.length();
+        if ((packageLength) % 16) {
+            randomPadding.resize(16 - (packageLength % 16));
+            Utils::randomBytes(&randomPadding);
+
+            packageLength += randomPadding.size();
+        }
+
+        encryptedPackage = Utils::aesEncrypt(sha + innerData + randomPadding, m_tmpAesKey);
+
+        encryptedPackage.truncate(packageLength);
+    }
+
+    outputStream << encryptedPackage;
+
+    sendPlainPackage(output);
+    setAuthState(AuthStateDhGenerationResultRequested);
+}
+
+bool CTelegramConnection::processServersDHAnswer(const QByteArray &payload)
+{
+    CTelegramStream inputStream(payload);
+
+    TLValue responseTLValue;
+    inputStream >> responseTLValue;
+
+    TLNumber128 clientNonce;
+    TLNumber128 serverNonce;
+
+    inputStream >> clientNonce;
+
+    if (clientNonce != m_clientNonce) {
+        qDebug() << "Error: Client nonce in incoming package is different from our own.";
+        return false;
+    }
+
+    inputStream >> serverNonce;
+
+    if (serverNonce != m_serverNonce) {
+        qDebug() << "Error: Server nonce in incoming package is different from known early.";
+        return false;
+    }
+
+    TLNumber128 newNonceHashLower128;
+
+    inputStream >> newNonceHashLower128;
+
+    QByteArray readedHashPart(newNonceHashLower128.data, newNonceHashLower128.size());
+
+    QByteArray expectedHashData(m_newNonce.data, m_newNonce.size());
+
+    QByteArray newAuthKey = Utils::binaryNumberModExp(m_gA, m_dhPrime, m_b);
+
+    expectedHashData.append(Utils::sha1(newAuthKey).left(8));
+
+    if (responseTLValue == TLValue::DhGenOk) {
+//        qDebug() << "Answer OK";
+
+        expectedHashData.insert(32, char(1));
+        if (Utils::sha1(expectedHashData).mid(4) != readedHashPart) {
+            qDebug() << "Error: Server (newNonce + auth key) hash is not correct.";
+            return false;
+        }
+
+        setAuthKey(newAuthKey);
+        m_serverSalt = m_serverNonce.parts[0] ^ m_newNonce.parts[0];
+
+        setAuthState(AuthStateHaveAKey);
+        return true;
+    } else if (responseTLValue == TLValue::DhGenRetry) {
+        qDebug() << "Answer RETRY";
+
+        expectedHashData.insert(32, char(2));
+        if (Utils::sha1(expectedHashData).mid(4) != readedHashPart) {
+            qDebug() << "Error: Server (newNonce + auth key) hash is not correct.";
+            return false;
+        }
+    } else if (responseTLValue == TLValue::DhGenFail) {
+        qDebug() << "Answer FAIL";
+
+        expectedHashData.insert(32, char(3));
+        if (Utils::sha1(expectedHashData).mid(4) != readedHashPart) {
+            qDebug() << "Error: Server (newNonce + auth key) hash is not correct.";
+            return false;
+        }
+    }
+
+    qDebug() << "Error: Unexpected server response.";
+
+    return false;
+}
+
+void CTelegramConnection::processRedirectedPackage(const QByteArray &data)
+{
+    sendEncryptedPackage(data);
+}
+
+TLValue CTelegramConnection::processRpcQuery(const QByteArray &data)
+{
+    CTelegramStream stream(data);
+
+    bool isUpdate;
+    TLValue value = processUpdate(stream, &isUpdate); // Doubtfully that this approach will work in next time.
+
+    if (isUpdate) {
+        return value;
+    }
+
+    switch (value) {
+    case TLValue::NewSessionCreated:
+        processSessionCreated(stream);
+        break;
+    case TLValue::MsgContainer:
+        processContainer(stream);
+        break;
+    case TLValue::RpcResult:
+        processRpcResult(stream);
+        break;
+    case TLValue::MsgsAck:
+        processMessageAck(stream);
+        break;
+    case TLValue::BadMsgNotification:
+    case TLValue::BadServerSalt:
+        processIgnoredMessageNotification(stream);
+        break;
+    case TLValue::GzipPacked:
+        processGzipPackedRpcQuery(stream);
+        break;
+    case TLValue::Pong:
+        processPingPong(stream);
+        break;
+    case TLValue::FutureSalts:
+        processFutureSalts(stream);
+        break;
+    default:
+        qDebug() << Q_FUNC_INFO << "value:" << value.toString();
+        break;
+    }
+
+    if (stream.error()) {
+        qWarning() << Q_FUNC_INFO << "Read of RPC result caused error. RPC type:" << value.toString() << "(read from the package -> can be misleading)";
+    }
+
+    return value;
+}
+
+void CTelegramConnection::processSessionCreated(CTelegramStream &stream)
+{
+    // https://core.telegram.org/mtproto/service_messages#new-session-creation-notification
+    quint64 n;
+
+    stream >> n;
+    stream >> n;
+    stream >> n;
+}
+
+void CTelegramConnection::processContainer(CTelegramStream &stream)
+{
+    // https://core.telegram.org/mtproto/service_messages#simple-container
+    quint32 itemsCount;
+
+    stream >> itemsCount;
+
+    for (quint32 i = 0; i < itemsCount; ++i) {
+        quint64 id;
+        stream >> id;
+
+        quint32 seqNo;
+        stream >> seqNo;
+
+        quint32 size;
+
+        stream >> size;
+
+        // The message data is not copied; it is valid while the container is processed.
+        const QByteArray data = stream.readBytesView(size);
+
+        if (acceptReceivedMessage(id, seqNo)) {
+            processRpcQuery(data);
+        }
+    }
+}
+
+void CTelegramConnection::processRpcResult(CTelegramStream &stream, quint64 idHint)
+{
+    quint64 id = idHint;
+
+    if (!id) {
+        quint64 messageId;
+        stream >> messageId;
+        id = requestIdByMessageId(messageId);
+    }
+
+    TLValue request;
+
+    const QByteArray &requestData = m_submittedPackages.value(id);
+
+    if (!requestData.isEmpty()) {
+        CTelegramStream storedStream(requestData);
+        TLValue processingResult;
+
+        storedStream >> request;
+
+        if (storedStream.error()) {
+            qWarning() << Q_FUNC_INFO << "Unable to read request type from the saved package. Package with id" << id << "ignored.";
+            return;
+        }
+
+        if (!isServiceRequest(requestData)) {
+            restartIdleTimer();
+        }
+
+        const RpcResultReader *resultReader = rpcResultReader(request);
+
+        if (resultReader) {
+            processingResult = (this->*resultReader->reader)(stream, id);
+        } else if (request == TLValue::RpcDropAnswer) {
+            processingResult = processRpcDropAnswer(stream, id);
+        } else if (request != TLValue::Ping) {
+            qDebug() << "Unknown outgoing RPC type:" << request.toString();
+        }
+
+        switch (processingResult) {
+        case TLValue::RpcError:
+            // The request is answered, unless it is queued again (e.g. to wait for the flood limit).
+            forgetPackageMessage(id);
+            processRpcError(stream, id, request);
+
+            if (!m_pendingPackages.contains(id) && !isDelayedPackage(id)) {
+                removeSubmittedPackage(id);
+            }
+            break;
+        case TLValue::GzipPacked:
+            processGzipPackedRpcResult(stream, id);
+            break;
+        default:
+            // Any other results considered as success
+            removeSubmittedPackage(id);
+            break;
+        }
+        if (stream.error()) {
+            qWarning() << Q_FUNC_INFO << "Read of RPC result caused an error. RPC type:" << request.toString() << "Package id:" << id;
+        }
+    } else {
+        stream >> request;
+        qDebug() << "Unexpected RPC message:" << request.toString() << "id" << id;
+    }
+}
+
+void CTelegramConnection::processGzipPackedRpcQuery(CTelegramStream &stream)
+{
+    const QByteArray packedData = stream.readByteArrayView();
+    const QByteArray data = Utils::unpackGZip(packedData);
+
+    if (!data.isEmpty()) {
+        processRpcQuery(data);
+    }
+}
+
+void CTelegramConnection::processGzipPackedRpcResult(CTelegramStream &stream, quint64 id)
+{
+    const QByteArray packedData = stream.readByteArrayView();
+    const QByteArray data = Utils::unpackGZip(packedData);
+
+    if (!data.isEmpty()) {
+        CTelegramStream unpackedStream(data);
+        processRpcResult(unpackedStream, id);
+    }
+}
+
+bool CTelegramConnection::processRpcError(CTelegramStream &stream, quint64 id, TLValue request)
+{
+    quint32 errorCode;
+    stream >> errorCode;
+
+    QString errorMessage;
+    stream >> errorMessage;
+
+    qDebug() << Q_FUNC_INFO << QString(QLatin1String("RPC Error %1: %2 for message %3 %4 (dc %5|%6:%7)"))
+                .arg(errorCode).arg(errorMessage).arg(id).arg(request.toString()).arg(m_dcInfo.id).arg(m_dcInfo.ipAddress).arg(m_dcInfo.port);
+
+    switch (errorCode) {
+    case 303: // ERROR_SEE_OTHER
+        if (processErrorSeeOther(errorMessage, id)) {
+            return true;
+        }
+        break;
+    case 400: // BAD_REQUEST
+        switch (request) {
+        case TLValue::AuthCheckPhone:
+        case TLValue::AuthSendCode:
+        case TLValue::AuthSendCall:
+        case TLValue::AuthSignIn:
+        case TLValue::AuthSignUp:
+            if (errorMessage == QLatin1String("API_ID_INVALID")) {
+                emit authSignErrorReceived(TelegramNamespace::AuthSignErrorAppIdIsInvalid, errorMessage);
+            } else if (errorMessage == QLatin1String("PHONE_NUMBER_INVALID")) {
+                emit authSignErrorReceived(TelegramNamespace::AuthSignErrorPhoneNumberIsInvalid, errorMessage);
+            } else if (errorMessage == QLatin1String("PHONE_NUMBER_OCCUPIED")) {
+                emit authSignErrorReceived(TelegramNamespace::AuthSignErrorPhoneNumberIsOccupied, errorMessage);
+            } else if (errorMessage == QLatin1String("PHONE_NUMBER_UNOCCUPIED")) {
+                emit authSignErrorReceived(TelegramNamespace::AuthSignErrorPhoneNumberIsUnoccupied, errorMessage);
+            } else if (errorMessage == QLatin1String("PHONE_CODE_INVALID")) {
+                emit authSignErrorReceived(TelegramNamespace::AuthSignErrorPhoneCodeIsInvalid, errorMessage);
+            } else if (errorMessage == QLatin1String("PHONE_CODE_EXPIRED")) {
+                emit authSignErrorReceived(TelegramNamespace::AuthSignErrorPhoneCodeIsExpired, errorMessage);
+            } else if (errorMessage == QLatin1String("FIRSTNAME_INVALID")) {
+                emit authSignErrorReceived(TelegramNamespace::AuthSignErrorFirstNameIsInvalid, errorMessage);
+            } else if (errorMessage == QLatin1String("LASTNAME_INVALID")) {
+                emit authSignErrorReceived(TelegramNamespace::AuthSignErrorLastNameIsInvalid, errorMessage);
+            } else {
+                emit authSignErrorReceived(TelegramNamespace::AuthSignErrorUnknown, errorMessage);
+            }
+
+            return true;
+        case TLValue::AccountCheckUsername:
+        case TLValue::AccountUpdateUsername: {
+            const QString userName = userNameFromPackage(id);
+
+            if (errorMessage == QLatin1String("USERNAME_INVALID")) {
+                emit userNameStatusUpdated(userName, TelegramNamespace::AccountUserNameStatusIsInvalid);
+            } else if (errorMessage == QLatin1String("USERNAME_OCCUPIED")) {
+                emit userNameStatusUpdated(userName, TelegramNamespace::AccountUserNameStatusIsOccupied);
+            } else if (errorMessage == QLatin1String("USERNAME_NOT_MODIFIED")) {
+                emit userNameStatusUpdated(userName, TelegramNamespace::AccountUserNameStatusIsNotModified);
+            } else {
+                emit userNameStatusUpdated(userName, TelegramNamespace::AccountUserNameStatusUnknown);
+            }
+        }
+            break;
+        default:
+            break;
+        }
+        break;
+    case 401: // UNAUTHORIZED
+        emit authorizationErrorReceived();
+        break;
+    case 420: // FLOOD
+        if (processFloodWait(errorMessage, id)) {
+            return true;
+        }
+        break;
+    default:
+        qDebug() << "RPC Error can not be handled.";
+        break;
+    }
+
+    return false;
+}
+
+TLValue CTelegramConnection::processRpcDropAnswer(CTelegramStream &stream, quint64 id)
+{
+    TLValue result;
+    stream >> result;
+
+    switch (result) {
+    case TLValue::RpcAnswerDropped: {
+        quint64 messageId;
+        quint32 sequenceNumber;
+        quint32 bytes;
+
+        stream >> messageId;
+        stream >> sequenceNumber;
+        stream >> bytes;
+
+        qDebug() << Q_FUNC_INFO << "Answer dropped for message" << messageId << "saved bytes:" << bytes;
+    }
+        break;
+    case TLValue::RpcAnswerDroppedRunning:
+    case TLValue::RpcAnswerUnknown:
+        qDebug() << Q_FUNC_INFO << result.toString() << "for drop request" << id;
+        break;
+    default:
+        break;
+    }
+
+    return result;
+}
+
+void CTelegramConnection::processMessageAck(CTelegramStream &stream)
+{
+    TLVector<quint64> idsVector;
+
+    stream >> idsVector;
+
+    foreach (quint64 id, idsVector) {
+        qDebug() << Q_FUNC_INFO << "Package" << id << "acked";
+//        m_submittedPackages.remove(id);
+    }
+}
+
+void CTelegramConnection::processIgnoredMessageNotification(CTelegramStream &stream)
+{
+    // https://core.telegram.org/mtproto/service_messages_about_messages#notice-of-ignored-error-message
+    quint64 id;
+    stream >> id;
+
+    quint32 seqNo;
+    stream >> seqNo;
+
+    quint32 errorCode;
+    stream >> errorCode;
+
+    QString errorText;
+    switch (errorCode) {
+    case 16:
+        errorText = QLatin1String("Id too low");
+        break;
+    case 17:
+        errorText = QLatin1String("Id too high");
+        break;
+    case 18:
+        errorText = QLatin1String("Incorrect two lower order id bits");
+        break;
+    case 19:
+        errorText = QLatin1String("Container id is the same as id of a previously received message");
+        break;
+    case 20:
+        errorText = QLatin1String("Message too old, and it cannot be verified whether the server has received a message with this id or not");
+        break;
+    case 32:
+        errorText = QLatin1String("Sequence number too low");
+        break;
+    case 33:
+        errorText = QLatin1String("Sequence number too high");
+        break;
+    case 34:
+        errorText = QLatin1String("An even sequence number expected");
+        break;
+    case 35:
+        errorText = QLatin1String("Odd sequence number expected");
+        break;
+    case 48:
+        errorText = QLatin1String("Incorrect server salt");
+        break;
+    case 64:
+        errorText = QLatin1String("Invalid container");
+        break;
+    default:
+        errorText = QLatin1String("Unknown error code");
+        break;
+    }
+    qDebug() << QString(QLatin1String("Bad message %1/%2: Code %3 (%4).")).arg(id).arg(seqNo).arg(errorCode).arg(errorText);
+
+    if ((errorCode == 16) || (errorCode == 17)) {
+        // The notification id is the server time at the moment of the rejection, so the offset sample
+        // of this very message is accurate enough to apply it as is, without the smoothing.
+        setClockOffset(m_lastClockOffsetSample);
+
+        sendEncryptedPackageAgain(id);
+        qDebug() << "Clock offset fixed to" << clockOffset() << "ms";
+    } else if (errorCode == 48) {
+        m_serverSalt = m_receivedServerSalt;
+        sendEncryptedPackageAgain(id);
+        qDebug() << "Local serverSalt fixed to" << m_serverSalt;
+
+        // The known salts schedule turned to be useless, so request the new one.
+        m_serverSalts.clear();
+        whenItsTimeToUpdateServerSalt();
+    }
+}
+
+void CTelegramConnection::processPingPong(CTelegramStream &stream)
+{
+    quint64 pid;
+    quint64 msgId;
+    stream >> msgId;
+    stream >> pid;
+
+    m_lastReceivedPingId = pid;
+    m_lastReceivedPingTime = QDateTime::currentMSecsSinceEpoch();
+    removeSubmittedPackage(requestIdByMessageId(msgId));
+
+    if (m_lastSentPingTime && (pid == m_lastSentPingId)) {
+        updateRoundTripTime(m_lastSentPingTime);
+
+        if (m_keepAliveProbe) {
+            m_keepAliveProbe = false;
+            processKeepAliveProbeResult(/* success */ true);
+        }
+    }
+
+//    qDebug() << Q_FUNC_INFO << m_lastReceivedPingId << m_lastReceivedPingTime;
+}
+
+void CTelegramConnection::processFutureSalts(CTelegramStream &stream)
+{
+    // https://core.telegram.org/mtproto/service_messages#request-for-several-future-salts
+    quint64 requestMessageId;
+    quint32 now;
+    quint32 count;
+
+    stream >> requestMessageId;
+    stream >> now;
+    stream >> count; // Bare vector, there is no vector type id
+
+    if (count > 64) {
+        qWarning() << Q_FUNC_INFO << "Unexpected salts count:" << count;
+        return;
+    }
+
+    TLVector<TLFutureSalt> salts;
+
+    for (quint32 i = 0; i < count; ++i) {
+        TLFutureSalt salt;
+        stream >> salt;
+        salts.append(salt);
+    }
+
+    if (stream.error()) {
+        qWarning() << Q_FUNC_INFO << "Unable to read the future salts.";
+        return;
+    }
+
+    const quint64 requestId = requestIdByMessageId(requestMessageId);
+    removeSubmittedPackage(requestId);
+
+    if (requestId && (requestId == m_futureSaltsRequestId)) {
+        m_futureSaltsRequestId = 0;
+    }
+
+    qDebug() << Q_FUNC_INFO << "Received" << salts.count() << "salts";
+
+    setServerSalts(salts);
+    whenItsTimeToUpdateServerSalt();
+}
+
+TLValue CTelegramConnection::processHelpGetConfig(CTelegramStream &stream, quint64 id)
+{
+    Q_UNUSED(id);
+
+    TLConfig result;
+    stream >> result;
+
+    if (result.tlType == TLValue::Config) {
+        m_dcConfiguration = result.dcOptions;
+
+        if (m_dcInfo.id != result.thisDc) {
+            emit actualDcIdReceived(m_dcInfo.id, result.thisDc);
+        }
+
+        emit dcConfigurationReceived(m_dcInfo.id);
+    }
+
+    return result.tlType;
+}
+
+TLValue CTelegramConnection::processContactsGetContacts(CTelegramStream &stream, quint64 id)
+{
+    Q_UNUSED(id);
+
+    TLContactsContacts result;
+    stream >> result;
+
+    if (result.tlType == TLValue::ContactsContacts) {
+        emit usersReceived(result.users);
+
+        QVector<quint32> contactList;
+        foreach (const TLUser &user, result.users) {
+            contactList.append(user.id);
+        }
+
+        emit contactListReceived(contactList);
+    }
+
+    return result.tlType;
+}
+
+TLValue CTelegramConnection::processContactsImportContacts(CTelegramStream &stream, quint64 id)
+{
+    Q_UNUSED(id);
+
+    TLContactsImportedContacts result;
+    stream >> result;
+
+    if (result.tlType == TLValue::ContactsImportedContacts) {
+        emit usersReceived(result.users);
+
+        QVector<quint32> addedList;
+        foreach (const TLUser &user, result.users) {
+            addedList.append(user.id);
+        }
+
+        emit contactListChanged(addedList, QVector<quint32>());
+    }
+
+    return result.tlType;
+}
+
+TLValue CTelegramConnection::processContactsDeleteContacts(CTelegramStream &stream, quint64 id)
+{
+    Q_UNUSED(id);
+
+    TLValue result;
+    stream >> result;
+
+    return result;
+}
+
+TLValue CTelegramConnection::processUpdatesGetState(CTelegramStream &stream, quint64 id)
+{
+    Q_UNUSED(id);
+
+    TLUpdatesState result;
+    stream >> result;
+
+    switch (result.tlType) {
+    case TLValue::UpdatesState:
+        emit updatesStateReceived(result);
+        break;
+    default:
+        break;
+    }
+
+    return result.tlType;
+}
+
+TLValue CTelegramConnection::processUpdatesGetDifference(CTelegramStream &stream, quint64 id)
+{
+    Q_UNUSED(id);
+
+    // The difference can be huge, so the messages are decoded only on demand.
+    TLUpdatesDifferenceView result;
+    stream >> result;
+
+    switch (result.tlType()) {
+    case TLValue::UpdatesDifference:
+    case TLValue::UpdatesDifferenceSlice:
+    case TLValue::UpdatesDifferenceEmpty:
+        emit updatesDifferenceReceived(result);
+        break;
+    default:
+        break;
+    }
+
+    return result.tlType();
+}
+
+TLValue CTelegramConnection::processAuthCheckPhone(CTelegramStream &stream, quint64 id)
+{
+    TLAuthCheckedPhone result;
+    stream >> result;
+
+    if (result.tlType == TLValue::AuthCheckedPhone) {
+        const QByteArray data = m_submittedPackages.value(id);
+
+        if (data.isEmpty()) {
+            qDebug() << Q_FUNC_INFO << "Can not restore rpc message" << id;
+            return result.tlType;
+        }
+
+        CTelegramStream stream(data);
+        TLValue value;
+        QString phone;
+        stream >> value;
+        stream >> phone;
+
+        emit phoneStatusReceived(phone, result.phoneRegistered);
+    }
+
+    return result.tlType;
+}
+
+TLValue CTelegramConnection::processAuthExportAuthorization(CTelegramStream &stream, quint64 id)
+{
+    TLAuthExportedAuthorization result;
+    stream >> result;
+
+    if (result.tlType == TLValue::AuthExportedAuthorization) {
+        const QByteArray data = m_submittedPackages.value(id);
+
+        if (data.isEmpty()) {
+            qDebug() << Q_FUNC_INFO << "Can not restore rpc message" << id;
+            return result.tlType;
+        }
+
+        CTelegramStream stream(data);
+        TLValue value;
+        quint32 dc;
+        stream >> value;
+        stream >> dc;
+
+        emit authExportedAuthorizationReceived(dc, result.id, result.bytes);
+    }
+
+    return result.tlType;
+}
+
+TLValue CTelegramConnection::processAuthSendCode(CTelegramStream &stream, quint64 id)
+{
+    TLAuthSentCode result;
+    stream >> result;
+    qDebug() << Q_FUNC_INFO << result.tlType.toString();
+
+    if (result.tlType == TLValue::AuthSentCode) {
+        m_authCodeHash = result.phoneCodeHash;
+
+        emit phoneCodeRequired();
+    } else if (result.tlType == TLValue::AuthSentAppCode) {
+        qDebug() << Q_FUNC_INFO << "AuthSentAppCode";
+        m_authCodeHash = result.phoneCodeHash;
+
+        const QByteArray data = m_submittedPackages.value(id);
+
+        if (data.isEmpty()) {
             qDebug() << Q_FUNC_INFO << "Can not restore rpc message" << id;
             return result.tlType;
         }
 
-        CTelegramStream stream(data);
-        TLValue value;
-        QString phone;
-        stream >> value;
-        stream >> phone;
+        CTelegramStream stream(data);
+        TLValue value;
+        QString phoneNumber;
+        stream >> value;
+        stream >> phoneNumber;
+
+        authSendSms(phoneNumber, m_authCodeHash);
+    }
+
+    return result.tlType;
+}
+
+TLValue CTelegramConnection::processAuthSendSms(CTelegramStream &stream, quint64 id)
+{
+    Q_UNUSED(id);
+
+    TLValue result;
+    stream >> result;
+
+    return result;
+}
+
+TLValue CTelegramConnection::processAuthSign(CTelegramStream &stream, quint64 id)
+{
+    Q_UNUSED(id);
+
+    TLAuthAuthorization result;
+    stream >> result;
+
+    qDebug() << Q_FUNC_INFO << "AuthAuthorization" << maskPhoneNumber(result.user.phone) << result.expires;
+
+    if (result.tlType == TLValue::AuthAuthorization) {
+        setAuthState(AuthStateSignedIn);
+    }
+
+    return result.tlType;
+}
+
+TLValue CTelegramConnection::processAuthLogOut(CTelegramStream &stream, quint64 id)
+{
+    Q_UNUSED(id);
+
+    TLValue result;
+    stream >> result;
+
+    emit loggedOut(result == TLValue::BoolTrue);
+
+    return result;
+}
+
+TLValue CTelegramConnection::processUploadGetFile(CTelegramStream &stream, quint64 id)
+{
+    TLUploadFile file;
+    stream >> file;
+
+    if (file.tlType == TLValue::UploadFile) {
+        const QByteArray data = m_submittedPackages.value(id);
+
+        if (data.isEmpty()) {
+            qDebug() << Q_FUNC_INFO << "Can not restore rpc message" << id;
+        } else {
+            CTelegramStream stream(data);
+            TLValue value;
+            TLInputFileLocation location;
+            quint32 offset;
+
+            stream >> value;
+            stream >> location;
+            stream >> offset;
+
+            emit fileDataReceived(file, m_requestedFilesIds.value(id), offset);
+        }
+    }
+
+    return file.tlType;
+}
+
+TLValue CTelegramConnection::processUploadSaveFilePart(CTelegramStream &stream, quint64 id)
+{
+    TLValue result;
+    stream >> result;
+
+    if (result == TLValue::BoolTrue) {
+        emit fileDataSent(m_requestedFilesIds.take(id));
+    } else {
+        // retry putFile() call?
+    }
+
+    return result;
+}
+
+TLValue CTelegramConnection::processUsersGetUsers(CTelegramStream &stream, quint64 id)
+{
+    Q_UNUSED(id);
+
+    TLVector<TLUser> result;
+
+    stream >> result;
+
+    if (result.tlType == TLValue::Vector) {
+        emit usersReceived(result);
+    }
+
+    return result.tlType;
+}
+
+TLValue CTelegramConnection::processUsersGetFullUser(CTelegramStream &stream, quint64 id)
+{
+    Q_UNUSED(id);
+
+    TLUserFull result;
+
+    stream >> result;
+
+    switch (result.tlType) {
+    case TLValue::UserFull:
+        emit fullUserReceived(result);
+        break;
+    default:
+        break;
+    }
+
+    return result.tlType;
+}
+
+TLValue CTelegramConnection::processMessagesSendMessage(CTelegramStream &stream, quint64 id)
+{
+    TLShared<TLMessagesSentMessage> result;
+    stream >> result;
+    const TLValue resultType = result->tlType;
+
+    TLInputPeer peer;
+    quint64 randomId;
+
+    if (readSendMessageRequest(m_submittedPackages.take(id), &peer, &randomId)) {
+        emit messageSentInfoReceived(peer, randomId, result);
+    }
+
+    return resultType;
+}
+
+TLValue CTelegramConnection::processMessagesSetTyping(CTelegramStream &stream, quint64 id)
+{
+    Q_UNUSED(id);
+
+    TLValue result;
+    stream >> result;
+
+    return result;
+}
+
+TLValue CTelegramConnection::processMessagesReadHistory(CTelegramStream &stream, quint64 id)
+{
+    Q_UNUSED(id);
+
+    TLMessagesAffectedHistory result;
+    stream >> result;
+
+    return result.tlType;
+}
+
+TLValue CTelegramConnection::processMessagesReceivedMessages(CTelegramStream &stream, quint64 id)
+{
+    Q_UNUSED(id);
+
+    TLVector<quint32> result;
+    stream >> result;
+
+    return result.tlType;
+}
+
+TLValue CTelegramConnection::processMessagesGetHistory(CTelegramStream &stream, quint64 id)
+{
+    TLShared<TLMessagesMessages> result;
+    stream >> result;
+    const TLValue resultType = result->tlType;
+
+    const QByteArray data = m_submittedPackages.value(id);
+
+    if (data.isEmpty()) {
+        qDebug() << Q_FUNC_INFO << "Can not restore rpc message" << id;
+    } else {
+        CTelegramStream stream(data);
+        TLValue value;
+        TLInputPeer peer;
+
+        stream >> value;
+        stream >> peer;
+
+        emit messagesHistoryReceived(result, peer);
+    }
+
+    return resultType;
+}
+
+TLValue CTelegramConnection::processMessagesGetChats(CTelegramStream &stream, quint64 id)
+{
+    Q_UNUSED(id);
+
+    TLMessagesChats result;
+    stream >> result;
+
+    if (result.tlType == TLValue::MessagesChats) {
+        emit messagesChatsReceived(result.chats);
+    }
+
+    return result.tlType;
+}
+
+TLValue CTelegramConnection::processMessagesGetFullChat(CTelegramStream &stream, quint64 id)
+{
+    Q_UNUSED(id);
+
+    TLMessagesChatFull result;
+    stream >> result;
+
+    if (result.tlType == TLValue::MessagesChatFull) {
+        emit messagesFullChatReceived(result.fullChat, result.chats, result.users);
+    }
+
+    return result.tlType;
+}
+
+TLValue CTelegramConnection::processAccountCheckUsername(CTelegramStream &stream, quint64 id)
+{
+    TLValue result;
+    stream >> result;
+
+    const QString userName = userNameFromPackage(id);
+
+    switch (result) {
+    case TLValue::BoolTrue:
+        emit userNameStatusUpdated(userName, TelegramNamespace::AccountUserNameStatusCanBeUsed);
+        break;
+    case TLValue::BoolFalse:
+        emit userNameStatusUpdated(userName, TelegramNamespace::AccountUserNameStatusCanNotBeUsed);
+        break;
+    default:
+        break;
+    }
+
+    return result;
+}
+
+TLValue CTelegramConnection::processAccountUpdateStatus(CTelegramStream &stream, quint64 id)
+{
+    Q_UNUSED(id);
+
+    TLValue result;
+    stream >> result;
+
+    return result;
+}
+
+TLValue CTelegramConnection::processAccountUpdateUsername(CTelegramStream &stream, quint64 id)
+{
+    TLUser result;
+    stream >> result;
+
+    const QString userName = userNameFromPackage(id);
+
+    if (result.tlType == TLValue::UserSelf) {
+        if (result.username == userName) {
+            emit userNameStatusUpdated(userName, TelegramNamespace::AccountUserNameStatusAccepted);
+        }
+        emit usersReceived(QVector<TLUser>() << result);
+    }
+
+    return result.tlType;
+}
+
+bool CTelegramConnection::processErrorSeeOther(const QString errorMessage, quint64 id)
+{
+    int lastSectionIndex = errorMessage.lastIndexOf(QChar(QLatin1Char('_')));
+    if (lastSectionIndex < 0) {
+        return false;
+    }
+
+    quint16 dc = 0;
+
+    bool ok;
+
+    const QString dcStr = errorMessage.mid(lastSectionIndex + 1);
+    dc = dcStr.toUInt(&ok);
+
+    if (!ok) {
+        return false;
+    }
+
+    const QByteArray data = m_submittedPackages.value(id);
+
+    if (data.isEmpty()) {
+        qDebug() << Q_FUNC_INFO << "Can not restore message" << id;
+        return false;
+    }
+
+    removeSubmittedPackage(id);
+
+    CTelegramStream stream(data);
+    TLValue value;
+    stream >> value;
+
+    if (value == TLValue::AuthSendCode) {
+        emit wantedActiveDcChanged(dc);
+    }
+
+    emit newRedirectedPackage(data, dc);
+
+    return true;
+}
+
+bool CTelegramConnection::processFloodWait(const QString &errorMessage, quint64 id)
+{
+    // FLOOD_WAIT_X (and alike): X is the time in seconds to wait before the next request of the method.
+    bool ok;
+    const quint32 seconds = errorMessage.section(QLatin1Char('_'), -1).toUInt(&ok);
+
+    if (!ok || !m_submittedPackages.contains(id)) {
+        return false;
+    }
+
+    quint64 methodKey;
+    quint64 peerKey;
+    getFloodWaitKeys(m_submittedPackages.value(id), &methodKey, &peerKey);
+
+    // The peer-specific limit is enough for the methods with a peer (such as sending a message to a chat).
+    m_floodWaitLimiter.processFloodWait(peerKey ? peerKey : methodKey, seconds, QDateTime::currentMSecsSinceEpoch());
+
+    const TLValue method = TLValue::firstFromArray(m_submittedPackages.value(id));
+
+    const bool dropped = seconds > s_floodWaitMaximumDelay;
+
+    if (dropped) {
+        qDebug() << Q_FUNC_INFO << "Drop the request" << id << method.toString() << "which has to wait for" << seconds << "seconds";
+
+        TLInputPeer peer;
+        quint64 randomId;
+
+        if ((method == TLValue::MessagesSendMessage) && readSendMessageRequest(m_submittedPackages.value(id), &peer, &randomId)) {
+            emit messageSendingFailed(peer, randomId);
+        }
+
+        removeSubmittedPackage(id);
+    } else {
+        // The request is answered, so it is sent in a new message after the delay.
+        forgetPackageMessage(id);
+        m_pendingPackages.removeOne(id);
+        addDelayedPackage(id, seconds * 1000);
+    }
+
+    emit floodWaitReceived(id, method, seconds, dropped);
+
+    return true;
+}
+
+TLValue CTelegramConnection::processUpdate(CTelegramStream &stream, bool *ok)
+{
+    TLShared<TLUpdates> updates;
+    stream >> updates;
+
+    if (stream.error()) {
+        qWarning() << Q_FUNC_INFO << "Read of an update caused an error.";
+    }
+
+    // The value is shared with the receivers after the emission, so it is not accessed as non-const anymore
+    const TLValue updatesType = updates->tlType;
+
+    switch (updatesType) {
+    case TLValue::UpdatesTooLong:
+    case TLValue::UpdateShortMessage:
+    case TLValue::UpdateShortChatMessage:
+    case TLValue::UpdateShort:
+    case TLValue::UpdatesCombined:
+    case TLValue::Updates:
+        emit updatesReceived(updates);
+        *ok = true;
+        break;
+    default:
+        *ok = false;
+        break;
+    }
+
+    return updatesType;
+}
+
+void CTelegramConnection::whenTransportStateChanged()
+{
+#ifdef NETWORK_LOGGING
+    if (!m_logFile) {
+        QDir dir;
+        dir.mkdir(QLatin1String("network"));
+
+        m_logFile = new QFile(QLatin1String("network/") + m_dcInfo.ipAddress + QLatin1String(".log"));
+        m_logFile->open(QIODevice::WriteOnly);
+    }
+
+    qDebug() << Q_FUNC_INFO << m_dcInfo.id << m_dcInfo.ipAddress << m_transport->state();
+#endif
+
+    switch (m_transport->state()) {
+    case QAbstractSocket::ConnectedState:
+        if (m_authKey.isEmpty()) {
+            initAuth();
+            setStatus(ConnectionStatusConnected);
+        } else {
+            // The same key and session are used on the new socket, so the requests, which have no answer yet,
+            // are sent again (in the same messages) before the ones queued meanwhile.
+            setAuthState(AuthStateSignedIn);
+            setStatus(ConnectionStatusConnected);
+            sendSentPackagesAgain();
+            sendPendingPackages();
+        }
+        break;
+    case QAbstractSocket::UnconnectedState:
+        if ((m_status >= ConnectionStatusConnected) && m_pingTimer && m_pingTimer->isActive()
+                && (QDateTime::currentMSecsSinceEpoch() - m_lastReceivedPackageTime >= m_keepAliveGoodInterval)) {
+            // The connection is dropped after the idle period, which is likely a NAT (or firewall) timeout.
+            m_keepAliveProbe = false;
+            processKeepAliveProbeResult(/* success */ false);
+        }
+
+        setStatus(ConnectionStatusDisconnected);
+        break;
+    default:
+        break;
+    }
+}
+
+void CTelegramConnection::whenTransportReadyRead()
+{
+    QByteArray input = m_transport->getPackage();
+
+    m_lastReceivedPackageTime = QDateTime::currentMSecsSinceEpoch();
+
+    CRawStream inputStream(input);
+
+    quint64 auth = 0;
+    quint64 timeStamp = 0;
+    quint32 length = 0;
+    QByteArray payload;
+    QByteArray decryptedData; // The payload can be a view of the decrypted data
+
+    inputStream >> auth;
+
+    /* Will be reimplemented later */
+
+    if (!auth) {
+        // Plain Message
+        inputStream >> timeStamp;
+        inputStream >> length;
+
+        if (inputStream.bytesRemaining() != int(length)) {
+            qDebug() << Q_FUNC_INFO << "Corrupted packet. Specified length does not equal to real length";
+            return;
+        }
+
+        payload = inputStream.readBytesView(length);
+
+        if (m_lastPlainPackageTime) {
+            updateRoundTripTime(m_lastPlainPackageTime);
+            m_lastPlainPackageTime = 0;
+        }
+
+        updateClockOffset(timeStamp);
+
+        switch (m_authState) {
+        case AuthStatePqRequested:
+            if (answerPqAuthorization(payload)) {
+                requestDhParameters();
+            }
+            break;
+        case AuthStateDhRequested:
+            if (answerDh(payload)) {
+                requestDhGenerationResult();
+            }
+            break;
+        case AuthStateDhGenerationResultRequested:
+            processServersDHAnswer(payload);
+            break;
+        default:
+            break;
+        }
+    } else if (m_authState >= AuthStateHaveAKey) {
+        if (auth != m_authId) {
+            qDebug() << Q_FUNC_INFO << "Incorrect auth id.";
+
+#ifdef NETWORK_LOGGING
+            QTextStream str(m_logFile);
+
+            str << QDateTime::currentDateTime().toString(QLatin1String("yyyyMMdd HH:mm:ss:zzz")) << QLatin1Char('|');
+            str << QLatin1String("pln|");
+            str << QString(QLatin1String("size: %1|")).arg(input.length(), 4, 10, QLatin1Char('0'));
+            str << QLatin1Char('|');
+            str << input.toHex();
+            str << endl;
+            str.flush();
+#endif
+
+            return;
+        }
+        // Encrypted Message
+        const QByteArray messageKey = inputStream.readBytesView(16);
+        const QByteArray data = inputStream.readBytesView(inputStream.bytesRemaining());
+
+        const SAesKey key = generateServerToClientAesKey(messageKey);
+
+        // The values, which are read from the package, do not refer to its data (the bytes are copied out),
+        // so the buffer of the previous package is reused to not load the allocator with a big block per package.
+        qSwap(decryptedData, m_receivedPackageBuffer);
+        Utils::aesDecrypt(data, key, &decryptedData);
+
+        CRawStream decryptedStream(decryptedData);
+
+        quint64 sessionId = 0;
+        quint64 messageId  = 0;
+        quint32 sequence = 0;
+        quint32 contentLength = 0;
+
+        decryptedStream >> m_receivedServerSalt;
+        decryptedStream >> sessionId;
+        decryptedStream >> messageId;
+        decryptedStream >> sequence;
+        decryptedStream >> contentLength;
+
+        if (m_serverSalt != m_receivedServerSalt) {
+            qDebug() << Q_FUNC_INFO << "Received different server salt:" << m_receivedServerSalt << "(remote) vs" << m_serverSalt << "(local)";
+//            return;
+        }
+
+        if (m_sessionId != sessionId) {
+            qDebug() << Q_FUNC_INFO << "Session Id is wrong.";
+            return;
+        }
+
+        const int headerLength = sizeof(m_receivedServerSalt) + sizeof(sessionId) + sizeof(messageId) + sizeof(sequence) + sizeof(contentLength);
 
-        emit phoneStatusReceived(phone, result.phoneRegistered);
-    }
+        // The length is not verified by the message key yet, so it is checked as unsigned before it is used for the view.
+        if (decryptedStream.error() || (contentLength > quint32(decryptedData.length() - headerLength))) {
+            qDebug() << Q_FUNC_INFO << "Expected data length is more, than actual.";
+            return;
+        }
 
-    return result.tlType;
-}
+        QByteArray expectedMessageKey = Utils::sha1(QByteArray::fromRawData(decryptedData.constData(), headerLength + contentLength)).mid(4);
 
-TLValue CTelegramConnection::processAuthExportAuthorization(CTelegramStream &stream, quint64 id)
-{
-    TLAuthExportedAuthorization result;
-    stream >> result;
+        if (messageKey != expectedMessageKey) {
+            qDebug() << Q_FUNC_INFO << "Wrong message key";
+            return;
+        }
 
-    if (result.tlType == TLValue::AuthExportedAuthorization) {
-        const QByteArray data = m_submittedPackages.value(id);
+        // The payload is a view of the decrypted data; the bytes fields are copied out of it on read.
+        payload = decryptedStream.readBytesView(decryptedStream.bytesRemaining());
 
-        if (data.isEmpty()) {
-            qDebug() << Q_FUNC_INFO << "Can not restore rpc message" << id;
-            return result.tlType;
+        updateClockOffset(messageId);
+
+        if (acceptReceivedMessage(messageId, sequence)) {
+            processRpcQuery(payload);
         }
+    }
 
-        CTelegramStream stream(data);
-        TLValue value;
-        quint32 dc;
-        stream >> value;
-        stream >> dc;
+#ifdef DEVELOPER_BUILD
+    TLValue firstValue;
 
-        emit authExportedAuthorizationReceived(dc, result.id, result.bytes);
+    if (payload.length() >= 4) {
+        quint32 *v = (quint32 *) payload.constData();
+        firstValue = TLValue(*v);
     }
 
-    return result.tlType;
+    static int packagesCount = 0;
+    qDebug() << Q_FUNC_INFO << "Got package" << ++packagesCount << firstValue.toString();
+#endif
+
+    if (!decryptedData.isNull()) {
+        // Keep the buffer for the next package
+        qSwap(decryptedData, m_receivedPackageBuffer);
+    }
 }
 
-TLValue CTelegramConnection::processAuthSendCode(CTelegramStream &stream, quint64 id)
+void CTelegramConnection::whenTransportTimeout()
 {
-    TLAuthSentCode result;
-    stream >> result;
-    qDebug() << Q_FUNC_INFO << result.tlType.toString();
+    setStatus(ConnectionStatusDisconnected, ConnectionStatusReasonTimeout);
+}
 
-    if (result.tlType == TLValue::AuthSentCode) {
-        m_authCodeHash = result.phoneCodeHash;
+void CTelegramConnection::whenItsTimeToPing()
+{
+//    qDebug() << Q_FUNC_INFO << QDateTime::currentMSecsSinceEpoch();
 
-        emit phoneCodeRequired();
-    } else if (result.tlType == TLValue::AuthSentAppCode) {
-        qDebug() << Q_FUNC_INFO << "AuthSentAppCode";
-        m_authCodeHash = result.phoneCodeHash;
+    if (status() < ConnectionStatusConnected) {
+        // Nothing to do.
+        return;
+    }
 
-        const QByteArray data = m_submittedPackages.value(id);
+    const qint64 currentTime = QDateTime::currentMSecsSinceEpoch();
 
-        if (data.isEmpty()) {
-            qDebug() << Q_FUNC_INFO << "Can not restore rpc message" << id;
-            return result.tlType;
-        }
+    if ((m_lastSentPingId != m_lastReceivedPingId) && (m_lastReceivedPackageTime < m_lastSentPingTime)) {
+        // Neither the pong, nor anything else came during the whole interval.
+        qDebug() << Q_FUNC_INFO << "pong time is out";
 
-        CTelegramStream stream(data);
-        TLValue value;
-        QString phoneNumber;
-        stream >> value;
-        stream >> phoneNumber;
+        if (m_keepAliveProbe) {
+            m_keepAliveProbe = false;
+            processKeepAliveProbeResult(/* success */ false);
+        }
 
-        authSendSms(phoneNumber, m_authCodeHash);
+        setStatus(ConnectionStatusDisconnected, ConnectionStatusReasonTimeout);
+        return;
     }
 
-    return result.tlType;
-}
+    const bool hadTrafficRecently = currentTime - m_lastReceivedPackageTime < m_keepAliveInterval;
 
-TLValue CTelegramConnection::processAuthSendSms(CTelegramStream &stream, quint64 id)
-{
-    Q_UNUSED(id);
+    if (hadTrafficRecently && m_lastSentPingTime && (currentTime - m_lastSentPingTime < m_keepAliveInterval * (s_keepAliveDisconnectFactor - 1))) {
+        // The connection is proved to be alive and the server still waits for the next ping.
+        return;
+    }
 
-    TLValue result;
-    stream >> result;
+    m_keepAliveProbe = !hadTrafficRecently && (m_keepAliveInterval < m_keepAliveCeiling);
+    m_lastSentPingTime = currentTime;
 
-    return result;
+    // Server will close the connection after m_serverDisconnectionExtraTime ms more, than the ping delay allows.
+    const quint32 disconnectDelay = m_keepAliveInterval * s_keepAliveDisconnectFactor + m_serverDisconnectionExtraTime;
+    pingDelayDisconnect((disconnectDelay + 999) / 1000);
 }
 
-TLValue CTelegramConnection::processAuthSign(CTelegramStream &stream, quint64 id)
+void CTelegramConnection::processKeepAliveProbeResult(bool success)
 {
-    Q_UNUSED(id);
+    if (success) {
+        if (m_keepAliveInterval > m_keepAliveGoodInterval) {
+            m_keepAliveGoodInterval = m_keepAliveInterval;
+        }
 
-    TLAuthAuthorization result;
-    stream >> result;
+        if (++m_keepAliveProbeSuccesses < s_keepAliveProbeSuccessCount) {
+            return;
+        }
 
-    qDebug() << Q_FUNC_INFO << "AuthAuthorization" << maskPhoneNumber(result.user.phone) << result.expires;
+        m_keepAliveInterval = qMin(m_keepAliveCeiling, m_keepAliveInterval * 3 / 2);
+    } else {
+        if (m_keepAliveInterval > m_keepAliveGoodInterval) {
+            // The probed interval is too long; do not try it anymore.
+            m_keepAliveCeiling = m_keepAliveGoodInterval;
+        } else {
+            // Even the known good interval does not work now, so back off.
+            m_keepAliveGoodInterval = qMax(m_pingInterval, m_keepAliveGoodInterval * 2 / 3);
+            m_keepAliveCeiling = m_keepAliveGoodInterval;
+        }
 
-    if (result.tlType == TLValue::AuthAuthorization) {
-        setAuthState(AuthStateSignedIn);
+        m_keepAliveInterval = m_keepAliveGoodInterval;
     }
 
-    return result.tlType;
+    m_keepAliveProbeSuccesses = 0;
+
+    qDebug() << Q_FUNC_INFO << "dc" << m_dcInfo.id << "keep-alive interval" << m_keepAliveInterval;
+
+    if (m_pingTimer) {
+        m_pingTimer->setInterval(m_keepAliveInterval);
+    }
 }
 
-TLValue CTelegramConnection::processAuthLogOut(CTelegramStream &stream, quint64 id)
+void CTelegramConnection::whenConnectionIsIdle()
 {
-    Q_UNUSED(id);
+    if (m_status < ConnectionStatusConnected) {
+        return;
+    }
 
-    TLValue result;
-    stream >> result;
+    if (!m_delayedPackages.isEmpty()) {
+        // Still has requests to send.
+        m_idleTimer->start(m_idleTimeout);
+        return;
+    }
 
-    emit loggedOut(result == TLValue::BoolTrue);
+    qDebug() << Q_FUNC_INFO << "Close the idle connection to dc" << m_dcInfo.id;
 
-    return result;
+    // The next request reconnects and signs in again (with the same key and session), so the unanswered requests
+    // are sent again in the same messages then. The service requests (such as pings) make no sense for the next connection.
+    foreach (quint64 id, m_submittedPackages.keys()) {
+        if (isServiceRequest(m_submittedPackages.value(id))) {
+            removeSubmittedPackage(id);
+        }
+    }
+
+    setAuthState(AuthStateNone);
+    m_transport->disconnectFromHost();
+    setStatus(ConnectionStatusDisconnected);
 }
 
-TLValue CTelegramConnection::processUploadGetFile(CTelegramStream &stream, quint64 id)
+void CTelegramConnection::whenItsTimeToAckMessages()
 {
-    TLUploadFile file;
-    stream >> file;
+    if (m_messagesToAck.isEmpty() || !isReadyToSendEncryptedPackages()) {
+        // Acks are not queued, so keep them until the connection is ready.
+        return;
+    }
 
-    if (file.tlType == TLValue::UploadFile) {
-        const QByteArray data = m_submittedPackages.value(id);
+    acknowledgeMessages(m_messagesToAck);
+    m_messagesToAck.clear();
+    m_messagesToAckSequenceNumbers.clear();
+}
 
-        if (data.isEmpty()) {
-            qDebug() << Q_FUNC_INFO << "Can not restore rpc message" << id;
-        } else {
-            CTelegramStream stream(data);
-            TLValue value;
-            TLInputFileLocation location;
-            quint32 offset;
+void CTelegramConnection::whenItsTimeToUpdateServerSalt()
+{
+    const quint32 time = serverTime();
 
-            stream >> value;
-            stream >> location;
-            stream >> offset;
+    while (!m_serverSalts.isEmpty() && (m_serverSalts.first().validUntil <= time + s_serverSaltExpirationMargin)) {
+        m_serverSalts.remove(0);
+    }
 
-            emit fileDataReceived(file, m_requestedFilesIds.value(id), offset);
+    if (!m_serverSalts.isEmpty() && (m_serverSalts.first().validSince <= time) && (m_serverSalt != m_serverSalts.first().salt)) {
+        m_serverSalt = m_serverSalts.first().salt;
+        qDebug() << Q_FUNC_INFO << "Switched to the next server salt" << m_serverSalt;
+    }
+
+    if ((m_serverSalts.count() < s_futureSaltsRequestThreshold) && !m_futureSaltsRequestId
+            && (m_authState >= AuthStateHaveAKey) && (m_transport->state() == QAbstractSocket::ConnectedState)) {
+        if (!m_contentRelatedMessages) {
+            // The first message of the session carries initConnection(), let it be an API request.
+            m_serverSaltTimer->start(s_futureSaltsRequestDelay);
+            return;
         }
+
+        m_futureSaltsRequestId = getFutureSalts(s_futureSaltsRequestCount);
     }
 
-    return file.tlType;
-}
+    if (m_serverSalts.isEmpty()) {
+        // Will be rescheduled on the future salts receiving.
+        m_serverSaltTimer->stop();
+        return;
+    }
 
-TLValue CTelegramConnection::processUploadSaveFilePart(CTelegramStream &stream, quint64 id)
-{
-    TLValue result;
-    stream >> result;
+    const TLFutureSalt &nextSalt = m_serverSalts.first();
+    quint32 secondsToUpdate;
 
-    if (result == TLValue::BoolTrue) {
-        emit fileDataSent(m_requestedFilesIds.take(id));
+    if (nextSalt.validSince > time) {
+        secondsToUpdate = nextSalt.validSince - time;
     } else {
-        // retry putFile() call?
+        secondsToUpdate = nextSalt.validUntil - s_serverSaltExpirationMargin - time;
     }
 
-    return result;
+    // Limit the interval to be sure that the timer is not affected by system sleep or clock change too much.
+    m_serverSaltTimer->start(qMin<quint32>(secondsToUpdate, 3600) * 1000);
 }
 
-TLValue CTelegramConnection::processUsersGetUsers(CTelegramStream &stream, quint64 id)
+SAesKey CTelegramConnection::generateTmpAesKey() const
 {
-    Q_UNUSED(id);
-
-    TLVector<TLUser> result;
-
-    stream >> result;
+    QByteArray newNonceAndServerNonce;
+    newNonceAndServerNonce.append(m_newNonce.data, m_newNonce.size());
+    newNonceAndServerNonce.append(m_serverNonce.data, m_serverNonce.size());
+    QByteArray serverNonceAndNewNonce;
+    serverNonceAndNewNonce.append(m_serverNonce.data, m_serverNonce.size());
+    serverNonceAndNewNonce.append(m_newNonce.data, m_newNonce.size());
+    QByteArray newNonceAndNewNonce;
+    newNonceAndNewNonce.append(m_newNonce.data, m_newNonce.size());
+    newNonceAndNewNonce.append(m_newNonce.data, m_newNonce.size());
 
-    if (result.tlType == TLValue::Vector) {
-        emit usersReceived(result);
-    }
+    const QByteArray key = Utils::sha1(newNonceAndServerNonce) + Utils::sha1(serverNonceAndNewNonce).mid(0, 12);
+    const QByteArray iv  = Utils::sha1(serverNonceAndNewNonce).mid(12, 8) + Utils::sha1(newNonceAndNewNonce) + QByteArray(m_newNonce.data, 4);
 
-    return result.tlType;
+    return SAesKey(key, iv);
 }
 
-TLValue CTelegramConnection::processUsersGetFullUser(CTelegramStream &stream, quint64 id)
+SAesKey CTelegramConnection::generateAesKey(const QByteArray &messageKey, int x) const
 {
-    Q_UNUSED(id);
+    // The key is generated for every package, so the hashes are computed over the parts of the auth key
+    // without temporary concatenations.
+    const char *authKey = m_authKey.constData();
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+
+    hash.addData(messageKey);
+    hash.addData(authKey + x, 32);
+    const QByteArray sha1_a = hash.result();
+
+    hash.reset();
+    hash.addData(authKey + 32 + x, 16);
+    hash.addData(messageKey);
+    hash.addData(authKey + 48 + x, 16);
+    const QByteArray sha1_b = hash.result();
+
+    hash.reset();
+    hash.addData(authKey + 64 + x, 32);
+    hash.addData(messageKey);
+    const QByteArray sha1_c = hash.result();
+
+    hash.reset();
+    hash.addData(messageKey);
+    hash.addData(authKey + 96 + x, 32);
+    const QByteArray sha1_d = hash.result();
+
+    QByteArray key;
+    key.reserve(32);
+    key.append(sha1_a.constData(), 8);
+    key.append(sha1_b.constData() + 8, 12);
+    key.append(sha1_c.constData() + 4, 12);
+
+    QByteArray iv;
+    iv.reserve(32);
+    iv.append(sha1_a.constData() + 8, 12);
+    iv.append(sha1_b.constData(), 8);
+    iv.append(sha1_c.constData() + 16, 4);
+    iv.append(sha1_d.constData(), 8);
 
-    TLUserFull result;
+    return SAesKey(key, iv);
+}
 
-    stream >> result;
+void CTelegramConnection::insertInitConnection(QByteArray *data) const
+{
+    CTelegramStream outputStream(data, /* write */ true);
 
-    switch (result.tlType) {
-    case TLValue::UserFull:
-        emit fullUserReceived(result);
-        break;
-    default:
-        break;
-    }
+    outputStream << TLValue::InvokeWithLayer;
+    outputStream << quint32(29);
+    outputStream << TLValue::InitConnection;
 
-    return result.tlType;
+    outputStream << m_appInfo->appId();
+    outputStream << m_appInfo->deviceInfo();
+    outputStream << m_appInfo->osInfo();
+    outputStream << m_appInfo->appVersion();
+    outputStream << m_appInfo->languageCode();
 }
 
-TLValue CTelegramConnection::processMessagesSendMessage(CTelegramStream &stream, quint64 id)
+quint64 CTelegramConnection::sendPlainPackage(const QByteArray &buffer)
 {
-    TLMessagesSentMessage result;
-    stream >> result;
-
-    {
-        const QByteArray data = m_submittedPackages.take(id);
+    quint64 messageId = newMessageId();
 
-        CTelegramStream outputStream(data);
+    QByteArray output;
+    CRawStream outputStream(&output, /* write */ true);
 
-        TLValue method;
-        quint32 flags;
-        TLInputPeer peer;
-        quint32 replyToMsgId;
-        QString message;
-        quint64 randomId;
+    outputStream << quint64(0);
+    outputStream << messageId;
+    outputStream << quint32(buffer.length());
+    outputStream << buffer;
 
-        outputStream >> method;
-        outputStream >> flags;
-        outputStream >> peer;
+    m_transport->sendPackage(output);
+    m_lastPlainPackageTime = QDateTime::currentMSecsSinceEpoch();
 
-        if (flags & 1 << 0) {
-            outputStream >> replyToMsgId;
-        }
+#ifdef NETWORK_LOGGING
+    CTelegramStream readBack(buffer);
+    TLValue val1;
+    readBack >> val1;
 
-        outputStream >> message;
-        outputStream >> randomId;
+    QTextStream str(m_logFile);
 
-        emit messageSentInfoReceived(peer, randomId, result);
-    }
+    str << QDateTime::currentDateTime().toString(QLatin1String("yyyyMMdd HH:mm:ss:zzz")) << QLatin1Char('|');
+    str << QLatin1String("pln|");
+    str << QString(QLatin1String("size: %1|")).arg(buffer.length(), 4, 10, QLatin1Char('0'));
+    str << formatTLValue(val1) << QLatin1Char('|');
+    str << buffer.toHex();
+    str << endl;
+    str.flush();
+#endif
 
-    return result.tlType;
+    return messageId;
 }
 
-TLValue CTelegramConnection::processMessagesSetTyping(CTelegramStream &stream, quint64 id)
+void CTelegramConnection::sendEncryptedMessage(quint64 messageId, quint32 sequenceNumber, const QByteArray &body)
 {
-    Q_UNUSED(id);
+    // The package (auth id, message key and the encrypted data) is allocated once; the data is encrypted in place.
+    static const int messageKeyLength = 16;
+    static const int innerDataOffset = sizeof(m_authId) + messageKeyLength;
 
-    TLValue result;
-    stream >> result;
+    const int innerDataLength = sizeof(m_serverSalt) + sizeof(m_sessionId) + sizeof(messageId) + sizeof(sequenceNumber)
+            + sizeof(quint32) + body.length();
+    const int paddingLength = (16 - innerDataLength % 16) % 16;
 
-    return result;
-}
+    QByteArray output;
+    output.reserve(innerDataOffset + innerDataLength + paddingLength);
 
-TLValue CTelegramConnection::processMessagesReadHistory(CTelegramStream &stream, quint64 id)
-{
-    Q_UNUSED(id);
+    {
+        CRawStream outputStream(&output, /* write */ true);
 
-    TLMessagesAffectedHistory result;
-    stream >> result;
+        outputStream << m_authId;
+        outputStream << QByteArray(messageKeyLength, char(0)); // Placeholder for the message key
 
-    return result.tlType;
-}
+        outputStream << m_serverSalt;
+        outputStream << m_sessionId;
+        outputStream << messageId;
+        outputStream << sequenceNumber;
 
-TLValue CTelegramConnection::processMessagesReceivedMessages(CTelegramStream &stream, quint64 id)
-{
-    Q_UNUSED(id);
+        outputStream << quint32(body.length());
+        outputStream << body;
+    }
 
-    TLVector<quint32> result;
-    stream >> result;
+    const QByteArray messageKey = Utils::sha1(QByteArray::fromRawData(output.constData() + innerDataOffset, innerDataLength)).mid(4);
+    const SAesKey key = generateClientToServerAesKey(messageKey);
 
-    return result.tlType;
+    // Write the padding right into the package data
+    output.resize(innerDataOffset + innerDataLength + paddingLength);
+    Utils::randomBytes(output.data() + innerDataOffset + innerDataLength, paddingLength);
+
+    memcpy(output.data() + sizeof(m_authId), messageKey.constData(), messageKeyLength);
+    Utils::aesEncrypt(output.data() + innerDataOffset, innerDataLength + paddingLength, key);
+
+    m_transport->sendPackage(output);
 }
 
-TLValue CTelegramConnection::processMessagesGetHistory(CTelegramStream &stream, quint64 id)
+quint64 CTelegramConnection::sendEncryptedPackage(const QByteArray &buffer, bool savePackage)
 {
-    TLMessagesMessages result;
-    stream >> result;
-
-    const QByteArray data = m_submittedPackages.value(id);
+    if (!savePackage) {
+        if (!isReadyToSendEncryptedPackages()) {
+            // Service messages (such as acks) make no sense for the next connection.
+            return 0;
+        }
 
-    if (data.isEmpty()) {
-        qDebug() << Q_FUNC_INFO << "Can not restore rpc message" << id;
-    } else {
-        CTelegramStream stream(data);
-        TLValue value;
-        TLInputPeer peer;
+        return sendEncryptedPackageNow(buffer);
+    }
 
-        stream >> value;
-        stream >> peer;
+    QList<quint64> dependencies;
 
-        emit messagesHistoryReceived(result, peer);
+    foreach (quint64 id, m_nextRequestDependencies) {
+        if (m_submittedPackages.contains(id)) { // There is no need to wait for the answered requests.
+            dependencies.append(id);
+        }
     }
 
-    return result.tlType;
-}
+    m_nextRequestDependencies.clear();
 
-TLValue CTelegramConnection::processMessagesGetChats(CTelegramStream &stream, quint64 id)
-{
-    Q_UNUSED(id);
+    if (!isReadyToSendEncryptedPackages()) {
+        const quint64 id = addPendingPackage(buffer);
 
-    TLMessagesChats result;
-    stream >> result;
+        if (!dependencies.isEmpty()) {
+            m_packageDependencies.insert(id, dependencies);
+        }
 
-    if (result.tlType == TLValue::MessagesChats) {
-        emit messagesChatsReceived(result.chats);
+        return id;
     }
 
-    return result.tlType;
-}
+    // The request id is the id of the message, if the request is sent right away.
+    const quint64 id = newMessageId();
+    m_submittedPackages.insert(id, buffer);
 
-TLValue CTelegramConnection::processMessagesGetFullChat(CTelegramStream &stream, quint64 id)
-{
-    Q_UNUSED(id);
+    if (!dependencies.isEmpty()) {
+        m_packageDependencies.insert(id, dependencies);
+    }
 
-    TLMessagesChatFull result;
-    stream >> result;
+    quint32 delay = dependenciesDelay(dependencies);
 
-    if (result.tlType == TLValue::MessagesChatFull) {
-        emit messagesFullChatReceived(result.fullChat, result.chats, result.users);
+    if (!delay) {
+        delay = acquireFloodWaitToken(buffer);
     }
 
-    return result.tlType;
+    if (delay) {
+        addDelayedPackage(id, delay);
+    } else {
+        sendSubmittedPackage(id, id);
+    }
+
+    return id;
 }
 
-TLValue CTelegramConnection::processAccountCheckUsername(CTelegramStream &stream, quint64 id)
+quint64 CTelegramConnection::sendEncryptedPackageNow(const QByteArray &buffer)
 {
-    TLValue result;
-    stream >> result;
+    const quint64 messageId = newMessageId();
 
-    const QString userName = userNameFromPackage(id);
+    m_sequenceNumber = m_contentRelatedMessages * 2 + 1;
+    ++m_contentRelatedMessages;
 
-    switch (result) {
-    case TLValue::BoolTrue:
-        emit userNameStatusUpdated(userName, TelegramNamespace::AccountUserNameStatusCanBeUsed);
-        break;
-    case TLValue::BoolFalse:
-        emit userNameStatusUpdated(userName, TelegramNamespace::AccountUserNameStatusCanNotBeUsed);
-        break;
-    default:
-        break;
+    QByteArray header;
+    if (m_sequenceNumber == 1) {
+        insertInitConnection(&header);
     }
 
-    return result;
+    sendEncryptedMessage(messageId, m_sequenceNumber, header + compressedPackage(buffer));
+
+#ifdef NETWORK_LOGGING
+    logEncryptedPackage(messageId, m_sequenceNumber, buffer);
+#endif
+
+    return messageId;
 }
 
-TLValue CTelegramConnection::processAccountUpdateStatus(CTelegramStream &stream, quint64 id)
+#ifdef NETWORK_LOGGING
+void CTelegramConnection::logEncryptedPackage(quint64 messageId, quint32 sequenceNumber, const QByteArray &buffer)
 {
-    Q_UNUSED(id);
+    CTelegramStream readBack(buffer);
+    TLValue val1;
+    readBack >> val1;
 
-    TLValue result;
-    stream >> result;
+    QTextStream str(m_logFile);
 
-    return result;
+    str << QString(QLatin1String("%1|enc|mId%2|seq%3|"))
+           .arg(QDateTime::currentDateTime().toString(QLatin1String("yyyyMMdd HH:mm:ss:zzz")))
+           .arg(messageId, 10, 10, QLatin1Char('0'))
+           .arg(sequenceNumber, 4, 10, QLatin1Char('0'));
+
+    str << QString(QLatin1String("size: %1|")).arg(buffer.length(), 4, 10, QLatin1Char('0'));
+
+    str << formatTLValue(val1) << QLatin1Char('|');
+    str << buffer.toHex();
+    str << endl;
+    str.flush();
 }
+#endif
 
-TLValue CTelegramConnection::processAccountUpdateUsername(CTelegramStream &stream, quint64 id)
+void CTelegramConnection::sendSubmittedPackage(quint64 id, quint64 messageId)
 {
-    TLUser result;
-    stream >> result;
+    m_sequenceNumber = m_contentRelatedMessages * 2 + 1;
+    ++m_contentRelatedMessages;
 
-    const QString userName = userNameFromPackage(id);
+    setPackageMessage(id, messageId, m_sequenceNumber);
+    sendEncryptedMessage(messageId, m_sequenceNumber, submittedPackageBody(id, m_sequenceNumber));
 
-    if (result.tlType == TLValue::UserSelf) {
-        if (result.username == userName) {
-            emit userNameStatusUpdated(userName, TelegramNamespace::AccountUserNameStatusAccepted);
-        }
-        emit usersReceived(QVector<TLUser>() << result);
+    if (!isServiceRequest(m_submittedPackages.value(id))) {
+        restartIdleTimer();
     }
 
-    return result.tlType;
+#ifdef NETWORK_LOGGING
+    logEncryptedPackage(messageId, m_sequenceNumber, m_submittedPackages.value(id));
+#endif
 }
 
-bool CTelegramConnection::processErrorSeeOther(const QString errorMessage, quint64 id)
+void CTelegramConnection::sendEncryptedPackageAgain(quint64 messageId)
 {
-    int lastSectionIndex = errorMessage.lastIndexOf(QChar(QLatin1Char('_')));
-    if (lastSectionIndex < 0) {
-        return false;
-    }
+    // The server ignored the message, so the request is sent in a new one (the request id is kept).
+    const quint64 id = requestIdByMessageId(messageId);
 
-    quint16 dc = 0;
+    if (!id) {
+        qDebug() << Q_FUNC_INFO << "Unknown message" << messageId;
+        return;
+    }
 
-    bool ok;
+#ifdef DEVELOPER_BUILD
+    TLValue firstValue = TLValue::firstFromArray(m_submittedPackages.value(id));
+    qDebug() << Q_FUNC_INFO << messageId << id << firstValue.toString();
+#endif
 
-    const QString dcStr = errorMessage.mid(lastSectionIndex + 1);
-    dc = dcStr.toUInt(&ok);
+    --m_contentRelatedMessages;
+    forgetPackageMessage(id);
 
-    if (!ok) {
-        return false;
+    if (isReadyToSendEncryptedPackages()) {
+        sendSubmittedPackage(id, newMessageId());
+    } else {
+        m_pendingPackages.append(id);
     }
+}
 
-    const QByteArray data = m_submittedPackages.take(id);
-
-    if (data.isEmpty()) {
-        qDebug() << Q_FUNC_INFO << "Can not restore message" << id;
-        return false;
+void CTelegramConnection::sendSentPackagesAgain()
+{
+    // The same session is continued on the new socket, so the requests without an answer are sent in the messages
+    // with the same ids and sequence numbers. The server does not process such requests twice.
+    QMap<quint64, SentPackage>::const_iterator it = m_sentPackages.constBegin();
+    for ( ; it != m_sentPackages.constEnd(); ++it) {
+        sendEncryptedMessage(it.key(), it.value().sequenceNumber, submittedPackageBody(it.value().requestId, it.value().sequenceNumber));
     }
+}
 
-    CTelegramStream stream(data);
-    TLValue value;
-    stream >> value;
-
-    if (value == TLValue::AuthSendCode) {
-        emit wantedActiveDcChanged(dc);
+QByteArray CTelegramConnection::submittedPackageBody(quint64 id, quint32 sequenceNumber) const
+{
+    QByteArray header;
+    if (sequenceNumber == 1) {
+        insertInitConnection(&header);
     }
 
-    emit newRedirectedPackage(data, dc);
+    // The dependencies are sent before the request, so they have the actual message ids.
+    header += invokeAfterHeader(m_packageDependencies.value(id));
 
-    return true;
+    return header + compressedPackage(m_submittedPackages.value(id));
 }
 
-TLValue CTelegramConnection::processUpdate(CTelegramStream &stream, bool *ok)
+bool CTelegramConnection::isReadyToSendEncryptedPackages() const
 {
-    TLUpdates updates;
-    stream >> updates;
-
-    if (stream.error()) {
-        qWarning() << Q_FUNC_INFO << "Read of an update caused an error.";
-    }
+    return (m_status >= ConnectionStatusConnected) && (m_authState >= AuthStateHaveAKey);
+}
 
-    switch (updates.tlType) {
-    case TLValue::UpdatesTooLong:
-    case TLValue::UpdateShortMessage:
-    case TLValue::UpdateShortChatMessage:
-    case TLValue::UpdateShort:
-    case TLValue::UpdatesCombined:
-    case TLValue::Updates:
-        emit updatesReceived(updates);
-        *ok = true;
-        break;
-    default:
-        *ok = false;
-        break;
-    }
+quint64 CTelegramConnection::addPendingPackage(const QByteArray &buffer)
+{
+    const quint64 id = newMessageId();
+    m_submittedPackages.insert(id, buffer);
+    m_pendingPackages.append(id);
 
-    return updates.tlType;
+    return id;
 }
 
-void CTelegramConnection::whenTransportStateChanged()
+CTelegramConnection::PackagePriority CTelegramConnection::packagePriority(const QByteArray &buffer)
 {
-#ifdef NETWORK_LOGGING
-    if (!m_logFile) {
-        QDir dir;
-        dir.mkdir(QLatin1String("network"));
-
-        m_logFile = new QFile(QLatin1String("network/") + m_dcInfo.ipAddress + QLatin1String(".log"));
-        m_logFile->open(QIODevice::WriteOnly);
+    switch (TLValue::firstFromArray(buffer)) {
+    case TLValue::AuthCheckPhone:
+    case TLValue::AuthSendCode:
+    case TLValue::AuthSendSms:
+    case TLValue::AuthSignIn:
+    case TLValue::AuthSignUp:
+    case TLValue::AuthExportAuthorization:
+    case TLValue::AuthImportAuthorization:
+    case TLValue::HelpGetConfig:
+    case TLValue::GetFutureSalts:
+    case TLValue::UpdatesGetState:
+    case TLValue::UpdatesGetDifference:
+        return PackagePriorityHigh;
+    case TLValue::UploadGetFile:
+    case TLValue::UploadSaveFilePart:
+    case TLValue::UploadSaveBigFilePart:
+        return PackagePriorityLow;
+    default:
+        return PackagePriorityNormal;
     }
+}
 
-    qDebug() << Q_FUNC_INFO << m_dcInfo.id << m_dcInfo.ipAddress << m_transport->state();
-#endif
-
-    switch (m_transport->state()) {
-    case QAbstractSocket::ConnectedState:
-        if (m_authKey.isEmpty()) {
-            initAuth();
-        } else {
-            setAuthState(AuthStateSignedIn);
-        }
-
-        setStatus(ConnectionStatusConnected);
-        break;
-    case QAbstractSocket::UnconnectedState:
-        setStatus(ConnectionStatusDisconnected);
-        break;
+bool CTelegramConnection::isServiceRequest(const QByteArray &buffer)
+{
+    // The keep-alive and session requests are sent anyway, so they do not keep an idle connection open.
+    switch (TLValue::firstFromArray(buffer)) {
+    case TLValue::Ping:
+    case TLValue::PingDelayDisconnect:
+    case TLValue::GetFutureSalts:
+    case TLValue::RpcDropAnswer:
+        return true;
     default:
-        break;
+        return false;
     }
 }
 
-void CTelegramConnection::whenTransportReadyRead()
+bool CTelegramConnection::readSendMessageRequest(const QByteArray &buffer, TLInputPeer *peer, quint64 *randomId)
 {
-    QByteArray input = m_transport->getPackage();
-    CRawStream inputStream(input);
-
-    quint64 auth = 0;
-    quint64 timeStamp = 0;
-    quint32 length = 0;
-    QByteArray payload;
-
-    inputStream >> auth;
-
-    /* Will be reimplemented later */
-
-    if (!auth) {
-        // Plain Message
-        inputStream >> timeStamp;
-        inputStream >> length;
+    CTelegramStream stream(buffer);
 
-        if (inputStream.bytesRemaining() != int(length)) {
-            qDebug() << Q_FUNC_INFO << "Corrupted packet. Specified length does not equal to real length";
-            return;
-        }
-
-        payload = inputStream.readBytes(length);
-
-        switch (m_authState) {
-        case AuthStatePqRequested:
-            if (answerPqAuthorization(payload)) {
-                requestDhParameters();
-            }
-            break;
-        case AuthStateDhRequested:
-            if (answerDh(payload)) {
-                requestDhGenerationResult();
-            }
-            break;
-        case AuthStateDhGenerationResultRequested:
-            processServersDHAnswer(payload);
-            break;
-        default:
-            break;
-        }
-    } else if (m_authState >= AuthStateHaveAKey) {
-        if (auth != m_authId) {
-            qDebug() << Q_FUNC_INFO << "Incorrect auth id.";
+    TLValue method;
+    quint32 flags;
+    quint32 replyToMsgId;
+    QString message;
 
-#ifdef NETWORK_LOGGING
-            QTextStream str(m_logFile);
+    stream >> method;
+    stream >> flags;
+    stream >> *peer;
 
-            str << QDateTime::currentDateTime().toString(QLatin1String("yyyyMMdd HH:mm:ss:zzz")) << QLatin1Char('|');
-            str << QLatin1String("pln|");
-            str << QString(QLatin1String("size: %1|")).arg(input.length(), 4, 10, QLatin1Char('0'));
-            str << QLatin1Char('|');
-            str << input.toHex();
-            str << endl;
-            str.flush();
-#endif
+    if (flags & 1 << 0) {
+        stream >> replyToMsgId;
+    }
 
-            return;
-        }
-        // Encrypted Message
-        const QByteArray messageKey = inputStream.readBytes(16);
-        const QByteArray data = inputStream.readBytes(inputStream.bytesRemaining());
+    stream >> message;
+    stream >> *randomId;
 
-        const SAesKey key = generateServerToClientAesKey(messageKey);
+    return (method == TLValue::MessagesSendMessage) && !stream.error();
+}
 
-        QByteArray decryptedData = Utils::aesDecrypt(data, key).left(data.length());
-        CRawStream decryptedStream(decryptedData);
+void CTelegramConnection::restartIdleTimer()
+{
+    // Only the requests and their results are counted as the activity; pings, pongs and acks are not.
+    if (m_idleTimeout && (m_status >= ConnectionStatusConnected)) {
+        m_idleTimer->start(m_idleTimeout);
+    }
+}
 
-        quint64 sessionId = 0;
-        quint64 messageId  = 0;
-        quint32 sequence = 0;
-        quint32 contentLength = 0;
+void CTelegramConnection::sendPendingPackages()
+{
+    if (m_pendingPackages.isEmpty() || !isReadyToSendEncryptedPackages()) {
+        return;
+    }
 
-        decryptedStream >> m_receivedServerSalt;
-        decryptedStream >> sessionId;
-        decryptedStream >> messageId;
-        decryptedStream >> sequence;
-        decryptedStream >> contentLength;
+    QList<quint64> queues[PackagePriorityLow + 1];
+    QHash<quint64, int> priorities;
 
-        if (m_serverSalt != m_receivedServerSalt) {
-            qDebug() << Q_FUNC_INFO << "Received different server salt:" << m_receivedServerSalt << "(remote) vs" << m_serverSalt << "(local)";
-//            return;
+    foreach (quint64 id, m_pendingPackages) {
+        if (!m_submittedPackages.contains(id)) {
+            continue;
         }
 
-        if (m_sessionId != sessionId) {
-            qDebug() << Q_FUNC_INFO << "Session Id is wrong.";
-            return;
+        const QList<quint64> dependencies = m_packageDependencies.value(id);
+        quint32 delay = dependenciesDelay(dependencies);
+
+        if (!delay) {
+            delay = acquireFloodWaitToken(m_submittedPackages.value(id));
         }
 
-        if (int(contentLength) > decryptedData.length()) {
-            qDebug() << Q_FUNC_INFO << "Expected data length is more, than actual.";
-            return;
+        if (delay) {
+            addDelayedPackage(id, delay);
+            continue;
         }
 
-        const int headerLength = sizeof(m_receivedServerSalt) + sizeof(sessionId) + sizeof(messageId) + sizeof(sequence) + sizeof(contentLength);
-        QByteArray expectedMessageKey = Utils::sha1(decryptedData.left(headerLength + contentLength)).mid(4);
+        // The queues are sent one after another, so a request never goes ahead of the requests it depends on.
+        int priority = packagePriority(m_submittedPackages.value(id));
 
-        if (messageKey != expectedMessageKey) {
-            qDebug() << Q_FUNC_INFO << "Wrong message key";
-            return;
+        foreach (quint64 dependency, dependencies) {
+            priority = qMax(priority, priorities.value(dependency, PackagePriorityHigh));
         }
 
-        payload = decryptedStream.readRemainingBytes();
-
-        processRpcQuery(payload);
+        priorities.insert(id, priority);
+        queues[priority].append(id);
     }
 
-#ifdef DEVELOPER_BUILD
-    TLValue firstValue;
+    m_pendingPackages.clear();
 
-    if (payload.length() >= 4) {
-        quint32 *v = (quint32 *) payload.constData();
-        firstValue = TLValue(*v);
-    }
+    QList<quint64> batch;
+    int batchSize = 0;
 
-    static int packagesCount = 0;
-    qDebug() << Q_FUNC_INFO << "Got package" << ++packagesCount << firstValue.toString();
-#endif
-}
+    for (int priority = PackagePriorityHigh; priority <= PackagePriorityLow; ++priority) {
+        foreach (quint64 id, queues[priority]) {
+            const int packageSize = m_submittedPackages.value(id).size();
 
-void CTelegramConnection::whenTransportTimeout()
-{
-    setStatus(ConnectionStatusDisconnected, ConnectionStatusReasonTimeout);
+            if (!batch.isEmpty() && ((batch.count() == s_containerMaximumMessages) || (batchSize + packageSize > s_containerMaximumSize))) {
+                sendPackagesInContainer(batch);
+                batch.clear();
+                batchSize = 0;
+            }
+
+            batch.append(id);
+            batchSize += packageSize;
+        }
+    }
+
+    if (!batch.isEmpty()) {
+        sendPackagesInContainer(batch);
+    }
 }
 
-void CTelegramConnection::whenItsTimeToPing()
+void CTelegramConnection::sendPackagesInContainer(const QList<quint64> &ids)
 {
-//    qDebug() << Q_FUNC_INFO << QDateTime::currentMSecsSinceEpoch();
-
-    if (status() < ConnectionStatusConnected) {
-        // Nothing to do.
+    if (ids.count() == 1) {
+        sendSubmittedPackage(ids.first(), newMessageId());
         return;
     }
 
-    if (m_lastSentPingTime && (m_lastSentPingTime > m_lastReceivedPingTime + m_pingInterval)) {
-        qDebug() << Q_FUNC_INFO << "pong time is out";
-        setStatus(ConnectionStatusDisconnected, ConnectionStatusReasonTimeout);
-        return;
+    QByteArray container;
+    CRawStream containerStream(&container, /* write */ true);
+
+    containerStream << TLValue::MsgContainer;
+    containerStream << quint32(ids.count());
+
+    bool hasContent = false;
+
+    foreach (quint64 id, ids) {
+        const quint64 messageId = newMessageId();
+
+        if (!isServiceRequest(m_submittedPackages.value(id))) {
+            hasContent = true;
+        }
+
+        m_sequenceNumber = m_contentRelatedMessages * 2 + 1;
+        ++m_contentRelatedMessages;
+
+        setPackageMessage(id, messageId, m_sequenceNumber);
+
+        // The dependencies are already in the container (or sent before) and have the actual message ids.
+        const QByteArray body = submittedPackageBody(id, m_sequenceNumber);
+
+        containerStream << messageId;
+        containerStream << m_sequenceNumber;
+        containerStream << quint32(body.length());
+        containerStream << body;
     }
 
-    m_lastSentPingTime = QDateTime::currentMSecsSinceEpoch();
+    // The container itself is not a content-related message and must have the greatest id.
+    sendEncryptedMessage(newMessageId(), m_contentRelatedMessages * 2, container);
 
-    pingDelayDisconnect(m_pingInterval + m_serverDisconnectionExtraTime); // Server will close the connection after m_serverDisconnectionExtraTime ms more, than our ping interval.
+    if (hasContent) {
+        restartIdleTimer();
+    }
 }
 
-void CTelegramConnection::whenItsTimeToAckMessages()
+void CTelegramConnection::setPackageMessage(quint64 id, quint64 messageId, quint32 sequenceNumber)
 {
-    if (m_messagesToAck.isEmpty()) {
-        return;
-    }
+    forgetPackageMessage(id);
 
-    acknowledgeMessages(m_messagesToAck);
-    m_messagesToAck.clear();
+    m_sentPackages.insert(messageId, SentPackage(id, sequenceNumber));
+    m_packageMessageIds.insert(id, messageId);
 }
 
-SAesKey CTelegramConnection::generateTmpAesKey() const
+bool CTelegramConnection::forgetPackageMessage(quint64 id)
 {
-    QByteArray newNonceAndServerNonce;
-    newNonceAndServerNonce.append(m_newNonce.data, m_newNonce.size());
-    newNonceAndServerNonce.append(m_serverNonce.data, m_serverNonce.size());
-    QByteArray serverNonceAndNewNonce;
-    serverNonceAndNewNonce.append(m_serverNonce.data, m_serverNonce.size());
-    serverNonceAndNewNonce.append(m_newNonce.data, m_newNonce.size());
-    QByteArray newNonceAndNewNonce;
-    newNonceAndNewNonce.append(m_newNonce.data, m_newNonce.size());
-    newNonceAndNewNonce.append(m_newNonce.data, m_newNonce.size());
+    // Returns true if the request was sent (and not answered yet).
+    if (!m_packageMessageIds.contains(id)) {
+        return false;
+    }
 
-    const QByteArray key = Utils::sha1(newNonceAndServerNonce) + Utils::sha1(serverNonceAndNewNonce).mid(0, 12);
-    const QByteArray iv  = Utils::sha1(serverNonceAndNewNonce).mid(12, 8) + Utils::sha1(newNonceAndNewNonce) + QByteArray(m_newNonce.data, 4);
+    m_sentPackages.remove(m_packageMessageIds.take(id));
 
-    return SAesKey(key, iv);
+    return true;
 }
 
-SAesKey CTelegramConnection::generateAesKey(const QByteArray &messageKey, int x) const
+bool CTelegramConnection::isDelayedPackage(quint64 id) const
 {
-    QByteArray sha1_a = Utils::sha1(messageKey + m_authKey.mid(x, 32));
-    QByteArray sha1_b = Utils::sha1(m_authKey.mid(32 + x, 16) + messageKey + m_authKey.mid(48 + x, 16));
-    QByteArray sha1_c = Utils::sha1(m_authKey.mid(64 + x, 32) + messageKey);
-    QByteArray sha1_d = Utils::sha1(messageKey + m_authKey.mid(96 + x, 32));
-
-    const QByteArray key = sha1_a.mid(0, 8) + sha1_b.mid(8, 12) + sha1_c.mid(4, 12);
-    const QByteArray iv  = sha1_a.mid(8, 12) + sha1_b.mid(0, 8) + sha1_c.mid(16, 4) + sha1_d.mid(0, 8);
+    QMultiMap<qint64, quint64>::const_iterator it = m_delayedPackages.constBegin();
+    for ( ; it != m_delayedPackages.constEnd(); ++it) {
+        if (it.value() == id) {
+            return true;
+        }
+    }
 
-    return SAesKey(key, iv);
+    return false;
 }
 
-void CTelegramConnection::insertInitConnection(QByteArray *data) const
+bool CTelegramConnection::removeSubmittedPackage(quint64 id)
 {
-    CTelegramStream outputStream(data, /* write */ true);
+    // Returns true if the package was sent already.
+    m_submittedPackages.remove(id);
+    m_packageDependencies.remove(id);
+    m_pendingPackages.removeOne(id);
 
-    outputStream << TLValue::InvokeWithLayer;
-    outputStream << quint32(29);
-    outputStream << TLValue::InitConnection;
+    QMultiMap<qint64, quint64>::iterator it = m_delayedPackages.begin();
+    for ( ; it != m_delayedPackages.end(); ++it) {
+        if (it.value() == id) {
+            m_delayedPackages.erase(it);
+            break;
+        }
+    }
 
-    outputStream << m_appInfo->appId();
-    outputStream << m_appInfo->deviceInfo();
-    outputStream << m_appInfo->osInfo();
-    outputStream << m_appInfo->appVersion();
-    outputStream << m_appInfo->languageCode();
+    return forgetPackageMessage(id);
 }
 
-quint64 CTelegramConnection::sendPlainPackage(const QByteArray &buffer)
+QByteArray CTelegramConnection::invokeAfterHeader(const QList<quint64> &dependencies) const
 {
-    quint64 messageId = newMessageId();
+    TLVector<quint64> ids;
 
-    QByteArray output;
-    CRawStream outputStream(&output, /* write */ true);
+    foreach (quint64 id, dependencies) {
+        // The server knows the sent (and not answered) requests by the message ids.
+        const quint64 messageId = m_packageMessageIds.value(id);
 
-    outputStream << quint64(0);
-    outputStream << messageId;
-    outputStream << quint32(buffer.length());
-    outputStream << buffer;
+        if (messageId) {
+            ids.append(messageId);
+        }
+    }
 
-    m_transport->sendPackage(output);
+    QByteArray output;
 
-#ifdef NETWORK_LOGGING
-    CTelegramStream readBack(buffer);
-    TLValue val1;
-    readBack >> val1;
+    if (ids.isEmpty()) {
+        return output;
+    }
 
-    QTextStream str(m_logFile);
+    CTelegramStream outputStream(&output, /* write */ true);
 
-    str << QDateTime::currentDateTime().toString(QLatin1String("yyyyMMdd HH:mm:ss:zzz")) << QLatin1Char('|');
-    str << QLatin1String("pln|");
-    str << QString(QLatin1String("size: %1|")).arg(buffer.length(), 4, 10, QLatin1Char('0'));
-    str << formatTLValue(val1) << QLatin1Char('|');
-    str << buffer.toHex();
-    str << endl;
-    str.flush();
-#endif
+    if (ids.count() == 1) {
+        outputStream << TLValue::InvokeAfterMsg;
+        outputStream << ids.first();
+    } else {
+        outputStream << TLValue::InvokeAfterMsgs;
+        outputStream << ids;
+    }
 
-    return messageId;
+    return output;
 }
 
-quint64 CTelegramConnection::sendEncryptedPackage(const QByteArray &buffer, bool savePackage)
+QByteArray CTelegramConnection::compressedPackage(const QByteArray &buffer) const
 {
-    QByteArray encryptedPackage;
-    QByteArray messageKey;
-    quint64 messageId;
-    {
-        messageId = newMessageId();
-
-        m_sequenceNumber = m_contentRelatedMessages * 2 + 1;
-        ++m_contentRelatedMessages;
+    if (!m_compressionThreshold || (quint32(buffer.size()) < m_compressionThreshold)) {
+        return buffer;
+    }
 
-        if (savePackage) {
-            // Story only content-related messages
-            m_submittedPackages.insert(messageId, buffer);
-        }
+    switch (TLValue::firstFromArray(buffer)) {
+    case TLValue::UploadSaveFilePart:
+    case TLValue::UploadSaveBigFilePart:
+    case TLValue::MessagesSendEncrypted:
+    case TLValue::MessagesSendEncryptedFile:
+    case TLValue::MessagesSendEncryptedService:
+        // Files are usually compressed already and the encrypted data is not compressible at all.
+        return buffer;
+    default:
+        break;
+    }
 
-        QByteArray innerData;
-        CRawStream stream(&innerData, /* write */ true);
+    const QByteArray packedData = Utils::packGZip(buffer);
 
-        stream << m_serverSalt;
-        stream << m_sessionId;
-        stream << messageId;
-        stream << m_sequenceNumber;
+    if (packedData.isEmpty()) {
+        return buffer;
+    }
 
-        QByteArray header;
-        if (m_sequenceNumber == 1) {
-            insertInitConnection(&header);
-        }
+    QByteArray output;
+    CTelegramStream outputStream(&output, /* write */ true);
 
-        stream << quint32(header.length() + buffer.length());
-        stream << header + buffer;
+    outputStream << TLValue::GzipPacked;
+    outputStream << packedData;
 
-        messageKey = Utils::sha1(innerData).mid(4);
-        const SAesKey key = generateClientToServerAesKey(messageKey);
+    if (output.size() >= buffer.size()) {
+        return buffer;
+    }
 
-        quint32 packageLength = innerData.length();
+    return output;
+}
 
-        if ((packageLength) % 16) {
-            QByteArray randomPadding;
-            randomPadding.resize(16 - (packageLength % 16));
-            Utils::randomBytes(&randomPadding);
+quint32 CTelegramConnection::dependenciesDelay(const QList<quint64> &dependencies) const
+{
+    // A request waits for the delayed requests it depends on.
+    if (dependencies.isEmpty()) {
+        return 0;
+    }
 
-            packageLength += randomPadding.size();
+    qint64 sendTime = 0;
 
-            stream << randomPadding;
+    QMultiMap<qint64, quint64>::const_iterator it = m_delayedPackages.constBegin();
+    for ( ; it != m_delayedPackages.constEnd(); ++it) {
+        if (dependencies.contains(it.value())) {
+            sendTime = qMax(sendTime, it.key());
         }
+    }
 
-        encryptedPackage = Utils::aesEncrypt(innerData, key).left(packageLength);
+    if (!sendTime) {
+        return 0;
     }
 
-    QByteArray output;
-    CRawStream outputStream(&output, /* write */ true);
+    return qMax<qint64>(sendTime - QDateTime::currentMSecsSinceEpoch(), 0) + 1;
+}
 
-    outputStream << m_authId;
-    outputStream << messageKey;
-    outputStream << encryptedPackage;
+void CTelegramConnection::invokeNextRequestAfter(const QList<quint64> &requestIds)
+{
+    m_nextRequestDependencies = requestIds;
+}
 
-    m_transport->sendPackage(output);
+void CTelegramConnection::getFloodWaitKeys(const QByteArray &buffer, quint64 *methodKey, quint64 *peerKey)
+{
+    CTelegramStream stream(buffer);
+    TLValue method;
+    stream >> method;
+
+    *methodKey = CFloodWaitLimiter::methodKey(method);
+    *peerKey = 0;
+
+    // The methods, which are limited per peer, have the peer as the first argument (possibly after the flags).
+    for (int offset = sizeof(quint32); offset <= int(sizeof(quint32) * 2); offset += sizeof(quint32)) {
+        switch (TLValue::firstFromArray(buffer.mid(offset))) {
+        case TLValue::InputPeerContact:
+        case TLValue::InputPeerForeign:
+        case TLValue::InputPeerChat: {
+            TLInputPeer peer;
+
+            if (offset > int(sizeof(quint32))) {
+                quint32 flags;
+                stream >> flags;
+            }
 
-#ifdef NETWORK_LOGGING
-    CTelegramStream readBack(buffer);
-    TLValue val1;
-    readBack >> val1;
+            stream >> peer;
 
-    QTextStream str(m_logFile);
+            if (!stream.error()) {
+                *peerKey = CFloodWaitLimiter::peerKey(method, peer.tlType, peer.tlType == TLValue::InputPeerChat ? peer.chatId : peer.userId);
+            }
+        }
+            return;
+        case TLValue::InputPeerEmpty:
+        case TLValue::InputPeerSelf:
+            return;
+        default:
+            break;
+        }
+    }
+}
 
-    str << QString(QLatin1String("%1|enc|mId%2|seq%3|"))
-           .arg(QDateTime::currentDateTime().toString(QLatin1String("yyyyMMdd HH:mm:ss:zzz")))
-           .arg(messageId, 10, 10, QLatin1Char('0'))
-           .arg(m_sequenceNumber, 4, 10, QLatin1Char('0'));
+quint32 CTelegramConnection::acquireFloodWaitToken(const QByteArray &buffer)
+{
+    quint64 methodKey;
+    quint64 peerKey;
+    getFloodWaitKeys(buffer, &methodKey, &peerKey);
 
-    str << QString(QLatin1String("size: %1|")).arg(buffer.length(), 4, 10, QLatin1Char('0'));
+    return m_floodWaitLimiter.acquire(methodKey, peerKey, QDateTime::currentMSecsSinceEpoch());
+}
 
-    str << formatTLValue(val1) << QLatin1Char('|');
-    str << buffer.toHex();
-    str << endl;
-    str.flush();
-#endif
+void CTelegramConnection::addDelayedPackage(quint64 id, quint32 delay)
+{
+    const qint64 sendTime = QDateTime::currentMSecsSinceEpoch() + delay;
 
-    return messageId;
+    m_delayedPackages.insert(sendTime, id);
+
+    if (!m_delayedPackagesTimer->isActive() || (sendTime == m_delayedPackages.constBegin().key())) {
+        m_delayedPackagesTimer->start(delay);
+    }
 }
 
-quint64 CTelegramConnection::sendEncryptedPackageAgain(quint64 id)
+quint32 CTelegramConnection::floodWaitTime() const
 {
-    --m_contentRelatedMessages;
-    const QByteArray data = m_submittedPackages.take(id);
-#ifdef DEVELOPER_BUILD
-    TLValue firstValue = TLValue::firstFromArray(data);
-    qDebug() << Q_FUNC_INFO << id << firstValue.toString();
-#endif
-    return sendEncryptedPackage(data);
+    return m_floodWaitLimiter.floodWaitTime(QDateTime::currentMSecsSinceEpoch());
+}
+
+void CTelegramConnection::whenItsTimeToSendDelayedPackages()
+{
+    const qint64 currentTime = QDateTime::currentMSecsSinceEpoch();
+
+    while (!m_delayedPackages.isEmpty() && (m_delayedPackages.constBegin().key() <= currentTime)) {
+        const quint64 id = m_delayedPackages.take(m_delayedPackages.constBegin().key());
+
+        // The package is sent along with the queued ones and passes the limiter once again.
+        if (m_submittedPackages.contains(id)) {
+            m_pendingPackages.append(id);
+        }
+    }
+
+    sendPendingPackages();
+
+    if (!m_delayedPackages.isEmpty() && !m_delayedPackagesTimer->isActive()) {
+        m_delayedPackagesTimer->start(qMax<qint64>(m_delayedPackages.constBegin().key() - currentTime, 0));
+    }
 }
 
 void CTelegramConnection::setStatus(ConnectionStatus status, ConnectionStatusReason reason)
@@ -3184,11 +5696,25 @@ void CTelegramConnection::setStatus(ConnectionStatus status, ConnectionStatusRea
     }
 
     m_status = status;
+
+    if (status == ConnectionStatusDisconnected) {
+        // Give a chance to the queued connections; the failed attempt is not an attempt anymore.
+        CConnectionScheduler::instance()->release(this);
+    }
+
     emit statusChanged(status, reason, m_dcInfo.id);
 
     if ((status < ConnectionStatusConnected) && m_pingTimer && m_pingTimer->isActive()) {
         m_pingTimer->stop();
     }
+
+    if (status < ConnectionStatusConnected) {
+        m_serverSaltTimer->stop();
+        m_futureSaltsRequestId = 0;
+        m_idleTimer->stop();
+    } else if (m_idleTimeout && !m_idleTimer->isActive()) {
+        m_idleTimer->start(m_idleTimeout);
+    }
 }
 
 void CTelegramConnection::setAuthState(CTelegramConnection::AuthState newState)
@@ -3200,6 +5726,14 @@ void CTelegramConnection::setAuthState(CTelegramConnection::AuthState newState)
 
     if ((m_authState >= AuthStateHaveAKey) && !m_sessionId) {
         Utils::randomBytes(&m_sessionId);
+        m_receivedMessages.reset();
+    }
+
+    if (m_authState >= AuthStateHaveAKey) {
+        // The handshake is done
+        CConnectionScheduler::instance()->release(this);
+        m_reconnectionDelay = 0;
+        sendPendingPackages();
     }
 
     emit authStateChanged(m_authState, m_dcInfo.id);
@@ -3208,12 +5742,14 @@ void CTelegramConnection::setAuthState(CTelegramConnection::AuthState newState)
         if (m_pingInterval) {
             startPingTimer();
         }
+
+        whenItsTimeToUpdateServerSalt();
     }
 }
 
 quint64 CTelegramConnection::newMessageId()
 {
-    quint64 newLastMessageId = formatClientTimeStamp(QDateTime::currentMSecsSinceEpoch() + deltaTime() * 1000);
+    quint64 newLastMessageId = formatClientTimeStamp(QDateTime::currentMSecsSinceEpoch() + clockOffset());
 
     if (newLastMessageId <= m_lastMessageId) {
         newLastMessageId = m_lastMessageId + 4; // Client's outgoing message id should be divisible by 4 and be greater than previous message id.
@@ -3229,6 +5765,49 @@ quint64 CTelegramConnection::newMessageId()
     return m_lastMessageId;
 }
 
+quint32 CTelegramConnection::serverTime() const
+{
+    return (QDateTime::currentMSecsSinceEpoch() + clockOffset()) / 1000;
+}
+
+void CTelegramConnection::updateClockOffset(quint64 serverMessageId)
+{
+    if (!serverMessageId) {
+        return;
+    }
+
+    // The server stamps the message id at the sending time, so the message is late for about a half of the round trip.
+    const qint64 serverTime = timeStampToMSecsSinceEpoch(serverMessageId) + m_roundTripTime / 2;
+    m_lastClockOffsetSample = serverTime - QDateTime::currentMSecsSinceEpoch();
+
+    if (!m_clockOffsetSamplesCount) {
+        // The first sample replaces the restored (or the default) value.
+        // The last message id is kept as is, because it can belong to a resumed session.
+        m_clockOffset = m_lastClockOffsetSample;
+    } else {
+        // Queued and delayed messages give lesser samples, so the offset goes down slowly and goes up fast.
+        const qint64 difference = m_lastClockOffsetSample - m_clockOffset;
+        m_clockOffset += difference / (difference > 0 ? s_clockOffsetRaiseFactor : s_clockOffsetDropFactor);
+    }
+
+    ++m_clockOffsetSamplesCount;
+}
+
+void CTelegramConnection::updateRoundTripTime(qint64 requestTime)
+{
+    const qint64 sample = QDateTime::currentMSecsSinceEpoch() - requestTime;
+
+    if (sample < 0) {
+        return;
+    }
+
+    if (!m_roundTripTime) {
+        m_roundTripTime = sample;
+    } else {
+        m_roundTripTime = (m_roundTripTime * (s_roundTripTimeFactor - 1) + sample) / s_roundTripTimeFactor;
+    }
+}
+
 QString CTelegramConnection::userNameFromPackage(quint64 id) const
 {
     const QByteArray data = m_submittedPackages.value(id);
@@ -3261,7 +5840,6 @@ void CTelegramConnection::startPingTimer()
 {
     if (!m_pingTimer) {
         m_pingTimer = new QTimer(this);
-        m_pingTimer->setInterval(m_pingInterval);
         m_pingTimer->setSingleShot(false);
         connect(m_pingTimer, SIGNAL(timeout()), SLOT(whenItsTimeToPing()));
     }
@@ -3270,15 +5848,33 @@ void CTelegramConnection::startPingTimer()
         return;
     }
 
+    m_pingTimer->setInterval(m_keepAliveInterval);
+
     m_lastReceivedPingId = 0;
     m_lastSentPingId = 0;
     m_lastReceivedPingTime = 0;
     m_lastSentPingTime = 0;
+    m_keepAliveProbe = false;
 
     m_pingTimer->start();
 }
 
-void CTelegramConnection::addMessageToAck(quint64 id)
+bool CTelegramConnection::acceptReceivedMessage(quint64 id, quint32 sequenceNumber)
+{
+    if (CMessageIdWindow::isContentRelated(sequenceNumber)) {
+        // Acknowledge a duplicate too: the server resends a message if the previous ack is lost.
+        addMessageToAck(id, sequenceNumber);
+    }
+
+    if (!m_receivedMessages.accept(id, sequenceNumber)) {
+        qDebug() << Q_FUNC_INFO << "Drop already received message" << id;
+        return false;
+    }
+
+    return true;
+}
+
+void CTelegramConnection::addMessageToAck(quint64 id, quint32 sequenceNumber)
 {
 //    qDebug() << Q_FUNC_INFO << id;
     if (!m_ackTimer->isActive()) {
@@ -3286,6 +5882,7 @@ void CTelegramConnection::addMessageToAck(quint64 id)
     }
 
     m_messagesToAck.append(id);
+    m_messagesToAckSequenceNumbers.append(sequenceNumber);
 
     if (m_messagesToAck.count() > 6) {
         whenItsTimeToAckMessages();
@@ -22,11 +22,15 @@
 #include <QByteArray>
 #include <QVector>
 #include <QMap>
+#include <QHash>
 #include <QStringList>
 
 #include "TelegramNamespace.hpp"
 #include "TLTypes.hpp"
+#include "TLViews.hpp"
 #include "TLNumbers.hpp"
+#include "CFloodWaitLimiter.hpp"
+#include "CMessageIdWindow.hpp"
 #include "crypto-rsa.hpp"
 #include "crypto-aes.hpp"
 
@@ -57,6 +61,12 @@ public:
         ConnectionStatusReasonTimeout
     };
 
+    enum PackagePriority {
+        PackagePriorityHigh,
+        PackagePriorityNormal,
+        PackagePriorityLow
+    };
+
     enum AuthState {
         AuthStateNone,
         AuthStatePqRequested,
@@ -66,13 +76,8 @@ public:
         AuthStateSignedIn
     };
 
-    enum DeltaTimeHeuristicState {
-        DeltaTimeIsOk,
-        DeltaTimeCorrectionForward,
-        DeltaTimeCorrectionBackward,
-    };
-
     explicit CTelegramConnection(const CAppInformation *appInfo, QObject *parent = 0);
+    ~CTelegramConnection();
 
     void setDcInfo(const TLDcOption &newDcInfo);
 
@@ -81,7 +86,11 @@ public:
 public slots:
     void connectToDc();
 
+    // Connects after the backoff delay, which grows with every attempt until the handshake succeed.
+    void scheduleReconnection();
+
 public:
+    inline quint32 reconnectionDelay() const { return m_reconnectionDelay; }
     inline ConnectionStatus status() const { return m_status; }
 
     static quint64 formatTimeStamp(qint64 timeInMs);
@@ -92,7 +101,18 @@ public:
     void initAuth();
     void getConfiguration();
 
+    // The interval is the minimal one: it is probed upward while the idle connection survives and
+    // goes back on a drop (supposedly caused by a NAT timeout). Pings are skipped while other traffic flows.
     void setKeepAliveSettings(quint32 interval, quint32 serverDisconnectionExtraTime);
+    inline quint32 keepAliveInterval() const { return m_keepAliveInterval; }
+
+    // Close the connection after the given time (in ms) without any traffic. Zero disables the timeout.
+    void setIdleTimeout(quint32 timeout);
+    inline quint32 idleTimeout() const { return m_idleTimeout; }
+
+    // Requests of the given size (in bytes) and bigger are sent in gzip_packed, if it saves bytes. Zero disables the compression.
+    inline void setCompressionThreshold(quint32 size) { m_compressionThreshold = size; }
+    inline quint32 compressionThreshold() const { return m_compressionThreshold; }
 
     // Generated Telegram API methods declaration
     quint64 accountChangePhone(const QString &phoneNumber, const QString &phoneCodeHash, const QString &phoneCode);
@@ -200,6 +220,8 @@ public:
     quint64 pingDelayDisconnect(quint32 disconnectInSec);
 
     quint64 acknowledgeMessages(const TLVector<quint64> &idsVector);
+    quint64 getFutureSalts(quint32 count);
+    quint64 rpcDropAnswer(quint64 requestMessageId);
 
     quint64 requestPhoneCode(const QString &phoneNumber);
     quint64 signIn(const QString &phoneNumber, const QString &authCode);
@@ -208,10 +230,13 @@ public:
     void downloadFile(const TLInputFileLocation &inputLocation, quint32 offset, quint32 limit, quint32 requestId);
     void uploadFile(quint64 fileId, quint32 filePart, const QByteArray &bytes, quint32 requestId);
 
-    quint64 sendMessage(const TLInputPeer &peer, const QString &message);
+    // Forgets the file parts requests of the transfer; the server is asked to drop the answers of the sent downloads.
+    void cancelFileRequest(quint32 requestId);
+
+    quint64 sendMessage(const TLInputPeer &peer, const QString &message, quint64 randomMessageId = 0);
     quint64 sendMedia(const TLInputPeer &peer, const TLInputMedia &media);
 
-    AuthState authState() { return m_authState; }
+    AuthState authState() const { return m_authState; }
 
     void requestPqAuthorization();
     bool answerPqAuthorization(const QByteArray &payload);
@@ -235,12 +260,33 @@ public:
 
     inline quint64 serverSalt() const { return m_serverSalt; }
     void setServerSalt(const quint64 salt) { m_serverSalt = salt; }
+    inline TLVector<TLFutureSalt> serverSalts() const { return m_serverSalts; }
+    void setServerSalts(const TLVector<TLFutureSalt> &salts);
     inline quint64 sessionId() const { return m_sessionId; }
 
+    // Session id, message counters, not acknowledged messages and not answered requests.
+    QByteArray sessionState() const;
+    bool restoreSessionState(const QByteArray &state);
+
     inline QVector<TLDcOption> dcConfiguration() const { return m_dcConfiguration; }
 
-    inline qint32 deltaTime() const { return m_deltaTime; }
-    void setDeltaTime(const qint32 newDt);
+    inline qint32 deltaTime() const { return m_clockOffset / 1000; }
+    void setDeltaTime(const qint32 newDt) { setClockOffset(qint64(newDt) * 1000); }
+
+    // Server clock minus local clock in ms, estimated from the received message ids.
+    inline qint64 clockOffset() const { return m_clockOffset; }
+    void setClockOffset(qint64 offset);
+
+    // Smoothed round trip time in ms, zero if it is not measured yet.
+    inline quint32 roundTripTime() const { return m_roundTripTime; }
+
+    // The next request is processed by the server only after the given ones (invokeAfterMsg/invokeAfterMsgs wrapper),
+    // so dependent requests can be sent back to back without waiting for the answers.
+    void invokeNextRequestAfter(const QList<quint64> &requestIds);
+
+    // The greatest remaining FLOOD_WAIT time in ms and the number of requests, delayed by the flood limiter.
+    quint32 floodWaitTime() const;
+    inline int delayedPackagesCount() const { return m_delayedPackages.count(); }
 
     void processRedirectedPackage(const QByteArray &data);
 
@@ -265,19 +311,113 @@ signals:
     void fileDataSent(quint32 requestId);
 
     void messagesChatsReceived(const QVector<TLChat> &chats);
-    void messagesFullChatReceived(const TLChatFull &chat, const QVector<TLChat> &chats, const QVector<TLUser> &users);
+    void messagesFullChatReceived(const TLShared<TLChatFull> &chat, const QVector<TLChat> &chats, const QVector<TLUser> &users);
 
     void fullUserReceived(const TLUserFull &userFull);
-    void messagesHistoryReceived(const TLMessagesMessages &history, const TLInputPeer &peer);
+    void messagesHistoryReceived(const TLShared<TLMessagesMessages> &history, const TLInputPeer &peer);
 
-    void updatesReceived(const TLUpdates &update);
+    void updatesReceived(const TLShared<TLUpdates> &updates);
     void updatesStateReceived(const TLUpdatesState &updatesState);
-    void updatesDifferenceReceived(const TLUpdatesDifference &updatesDifference);
+    void updatesDifferenceReceived(const TLUpdatesDifferenceView &updatesDifference);
 
-    void messageSentInfoReceived(const TLInputPeer &peer, quint64 randomId, TLMessagesSentMessage info);
+    void messageSentInfoReceived(const TLInputPeer &peer, quint64 randomId, const TLShared<TLMessagesSentMessage> &info);
+    void messageSendingFailed(const TLInputPeer &peer, quint64 randomId);
     void authExportedAuthorizationReceived(quint32 dc, quint32 id, const QByteArray &data);
 
+    // The server asked to wait before the next request of the method. The request is delayed and sent
+    // again automatically, unless it would wait for too long: then it is dropped (and a dropped message
+    // is reported with messageSendingFailed() as well).
+    void floodWaitReceived(quint64 requestId, quint32 method, quint32 seconds, bool dropped);
+
+    // Generated RPC result signals
+    void accountChangePhoneResultReceived(quint64 requestId, const TLShared<TLUser> &result);
+    void accountDeleteAccountResultReceived(quint64 requestId, bool result);
+    void accountGetAccountTTLResultReceived(quint64 requestId, const TLShared<TLAccountDaysTTL> &result);
+    void accountGetAuthorizationsResultReceived(quint64 requestId, const TLShared<TLAccountAuthorizations> &result);
+    void accountGetNotifySettingsResultReceived(quint64 requestId, const TLShared<TLPeerNotifySettings> &result);
+    void accountGetPasswordResultReceived(quint64 requestId, const TLShared<TLAccountPassword> &result);
+    void accountGetPasswordSettingsResultReceived(quint64 requestId, const TLShared<TLAccountPasswordSettings> &result);
+    void accountGetPrivacyResultReceived(quint64 requestId, const TLShared<TLAccountPrivacyRules> &result);
+    void accountGetWallPapersResultReceived(quint64 requestId, const TLVector<TLWallPaper> &result);
+    void accountRegisterDeviceResultReceived(quint64 requestId, bool result);
+    void accountResetAuthorizationResultReceived(quint64 requestId, bool result);
+    void accountResetNotifySettingsResultReceived(quint64 requestId, bool result);
+    void accountSendChangePhoneCodeResultReceived(quint64 requestId, const TLShared<TLAccountSentChangePhoneCode> &result);
+    void accountSetAccountTTLResultReceived(quint64 requestId, bool result);
+    void accountSetPrivacyResultReceived(quint64 requestId, const TLShared<TLAccountPrivacyRules> &result);
+    void accountUnregisterDeviceResultReceived(quint64 requestId, bool result);
+    void accountUpdateDeviceLockedResultReceived(quint64 requestId, bool result);
+    void accountUpdateNotifySettingsResultReceived(quint64 requestId, bool result);
+    void accountUpdatePasswordSettingsResultReceived(quint64 requestId, bool result);
+    void accountUpdateProfileResultReceived(quint64 requestId, const TLShared<TLUser> &result);
+    void authBindTempAuthKeyResultReceived(quint64 requestId, bool result);
+    void authCheckPasswordResultReceived(quint64 requestId, const TLShared<TLAuthAuthorization> &result);
+    void authRecoverPasswordResultReceived(quint64 requestId, const TLShared<TLAuthAuthorization> &result);
+    void authRequestPasswordRecoveryResultReceived(quint64 requestId, const TLShared<TLAuthPasswordRecovery> &result);
+    void authResetAuthorizationsResultReceived(quint64 requestId, bool result);
+    void authSendCallResultReceived(quint64 requestId, bool result);
+    void authSendInvitesResultReceived(quint64 requestId, bool result);
+    void contactsBlockResultReceived(quint64 requestId, bool result);
+    void contactsDeleteContactResultReceived(quint64 requestId, const TLShared<TLContactsLink> &result);
+    void contactsExportCardResultReceived(quint64 requestId, const TLVector<quint32> &result);
+    void contactsGetBlockedResultReceived(quint64 requestId, const TLShared<TLContactsBlocked> &result);
+    void contactsGetStatusesResultReceived(quint64 requestId, const TLVector<TLContactStatus> &result);
+    void contactsGetSuggestedResultReceived(quint64 requestId, const TLShared<TLContactsSuggested> &result);
+    void contactsImportCardResultReceived(quint64 requestId, const TLShared<TLUser> &result);
+    void contactsResolveUsernameResultReceived(quint64 requestId, const TLShared<TLUser> &result);
+    void contactsSearchResultReceived(quint64 requestId, const TLShared<TLContactsFound> &result);
+    void contactsUnblockResultReceived(quint64 requestId, bool result);
+    void messagesAcceptEncryptionResultReceived(quint64 requestId, const TLShared<TLEncryptedChat> &result);
+    void messagesAddChatUserResultReceived(quint64 requestId, const TLShared<TLUpdates> &result);
+    void messagesCheckChatInviteResultReceived(quint64 requestId, const TLShared<TLChatInvite> &result);
+    void messagesCreateChatResultReceived(quint64 requestId, const TLShared<TLUpdates> &result);
+    void messagesDeleteChatUserResultReceived(quint64 requestId, const TLShared<TLUpdates> &result);
+    void messagesDeleteHistoryResultReceived(quint64 requestId, const TLShared<TLMessagesAffectedHistory> &result);
+    void messagesDeleteMessagesResultReceived(quint64 requestId, const TLShared<TLMessagesAffectedMessages> &result);
+    void messagesDiscardEncryptionResultReceived(quint64 requestId, bool result);
+    void messagesEditChatPhotoResultReceived(quint64 requestId, const TLShared<TLUpdates> &result);
+    void messagesEditChatTitleResultReceived(quint64 requestId, const TLShared<TLUpdates> &result);
+    void messagesExportChatInviteResultReceived(quint64 requestId, const TLShared<TLExportedChatInvite> &result);
+    void messagesForwardMessageResultReceived(quint64 requestId, const TLShared<TLUpdates> &result);
+    void messagesForwardMessagesResultReceived(quint64 requestId, const TLShared<TLUpdates> &result);
+    void messagesGetAllStickersResultReceived(quint64 requestId, const TLShared<TLMessagesAllStickers> &result);
+    void messagesGetDhConfigResultReceived(quint64 requestId, const TLShared<TLMessagesDhConfig> &result);
+    void messagesGetDialogsResultReceived(quint64 requestId, const TLShared<TLMessagesDialogs> &result);
+    void messagesGetMessagesResultReceived(quint64 requestId, const TLShared<TLMessagesMessages> &result);
+    void messagesGetStickerSetResultReceived(quint64 requestId, const TLShared<TLMessagesStickerSet> &result);
+    void messagesGetStickersResultReceived(quint64 requestId, const TLShared<TLMessagesStickers> &result);
+    void messagesGetWebPagePreviewResultReceived(quint64 requestId, const TLShared<TLMessageMedia> &result);
+    void messagesImportChatInviteResultReceived(quint64 requestId, const TLShared<TLUpdates> &result);
+    void messagesInstallStickerSetResultReceived(quint64 requestId, bool result);
+    void messagesReadEncryptedHistoryResultReceived(quint64 requestId, bool result);
+    void messagesReadMessageContentsResultReceived(quint64 requestId, const TLShared<TLMessagesAffectedMessages> &result);
+    void messagesReceivedQueueResultReceived(quint64 requestId, const TLVector<quint64> &result);
+    void messagesRequestEncryptionResultReceived(quint64 requestId, const TLShared<TLEncryptedChat> &result);
+    void messagesSearchResultReceived(quint64 requestId, const TLShared<TLMessagesMessages> &result);
+    void messagesSendBroadcastResultReceived(quint64 requestId, const TLShared<TLUpdates> &result);
+    void messagesSendEncryptedResultReceived(quint64 requestId, const TLShared<TLMessagesSentEncryptedMessage> &result);
+    void messagesSendEncryptedFileResultReceived(quint64 requestId, const TLShared<TLMessagesSentEncryptedMessage> &result);
+    void messagesSendEncryptedServiceResultReceived(quint64 requestId, const TLShared<TLMessagesSentEncryptedMessage> &result);
+    void messagesSendMediaResultReceived(quint64 requestId, const TLShared<TLUpdates> &result);
+    void messagesSetEncryptedTypingResultReceived(quint64 requestId, bool result);
+    void messagesUninstallStickerSetResultReceived(quint64 requestId, bool result);
+    // End of generated RPC result signals
+
 protected:
+    struct RpcResultReader {
+        quint32 method;
+        TLValue (CTelegramConnection::*reader)(CTelegramStream &stream, quint64 id);
+    };
+
+    struct SentPackage {
+        SentPackage(quint64 request = 0, quint32 seqNo = 0) : requestId(request), sequenceNumber(seqNo) { }
+        quint64 requestId;
+        quint32 sequenceNumber;
+    };
+
+    static const RpcResultReader *rpcResultReader(TLValue method);
+    static inline bool isRpcResultPayload(TLValue value) { return (value != TLValue::RpcError) && (value != TLValue::GzipPacked); }
+
     TLValue processRpcQuery(const QByteArray &data);
 
     void processSessionCreated(CTelegramStream &stream);
@@ -286,10 +426,12 @@ protected:
     void processGzipPackedRpcQuery(CTelegramStream &stream);
     void processGzipPackedRpcResult(CTelegramStream &stream, quint64 id);
     bool processRpcError(CTelegramStream &stream, quint64 id, TLValue request);
+    TLValue processRpcDropAnswer(CTelegramStream &stream, quint64 id);
 
     void processMessageAck(CTelegramStream &stream);
     void processIgnoredMessageNotification(CTelegramStream &stream);
     void processPingPong(CTelegramStream &stream);
+    void processFutureSalts(CTelegramStream &stream);
 
     TLValue processHelpGetConfig(CTelegramStream &stream, quint64 id);
     TLValue processContactsGetContacts(CTelegramStream &stream, quint64 id);
@@ -318,7 +460,92 @@ protected:
     TLValue processAccountUpdateStatus(CTelegramStream &stream, quint64 id);
     TLValue processAccountUpdateUsername(CTelegramStream &stream, quint64 id);
 
+    // Methods which share the result handler with another one
+    inline TLValue processAuthImportAuthorization(CTelegramStream &stream, quint64 id) { return processAuthSign(stream, id); }
+    inline TLValue processAuthSignIn(CTelegramStream &stream, quint64 id) { return processAuthSign(stream, id); }
+    inline TLValue processAuthSignUp(CTelegramStream &stream, quint64 id) { return processAuthSign(stream, id); }
+    inline TLValue processUploadSaveBigFilePart(CTelegramStream &stream, quint64 id) { return processUploadSaveFilePart(stream, id); }
+
+    // Generated RPC result readers declaration
+    TLValue readAccountChangePhoneResult(CTelegramStream &stream, quint64 id);
+    TLValue readAccountDeleteAccountResult(CTelegramStream &stream, quint64 id);
+    TLValue readAccountGetAccountTTLResult(CTelegramStream &stream, quint64 id);
+    TLValue readAccountGetAuthorizationsResult(CTelegramStream &stream, quint64 id);
+    TLValue readAccountGetNotifySettingsResult(CTelegramStream &stream, quint64 id);
+    TLValue readAccountGetPasswordResult(CTelegramStream &stream, quint64 id);
+    TLValue readAccountGetPasswordSettingsResult(CTelegramStream &stream, quint64 id);
+    TLValue readAccountGetPrivacyResult(CTelegramStream &stream, quint64 id);
+    TLValue readAccountGetWallPapersResult(CTelegramStream &stream, quint64 id);
+    TLValue readAccountRegisterDeviceResult(CTelegramStream &stream, quint64 id);
+    TLValue readAccountResetAuthorizationResult(CTelegramStream &stream, quint64 id);
+    TLValue readAccountResetNotifySettingsResult(CTelegramStream &stream, quint64 id);
+    TLValue readAccountSendChangePhoneCodeResult(CTelegramStream &stream, quint64 id);
+    TLValue readAccountSetAccountTTLResult(CTelegramStream &stream, quint64 id);
+    TLValue readAccountSetPrivacyResult(CTelegramStream &stream, quint64 id);
+    TLValue readAccountUnregisterDeviceResult(CTelegramStream &stream, quint64 id);
+    TLValue readAccountUpdateDeviceLockedResult(CTelegramStream &stream, quint64 id);
+    TLValue readAccountUpdateNotifySettingsResult(CTelegramStream &stream, quint64 id);
+    TLValue readAccountUpdatePasswordSettingsResult(CTelegramStream &stream, quint64 id);
+    TLValue readAccountUpdateProfileResult(CTelegramStream &stream, quint64 id);
+    TLValue readAuthBindTempAuthKeyResult(CTelegramStream &stream, quint64 id);
+    TLValue readAuthCheckPasswordResult(CTelegramStream &stream, quint64 id);
+    TLValue readAuthRecoverPasswordResult(CTelegramStream &stream, quint64 id);
+    TLValue readAuthRequestPasswordRecoveryResult(CTelegramStream &stream, quint64 id);
+    TLValue readAuthResetAuthorizationsResult(CTelegramStream &stream, quint64 id);
+    TLValue readAuthSendCallResult(CTelegramStream &stream, quint64 id);
+    TLValue readAuthSendInvitesResult(CTelegramStream &stream, quint64 id);
+    TLValue readContactsBlockResult(CTelegramStream &stream, quint64 id);
+    TLValue readContactsDeleteContactResult(CTelegramStream &stream, quint64 id);
+    TLValue readContactsExportCardResult(CTelegramStream &stream, quint64 id);
+    TLValue readContactsGetBlockedResult(CTelegramStream &stream, quint64 id);
+    TLValue readContactsGetStatusesResult(CTelegramStream &stream, quint64 id);
+    TLValue readContactsGetSuggestedResult(CTelegramStream &stream, quint64 id);
+    TLValue readContactsImportCardResult(CTelegramStream &stream, quint64 id);
+    TLValue readContactsResolveUsernameResult(CTelegramStream &stream, quint64 id);
+    TLValue readContactsSearchResult(CTelegramStream &stream, quint64 id);
+    TLValue readContactsUnblockResult(CTelegramStream &stream, quint64 id);
+    TLValue readMessagesAcceptEncryptionResult(CTelegramStream &stream, quint64 id);
+    TLValue readMessagesAddChatUserResult(CTelegramStream &stream, quint64 id);
+    TLValue readMessagesCheckChatInviteResult(CTelegramStream &stream, quint64 id);
+    TLValue readMessagesCreateChatResult(CTelegramStream &stream, quint64 id);
+    TLValue readMessagesDeleteChatUserResult(CTelegramStream &stream, quint64 id);
+    TLValue readMessagesDeleteHistoryResult(CTelegramStream &stream, quint64 id);
+    TLValue readMessagesDeleteMessagesResult(CTelegramStream &stream, quint64 id);
+    TLValue readMessagesDiscardEncryptionResult(CTelegramStream &stream, quint64 id);
+    TLValue readMessagesEditChatPhotoResult(CTelegramStream &stream, quint64 id);
+    TLValue readMessagesEditChatTitleResult(CTelegramStream &stream, quint64 id);
+    TLValue readMessagesExportChatInviteResult(CTelegramStream &stream, quint64 id);
+    TLValue readMessagesForwardMessageResult(CTelegramStream &stream, quint64 id);
+    TLValue readMessagesForwardMessagesResult(CTelegramStream &stream, quint64 id);
+    TLValue readMessagesGetAllStickersResult(CTelegramStream &stream, quint64 id);
+    TLValue readMessagesGetDhConfigResult(CTelegramStream &stream, quint64 id);
+    TLValue readMessagesGetDialogsResult(CTelegramStream &stream, quint64 id);
+    TLValue readMessagesGetMessagesResult(CTelegramStream &stream, quint64 id);
+    TLValue readMessagesGetStickerSetResult(CTelegramStream &stream, quint64 id);
+    TLValue readMessagesGetStickersResult(CTelegramStream &stream, quint64 id);
+    TLValue readMessagesGetWebPagePreviewResult(CTelegramStream &stream, quint64 id);
+    TLValue readMessagesImportChatInviteResult(CTelegramStream &stream, quint64 id);
+    TLValue readMessagesInstallStickerSetResult(CTelegramStream &stream, quint64 id);
+    TLValue readMessagesReadEncryptedHistoryResult(CTelegramStream &stream, quint64 id);
+    TLValue readMessagesReadMessageContentsResult(CTelegramStream &stream, quint64 id);
+    TLValue readMessagesReceivedQueueResult(CTelegramStream &stream, quint64 id);
+    TLValue readMessagesRequestEncryptionResult(CTelegramStream &stream, quint64 id);
+    TLValue readMessagesSearchResult(CTelegramStream &stream, quint64 id);
+    TLValue readMessagesSendBroadcastResult(CTelegramStream &stream, quint64 id);
+    TLValue readMessagesSendEncryptedResult(CTelegramStream &stream, quint64 id);
+    TLValue readMessagesSendEncryptedFileResult(CTelegramStream &stream, quint64 id);
+    TLValue readMessagesSendEncryptedServiceResult(CTelegramStream &stream, quint64 id);
+    TLValue readMessagesSendMediaResult(CTelegramStream &stream, quint64 id);
+    TLValue readMessagesSetEncryptedTypingResult(CTelegramStream &stream, quint64 id);
+    TLValue readMessagesUninstallStickerSetResult(CTelegramStream &stream, quint64 id);
+    // End of generated RPC result readers declaration
+
+    // Sorted by the method id
+    static const RpcResultReader s_rpcResultReaders[];
+    static const int s_rpcResultReadersCount;
+
     bool processErrorSeeOther(const QString errorMessage, quint64 id);
+    bool processFloodWait(const QString &errorMessage, quint64 id);
 
     TLValue processUpdate(CTelegramStream &stream, bool *ok);
 
@@ -332,7 +559,36 @@ protected:
 
     quint64 sendPlainPackage(const QByteArray &buffer);
     quint64 sendEncryptedPackage(const QByteArray &buffer, bool savePackage = true);
-    quint64 sendEncryptedPackageAgain(quint64 id);
+    quint64 sendEncryptedPackageNow(const QByteArray &buffer);
+    void sendSubmittedPackage(quint64 id, quint64 messageId);
+    void sendEncryptedPackageAgain(quint64 messageId);
+    void sendSentPackagesAgain();
+    QByteArray submittedPackageBody(quint64 id, quint32 sequenceNumber) const;
+#ifdef NETWORK_LOGGING
+    void logEncryptedPackage(quint64 messageId, quint32 sequenceNumber, const QByteArray &buffer);
+#endif
+    void sendEncryptedMessage(quint64 messageId, quint32 sequenceNumber, const QByteArray &body);
+
+    bool isReadyToSendEncryptedPackages() const;
+    quint64 addPendingPackage(const QByteArray &buffer);
+    static PackagePriority packagePriority(const QByteArray &buffer);
+    static bool isServiceRequest(const QByteArray &buffer);
+    static bool readSendMessageRequest(const QByteArray &buffer, TLInputPeer *peer, quint64 *randomId);
+    void restartIdleTimer();
+    void sendPendingPackages();
+    void sendPackagesInContainer(const QList<quint64> &ids);
+    void setPackageMessage(quint64 id, quint64 messageId, quint32 sequenceNumber);
+    bool forgetPackageMessage(quint64 id);
+    inline quint64 requestIdByMessageId(quint64 messageId) const { return m_sentPackages.value(messageId).requestId; }
+    bool isDelayedPackage(quint64 id) const;
+    bool removeSubmittedPackage(quint64 id);
+    QByteArray invokeAfterHeader(const QList<quint64> &dependencies) const;
+    QByteArray compressedPackage(const QByteArray &buffer) const;
+    quint32 dependenciesDelay(const QList<quint64> &dependencies) const;
+
+    static void getFloodWaitKeys(const QByteArray &buffer, quint64 *methodKey, quint64 *peerKey);
+    quint32 acquireFloodWaitToken(const QByteArray &buffer);
+    void addDelayedPackage(quint64 id, quint32 delay);
 
     void setTransport(CTelegramTransport *newTransport);
 
@@ -340,12 +596,18 @@ protected:
     void setAuthState(AuthState newState);
 
     quint64 newMessageId();
+    quint32 serverTime() const;
+
+    void updateClockOffset(quint64 serverMessageId);
+    void updateRoundTripTime(qint64 requestTime);
 
     QString userNameFromPackage(quint64 id) const;
 
     void startPingTimer();
+    void processKeepAliveProbeResult(bool success);
 
-    void addMessageToAck(quint64 id);
+    void addMessageToAck(quint64 id, quint32 sequenceNumber);
+    bool acceptReceivedMessage(quint64 id, quint32 sequenceNumber);
 
 protected slots:
     void whenTransportStateChanged();
@@ -353,17 +615,31 @@ protected slots:
     void whenTransportTimeout();
     void whenItsTimeToPing();
     void whenItsTimeToAckMessages();
+    void whenItsTimeToUpdateServerSalt();
+    void whenConnectionIsIdle();
+    void whenItsTimeToSendDelayedPackages();
 
 protected:
     ConnectionStatus m_status;
     const CAppInformation *m_appInfo;
 
-    QMap<quint64, QByteArray> m_submittedPackages; // <message id, package data>
-    QMap<quint64, quint32> m_requestedFilesIds; // <message id, file id>
+    // The request id is given to the caller and never changes, while the request can be sent in several messages.
+    QMap<quint64, QByteArray> m_submittedPackages; // <request id, package data>
+    QMap<quint64, SentPackage> m_sentPackages; // <message id, the request>, sent and not answered yet
+    QHash<quint64, quint64> m_packageMessageIds; // <request id, message id>, sent and not answered yet
+    QList<quint64> m_pendingPackages; // Submitted, but not sent yet (the connection is not ready)
+    QMultiMap<qint64, quint64> m_delayedPackages; // <time to send, request id>, submitted, but held by the flood limiter
+    QMap<quint64, quint32> m_requestedFilesIds; // <request id, file id>
+    QMap<quint64, QList<quint64> > m_packageDependencies; // <request id, ids of the requests to invoke after>
+    QList<quint64> m_nextRequestDependencies;
 
     CTelegramTransport *m_transport;
     QTimer *m_pingTimer;
     QTimer *m_ackTimer;
+    QTimer *m_serverSaltTimer;
+    QTimer *m_reconnectionTimer;
+    QTimer *m_idleTimer;
+    QTimer *m_delayedPackagesTimer;
 
     AuthState m_authState;
 
@@ -372,6 +648,9 @@ protected:
     quint64 m_authKeyAuxHash;
     quint64 m_serverSalt;
     quint64 m_receivedServerSalt;
+    QByteArray m_receivedPackageBuffer;
+    TLVector<TLFutureSalt> m_serverSalts; // Sorted by validSince
+    quint64 m_futureSaltsRequestId;
     quint64 m_sessionId;
     quint64 m_lastMessageId;
     quint64 m_lastSentPingId;
@@ -382,11 +661,26 @@ protected:
     quint32 m_contentRelatedMessages;
 
     TLVector<quint64> m_messagesToAck;
+    TLVector<quint32> m_messagesToAckSequenceNumbers; // Kept to restore the received messages window
+    CMessageIdWindow m_receivedMessages;
+    CFloodWaitLimiter m_floodWaitLimiter;
 
     quint32 m_pingInterval;
     quint32 m_serverDisconnectionExtraTime;
-    qint32 m_deltaTime;
-    DeltaTimeHeuristicState m_deltaTimeHeuristicState;
+    quint32 m_keepAliveInterval;
+    quint32 m_keepAliveGoodInterval; // The greatest interval, proved to keep the connection alive
+    quint32 m_keepAliveCeiling;
+    quint32 m_keepAliveProbeSuccesses;
+    bool m_keepAliveProbe; // The last ping was sent after the idle period and tests the interval
+    quint32 m_idleTimeout;
+    quint32 m_compressionThreshold;
+    qint64 m_lastReceivedPackageTime;
+    qint64 m_clockOffset;
+    qint64 m_lastClockOffsetSample;
+    quint32 m_clockOffsetSamplesCount;
+    quint32 m_roundTripTime;
+    qint64 m_lastPlainPackageTime;
+    quint32 m_reconnectionDelay;
 
     TLNumber128 m_clientNonce;
     TLNumber128 m_serverNonce;
@@ -73,6 +73,8 @@ CTelegramCore::CTelegramCore(QObject *parent) :
             SIGNAL(chatChanged(quint32)));
     connect(m_dispatcher, SIGNAL(authorizationErrorReceived()),
             SIGNAL(authorizationErrorReceived()));
+    connect(m_dispatcher, SIGNAL(floodWaitReceived(QString,quint32)),
+            SIGNAL(floodWaitReceived(QString,quint32)));
     connect(m_dispatcher, SIGNAL(userNameStatusUpdated(QString,TelegramNamespace::AccountUserNameStatus)),
             SIGNAL(userNameStatusUpdated(QString,TelegramNamespace::AccountUserNameStatus)));
     connect(m_dispatcher, SIGNAL(uploadingStatusUpdated(quint32,quint32,quint32)),
@@ -117,6 +119,21 @@ TelegramNamespace::ConnectionState CTelegramCore::connectionState() const
     return m_dispatcher->connectionState();
 }
 
+qint64 CTelegramCore::clockOffset() const
+{
+    return m_dispatcher->clockOffset();
+}
+
+quint32 CTelegramCore::roundTripTime() const
+{
+    return m_dispatcher->roundTripTime();
+}
+
+quint32 CTelegramCore::floodWaitTime() const
+{
+    return m_dispatcher->floodWaitTime();
+}
+
 bool CTelegramCore::initConnection(const QVector<TelegramNamespace::DcOption> &dcs)
 {
     if (!m_appInfo || !m_appInfo->isValid()) {
@@ -186,6 +203,16 @@ void CTelegramCore::requestMessageMediaData(quint32 messageId)
     m_dispatcher->requestMessageMediaData(messageId);
 }
 
+bool CTelegramCore::cancelMessageMediaDataRequest(quint32 messageId)
+{
+    return m_dispatcher->cancelMessageMediaDataRequest(messageId);
+}
+
+bool CTelegramCore::cancelUpload(quint32 requestId)
+{
+    return m_dispatcher->cancelFileRequest(requestId);
+}
+
 bool CTelegramCore::requestHistory(const QString &identifier, int offset, int limit)
 {
     return m_dispatcher->requestHistory(identifier, offset, limit);
@@ -301,6 +328,11 @@ void CTelegramCore::setAutoReconnection(bool enable)
     return m_dispatcher->setAutoReconnection(enable);
 }
 
+void CTelegramCore::setSessionResumption(bool enable)
+{
+    return m_dispatcher->setSessionResumption(enable);
+}
+
 void CTelegramCore::setPingInterval(quint32 interval, quint32 serverDisconnectionAdditionTime)
 {
     return m_dispatcher->setPingInterval(interval, serverDisconnectionAdditionTime);
@@ -311,6 +343,11 @@ void CTelegramCore::setMediaDataBufferSize(quint32 size)
     m_dispatcher->setMediaDataBufferSize(size);
 }
 
+void CTelegramCore::setCompressionThreshold(quint32 size)
+{
+    m_dispatcher->setCompressionThreshold(size);
+}
+
 QString CTelegramCore::selfPhone() const
 {
     return m_dispatcher->selfPhone();
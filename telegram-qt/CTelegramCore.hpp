@@ -44,6 +44,14 @@ public:
     QByteArray connectionSecretInfo() const;
 
     Q_INVOKABLE TelegramNamespace::ConnectionState connectionState() const;
+
+    // Connection health: the estimated server clock offset and the smoothed round trip time, both in ms.
+    Q_INVOKABLE qint64 clockOffset() const;
+    Q_INVOKABLE quint32 roundTripTime() const;
+
+    // The greatest remaining time (in ms) the server asked to wait before the next request of some method.
+    Q_INVOKABLE quint32 floodWaitTime() const;
+
     Q_INVOKABLE QString selfPhone() const;
     Q_INVOKABLE QStringList contactList() const;
     Q_INVOKABLE QList<quint32> chatList() const;
@@ -70,10 +78,16 @@ public Q_SLOTS:
     void setAcceptableMessageTypes(TelegramNamespace::MessageTypeFlags types);
     void setAutoReconnection(bool enable);
 
+    // Store the MTProto session in the connectionSecretInfo(), so the server keeps delivering the updates to the restored connection.
+    void setSessionResumption(bool enable);
+
     // By default, the app would ping server every 15 000 ms and instruct the server to close connection after 10 000 more ms. Pass interval = 0 to disable ping.
     void setPingInterval(quint32 interval, quint32 serverDisconnectionAdditionTime = 10000);
     void setMediaDataBufferSize(quint32 size);
 
+    // Requests of the given size (1024 bytes by default) and bigger are sent compressed, if it saves bytes. Pass size = 0 to disable the compression.
+    void setCompressionThreshold(quint32 size);
+
     bool initConnection(const QVector<TelegramNamespace::DcOption> &dcs = QVector<TelegramNamespace::DcOption>()); // Uses builtin dc options by default
     bool restoreConnection(const QByteArray &secret);
     void closeConnection();
@@ -93,6 +107,10 @@ public Q_SLOTS:
     void requestContactAvatar(const QString &contact);
     void requestMessageMediaData(quint32 messageId);
 
+    // Stop the transfer: no more data chunks (or uploading status updates) are emitted for the request.
+    bool cancelMessageMediaDataRequest(quint32 messageId);
+    bool cancelUpload(quint32 requestId);
+
     bool requestHistory(const QString &identifier, int offset, int limit);
 
     // Does not work yet
@@ -172,6 +190,10 @@ Q_SIGNALS:
 
     void authorizationErrorReceived();
 
+    // The request is delayed (or dropped, if the wait is longer than five minutes) and sent again automatically.
+    // A dropped message is reported by sentMessageStatusChanged() with MessageDeliveryStatusFailed.
+    void floodWaitReceived(const QString &method, quint32 seconds);
+
     void userNameStatusUpdated(const QString &userName, TelegramNamespace::AccountUserNameStatus status);
     void uploadingStatusUpdated(quint32 requestId, quint32 currentOffset, quint32 size);
 
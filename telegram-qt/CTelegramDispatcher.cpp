@@ -46,8 +46,16 @@ static const QVector<TelegramNamespace::DcOption> s_builtInDcs = QVector<Telegra
         << TelegramNamespace::DcOption(QLatin1String("149.154.171.5")  , 443);
 
 static const quint32 s_defaultPingInterval = 15000; // 15 sec
+static const quint32 s_defaultCompressionThreshold = 1024; // Smaller requests would not shrink enough to pay off the compression.
+static const quint32 s_extraConnectionIdleTimeout = 60000; // Connections to the other DCs (media transfer) are closed after a minute of silence.
+
+const quint32 secretFormatVersion = 5;
+
+enum ConnectionRecordFlags {
+    ConnectionRecordSignedIn = 1 << 0, // The auth key is authorized (signed in or imported)
+    ConnectionRecordHasSession = 1 << 1 // The record ends with the MTProto session state
+};
 
-const quint32 secretFormatVersion = 3;
 const int s_userTypingActionPeriod = 6000; // 6 sec
 const int s_localTypingDuration = 5000; // 5 sec
 const int s_localTypingRecommendedRepeatInterval = 400; // (s_userTypingActionPeriod - s_localTypingDuration) / 2. Minus 100 ms for insurance.
@@ -87,7 +95,7 @@ FileRequestDescriptor FileRequestDescriptor::uploadRequest(const QByteArray &dat
 
 FileRequestDescriptor FileRequestDescriptor::avatarRequest(const TLUser *user)
 {
-    if (user->photo.photoSmall.tlType != TLValue::FileLocation) {
+    if (user->photo->photoSmall->tlType != TLValue::FileLocation) {
         return FileRequestDescriptor();
     }
 
@@ -95,7 +103,7 @@ FileRequestDescriptor FileRequestDescriptor::avatarRequest(const TLUser *user)
 
     result.m_type = Avatar;
     result.m_userId = user->id;
-    result.setupLocation(user->photo.photoSmall);
+    result.setupLocation(user->photo->photoSmall);
 
     return result;
 }
@@ -110,34 +118,34 @@ FileRequestDescriptor FileRequestDescriptor::messageMediaDataRequest(const TLMes
 
     switch (media.tlType) {
     case TLValue::MessageMediaPhoto:
-        if (media.photo.sizes.isEmpty()) {
+        if (media.photo->sizes.isEmpty()) {
             return FileRequestDescriptor();
         } else {
-            const TLPhotoSize s = media.photo.sizes.last();
+            const TLPhotoSize s = media.photo->sizes.last();
             result.setupLocation(s.location);
             result.m_size = s.size;
         }
         break;
     case TLValue::MessageMediaAudio:
-        result.m_dcId = media.audio.dcId;
+        result.m_dcId = media.audio->dcId;
         result.m_inputLocation.tlType = TLValue::InputAudioFileLocation;
-        result.m_inputLocation.id = media.audio.id;
-        result.m_inputLocation.accessHash = media.audio.accessHash;
-        result.m_size = media.audio.size;
+        result.m_inputLocation.id = media.audio->id;
+        result.m_inputLocation.accessHash = media.audio->accessHash;
+        result.m_size = media.audio->size;
         break;
     case TLValue::MessageMediaVideo:
-        result.m_dcId = media.video.dcId;
+        result.m_dcId = media.video->dcId;
         result.m_inputLocation.tlType = TLValue::InputVideoFileLocation;
-        result.m_inputLocation.id = media.video.id;
-        result.m_inputLocation.accessHash = media.video.accessHash;
-        result.m_size = media.video.size;
+        result.m_inputLocation.id = media.video->id;
+        result.m_inputLocation.accessHash = media.video->accessHash;
+        result.m_size = media.video->size;
         break;
     case TLValue::MessageMediaDocument:
-        result.m_dcId = media.document.dcId;
+        result.m_dcId = media.document->dcId;
         result.m_inputLocation.tlType = TLValue::InputDocumentFileLocation;
-        result.m_inputLocation.id = media.document.id;
-        result.m_inputLocation.accessHash = media.document.accessHash;
-        result.m_size = media.document.size;
+        result.m_inputLocation.id = media.document->id;
+        result.m_inputLocation.accessHash = media.document->accessHash;
+        result.m_size = media.document->size;
         break;
     default:
         return FileRequestDescriptor();
@@ -208,6 +216,13 @@ void FileRequestDescriptor::bumpPart()
     }
 }
 
+void FileRequestDescriptor::abort()
+{
+    delete m_hash;
+    m_hash = 0;
+    m_data.clear();
+}
+
 QByteArray FileRequestDescriptor::data() const
 {
     return m_data.mid(m_part * c_chunkSize, c_chunkSize);
@@ -240,14 +255,17 @@ CTelegramDispatcher::CTelegramDispatcher(QObject *parent) :
     m_messageReceivingFilterFlags(TelegramNamespace::MessageFlagRead),
     m_acceptableMessageTypes(TelegramNamespace::MessageTypeText),
     m_autoReconnectionEnabled(false),
+    m_sessionResumptionEnabled(false),
     m_pingInterval(s_defaultPingInterval),
     m_mediaDataBufferSize(128 * 256), // 128 KB
+    m_compressionThreshold(s_defaultCompressionThreshold),
     m_initializationState(0),
     m_requestedSteps(0),
     m_activeDc(0),
     m_wantedActiveDc(0),
     m_autoConnectionDcIndex(s_autoConnectionIndexInvalid),
     m_updatesStateIsLocked(false),
+    m_actualStateIsPending(false),
     m_selfUserId(0),
     m_fileRequestCounter(0),
     m_typingUpdateTimer(new QTimer(this))
@@ -282,6 +300,35 @@ qint32 CTelegramDispatcher::localTypingRecommendedRepeatInterval()
     return s_localTypingRecommendedRepeatInterval;
 }
 
+qint64 CTelegramDispatcher::clockOffset() const
+{
+    if (!activeConnection()) {
+        return 0;
+    }
+
+    return activeConnection()->clockOffset();
+}
+
+quint32 CTelegramDispatcher::roundTripTime() const
+{
+    if (!activeConnection()) {
+        return 0;
+    }
+
+    return activeConnection()->roundTripTime();
+}
+
+quint32 CTelegramDispatcher::floodWaitTime() const
+{
+    quint32 result = 0;
+
+    foreach (const CTelegramConnection *connection, m_connections) {
+        result = qMax(result, connection->floodWaitTime());
+    }
+
+    return result;
+}
+
 QString CTelegramDispatcher::selfPhone() const
 {
     if (!m_selfUserId || !m_users.value(m_selfUserId)) {
@@ -357,19 +404,129 @@ QByteArray CTelegramDispatcher::connectionSecretInfo() const
     CTelegramStream outputStream(&output, /* write */ true);
 
     outputStream << secretFormatVersion;
-    outputStream << activeConnection()->deltaTime();
-    outputStream << activeConnection()->dcInfo();
-    outputStream << activeConnection()->authKey();
-    outputStream << activeConnection()->authId();
-    outputStream << activeConnection()->serverSalt();
+    outputStream << activeConnection()->dcInfo().id;
     outputStream << m_updatesState.pts;
     outputStream << m_updatesState.qts;
     outputStream << m_updatesState.date;
     outputStream << m_chatIds;
 
+    QList<QByteArray> records;
+
+    foreach (const CTelegramConnection *connection, m_connections) {
+        if (connection->authKey().isEmpty()) {
+            continue;
+        }
+
+        // A key, which is not authorized yet, would need the authorization import anyway, so it is not worth to store.
+        if (!isAuthorizedConnection(connection)) {
+            continue;
+        }
+
+        records.append(connectionRecord(connection));
+    }
+
+    outputStream << quint32(records.count());
+
+    foreach (const QByteArray &record, records) {
+        outputStream << record;
+    }
+
+    return output;
+}
+
+// Every DC connection is stored as a separate length-prefixed record, so the newer fields can be appended
+// to the record end without a break of the format for the rest of the records.
+QByteArray CTelegramDispatcher::connectionRecord(const CTelegramConnection *connection) const
+{
+    QByteArray output;
+    CTelegramStream outputStream(&output, /* write */ true);
+
+    quint32 flags = 0;
+
+    if (isAuthorizedConnection(connection)) {
+        flags |= ConnectionRecordSignedIn;
+    }
+
+    QByteArray sessionState;
+
+    if (m_sessionResumptionEnabled) {
+        sessionState = connection->sessionState();
+    }
+
+    if (!sessionState.isEmpty()) {
+        flags |= ConnectionRecordHasSession;
+    }
+
+    outputStream << flags;
+    outputStream << connection->dcInfo();
+    outputStream << connection->authKey();
+    outputStream << connection->authId();
+    outputStream << connection->serverSalt();
+    outputStream << connection->serverSalts();
+    outputStream << connection->clockOffset();
+
+    if (flags & ConnectionRecordHasSession) {
+        outputStream << sessionState;
+    }
+
     return output;
 }
 
+// The connection state is reset on the reconnection, so the authorization is tracked separately.
+bool CTelegramDispatcher::isAuthorizedConnection(const CTelegramConnection *connection) const
+{
+    return (connection == activeConnection()) || m_authorizedConnections.contains(connection);
+}
+
+CTelegramConnection *CTelegramDispatcher::restoreConnectionRecord(const QByteArray &record)
+{
+    CTelegramStream inputStream(record);
+
+    quint32 flags;
+    TLDcOption dcInfo;
+    QByteArray authKey;
+    quint64 authId;
+    quint64 serverSalt;
+    TLVector<TLFutureSalt> serverSalts;
+    qint64 clockOffset;
+
+    inputStream >> flags;
+    inputStream >> dcInfo;
+    inputStream >> authKey;
+    inputStream >> authId;
+    inputStream >> serverSalt;
+    inputStream >> serverSalts;
+    inputStream >> clockOffset;
+
+    if (inputStream.error() || authKey.isEmpty() || !(flags & ConnectionRecordSignedIn)) {
+        qDebug() << Q_FUNC_INFO << "Invalid connection record for dc" << dcInfo.id;
+        return 0;
+    }
+
+    CTelegramConnection *connection = createConnection();
+    connection->setDcInfo(dcInfo);
+    connection->setClockOffset(clockOffset);
+    connection->setAuthKey(authKey);
+    connection->setServerSalt(serverSalt);
+    connection->setServerSalts(serverSalts);
+
+    if (connection->authId() != authId) {
+        qDebug() << Q_FUNC_INFO << "Invalid auth data for dc" << dcInfo.id;
+        delete connection;
+        return 0;
+    }
+
+    if (flags & ConnectionRecordHasSession) {
+        QByteArray sessionState;
+        inputStream >> sessionState;
+
+        // The server will just create a new session if the old one is already forgotten.
+        connection->restoreSessionState(sessionState);
+    }
+
+    return connection;
+}
+
 void CTelegramDispatcher::setMessageReceivingFilter(TelegramNamespace::MessageFlags flags)
 {
     m_messageReceivingFilterFlags = flags;
@@ -385,6 +542,11 @@ void CTelegramDispatcher::setAutoReconnection(bool enable)
     m_autoReconnectionEnabled = enable;
 }
 
+void CTelegramDispatcher::setSessionResumption(bool enable)
+{
+    m_sessionResumptionEnabled = enable;
+}
+
 void CTelegramDispatcher::setPingInterval(quint32 ms, quint32 serverDisconnectionAdditionTime)
 {
     m_pingInterval = ms;
@@ -408,6 +570,15 @@ void CTelegramDispatcher::setMediaDataBufferSize(quint32 size)
     m_mediaDataBufferSize = size;
 }
 
+void CTelegramDispatcher::setCompressionThreshold(quint32 size)
+{
+    m_compressionThreshold = size;
+
+    foreach (CTelegramConnection *connection, m_connections) {
+        connection->setCompressionThreshold(size);
+    }
+}
+
 bool CTelegramDispatcher::initConnection(const QVector<TelegramNamespace::DcOption> &dcs)
 {
     if (!dcs.isEmpty()) {
@@ -433,10 +604,13 @@ void CTelegramDispatcher::tryNextDcAddress()
 
     qDebug() << "CTelegramDispatcher::tryNextBuiltInDcAddress(): Dc index" << m_autoConnectionDcIndex;
 
+    bool wrappedUp = false;
+
     if (m_autoConnectionDcIndex >= m_connectionAddresses.count()) {
         if (m_autoReconnectionEnabled) {
             qDebug() << "CTelegramDispatcher::tryNextBuiltInDcAddress(): Could not connect to any known dc. Reconnection enabled -> wrapping up and tring again.";
             m_autoConnectionDcIndex = 0;
+            wrappedUp = true;
         } else {
             qDebug() << "CTelegramDispatcher::tryNextBuiltInDcAddress(): Could not connect to any known dc. Giving up.";
             setConnectionState(TelegramNamespace::ConnectionStateDisconnected);
@@ -455,6 +629,12 @@ void CTelegramDispatcher::tryNextDcAddress()
 
     activeConnection()->setDcInfo(dcInfo);
 
+    if (wrappedUp) {
+        // All the addresses failed, so do not go for the next round immediately.
+        activeConnection()->scheduleReconnection();
+        return;
+    }
+
     initConnectionSharedFinal();
 }
 
@@ -463,11 +643,6 @@ bool CTelegramDispatcher::restoreConnection(const QByteArray &secret)
     CTelegramStream inputStream(secret);
 
     quint32 format;
-    qint32 deltaTime;
-    TLDcOption dcInfo;
-    QByteArray authKey;
-    quint64 authId;
-    quint64 serverSalt;
 
     inputStream >> format;
 
@@ -478,6 +653,73 @@ bool CTelegramDispatcher::restoreConnection(const QByteArray &secret)
         qDebug() << Q_FUNC_INFO << "Format version:" << format;
     }
 
+    if (format < 5) {
+        return restoreLegacyConnection(inputStream, format);
+    }
+
+    quint32 activeDc;
+    quint32 recordsCount;
+
+    inputStream >> activeDc;
+
+    initConnectionSharedClear();
+
+    inputStream >> m_updatesState.pts;
+    inputStream >> m_updatesState.qts;
+    inputStream >> m_updatesState.date;
+    inputStream >> m_chatIds;
+    inputStream >> recordsCount;
+
+    QMap<quint32, CTelegramConnection *> connections;
+
+    for (quint32 i = 0; (i < recordsCount) && !inputStream.error(); ++i) {
+        QByteArray record;
+        inputStream >> record;
+
+        CTelegramConnection *connection = restoreConnectionRecord(record);
+
+        if (!connection) {
+            continue;
+        }
+
+        const quint32 dc = connection->dcInfo().id;
+
+        if (connections.contains(dc)) {
+            delete connections.value(dc);
+        }
+
+        connections.insert(dc, connection);
+    }
+
+    if (!connections.contains(activeDc)) {
+        qDebug() << Q_FUNC_INFO << "There is no valid auth data for the active dc" << activeDc;
+        qDeleteAll(connections);
+        return false;
+    }
+
+    // The connections to the other DCs are established on demand and need no handshake nor the authorization import.
+    foreach (CTelegramConnection *connection, connections) {
+        if (connection->dcInfo().id != activeDc) {
+            connection->setIdleTimeout(s_extraConnectionIdleTimeout);
+        }
+
+        m_connections.insert(connection->dcInfo().id, connection);
+        m_authorizedConnections.insert(connection);
+    }
+
+    initConnectionSharedFinal(activeDc);
+
+    return true;
+}
+
+bool CTelegramDispatcher::restoreLegacyConnection(CTelegramStream &inputStream, quint32 format)
+{
+    qint32 deltaTime;
+    TLDcOption dcInfo;
+    QByteArray authKey;
+    quint64 authId;
+    quint64 serverSalt;
+
     QString legacySelfPhone;
 
     inputStream >> deltaTime;
@@ -511,11 +753,18 @@ bool CTelegramDispatcher::restoreConnection(const QByteArray &secret)
         inputStream >> m_chatIds;
     }
 
+    TLVector<TLFutureSalt> serverSalts;
+
+    if (format >= 4) {
+        inputStream >> serverSalts;
+    }
+
     CTelegramConnection *connection = createConnection();
     connection->setDcInfo(dcInfo);
     connection->setDeltaTime(deltaTime);
     connection->setAuthKey(authKey);
     connection->setServerSalt(serverSalt);
+    connection->setServerSalts(serverSalts);
 
     if (connection->authId() != authId) {
         qDebug() << Q_FUNC_INFO << "Invalid auth data.";
@@ -547,6 +796,7 @@ void CTelegramDispatcher::initConnectionSharedFinal(quint32 activeDc)
     setConnectionState(TelegramNamespace::ConnectionStateConnecting);
     setActiveDc(activeDc);
     m_updatesStateIsLocked = false;
+    m_actualStateIsPending = false;
     m_selfUserId = 0;
 
     m_actualState = TLUpdatesState();
@@ -564,12 +814,14 @@ void CTelegramDispatcher::closeConnection()
     }
 
     m_connections.clear();
+    m_authorizedConnections.clear();
 
     m_dcConfiguration.clear();
     m_delayedPackages.clear();
     qDeleteAll(m_users);
     m_users.clear();
     m_messagesMap.clear();
+    m_queuedMessages.clear();
     m_contactList.clear();
     m_requestedFileDescriptors.clear();
     m_fileRequestCounter = 0;
@@ -643,7 +895,7 @@ void CTelegramDispatcher::requestContactAvatar(const QString &phoneNumber)
         return;
     }
 
-    if (user->photo.tlType == TLValue::UserProfilePhotoEmpty) {
+    if (user->photo->tlType == TLValue::UserProfilePhotoEmpty) {
         qDebug() << Q_FUNC_INFO << "User" << maskPhoneNumber(phoneNumber) << "have no avatar";
         return;
     }
@@ -667,6 +919,37 @@ bool CTelegramDispatcher::requestMessageMediaData(quint32 messageId)
     return requestFile(FileRequestDescriptor::messageMediaDataRequest(m_knownMediaMessages.value(messageId)));
 }
 
+bool CTelegramDispatcher::cancelMessageMediaDataRequest(quint32 messageId)
+{
+    QMap<quint32, FileRequestDescriptor>::const_iterator it = m_requestedFileDescriptors.constBegin();
+    for ( ; it != m_requestedFileDescriptors.constEnd(); ++it) {
+        if ((it.value().type() == FileRequestDescriptor::MessageMediaData) && (it.value().messageId() == messageId)) {
+            return cancelFileRequest(it.key());
+        }
+    }
+
+    return false;
+}
+
+bool CTelegramDispatcher::cancelFileRequest(quint32 requestId)
+{
+    if (!m_requestedFileDescriptors.contains(requestId)) {
+        qDebug() << Q_FUNC_INFO << "Unknown request" << requestId;
+        return false;
+    }
+
+    FileRequestDescriptor descriptor = m_requestedFileDescriptors.take(requestId);
+    descriptor.abort();
+
+    CTelegramConnection *connection = m_connections.value(descriptor.dcId());
+
+    if (connection) {
+        connection->cancelFileRequest(requestId);
+    }
+
+    return true;
+}
+
 bool CTelegramDispatcher::getMessageMediaInfo(TelegramNamespace::MessageMediaInfo *messageInfo, quint32 messageId) const
 {
     if (!m_knownMediaMessages.contains(messageId)) {
@@ -714,9 +997,25 @@ quint32 CTelegramDispatcher::uploadFile(QIODevice *source, const QString &fileNa
 
 quint64 CTelegramDispatcher::sendMessage(const QString &identifier, const QString &message)
 {
-    if (!activeConnection()) {
-        return 0;
+    quint64 randomMessageId;
+    Utils::randomBytes(&randomMessageId);
+
+    if (!activeConnection() || (m_initializationState != StepDone)) {
+        // The message is sent as soon as the connection is ready and the contacts are known.
+        QueuedMessage queuedMessage;
+        queuedMessage.identifier = identifier;
+        queuedMessage.message = message;
+        queuedMessage.randomId = randomMessageId;
+        m_queuedMessages.append(queuedMessage);
+
+        return randomMessageId;
     }
+
+    return sendMessageNow(identifier, message, randomMessageId);
+}
+
+quint64 CTelegramDispatcher::sendMessageNow(const QString &identifier, const QString &message, quint64 randomMessageId)
+{
     const TLInputPeer peer = identifierToInputPeer(identifier);
 
     int actionIndex;
@@ -744,7 +1043,19 @@ quint64 CTelegramDispatcher::sendMessage(const QString &identifier, const QStrin
         m_localMessageActions.remove(actionIndex);
     }
 
-    return activeConnection()->sendMessage(peer, message);
+    return activeConnection()->sendMessage(peer, message, randomMessageId);
+}
+
+void CTelegramDispatcher::sendQueuedMessages()
+{
+    const QList<QueuedMessage> messages = m_queuedMessages;
+    m_queuedMessages.clear();
+
+    foreach (const QueuedMessage &queuedMessage, messages) {
+        if (!sendMessageNow(queuedMessage.identifier, queuedMessage.message, queuedMessage.randomId)) {
+            qDebug() << Q_FUNC_INFO << "Unable to send the queued message to" << maskPhoneNumber(queuedMessage.identifier);
+        }
+    }
 }
 
 quint64 CTelegramDispatcher::forwardMessage(const QString &identifier, quint32 messageId)
@@ -777,27 +1088,27 @@ quint64 CTelegramDispatcher::sendMedia(const QString &identifier, const Telegram
     switch (media->tlType) {
     case TLValue::MessageMediaPhoto:
         inputMedia.tlType = TLValue::InputMediaPhoto;
-        inputMedia.idInputPhoto.tlType = TLValue::InputPhoto;
-        inputMedia.idInputPhoto.id = media->photo.id;
-        inputMedia.idInputPhoto.accessHash = media->photo.accessHash;
+        inputMedia.idInputPhoto->tlType = TLValue::InputPhoto;
+        inputMedia.idInputPhoto->id = media->photo->id;
+        inputMedia.idInputPhoto->accessHash = media->photo->accessHash;
         break;
     case TLValue::MessageMediaAudio:
         inputMedia.tlType = TLValue::InputMediaAudio;
-        inputMedia.idInputAudio.tlType = TLValue::InputAudio;
-        inputMedia.idInputAudio.id = media->audio.id;
-        inputMedia.idInputAudio.accessHash = media->audio.accessHash;
+        inputMedia.idInputAudio->tlType = TLValue::InputAudio;
+        inputMedia.idInputAudio->id = media->audio->id;
+        inputMedia.idInputAudio->accessHash = media->audio->accessHash;
         break;
     case TLValue::MessageMediaVideo:
         inputMedia.tlType = TLValue::InputMediaVideo;
-        inputMedia.idInputVeo.tlType = TLValue::InputVideo;
-        inputMedia.idInputVeo.id = media->video.id;
-        inputMedia.idInputVeo.accessHash = media->video.accessHash;
+        inputMedia.idInputVeo->tlType = TLValue::InputVideo;
+        inputMedia.idInputVeo->id = media->video->id;
+        inputMedia.idInputVeo->accessHash = media->video->accessHash;
         break;
     case TLValue::MessageMediaGeo:
         inputMedia.tlType = TLValue::InputMediaGeoPoint;
-        inputMedia.geoPoint.tlType = TLValue::InputGeoPoint;
-        inputMedia.geoPoint.longitude = media->geo.longitude;
-        inputMedia.geoPoint.latitude = media->geo.latitude;
+        inputMedia.geoPoint->tlType = TLValue::InputGeoPoint;
+        inputMedia.geoPoint->longitude = media->geo->longitude;
+        inputMedia.geoPoint->latitude = media->geo->latitude;
         break;
     case TLValue::MessageMediaContact:
         inputMedia.tlType = TLValue::InputMediaContact;
@@ -807,9 +1118,9 @@ quint64 CTelegramDispatcher::sendMedia(const QString &identifier, const Telegram
         break;
     case TLValue::MessageMediaDocument:
         inputMedia.tlType = TLValue::InputMediaDocument;
-        inputMedia.idInputDocument.tlType = TLValue::InputDocument;
-        inputMedia.idInputDocument.id = media->document.id;
-        inputMedia.idInputDocument.accessHash = media->document.accessHash;
+        inputMedia.idInputDocument->tlType = TLValue::InputDocument;
+        inputMedia.idInputDocument->id = media->document->id;
+        inputMedia.idInputDocument->accessHash = media->document->accessHash;
         break;
     default:
         return 0;
@@ -977,7 +1288,7 @@ TelegramNamespace::ContactStatus CTelegramDispatcher::contactStatus(const QStrin
     const TLUser *user = identifierToUser(phone);
 
     if (user) {
-        return decodeContactStatus(user->status.tlType);
+        return decodeContactStatus(user->status->tlType);
     }
 
     return TelegramNamespace::ContactStatusUnknown;
@@ -988,11 +1299,11 @@ quint32 CTelegramDispatcher::contactLastOnline(const QString &contact) const
     const TLUser *user = identifierToUser(contact);
 
     if (user) {
-        switch (user->status.tlType) {
+        switch (user->status->tlType) {
         case TLValue::UserStatusOnline:
-            return user->status.expires;
+            return user->status->expires;
         case TLValue::UserStatusOffline:
-            return user->status.wasOnline;
+            return user->status->wasOnline;
         case TLValue::UserStatusRecently:
             return TelegramNamespace::ContactLastOnlineRecently;
         case TLValue::UserStatusLastWeek:
@@ -1234,21 +1545,29 @@ void CTelegramDispatcher::messageActionTimerTimeout()
     }
 }
 
-void CTelegramDispatcher::whenMessageSentInfoReceived(const TLInputPeer &peer, quint64 randomId, TLMessagesSentMessage info)
+void CTelegramDispatcher::whenMessageSentInfoReceived(const TLInputPeer &peer, quint64 randomId, const TLShared<TLMessagesSentMessage> &info)
 {
     const QString identifier = userIdToIdentifier(peer.userId);
     QPair<QString, quint64> phoneAndId(identifier, randomId);
 
-    m_messagesMap.insert(info.id, phoneAndId);
+    m_messagesMap.insert(info->id, phoneAndId);
+
+    emit sentMessageStatusChanged(identifier, info->id, TelegramNamespace::MessageDeliveryStatusSent);
 
-    emit sentMessageStatusChanged(identifier, info.id, TelegramNamespace::MessageDeliveryStatusSent);
+    ensureUpdateState(info->pts, info->seq, info->date);
+}
+
+void CTelegramDispatcher::whenMessageSendingFailed(const TLInputPeer &peer, quint64 randomId)
+{
+    // The caller knows the message by the random id, so it can send the message again (or report the failure).
+    const QString identifier = peer.tlType == TLValue::InputPeerChat ? chatIdToIdentifier(peer.chatId) : userIdToIdentifier(peer.userId);
 
-    ensureUpdateState(info.pts, info.seq, info.date);
+    emit sentMessageStatusChanged(identifier, randomId, TelegramNamespace::MessageDeliveryStatusFailed);
 }
 
-void CTelegramDispatcher::whenMessagesHistoryReceived(const TLMessagesMessages &messages)
+void CTelegramDispatcher::whenMessagesHistoryReceived(const TLShared<TLMessagesMessages> &messages)
 {
-    foreach (const TLMessage &message, messages.messages) {
+    foreach (const TLMessage &message, messages->messages) {
         processMessageReceived(message);
     }
 }
@@ -1266,7 +1585,7 @@ void CTelegramDispatcher::getUser(quint32 id)
     activeConnection()->usersGetUsers(QVector<TLInputUser>() << user);
 }
 
-void CTelegramDispatcher::getInitialUsers()
+quint64 CTelegramDispatcher::getInitialUsers()
 {
     QVector<TLInputUser> users;
 
@@ -1279,12 +1598,12 @@ void CTelegramDispatcher::getInitialUsers()
     user.userId = 777000;
     users << user;
 
-    activeConnection()->usersGetUsers(users);
+    return activeConnection()->usersGetUsers(users);
 }
 
-void CTelegramDispatcher::getContacts()
+quint64 CTelegramDispatcher::getContacts()
 {
-    activeConnection()->contactsGetContacts(QString()); // Empty hash argument for now.
+    return activeConnection()->contactsGetContacts(QString()); // Empty hash argument for now.
 }
 
 void CTelegramDispatcher::getChatsInfo()
@@ -1306,6 +1625,13 @@ void CTelegramDispatcher::getUpdatesState()
 void CTelegramDispatcher::whenUpdatesStateReceived(const TLUpdatesState &updatesState)
 {
     m_actualState = updatesState;
+
+    if (!(m_initializationState & StepKnowSelf) || !(m_initializationState & StepContactList)) {
+        // The server processes the request after the users one, but the answers may come in any order.
+        m_actualStateIsPending = true;
+        return;
+    }
+
     checkStateAndCallGetDifference();
 }
 
@@ -1315,35 +1641,40 @@ void CTelegramDispatcher::getDifference()
     activeConnection()->updatesGetDifference(m_updatesState.pts, m_updatesState.date, m_updatesState.qts);
 }
 
-void CTelegramDispatcher::whenUpdatesDifferenceReceived(const TLUpdatesDifference &updatesDifference)
+void CTelegramDispatcher::whenUpdatesDifferenceReceived(const TLUpdatesDifferenceView &updatesDifference)
 {
-    switch (updatesDifference.tlType) {
+    switch (updatesDifference.tlType()) {
     case TLValue::UpdatesDifference:
-    case TLValue::UpdatesDifferenceSlice:
-        qDebug() << Q_FUNC_INFO << "UpdatesDifference" << updatesDifference.newMessages.count();
-        foreach (const TLChat &chat, updatesDifference.chats) {
+    case TLValue::UpdatesDifferenceSlice: {
+        const TLVector<TLMessageView> newMessages = updatesDifference.newMessages();
+        qDebug() << Q_FUNC_INFO << "UpdatesDifference" << newMessages.count();
+        foreach (const TLChat &chat, updatesDifference.chats()) {
             updateChat(chat);
         }
 
-        foreach (const TLMessage &message, updatesDifference.newMessages) {
-            if ((message.tlType != TLValue::MessageService) && (filterReceivedMessage(getPublicMessageFlags(message)))) {
+        foreach (const TLMessageView &message, newMessages) {
+            // Only the filter fields are decoded for the messages, which are going to be skipped.
+            if ((message.tlType() != TLValue::MessageService) && (filterReceivedMessage(getPublicMessageFlags(message.fromId(), message.flags())))) {
                 continue;
             }
 
-            processMessageReceived(message);
+            processMessageReceived(message.toStruct());
         }
-        if (updatesDifference.tlType == TLValue::UpdatesDifference) {
-            setUpdateState(updatesDifference.state.pts, updatesDifference.state.seq, updatesDifference.state.date);
+        if (updatesDifference.tlType() == TLValue::UpdatesDifference) {
+            const TLUpdatesState state = updatesDifference.state();
+            setUpdateState(state.pts, state.seq, state.date);
         } else { // UpdatesDifferenceSlice
             // Looks like updatesDifference.intermediateState is always null nowadays.
-            setUpdateState(updatesDifference.intermediateState.pts, updatesDifference.intermediateState.seq, updatesDifference.intermediateState.date);
+            const TLUpdatesState state = updatesDifference.intermediateState();
+            setUpdateState(state.pts, state.seq, state.date);
         }
 
-        foreach (const TLUpdate &update, updatesDifference.otherUpdates) {
+        foreach (const TLUpdate &update, updatesDifference.otherUpdates()) {
             processUpdate(update);
         }
 
         break;
+    }
     case TLValue::UpdatesDifferenceEmpty:
         qDebug() << Q_FUNC_INFO << "UpdatesDifferenceEmpty";
 
@@ -1352,7 +1683,7 @@ void CTelegramDispatcher::whenUpdatesDifferenceReceived(const TLUpdatesDifferenc
         return;
         break;
     default:
-        qDebug() << Q_FUNC_INFO << "unknown diff type:" << updatesDifference.tlType.toString();
+        qDebug() << Q_FUNC_INFO << "unknown diff type:" << updatesDifference.tlType().toString();
         break;
     }
 
@@ -1370,7 +1701,7 @@ void CTelegramDispatcher::whenMessagesChatsReceived(const QVector<TLChat> &chats
     continueInitialization(StepChatInfo);
 }
 
-void CTelegramDispatcher::whenMessagesFullChatReceived(const TLChatFull &chat, const QVector<TLChat> &chats, const QVector<TLUser> &users)
+void CTelegramDispatcher::whenMessagesFullChatReceived(const TLShared<TLChatFull> &chat, const QVector<TLChat> &chats, const QVector<TLUser> &users)
 {
     Q_UNUSED(chats);
 
@@ -1496,7 +1827,7 @@ void CTelegramDispatcher::processUpdate(const TLUpdate &update)
     case TLValue::UpdateUserTyping:
     case TLValue::UpdateChatUserTyping:
         if (m_users.contains(update.userId)) {
-            TelegramNamespace::MessageAction action = telegramMessageActionToPublicAction(update.action.tlType);
+            TelegramNamespace::MessageAction action = telegramMessageActionToPublicAction(update.action->tlType);
 
             int remainingTime = s_userTypingActionPeriod;
 #if QT_VERSION >= 0x050000
@@ -1532,12 +1863,12 @@ void CTelegramDispatcher::processUpdate(const TLUpdate &update)
         }
         break;
     case TLValue::UpdateChatParticipants: {
-        TLChatFull newChatState = m_chatFullInfo.value(update.participants.chatId);
-        newChatState.id = update.participants.chatId; // newChatState can be newly created emtpy chat
+        TLChatFull newChatState = m_chatFullInfo.value(update.participants->chatId);
+        newChatState.id = update.participants->chatId; // newChatState can be newly created emtpy chat
         newChatState.participants = update.participants;
         updateFullChat(newChatState);
 
-        qDebug() << Q_FUNC_INFO << "chat id resolved to" << update.participants.chatId;
+        qDebug() << Q_FUNC_INFO << "chat id resolved to" << update.participants->chatId;
         break;
     }
     case TLValue::UpdateUserStatus: {
@@ -1548,7 +1879,7 @@ void CTelegramDispatcher::processUpdate(const TLUpdate &update)
         TLUser *user = m_users.value(update.userId);
         if (user) {
             user->status = update.status;
-            emit contactStatusChanged(userIdToIdentifier(update.userId), decodeContactStatus(user->status.tlType));
+            emit contactStatusChanged(userIdToIdentifier(update.userId), decodeContactStatus(user->status->tlType));
         }
         break;
     }
@@ -1661,7 +1992,7 @@ void CTelegramDispatcher::processMessageReceived(const TLMessage &message)
     if (message.tlType == TLValue::MessageService) {
         const TLMessageAction &action = message.action;
 
-        const quint32 chatId = message.toId.chatId;
+        const quint32 chatId = message.toId->chatId;
         TLChat chat = m_chatInfo.value(chatId);
         TLChatFull fullChat = m_chatFullInfo.value(chatId);
 
@@ -1722,13 +2053,13 @@ void CTelegramDispatcher::processMessageReceived(const TLMessage &message)
         return;
     }
 
-    const TelegramNamespace::MessageType messageType = telegramMessageTypeToPublicMessageType(message.media.tlType);
+    const TelegramNamespace::MessageType messageType = telegramMessageTypeToPublicMessageType(message.media->tlType);
 
     if (!(messageType & m_acceptableMessageTypes)) {
         return;
     }
 
-    if (message.media.tlType != TLValue::MessageMediaEmpty) {
+    if (message.media->tlType != TLValue::MessageMediaEmpty) {
         m_knownMediaMessages.insert(message.id, message);
     }
 
@@ -1740,7 +2071,7 @@ void CTelegramDispatcher::processMessageReceived(const TLMessage &message)
         apiMessage.fwdTimestamp = message.fwdDate;
     }
 
-    if ((message.toId.tlType == TLValue::PeerChat) || (messageFlags & TelegramNamespace::MessageFlagOut)) {
+    if ((message.toId->tlType == TLValue::PeerChat) || (messageFlags & TelegramNamespace::MessageFlagOut)) {
         apiMessage.peer = peerToIdentifier(message.toId);
     } else {
         apiMessage.peer = userIdToIdentifier(message.fromId);
@@ -1756,12 +2087,12 @@ void CTelegramDispatcher::processMessageReceived(const TLMessage &message)
     emit messageReceived(apiMessage);
 
 #ifndef TELEGRAMQT_NO_DEPRECATED
-    if (message.toId.tlType == TLValue::PeerUser) {
-        quint32 contactUserId = messageFlags & TelegramNamespace::MessageFlagOut ? message.toId.userId : message.fromId;
+    if (message.toId->tlType == TLValue::PeerUser) {
+        quint32 contactUserId = messageFlags & TelegramNamespace::MessageFlagOut ? message.toId->userId : message.fromId;
         emit messageReceived(userIdToIdentifier(contactUserId),
                              message.message, messageType, message.id, messageFlags, message.date);
     } else {
-        emit chatMessageReceived(telegramChatIdToPublicId(message.toId.chatId), userIdToIdentifier(message.fromId),
+        emit chatMessageReceived(telegramChatIdToPublicId(message.toId->chatId), userIdToIdentifier(message.fromId),
                                  message.message, messageType, message.id, messageFlags, message.date);
     }
 #endif
@@ -1962,7 +2293,7 @@ TLUser *CTelegramDispatcher::identifierToUser(const QString &identifier) const
 
 QString CTelegramDispatcher::userAvatarToken(const TLUser *user) const
 {
-    const TLFileLocation &avatar = user->photo.photoSmall;
+    const TLFileLocation &avatar = user->photo->photoSmall;
 
     if (avatar.tlType == TLValue::FileLocationUnavailable) {
         return QString();
@@ -2001,6 +2332,7 @@ CTelegramConnection *CTelegramDispatcher::getConnection(quint32 dc)
 
         connection = createConnection();
         connection->setDcInfo(dcInfo);
+        connection->setIdleTimeout(s_extraConnectionIdleTimeout);
         m_connections.insert(dc, connection);
     }
 
@@ -2024,22 +2356,24 @@ void CTelegramDispatcher::whenConnectionAuthChanged(int newState, quint32 dc)
                     SLOT(whenContactListReceived(QVector<quint32>)));
             connect(connection, SIGNAL(contactListChanged(QVector<quint32>,QVector<quint32>)),
                     SLOT(whenContactListChanged(QVector<quint32>,QVector<quint32>)));
-            connect(connection, SIGNAL(updatesReceived(TLUpdates)),
-                    SLOT(whenUpdatesReceived(TLUpdates)));
-            connect(connection, SIGNAL(messageSentInfoReceived(TLInputPeer,quint64,TLMessagesSentMessage)),
-                    SLOT(whenMessageSentInfoReceived(TLInputPeer,quint64,TLMessagesSentMessage)));
-            connect(connection, SIGNAL(messagesHistoryReceived(TLMessagesMessages,TLInputPeer)),
-                    SLOT(whenMessagesHistoryReceived(TLMessagesMessages)));
+            connect(connection, SIGNAL(updatesReceived(TLShared<TLUpdates>)),
+                    SLOT(whenUpdatesReceived(TLShared<TLUpdates>)));
+            connect(connection, SIGNAL(messageSentInfoReceived(TLInputPeer,quint64,TLShared<TLMessagesSentMessage>)),
+                    SLOT(whenMessageSentInfoReceived(TLInputPeer,quint64,TLShared<TLMessagesSentMessage>)));
+            connect(connection, SIGNAL(messageSendingFailed(TLInputPeer,quint64)),
+                    SLOT(whenMessageSendingFailed(TLInputPeer,quint64)));
+            connect(connection, SIGNAL(messagesHistoryReceived(TLShared<TLMessagesMessages>,TLInputPeer)),
+                    SLOT(whenMessagesHistoryReceived(TLShared<TLMessagesMessages>)));
             connect(connection, SIGNAL(updatesStateReceived(TLUpdatesState)),
                     SLOT(whenUpdatesStateReceived(TLUpdatesState)));
-            connect(connection, SIGNAL(updatesDifferenceReceived(TLUpdatesDifference)),
-                    SLOT(whenUpdatesDifferenceReceived(TLUpdatesDifference)));
+            connect(connection, SIGNAL(updatesDifferenceReceived(TLUpdatesDifferenceView)),
+                    SLOT(whenUpdatesDifferenceReceived(TLUpdatesDifferenceView)));
             connect(connection, SIGNAL(authExportedAuthorizationReceived(quint32,quint32,QByteArray)),
                     SLOT(whenAuthExportedAuthorizationReceived(quint32,quint32,QByteArray)));
             connect(connection, SIGNAL(messagesChatsReceived(QVector<TLChat>)),
                     SLOT(whenMessagesChatsReceived(QVector<TLChat>)));
-            connect(connection, SIGNAL(messagesFullChatReceived(TLChatFull,QVector<TLChat>,QVector<TLUser>)),
-                    SLOT(whenMessagesFullChatReceived(TLChatFull,QVector<TLChat>,QVector<TLUser>)));
+            connect(connection, SIGNAL(messagesFullChatReceived(TLShared<TLChatFull>,QVector<TLChat>,QVector<TLUser>)),
+                    SLOT(whenMessagesFullChatReceived(TLShared<TLChatFull>,QVector<TLChat>,QVector<TLUser>)));
             connect(connection, SIGNAL(userNameStatusUpdated(QString,TelegramNamespace::AccountUserNameStatus)),
                     SIGNAL(userNameStatusUpdated(QString,TelegramNamespace::AccountUserNameStatus)));
             connect(connection, SIGNAL(loggedOut(bool)),
@@ -2063,6 +2397,10 @@ void CTelegramDispatcher::whenConnectionAuthChanged(int newState, quint32 dc)
         }
     }
 
+    if (newState == CTelegramConnection::AuthStateSignedIn) {
+        m_authorizedConnections.insert(connection);
+    }
+
     if (newState >= CTelegramConnection::AuthStateHaveAKey) {
         if (m_wantedActiveDc == dc) {
             setActiveDc(dc);
@@ -2098,14 +2436,14 @@ void CTelegramDispatcher::whenConnectionStatusChanged(int newStatus, int reason,
                 if (m_autoConnectionDcIndex >= 0) {
                     tryNextDcAddress();
                 } else if (m_autoReconnectionEnabled) {
-                    // Network error; try to reconnect after a second.
-                    QTimer::singleShot(1000, connection, SLOT(connectToDc()));
+                    // Network error; try to reconnect after the backoff delay.
+                    connection->scheduleReconnection();
                 }
             } else {
                 setConnectionState(TelegramNamespace::ConnectionStateDisconnected);
 
                 if (m_autoReconnectionEnabled) {
-                    connection->connectToDc();
+                    connection->scheduleReconnection();
                 }
             }
         } else if (newStatus >= CTelegramConnection::ConnectionStatusConnected) {
@@ -2195,6 +2533,15 @@ void CTelegramDispatcher::whenWantedActiveDcChanged(quint32 dc)
     }
 }
 
+void CTelegramDispatcher::whenFloodWaitReceived(quint64 requestId, quint32 method, quint32 seconds, bool dropped)
+{
+    if (dropped) {
+        qDebug() << Q_FUNC_INFO << "The request" << requestId << TLValue(method).toString() << "is dropped by the flood limit";
+    }
+
+    emit floodWaitReceived(TLValue(method).toString(), seconds);
+}
+
 #ifndef TELEGRAMQT_NO_DEPRECATED
 void CTelegramDispatcher::whenPhoneStatusReceived(const QString &phone, bool registered)
 {
@@ -2226,9 +2573,9 @@ void CTelegramDispatcher::whenFileDataReceived(const TLUploadFile &file, quint32
         if (m_knownMediaMessages.contains(descriptor.messageId())) {
             const TLMessage message = m_knownMediaMessages.value(descriptor.messageId());
             const TelegramNamespace::MessageFlags messageFlags = getPublicMessageFlags(message);
-            const TelegramNamespace::MessageType messageType = telegramMessageTypeToPublicMessageType(message.media.tlType);
+            const TelegramNamespace::MessageType messageType = telegramMessageTypeToPublicMessageType(message.media->tlType);
 
-            quint32 contactUserId = messageFlags & TelegramNamespace::MessageFlagOut ? message.toId.userId : message.fromId;
+            quint32 contactUserId = messageFlags & TelegramNamespace::MessageFlagOut ? message.toId->userId : message.fromId;
 #ifdef DEVELOPER_BUILD
             qDebug() << Q_FUNC_INFO << "MessageMediaData:" << message.id << offset << "-" << offset + chunkSize << "/" << descriptor.size();
 #endif
@@ -2286,8 +2633,10 @@ void CTelegramDispatcher::whenFileDataUploaded(quint32 requestId)
     }
 }
 
-void CTelegramDispatcher::whenUpdatesReceived(const TLUpdates &updates)
+void CTelegramDispatcher::whenUpdatesReceived(const TLShared<TLUpdates> &sharedUpdates)
 {
+    const TLUpdates &updates = *sharedUpdates;
+
 #ifdef DEVELOPER_BUILD
     qDebug() << Q_FUNC_INFO << updates;
 #else
@@ -2313,12 +2662,12 @@ void CTelegramDispatcher::whenUpdatesReceived(const TLUpdates &updates)
         shortMessage.fromId = updates.fromId;
         shortMessage.message = updates.message;
         shortMessage.date = updates.date;
-        shortMessage.media.tlType = TLValue::MessageMediaEmpty;
+        shortMessage.media->tlType = TLValue::MessageMediaEmpty;
 
         int messageActionIndex = 0;
         if (updates.tlType == TLValue::UpdateShortMessage) {
             messageActionIndex = TypingStatus::indexForUser(m_contactsMessageActions, updates.fromId);
-            shortMessage.toId.tlType = TLValue::PeerUser;
+            shortMessage.toId->tlType = TLValue::PeerUser;
 
             if (messageActionIndex >= 0) {
                 emit contactTypingStatusChanged(userIdToIdentifier(updates.fromId),
@@ -2327,8 +2676,8 @@ void CTelegramDispatcher::whenUpdatesReceived(const TLUpdates &updates)
 
         } else {
             messageActionIndex = TypingStatus::indexForUser(m_contactsMessageActions, updates.fromId);
-            shortMessage.toId.tlType = TLValue::PeerChat;
-            shortMessage.toId.chatId = updates.chatId;
+            shortMessage.toId->tlType = TLValue::PeerChat;
+            shortMessage.toId->chatId = updates.chatId;
 
             if (messageActionIndex >= 0) {
                 emit contactChatTypingStatusChanged(telegramChatIdToPublicId(updates.chatId),
@@ -2393,12 +2742,22 @@ void CTelegramDispatcher::setActiveDc(quint32 dc)
         return;
     }
 
+    CTelegramConnection *previousConnection = activeConnection();
+
     m_activeDc = dc;
 
     m_wantedActiveDc = dc;
 
-    if (m_connections.value(dc)) {
-        m_connections.value(dc)->setKeepAliveSettings(m_pingInterval, m_pingServerAdditionDisconnectionTime);
+    CTelegramConnection *connection = m_connections.value(dc);
+
+    if (previousConnection && (previousConnection != connection)) {
+        previousConnection->setKeepAliveSettings(0, 0);
+        previousConnection->setIdleTimeout(s_extraConnectionIdleTimeout);
+    }
+
+    if (connection) {
+        connection->setKeepAliveSettings(m_pingInterval, m_pingServerAdditionDisconnectionTime);
+        connection->setIdleTimeout(0);
     }
 
     qDebug() << Q_FUNC_INFO << dc;
@@ -2431,49 +2790,59 @@ void CTelegramDispatcher::continueInitialization(CTelegramDispatcher::Initializa
         m_requestedSteps |= StepDcConfiguration;
     }
 
-    if (!(m_initializationState & StepDcConfiguration)) { // DC configuration is unknown yet
-        return;
-    }
-
-    if (justDone == StepDcConfiguration) {
-        if (activeConnection()->authState() == CTelegramConnection::AuthStateHaveAKey) {
-            setConnectionState(TelegramNamespace::ConnectionStateAuthRequired);
-        } else {
-            setConnectionState(TelegramNamespace::ConnectionStateConnected);
-        }
-    }
-
-    if ((m_initializationState & StepDcConfiguration) && (m_initializationState & StepSignIn)) {
-        setConnectionState(TelegramNamespace::ConnectionStateAuthenticated);
+    if (m_initializationState & StepSignIn) {
+        // The requests do not depend on the DC configuration, so all of them are sent back to back (and likely
+        // go in one container). The updates state is requested right away too: the server processes it after
+        // the users and contacts requests, so the order is kept without the extra round trips.
+        QList<quint64> usersRequests;
 
         if (!(m_requestedSteps & StepKnowSelf)) {
-            getInitialUsers();
+            usersRequests << getInitialUsers();
             m_requestedSteps |= StepKnowSelf;
         }
 
         if (!(m_requestedSteps & StepContactList)) {
-            getContacts();
+            usersRequests << getContacts();
             m_requestedSteps |= StepContactList;
         }
 
+        if (!(m_requestedSteps & StepUpdates)) {
+            m_requestedSteps |= StepUpdates;
+            activeConnection()->invokeNextRequestAfter(usersRequests);
+            getUpdatesState();
+        }
+
         if (!(m_requestedSteps & StepChatInfo)) {
-            getChatsInfo();
             m_requestedSteps |= StepChatInfo;
+            getChatsInfo(); // Can finish the step right away
         }
     }
 
-    if (m_initializationState == StepDone) {
-        setConnectionState(TelegramNamespace::ConnectionStateReady);
+    if (m_actualStateIsPending && (m_initializationState & StepContactList) && (m_initializationState & StepKnowSelf)) {
+        // We need to know users (contact list and self) info to properly process updates.
+        m_actualStateIsPending = false;
+        checkStateAndCallGetDifference();
+        return; // Continued by the checkStateAndCallGetDifference() call
+    }
+
+    if (!(m_initializationState & StepDcConfiguration)) { // DC configuration is unknown yet
         return;
     }
 
-    if ((m_initializationState & StepContactList) && (m_initializationState & StepKnowSelf)) {
-        // We need to know users (contact list and self) info to properly process updates.
-        if (!(m_requestedSteps & StepUpdates)) {
-            getUpdatesState();
-            m_requestedSteps |= StepUpdates;
+    if (justDone == StepDcConfiguration) {
+        if (activeConnection()->authState() == CTelegramConnection::AuthStateHaveAKey) {
+            setConnectionState(TelegramNamespace::ConnectionStateAuthRequired);
+        } else {
+            setConnectionState(TelegramNamespace::ConnectionStateConnected);
         }
     }
+
+    if (m_initializationState == StepDone) {
+        setConnectionState(TelegramNamespace::ConnectionStateReady);
+        sendQueuedMessages();
+    } else if (m_initializationState & StepSignIn) {
+        setConnectionState(TelegramNamespace::ConnectionStateAuthenticated);
+    }
 }
 
 quint32 CTelegramDispatcher::telegramChatIdToPublicId(quint32 telegramChatId) const
@@ -2501,18 +2870,23 @@ bool CTelegramDispatcher::havePublicChatId(quint32 publicChatId) const
 
 // Basically we just revert Unread and Read flag.
 TelegramNamespace::MessageFlags CTelegramDispatcher::getPublicMessageFlags(const TLMessage &message)
+{
+    return getPublicMessageFlags(message.fromId, message.flags);
+}
+
+TelegramNamespace::MessageFlags CTelegramDispatcher::getPublicMessageFlags(quint32 fromId, quint32 flags)
 {
     TelegramNamespace::MessageFlags result = TelegramNamespace::MessageFlagNone;
 
-    if (message.fromId == m_selfUserId) {
+    if (fromId == m_selfUserId) {
         result |= TelegramNamespace::MessageFlagOut;
     }
 
-    if (message.flags & TelegramMessageFlagForward) {
+    if (flags & TelegramMessageFlagForward) {
         result |= TelegramNamespace::MessageFlagForwarded;
     }
 
-    if (message.flags & TelegramMessageFlagReply) {
+    if (flags & TelegramMessageFlagReply) {
         result |= TelegramNamespace::MessageFlagIsReply;
     }
 
@@ -2564,6 +2938,7 @@ void CTelegramDispatcher::checkStateAndCallGetDifference()
 CTelegramConnection *CTelegramDispatcher::createConnection()
 {
     CTelegramConnection *connection = new CTelegramConnection(m_appInformation, this);
+    connection->setCompressionThreshold(m_compressionThreshold);
 
     connect(connection, SIGNAL(authStateChanged(int,quint32)), SLOT(whenConnectionAuthChanged(int,quint32)));
     connect(connection, SIGNAL(statusChanged(int,int,quint32)), SLOT(whenConnectionStatusChanged(int,int,quint32)));
@@ -2583,6 +2958,7 @@ CTelegramConnection *CTelegramDispatcher::createConnection()
             SIGNAL(authSignErrorReceived(TelegramNamespace::AuthSignError,QString)),
             SIGNAL(authSignErrorReceived(TelegramNamespace::AuthSignError,QString)));
     connect(connection, SIGNAL(authorizationErrorReceived()), SIGNAL(authorizationErrorReceived()));
+    connect(connection, SIGNAL(floodWaitReceived(quint64,quint32,quint32,bool)), SLOT(whenFloodWaitReceived(quint64,quint32,quint32,bool)));
 
     connect(connection, SIGNAL(fileDataReceived(TLUploadFile,quint32,quint32)), SLOT(whenFileDataReceived(TLUploadFile,quint32,quint32)));
 
@@ -23,10 +23,12 @@
 #include <QMap>
 #include <QMultiMap>
 #include <QPair>
+#include <QSet>
 #include <QStringList>
 #include <QVector>
 
 #include "TLTypes.hpp"
+#include "TLViews.hpp"
 #include "TelegramNamespace.hpp"
 
 class QTimer;
@@ -35,6 +37,7 @@ class QIODevice;
 
 class CAppInformation;
 class CTelegramConnection;
+class CTelegramStream;
 
 class FileRequestDescriptor
 {
@@ -76,6 +79,7 @@ public:
     bool isBigFile() const;
     bool finished() const;
     void bumpPart();
+    void abort(); // Releases the data of the canceled request
 
     QByteArray data() const;
 
@@ -130,6 +134,9 @@ public:
     static qint32 localTypingRecommendedRepeatInterval();
 
     inline TelegramNamespace::ConnectionState connectionState() const { return m_connectionState; }
+    qint64 clockOffset() const;
+    quint32 roundTripTime() const;
+    quint32 floodWaitTime() const;
 
     QString selfPhone() const;
 
@@ -145,8 +152,10 @@ public:
     void setMessageReceivingFilter(TelegramNamespace::MessageFlags flags);
     void setAcceptableMessageTypes(TelegramNamespace::MessageTypeFlags types);
     void setAutoReconnection(bool enable);
+    void setSessionResumption(bool enable);
     void setPingInterval(quint32 ms, quint32 serverDisconnectionAdditionTime);
     void setMediaDataBufferSize(quint32 size);
+    void setCompressionThreshold(quint32 size);
 
     bool initConnection(const QVector<TelegramNamespace::DcOption> &dcs);
     bool restoreConnection(const QByteArray &secret);
@@ -160,6 +169,8 @@ public:
     void requestPhoneCode(const QString &phoneNumber);
     void requestContactAvatar(const QString &contact);
     bool requestMessageMediaData(quint32 messageId);
+    bool cancelMessageMediaDataRequest(quint32 messageId);
+    bool cancelFileRequest(quint32 requestId);
     bool getMessageMediaInfo(TelegramNamespace::MessageMediaInfo *messageInfo, quint32 messageId) const;
 
     bool requestHistory(const QString &identifier, quint32 offset, quint32 limit);
@@ -201,6 +212,7 @@ signals:
     void authSignErrorReceived(TelegramNamespace::AuthSignError errorCode, const QString &errorMessage);
     void loggedOut(bool result);
     void authorizationErrorReceived();
+    void floodWaitReceived(const QString &method, quint32 seconds);
     void userNameStatusUpdated(const QString &userName, TelegramNamespace::AccountUserNameStatus status);
     void uploadingStatusUpdated(quint32 requestId, quint32 offset, quint32 size);
 
@@ -235,6 +247,7 @@ protected slots:
     void whenConnectionDcIdUpdated(quint32 connectionId, quint32 newDcId);
     void whenPackageRedirected(const QByteArray &data, quint32 dc);
     void whenWantedActiveDcChanged(quint32 dc);
+    void whenFloodWaitReceived(quint64 requestId, quint32 method, quint32 seconds, bool dropped);
 
 #ifndef TELEGRAMQT_NO_DEPRECATED
     void whenPhoneStatusReceived(const QString &phone, bool registered);
@@ -242,7 +255,7 @@ protected slots:
 
     void whenFileDataReceived(const TLUploadFile &file, quint32 requestId, quint32 offset);
     void whenFileDataUploaded(quint32 requestId);
-    void whenUpdatesReceived(const TLUpdates &updates);
+    void whenUpdatesReceived(const TLShared<TLUpdates> &sharedUpdates);
     void whenAuthExportedAuthorizationReceived(quint32 dc, quint32 id, const QByteArray &data);
 
     void whenUsersReceived(const QVector<TLUser> &users);
@@ -251,20 +264,21 @@ protected slots:
     void whenContactListChanged(const QVector<quint32> &added, const QVector<quint32> &removed);
     void messageActionTimerTimeout();
 
-    void whenMessageSentInfoReceived(const TLInputPeer &peer, quint64 randomId, TLMessagesSentMessage info);
-    void whenMessagesHistoryReceived(const TLMessagesMessages &messages);
+    void whenMessageSentInfoReceived(const TLInputPeer &peer, quint64 randomId, const TLShared<TLMessagesSentMessage> &info);
+    void whenMessageSendingFailed(const TLInputPeer &peer, quint64 randomId);
+    void whenMessagesHistoryReceived(const TLShared<TLMessagesMessages> &messages);
 
     void getDcConfiguration();
-    void getContacts();
+    quint64 getContacts();
     void getChatsInfo();
     void getUpdatesState();
     void whenUpdatesStateReceived(const TLUpdatesState &updatesState);
 
     void getDifference();
-    void whenUpdatesDifferenceReceived(const TLUpdatesDifference &updatesDifference);
+    void whenUpdatesDifferenceReceived(const TLUpdatesDifferenceView &updatesDifference);
 
     void whenMessagesChatsReceived(const QVector<TLChat> &chats);
-    void whenMessagesFullChatReceived(const TLChatFull &chat, const QVector<TLChat> &chats, const QVector<TLUser> &users);
+    void whenMessagesFullChatReceived(const TLShared<TLChatFull> &chat, const QVector<TLChat> &chats, const QVector<TLUser> &users);
 
 protected:
     void setConnectionState(TelegramNamespace::ConnectionState state);
@@ -282,7 +296,7 @@ protected:
     void initConnectionSharedFinal(quint32 activeDc = 0);
 
     void getUser(quint32 id);
-    void getInitialUsers();
+    quint64 getInitialUsers();
 
     bool filterReceivedMessage(quint32 messageFlags) const;
 
@@ -304,6 +318,10 @@ protected:
     CTelegramConnection *getConnection(quint32 dc);
 
     CTelegramConnection *createConnection();
+    QByteArray connectionRecord(const CTelegramConnection *connection) const;
+    CTelegramConnection *restoreConnectionRecord(const QByteArray &record);
+    bool isAuthorizedConnection(const CTelegramConnection *connection) const;
+    bool restoreLegacyConnection(CTelegramStream &inputStream, quint32 format);
     void ensureSignedConnection(CTelegramConnection *connection);
 
     TLDcOption dcInfoById(quint32 dc) const;
@@ -324,6 +342,10 @@ protected:
     bool havePublicChatId(quint32 publicChatId) const;
 
     TelegramNamespace::MessageFlags getPublicMessageFlags(const TLMessage &message);
+    TelegramNamespace::MessageFlags getPublicMessageFlags(quint32 fromId, quint32 flags);
+
+    quint64 sendMessageNow(const QString &identifier, const QString &message, quint64 randomMessageId);
+    void sendQueuedMessages();
 
     struct TypingStatus {
         TypingStatus() : chatId(0), userId(0),
@@ -359,6 +381,14 @@ protected:
         }
     };
 
+    struct QueuedMessage {
+        QueuedMessage() : randomId(0) { }
+
+        QString identifier;
+        QString message;
+        quint64 randomId;
+    };
+
     TelegramNamespace::ConnectionState m_connectionState;
 
     const CAppInformation *m_appInformation;
@@ -366,9 +396,11 @@ protected:
     quint32 m_messageReceivingFilterFlags;
     quint32 m_acceptableMessageTypes;
     bool m_autoReconnectionEnabled;
+    bool m_sessionResumptionEnabled;
     quint32 m_pingInterval;
     quint32 m_pingServerAdditionDisconnectionTime;
     quint32 m_mediaDataBufferSize;
+    quint32 m_compressionThreshold;
 
     quint32 m_initializationState; // InitializationStep flags
     quint32 m_requestedSteps; // InitializationStep flags
@@ -380,10 +412,12 @@ protected:
     QVector<TelegramNamespace::DcOption> m_connectionAddresses;
     QVector<TLDcOption> m_dcConfiguration;
     QMap<quint32, CTelegramConnection *> m_connections;
+    QSet<const CTelegramConnection *> m_authorizedConnections; // The auth key is signed in or imported
 
     TLUpdatesState m_updatesState; // Current application update state (may be older than actual server-side message box state)
     TLUpdatesState m_actualState; // State reported by server as actual
     bool m_updatesStateIsLocked; // True if we are (going to) getting updatesDifference.
+    bool m_actualStateIsPending; // The state is received before the users, which are needed to process the difference.
     bool m_emitOnlyIncomingUnreadMessages;
 
     QMap<quint32, QPair<quint32,QByteArray> > m_exportedAuthentications; // dc, <id, auth data>
@@ -391,6 +425,7 @@ protected:
     QMap<quint32, TLUser*> m_users;
 
     QMap<quint32, QPair<QString, quint64> >m_messagesMap; // message id to phone and big_random message id
+    QList<QueuedMessage> m_queuedMessages; // Sent before the connection is ready (the contacts are not known yet)
 
     QMap<quint32, TLMessage> m_knownMediaMessages; // message id, message
 
@@ -20,8 +20,14 @@
 #include <QtEndian>
 
 #include <QIODevice>
+#include <QVarLengthArray>
 #include <QDebug>
 
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define TELEGRAMQT_UTF8_SSE2
+#endif
+
 static const char s_nulls[4] = { 0, 0, 0, 0 };
 
 template CTelegramStream &CTelegramStream::operator>>(TLVector<qint32> &v);
@@ -63,6 +69,8 @@ template CTelegramStream &CTelegramStream::operator>>(TLVector<TLDialog> &v);
 template CTelegramStream &CTelegramStream::operator>>(TLVector<TLMessage> &v);
 template CTelegramStream &CTelegramStream::operator>>(TLVector<TLUpdate> &v);
 template CTelegramStream &CTelegramStream::operator>>(TLVector<TLEncryptedMessage> &v);
+template CTelegramStream &CTelegramStream::operator>>(TLVector<TLWallPaper> &v);
+template CTelegramStream &CTelegramStream::operator>>(TLVector<TLContactStatus> &v);
 // End of generated vector read templates instancing
 
 // Generated vector write templates instancing
@@ -74,6 +82,150 @@ template CTelegramStream &CTelegramStream::operator<<(const TLVector<TLInputPhot
 template CTelegramStream &CTelegramStream::operator<<(const TLVector<TLDocumentAttribute> &v);
 // End of generated vector write templates instancing
 template CTelegramStream &CTelegramStream::operator<<(const TLVector<TLDcOption> &v);
+template CTelegramStream &CTelegramStream::operator>>(TLVector<TLFutureSalt> &v);
+template CTelegramStream &CTelegramStream::operator<<(const TLVector<TLFutureSalt> &v);
+
+// Decodes UTF-8 straight into the UTF-16 buffer (which should have space for the size units).
+// Stops at the first NUL character, like QString::fromUtf8(const QByteArray &).
+// Returns the number of the written units or -1, if the data is not a strictly valid UTF-8
+// (the caller should fall back to Qt conversion then, to get the same replacement characters).
+static int utf8ToUtf16(const uchar *src, int size, ushort *dst)
+{
+    const uchar *end = src + size;
+    const ushort *start = dst;
+
+    while (src < end) {
+#ifdef TELEGRAMQT_UTF8_SSE2
+        // ASCII fast path: 16 characters at once
+        const __m128i zero = _mm_setzero_si128();
+
+        while (end - src >= 16) {
+            const __m128i chunk = _mm_loadu_si128((const __m128i *) src);
+
+            if (_mm_movemask_epi8(chunk) | _mm_movemask_epi8(_mm_cmpeq_epi8(chunk, zero))) {
+                break; // Non-ASCII or NUL character
+            }
+
+            _mm_storeu_si128((__m128i *) dst, _mm_unpacklo_epi8(chunk, zero));
+            _mm_storeu_si128((__m128i *) (dst + 8), _mm_unpackhi_epi8(chunk, zero));
+            src += 16;
+            dst += 16;
+        }
+
+        if (src == end) {
+            break;
+        }
+#endif
+        const uint c = *src;
+
+        if (c < 0x80) {
+            if (!c) {
+                break;
+            }
+
+            *dst++ = c;
+            ++src;
+        } else if ((c >= 0xc2) && (c <= 0xdf)) {
+            if ((end - src < 2) || ((src[1] & 0xc0) != 0x80)) {
+                return -1;
+            }
+
+            *dst++ = ((c & 0x1f) << 6) | (src[1] & 0x3f);
+            src += 2;
+        } else if ((c >= 0xe0) && (c <= 0xef)) {
+            if ((end - src < 3) || ((src[1] & 0xc0) != 0x80) || ((src[2] & 0xc0) != 0x80)) {
+                return -1;
+            }
+
+            const uint u = ((c & 0x0f) << 12) | ((src[1] & 0x3f) << 6) | (src[2] & 0x3f);
+
+            // Overlong forms, surrogates and BOM (Qt may skip it)
+            if ((u < 0x800) || ((u >= 0xd800) && (u <= 0xdfff)) || (u == 0xfeff)) {
+                return -1;
+            }
+
+            *dst++ = u;
+            src += 3;
+        } else if ((c >= 0xf0) && (c <= 0xf4)) {
+            if ((end - src < 4) || ((src[1] & 0xc0) != 0x80) || ((src[2] & 0xc0) != 0x80) || ((src[3] & 0xc0) != 0x80)) {
+                return -1;
+            }
+
+            const uint u = ((c & 0x07) << 18) | ((src[1] & 0x3f) << 12) | ((src[2] & 0x3f) << 6) | (src[3] & 0x3f);
+
+            if ((u < 0x10000) || (u > 0x10ffff)) {
+                return -1;
+            }
+
+            *dst++ = QChar::highSurrogate(u);
+            *dst++ = QChar::lowSurrogate(u);
+            src += 4;
+        } else {
+            return -1;
+        }
+    }
+
+    return dst - start;
+}
+
+// Encodes UTF-16 to UTF-8 (the buffer should have space for 3 * size bytes).
+// Returns the number of the written bytes or -1, if the string has unpaired surrogates
+// (the caller should fall back to Qt conversion then).
+static int utf16ToUtf8(const ushort *src, int size, uchar *dst)
+{
+    const ushort *end = src + size;
+    const uchar *start = dst;
+
+    while (src < end) {
+#ifdef TELEGRAMQT_UTF8_SSE2
+        // ASCII fast path: 8 characters at once
+        const __m128i nonAsciiMask = _mm_set1_epi16(short(0xff80));
+        const __m128i zero = _mm_setzero_si128();
+
+        while (end - src >= 8) {
+            const __m128i chunk = _mm_loadu_si128((const __m128i *) src);
+
+            if (_mm_movemask_epi8(_mm_cmpeq_epi16(_mm_and_si128(chunk, nonAsciiMask), zero)) != 0xffff) {
+                break;
+            }
+
+            _mm_storel_epi64((__m128i *) dst, _mm_packus_epi16(chunk, chunk));
+            src += 8;
+            dst += 8;
+        }
+
+        if (src == end) {
+            break;
+        }
+#endif
+        const uint u = *src;
+
+        if (u < 0x80) {
+            *dst++ = u;
+            ++src;
+        } else if (u < 0x800) {
+            *dst++ = 0xc0 | (u >> 6);
+            *dst++ = 0x80 | (u & 0x3f);
+            ++src;
+        } else if ((u < 0xd800) || (u > 0xdfff)) {
+            *dst++ = 0xe0 | (u >> 12);
+            *dst++ = 0x80 | ((u >> 6) & 0x3f);
+            *dst++ = 0x80 | (u & 0x3f);
+            ++src;
+        } else if (QChar::isHighSurrogate(u) && (end - src >= 2) && QChar::isLowSurrogate(src[1])) {
+            const uint ucs4 = QChar::surrogateToUcs4(u, src[1]);
+            *dst++ = 0xf0 | (ucs4 >> 18);
+            *dst++ = 0x80 | ((ucs4 >> 12) & 0x3f);
+            *dst++ = 0x80 | ((ucs4 >> 6) & 0x3f);
+            *dst++ = 0x80 | (ucs4 & 0x3f);
+            src += 2;
+        } else {
+            return -1;
+        }
+    }
+
+    return dst - start;
+}
 
 CTelegramStream::CTelegramStream(QByteArray *data, bool write) :
     CRawStream(data, write)
@@ -87,6 +239,12 @@ CTelegramStream::CTelegramStream(const QByteArray &data) :
 
 }
 
+CTelegramStream::CTelegramStream(const char *data, int size) :
+    CRawStream(data, size)
+{
+
+}
+
 CTelegramStream::CTelegramStream(QIODevice *d) :
     CRawStream(d)
 {
@@ -95,443 +253,472 @@ CTelegramStream::CTelegramStream(QIODevice *d) :
 
 CTelegramStream &CTelegramStream::operator>>(QByteArray &data)
 {
-    quint32 length = 0;
-    read(&length, 1);
+    // The only copy of the bytes: from the packet to the implicitly shared result.
+    // For a memory block the length is bounded by the available data, so a broken length does not lead to a huge allocation.
+    quint32 paddingSize = 0;
+    data = readBytes(readByteArrayLength(&paddingSize));
+    skipBytes(paddingSize);
 
-    if (length < 0xfe) {
-        data.resize(length);
-        length += 1; // Plus one byte before data
-    } else {
-        read(&length, 3);
-        data.resize(length);
-        length += 4; // Plus four bytes before data
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::operator>>(QString &str)
+{
+    const QByteArray data = readByteArrayView();
+
+    if (data.isEmpty()) {
+        str = QString();
+        return *this;
     }
 
-    read(data.data(), data.size());
+    // The UTF-8 string never has less bytes than UTF-16 units.
+    QString result;
+    result.resize(data.size());
 
-    if (length & 3) {
-        readBytes(4 - (length & 3));
+    const int length = utf8ToUtf16((const uchar *) data.constData(), data.size(), (ushort *) result.data());
+
+    if (length < 0) {
+        str = QString::fromUtf8(data);
+    } else {
+        result.resize(length);
+        str = result;
     }
 
     return *this;
 }
 
+QByteArray CTelegramStream::readByteArrayView()
+{
+    quint32 paddingSize = 0;
+    const QByteArray data = readBytesView(readByteArrayLength(&paddingSize));
+    skipBytes(paddingSize);
+
+    return data;
+}
+
+quint32 CTelegramStream::readByteArrayLength(quint32 *paddingSize)
+{
+    quint32 length = 0;
+    read(&length, 1);
+
+    quint32 totalLength = length + 1; // Plus one byte before data
+
+    if (length >= 0xfe) {
+        length = 0;
+        read(&length, 3);
+        totalLength = length + 4; // Plus four bytes before data
+    }
+
+    *paddingSize = (4 - (totalLength & 3)) & 3;
+
+    return length;
+}
+
 template <typename T>
 CTelegramStream &CTelegramStream::operator>>(TLVector<T> &v)
 {
-    TLVector<T> result;
+    *this >> v.tlType;
 
-    *this >> result.tlType;
+    quint32 length = 0;
 
-    if (result.tlType == TLValue::Vector) {
-        quint32 length = 0;
+    if (v.tlType == TLValue::Vector) {
         *this >> length;
-        for (quint32 i = 0; i < length; ++i) {
-            T value;
-            *this >> value;
-            result.append(value);
+
+        // Any element takes at least four bytes, so a broken length can not lead to a huge allocation.
+        if (length > quint32(bytesRemaining()) / 4) {
+            skipBytes(bytesRemaining() + 1); // Read past the end to set the stream error.
+            length = 0;
         }
     }
 
-    v = result;
+    // The elements are read in place, without a temporary value and its copy to the vector.
+    v.resize(length);
+
+    if (length) {
+        T *data = v.data();
+
+        if (TLVectorTraits<T>::IsPod) {
+            read(data, length * sizeof(T)); // Bounds-checked: a short read sets the stream error.
+        } else {
+            for (quint32 i = 0; i < length; ++i) {
+                *this >> data[i];
+            }
+        }
+    }
+
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::operator>>(TLFutureSalt &futureSalt)
+{
+    *this >> futureSalt.validSince;
+    *this >> futureSalt.validUntil;
+    *this >> futureSalt.salt;
+
     return *this;
 }
 
 // Generated read operators implementation
 CTelegramStream &CTelegramStream::operator>>(TLAccountDaysTTL &accountDaysTTL)
 {
-    TLAccountDaysTTL result;
+    accountDaysTTL = TLAccountDaysTTL();
 
-    *this >> result.tlType;
+    *this >> accountDaysTTL.tlType;
 
-    switch (result.tlType) {
+    switch (accountDaysTTL.tlType) {
     case TLValue::AccountDaysTTL:
-        *this >> result.days;
+        *this >> accountDaysTTL.days;
         break;
     default:
         break;
     }
 
-    accountDaysTTL = result;
-
     return *this;
 }
 
 CTelegramStream &CTelegramStream::operator>>(TLAccountPassword &accountPassword)
 {
-    TLAccountPassword result;
+    accountPassword = TLAccountPassword();
 
-    *this >> result.tlType;
+    *this >> accountPassword.tlType;
 
-    switch (result.tlType) {
+    switch (accountPassword.tlType) {
     case TLValue::AccountNoPassword:
-        *this >> result.newSalt;
-        *this >> result.emailUnconfirmedPattern;
+        *this >> accountPassword.newSalt;
+        *this >> accountPassword.emailUnconfirmedPattern;
         break;
     case TLValue::AccountPassword:
-        *this >> result.currentSalt;
-        *this >> result.newSalt;
-        *this >> result.hint;
-        *this >> result.hasRecovery;
-        *this >> result.emailUnconfirmedPattern;
+        *this >> accountPassword.currentSalt;
+        *this >> accountPassword.newSalt;
+        *this >> accountPassword.hint;
+        *this >> accountPassword.hasRecovery;
+        *this >> accountPassword.emailUnconfirmedPattern;
         break;
     default:
         break;
     }
 
-    accountPassword = result;
-
     return *this;
 }
 
 CTelegramStream &CTelegramStream::operator>>(TLAccountPasswordInputSettings &accountPasswordInputSettings)
 {
-    TLAccountPasswordInputSettings result;
+    accountPasswordInputSettings = TLAccountPasswordInputSettings();
 
-    *this >> result.tlType;
+    *this >> accountPasswordInputSettings.tlType;
 
-    switch (result.tlType) {
+    switch (accountPasswordInputSettings.tlType) {
     case TLValue::AccountPasswordInputSettings:
-        *this >> result.flags;
-        if (result.flags & 1 << 0) {
-            *this >> result.newSalt;
+        *this >> accountPasswordInputSettings.flags;
+        if (accountPasswordInputSettings.flags & 1 << 0) {
+            *this >> accountPasswordInputSettings.newSalt;
         }
-        if (result.flags & 1 << 0) {
-            *this >> result.newPasswordHash;
+        if (accountPasswordInputSettings.flags & 1 << 0) {
+            *this >> accountPasswordInputSettings.newPasswordHash;
         }
-        if (result.flags & 1 << 0) {
-            *this >> result.hint;
+        if (accountPasswordInputSettings.flags & 1 << 0) {
+            *this >> accountPasswordInputSettings.hint;
         }
-        if (result.flags & 1 << 1) {
-            *this >> result.email;
+        if (accountPasswordInputSettings.flags & 1 << 1) {
+            *this >> accountPasswordInputSettings.email;
         }
         break;
     default:
         break;
     }
 
-    accountPasswordInputSettings = result;
-
     return *this;
 }
 
 CTelegramStream &CTelegramStream::operator>>(TLAccountPasswordSettings &accountPasswordSettings)
 {
-    TLAccountPasswordSettings result;
+    accountPasswordSettings = TLAccountPasswordSettings();
 
-    *this >> result.tlType;
+    *this >> accountPasswordSettings.tlType;
 
-    switch (result.tlType) {
+    switch (accountPasswordSettings.tlType) {
     case TLValue::AccountPasswordSettings:
-        *this >> result.email;
+        *this >> accountPasswordSettings.email;
         break;
     default:
         break;
     }
 
-    accountPasswordSettings = result;
-
     return *this;
 }
 
 CTelegramStream &CTelegramStream::operator>>(TLAccountSentChangePhoneCode &accountSentChangePhoneCode)
 {
-    TLAccountSentChangePhoneCode result;
+    accountSentChangePhoneCode = TLAccountSentChangePhoneCode();
 
-    *this >> result.tlType;
+    *this >> accountSentChangePhoneCode.tlType;
 
-    switch (result.tlType) {
+    switch (accountSentChangePhoneCode.tlType) {
     case TLValue::AccountSentChangePhoneCode:
-        *this >> result.phoneCodeHash;
-        *this >> result.sendCallTimeout;
+        *this >> accountSentChangePhoneCode.phoneCodeHash;
+        *this >> accountSentChangePhoneCode.sendCallTimeout;
         break;
     default:
         break;
     }
 
-    accountSentChangePhoneCode = result;
-
     return *this;
 }
 
 CTelegramStream &CTelegramStream::operator>>(TLAudio &audio)
 {
-    TLAudio result;
+    audio = TLAudio();
 
-    *this >> result.tlType;
+    *this >> audio.tlType;
 
-    switch (result.tlType) {
+    switch (audio.tlType) {
     case TLValue::AudioEmpty:
-        *this >> result.id;
+        *this >> audio.id;
         break;
     case TLValue::Audio:
-        *this >> result.id;
-        *this >> result.accessHash;
-        *this >> result.userId;
-        *this >> result.date;
-        *this >> result.duration;
-        *this >> result.mimeType;
-        *this >> result.size;
-        *this >> result.dcId;
+        *this >> audio.id;
+        *this >> audio.accessHash;
+        *this >> audio.userId;
+        *this >> audio.date;
+        *this >> audio.duration;
+        *this >> audio.mimeType;
+        *this >> audio.size;
+        *this >> audio.dcId;
         break;
     default:
         break;
     }
 
-    audio = result;
-
     return *this;
 }
 
 CTelegramStream &CTelegramStream::operator>>(TLAuthCheckedPhone &authCheckedPhone)
 {
-    TLAuthCheckedPhone result;
+    authCheckedPhone = TLAuthCheckedPhone();
 
-    *this >> result.tlType;
+    *this >> authCheckedPhone.tlType;
 
-    switch (result.tlType) {
+    switch (authCheckedPhone.tlType) {
     case TLValue::AuthCheckedPhone:
-        *this >> result.phoneRegistered;
+        *this >> authCheckedPhone.phoneRegistered;
         break;
     default:
         break;
     }
 
-    authCheckedPhone = result;
-
     return *this;
 }
 
 CTelegramStream &CTelegramStream::operator>>(TLAuthExportedAuthorization &authExportedAuthorization)
 {
-    TLAuthExportedAuthorization result;
+    authExportedAuthorization = TLAuthExportedAuthorization();
 
-    *this >> result.tlType;
+    *this >> authExportedAuthorization.tlType;
 
-    switch (result.tlType) {
+    switch (authExportedAuthorization.tlType) {
     case TLValue::AuthExportedAuthorization:
-        *this >> result.id;
-        *this >> result.bytes;
+        *this >> authExportedAuthorization.id;
+        *this >> authExportedAuthorization.bytes;
         break;
     default:
         break;
     }
 
-    authExportedAuthorization = result;
-
     return *this;
 }
 
 CTelegramStream &CTelegramStream::operator>>(TLAuthPasswordRecovery &authPasswordRecovery)
 {
-    TLAuthPasswordRecovery result;
+    authPasswordRecovery = TLAuthPasswordRecovery();
 
-    *this >> result.tlType;
+    *this >> authPasswordRecovery.tlType;
 
-    switch (result.tlType) {
+    switch (authPasswordRecovery.tlType) {
     case TLValue::AuthPasswordRecovery:
-        *this >> result.emailPattern;
+        *this >> authPasswordRecovery.emailPattern;
         break;
     default:
         break;
     }
 
-    authPasswordRecovery = result;
-
     return *this;
 }
 
 CTelegramStream &CTelegramStream::operator>>(TLAuthSentCode &authSentCode)
 {
-    TLAuthSentCode result;
+    authSentCode = TLAuthSentCode();
 
-    *this >> result.tlType;
+    *this >> authSentCode.tlType;
 
-    switch (result.tlType) {
+    switch (authSentCode.tlType) {
     case TLValue::AuthSentCode:
-        *this >> result.phoneRegistered;
-        *this >> result.phoneCodeHash;
-        *this >> result.sendCallTimeout;
-        *this >> result.isPassword;
+        *this >> authSentCode.phoneRegistered;
+        *this >> authSentCode.phoneCodeHash;
+        *this >> authSentCode.sendCallTimeout;
+        *this >> authSentCode.isPassword;
         break;
     case TLValue::AuthSentAppCode:
-        *this >> result.phoneRegistered;
-        *this >> result.phoneCodeHash;
-        *this >> result.sendCallTimeout;
-        *this >> result.isPassword;
+        *this >> authSentCode.phoneRegistered;
+        *this >> authSentCode.phoneCodeHash;
+        *this >> authSentCode.sendCallTimeout;
+        *this >> authSentCode.isPassword;
         break;
     default:
         break;
     }
 
-    authSentCode = result;
-
     return *this;
 }
 
 CTelegramStream &CTelegramStream::operator>>(TLAuthorization &authorization)
 {
-    TLAuthorization result;
+    authorization = TLAuthorization();
 
-    *this >> result.tlType;
+    *this >> authorization.tlType;
 
-    switch (result.tlType) {
+    switch (authorization.tlType) {
     case TLValue::Authorization:
-        *this >> result.hash;
-        *this >> result.flags;
-        *this >> result.deviceModel;
-        *this >> result.platform;
-        *this >> result.systemVersion;
-        *this >> result.apiId;
-        *this >> result.appName;
-        *this >> result.appVersion;
-        *this >> result.dateCreated;
-        *this >> result.dateActive;
-        *this >> result.ip;
-        *this >> result.country;
-        *this >> result.region;
+        *this >> authorization.hash;
+        *this >> authorization.flags;
+        *this >> authorization.deviceModel;
+        *this >> authorization.platform;
+        *this >> authorization.systemVersion;
+        *this >> authorization.apiId;
+        *this >> authorization.appName;
+        *this >> authorization.appVersion;
+        *this >> authorization.dateCreated;
+        *this >> authorization.dateActive;
+        *this >> authorization.ip;
+        *this >> authorization.country;
+        *this >> authorization.region;
         break;
     default:
         break;
     }
 
-    authorization = result;
-
     return *this;
 }
 
 CTelegramStream &CTelegramStream::operator>>(TLChatLocated &chatLocated)
 {
-    TLChatLocated result;
+    chatLocated = TLChatLocated();
 
-    *this >> result.tlType;
+    *this >> chatLocated.tlType;
 
-    switch (result.tlType) {
+    switch (chatLocated.tlType) {
     case TLValue::ChatLocated:
-        *this >> result.chatId;
-        *this >> result.distance;
+        *this >> chatLocated.chatId;
+        *this >> chatLocated.distance;
         break;
     default:
         break;
     }
 
-    chatLocated = result;
-
     return *this;
 }
 
 CTelegramStream &CTelegramStream::operator>>(TLChatParticipant &chatParticipant)
 {
-    TLChatParticipant result;
+    chatParticipant = TLChatParticipant();
 
-    *this >> result.tlType;
+    *this >> chatParticipant.tlType;
 
-    switch (result.tlType) {
+    switch (chatParticipant.tlType) {
     case TLValue::ChatParticipant:
-        *this >> result.userId;
-        *this >> result.inviterId;
-        *this >> result.date;
+        *this >> chatParticipant.userId;
+        *this >> chatParticipant.inviterId;
+        *this >> chatParticipant.date;
         break;
     default:
         break;
     }
 
-    chatParticipant = result;
-
     return *this;
 }
 
 CTelegramStream &CTelegramStream::operator>>(TLChatParticipants &chatParticipants)
 {
-    TLChatParticipants result;
+    chatParticipants = TLChatParticipants();
 
-    *this >> result.tlType;
+    *this >> chatParticipants.tlType;
 
-    switch (result.tlType) {
+    switch (chatParticipants.tlType) {
     case TLValue::ChatParticipantsForbidden:
-        *this >> result.chatId;
+        *this >> chatParticipants.chatId;
         break;
     case TLValue::ChatParticipants:
-        *this >> result.chatId;
-        *this >> result.adminId;
-        *this >> result.participants;
-        *this >> result.version;
+        *this >> chatParticipants.chatId;
+        *this >> chatParticipants.adminId;
+        *this >> chatParticipants.participants;
+        *this >> chatParticipants.version;
         break;
     default:
         break;
     }
 
-    chatParticipants = result;
-
     return *this;
 }
 
 CTelegramStream &CTelegramStream::operator>>(TLContact &contact)
 {
-    TLContact result;
+    contact = TLContact();
 
-    *this >> result.tlType;
+    *this >> contact.tlType;
 
-    switch (result.tlType) {
+    switch (contact.tlType) {
     case TLValue::Contact:
-        *this >> result.userId;
-        *this >> result.mutual;
+        *this >> contact.userId;
+        *this >> contact.mutual;
         break;
     default:
         break;
     }
 
-    contact = result;
-
     return *this;
 }
 
 CTelegramStream &CTelegramStream::operator>>(TLContactBlocked &contactBlocked)
 {
-    TLContactBlocked result;
+    contactBlocked = TLContactBlocked();
 
-    *this >> result.tlType;
+    *this >> contactBlocked.tlType;
 
-    switch (result.tlType) {
+    switch (contactBlocked.tlType) {
     case TLValue::ContactBlocked:
-        *this >> result.userId;
-        *this >> result.date;
+        *this >> contactBlocked.userId;
+        *this >> contactBlocked.date;
         break;
     default:
         break;
     }
 
-    contactBlocked = result;
-
     return *this;
 }
 
 CTelegramStream &CTelegramStream::operator>>(TLContactFound &contactFound)
 {
-    TLContactFound result;
+    contactFound = TLContactFound();
 
-    *this >> result.tlType;
+    *this >> contactFound.tlType;
 
-    switch (result.tlType) {
+    switch (contactFound.tlType) {
     case TLValue::ContactFound:
-        *this >> result.userId;
+        *this >> contactFound.userId;
         break;
     default:
         break;
     }
 
-    contactFound = result;
-
     return *this;
 }
 
 CTelegramStream &CTelegramStream::operator>>(TLContactLink &contactLink)
 {
-    TLContactLink result;
+    contactLink = TLContactLink();
 
-    *this >> result.tlType;
+    *this >> contactLink.tlType;
 
-    switch (result.tlType) {
+    switch (contactLink.tlType) {
     case TLValue::ContactLinkUnknown:
         break;
     case TLValue::ContactLinkNone:
@@ -544,275 +731,253 @@ CTelegramStream &CTelegramStream::operator>>(TLContactLink &contactLink)
         break;
     }
 
-    contactLink = result;
-
     return *this;
 }
 
 CTelegramStream &CTelegramStream::operator>>(TLContactSuggested &contactSuggested)
 {
-    TLContactSuggested result;
+    contactSuggested = TLContactSuggested();
 
-    *this >> result.tlType;
+    *this >> contactSuggested.tlType;
 
-    switch (result.tlType) {
+    switch (contactSuggested.tlType) {
     case TLValue::ContactSuggested:
-        *this >> result.userId;
-        *this >> result.mutualContacts;
+        *this >> contactSuggested.userId;
+        *this >> contactSuggested.mutualContacts;
         break;
     default:
         break;
     }
 
-    contactSuggested = result;
-
     return *this;
 }
 
 CTelegramStream &CTelegramStream::operator>>(TLDcOption &dcOption)
 {
-    TLDcOption result;
+    dcOption = TLDcOption();
 
-    *this >> result.tlType;
+    *this >> dcOption.tlType;
 
-    switch (result.tlType) {
+    switch (dcOption.tlType) {
     case TLValue::DcOption:
-        *this >> result.id;
-        *this >> result.hostname;
-        *this >> result.ipAddress;
-        *this >> result.port;
+        *this >> dcOption.id;
+        *this >> dcOption.hostname;
+        *this >> dcOption.ipAddress;
+        *this >> dcOption.port;
         break;
     default:
         break;
     }
 
-    dcOption = result;
-
     return *this;
 }
 
 CTelegramStream &CTelegramStream::operator>>(TLDisabledFeature &disabledFeature)
 {
-    TLDisabledFeature result;
+    disabledFeature = TLDisabledFeature();
 
-    *this >> result.tlType;
+    *this >> disabledFeature.tlType;
 
-    switch (result.tlType) {
+    switch (disabledFeature.tlType) {
     case TLValue::DisabledFeature:
-        *this >> result.feature;
-        *this >> result.description;
+        *this >> disabledFeature.feature;
+        *this >> disabledFeature.description;
         break;
     default:
         break;
     }
 
-    disabledFeature = result;
-
     return *this;
 }
 
 CTelegramStream &CTelegramStream::operator>>(TLEncryptedChat &encryptedChat)
 {
-    TLEncryptedChat result;
+    encryptedChat = TLEncryptedChat();
 
-    *this >> result.tlType;
+    *this >> encryptedChat.tlType;
 
-    switch (result.tlType) {
+    switch (encryptedChat.tlType) {
     case TLValue::EncryptedChatEmpty:
-        *this >> result.id;
+        *this >> encryptedChat.id;
         break;
     case TLValue::EncryptedChatWaiting:
-        *this >> result.id;
-        *this >> result.accessHash;
-        *this >> result.date;
-        *this >> result.adminId;
-        *this >> result.participantId;
+        *this >> encryptedChat.id;
+        *this >> encryptedChat.accessHash;
+        *this >> encryptedChat.date;
+        *this >> encryptedChat.adminId;
+        *this >> encryptedChat.participantId;
         break;
     case TLValue::EncryptedChatRequested:
-        *this >> result.id;
-        *this >> result.accessHash;
-        *this >> result.date;
-        *this >> result.adminId;
-        *this >> result.participantId;
-        *this >> result.gA;
+        *this >> encryptedChat.id;
+        *this >> encryptedChat.accessHash;
+        *this >> encryptedChat.date;
+        *this >> encryptedChat.adminId;
+        *this >> encryptedChat.participantId;
+        *this >> encryptedChat.gA;
         break;
     case TLValue::EncryptedChat:
-        *this >> result.id;
-        *this >> result.accessHash;
-        *this >> result.date;
-        *this >> result.adminId;
-        *this >> result.participantId;
-        *this >> result.gAOrB;
-        *this >> result.keyFingerprint;
+        *this >> encryptedChat.id;
+        *this >> encryptedChat.accessHash;
+        *this >> encryptedChat.date;
+        *this >> encryptedChat.adminId;
+        *this >> encryptedChat.participantId;
+        *this >> encryptedChat.gAOrB;
+        *this >> encryptedChat.keyFingerprint;
         break;
     case TLValue::EncryptedChatDiscarded:
-        *this >> result.id;
+        *this >> encryptedChat.id;
         break;
     default:
         break;
     }
 
-    encryptedChat = result;
-
     return *this;
 }
 
 CTelegramStream &CTelegramStream::operator>>(TLEncryptedFile &encryptedFile)
 {
-    TLEncryptedFile result;
+    encryptedFile = TLEncryptedFile();
 
-    *this >> result.tlType;
+    *this >> encryptedFile.tlType;
 
-    switch (result.tlType) {
+    switch (encryptedFile.tlType) {
     case TLValue::EncryptedFileEmpty:
         break;
     case TLValue::EncryptedFile:
-        *this >> result.id;
-        *this >> result.accessHash;
-        *this >> result.size;
-        *this >> result.dcId;
-        *this >> result.keyFingerprint;
+        *this >> encryptedFile.id;
+        *this >> encryptedFile.accessHash;
+        *this >> encryptedFile.size;
+        *this >> encryptedFile.dcId;
+        *this >> encryptedFile.keyFingerprint;
         break;
     default:
         break;
     }
 
-    encryptedFile = result;
-
     return *this;
 }
 
 CTelegramStream &CTelegramStream::operator>>(TLEncryptedMessage &encryptedMessage)
 {
-    TLEncryptedMessage result;
+    encryptedMessage = TLEncryptedMessage();
 
-    *this >> result.tlType;
+    *this >> encryptedMessage.tlType;
 
-    switch (result.tlType) {
+    switch (encryptedMessage.tlType) {
     case TLValue::EncryptedMessage:
-        *this >> result.randomId;
-        *this >> result.chatId;
-        *this >> result.date;
-        *this >> result.bytes;
-        *this >> result.file;
+        *this >> encryptedMessage.randomId;
+        *this >> encryptedMessage.chatId;
+        *this >> encryptedMessage.date;
+        *this >> encryptedMessage.bytes;
+        *this >> encryptedMessage.file;
         break;
     case TLValue::EncryptedMessageService:
-        *this >> result.randomId;
-        *this >> result.chatId;
-        *this >> result.date;
-        *this >> result.bytes;
+        *this >> encryptedMessage.randomId;
+        *this >> encryptedMessage.chatId;
+        *this >> encryptedMessage.date;
+        *this >> encryptedMessage.bytes;
         break;
     default:
         break;
     }
 
-    encryptedMessage = result;
-
     return *this;
 }
 
 CTelegramStream &CTelegramStream::operator>>(TLError &error)
 {
-    TLError result;
+    error = TLError();
 
-    *this >> result.tlType;
+    *this >> error.tlType;
 
-    switch (result.tlType) {
+    switch (error.tlType) {
     case TLValue::Error:
-        *this >> result.code;
-        *this >> result.text;
+        *this >> error.code;
+        *this >> error.text;
         break;
     default:
         break;
     }
 
-    error = result;
-
     return *this;
 }
 
 CTelegramStream &CTelegramStream::operator>>(TLExportedChatInvite &exportedChatInvite)
 {
-    TLExportedChatInvite result;
+    exportedChatInvite = TLExportedChatInvite();
 
-    *this >> result.tlType;
+    *this >> exportedChatInvite.tlType;
 
-    switch (result.tlType) {
+    switch (exportedChatInvite.tlType) {
     case TLValue::ChatInviteEmpty:
         break;
     case TLValue::ChatInviteExported:
-        *this >> result.link;
+        *this >> exportedChatInvite.link;
         break;
     default:
         break;
     }
 
-    exportedChatInvite = result;
-
     return *this;
 }
 
 CTelegramStream &CTelegramStream::operator>>(TLFileLocation &fileLocation)
 {
-    TLFileLocation result;
+    fileLocation = TLFileLocation();
 
-    *this >> result.tlType;
+    *this >> fileLocation.tlType;
 
-    switch (result.tlType) {
+    switch (fileLocation.tlType) {
     case TLValue::FileLocationUnavailable:
-        *this >> result.volumeId;
-        *this >> result.localId;
-        *this >> result.secret;
+        *this >> fileLocation.volumeId;
+        *this >> fileLocation.localId;
+        *this >> fileLocation.secret;
         break;
     case TLValue::FileLocation:
-        *this >> result.dcId;
-        *this >> result.volumeId;
-        *this >> result.localId;
-        *this >> result.secret;
+        *this >> fileLocation.dcId;
+        *this >> fileLocation.volumeId;
+        *this >> fileLocation.localId;
+        *this >> fileLocation.secret;
         break;
     default:
         break;
     }
 
-    fileLocation = result;
-
     return *this;
 }
 
 CTelegramStream &CTelegramStream::operator>>(TLGeoPoint &geoPoint)
 {
-    TLGeoPoint result;
+    geoPoint = TLGeoPoint();
 
-    *this >> result.tlType;
+    *this >> geoPoint.tlType;
 
-    switch (result.tlType) {
+    switch (geoPoint.tlType) {
     case TLValue::GeoPointEmpty:
         break;
     case TLValue::GeoPoint:
-        *this >> result.longitude;
-        *this >> result.latitude;
+        *this >> geoPoint.longitude;
+        *this >> geoPoint.latitude;
         break;
     default:
         break;
     }
 
-    geoPoint = result;
-
     return *this;
 }
 
 CTelegramStream &CTelegramStream::operator>>(TLHelpAppUpdate &helpAppUpdate)
 {
-    TLHelpAppUpdate result;
+    helpAppUpdate = TLHelpAppUpdate();
 
-    *this >> result.tlType;
+    *this >> helpAppUpdate.tlType;
 
-    switch (result.tlType) {
+    switch (helpAppUpdate.tlType) {
     case TLValue::HelpAppUpdate:
-        *this >> result.id;
-        *this >> result.critical;
-        *this >> result.url;
-        *this >> result.text;
+        *this >> helpAppUpdate.id;
+        *this >> helpAppUpdate.critical;
+        *this >> helpAppUpdate.url;
+        *this >> helpAppUpdate.text;
         break;
     case TLValue::HelpNoAppUpdate:
         break;
@@ -820,334 +985,306 @@ CTelegramStream &CTelegramStream::operator>>(TLHelpAppUpdate &helpAppUpdate)
         break;
     }
 
-    helpAppUpdate = result;
-
     return *this;
 }
 
 CTelegramStream &CTelegramStream::operator>>(TLHelpInviteText &helpInviteText)
 {
-    TLHelpInviteText result;
+    helpInviteText = TLHelpInviteText();
 
-    *this >> result.tlType;
+    *this >> helpInviteText.tlType;
 
-    switch (result.tlType) {
+    switch (helpInviteText.tlType) {
     case TLValue::HelpInviteText:
-        *this >> result.message;
+        *this >> helpInviteText.message;
         break;
     default:
         break;
     }
 
-    helpInviteText = result;
-
     return *this;
 }
 
 CTelegramStream &CTelegramStream::operator>>(TLImportedContact &importedContact)
 {
-    TLImportedContact result;
+    importedContact = TLImportedContact();
 
-    *this >> result.tlType;
+    *this >> importedContact.tlType;
 
-    switch (result.tlType) {
+    switch (importedContact.tlType) {
     case TLValue::ImportedContact:
-        *this >> result.userId;
-        *this >> result.clientId;
+        *this >> importedContact.userId;
+        *this >> importedContact.clientId;
         break;
     default:
         break;
     }
 
-    importedContact = result;
-
     return *this;
 }
 
 CTelegramStream &CTelegramStream::operator>>(TLInputAppEvent &inputAppEvent)
 {
-    TLInputAppEvent result;
+    inputAppEvent = TLInputAppEvent();
 
-    *this >> result.tlType;
+    *this >> inputAppEvent.tlType;
 
-    switch (result.tlType) {
+    switch (inputAppEvent.tlType) {
     case TLValue::InputAppEvent:
-        *this >> result.time;
-        *this >> result.type;
-        *this >> result.peer;
-        *this >> result.data;
+        *this >> inputAppEvent.time;
+        *this >> inputAppEvent.type;
+        *this >> inputAppEvent.peer;
+        *this >> inputAppEvent.data;
         break;
     default:
         break;
     }
 
-    inputAppEvent = result;
-
     return *this;
 }
 
 CTelegramStream &CTelegramStream::operator>>(TLInputAudio &inputAudio)
 {
-    TLInputAudio result;
+    inputAudio = TLInputAudio();
 
-    *this >> result.tlType;
+    *this >> inputAudio.tlType;
 
-    switch (result.tlType) {
+    switch (inputAudio.tlType) {
     case TLValue::InputAudioEmpty:
         break;
     case TLValue::InputAudio:
-        *this >> result.id;
-        *this >> result.accessHash;
+        *this >> inputAudio.id;
+        *this >> inputAudio.accessHash;
         break;
     default:
         break;
     }
 
-    inputAudio = result;
-
     return *this;
 }
 
 CTelegramStream &CTelegramStream::operator>>(TLInputContact &inputContact)
 {
-    TLInputContact result;
+    inputContact = TLInputContact();
 
-    *this >> result.tlType;
+    *this >> inputContact.tlType;
 
-    switch (result.tlType) {
+    switch (inputContact.tlType) {
     case TLValue::InputPhoneContact:
-        *this >> result.clientId;
-        *this >> result.phone;
-        *this >> result.firstName;
-        *this >> result.lastName;
+        *this >> inputContact.clientId;
+        *this >> inputContact.phone;
+        *this >> inputContact.firstName;
+        *this >> inputContact.lastName;
         break;
     default:
         break;
     }
 
-    inputContact = result;
-
     return *this;
 }
 
 CTelegramStream &CTelegramStream::operator>>(TLInputDocument &inputDocument)
 {
-    TLInputDocument result;
+    inputDocument = TLInputDocument();
 
-    *this >> result.tlType;
+    *this >> inputDocument.tlType;
 
-    switch (result.tlType) {
+    switch (inputDocument.tlType) {
     case TLValue::InputDocumentEmpty:
         break;
     case TLValue::InputDocument:
-        *this >> result.id;
-        *this >> result.accessHash;
+        *this >> inputDocument.id;
+        *this >> inputDocument.accessHash;
         break;
     default:
         break;
     }
 
-    inputDocument = result;
-
     return *this;
 }
 
 CTelegramStream &CTelegramStream::operator>>(TLInputEncryptedChat &inputEncryptedChat)
 {
-    TLInputEncryptedChat result;
+    inputEncryptedChat = TLInputEncryptedChat();
 
-    *this >> result.tlType;
+    *this >> inputEncryptedChat.tlType;
 
-    switch (result.tlType) {
+    switch (inputEncryptedChat.tlType) {
     case TLValue::InputEncryptedChat:
-        *this >> result.chatId;
-        *this >> result.accessHash;
+        *this >> inputEncryptedChat.chatId;
+        *this >> inputEncryptedChat.accessHash;
         break;
     default:
         break;
     }
 
-    inputEncryptedChat = result;
-
     return *this;
 }
 
 CTelegramStream &CTelegramStream::operator>>(TLInputEncryptedFile &inputEncryptedFile)
 {
-    TLInputEncryptedFile result;
+    inputEncryptedFile = TLInputEncryptedFile();
 
-    *this >> result.tlType;
+    *this >> inputEncryptedFile.tlType;
 
-    switch (result.tlType) {
+    switch (inputEncryptedFile.tlType) {
     case TLValue::InputEncryptedFileEmpty:
         break;
     case TLValue::InputEncryptedFileUploaded:
-        *this >> result.id;
-        *this >> result.parts;
-        *this >> result.md5Checksum;
-        *this >> result.keyFingerprint;
+        *this >> inputEncryptedFile.id;
+        *this >> inputEncryptedFile.parts;
+        *this >> inputEncryptedFile.md5Checksum;
+        *this >> inputEncryptedFile.keyFingerprint;
         break;
     case TLValue::InputEncryptedFile:
-        *this >> result.id;
-        *this >> result.accessHash;
+        *this >> inputEncryptedFile.id;
+        *this >> inputEncryptedFile.accessHash;
         break;
     case TLValue::InputEncryptedFileBigUploaded:
-        *this >> result.id;
-        *this >> result.parts;
-        *this >> result.keyFingerprint;
+        *this >> inputEncryptedFile.id;
+        *this >> inputEncryptedFile.parts;
+        *this >> inputEncryptedFile.keyFingerprint;
         break;
     default:
         break;
     }
 
-    inputEncryptedFile = result;
-
     return *this;
 }
 
 CTelegramStream &CTelegramStream::operator>>(TLInputFile &inputFile)
 {
-    TLInputFile result;
+    inputFile = TLInputFile();
 
-    *this >> result.tlType;
+    *this >> inputFile.tlType;
 
-    switch (result.tlType) {
+    switch (inputFile.tlType) {
     case TLValue::InputFile:
-        *this >> result.id;
-        *this >> result.parts;
-        *this >> result.name;
-        *this >> result.md5Checksum;
+        *this >> inputFile.id;
+        *this >> inputFile.parts;
+        *this >> inputFile.name;
+        *this >> inputFile.md5Checksum;
         break;
     case TLValue::InputFileBig:
-        *this >> result.id;
-        *this >> result.parts;
-        *this >> result.name;
+        *this >> inputFile.id;
+        *this >> inputFile.parts;
+        *this >> inputFile.name;
         break;
     default:
         break;
     }
 
-    inputFile = result;
-
     return *this;
 }
 
 CTelegramStream &CTelegramStream::operator>>(TLInputFileLocation &inputFileLocation)
 {
-    TLInputFileLocation result;
+    inputFileLocation = TLInputFileLocation();
 
-    *this >> result.tlType;
+    *this >> inputFileLocation.tlType;
 
-    switch (result.tlType) {
+    switch (inputFileLocation.tlType) {
     case TLValue::InputFileLocation:
-        *this >> result.volumeId;
-        *this >> result.localId;
-        *this >> result.secret;
+        *this >> inputFileLocation.volumeId;
+        *this >> inputFileLocation.localId;
+        *this >> inputFileLocation.secret;
         break;
     case TLValue::InputVideoFileLocation:
-        *this >> result.id;
-        *this >> result.accessHash;
+        *this >> inputFileLocation.id;
+        *this >> inputFileLocation.accessHash;
         break;
     case TLValue::InputEncryptedFileLocation:
-        *this >> result.id;
-        *this >> result.accessHash;
+        *this >> inputFileLocation.id;
+        *this >> inputFileLocation.accessHash;
         break;
     case TLValue::InputAudioFileLocation:
-        *this >> result.id;
-        *this >> result.accessHash;
+        *this >> inputFileLocation.id;
+        *this >> inputFileLocation.accessHash;
         break;
     case TLValue::InputDocumentFileLocation:
-        *this >> result.id;
-        *this >> result.accessHash;
+        *this >> inputFileLocation.id;
+        *this >> inputFileLocation.accessHash;
         break;
     default:
         break;
     }
 
-    inputFileLocation = result;
-
     return *this;
 }
 
 CTelegramStream &CTelegramStream::operator>>(TLInputGeoChat &inputGeoChat)
 {
-    TLInputGeoChat result;
+    inputGeoChat = TLInputGeoChat();
 
-    *this >> result.tlType;
+    *this >> inputGeoChat.tlType;
 
-    switch (result.tlType) {
+    switch (inputGeoChat.tlType) {
     case TLValue::InputGeoChat:
-        *this >> result.chatId;
-        *this >> result.accessHash;
+        *this >> inputGeoChat.chatId;
+        *this >> inputGeoChat.accessHash;
         break;
     default:
         break;
     }
 
-    inputGeoChat = result;
-
     return *this;
 }
 
 CTelegramStream &CTelegramStream::operator>>(TLInputGeoPoint &inputGeoPoint)
 {
-    TLInputGeoPoint result;
+    inputGeoPoint = TLInputGeoPoint();
 
-    *this >> result.tlType;
+    *this >> inputGeoPoint.tlType;
 
-    switch (result.tlType) {
+    switch (inputGeoPoint.tlType) {
     case TLValue::InputGeoPointEmpty:
         break;
     case TLValue::InputGeoPoint:
-        *this >> result.latitude;
-        *this >> result.longitude;
+        *this >> inputGeoPoint.latitude;
+        *this >> inputGeoPoint.longitude;
         break;
     default:
         break;
     }
 
-    inputGeoPoint = result;
-
     return *this;
 }
 
 CTelegramStream &CTelegramStream::operator>>(TLInputPeer &inputPeer)
 {
-    TLInputPeer result;
+    inputPeer = TLInputPeer();
 
-    *this >> result.tlType;
+    *this >> inputPeer.tlType;
 
-    switch (result.tlType) {
+    switch (inputPeer.tlType) {
     case TLValue::InputPeerEmpty:
         break;
     case TLValue::InputPeerSelf:
         break;
     case TLValue::InputPeerContact:
-        *this >> result.userId;
+        *this >> inputPeer.userId;
         break;
     case TLValue::InputPeerForeign:
-        *this >> result.userId;
-        *this >> result.accessHash;
+        *this >> inputPeer.userId;
+        *this >> inputPeer.accessHash;
         break;
     case TLValue::InputPeerChat:
-        *this >> result.chatId;
+        *this >> inputPeer.chatId;
         break;
     default:
         break;
     }
 
-    inputPeer = result;
-
     return *this;
 }
 
 CTelegramStream &CTelegramStream::operator>>(TLInputPeerNotifyEvents &inputPeerNotifyEvents)
 {
-    TLInputPeerNotifyEvents result;
+    inputPeerNotifyEvents = TLInputPeerNotifyEvents();
 
-    *this >> result.tlType;
+    *this >> inputPeerNotifyEvents.tlType;
 
-    switch (result.tlType) {
+    switch (inputPeerNotifyEvents.tlType) {
     case TLValue::InputPeerNotifyEventsEmpty:
         break;
     case TLValue::InputPeerNotifyEventsAll:
@@ -1156,243 +1293,221 @@ CTelegramStream &CTelegramStream::operator>>(TLInputPeerNotifyEvents &inputPeerN
         break;
     }
 
-    inputPeerNotifyEvents = result;
-
     return *this;
 }
 
 CTelegramStream &CTelegramStream::operator>>(TLInputPeerNotifySettings &inputPeerNotifySettings)
 {
-    TLInputPeerNotifySettings result;
+    inputPeerNotifySettings = TLInputPeerNotifySettings();
 
-    *this >> result.tlType;
+    *this >> inputPeerNotifySettings.tlType;
 
-    switch (result.tlType) {
+    switch (inputPeerNotifySettings.tlType) {
     case TLValue::InputPeerNotifySettings:
-        *this >> result.muteUntil;
-        *this >> result.sound;
-        *this >> result.showPreviews;
-        *this >> result.eventsMask;
+        *this >> inputPeerNotifySettings.muteUntil;
+        *this >> inputPeerNotifySettings.sound;
+        *this >> inputPeerNotifySettings.showPreviews;
+        *this >> inputPeerNotifySettings.eventsMask;
         break;
     default:
         break;
     }
 
-    inputPeerNotifySettings = result;
-
     return *this;
 }
 
 CTelegramStream &CTelegramStream::operator>>(TLInputPhoto &inputPhoto)
 {
-    TLInputPhoto result;
+    inputPhoto = TLInputPhoto();
 
-    *this >> result.tlType;
+    *this >> inputPhoto.tlType;
 
-    switch (result.tlType) {
+    switch (inputPhoto.tlType) {
     case TLValue::InputPhotoEmpty:
         break;
     case TLValue::InputPhoto:
-        *this >> result.id;
-        *this >> result.accessHash;
+        *this >> inputPhoto.id;
+        *this >> inputPhoto.accessHash;
         break;
     default:
         break;
     }
 
-    inputPhoto = result;
-
     return *this;
 }
 
 CTelegramStream &CTelegramStream::operator>>(TLInputPhotoCrop &inputPhotoCrop)
 {
-    TLInputPhotoCrop result;
+    inputPhotoCrop = TLInputPhotoCrop();
 
-    *this >> result.tlType;
+    *this >> inputPhotoCrop.tlType;
 
-    switch (result.tlType) {
+    switch (inputPhotoCrop.tlType) {
     case TLValue::InputPhotoCropAuto:
         break;
     case TLValue::InputPhotoCrop:
-        *this >> result.cropLeft;
-        *this >> result.cropTop;
-        *this >> result.cropWidth;
+        *this >> inputPhotoCrop.cropLeft;
+        *this >> inputPhotoCrop.cropTop;
+        *this >> inputPhotoCrop.cropWidth;
         break;
     default:
         break;
     }
 
-    inputPhotoCrop = result;
-
     return *this;
 }
 
 CTelegramStream &CTelegramStream::operator>>(TLInputPrivacyKey &inputPrivacyKey)
 {
-    TLInputPrivacyKey result;
+    inputPrivacyKey = TLInputPrivacyKey();
 
-    *this >> result.tlType;
+    *this >> inputPrivacyKey.tlType;
 
-    switch (result.tlType) {
+    switch (inputPrivacyKey.tlType) {
     case TLValue::InputPrivacyKeyStatusTimestamp:
         break;
     default:
         break;
     }
 
-    inputPrivacyKey = result;
-
     return *this;
 }
 
 CTelegramStream &CTelegramStream::operator>>(TLInputStickerSet &inputStickerSet)
 {
-    TLInputStickerSet result;
+    inputStickerSet = TLInputStickerSet();
 
-    *this >> result.tlType;
+    *this >> inputStickerSet.tlType;
 
-    switch (result.tlType) {
+    switch (inputStickerSet.tlType) {
     case TLValue::InputStickerSetEmpty:
         break;
     case TLValue::InputStickerSetID:
-        *this >> result.id;
-        *this >> result.accessHash;
+        *this >> inputStickerSet.id;
+        *this >> inputStickerSet.accessHash;
         break;
     case TLValue::InputStickerSetShortName:
-        *this >> result.shortName;
+        *this >> inputStickerSet.shortName;
         break;
     default:
         break;
     }
 
-    inputStickerSet = result;
-
     return *this;
 }
 
 CTelegramStream &CTelegramStream::operator>>(TLInputUser &inputUser)
 {
-    TLInputUser result;
+    inputUser = TLInputUser();
 
-    *this >> result.tlType;
+    *this >> inputUser.tlType;
 
-    switch (result.tlType) {
+    switch (inputUser.tlType) {
     case TLValue::InputUserEmpty:
         break;
     case TLValue::InputUserSelf:
         break;
     case TLValue::InputUserContact:
-        *this >> result.userId;
+        *this >> inputUser.userId;
         break;
     case TLValue::InputUserForeign:
-        *this >> result.userId;
-        *this >> result.accessHash;
+        *this >> inputUser.userId;
+        *this >> inputUser.accessHash;
         break;
     default:
         break;
     }
 
-    inputUser = result;
-
     return *this;
 }
 
 CTelegramStream &CTelegramStream::operator>>(TLInputVideo &inputVideo)
 {
-    TLInputVideo result;
+    inputVideo = TLInputVideo();
 
-    *this >> result.tlType;
+    *this >> inputVideo.tlType;
 
-    switch (result.tlType) {
+    switch (inputVideo.tlType) {
     case TLValue::InputVideoEmpty:
         break;
     case TLValue::InputVideo:
-        *this >> result.id;
-        *this >> result.accessHash;
+        *this >> inputVideo.id;
+        *this >> inputVideo.accessHash;
         break;
     default:
         break;
     }
 
-    inputVideo = result;
-
     return *this;
 }
 
 CTelegramStream &CTelegramStream::operator>>(TLMessagesAffectedHistory &messagesAffectedHistory)
 {
-    TLMessagesAffectedHistory result;
+    messagesAffectedHistory = TLMessagesAffectedHistory();
 
-    *this >> result.tlType;
+    *this >> messagesAffectedHistory.tlType;
 
-    switch (result.tlType) {
+    switch (messagesAffectedHistory.tlType) {
     case TLValue::MessagesAffectedHistory:
-        *this >> result.pts;
-        *this >> result.ptsCount;
-        *this >> result.offset;
+        *this >> messagesAffectedHistory.pts;
+        *this >> messagesAffectedHistory.ptsCount;
+        *this >> messagesAffectedHistory.offset;
         break;
     default:
         break;
     }
 
-    messagesAffectedHistory = result;
-
     return *this;
 }
 
 CTelegramStream &CTelegramStream::operator>>(TLMessagesAffectedMessages &messagesAffectedMessages)
 {
-    TLMessagesAffectedMessages result;
+    messagesAffectedMessages = TLMessagesAffectedMessages();
 
-    *this >> result.tlType;
+    *this >> messagesAffectedMessages.tlType;
 
-    switch (result.tlType) {
+    switch (messagesAffectedMessages.tlType) {
     case TLValue::MessagesAffectedMessages:
-        *this >> result.pts;
-        *this >> result.ptsCount;
+        *this >> messagesAffectedMessages.pts;
+        *this >> messagesAffectedMessages.ptsCount;
         break;
     default:
         break;
     }
 
-    messagesAffectedMessages = result;
-
     return *this;
 }
 
 CTelegramStream &CTelegramStream::operator>>(TLMessagesDhConfig &messagesDhConfig)
 {
-    TLMessagesDhConfig result;
+    messagesDhConfig = TLMessagesDhConfig();
 
-    *this >> result.tlType;
+    *this >> messagesDhConfig.tlType;
 
-    switch (result.tlType) {
+    switch (messagesDhConfig.tlType) {
     case TLValue::MessagesDhConfigNotModified:
-        *this >> result.random;
+        *this >> messagesDhConfig.random;
         break;
     case TLValue::MessagesDhConfig:
-        *this >> result.g;
-        *this >> result.p;
-        *this >> result.version;
-        *this >> result.random;
+        *this >> messagesDhConfig.g;
+        *this >> messagesDhConfig.p;
+        *this >> messagesDhConfig.version;
+        *this >> messagesDhConfig.random;
         break;
     default:
         break;
     }
 
-    messagesDhConfig = result;
-
     return *this;
 }
 
 CTelegramStream &CTelegramStream::operator>>(TLMessagesFilter &messagesFilter)
 {
-    TLMessagesFilter result;
+    messagesFilter = TLMessagesFilter();
 
-    *this >> result.tlType;
+    *this >> messagesFilter.tlType;
 
-    switch (result.tlType) {
+    switch (messagesFilter.tlType) {
     case TLValue::InputMessagesFilterEmpty:
         break;
     case TLValue::InputMessagesFilterPhotos:
@@ -1411,84 +1526,76 @@ CTelegramStream &CTelegramStream::operator>>(TLMessagesFilter &messagesFilter)
         break;
     }
 
-    messagesFilter = result;
-
     return *this;
 }
 
 CTelegramStream &CTelegramStream::operator>>(TLMessagesSentEncryptedMessage &messagesSentEncryptedMessage)
 {
-    TLMessagesSentEncryptedMessage result;
+    messagesSentEncryptedMessage = TLMessagesSentEncryptedMessage();
 
-    *this >> result.tlType;
+    *this >> messagesSentEncryptedMessage.tlType;
 
-    switch (result.tlType) {
+    switch (messagesSentEncryptedMessage.tlType) {
     case TLValue::MessagesSentEncryptedMessage:
-        *this >> result.date;
+        *this >> messagesSentEncryptedMessage.date;
         break;
     case TLValue::MessagesSentEncryptedFile:
-        *this >> result.date;
-        *this >> result.file;
+        *this >> messagesSentEncryptedMessage.date;
+        *this >> messagesSentEncryptedMessage.file;
         break;
     default:
         break;
     }
 
-    messagesSentEncryptedMessage = result;
-
     return *this;
 }
 
 CTelegramStream &CTelegramStream::operator>>(TLNearestDc &nearestDc)
 {
-    TLNearestDc result;
+    nearestDc = TLNearestDc();
 
-    *this >> result.tlType;
+    *this >> nearestDc.tlType;
 
-    switch (result.tlType) {
+    switch (nearestDc.tlType) {
     case TLValue::NearestDc:
-        *this >> result.country;
-        *this >> result.thisDc;
-        *this >> result.nearestDc;
+        *this >> nearestDc.country;
+        *this >> nearestDc.thisDc;
+        *this >> nearestDc.nearestDc;
         break;
     default:
         break;
     }
 
-    nearestDc = result;
-
     return *this;
 }
 
 CTelegramStream &CTelegramStream::operator>>(TLPeer &peer)
 {
-    TLPeer result;
+    peer = TLPeer();
 
-    *this >> result.tlType;
+    *this >> peer.tlType;
 
-    switch (result.tlType) {
+    switch (peer.tlType) {
     case TLValue::PeerUser:
-        *this >> result.userId;
+        *this >> peer.userId;
         break;
     case TLValue::PeerChat:
-        *this >> result.chatId;
+        *this >> peer.chatId;
         break;
     default:
         break;
     }
 
-    peer = result;
-
     return *this;
 }
 
 CTelegramStream &CTelegramStream::operator>>(TLPeerNotifyEvents &peerNotifyEvents)
 {
-    TLPeerNotifyEvents result;
+    peerNotifyEvents = TLPeerNotifyEvents();
 
-    *this >> result.tlType;
+    *this >> peerNotifyEvents.tlType;
 
-    switch (result.tlType) {
+    switch (peerNotifyEvents.tlType) {
     case TLValue::PeerNotifyEventsEmpty:
         break;
     case TLValue::PeerNotifyEventsAll:
@@ -1497,143 +1604,131 @@ CTelegramStream &CTelegramStream::operator>>(TLPeerNotifyEvents &peerNotifyEvent
         break;
     }
 
-    peerNotifyEvents = result;
-
     return *this;
 }
 
 CTelegramStream &CTelegramStream::operator>>(TLPeerNotifySettings &peerNotifySettings)
 {
-    TLPeerNotifySettings result;
+    peerNotifySettings = TLPeerNotifySettings();
 
-    *this >> result.tlType;
+    *this >> peerNotifySettings.tlType;
 
-    switch (result.tlType) {
+    switch (peerNotifySettings.tlType) {
     case TLValue::PeerNotifySettingsEmpty:
         break;
     case TLValue::PeerNotifySettings:
-        *this >> result.muteUntil;
-        *this >> result.sound;
-        *this >> result.showPreviews;
-        *this >> result.eventsMask;
+        *this >> peerNotifySettings.muteUntil;
+        *this >> peerNotifySettings.sound;
+        *this >> peerNotifySettings.showPreviews;
+        *this >> peerNotifySettings.eventsMask;
         break;
     default:
         break;
     }
 
-    peerNotifySettings = result;
-
     return *this;
 }
 
 CTelegramStream &CTelegramStream::operator>>(TLPhotoSize &photoSize)
 {
-    TLPhotoSize result;
+    photoSize = TLPhotoSize();
 
-    *this >> result.tlType;
+    *this >> photoSize.tlType;
 
-    switch (result.tlType) {
+    switch (photoSize.tlType) {
     case TLValue::PhotoSizeEmpty:
-        *this >> result.type;
+        *this >> photoSize.type;
         break;
     case TLValue::PhotoSize:
-        *this >> result.type;
-        *this >> result.location;
-        *this >> result.w;
-        *this >> result.h;
-        *this >> result.size;
+        *this >> photoSize.type;
+        *this >> photoSize.location;
+        *this >> photoSize.w;
+        *this >> photoSize.h;
+        *this >> photoSize.size;
         break;
     case TLValue::PhotoCachedSize:
-        *this >> result.type;
-        *this >> result.location;
-        *this >> result.w;
-        *this >> result.h;
-        *this >> result.bytes;
+        *this >> photoSize.type;
+        *this >> photoSize.location;
+        *this >> photoSize.w;
+        *this >> photoSize.h;
+        *this >> photoSize.bytes;
         break;
     default:
         break;
     }
 
-    photoSize = result;
-
     return *this;
 }
 
 CTelegramStream &CTelegramStream::operator>>(TLPrivacyKey &privacyKey)
 {
-    TLPrivacyKey result;
+    privacyKey = TLPrivacyKey();
 
-    *this >> result.tlType;
+    *this >> privacyKey.tlType;
 
-    switch (result.tlType) {
+    switch (privacyKey.tlType) {
     case TLValue::PrivacyKeyStatusTimestamp:
         break;
     default:
         break;
     }
 
-    privacyKey = result;
-
     return *this;
 }
 
 CTelegramStream &CTelegramStream::operator>>(TLPrivacyRule &privacyRule)
 {
-    TLPrivacyRule result;
+    privacyRule = TLPrivacyRule();
 
-    *this >> result.tlType;
+    *this >> privacyRule.tlType;
 
-    switch (result.tlType) {
+    switch (privacyRule.tlType) {
     case TLValue::PrivacyValueAllowContacts:
         break;
     case TLValue::PrivacyValueAllowAll:
         break;
     case TLValue::PrivacyValueAllowUsers:
-        *this >> result.users;
+        *this >> privacyRule.users;
         break;
     case TLValue::PrivacyValueDisallowContacts:
         break;
     case TLValue::PrivacyValueDisallowAll:
         break;
     case TLValue::PrivacyValueDisallowUsers:
-        *this >> result.users;
+        *this >> privacyRule.users;
         break;
     default:
         break;
     }
 
-    privacyRule = result;
-
     return *this;
 }
 
 CTelegramStream &CTelegramStream::operator>>(TLReceivedNotifyMessage &receivedNotifyMessage)
 {
-    TLReceivedNotifyMessage result;
+    receivedNotifyMessage = TLReceivedNotifyMessage();
 
-    *this >> result.tlType;
+    *this >> receivedNotifyMessage.tlType;
 
-    switch (result.tlType) {
+    switch (receivedNotifyMessage.tlType) {
     case TLValue::ReceivedNotifyMessage:
-        *this >> result.id;
-        *this >> result.flags;
+        *this >> receivedNotifyMessage.id;
+        *this >> receivedNotifyMessage.flags;
         break;
     default:
         break;
     }
 
-    receivedNotifyMessage = result;
-
     return *this;
 }
 
 CTelegramStream &CTelegramStream::operator>>(TLSendMessageAction &sendMessageAction)
 {
-    TLSendMessageAction result;
+    sendMessageAction = TLSendMessageAction();
 
-    *this >> result.tlType;
+    *this >> sendMessageAction.tlType;
 
-    switch (result.tlType) {
+    switch (sendMessageAction.tlType) {
     case TLValue::SendMessageTypingAction:
         break;
     case TLValue::SendMessageCancelAction:
@@ -1641,18 +1736,18 @@ CTelegramStream &CTelegramStream::operator>>(TLSendMessageAction &sendMessageAct
     case TLValue::SendMessageRecordVideoAction:
         break;
     case TLValue::SendMessageUploadVideoAction:
-        *this >> result.progress;
+        *this >> sendMessageAction.progress;
         break;
     case TLValue::SendMessageRecordAudioAction:
         break;
     case TLValue::SendMessageUploadAudioAction:
-        *this >> result.progress;
+        *this >> sendMessageAction.progress;
         break;
     case TLValue::SendMessageUploadPhotoAction:
-        *this >> result.progress;
+        *this >> sendMessageAction.progress;
         break;
     case TLValue::SendMessageUploadDocumentAction:
-        *this >> result.progress;
+        *this >> sendMessageAction.progress;
         break;
     case TLValue::SendMessageGeoLocationAction:
         break;
@@ -1662,60 +1757,54 @@ CTelegramStream &CTelegramStream::operator>>(TLSendMessageAction &sendMessageAct
         break;
     }
 
-    sendMessageAction = result;
-
     return *this;
 }
 
 CTelegramStream &CTelegramStream::operator>>(TLStickerPack &stickerPack)
 {
-    TLStickerPack result;
+    stickerPack = TLStickerPack();
 
-    *this >> result.tlType;
+    *this >> stickerPack.tlType;
 
-    switch (result.tlType) {
+    switch (stickerPack.tlType) {
     case TLValue::StickerPack:
-        *this >> result.emoticon;
-        *this >> result.documents;
+        *this >> stickerPack.emoticon;
+        *this >> stickerPack.documents;
         break;
     default:
         break;
     }
 
-    stickerPack = result;
-
     return *this;
 }
 
 CTelegramStream &CTelegramStream::operator>>(TLStickerSet &stickerSet)
 {
-    TLStickerSet result;
+    stickerSet = TLStickerSet();
 
-    *this >> result.tlType;
+    *this >> stickerSet.tlType;
 
-    switch (result.tlType) {
+    switch (stickerSet.tlType) {
     case TLValue::StickerSet:
-        *this >> result.id;
-        *this >> result.accessHash;
-        *this >> result.title;
-        *this >> result.shortName;
+        *this >> stickerSet.id;
+        *this >> stickerSet.accessHash;
+        *this >> stickerSet.title;
+        *this >> stickerSet.shortName;
         break;
     default:
         break;
     }
 
-    stickerSet = result;
-
     return *this;
 }
 
 CTelegramStream &CTelegramStream::operator>>(TLStorageFileType &storageFileType)
 {
-    TLStorageFileType result;
+    storageFileType = TLStorageFileType();
 
-    *this >> result.tlType;
+    *this >> storageFileType.tlType;
 
-    switch (result.tlType) {
+    switch (storageFileType.tlType) {
     case TLValue::StorageFileUnknown:
         break;
     case TLValue::StorageFileJpeg:
@@ -1740,92 +1829,84 @@ CTelegramStream &CTelegramStream::operator>>(TLStorageFileType &storageFileType)
         break;
     }
 
-    storageFileType = result;
-
     return *this;
 }
 
 CTelegramStream &CTelegramStream::operator>>(TLUpdatesState &updatesState)
 {
-    TLUpdatesState result;
+    updatesState = TLUpdatesState();
 
-    *this >> result.tlType;
+    *this >> updatesState.tlType;
 
-    switch (result.tlType) {
+    switch (updatesState.tlType) {
     case TLValue::UpdatesState:
-        *this >> result.pts;
-        *this >> result.qts;
-        *this >> result.date;
-        *this >> result.seq;
-        *this >> result.unreadCount;
+        *this >> updatesState.pts;
+        *this >> updatesState.qts;
+        *this >> updatesState.date;
+        *this >> updatesState.seq;
+        *this >> updatesState.unreadCount;
         break;
     default:
         break;
     }
 
-    updatesState = result;
-
     return *this;
 }
 
 CTelegramStream &CTelegramStream::operator>>(TLUploadFile &uploadFile)
 {
-    TLUploadFile result;
+    uploadFile = TLUploadFile();
 
-    *this >> result.tlType;
+    *this >> uploadFile.tlType;
 
-    switch (result.tlType) {
+    switch (uploadFile.tlType) {
     case TLValue::UploadFile:
-        *this >> result.type;
-        *this >> result.mtime;
-        *this >> result.bytes;
+        *this >> uploadFile.type;
+        *this >> uploadFile.mtime;
+        *this >> uploadFile.bytes;
         break;
     default:
         break;
     }
 
-    uploadFile = result;
-
     return *this;
 }
 
 CTelegramStream &CTelegramStream::operator>>(TLUserProfilePhoto &userProfilePhoto)
 {
-    TLUserProfilePhoto result;
+    userProfilePhoto = TLUserProfilePhoto();
 
-    *this >> result.tlType;
+    *this >> userProfilePhoto.tlType;
 
-    switch (result.tlType) {
+    switch (userProfilePhoto.tlType) {
     case TLValue::UserProfilePhotoEmpty:
         break;
     case TLValue::UserProfilePhoto:
-        *this >> result.photoId;
-        *this >> result.photoSmall;
-        *this >> result.photoBig;
+        *this >> userProfilePhoto.photoId;
+        *this >> userProfilePhoto.photoSmall;
+        *this >> userProfilePhoto.photoBig;
         break;
     default:
         break;
     }
 
-    userProfilePhoto = result;
-
     return *this;
 }
 
 CTelegramStream &CTelegramStream::operator>>(TLUserStatus &userStatus)
 {
-    TLUserStatus result;
+    userStatus = TLUserStatus();
 
-    *this >> result.tlType;
+    *this >> userStatus.tlType;
 
-    switch (result.tlType) {
+    switch (userStatus.tlType) {
     case TLValue::UserStatusEmpty:
         break;
     case TLValue::UserStatusOnline:
-        *this >> result.expires;
+        *this >> userStatus.expires;
         break;
     case TLValue::UserStatusOffline:
-        *this >> result.wasOnline;
+        *this >> userStatus.wasOnline;
         break;
     case TLValue::UserStatusRecently:
         break;
@@ -1837,344 +1918,322 @@ CTelegramStream &CTelegramStream::operator>>(TLUserStatus &userStatus)
         break;
     }
 
-    userStatus = result;
-
     return *this;
 }
 
 CTelegramStream &CTelegramStream::operator>>(TLVideo &video)
 {
-    TLVideo result;
+    video = TLVideo();
 
-    *this >> result.tlType;
+    *this >> video.tlType;
 
-    switch (result.tlType) {
+    switch (video.tlType) {
     case TLValue::VideoEmpty:
-        *this >> result.id;
+        *this >> video.id;
         break;
     case TLValue::Video:
-        *this >> result.id;
-        *this >> result.accessHash;
-        *this >> result.userId;
-        *this >> result.date;
-        *this >> result.duration;
-        *this >> result.size;
-        *this >> result.thumb;
-        *this >> result.dcId;
-        *this >> result.w;
-        *this >> result.h;
+        *this >> video.id;
+        *this >> video.accessHash;
+        *this >> video.userId;
+        *this >> video.date;
+        *this >> video.duration;
+        *this >> video.size;
+        *this >> video.thumb;
+        *this >> video.dcId;
+        *this >> video.w;
+        *this >> video.h;
         break;
     default:
         break;
     }
 
-    video = result;
-
     return *this;
 }
 
 CTelegramStream &CTelegramStream::operator>>(TLWallPaper &wallPaper)
 {
-    TLWallPaper result;
+    wallPaper = TLWallPaper();
 
-    *this >> result.tlType;
+    *this >> wallPaper.tlType;
 
-    switch (result.tlType) {
+    switch (wallPaper.tlType) {
     case TLValue::WallPaper:
-        *this >> result.id;
-        *this >> result.title;
-        *this >> result.sizes;
-        *this >> result.color;
+        *this >> wallPaper.id;
+        *this >> wallPaper.title;
+        *this >> wallPaper.sizes;
+        *this >> wallPaper.color;
         break;
     case TLValue::WallPaperSolid:
-        *this >> result.id;
-        *this >> result.title;
-        *this >> result.bgColor;
-        *this >> result.color;
+        *this >> wallPaper.id;
+        *this >> wallPaper.title;
+        *this >> wallPaper.bgColor;
+        *this >> wallPaper.color;
         break;
     default:
         break;
     }
 
-    wallPaper = result;
-
     return *this;
 }
 
 CTelegramStream &CTelegramStream::operator>>(TLAccountAuthorizations &accountAuthorizations)
 {
-    TLAccountAuthorizations result;
+    accountAuthorizations = TLAccountAuthorizations();
 
-    *this >> result.tlType;
+    *this >> accountAuthorizations.tlType;
 
-    switch (result.tlType) {
+    switch (accountAuthorizations.tlType) {
     case TLValue::AccountAuthorizations:
-        *this >> result.authorizations;
+        *this >> accountAuthorizations.authorizations;
         break;
     default:
         break;
     }
 
-    accountAuthorizations = result;
-
     return *this;
 }
 
 CTelegramStream &CTelegramStream::operator>>(TLChatPhoto &chatPhoto)
 {
-    TLChatPhoto result;
+    chatPhoto = TLChatPhoto();
 
-    *this >> result.tlType;
+    *this >> chatPhoto.tlType;
 
-    switch (result.tlType) {
+    switch (chatPhoto.tlType) {
     case TLValue::ChatPhotoEmpty:
         break;
     case TLValue::ChatPhoto:
-        *this >> result.photoSmall;
-        *this >> result.photoBig;
+        *this >> chatPhoto.photoSmall;
+        *this >> chatPhoto.photoBig;
         break;
     default:
         break;
     }
 
-    chatPhoto = result;
-
     return *this;
 }
 
 CTelegramStream &CTelegramStream::operator>>(TLConfig &config)
 {
-    TLConfig result;
+    config = TLConfig();
 
-    *this >> result.tlType;
+    *this >> config.tlType;
 
-    switch (result.tlType) {
+    switch (config.tlType) {
     case TLValue::Config:
-        *this >> result.date;
-        *this >> result.expires;
-        *this >> result.testMode;
-        *this >> result.thisDc;
-        *this >> result.dcOptions;
-        *this >> result.chatSizeMax;
-        *this >> result.broadcastSizeMax;
-        *this >> result.forwardedCountMax;
-        *this >> result.onlineUpdatePeriodMs;
-        *this >> result.offlineBlurTimeoutMs;
-        *this >> result.offlineIdleTimeoutMs;
-        *this >> result.onlineCloudTimeoutMs;
-        *this >> result.notifyCloudDelayMs;
-        *this >> result.notifyDefaultDelayMs;
-        *this >> result.chatBigSize;
-        *this >> result.pushChatPeriodMs;
-        *this >> result.pushChatLimit;
-        *this >> result.disabledFeatures;
+        *this >> config.date;
+        *this >> config.expires;
+        *this >> config.testMode;
+        *this >> config.thisDc;
+        *this >> config.dcOptions;
+        *this >> config.chatSizeMax;
+        *this >> config.broadcastSizeMax;
+        *this >> config.forwardedCountMax;
+        *this >> config.onlineUpdatePeriodMs;
+        *this >> config.offlineBlurTimeoutMs;
+        *this >> config.offlineIdleTimeoutMs;
+        *this >> config.onlineCloudTimeoutMs;
+        *this >> config.notifyCloudDelayMs;
+        *this >> config.notifyDefaultDelayMs;
+        *this >> config.chatBigSize;
+        *this >> config.pushChatPeriodMs;
+        *this >> config.pushChatLimit;
+        *this >> config.disabledFeatures;
         break;
     default:
         break;
     }
 
-    config = result;
-
     return *this;
 }
 
 CTelegramStream &CTelegramStream::operator>>(TLContactStatus &contactStatus)
 {
-    TLContactStatus result;
+    contactStatus = TLContactStatus();
 
-    *this >> result.tlType;
+    *this >> contactStatus.tlType;
 
-    switch (result.tlType) {
+    switch (contactStatus.tlType) {
     case TLValue::ContactStatus:
-        *this >> result.userId;
-        *this >> result.status;
+        *this >> contactStatus.userId;
+        *this >> contactStatus.status;
         break;
     default:
         break;
     }
 
-    contactStatus = result;
-
     return *this;
 }
 
 CTelegramStream &CTelegramStream::operator>>(TLDialog &dialog)
 {
-    TLDialog result;
+    dialog = TLDialog();
 
-    *this >> result.tlType;
+    *this >> dialog.tlType;
 
-    switch (result.tlType) {
+    switch (dialog.tlType) {
     case TLValue::Dialog:
-        *this >> result.peer;
-        *this >> result.topMessage;
-        *this >> result.readInboxMaxId;
-        *this >> result.unreadCount;
-        *this >> result.notifySettings;
+        *this >> dialog.peer;
+        *this >> dialog.topMessage;
+        *this >> dialog.readInboxMaxId;
+        *this >> dialog.unreadCount;
+        *this >> dialog.notifySettings;
         break;
     default:
         break;
     }
 
-    dialog = result;
-
     return *this;
 }
 
 CTelegramStream &CTelegramStream::operator>>(TLDocumentAttribute &documentAttribute)
 {
-    TLDocumentAttribute result;
+    documentAttribute = TLDocumentAttribute();
 
-    *this >> result.tlType;
+    *this >> documentAttribute.tlType;
 
-    switch (result.tlType) {
+    switch (documentAttribute.tlType) {
     case TLValue::DocumentAttributeImageSize:
-        *this >> result.w;
-        *this >> result.h;
+        *this >> documentAttribute.w;
+        *this >> documentAttribute.h;
         break;
     case TLValue::DocumentAttributeAnimated:
         break;
     case TLValue::DocumentAttributeSticker:
-        *this >> result.alt;
-        *this >> result.stickerset;
+        *this >> documentAttribute.alt;
+        *this >> documentAttribute.stickerset;
         break;
     case TLValue::DocumentAttributeVideo:
-        *this >> result.duration;
-        *this >> result.w;
-        *this >> result.h;
+        *this >> documentAttribute.duration;
+        *this >> documentAttribute.w;
+        *this >> documentAttribute.h;
         break;
     case TLValue::DocumentAttributeAudio:
-        *this >> result.duration;
+        *this >> documentAttribute.duration;
         break;
     case TLValue::DocumentAttributeFilename:
-        *this >> result.fileName;
+        *this >> documentAttribute.fileName;
         break;
     default:
         break;
     }
 
-    documentAttribute = result;
-
     return *this;
 }
 
 CTelegramStream &CTelegramStream::operator>>(TLInputChatPhoto &inputChatPhoto)
 {
-    TLInputChatPhoto result;
+    inputChatPhoto = TLInputChatPhoto();
 
-    *this >> result.tlType;
+    *this >> inputChatPhoto.tlType;
 
-    switch (result.tlType) {
+    switch (inputChatPhoto.tlType) {
     case TLValue::InputChatPhotoEmpty:
         break;
     case TLValue::InputChatUploadedPhoto:
-        *this >> result.file;
-        *this >> result.crop;
+        *this >> inputChatPhoto.file;
+        *this >> inputChatPhoto.crop;
         break;
     case TLValue::InputChatPhoto:
-        *this >> result.id;
-        *this >> result.crop;
+        *this >> inputChatPhoto.id;
+        *this >> inputChatPhoto.crop;
         break;
     default:
         break;
     }
 
-    inputChatPhoto = result;
-
     return *this;
 }
 
 CTelegramStream &CTelegramStream::operator>>(TLInputMedia &inputMedia)
 {
-    TLInputMedia result;
+    inputMedia = TLInputMedia();
 
-    *this >> result.tlType;
+    *this >> inputMedia.tlType;
 
-    switch (result.tlType) {
+    switch (inputMedia.tlType) {
     case TLValue::InputMediaEmpty:
         break;
     case TLValue::InputMediaUploadedPhoto:
-        *this >> result.file;
-        *this >> result.caption;
+        *this >> inputMedia.file;
+        *this >> inputMedia.caption;
         break;
     case TLValue::InputMediaPhoto:
-        *this >> result.idInputPhoto;
-        *this >> result.caption;
+        *this >> inputMedia.idInputPhoto;
+        *this >> inputMedia.caption;
         break;
     case TLValue::InputMediaGeoPoint:
-        *this >> result.geoPoint;
+        *this >> inputMedia.geoPoint;
         break;
     case TLValue::InputMediaContact:
-        *this >> result.phoneNumber;
-        *this >> result.firstName;
-        *this >> result.lastName;
+        *this >> inputMedia.phoneNumber;
+        *this >> inputMedia.firstName;
+        *this >> inputMedia.lastName;
         break;
     case TLValue::InputMediaUploadedVideo:
-        *this >> result.file;
-        *this >> result.duration;
-        *this >> result.w;
-        *this >> result.h;
-        *this >> result.caption;
+        *this >> inputMedia.file;
+        *this >> inputMedia.duration;
+        *this >> inputMedia.w;
+        *this >> inputMedia.h;
+        *this >> inputMedia.caption;
         break;
     case TLValue::InputMediaUploadedThumbVideo:
-        *this >> result.file;
-        *this >> result.thumb;
-        *this >> result.duration;
-        *this >> result.w;
-        *this >> result.h;
-        *this >> result.caption;
+        *this >> inputMedia.file;
+        *this >> inputMedia.thumb;
+        *this >> inputMedia.duration;
+        *this >> inputMedia.w;
+        *this >> inputMedia.h;
+        *this >> inputMedia.caption;
         break;
     case TLValue::InputMediaVideo:
-        *this >> result.idInputVeo;
-        *this >> result.caption;
+        *this >> inputMedia.idInputVeo;
+        *this >> inputMedia.caption;
         break;
     case TLValue::InputMediaUploadedAudio:
-        *this >> result.file;
-        *this >> result.duration;
-        *this >> result.mimeType;
+        *this >> inputMedia.file;
+        *this >> inputMedia.duration;
+        *this >> inputMedia.mimeType;
         break;
     case TLValue::InputMediaAudio:
-        *this >> result.idInputAudio;
+        *this >> inputMedia.idInputAudio;
         break;
     case TLValue::InputMediaUploadedDocument:
-        *this >> result.file;
-        *this >> result.mimeType;
-        *this >> result.attributes;
+        *this >> inputMedia.file;
+        *this >> inputMedia.mimeType;
+        *this >> inputMedia.attributes;
         break;
     case TLValue::InputMediaUploadedThumbDocument:
-        *this >> result.file;
-        *this >> result.thumb;
-        *this >> result.mimeType;
-        *this >> result.attributes;
+        *this >> inputMedia.file;
+        *this >> inputMedia.thumb;
+        *this >> inputMedia.mimeType;
+        *this >> inputMedia.attributes;
         break;
     case TLValue::InputMediaDocument:
-        *this >> result.idInputDocument;
+        *this >> inputMedia.idInputDocument;
         break;
     case TLValue::InputMediaVenue:
-        *this >> result.geoPoint;
-        *this >> result.title;
-        *this >> result.address;
-        *this >> result.provider;
-        *this >> result.venueId;
+        *this >> inputMedia.geoPoint;
+        *this >> inputMedia.title;
+        *this >> inputMedia.address;
+        *this >> inputMedia.provider;
+        *this >> inputMedia.venueId;
         break;
     default:
         break;
     }
 
-    inputMedia = result;
-
     return *this;
 }
 
 CTelegramStream &CTelegramStream::operator>>(TLInputNotifyPeer &inputNotifyPeer)
 {
-    TLInputNotifyPeer result;
+    inputNotifyPeer = TLInputNotifyPeer();
 
-    *this >> result.tlType;
+    *this >> inputNotifyPeer.tlType;
 
-    switch (result.tlType) {
+    switch (inputNotifyPeer.tlType) {
     case TLValue::InputNotifyPeer:
-        *this >> result.peerInput;
+        *this >> inputNotifyPeer.peerInput;
         break;
     case TLValue::InputNotifyUsers:
         break;
@@ -2183,56 +2242,52 @@ CTelegramStream &CTelegramStream::operator>>(TLInputNotifyPeer &inputNotifyPeer)
     case TLValue::InputNotifyAll:
         break;
     case TLValue::InputNotifyGeoChatPeer:
-        *this >> result.peerInputGeoChat;
+        *this >> inputNotifyPeer.peerInputGeoChat;
         break;
     default:
         break;
     }
 
-    inputNotifyPeer = result;
-
     return *this;
 }
 
 CTelegramStream &CTelegramStream::operator>>(TLInputPrivacyRule &inputPrivacyRule)
 {
-    TLInputPrivacyRule result;
+    inputPrivacyRule = TLInputPrivacyRule();
 
-    *this >> result.tlType;
+    *this >> inputPrivacyRule.tlType;
 
-    switch (result.tlType) {
+    switch (inputPrivacyRule.tlType) {
     case TLValue::InputPrivacyValueAllowContacts:
         break;
     case TLValue::InputPrivacyValueAllowAll:
         break;
     case TLValue::InputPrivacyValueAllowUsers:
-        *this >> result.users;
+        *this >> inputPrivacyRule.users;
         break;
     case TLValue::InputPrivacyValueDisallowContacts:
         break;
     case TLValue::InputPrivacyValueDisallowAll:
         break;
     case TLValue::InputPrivacyValueDisallowUsers:
-        *this >> result.users;
+        *this >> inputPrivacyRule.users;
         break;
     default:
         break;
     }
 
-    inputPrivacyRule = result;
-
     return *this;
 }
 
 CTelegramStream &CTelegramStream::operator>>(TLNotifyPeer &notifyPeer)
 {
-    TLNotifyPeer result;
+    notifyPeer = TLNotifyPeer();
 
-    *this >> result.tlType;
+    *this >> notifyPeer.tlType;
 
-    switch (result.tlType) {
+    switch (notifyPeer.tlType) {
     case TLValue::NotifyPeer:
-        *this >> result.peer;
+        *this >> notifyPeer.peer;
         break;
     case TLValue::NotifyUsers:
         break;
@@ -2244,1241 +2299,1165 @@ CTelegramStream &CTelegramStream::operator>>(TLNotifyPeer &notifyPeer)
         break;
     }
 
-    notifyPeer = result;
-
     return *this;
 }
 
 CTelegramStream &CTelegramStream::operator>>(TLPhoto &photo)
 {
-    TLPhoto result;
+    photo = TLPhoto();
 
-    *this >> result.tlType;
+    *this >> photo.tlType;
 
-    switch (result.tlType) {
+    switch (photo.tlType) {
     case TLValue::PhotoEmpty:
-        *this >> result.id;
+        *this >> photo.id;
         break;
     case TLValue::Photo:
-        *this >> result.id;
-        *this >> result.accessHash;
-        *this >> result.userId;
-        *this >> result.date;
-        *this >> result.geo;
-        *this >> result.sizes;
+        *this >> photo.id;
+        *this >> photo.accessHash;
+        *this >> photo.userId;
+        *this >> photo.date;
+        *this >> photo.geo;
+        *this >> photo.sizes;
         break;
     default:
         break;
     }
 
-    photo = result;
-
     return *this;
 }
 
 CTelegramStream &CTelegramStream::operator>>(TLUser &user)
 {
-    TLUser result;
+    user = TLUser();
 
-    *this >> result.tlType;
+    *this >> user.tlType;
 
-    switch (result.tlType) {
+    switch (user.tlType) {
     case TLValue::UserEmpty:
-        *this >> result.id;
+        *this >> user.id;
         break;
     case TLValue::UserSelf:
-        *this >> result.id;
-        *this >> result.firstName;
-        *this >> result.lastName;
-        *this >> result.username;
-        *this >> result.phone;
-        *this >> result.photo;
-        *this >> result.status;
+        *this >> user.id;
+        *this >> user.firstName;
+        *this >> user.lastName;
+        *this >> user.username;
+        *this >> user.phone;
+        *this >> user.photo;
+        *this >> user.status;
         break;
     case TLValue::UserContact:
-        *this >> result.id;
-        *this >> result.firstName;
-        *this >> result.lastName;
-        *this >> result.username;
-        *this >> result.accessHash;
-        *this >> result.phone;
-        *this >> result.photo;
-        *this >> result.status;
+        *this >> user.id;
+        *this >> user.firstName;
+        *this >> user.lastName;
+        *this >> user.username;
+        *this >> user.accessHash;
+        *this >> user.phone;
+        *this >> user.photo;
+        *this >> user.status;
         break;
     case TLValue::UserRequest:
-        *this >> result.id;
-        *this >> result.firstName;
-        *this >> result.lastName;
-        *this >> result.username;
-        *this >> result.accessHash;
-        *this >> result.phone;
-        *this >> result.photo;
-        *this >> result.status;
+        *this >> user.id;
+        *this >> user.firstName;
+        *this >> user.lastName;
+        *this >> user.username;
+        *this >> user.accessHash;
+        *this >> user.phone;
+        *this >> user.photo;
+        *this >> user.status;
         break;
     case TLValue::UserForeign:
-        *this >> result.id;
-        *this >> result.firstName;
-        *this >> result.lastName;
-        *this >> result.username;
-        *this >> result.accessHash;
-        *this >> result.photo;
-        *this >> result.status;
+        *this >> user.id;
+        *this >> user.firstName;
+        *this >> user.lastName;
+        *this >> user.username;
+        *this >> user.accessHash;
+        *this >> user.photo;
+        *this >> user.status;
         break;
     case TLValue::UserDeleted:
-        *this >> result.id;
-        *this >> result.firstName;
-        *this >> result.lastName;
-        *this >> result.username;
+        *this >> user.id;
+        *this >> user.firstName;
+        *this >> user.lastName;
+        *this >> user.username;
         break;
     default:
         break;
     }
 
-    user = result;
-
     return *this;
 }
 
 CTelegramStream &CTelegramStream::operator>>(TLWebPage &webPage)
 {
-    TLWebPage result;
+    webPage = TLWebPage();
 
-    *this >> result.tlType;
+    *this >> webPage.tlType;
 
-    switch (result.tlType) {
+    switch (webPage.tlType) {
     case TLValue::WebPageEmpty:
-        *this >> result.id;
+        *this >> webPage.id;
         break;
     case TLValue::WebPagePending:
-        *this >> result.id;
-        *this >> result.date;
+        *this >> webPage.id;
+        *this >> webPage.date;
         break;
     case TLValue::WebPage:
-        *this >> result.flags;
-        *this >> result.id;
-        *this >> result.url;
-        *this >> result.displayUrl;
-        if (result.flags & 1 << 0) {
-            *this >> result.type;
+        *this >> webPage.flags;
+        *this >> webPage.id;
+        *this >> webPage.url;
+        *this >> webPage.displayUrl;
+        if (webPage.flags & 1 << 0) {
+            *this >> webPage.type;
         }
-        if (result.flags & 1 << 1) {
-            *this >> result.siteName;
+        if (webPage.flags & 1 << 1) {
+            *this >> webPage.siteName;
         }
-        if (result.flags & 1 << 2) {
-            *this >> result.title;
+        if (webPage.flags & 1 << 2) {
+            *this >> webPage.title;
         }
-        if (result.flags & 1 << 3) {
-            *this >> result.description;
+        if (webPage.flags & 1 << 3) {
+            *this >> webPage.description;
         }
-        if (result.flags & 1 << 4) {
-            *this >> result.photo;
+        if (webPage.flags & 1 << 4) {
+            *this >> webPage.photo;
         }
-        if (result.flags & 1 << 5) {
-            *this >> result.embedUrl;
+        if (webPage.flags & 1 << 5) {
+            *this >> webPage.embedUrl;
         }
-        if (result.flags & 1 << 5) {
-            *this >> result.embedType;
+        if (webPage.flags & 1 << 5) {
+            *this >> webPage.embedType;
         }
-        if (result.flags & 1 << 6) {
-            *this >> result.embedWidth;
+        if (webPage.flags & 1 << 6) {
+            *this >> webPage.embedWidth;
         }
-        if (result.flags & 1 << 6) {
-            *this >> result.embedHeight;
+        if (webPage.flags & 1 << 6) {
+            *this >> webPage.embedHeight;
         }
-        if (result.flags & 1 << 7) {
-            *this >> result.duration;
+        if (webPage.flags & 1 << 7) {
+            *this >> webPage.duration;
         }
-        if (result.flags & 1 << 8) {
-            *this >> result.author;
+        if (webPage.flags & 1 << 8) {
+            *this >> webPage.author;
         }
         break;
     default:
         break;
     }
 
-    webPage = result;
-
     return *this;
 }
 
 CTelegramStream &CTelegramStream::operator>>(TLAccountPrivacyRules &accountPrivacyRules)
 {
-    TLAccountPrivacyRules result;
+    accountPrivacyRules = TLAccountPrivacyRules();
 
-    *this >> result.tlType;
+    *this >> accountPrivacyRules.tlType;
 
-    switch (result.tlType) {
+    switch (accountPrivacyRules.tlType) {
     case TLValue::AccountPrivacyRules:
-        *this >> result.rules;
-        *this >> result.users;
+        *this >> accountPrivacyRules.rules;
+        *this >> accountPrivacyRules.users;
         break;
     default:
         break;
     }
 
-    accountPrivacyRules = result;
-
     return *this;
 }
 
 CTelegramStream &CTelegramStream::operator>>(TLAuthAuthorization &authAuthorization)
 {
-    TLAuthAuthorization result;
+    authAuthorization = TLAuthAuthorization();
 
-    *this >> result.tlType;
+    *this >> authAuthorization.tlType;
 
-    switch (result.tlType) {
+    switch (authAuthorization.tlType) {
     case TLValue::AuthAuthorization:
-        *this >> result.expires;
-        *this >> result.user;
+        *this >> authAuthorization.expires;
+        *this >> authAuthorization.user;
         break;
     default:
         break;
     }
 
-    authAuthorization = result;
-
     return *this;
 }
 
 CTelegramStream &CTelegramStream::operator>>(TLChat &chat)
 {
-    TLChat result;
+    chat = TLChat();
 
-    *this >> result.tlType;
+    *this >> chat.tlType;
 
-    switch (result.tlType) {
+    switch (chat.tlType) {
     case TLValue::ChatEmpty:
-        *this >> result.id;
+        *this >> chat.id;
         break;
     case TLValue::Chat:
-        *this >> result.id;
-        *this >> result.title;
-        *this >> result.photo;
-        *this >> result.participantsCount;
-        *this >> result.date;
-        *this >> result.left;
-        *this >> result.version;
+        *this >> chat.id;
+        *this >> chat.title;
+        *this >> chat.photo;
+        *this >> chat.participantsCount;
+        *this >> chat.date;
+        *this >> chat.left;
+        *this >> chat.version;
         break;
     case TLValue::ChatForbidden:
-        *this >> result.id;
-        *this >> result.title;
-        *this >> result.date;
+        *this >> chat.id;
+        *this >> chat.title;
+        *this >> chat.date;
         break;
     case TLValue::GeoChat:
-        *this >> result.id;
-        *this >> result.accessHash;
-        *this >> result.title;
-        *this >> result.address;
-        *this >> result.venue;
-        *this >> result.geo;
-        *this >> result.photo;
-        *this >> result.participantsCount;
-        *this >> result.date;
-        *this >> result.checkedIn;
-        *this >> result.version;
+        *this >> chat.id;
+        *this >> chat.accessHash;
+        *this >> chat.title;
+        *this >> chat.address;
+        *this >> chat.venue;
+        *this >> chat.geo;
+        *this >> chat.photo;
+        *this >> chat.participantsCount;
+        *this >> chat.date;
+        *this >> chat.checkedIn;
+        *this >> chat.version;
         break;
     default:
         break;
     }
 
-    chat = result;
-
     return *this;
 }
 
 CTelegramStream &CTelegramStream::operator>>(TLChatFull &chatFull)
 {
-    TLChatFull result;
+    chatFull = TLChatFull();
 
-    *this >> result.tlType;
+    *this >> chatFull.tlType;
 
-    switch (result.tlType) {
+    switch (chatFull.tlType) {
     case TLValue::ChatFull:
-        *this >> result.id;
-        *this >> result.participants;
-        *this >> result.chatPhoto;
-        *this >> result.notifySettings;
-        *this >> result.exportedInvite;
+        *this >> chatFull.id;
+        *this >> chatFull.participants;
+        *this >> chatFull.chatPhoto;
+        *this >> chatFull.notifySettings;
+        *this >> chatFull.exportedInvite;
         break;
     default:
         break;
     }
 
-    chatFull = result;
-
     return *this;
 }
 
 CTelegramStream &CTelegramStream::operator>>(TLChatInvite &chatInvite)
 {
-    TLChatInvite result;
+    chatInvite = TLChatInvite();
 
-    *this >> result.tlType;
+    *this >> chatInvite.tlType;
 
-    switch (result.tlType) {
+    switch (chatInvite.tlType) {
     case TLValue::ChatInviteAlready:
-        *this >> result.chat;
+        *this >> chatInvite.chat;
         break;
     case TLValue::ChatInvite:
-        *this >> result.title;
+        *this >> chatInvite.title;
         break;
     default:
         break;
     }
 
-    chatInvite = result;
-
     return *this;
 }
 
 CTelegramStream &CTelegramStream::operator>>(TLContactsBlocked &contactsBlocked)
 {
-    TLContactsBlocked result;
+    contactsBlocked = TLContactsBlocked();
 
-    *this >> result.tlType;
+    *this >> contactsBlocked.tlType;
 
-    switch (result.tlType) {
+    switch (contactsBlocked.tlType) {
     case TLValue::ContactsBlocked:
-        *this >> result.blocked;
-        *this >> result.users;
+        *this >> contactsBlocked.blocked;
+        *this >> contactsBlocked.users;
         break;
     case TLValue::ContactsBlockedSlice:
-        *this >> result.count;
-        *this >> result.blocked;
-        *this >> result.users;
+        *this >> contactsBlocked.count;
+        *this >> contactsBlocked.blocked;
+        *this >> contactsBlocked.users;
         break;
     default:
         break;
     }
 
-    contactsBlocked = result;
-
     return *this;
 }
 
 CTelegramStream &CTelegramStream::operator>>(TLContactsContacts &contactsContacts)
 {
-    TLContactsContacts result;
+    contactsContacts = TLContactsContacts();
 
-    *this >> result.tlType;
+    *this >> contactsContacts.tlType;
 
-    switch (result.tlType) {
+    switch (contactsContacts.tlType) {
     case TLValue::ContactsContactsNotModified:
         break;
     case TLValue::ContactsContacts:
-        *this >> result.contacts;
-        *this >> result.users;
+        *this >> contactsContacts.contacts;
+        *this >> contactsContacts.users;
         break;
     default:
         break;
     }
 
-    contactsContacts = result;
-
     return *this;
 }
 
 CTelegramStream &CTelegramStream::operator>>(TLContactsFound &contactsFound)
 {
-    TLContactsFound result;
+    contactsFound = TLContactsFound();
 
-    *this >> result.tlType;
+    *this >> contactsFound.tlType;
 
-    switch (result.tlType) {
+    switch (contactsFound.tlType) {
     case TLValue::ContactsFound:
-        *this >> result.results;
-        *this >> result.users;
+        *this >> contactsFound.results;
+        *this >> contactsFound.users;
         break;
     default:
         break;
     }
 
-    contactsFound = result;
-
     return *this;
 }
 
 CTelegramStream &CTelegramStream::operator>>(TLContactsImportedContacts &contactsImportedContacts)
 {
-    TLContactsImportedContacts result;
+    contactsImportedContacts = TLContactsImportedContacts();
 
-    *this >> result.tlType;
+    *this >> contactsImportedContacts.tlType;
 
-    switch (result.tlType) {
+    switch (contactsImportedContacts.tlType) {
     case TLValue::ContactsImportedContacts:
-        *this >> result.imported;
-        *this >> result.retryContacts;
-        *this >> result.users;
+        *this >> contactsImportedContacts.imported;
+        *this >> contactsImportedContacts.retryContacts;
+        *this >> contactsImportedContacts.users;
         break;
     default:
         break;
     }
 
-    contactsImportedContacts = result;
-
     return *this;
 }
 
 CTelegramStream &CTelegramStream::operator>>(TLContactsLink &contactsLink)
 {
-    TLContactsLink result;
+    contactsLink = TLContactsLink();
 
-    *this >> result.tlType;
+    *this >> contactsLink.tlType;
 
-    switch (result.tlType) {
+    switch (contactsLink.tlType) {
     case TLValue::ContactsLink:
-        *this >> result.myLink;
-        *this >> result.foreignLink;
-        *this >> result.user;
+        *this >> contactsLink.myLink;
+        *this >> contactsLink.foreignLink;
+        *this >> contactsLink.user;
         break;
     default:
         break;
     }
 
-    contactsLink = result;
-
     return *this;
 }
 
 CTelegramStream &CTelegramStream::operator>>(TLContactsSuggested &contactsSuggested)
 {
-    TLContactsSuggested result;
+    contactsSuggested = TLContactsSuggested();
 
-    *this >> result.tlType;
+    *this >> contactsSuggested.tlType;
 
-    switch (result.tlType) {
+    switch (contactsSuggested.tlType) {
     case TLValue::ContactsSuggested:
-        *this >> result.results;
-        *this >> result.users;
+        *this >> contactsSuggested.results;
+        *this >> contactsSuggested.users;
         break;
     default:
         break;
     }
 
-    contactsSuggested = result;
-
     return *this;
 }
 
 CTelegramStream &CTelegramStream::operator>>(TLDocument &document)
 {
-    TLDocument result;
+    document = TLDocument();
 
-    *this >> result.tlType;
+    *this >> document.tlType;
 
-    switch (result.tlType) {
+    switch (document.tlType) {
     case TLValue::DocumentEmpty:
-        *this >> result.id;
+        *this >> document.id;
         break;
     case TLValue::Document:
-        *this >> result.id;
-        *this >> result.accessHash;
-        *this >> result.date;
-        *this >> result.mimeType;
-        *this >> result.size;
-        *this >> result.thumb;
-        *this >> result.dcId;
-        *this >> result.attributes;
+        *this >> document.id;
+        *this >> document.accessHash;
+        *this >> document.date;
+        *this >> document.mimeType;
+        *this >> document.size;
+        *this >> document.thumb;
+        *this >> document.dcId;
+        *this >> document.attributes;
         break;
     default:
         break;
     }
 
-    document = result;
-
     return *this;
 }
 
 CTelegramStream &CTelegramStream::operator>>(TLHelpSupport &helpSupport)
 {
-    TLHelpSupport result;
+    helpSupport = TLHelpSupport();
 
-    *this >> result.tlType;
+    *this >> helpSupport.tlType;
 
-    switch (result.tlType) {
+    switch (helpSupport.tlType) {
     case TLValue::HelpSupport:
-        *this >> result.phoneNumber;
-        *this >> result.user;
+        *this >> helpSupport.phoneNumber;
+        *this >> helpSupport.user;
         break;
     default:
         break;
     }
 
-    helpSupport = result;
-
     return *this;
 }
 
 CTelegramStream &CTelegramStream::operator>>(TLMessageAction &messageAction)
 {
-    TLMessageAction result;
+    messageAction = TLMessageAction();
 
-    *this >> result.tlType;
+    *this >> messageAction.tlType;
 
-    switch (result.tlType) {
+    switch (messageAction.tlType) {
     case TLValue::MessageActionEmpty:
         break;
     case TLValue::MessageActionChatCreate:
-        *this >> result.title;
-        *this >> result.users;
+        *this >> messageAction.title;
+        *this >> messageAction.users;
         break;
     case TLValue::MessageActionChatEditTitle:
-        *this >> result.title;
+        *this >> messageAction.title;
         break;
     case TLValue::MessageActionChatEditPhoto:
-        *this >> result.photo;
+        *this >> messageAction.photo;
         break;
     case TLValue::MessageActionChatDeletePhoto:
         break;
     case TLValue::MessageActionChatAddUser:
-        *this >> result.userId;
+        *this >> messageAction.userId;
         break;
     case TLValue::MessageActionChatDeleteUser:
-        *this >> result.userId;
+        *this >> messageAction.userId;
         break;
     case TLValue::MessageActionGeoChatCreate:
-        *this >> result.title;
-        *this >> result.address;
+        *this >> messageAction.title;
+        *this >> messageAction.address;
         break;
     case TLValue::MessageActionGeoChatCheckin:
         break;
     case TLValue::MessageActionChatJoinedByLink:
-        *this >> result.inviterId;
+        *this >> messageAction.inviterId;
         break;
     default:
         break;
     }
 
-    messageAction = result;
-
     return *this;
 }
 
 CTelegramStream &CTelegramStream::operator>>(TLMessageMedia &messageMedia)
 {
-    TLMessageMedia result;
+    messageMedia = TLMessageMedia();
 
-    *this >> result.tlType;
+    *this >> messageMedia.tlType;
 
-    switch (result.tlType) {
+    switch (messageMedia.tlType) {
     case TLValue::MessageMediaEmpty:
         break;
     case TLValue::MessageMediaPhoto:
-        *this >> result.photo;
-        *this >> result.caption;
+        *this >> messageMedia.photo;
+        *this >> messageMedia.caption;
         break;
     case TLValue::MessageMediaVideo:
-        *this >> result.video;
-        *this >> result.caption;
+        *this >> messageMedia.video;
+        *this >> messageMedia.caption;
         break;
     case TLValue::MessageMediaGeo:
-        *this >> result.geo;
+        *this >> messageMedia.geo;
         break;
     case TLValue::MessageMediaContact:
-        *this >> result.phoneNumber;
-        *this >> result.firstName;
-        *this >> result.lastName;
-        *this >> result.userId;
+        *this >> messageMedia.phoneNumber;
+        *this >> messageMedia.firstName;
+        *this >> messageMedia.lastName;
+        *this >> messageMedia.userId;
         break;
     case TLValue::MessageMediaUnsupported:
         break;
     case TLValue::MessageMediaDocument:
-        *this >> result.document;
+        *this >> messageMedia.document;
         break;
     case TLValue::MessageMediaAudio:
-        *this >> result.audio;
+        *this >> messageMedia.audio;
         break;
     case TLValue::MessageMediaWebPage:
-        *this >> result.webpage;
+        *this >> messageMedia.webpage;
         break;
     case TLValue::MessageMediaVenue:
-        *this >> result.geo;
-        *this >> result.title;
-        *this >> result.address;
-        *this >> result.provider;
-        *this >> result.venueId;
+        *this >> messageMedia.geo;
+        *this >> messageMedia.title;
+        *this >> messageMedia.address;
+        *this >> messageMedia.provider;
+        *this >> messageMedia.venueId;
         break;
     default:
         break;
     }
 
-    messageMedia = result;
-
     return *this;
 }
 
 CTelegramStream &CTelegramStream::operator>>(TLMessagesAllStickers &messagesAllStickers)
 {
-    TLMessagesAllStickers result;
+    messagesAllStickers = TLMessagesAllStickers();
 
-    *this >> result.tlType;
+    *this >> messagesAllStickers.tlType;
 
-    switch (result.tlType) {
+    switch (messagesAllStickers.tlType) {
     case TLValue::MessagesAllStickersNotModified:
         break;
     case TLValue::MessagesAllStickers:
-        *this >> result.hash;
-        *this >> result.packs;
-        *this >> result.sets;
-        *this >> result.documents;
+        *this >> messagesAllStickers.hash;
+        *this >> messagesAllStickers.packs;
+        *this >> messagesAllStickers.sets;
+        *this >> messagesAllStickers.documents;
         break;
     default:
         break;
     }
 
-    messagesAllStickers = result;
-
     return *this;
 }
 
 CTelegramStream &CTelegramStream::operator>>(TLMessagesChatFull &messagesChatFull)
 {
-    TLMessagesChatFull result;
+    messagesChatFull = TLMessagesChatFull();
 
-    *this >> result.tlType;
+    *this >> messagesChatFull.tlType;
 
-    switch (result.tlType) {
+    switch (messagesChatFull.tlType) {
     case TLValue::MessagesChatFull:
-        *this >> result.fullChat;
-        *this >> result.chats;
-        *this >> result.users;
+        *this >> messagesChatFull.fullChat;
+        *this >> messagesChatFull.chats;
+        *this >> messagesChatFull.users;
         break;
     default:
         break;
     }
 
-    messagesChatFull = result;
-
     return *this;
 }
 
 CTelegramStream &CTelegramStream::operator>>(TLMessagesChats &messagesChats)
 {
-    TLMessagesChats result;
+    messagesChats = TLMessagesChats();
 
-    *this >> result.tlType;
+    *this >> messagesChats.tlType;
 
-    switch (result.tlType) {
+    switch (messagesChats.tlType) {
     case TLValue::MessagesChats:
-        *this >> result.chats;
+        *this >> messagesChats.chats;
         break;
     default:
         break;
     }
 
-    messagesChats = result;
-
     return *this;
 }
 
 CTelegramStream &CTelegramStream::operator>>(TLMessagesSentMessage &messagesSentMessage)
 {
-    TLMessagesSentMessage result;
+    messagesSentMessage = TLMessagesSentMessage();
 
-    *this >> result.tlType;
+    *this >> messagesSentMessage.tlType;
 
-    switch (result.tlType) {
+    switch (messagesSentMessage.tlType) {
     case TLValue::MessagesSentMessage:
-        *this >> result.id;
-        *this >> result.date;
-        *this >> result.media;
-        *this >> result.pts;
-        *this >> result.ptsCount;
+        *this >> messagesSentMessage.id;
+        *this >> messagesSentMessage.date;
+        *this >> messagesSentMessage.media;
+        *this >> messagesSentMessage.pts;
+        *this >> messagesSentMessage.ptsCount;
         break;
     case TLValue::MessagesSentMessageLink:
-        *this >> result.id;
-        *this >> result.date;
-        *this >> result.media;
-        *this >> result.pts;
-        *this >> result.ptsCount;
-        *this >> result.links;
-        *this >> result.seq;
+        *this >> messagesSentMessage.id;
+        *this >> messagesSentMessage.date;
+        *this >> messagesSentMessage.media;
+        *this >> messagesSentMessage.pts;
+        *this >> messagesSentMessage.ptsCount;
+        *this >> messagesSentMessage.links;
+        *this >> messagesSentMessage.seq;
         break;
     default:
         break;
     }
 
-    messagesSentMessage = result;
-
     return *this;
 }
 
 CTelegramStream &CTelegramStream::operator>>(TLMessagesStickerSet &messagesStickerSet)
 {
-    TLMessagesStickerSet result;
+    messagesStickerSet = TLMessagesStickerSet();
 
-    *this >> result.tlType;
+    *this >> messagesStickerSet.tlType;
 
-    switch (result.tlType) {
+    switch (messagesStickerSet.tlType) {
     case TLValue::MessagesStickerSet:
-        *this >> result.set;
-        *this >> result.packs;
-        *this >> result.documents;
+        *this >> messagesStickerSet.set;
+        *this >> messagesStickerSet.packs;
+        *this >> messagesStickerSet.documents;
         break;
     default:
         break;
     }
 
-    messagesStickerSet = result;
-
     return *this;
 }
 
 CTelegramStream &CTelegramStream::operator>>(TLMessagesStickers &messagesStickers)
 {
-    TLMessagesStickers result;
+    messagesStickers = TLMessagesStickers();
 
-    *this >> result.tlType;
+    *this >> messagesStickers.tlType;
 
-    switch (result.tlType) {
+    switch (messagesStickers.tlType) {
     case TLValue::MessagesStickersNotModified:
         break;
     case TLValue::MessagesStickers:
-        *this >> result.hash;
-        *this >> result.stickers;
+        *this >> messagesStickers.hash;
+        *this >> messagesStickers.stickers;
         break;
     default:
         break;
     }
 
-    messagesStickers = result;
-
     return *this;
 }
 
 CTelegramStream &CTelegramStream::operator>>(TLPhotosPhoto &photosPhoto)
 {
-    TLPhotosPhoto result;
+    photosPhoto = TLPhotosPhoto();
 
-    *this >> result.tlType;
+    *this >> photosPhoto.tlType;
 
-    switch (result.tlType) {
+    switch (photosPhoto.tlType) {
     case TLValue::PhotosPhoto:
-        *this >> result.photo;
-        *this >> result.users;
+        *this >> photosPhoto.photo;
+        *this >> photosPhoto.users;
         break;
     default:
         break;
     }
 
-    photosPhoto = result;
-
     return *this;
 }
 
 CTelegramStream &CTelegramStream::operator>>(TLPhotosPhotos &photosPhotos)
 {
-    TLPhotosPhotos result;
+    photosPhotos = TLPhotosPhotos();
 
-    *this >> result.tlType;
+    *this >> photosPhotos.tlType;
 
-    switch (result.tlType) {
+    switch (photosPhotos.tlType) {
     case TLValue::PhotosPhotos:
-        *this >> result.photos;
-        *this >> result.users;
+        *this >> photosPhotos.photos;
+        *this >> photosPhotos.users;
         break;
     case TLValue::PhotosPhotosSlice:
-        *this >> result.count;
-        *this >> result.photos;
-        *this >> result.users;
+        *this >> photosPhotos.count;
+        *this >> photosPhotos.photos;
+        *this >> photosPhotos.users;
         break;
     default:
         break;
     }
 
-    photosPhotos = result;
-
     return *this;
 }
 
 CTelegramStream &CTelegramStream::operator>>(TLUserFull &userFull)
 {
-    TLUserFull result;
+    userFull = TLUserFull();
 
-    *this >> result.tlType;
+    *this >> userFull.tlType;
 
-    switch (result.tlType) {
+    switch (userFull.tlType) {
     case TLValue::UserFull:
-        *this >> result.user;
-        *this >> result.link;
-        *this >> result.profilePhoto;
-        *this >> result.notifySettings;
-        *this >> result.blocked;
-        *this >> result.realFirstName;
-        *this >> result.realLastName;
+        *this >> userFull.user;
+        *this >> userFull.link;
+        *this >> userFull.profilePhoto;
+        *this >> userFull.notifySettings;
+        *this >> userFull.blocked;
+        *this >> userFull.realFirstName;
+        *this >> userFull.realLastName;
         break;
     default:
         break;
     }
 
-    userFull = result;
-
     return *this;
 }
 
 CTelegramStream &CTelegramStream::operator>>(TLGeoChatMessage &geoChatMessage)
 {
-    TLGeoChatMessage result;
+    geoChatMessage = TLGeoChatMessage();
 
-    *this >> result.tlType;
+    *this >> geoChatMessage.tlType;
 
-    switch (result.tlType) {
+    switch (geoChatMessage.tlType) {
     case TLValue::GeoChatMessageEmpty:
-        *this >> result.chatId;
-        *this >> result.id;
+        *this >> geoChatMessage.chatId;
+        *this >> geoChatMessage.id;
         break;
     case TLValue::GeoChatMessage:
-        *this >> result.chatId;
-        *this >> result.id;
-        *this >> result.fromId;
-        *this >> result.date;
-        *this >> result.message;
-        *this >> result.media;
+        *this >> geoChatMessage.chatId;
+        *this >> geoChatMessage.id;
+        *this >> geoChatMessage.fromId;
+        *this >> geoChatMessage.date;
+        *this >> geoChatMessage.message;
+        *this >> geoChatMessage.media;
         break;
     case TLValue::GeoChatMessageService:
-        *this >> result.chatId;
-        *this >> result.id;
-        *this >> result.fromId;
-        *this >> result.date;
-        *this >> result.action;
+        *this >> geoChatMessage.chatId;
+        *this >> geoChatMessage.id;
+        *this >> geoChatMessage.fromId;
+        *this >> geoChatMessage.date;
+        *this >> geoChatMessage.action;
         break;
     default:
         break;
     }
 
-    geoChatMessage = result;
-
     return *this;
 }
 
 CTelegramStream &CTelegramStream::operator>>(TLGeochatsLocated &geochatsLocated)
 {
-    TLGeochatsLocated result;
+    geochatsLocated = TLGeochatsLocated();
 
-    *this >> result.tlType;
+    *this >> geochatsLocated.tlType;
 
-    switch (result.tlType) {
+    switch (geochatsLocated.tlType) {
     case TLValue::GeochatsLocated:
-        *this >> result.results;
-        *this >> result.messages;
-        *this >> result.chats;
-        *this >> result.users;
+        *this >> geochatsLocated.results;
+        *this >> geochatsLocated.messages;
+        *this >> geochatsLocated.chats;
+        *this >> geochatsLocated.users;
         break;
     default:
         break;
     }
 
-    geochatsLocated = result;
-
     return *this;
 }
 
 CTelegramStream &CTelegramStream::operator>>(TLGeochatsMessages &geochatsMessages)
 {
-    TLGeochatsMessages result;
+    geochatsMessages = TLGeochatsMessages();
 
-    *this >> result.tlType;
+    *this >> geochatsMessages.tlType;
 
-    switch (result.tlType) {
+    switch (geochatsMessages.tlType) {
     case TLValue::GeochatsMessages:
-        *this >> result.messages;
-        *this >> result.chats;
-        *this >> result.users;
+        *this >> geochatsMessages.messages;
+        *this >> geochatsMessages.chats;
+        *this >> geochatsMessages.users;
         break;
     case TLValue::GeochatsMessagesSlice:
-        *this >> result.count;
-        *this >> result.messages;
-        *this >> result.chats;
-        *this >> result.users;
+        *this >> geochatsMessages.count;
+        *this >> geochatsMessages.messages;
+        *this >> geochatsMessages.chats;
+        *this >> geochatsMessages.users;
         break;
     default:
         break;
     }
 
-    geochatsMessages = result;
-
     return *this;
 }
 
 CTelegramStream &CTelegramStream::operator>>(TLGeochatsStatedMessage &geochatsStatedMessage)
 {
-    TLGeochatsStatedMessage result;
+    geochatsStatedMessage = TLGeochatsStatedMessage();
 
-    *this >> result.tlType;
+    *this >> geochatsStatedMessage.tlType;
 
-    switch (result.tlType) {
+    switch (geochatsStatedMessage.tlType) {
     case TLValue::GeochatsStatedMessage:
-        *this >> result.message;
-        *this >> result.chats;
-        *this >> result.users;
-        *this >> result.seq;
+        *this >> geochatsStatedMessage.message;
+        *this >> geochatsStatedMessage.chats;
+        *this >> geochatsStatedMessage.users;
+        *this >> geochatsStatedMessage.seq;
         break;
     default:
         break;
     }
 
-    geochatsStatedMessage = result;
-
     return *this;
 }
 
 CTelegramStream &CTelegramStream::operator>>(TLMessage &message)
 {
-    TLMessage result;
+    message = TLMessage();
 
-    *this >> result.tlType;
+    *this >> message.tlType;
 
-    switch (result.tlType) {
+    switch (message.tlType) {
     case TLValue::MessageEmpty:
-        *this >> result.id;
+        *this >> message.id;
         break;
     case TLValue::Message:
-        *this >> result.flags;
-        *this >> result.id;
-        *this >> result.fromId;
-        *this >> result.toId;
-        if (result.flags & 1 << 2) {
-            *this >> result.fwdFromId;
+        *this >> message.flags;
+        *this >> message.id;
+        *this >> message.fromId;
+        *this >> message.toId;
+        if (message.flags & 1 << 2) {
+            *this >> message.fwdFromId;
         }
-        if (result.flags & 1 << 2) {
-            *this >> result.fwdDate;
+        if (message.flags & 1 << 2) {
+            *this >> message.fwdDate;
         }
-        if (result.flags & 1 << 3) {
-            *this >> result.replyToMsgId;
+        if (message.flags & 1 << 3) {
+            *this >> message.replyToMsgId;
         }
-        *this >> result.date;
-        *this >> result.message;
-        *this >> result.media;
+        *this >> message.date;
+        *this >> message.message;
+        *this >> message.media;
         break;
     case TLValue::MessageService:
-        *this >> result.flags;
-        *this >> result.id;
-        *this >> result.fromId;
-        *this >> result.toId;
-        *this >> result.date;
-        *this >> result.action;
+        *this >> message.flags;
+        *this >> message.id;
+        *this >> message.fromId;
+        *this >> message.toId;
+        *this >> message.date;
+        *this >> message.action;
         break;
     default:
         break;
     }
 
-    message = result;
-
     return *this;
 }
 
 CTelegramStream &CTelegramStream::operator>>(TLMessagesDialogs &messagesDialogs)
 {
-    TLMessagesDialogs result;
+    messagesDialogs = TLMessagesDialogs();
 
-    *this >> result.tlType;
+    *this >> messagesDialogs.tlType;
 
-    switch (result.tlType) {
+    switch (messagesDialogs.tlType) {
     case TLValue::MessagesDialogs:
-        *this >> result.dialogs;
-        *this >> result.messages;
-        *this >> result.chats;
-        *this >> result.users;
+        *this >> messagesDialogs.dialogs;
+        *this >> messagesDialogs.messages;
+        *this >> messagesDialogs.chats;
+        *this >> messagesDialogs.users;
         break;
     case TLValue::MessagesDialogsSlice:
-        *this >> result.count;
-        *this >> result.dialogs;
-        *this >> result.messages;
-        *this >> result.chats;
-        *this >> result.users;
+        *this >> messagesDialogs.count;
+        *this >> messagesDialogs.dialogs;
+        *this >> messagesDialogs.messages;
+        *this >> messagesDialogs.chats;
+        *this >> messagesDialogs.users;
         break;
     default:
         break;
     }
 
-    messagesDialogs = result;
-
     return *this;
 }
 
 CTelegramStream &CTelegramStream::operator>>(TLMessagesMessages &messagesMessages)
 {
-    TLMessagesMessages result;
+    messagesMessages = TLMessagesMessages();
 
-    *this >> result.tlType;
+    *this >> messagesMessages.tlType;
 
-    switch (result.tlType) {
+    switch (messagesMessages.tlType) {
     case TLValue::MessagesMessages:
-        *this >> result.messages;
-        *this >> result.chats;
-        *this >> result.users;
+        *this >> messagesMessages.messages;
+        *this >> messagesMessages.chats;
+        *this >> messagesMessages.users;
         break;
     case TLValue::MessagesMessagesSlice:
-        *this >> result.count;
-        *this >> result.messages;
-        *this >> result.chats;
-        *this >> result.users;
+        *this >> messagesMessages.count;
+        *this >> messagesMessages.messages;
+        *this >> messagesMessages.chats;
+        *this >> messagesMessages.users;
         break;
     default:
         break;
     }
 
-    messagesMessages = result;
-
     return *this;
 }
 
 CTelegramStream &CTelegramStream::operator>>(TLUpdate &update)
 {
-    TLUpdate result;
+    update = TLUpdate();
 
-    *this >> result.tlType;
+    *this >> update.tlType;
 
-    switch (result.tlType) {
+    switch (update.tlType) {
     case TLValue::UpdateNewMessage:
-        *this >> result.message;
-        *this >> result.pts;
-        *this >> result.ptsCount;
+        *this >> update.message;
+        *this >> update.pts;
+        *this >> update.ptsCount;
         break;
     case TLValue::UpdateMessageID:
-        *this >> result.id;
-        *this >> result.randomId;
+        *this >> update.id;
+        *this >> update.randomId;
         break;
     case TLValue::UpdateDeleteMessages:
-        *this >> result.messages;
-        *this >> result.pts;
-        *this >> result.ptsCount;
+        *this >> update.messages;
+        *this >> update.pts;
+        *this >> update.ptsCount;
         break;
     case TLValue::UpdateUserTyping:
-        *this >> result.userId;
-        *this >> result.action;
+        *this >> update.userId;
+        *this >> update.action;
         break;
     case TLValue::UpdateChatUserTyping:
-        *this >> result.chatId;
-        *this >> result.userId;
-        *this >> result.action;
+        *this >> update.chatId;
+        *this >> update.userId;
+        *this >> update.action;
         break;
     case TLValue::UpdateChatParticipants:
-        *this >> result.participants;
+        *this >> update.participants;
         break;
     case TLValue::UpdateUserStatus:
-        *this >> result.userId;
-        *this >> result.status;
+        *this >> update.userId;
+        *this >> update.status;
         break;
     case TLValue::UpdateUserName:
-        *this >> result.userId;
-        *this >> result.firstName;
-        *this >> result.lastName;
-        *this >> result.username;
+        *this >> update.userId;
+        *this >> update.firstName;
+        *this >> update.lastName;
+        *this >> update.username;
         break;
     case TLValue::UpdateUserPhoto:
-        *this >> result.userId;
-        *this >> result.date;
-        *this >> result.photo;
-        *this >> result.previous;
+        *this >> update.userId;
+        *this >> update.date;
+        *this >> update.photo;
+        *this >> update.previous;
         break;
     case TLValue::UpdateContactRegistered:
-        *this >> result.userId;
-        *this >> result.date;
+        *this >> update.userId;
+        *this >> update.date;
         break;
     case TLValue::UpdateContactLink:
-        *this >> result.userId;
-        *this >> result.myLink;
-        *this >> result.foreignLink;
+        *this >> update.userId;
+        *this >> update.myLink;
+        *this >> update.foreignLink;
         break;
     case TLValue::UpdateNewAuthorization:
-        *this >> result.authKeyId;
-        *this >> result.date;
-        *this >> result.device;
-        *this >> result.location;
+        *this >> update.authKeyId;
+        *this >> update.date;
+        *this >> update.device;
+        *this >> update.location;
         break;
     case TLValue::UpdateNewGeoChatMessage:
-        *this >> result.messageGeoChat;
+        *this >> update.messageGeoChat;
         break;
     case TLValue::UpdateNewEncryptedMessage:
-        *this >> result.messageEncrypted;
-        *this >> result.qts;
+        *this >> update.messageEncrypted;
+        *this >> update.qts;
         break;
     case TLValue::UpdateEncryptedChatTyping:
-        *this >> result.chatId;
+        *this >> update.chatId;
         break;
     case TLValue::UpdateEncryption:
-        *this >> result.chat;
-        *this >> result.date;
+        *this >> update.chat;
+        *this >> update.date;
         break;
     case TLValue::UpdateEncryptedMessagesRead:
-        *this >> result.chatId;
-        *this >> result.maxDate;
-        *this >> result.date;
+        *this >> update.chatId;
+        *this >> update.maxDate;
+        *this >> update.date;
         break;
     case TLValue::UpdateChatParticipantAdd:
-        *this >> result.chatId;
-        *this >> result.userId;
-        *this >> result.inviterId;
-        *this >> result.version;
+        *this >> update.chatId;
+        *this >> update.userId;
+        *this >> update.inviterId;
+        *this >> update.version;
         break;
     case TLValue::UpdateChatParticipantDelete:
-        *this >> result.chatId;
-        *this >> result.userId;
-        *this >> result.version;
+        *this >> update.chatId;
+        *this >> update.userId;
+        *this >> update.version;
         break;
     case TLValue::UpdateDcOptions:
-        *this >> result.dcOptions;
+        *this >> update.dcOptions;
         break;
     case TLValue::UpdateUserBlocked:
-        *this >> result.userId;
-        *this >> result.blocked;
+        *this >> update.userId;
+        *this >> update.blocked;
         break;
     case TLValue::UpdateNotifySettings:
-        *this >> result.peerNotify;
-        *this >> result.notifySettings;
+        *this >> update.peerNotify;
+        *this >> update.notifySettings;
         break;
     case TLValue::UpdateServiceNotification:
-        *this >> result.type;
-        *this >> result.messageQString;
-        *this >> result.media;
-        *this >> result.popup;
+        *this >> update.type;
+        *this >> update.messageQString;
+        *this >> update.media;
+        *this >> update.popup;
         break;
     case TLValue::UpdatePrivacy:
-        *this >> result.key;
-        *this >> result.rules;
+        *this >> update.key;
+        *this >> update.rules;
         break;
     case TLValue::UpdateUserPhone:
-        *this >> result.userId;
-        *this >> result.phone;
+        *this >> update.userId;
+        *this >> update.phone;
         break;
     case TLValue::UpdateReadHistoryInbox:
-        *this >> result.peer;
-        *this >> result.maxId;
-        *this >> result.pts;
-        *this >> result.ptsCount;
+        *this >> update.peer;
+        *this >> update.maxId;
+        *this >> update.pts;
+        *this >> update.ptsCount;
         break;
     case TLValue::UpdateReadHistoryOutbox:
-        *this >> result.peer;
-        *this >> result.maxId;
-        *this >> result.pts;
-        *this >> result.ptsCount;
+        *this >> update.peer;
+        *this >> update.maxId;
+        *this >> update.pts;
+        *this >> update.ptsCount;
         break;
     case TLValue::UpdateWebPage:
-        *this >> result.webpage;
+        *this >> update.webpage;
         break;
     case TLValue::UpdateReadMessagesContents:
-        *this >> result.messages;
-        *this >> result.pts;
-        *this >> result.ptsCount;
+        *this >> update.messages;
+        *this >> update.pts;
+        *this >> update.ptsCount;
         break;
     default:
         break;
     }
 
-    update = result;
-
     return *this;
 }
 
 CTelegramStream &CTelegramStream::operator>>(TLUpdates &updates)
 {
-    TLUpdates result;
+    updates = TLUpdates();
 
-    *this >> result.tlType;
+    *this >> updates.tlType;
 
-    switch (result.tlType) {
+    switch (updates.tlType) {
     case TLValue::UpdatesTooLong:
         break;
     case TLValue::UpdateShortMessage:
-        *this >> result.flags;
-        *this >> result.id;
-        *this >> result.userId;
-        *this >> result.message;
-        *this >> result.pts;
-        *this >> result.ptsCount;
-        *this >> result.date;
-        if (result.flags & 1 << 2) {
-            *this >> result.fwdFromId;
+        *this >> updates.flags;
+        *this >> updates.id;
+        *this >> updates.userId;
+        *this >> updates.message;
+        *this >> updates.pts;
+        *this >> updates.ptsCount;
+        *this >> updates.date;
+        if (updates.flags & 1 << 2) {
+            *this >> updates.fwdFromId;
         }
-        if (result.flags & 1 << 2) {
-            *this >> result.fwdDate;
+        if (updates.flags & 1 << 2) {
+            *this >> updates.fwdDate;
         }
-        if (result.flags & 1 << 3) {
-            *this >> result.replyToMsgId;
+        if (updates.flags & 1 << 3) {
+            *this >> updates.replyToMsgId;
         }
         break;
     case TLValue::UpdateShortChatMessage:
-        *this >> result.flags;
-        *this >> result.id;
-        *this >> result.fromId;
-        *this >> result.chatId;
-        *this >> result.message;
-        *this >> result.pts;
-        *this >> result.ptsCount;
-        *this >> result.date;
-        if (result.flags & 1 << 2) {
-            *this >> result.fwdFromId;
+        *this >> updates.flags;
+        *this >> updates.id;
+        *this >> updates.fromId;
+        *this >> updates.chatId;
+        *this >> updates.message;
+        *this >> updates.pts;
+        *this >> updates.ptsCount;
+        *this >> updates.date;
+        if (updates.flags & 1 << 2) {
+            *this >> updates.fwdFromId;
         }
-        if (result.flags & 1 << 2) {
-            *this >> result.fwdDate;
+        if (updates.flags & 1 << 2) {
+            *this >> updates.fwdDate;
         }
-        if (result.flags & 1 << 3) {
-            *this >> result.replyToMsgId;
+        if (updates.flags & 1 << 3) {
+            *this >> updates.replyToMsgId;
         }
         break;
     case TLValue::UpdateShort:
-        *this >> result.update;
-        *this >> result.date;
+        *this >> updates.update;
+        *this >> updates.date;
         break;
     case TLValue::UpdatesCombined:
-        *this >> result.updates;
-        *this >> result.users;
-        *this >> result.chats;
-        *this >> result.date;
-        *this >> result.seqStart;
-        *this >> result.seq;
+        *this >> updates.updates;
+        *this >> updates.users;
+        *this >> updates.chats;
+        *this >> updates.date;
+        *this >> updates.seqStart;
+        *this >> updates.seq;
         break;
     case TLValue::Updates:
-        *this >> result.updates;
-        *this >> result.users;
-        *this >> result.chats;
-        *this >> result.date;
-        *this >> result.seq;
+        *this >> updates.updates;
+        *this >> updates.users;
+        *this >> updates.chats;
+        *this >> updates.date;
+        *this >> updates.seq;
         break;
     default:
         break;
     }
 
-    updates = result;
-
     return *this;
 }
 
 CTelegramStream &CTelegramStream::operator>>(TLUpdatesDifference &updatesDifference)
 {
-    TLUpdatesDifference result;
+    updatesDifference = TLUpdatesDifference();
 
-    *this >> result.tlType;
+    *this >> updatesDifference.tlType;
 
-    switch (result.tlType) {
+    switch (updatesDifference.tlType) {
     case TLValue::UpdatesDifferenceEmpty:
-        *this >> result.date;
-        *this >> result.seq;
+        *this >> updatesDifference.date;
+        *this >> updatesDifference.seq;
         break;
     case TLValue::UpdatesDifference:
-        *this >> result.newMessages;
-        *this >> result.newEncryptedMessages;
-        *this >> result.otherUpdates;
-        *this >> result.chats;
-        *this >> result.users;
-        *this >> result.state;
+        *this >> updatesDifference.newMessages;
+        *this >> updatesDifference.newEncryptedMessages;
+        *this >> updatesDifference.otherUpdates;
+        *this >> updatesDifference.chats;
+        *this >> updatesDifference.users;
+        *this >> updatesDifference.state;
         break;
     case TLValue::UpdatesDifferenceSlice:
-        *this >> result.newMessages;
-        *this >> result.newEncryptedMessages;
-        *this >> result.otherUpdates;
-        *this >> result.chats;
-        *this >> result.users;
-        *this >> result.intermediateState;
+        *this >> updatesDifference.newMessages;
+        *this >> updatesDifference.newEncryptedMessages;
+        *this >> updatesDifference.otherUpdates;
+        *this >> updatesDifference.chats;
+        *this >> updatesDifference.users;
+        *this >> updatesDifference.intermediateState;
         break;
     default:
         break;
     }
 
-    updatesDifference = result;
-
     return *this;
 }
 
@@ -3492,8 +3471,12 @@ CTelegramStream &CTelegramStream::operator<<(const TLVector<T> &v)
     if (v.tlType == TLValue::Vector) {
         *this << quint32(v.count());
 
-        for (int i = 0; i < v.count(); ++i) {
-            *this << v.at(i);
+        if (TLVectorTraits<T>::IsPod) {
+            write(v.constData(), v.count() * sizeof(T));
+        } else {
+            for (int i = 0; i < v.count(); ++i) {
+                *this << v.at(i);
+            }
         }
     }
 
@@ -3502,24 +3485,43 @@ CTelegramStream &CTelegramStream::operator<<(const TLVector<T> &v)
 
 CTelegramStream &CTelegramStream::operator<<(const QByteArray &data)
 {
-    quint32 length = data.size();
+    writeByteArray(data.constData(), data.size());
+    return *this;
+}
+
+CTelegramStream &CTelegramStream::operator<<(const QString &str)
+{
+    // Short strings are encoded on the stack; a UTF-16 unit takes up to 3 bytes in UTF-8.
+    QVarLengthArray<char, 1024> buffer(str.size() * 3);
+
+    const int length = utf16ToUtf8((const ushort *) str.constData(), str.size(), (uchar *) buffer.data());
+
+    if (length < 0) {
+        return *this << str.toUtf8();
+    }
+
+    writeByteArray(buffer.constData(), length);
+    return *this;
+}
+
+void CTelegramStream::writeByteArray(const char *data, int size)
+{
+    quint32 length = size;
 
     if (length < 0xfe) {
         const char lengthToWrite = length;
         write(&lengthToWrite, 1);
-        write(data.constData(), data.size());
+        write(data, size);
         length += 1;
     } else {
         *this << quint32((length << 8) + 0xfe);
-        write(data.constData(), data.size());
+        write(data, size);
         length += 4;
     }
 
     if (length & 3) {
         write(s_nulls, 4 - (length & 3));
     }
-
-    return *this;
 }
 
 CTelegramStream &CTelegramStream::operator<<(const TLDcOption &dcOption)
@@ -3534,6 +3536,41 @@ CTelegramStream &CTelegramStream::operator<<(const TLDcOption &dcOption)
     return *this;
 }
 
+CTelegramStream &CTelegramStream::operator<<(const TLFutureSalt &futureSalt)
+{
+    *this << futureSalt.validSince;
+    *this << futureSalt.validUntil;
+    *this << futureSalt.salt;
+
+    return *this;
+}
+
+int CTelegramStream::serializedSize(const QString &str)
+{
+    // Length of the UTF-8 representation, without a conversion
+    int length = 0;
+
+    const QChar *c = str.constData();
+    const QChar *end = c + str.size();
+
+    for (; c != end; ++c) {
+        const ushort u = c->unicode();
+
+        if (u < 0x80) {
+            length += 1;
+        } else if (u < 0x800) {
+            length += 2;
+        } else if (QChar::isHighSurrogate(u) && (c + 1 != end) && QChar::isLowSurrogate((c + 1)->unicode())) {
+            length += 4;
+            ++c;
+        } else {
+            length += 3;
+        }
+    }
+
+    return byteArraySize(length);
+}
+
 // Generated write operators implementation
 CTelegramStream &CTelegramStream::operator<<(const TLAccountDaysTTL &accountDaysTTL)
 {
@@ -4187,3 +4224,657 @@ CTelegramStream &CTelegramStream::operator<<(const TLInputPrivacyRule &inputPriv
 }
 
 // End of generated write operators implementation
+
+// Generated serialized size functions implementation
+int CTelegramStream::serializedSize(const TLAccountDaysTTL &accountDaysTTL)
+{
+    int size = serializedSize(accountDaysTTL.tlType);
+
+    switch (accountDaysTTL.tlType) {
+    case TLValue::AccountDaysTTL:
+        size += serializedSize(accountDaysTTL.days);
+        break;
+    default:
+        break;
+    }
+
+    return size;
+}
+
+int CTelegramStream::serializedSize(const TLAccountPasswordInputSettings &accountPasswordInputSettings)
+{
+    int size = serializedSize(accountPasswordInputSettings.tlType);
+
+    switch (accountPasswordInputSettings.tlType) {
+    case TLValue::AccountPasswordInputSettings:
+        size += serializedSize(accountPasswordInputSettings.flags);
+        if (accountPasswordInputSettings.flags & 1 << 0) {
+            size += serializedSize(accountPasswordInputSettings.newSalt);
+        }
+        if (accountPasswordInputSettings.flags & 1 << 0) {
+            size += serializedSize(accountPasswordInputSettings.newPasswordHash);
+        }
+        if (accountPasswordInputSettings.flags & 1 << 0) {
+            size += serializedSize(accountPasswordInputSettings.hint);
+        }
+        if (accountPasswordInputSettings.flags & 1 << 1) {
+            size += serializedSize(accountPasswordInputSettings.email);
+        }
+        break;
+    default:
+        break;
+    }
+
+    return size;
+}
+
+int CTelegramStream::serializedSize(const TLInputAppEvent &inputAppEvent)
+{
+    int size = serializedSize(inputAppEvent.tlType);
+
+    switch (inputAppEvent.tlType) {
+    case TLValue::InputAppEvent:
+        size += serializedSize(inputAppEvent.time);
+        size += serializedSize(inputAppEvent.type);
+        size += serializedSize(inputAppEvent.peer);
+        size += serializedSize(inputAppEvent.data);
+        break;
+    default:
+        break;
+    }
+
+    return size;
+}
+
+int CTelegramStream::serializedSize(const TLInputAudio &inputAudio)
+{
+    int size = serializedSize(inputAudio.tlType);
+
+    switch (inputAudio.tlType) {
+    case TLValue::InputAudioEmpty:
+        break;
+    case TLValue::InputAudio:
+        size += serializedSize(inputAudio.id);
+        size += serializedSize(inputAudio.accessHash);
+        break;
+    default:
+        break;
+    }
+
+    return size;
+}
+
+int CTelegramStream::serializedSize(const TLInputContact &inputContact)
+{
+    int size = serializedSize(inputContact.tlType);
+
+    switch (inputContact.tlType) {
+    case TLValue::InputPhoneContact:
+        size += serializedSize(inputContact.clientId);
+        size += serializedSize(inputContact.phone);
+        size += serializedSize(inputContact.firstName);
+        size += serializedSize(inputContact.lastName);
+        break;
+    default:
+        break;
+    }
+
+    return size;
+}
+
+int CTelegramStream::serializedSize(const TLInputDocument &inputDocument)
+{
+    int size = serializedSize(inputDocument.tlType);
+
+    switch (inputDocument.tlType) {
+    case TLValue::InputDocumentEmpty:
+        break;
+    case TLValue::InputDocument:
+        size += serializedSize(inputDocument.id);
+        size += serializedSize(inputDocument.accessHash);
+        break;
+    default:
+        break;
+    }
+
+    return size;
+}
+
+int CTelegramStream::serializedSize(const TLInputEncryptedChat &inputEncryptedChat)
+{
+    int size = serializedSize(inputEncryptedChat.tlType);
+
+    switch (inputEncryptedChat.tlType) {
+    case TLValue::InputEncryptedChat:
+        size += serializedSize(inputEncryptedChat.chatId);
+        size += serializedSize(inputEncryptedChat.accessHash);
+        break;
+    default:
+        break;
+    }
+
+    return size;
+}
+
+int CTelegramStream::serializedSize(const TLInputEncryptedFile &inputEncryptedFile)
+{
+    int size = serializedSize(inputEncryptedFile.tlType);
+
+    switch (inputEncryptedFile.tlType) {
+    case TLValue::InputEncryptedFileEmpty:
+        break;
+    case TLValue::InputEncryptedFileUploaded:
+        size += serializedSize(inputEncryptedFile.id);
+        size += serializedSize(inputEncryptedFile.parts);
+        size += serializedSize(inputEncryptedFile.md5Checksum);
+        size += serializedSize(inputEncryptedFile.keyFingerprint);
+        break;
+    case TLValue::InputEncryptedFile:
+        size += serializedSize(inputEncryptedFile.id);
+        size += serializedSize(inputEncryptedFile.accessHash);
+        break;
+    case TLValue::InputEncryptedFileBigUploaded:
+        size += serializedSize(inputEncryptedFile.id);
+        size += serializedSize(inputEncryptedFile.parts);
+        size += serializedSize(inputEncryptedFile.keyFingerprint);
+        break;
+    default:
+        break;
+    }
+
+    return size;
+}
+
+int CTelegramStream::serializedSize(const TLInputFile &inputFile)
+{
+    int size = serializedSize(inputFile.tlType);
+
+    switch (inputFile.tlType) {
+    case TLValue::InputFile:
+        size += serializedSize(inputFile.id);
+        size += serializedSize(inputFile.parts);
+        size += serializedSize(inputFile.name);
+        size += serializedSize(inputFile.md5Checksum);
+        break;
+    case TLValue::InputFileBig:
+        size += serializedSize(inputFile.id);
+        size += serializedSize(inputFile.parts);
+        size += serializedSize(inputFile.name);
+        break;
+    default:
+        break;
+    }
+
+    return size;
+}
+
+int CTelegramStream::serializedSize(const TLInputFileLocation &inputFileLocation)
+{
+    int size = serializedSize(inputFileLocation.tlType);
+
+    switch (inputFileLocation.tlType) {
+    case TLValue::InputFileLocation:
+        size += serializedSize(inputFileLocation.volumeId);
+        size += serializedSize(inputFileLocation.localId);
+        size += serializedSize(inputFileLocation.secret);
+        break;
+    case TLValue::InputVideoFileLocation:
+        size += serializedSize(inputFileLocation.id);
+        size += serializedSize(inputFileLocation.accessHash);
+        break;
+    case TLValue::InputEncryptedFileLocation:
+        size += serializedSize(inputFileLocation.id);
+        size += serializedSize(inputFileLocation.accessHash);
+        break;
+    case TLValue::InputAudioFileLocation:
+        size += serializedSize(inputFileLocation.id);
+        size += serializedSize(inputFileLocation.accessHash);
+        break;
+    case TLValue::InputDocumentFileLocation:
+        size += serializedSize(inputFileLocation.id);
+        size += serializedSize(inputFileLocation.accessHash);
+        break;
+    default:
+        break;
+    }
+
+    return size;
+}
+
+int CTelegramStream::serializedSize(const TLInputGeoChat &inputGeoChat)
+{
+    int size = serializedSize(inputGeoChat.tlType);
+
+    switch (inputGeoChat.tlType) {
+    case TLValue::InputGeoChat:
+        size += serializedSize(inputGeoChat.chatId);
+        size += serializedSize(inputGeoChat.accessHash);
+        break;
+    default:
+        break;
+    }
+
+    return size;
+}
+
+int CTelegramStream::serializedSize(const TLInputGeoPoint &inputGeoPoint)
+{
+    int size = serializedSize(inputGeoPoint.tlType);
+
+    switch (inputGeoPoint.tlType) {
+    case TLValue::InputGeoPointEmpty:
+        break;
+    case TLValue::InputGeoPoint:
+        size += serializedSize(inputGeoPoint.latitude);
+        size += serializedSize(inputGeoPoint.longitude);
+        break;
+    default:
+        break;
+    }
+
+    return size;
+}
+
+int CTelegramStream::serializedSize(const TLInputPeer &inputPeer)
+{
+    int size = serializedSize(inputPeer.tlType);
+
+    switch (inputPeer.tlType) {
+    case TLValue::InputPeerEmpty:
+        break;
+    case TLValue::InputPeerSelf:
+        break;
+    case TLValue::InputPeerContact:
+        size += serializedSize(inputPeer.userId);
+        break;
+    case TLValue::InputPeerForeign:
+        size += serializedSize(inputPeer.userId);
+        size += serializedSize(inputPeer.accessHash);
+        break;
+    case TLValue::InputPeerChat:
+        size += serializedSize(inputPeer.chatId);
+        break;
+    default:
+        break;
+    }
+
+    return size;
+}
+
+int CTelegramStream::serializedSize(const TLInputPeerNotifySettings &inputPeerNotifySettings)
+{
+    int size = serializedSize(inputPeerNotifySettings.tlType);
+
+    switch (inputPeerNotifySettings.tlType) {
+    case TLValue::InputPeerNotifySettings:
+        size += serializedSize(inputPeerNotifySettings.muteUntil);
+        size += serializedSize(inputPeerNotifySettings.sound);
+        size += serializedSize(inputPeerNotifySettings.showPreviews);
+        size += serializedSize(inputPeerNotifySettings.eventsMask);
+        break;
+    default:
+        break;
+    }
+
+    return size;
+}
+
+int CTelegramStream::serializedSize(const TLInputPhoto &inputPhoto)
+{
+    int size = serializedSize(inputPhoto.tlType);
+
+    switch (inputPhoto.tlType) {
+    case TLValue::InputPhotoEmpty:
+        break;
+    case TLValue::InputPhoto:
+        size += serializedSize(inputPhoto.id);
+        size += serializedSize(inputPhoto.accessHash);
+        break;
+    default:
+        break;
+    }
+
+    return size;
+}
+
+int CTelegramStream::serializedSize(const TLInputPhotoCrop &inputPhotoCrop)
+{
+    int size = serializedSize(inputPhotoCrop.tlType);
+
+    switch (inputPhotoCrop.tlType) {
+    case TLValue::InputPhotoCropAuto:
+        break;
+    case TLValue::InputPhotoCrop:
+        size += serializedSize(inputPhotoCrop.cropLeft);
+        size += serializedSize(inputPhotoCrop.cropTop);
+        size += serializedSize(inputPhotoCrop.cropWidth);
+        break;
+    default:
+        break;
+    }
+
+    return size;
+}
+
+int CTelegramStream::serializedSize(const TLInputPrivacyKey &inputPrivacyKey)
+{
+    int size = serializedSize(inputPrivacyKey.tlType);
+
+    switch (inputPrivacyKey.tlType) {
+    case TLValue::InputPrivacyKeyStatusTimestamp:
+        break;
+    default:
+        break;
+    }
+
+    return size;
+}
+
+int CTelegramStream::serializedSize(const TLInputStickerSet &inputStickerSet)
+{
+    int size = serializedSize(inputStickerSet.tlType);
+
+    switch (inputStickerSet.tlType) {
+    case TLValue::InputStickerSetEmpty:
+        break;
+    case TLValue::InputStickerSetID:
+        size += serializedSize(inputStickerSet.id);
+        size += serializedSize(inputStickerSet.accessHash);
+        break;
+    case TLValue::InputStickerSetShortName:
+        size += serializedSize(inputStickerSet.shortName);
+        break;
+    default:
+        break;
+    }
+
+    return size;
+}
+
+int CTelegramStream::serializedSize(const TLInputUser &inputUser)
+{
+    int size = serializedSize(inputUser.tlType);
+
+    switch (inputUser.tlType) {
+    case TLValue::InputUserEmpty:
+        break;
+    case TLValue::InputUserSelf:
+        break;
+    case TLValue::InputUserContact:
+        size += serializedSize(inputUser.userId);
+        break;
+    case TLValue::InputUserForeign:
+        size += serializedSize(inputUser.userId);
+        size += serializedSize(inputUser.accessHash);
+        break;
+    default:
+        break;
+    }
+
+    return size;
+}
+
+int CTelegramStream::serializedSize(const TLInputVideo &inputVideo)
+{
+    int size = serializedSize(inputVideo.tlType);
+
+    switch (inputVideo.tlType) {
+    case TLValue::InputVideoEmpty:
+        break;
+    case TLValue::InputVideo:
+        size += serializedSize(inputVideo.id);
+        size += serializedSize(inputVideo.accessHash);
+        break;
+    default:
+        break;
+    }
+
+    return size;
+}
+
+int CTelegramStream::serializedSize(const TLMessagesFilter &messagesFilter)
+{
+    int size = serializedSize(messagesFilter.tlType);
+
+    switch (messagesFilter.tlType) {
+    case TLValue::InputMessagesFilterEmpty:
+        break;
+    case TLValue::InputMessagesFilterPhotos:
+        break;
+    case TLValue::InputMessagesFilterVideo:
+        break;
+    case TLValue::InputMessagesFilterPhotoVideo:
+        break;
+    case TLValue::InputMessagesFilterPhotoVideoDocuments:
+        break;
+    case TLValue::InputMessagesFilterDocument:
+        break;
+    case TLValue::InputMessagesFilterAudio:
+        break;
+    default:
+        break;
+    }
+
+    return size;
+}
+
+int CTelegramStream::serializedSize(const TLSendMessageAction &sendMessageAction)
+{
+    int size = serializedSize(sendMessageAction.tlType);
+
+    switch (sendMessageAction.tlType) {
+    case TLValue::SendMessageTypingAction:
+        break;
+    case TLValue::SendMessageCancelAction:
+        break;
+    case TLValue::SendMessageRecordVideoAction:
+        break;
+    case TLValue::SendMessageUploadVideoAction:
+        size += serializedSize(sendMessageAction.progress);
+        break;
+    case TLValue::SendMessageRecordAudioAction:
+        break;
+    case TLValue::SendMessageUploadAudioAction:
+        size += serializedSize(sendMessageAction.progress);
+        break;
+    case TLValue::SendMessageUploadPhotoAction:
+        size += serializedSize(sendMessageAction.progress);
+        break;
+    case TLValue::SendMessageUploadDocumentAction:
+        size += serializedSize(sendMessageAction.progress);
+        break;
+    case TLValue::SendMessageGeoLocationAction:
+        break;
+    case TLValue::SendMessageChooseContactAction:
+        break;
+    default:
+        break;
+    }
+
+    return size;
+}
+
+int CTelegramStream::serializedSize(const TLDocumentAttribute &documentAttribute)
+{
+    int size = serializedSize(documentAttribute.tlType);
+
+    switch (documentAttribute.tlType) {
+    case TLValue::DocumentAttributeImageSize:
+        size += serializedSize(documentAttribute.w);
+        size += serializedSize(documentAttribute.h);
+        break;
+    case TLValue::DocumentAttributeAnimated:
+        break;
+    case TLValue::DocumentAttributeSticker:
+        size += serializedSize(documentAttribute.alt);
+        size += serializedSize(documentAttribute.stickerset);
+        break;
+    case TLValue::DocumentAttributeVideo:
+        size += serializedSize(documentAttribute.duration);
+        size += serializedSize(documentAttribute.w);
+        size += serializedSize(documentAttribute.h);
+        break;
+    case TLValue::DocumentAttributeAudio:
+        size += serializedSize(documentAttribute.duration);
+        break;
+    case TLValue::DocumentAttributeFilename:
+        size += serializedSize(documentAttribute.fileName);
+        break;
+    default:
+        break;
+    }
+
+    return size;
+}
+
+int CTelegramStream::serializedSize(const TLInputChatPhoto &inputChatPhoto)
+{
+    int size = serializedSize(inputChatPhoto.tlType);
+
+    switch (inputChatPhoto.tlType) {
+    case TLValue::InputChatPhotoEmpty:
+        break;
+    case TLValue::InputChatUploadedPhoto:
+        size += serializedSize(inputChatPhoto.file);
+        size += serializedSize(inputChatPhoto.crop);
+        break;
+    case TLValue::InputChatPhoto:
+        size += serializedSize(inputChatPhoto.id);
+        size += serializedSize(inputChatPhoto.crop);
+        break;
+    default:
+        break;
+    }
+
+    return size;
+}
+
+int CTelegramStream::serializedSize(const TLInputMedia &inputMedia)
+{
+    int size = serializedSize(inputMedia.tlType);
+
+    switch (inputMedia.tlType) {
+    case TLValue::InputMediaEmpty:
+        break;
+    case TLValue::InputMediaUploadedPhoto:
+        size += serializedSize(inputMedia.file);
+        size += serializedSize(inputMedia.caption);
+        break;
+    case TLValue::InputMediaPhoto:
+        size += serializedSize(inputMedia.idInputPhoto);
+        size += serializedSize(inputMedia.caption);
+        break;
+    case TLValue::InputMediaGeoPoint:
+        size += serializedSize(inputMedia.geoPoint);
+        break;
+    case TLValue::InputMediaContact:
+        size += serializedSize(inputMedia.phoneNumber);
+        size += serializedSize(inputMedia.firstName);
+        size += serializedSize(inputMedia.lastName);
+        break;
+    case TLValue::InputMediaUploadedVideo:
+        size += serializedSize(inputMedia.file);
+        size += serializedSize(inputMedia.duration);
+        size += serializedSize(inputMedia.w);
+        size += serializedSize(inputMedia.h);
+        size += serializedSize(inputMedia.caption);
+        break;
+    case TLValue::InputMediaUploadedThumbVideo:
+        size += serializedSize(inputMedia.file);
+        size += serializedSize(inputMedia.thumb);
+        size += serializedSize(inputMedia.duration);
+        size += serializedSize(inputMedia.w);
+        size += serializedSize(inputMedia.h);
+        size += serializedSize(inputMedia.caption);
+        break;
+    case TLValue::InputMediaVideo:
+        size += serializedSize(inputMedia.idInputVeo);
+        size += serializedSize(inputMedia.caption);
+        break;
+    case TLValue::InputMediaUploadedAudio:
+        size += serializedSize(inputMedia.file);
+        size += serializedSize(inputMedia.duration);
+        size += serializedSize(inputMedia.mimeType);
+        break;
+    case TLValue::InputMediaAudio:
+        size += serializedSize(inputMedia.idInputAudio);
+        break;
+    case TLValue::InputMediaUploadedDocument:
+        size += serializedSize(inputMedia.file);
+        size += serializedSize(inputMedia.mimeType);
+        size += serializedSize(inputMedia.attributes);
+        break;
+    case TLValue::InputMediaUploadedThumbDocument:
+        size += serializedSize(inputMedia.file);
+        size += serializedSize(inputMedia.thumb);
+        size += serializedSize(inputMedia.mimeType);
+        size += serializedSize(inputMedia.attributes);
+        break;
+    case TLValue::InputMediaDocument:
+        size += serializedSize(inputMedia.idInputDocument);
+        break;
+    case TLValue::InputMediaVenue:
+        size += serializedSize(inputMedia.geoPoint);
+        size += serializedSize(inputMedia.title);
+        size += serializedSize(inputMedia.address);
+        size += serializedSize(inputMedia.provider);
+        size += serializedSize(inputMedia.venueId);
+        break;
+    default:
+        break;
+    }
+
+    return size;
+}
+
+int CTelegramStream::serializedSize(const TLInputNotifyPeer &inputNotifyPeer)
+{
+    int size = serializedSize(inputNotifyPeer.tlType);
+
+    switch (inputNotifyPeer.tlType) {
+    case TLValue::InputNotifyPeer:
+        size += serializedSize(inputNotifyPeer.peerInput);
+        break;
+    case TLValue::InputNotifyUsers:
+        break;
+    case TLValue::InputNotifyChats:
+        break;
+    case TLValue::InputNotifyAll:
+        break;
+    case TLValue::InputNotifyGeoChatPeer:
+        size += serializedSize(inputNotifyPeer.peerInputGeoChat);
+        break;
+    default:
+        break;
+    }
+
+    return size;
+}
+
+int CTelegramStream::serializedSize(const TLInputPrivacyRule &inputPrivacyRule)
+{
+    int size = serializedSize(inputPrivacyRule.tlType);
+
+    switch (inputPrivacyRule.tlType) {
+    case TLValue::InputPrivacyValueAllowContacts:
+        break;
+    case TLValue::InputPrivacyValueAllowAll:
+        break;
+    case TLValue::InputPrivacyValueAllowUsers:
+        size += serializedSize(inputPrivacyRule.users);
+        break;
+    case TLValue::InputPrivacyValueDisallowContacts:
+        break;
+    case TLValue::InputPrivacyValueDisallowAll:
+        break;
+    case TLValue::InputPrivacyValueDisallowUsers:
+        size += serializedSize(inputPrivacyRule.users);
+        break;
+    default:
+        break;
+    }
+
+    return size;
+}
+
+// End of generated serialized size functions implementation
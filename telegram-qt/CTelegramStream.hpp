@@ -24,11 +24,28 @@
 #include "CRawStream.hpp"
 #include "TLTypes.hpp"
 
+// The vectors of the types, which have the same representation in memory and on the wire,
+// are read and written as one block of memory.
+template <typename T>
+struct TLVectorTraits
+{
+    enum { IsPod = false };
+};
+
+#if Q_BYTE_ORDER == Q_LITTLE_ENDIAN
+template <> struct TLVectorTraits<qint32> { enum { IsPod = true }; };
+template <> struct TLVectorTraits<quint32> { enum { IsPod = true }; };
+template <> struct TLVectorTraits<qint64> { enum { IsPod = true }; };
+template <> struct TLVectorTraits<quint64> { enum { IsPod = true }; };
+template <> struct TLVectorTraits<double> { enum { IsPod = true }; };
+#endif
+
 class CTelegramStream : public CRawStream
 {
 public:
     explicit CTelegramStream(QByteArray *data, bool write);
     explicit CTelegramStream(const QByteArray &data);
+    explicit CTelegramStream(const char *data, int size);
 
     explicit CTelegramStream(QIODevice *d = 0);
 
@@ -36,13 +53,21 @@ public:
     using CRawStream::operator >>;
 
     CTelegramStream &operator>>(QByteArray &data);
+
+    // Reads TL bytes without a copy (see CRawStream::readBytesView()).
+    QByteArray readByteArrayView();
     CTelegramStream &operator>>(QString &str);
 
     CTelegramStream &operator>>(bool &data);
 
+    CTelegramStream &operator>>(TLFutureSalt &futureSalt);
+
     template <typename T>
     CTelegramStream &operator>>(TLVector<T> &v);
 
+    template <typename T>
+    CTelegramStream &operator>>(TLShared<T> &value);
+
     // Generated read operators
     CTelegramStream &operator>>(TLAccountDaysTTL &accountDaysTTL);
     CTelegramStream &operator>>(TLAccountPassword &accountPassword);
@@ -173,6 +198,7 @@ public:
     CTelegramStream &operator<<(const bool &data);
 
     CTelegramStream &operator<<(const TLDcOption &dcOption);
+    CTelegramStream &operator<<(const TLFutureSalt &futureSalt);
 
     // Generated write operators
     CTelegramStream &operator<<(const TLAccountDaysTTL &accountDaysTTL);
@@ -207,15 +233,64 @@ public:
     template <typename T>
     CTelegramStream &operator<<(const TLVector<T> &v);
 
-};
+    template <typename T>
+    CTelegramStream &operator<<(const TLShared<T> &value);
 
-inline CTelegramStream &CTelegramStream::operator>>(QString &str)
-{
-    QByteArray data;
-    *this >> data;
-    str = QString::fromUtf8(data);
-    return *this;
-}
+    // The size of the serialized data (the same as written by the operators above)
+    static int serializedSize(bool data);
+    static int serializedSize(quint32 i);
+    static int serializedSize(quint64 i);
+    static int serializedSize(double d);
+    static int serializedSize(TLValue v);
+    static int serializedSize(const QByteArray &data);
+    static int serializedSize(const QString &str);
+
+    template <int Size>
+    static int serializedSize(const TLNumbers<Size> &n);
+
+    template <typename T>
+    static int serializedSize(const TLVector<T> &v);
+
+    template <typename T>
+    static int serializedSize(const TLShared<T> &value);
+
+    // Generated serialized size functions
+    static int serializedSize(const TLAccountDaysTTL &accountDaysTTL);
+    static int serializedSize(const TLAccountPasswordInputSettings &accountPasswordInputSettings);
+    static int serializedSize(const TLInputAppEvent &inputAppEvent);
+    static int serializedSize(const TLInputAudio &inputAudio);
+    static int serializedSize(const TLInputContact &inputContact);
+    static int serializedSize(const TLInputDocument &inputDocument);
+    static int serializedSize(const TLInputEncryptedChat &inputEncryptedChat);
+    static int serializedSize(const TLInputEncryptedFile &inputEncryptedFile);
+    static int serializedSize(const TLInputFile &inputFile);
+    static int serializedSize(const TLInputFileLocation &inputFileLocation);
+    static int serializedSize(const TLInputGeoChat &inputGeoChat);
+    static int serializedSize(const TLInputGeoPoint &inputGeoPoint);
+    static int serializedSize(const TLInputPeer &inputPeer);
+    static int serializedSize(const TLInputPeerNotifySettings &inputPeerNotifySettings);
+    static int serializedSize(const TLInputPhoto &inputPhoto);
+    static int serializedSize(const TLInputPhotoCrop &inputPhotoCrop);
+    static int serializedSize(const TLInputPrivacyKey &inputPrivacyKey);
+    static int serializedSize(const TLInputStickerSet &inputStickerSet);
+    static int serializedSize(const TLInputUser &inputUser);
+    static int serializedSize(const TLInputVideo &inputVideo);
+    static int serializedSize(const TLMessagesFilter &messagesFilter);
+    static int serializedSize(const TLSendMessageAction &sendMessageAction);
+    static int serializedSize(const TLDocumentAttribute &documentAttribute);
+    static int serializedSize(const TLInputChatPhoto &inputChatPhoto);
+    static int serializedSize(const TLInputMedia &inputMedia);
+    static int serializedSize(const TLInputNotifyPeer &inputNotifyPeer);
+    static int serializedSize(const TLInputPrivacyRule &inputPrivacyRule);
+    // End of generated serialized size functions
+
+    static int byteArraySize(int length);
+
+private:
+    quint32 readByteArrayLength(quint32 *paddingSize);
+    void writeByteArray(const char *data, int size);
+
+};
 
 inline CTelegramStream &CTelegramStream::operator>>(bool &data)
 {
@@ -231,11 +306,6 @@ inline CTelegramStream &CTelegramStream::operator>>(bool &data)
     return *this;
 }
 
-inline CTelegramStream &CTelegramStream::operator<<(const QString &str)
-{
-    return *this << str.toUtf8();
-}
-
 inline CTelegramStream &CTelegramStream::operator<<(const bool &data)
 {
     if (data) {
@@ -247,4 +317,91 @@ inline CTelegramStream &CTelegramStream::operator<<(const bool &data)
     return *this;
 }
 
+inline int CTelegramStream::serializedSize(bool data)
+{
+    Q_UNUSED(data)
+    return 4;
+}
+
+inline int CTelegramStream::serializedSize(quint32 i)
+{
+    Q_UNUSED(i)
+    return 4;
+}
+
+inline int CTelegramStream::serializedSize(quint64 i)
+{
+    Q_UNUSED(i)
+    return 8;
+}
+
+inline int CTelegramStream::serializedSize(double d)
+{
+    Q_UNUSED(d)
+    return 8;
+}
+
+inline int CTelegramStream::serializedSize(TLValue v)
+{
+    Q_UNUSED(v)
+    return 4;
+}
+
+inline int CTelegramStream::serializedSize(const QByteArray &data)
+{
+    return byteArraySize(data.size());
+}
+
+template <int Size>
+int CTelegramStream::serializedSize(const TLNumbers<Size> &n)
+{
+    Q_UNUSED(n)
+    return Size / 8;
+}
+
+template <typename T>
+int CTelegramStream::serializedSize(const TLVector<T> &v)
+{
+    int size = serializedSize(v.tlType);
+
+    if (v.tlType == TLValue::Vector) {
+        size += 4; // Count
+
+        if (TLVectorTraits<T>::IsPod) {
+            return size + v.count() * sizeof(T);
+        }
+
+        for (int i = 0; i < v.count(); ++i) {
+            size += serializedSize(v.at(i));
+        }
+    }
+
+    return size;
+}
+
+template <typename T>
+int CTelegramStream::serializedSize(const TLShared<T> &value)
+{
+    return serializedSize(*value);
+}
+
+template <typename T>
+CTelegramStream &CTelegramStream::operator>>(TLShared<T> &value)
+{
+    return *this >> *value;
+}
+
+template <typename T>
+CTelegramStream &CTelegramStream::operator<<(const TLShared<T> &value)
+{
+    return *this << *value;
+}
+
+inline int CTelegramStream::byteArraySize(int length)
+{
+    // One or four bytes of the length, the data and the padding to four bytes
+    const int size = length + (length < 0xfe ? 1 : 4);
+    return (size + 3) & ~3;
+}
+
 #endif // CTELEGRAMSTREAM_HPP
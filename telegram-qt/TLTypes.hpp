@@ -22,6 +22,7 @@
 
 #include <QMetaType>
 #include <QVector>
+#include <QSharedData>
 
 template <typename T>
 class TLVector : public QVector<T>
@@ -42,6 +43,81 @@ public:
     TLValue tlType;
 };
 
+// Implicitly shared (copy-on-write) handle of a TL object.
+// A copy of the handle costs one reference count increment, so it is cheap to pass it by value (e.g. in queued signals).
+// A null handle reads as a default constructed object; non-const access allocates or detaches the object.
+template <typename T>
+class TLShared
+{
+public:
+    inline TLShared() { }
+    inline TLShared(const T &value) : d(new Data(value)) { }
+
+    TLShared &operator=(const T &value) {
+        d = new Data(value);
+        return *this;
+    }
+
+    inline bool isNull() const { return !d; }
+    inline void clear() { d = QSharedDataPointer<Data>(); }
+
+    inline const T &operator*() const { return d ? d->value : defaultValue(); }
+    inline const T *operator->() const { return &operator*(); }
+    inline operator const T &() const { return operator*(); }
+
+    inline T &operator*() { allocate(); return d->value; }
+    inline T *operator->() { allocate(); return &d->value; }
+
+private:
+    struct Data : public QSharedData {
+        Data() { }
+        Data(const T &v) : value(v) { }
+        T value;
+    };
+
+    void allocate() {
+        if (!d) {
+            d = new Data();
+        }
+    }
+
+    static const T &defaultValue() {
+        static const T value = T();
+        return value;
+    }
+
+    QSharedDataPointer<Data> d;
+};
+
+// Object member of a TL type, which belongs to only some constructors of the type (or depends on flags).
+// The members of the inactive constructors take only a pointer, because a null value is not allocated.
+template <typename T>
+class TLOptional : public TLShared<T>
+{
+public:
+    inline TLOptional() { }
+    inline TLOptional(const T &value) : TLShared<T>(value) { }
+
+    TLOptional &operator=(const T &value) {
+        TLShared<T>::operator=(value);
+        return *this;
+    }
+};
+
+// MTProto service type, which is not a part of the API scheme. Serialized as a bare type.
+struct TLFutureSalt {
+    TLFutureSalt() :
+        validSince(0),
+        validUntil(0),
+        salt(0),
+        tlType(TLValue::FutureSalt) { }
+
+    quint32 validSince;
+    quint32 validUntil;
+    quint64 salt;
+    TLValue tlType;
+};
+
 // Generated TLTypes
 struct TLAccountDaysTTL {
     TLAccountDaysTTL() :
@@ -342,7 +418,7 @@ struct TLEncryptedMessage {
     quint32 chatId;
     quint32 date;
     QByteArray bytes;
-    TLEncryptedFile file;
+    TLOptional<TLEncryptedFile> file;
     TLValue tlType;
 };
 
@@ -697,7 +773,7 @@ struct TLMessagesSentEncryptedMessage {
         tlType(TLValue::MessagesSentEncryptedMessage) { }
 
     quint32 date;
-    TLEncryptedFile file;
+    TLOptional<TLEncryptedFile> file;
     TLValue tlType;
 };
 
@@ -753,7 +829,7 @@ struct TLPhotoSize {
         tlType(TLValue::PhotoSizeEmpty) { }
 
     QString type;
-    TLFileLocation location;
+    TLOptional<TLFileLocation> location;
     quint32 w;
     quint32 h;
     quint32 size;
@@ -859,8 +935,8 @@ struct TLUserProfilePhoto {
         tlType(TLValue::UserProfilePhotoEmpty) { }
 
     quint64 photoId;
-    TLFileLocation photoSmall;
-    TLFileLocation photoBig;
+    TLOptional<TLFileLocation> photoSmall;
+    TLOptional<TLFileLocation> photoBig;
     TLValue tlType;
 };
 
@@ -894,7 +970,7 @@ struct TLVideo {
     quint32 date;
     quint32 duration;
     quint32 size;
-    TLPhotoSize thumb;
+    TLOptional<TLPhotoSize> thumb;
     quint32 dcId;
     quint32 w;
     quint32 h;
@@ -928,8 +1004,8 @@ struct TLChatPhoto {
     TLChatPhoto() :
         tlType(TLValue::ChatPhotoEmpty) { }
 
-    TLFileLocation photoSmall;
-    TLFileLocation photoBig;
+    TLOptional<TLFileLocation> photoSmall;
+    TLOptional<TLFileLocation> photoBig;
     TLValue tlType;
 };
 
@@ -1009,7 +1085,7 @@ struct TLDocumentAttribute {
     quint32 w;
     quint32 h;
     QString alt;
-    TLInputStickerSet stickerset;
+    TLOptional<TLInputStickerSet> stickerset;
     quint32 duration;
     QString fileName;
     TLValue tlType;
@@ -1019,9 +1095,9 @@ struct TLInputChatPhoto {
     TLInputChatPhoto() :
         tlType(TLValue::InputChatPhotoEmpty) { }
 
-    TLInputFile file;
-    TLInputPhotoCrop crop;
-    TLInputPhoto id;
+    TLOptional<TLInputFile> file;
+    TLOptional<TLInputPhotoCrop> crop;
+    TLOptional<TLInputPhoto> id;
     TLValue tlType;
 };
 
@@ -1032,22 +1108,22 @@ struct TLInputMedia {
         h(0),
         tlType(TLValue::InputMediaEmpty) { }
 
-    TLInputFile file;
+    TLOptional<TLInputFile> file;
     QString caption;
-    TLInputPhoto idInputPhoto;
-    TLInputGeoPoint geoPoint;
+    TLOptional<TLInputPhoto> idInputPhoto;
+    TLOptional<TLInputGeoPoint> geoPoint;
     QString phoneNumber;
     QString firstName;
     QString lastName;
     quint32 duration;
     quint32 w;
     quint32 h;
-    TLInputFile thumb;
-    TLInputVideo idInputVeo;
+    TLOptional<TLInputFile> thumb;
+    TLOptional<TLInputVideo> idInputVeo;
     QString mimeType;
-    TLInputAudio idInputAudio;
+    TLOptional<TLInputAudio> idInputAudio;
     TLVector<TLDocumentAttribute> attributes;
-    TLInputDocument idInputDocument;
+    TLOptional<TLInputDocument> idInputDocument;
     QString title;
     QString address;
     QString provider;
@@ -1059,8 +1135,8 @@ struct TLInputNotifyPeer {
     TLInputNotifyPeer() :
         tlType(TLValue::InputNotifyPeer) { }
 
-    TLInputPeer peerInput;
-    TLInputGeoChat peerInputGeoChat;
+    TLOptional<TLInputPeer> peerInput;
+    TLOptional<TLInputGeoChat> peerInputGeoChat;
     TLValue tlType;
 };
 
@@ -1076,7 +1152,7 @@ struct TLNotifyPeer {
     TLNotifyPeer() :
         tlType(TLValue::NotifyPeer) { }
 
-    TLPeer peer;
+    TLOptional<TLPeer> peer;
     TLValue tlType;
 };
 
@@ -1092,7 +1168,7 @@ struct TLPhoto {
     quint64 accessHash;
     quint32 userId;
     quint32 date;
-    TLGeoPoint geo;
+    TLOptional<TLGeoPoint> geo;
     TLVector<TLPhotoSize> sizes;
     TLValue tlType;
 };
@@ -1108,8 +1184,8 @@ struct TLUser {
     QString lastName;
     QString username;
     QString phone;
-    TLUserProfilePhoto photo;
-    TLUserStatus status;
+    TLOptional<TLUserProfilePhoto> photo;
+    TLOptional<TLUserStatus> status;
     quint64 accessHash;
     TLValue tlType;
 };
@@ -1133,7 +1209,7 @@ struct TLWebPage {
     QString siteName;
     QString title;
     QString description;
-    TLPhoto photo;
+    TLOptional<TLPhoto> photo;
     QString embedUrl;
     QString embedType;
     quint32 embedWidth;
@@ -1175,7 +1251,7 @@ struct TLChat {
 
     quint32 id;
     QString title;
-    TLChatPhoto photo;
+    TLOptional<TLChatPhoto> photo;
     quint32 participantsCount;
     quint32 date;
     bool left;
@@ -1183,7 +1259,7 @@ struct TLChat {
     quint64 accessHash;
     QString address;
     QString venue;
-    TLGeoPoint geo;
+    TLOptional<TLGeoPoint> geo;
     bool checkedIn;
     TLValue tlType;
 };
@@ -1205,7 +1281,7 @@ struct TLChatInvite {
     TLChatInvite() :
         tlType(TLValue::ChatInviteAlready) { }
 
-    TLChat chat;
+    TLOptional<TLChat> chat;
     QString title;
     TLValue tlType;
 };
@@ -1282,7 +1358,7 @@ struct TLDocument {
     quint32 date;
     QString mimeType;
     quint32 size;
-    TLPhotoSize thumb;
+    TLOptional<TLPhotoSize> thumb;
     quint32 dcId;
     TLVector<TLDocumentAttribute> attributes;
     TLValue tlType;
@@ -1305,7 +1381,7 @@ struct TLMessageAction {
 
     QString title;
     TLVector<quint32> users;
-    TLPhoto photo;
+    TLOptional<TLPhoto> photo;
     quint32 userId;
     QString address;
     quint32 inviterId;
@@ -1317,17 +1393,17 @@ struct TLMessageMedia {
         userId(0),
         tlType(TLValue::MessageMediaEmpty) { }
 
-    TLPhoto photo;
+    TLOptional<TLPhoto> photo;
     QString caption;
-    TLVideo video;
-    TLGeoPoint geo;
+    TLOptional<TLVideo> video;
+    TLOptional<TLGeoPoint> geo;
     QString phoneNumber;
     QString firstName;
     QString lastName;
     quint32 userId;
-    TLDocument document;
-    TLAudio audio;
-    TLWebPage webpage;
+    TLOptional<TLDocument> document;
+    TLOptional<TLAudio> audio;
+    TLOptional<TLWebPage> webpage;
     QString title;
     QString address;
     QString provider;
@@ -1450,8 +1526,8 @@ struct TLGeoChatMessage {
     quint32 fromId;
     quint32 date;
     QString message;
-    TLMessageMedia media;
-    TLMessageAction action;
+    TLOptional<TLMessageMedia> media;
+    TLOptional<TLMessageAction> action;
     TLValue tlType;
 };
 
@@ -1504,14 +1580,14 @@ struct TLMessage {
     quint32 id;
     quint32 flags;
     quint32 fromId;
-    TLPeer toId;
+    TLOptional<TLPeer> toId;
     quint32 fwdFromId;
     quint32 fwdDate;
     quint32 replyToMsgId;
     quint32 date;
     QString message;
-    TLMessageMedia media;
-    TLMessageAction action;
+    TLOptional<TLMessageMedia> media;
+    TLOptional<TLMessageAction> action;
     TLValue tlType;
 };
 
@@ -1560,49 +1636,49 @@ struct TLUpdate {
         maxId(0),
         tlType(TLValue::UpdateNewMessage) { }
 
-    TLMessage message;
+    TLOptional<TLMessage> message;
     quint32 pts;
     quint32 ptsCount;
     quint32 id;
     quint64 randomId;
     TLVector<quint32> messages;
     quint32 userId;
-    TLSendMessageAction action;
+    TLOptional<TLSendMessageAction> action;
     quint32 chatId;
-    TLChatParticipants participants;
-    TLUserStatus status;
+    TLOptional<TLChatParticipants> participants;
+    TLOptional<TLUserStatus> status;
     QString firstName;
     QString lastName;
     QString username;
     quint32 date;
-    TLUserProfilePhoto photo;
+    TLOptional<TLUserProfilePhoto> photo;
     bool previous;
-    TLContactLink myLink;
-    TLContactLink foreignLink;
+    TLOptional<TLContactLink> myLink;
+    TLOptional<TLContactLink> foreignLink;
     quint64 authKeyId;
     QString device;
     QString location;
-    TLGeoChatMessage messageGeoChat;
-    TLEncryptedMessage messageEncrypted;
+    TLOptional<TLGeoChatMessage> messageGeoChat;
+    TLOptional<TLEncryptedMessage> messageEncrypted;
     quint32 qts;
-    TLEncryptedChat chat;
+    TLOptional<TLEncryptedChat> chat;
     quint32 maxDate;
     quint32 inviterId;
     quint32 version;
     TLVector<TLDcOption> dcOptions;
     bool blocked;
-    TLNotifyPeer peerNotify;
-    TLPeerNotifySettings notifySettings;
+    TLOptional<TLNotifyPeer> peerNotify;
+    TLOptional<TLPeerNotifySettings> notifySettings;
     QString type;
     QString messageQString;
-    TLMessageMedia media;
+    TLOptional<TLMessageMedia> media;
     bool popup;
-    TLPrivacyKey key;
+    TLOptional<TLPrivacyKey> key;
     TLVector<TLPrivacyRule> rules;
     QString phone;
-    TLPeer peer;
+    TLOptional<TLPeer> peer;
     quint32 maxId;
-    TLWebPage webpage;
+    TLOptional<TLWebPage> webpage;
     TLValue tlType;
 };
 
@@ -1635,7 +1711,7 @@ struct TLUpdates {
     quint32 replyToMsgId;
     quint32 fromId;
     quint32 chatId;
-    TLUpdate update;
+    TLOptional<TLUpdate> update;
     TLVector<TLUpdate> updates;
     TLVector<TLUser> users;
     TLVector<TLChat> chats;
@@ -1657,8 +1733,8 @@ struct TLUpdatesDifference {
     TLVector<TLUpdate> otherUpdates;
     TLVector<TLChat> chats;
     TLVector<TLUser> users;
-    TLUpdatesState state;
-    TLUpdatesState intermediateState;
+    TLOptional<TLUpdatesState> state;
+    TLOptional<TLUpdatesState> intermediateState;
     TLValue tlType;
 };
 
@@ -1667,5 +1743,39 @@ struct TLUpdatesDifference {
 Q_DECLARE_METATYPE(TLUploadFile)
 Q_DECLARE_METATYPE(QVector<TLUser>)
 Q_DECLARE_METATYPE(TLUpdates)
+// The results of the hand-written handlers, which are not generated as the shared results
+Q_DECLARE_METATYPE(TLShared<TLMessagesSentMessage>)
+Q_DECLARE_METATYPE(TLShared<TLChatFull>)
+
+// Generated shared results meta types
+Q_DECLARE_METATYPE(TLShared<TLAccountAuthorizations>)
+Q_DECLARE_METATYPE(TLShared<TLAccountDaysTTL>)
+Q_DECLARE_METATYPE(TLShared<TLAccountPassword>)
+Q_DECLARE_METATYPE(TLShared<TLAccountPasswordSettings>)
+Q_DECLARE_METATYPE(TLShared<TLAccountPrivacyRules>)
+Q_DECLARE_METATYPE(TLShared<TLAccountSentChangePhoneCode>)
+Q_DECLARE_METATYPE(TLShared<TLAuthAuthorization>)
+Q_DECLARE_METATYPE(TLShared<TLAuthPasswordRecovery>)
+Q_DECLARE_METATYPE(TLShared<TLChatInvite>)
+Q_DECLARE_METATYPE(TLShared<TLContactsBlocked>)
+Q_DECLARE_METATYPE(TLShared<TLContactsFound>)
+Q_DECLARE_METATYPE(TLShared<TLContactsLink>)
+Q_DECLARE_METATYPE(TLShared<TLContactsSuggested>)
+Q_DECLARE_METATYPE(TLShared<TLEncryptedChat>)
+Q_DECLARE_METATYPE(TLShared<TLExportedChatInvite>)
+Q_DECLARE_METATYPE(TLShared<TLMessageMedia>)
+Q_DECLARE_METATYPE(TLShared<TLMessagesAffectedHistory>)
+Q_DECLARE_METATYPE(TLShared<TLMessagesAffectedMessages>)
+Q_DECLARE_METATYPE(TLShared<TLMessagesAllStickers>)
+Q_DECLARE_METATYPE(TLShared<TLMessagesDhConfig>)
+Q_DECLARE_METATYPE(TLShared<TLMessagesDialogs>)
+Q_DECLARE_METATYPE(TLShared<TLMessagesMessages>)
+Q_DECLARE_METATYPE(TLShared<TLMessagesSentEncryptedMessage>)
+Q_DECLARE_METATYPE(TLShared<TLMessagesStickerSet>)
+Q_DECLARE_METATYPE(TLShared<TLMessagesStickers>)
+Q_DECLARE_METATYPE(TLShared<TLPeerNotifySettings>)
+Q_DECLARE_METATYPE(TLShared<TLUpdates>)
+Q_DECLARE_METATYPE(TLShared<TLUser>)
+// End of generated shared results meta types
 
 #endif // TLTYPES_HPP
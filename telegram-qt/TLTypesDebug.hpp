@@ -145,4 +145,10 @@ QDebug operator<<(QDebug d, const TLUpdates &updates);
 QDebug operator<<(QDebug d, const TLUpdatesDifference &updatesDifference);
 // End of generated TLTypes debug operators
 
+template <typename T>
+QDebug operator<<(QDebug d, const TLShared<T> &value)
+{
+    return d << *value;
+}
+
 #endif // TLTYPESDEBUG_HPP
@@ -546,9 +546,7 @@ public:
     }
 
     QString toString() const;
-#ifdef DEVELOPER_BUILD
     static TLValue firstFromArray(const QByteArray &data);
-#endif
 
 private:
     Value m_value;
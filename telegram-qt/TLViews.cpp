@@ -0,0 +1,1918 @@
+/*
+   Copyright (C) 2014-2015 Alexandr Akulich <akulichalexander@gmail.com>
+
+   This file is a part of TelegramQt library.
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+ */
+
+#include "TLViews.hpp"
+
+#include <QtEndian>
+
+enum TLSchemaFieldKind {
+    FieldBool,
+    FieldInt,
+    FieldLong,
+    FieldDouble,
+    FieldBytes,
+    FieldObject,
+    FieldVector
+};
+
+struct TLSchemaField {
+    quint8 kind;
+    quint8 elementKind; // Kind of the vector elements
+    qint16 typeIndex; // Type of the object (or of the vector elements)
+    quint8 memberIndex; // Index of the member in the TL type
+    qint8 flagBit; // -1 for the fields, which do not depend on flags
+    quint8 flagFieldIndex; // Index of the flags field in the constructor
+};
+
+struct TLSchemaConstructor {
+    quint32 id;
+    quint16 firstField;
+    quint16 fieldsCount;
+};
+
+struct TLSchemaType {
+    quint16 firstConstructor;
+    quint16 constructorsCount;
+    quint16 membersCount;
+};
+
+// Generated TL schema
+enum TLSchemaTypeIndex {
+    TypeAccountDaysTTL,
+    TypeAccountPassword,
+    TypeAccountPasswordInputSettings,
+    TypeAccountPasswordSettings,
+    TypeAccountSentChangePhoneCode,
+    TypeAudio,
+    TypeAuthCheckedPhone,
+    TypeAuthExportedAuthorization,
+    TypeAuthPasswordRecovery,
+    TypeAuthSentCode,
+    TypeAuthorization,
+    TypeChatLocated,
+    TypeChatParticipant,
+    TypeChatParticipants,
+    TypeContact,
+    TypeContactBlocked,
+    TypeContactFound,
+    TypeContactLink,
+    TypeContactSuggested,
+    TypeDcOption,
+    TypeDisabledFeature,
+    TypeEncryptedChat,
+    TypeEncryptedFile,
+    TypeEncryptedMessage,
+    TypeError,
+    TypeExportedChatInvite,
+    TypeFileLocation,
+    TypeGeoPoint,
+    TypeHelpAppUpdate,
+    TypeHelpInviteText,
+    TypeImportedContact,
+    TypeInputAppEvent,
+    TypeInputAudio,
+    TypeInputContact,
+    TypeInputDocument,
+    TypeInputEncryptedChat,
+    TypeInputEncryptedFile,
+    TypeInputFile,
+    TypeInputFileLocation,
+    TypeInputGeoChat,
+    TypeInputGeoPoint,
+    TypeInputPeer,
+    TypeInputPeerNotifyEvents,
+    TypeInputPeerNotifySettings,
+    TypeInputPhoto,
+    TypeInputPhotoCrop,
+    TypeInputPrivacyKey,
+    TypeInputStickerSet,
+    TypeInputUser,
+    TypeInputVideo,
+    TypeMessagesAffectedHistory,
+    TypeMessagesAffectedMessages,
+    TypeMessagesDhConfig,
+    TypeMessagesFilter,
+    TypeMessagesSentEncryptedMessage,
+    TypeNearestDc,
+    TypePeer,
+    TypePeerNotifyEvents,
+    TypePeerNotifySettings,
+    TypePhotoSize,
+    TypePrivacyKey,
+    TypePrivacyRule,
+    TypeReceivedNotifyMessage,
+    TypeSendMessageAction,
+    TypeStickerPack,
+    TypeStickerSet,
+    TypeStorageFileType,
+    TypeUpdatesState,
+    TypeUploadFile,
+    TypeUserProfilePhoto,
+    TypeUserStatus,
+    TypeVideo,
+    TypeWallPaper,
+    TypeAccountAuthorizations,
+    TypeChatPhoto,
+    TypeConfig,
+    TypeContactStatus,
+    TypeDialog,
+    TypeDocumentAttribute,
+    TypeInputChatPhoto,
+    TypeInputMedia,
+    TypeInputNotifyPeer,
+    TypeInputPrivacyRule,
+    TypeNotifyPeer,
+    TypePhoto,
+    TypeUser,
+    TypeWebPage,
+    TypeAccountPrivacyRules,
+    TypeAuthAuthorization,
+    TypeChat,
+    TypeChatFull,
+    TypeChatInvite,
+    TypeContactsBlocked,
+    TypeContactsContacts,
+    TypeContactsFound,
+    TypeContactsImportedContacts,
+    TypeContactsLink,
+    TypeContactsSuggested,
+    TypeDocument,
+    TypeHelpSupport,
+    TypeMessageAction,
+    TypeMessageMedia,
+    TypeMessagesAllStickers,
+    TypeMessagesChatFull,
+    TypeMessagesChats,
+    TypeMessagesSentMessage,
+    TypeMessagesStickerSet,
+    TypeMessagesStickers,
+    TypePhotosPhoto,
+    TypePhotosPhotos,
+    TypeUserFull,
+    TypeGeoChatMessage,
+    TypeGeochatsLocated,
+    TypeGeochatsMessages,
+    TypeGeochatsStatedMessage,
+    TypeMessage,
+    TypeMessagesDialogs,
+    TypeMessagesMessages,
+    TypeUpdate,
+    TypeUpdates,
+    TypeUpdatesDifference,
+};
+
+static const TLSchemaField s_schemaFields[] = {
+    // AccountDaysTTL
+    { FieldInt, 0, -1, 0, -1, 0 }, // days
+    // AccountNoPassword
+    { FieldBytes, 0, -1, 0, -1, 0 }, // newSalt
+    { FieldBytes, 0, -1, 1, -1, 0 }, // emailUnconfirmedPattern
+    // AccountPassword
+    { FieldBytes, 0, -1, 2, -1, 0 }, // currentSalt
+    { FieldBytes, 0, -1, 0, -1, 0 }, // newSalt
+    { FieldBytes, 0, -1, 3, -1, 0 }, // hint
+    { FieldBool, 0, -1, 4, -1, 0 }, // hasRecovery
+    { FieldBytes, 0, -1, 1, -1, 0 }, // emailUnconfirmedPattern
+    // AccountPasswordInputSettings
+    { FieldInt, 0, -1, 0, -1, 0 }, // flags
+    { FieldBytes, 0, -1, 1, 0, 0 }, // newSalt
+    { FieldBytes, 0, -1, 2, 0, 0 }, // newPasswordHash
+    { FieldBytes, 0, -1, 3, 0, 0 }, // hint
+    { FieldBytes, 0, -1, 4, 1, 0 }, // email
+    // AccountPasswordSettings
+    { FieldBytes, 0, -1, 0, -1, 0 }, // email
+    // AccountSentChangePhoneCode
+    { FieldBytes, 0, -1, 0, -1, 0 }, // phoneCodeHash
+    { FieldInt, 0, -1, 1, -1, 0 }, // sendCallTimeout
+    // AudioEmpty
+    { FieldLong, 0, -1, 0, -1, 0 }, // id
+    // Audio
+    { FieldLong, 0, -1, 0, -1, 0 }, // id
+    { FieldLong, 0, -1, 1, -1, 0 }, // accessHash
+    { FieldInt, 0, -1, 2, -1, 0 }, // userId
+    { FieldInt, 0, -1, 3, -1, 0 }, // date
+    { FieldInt, 0, -1, 4, -1, 0 }, // duration
+    { FieldBytes, 0, -1, 5, -1, 0 }, // mimeType
+    { FieldInt, 0, -1, 6, -1, 0 }, // size
+    { FieldInt, 0, -1, 7, -1, 0 }, // dcId
+    // AuthCheckedPhone
+    { FieldBool, 0, -1, 0, -1, 0 }, // phoneRegistered
+    // AuthExportedAuthorization
+    { FieldInt, 0, -1, 0, -1, 0 }, // id
+    { FieldBytes, 0, -1, 1, -1, 0 }, // bytes
+    // AuthPasswordRecovery
+    { FieldBytes, 0, -1, 0, -1, 0 }, // emailPattern
+    // AuthSentCode
+    { FieldBool, 0, -1, 0, -1, 0 }, // phoneRegistered
+    { FieldBytes, 0, -1, 1, -1, 0 }, // phoneCodeHash
+    { FieldInt, 0, -1, 2, -1, 0 }, // sendCallTimeout
+    { FieldBool, 0, -1, 3, -1, 0 }, // isPassword
+    // AuthSentAppCode
+    { FieldBool, 0, -1, 0, -1, 0 }, // phoneRegistered
+    { FieldBytes, 0, -1, 1, -1, 0 }, // phoneCodeHash
+    { FieldInt, 0, -1, 2, -1, 0 }, // sendCallTimeout
+    { FieldBool, 0, -1, 3, -1, 0 }, // isPassword
+    // Authorization
+    { FieldLong, 0, -1, 0, -1, 0 }, // hash
+    { FieldInt, 0, -1, 1, -1, 0 }, // flags
+    { FieldBytes, 0, -1, 2, -1, 0 }, // deviceModel
+    { FieldBytes, 0, -1, 3, -1, 0 }, // platform
+    { FieldBytes, 0, -1, 4, -1, 0 }, // systemVersion
+    { FieldInt, 0, -1, 5, -1, 0 }, // apiId
+    { FieldBytes, 0, -1, 6, -1, 0 }, // appName
+    { FieldBytes, 0, -1, 7, -1, 0 }, // appVersion
+    { FieldInt, 0, -1, 8, -1, 0 }, // dateCreated
+    { FieldInt, 0, -1, 9, -1, 0 }, // dateActive
+    { FieldBytes, 0, -1, 10, -1, 0 }, // ip
+    { FieldBytes, 0, -1, 11, -1, 0 }, // country
+    { FieldBytes, 0, -1, 12, -1, 0 }, // region
+    // ChatLocated
+    { FieldInt, 0, -1, 0, -1, 0 }, // chatId
+    { FieldInt, 0, -1, 1, -1, 0 }, // distance
+    // ChatParticipant
+    { FieldInt, 0, -1, 0, -1, 0 }, // userId
+    { FieldInt, 0, -1, 1, -1, 0 }, // inviterId
+    { FieldInt, 0, -1, 2, -1, 0 }, // date
+    // ChatParticipantsForbidden
+    { FieldInt, 0, -1, 0, -1, 0 }, // chatId
+    // ChatParticipants
+    { FieldInt, 0, -1, 0, -1, 0 }, // chatId
+    { FieldInt, 0, -1, 1, -1, 0 }, // adminId
+    { FieldVector, FieldObject, TypeChatParticipant, 2, -1, 0 }, // participants
+    { FieldInt, 0, -1, 3, -1, 0 }, // version
+    // Contact
+    { FieldInt, 0, -1, 0, -1, 0 }, // userId
+    { FieldBool, 0, -1, 1, -1, 0 }, // mutual
+    // ContactBlocked
+    { FieldInt, 0, -1, 0, -1, 0 }, // userId
+    { FieldInt, 0, -1, 1, -1, 0 }, // date
+    // ContactFound
+    { FieldInt, 0, -1, 0, -1, 0 }, // userId
+    // ContactSuggested
+    { FieldInt, 0, -1, 0, -1, 0 }, // userId
+    { FieldInt, 0, -1, 1, -1, 0 }, // mutualContacts
+    // DcOption
+    { FieldInt, 0, -1, 0, -1, 0 }, // id
+    { FieldBytes, 0, -1, 1, -1, 0 }, // hostname
+    { FieldBytes, 0, -1, 2, -1, 0 }, // ipAddress
+    { FieldInt, 0, -1, 3, -1, 0 }, // port
+    // DisabledFeature
+    { FieldBytes, 0, -1, 0, -1, 0 }, // feature
+    { FieldBytes, 0, -1, 1, -1, 0 }, // description
+    // EncryptedChatEmpty
+    { FieldInt, 0, -1, 0, -1, 0 }, // id
+    // EncryptedChatWaiting
+    { FieldInt, 0, -1, 0, -1, 0 }, // id
+    { FieldLong, 0, -1, 1, -1, 0 }, // accessHash
+    { FieldInt, 0, -1, 2, -1, 0 }, // date
+    { FieldInt, 0, -1, 3, -1, 0 }, // adminId
+    { FieldInt, 0, -1, 4, -1, 0 }, // participantId
+    // EncryptedChatRequested
+    { FieldInt, 0, -1, 0, -1, 0 }, // id
+    { FieldLong, 0, -1, 1, -1, 0 }, // accessHash
+    { FieldInt, 0, -1, 2, -1, 0 }, // date
+    { FieldInt, 0, -1, 3, -1, 0 }, // adminId
+    { FieldInt, 0, -1, 4, -1, 0 }, // participantId
+    { FieldBytes, 0, -1, 5, -1, 0 }, // gA
+    // EncryptedChat
+    { FieldInt, 0, -1, 0, -1, 0 }, // id
+    { FieldLong, 0, -1, 1, -1, 0 }, // accessHash
+    { FieldInt, 0, -1, 2, -1, 0 }, // date
+    { FieldInt, 0, -1, 3, -1, 0 }, // adminId
+    { FieldInt, 0, -1, 4, -1, 0 }, // participantId
+    { FieldBytes, 0, -1, 6, -1, 0 }, // gAOrB
+    { FieldLong, 0, -1, 7, -1, 0 }, // keyFingerprint
+    // EncryptedChatDiscarded
+    { FieldInt, 0, -1, 0, -1, 0 }, // id
+    // EncryptedFile
+    { FieldLong, 0, -1, 0, -1, 0 }, // id
+    { FieldLong, 0, -1, 1, -1, 0 }, // accessHash
+    { FieldInt, 0, -1, 2, -1, 0 }, // size
+    { FieldInt, 0, -1, 3, -1, 0 }, // dcId
+    { FieldInt, 0, -1, 4, -1, 0 }, // keyFingerprint
+    // EncryptedMessage
+    { FieldLong, 0, -1, 0, -1, 0 }, // randomId
+    { FieldInt, 0, -1, 1, -1, 0 }, // chatId
+    { FieldInt, 0, -1, 2, -1, 0 }, // date
+    { FieldBytes, 0, -1, 3, -1, 0 }, // bytes
+    { FieldObject, 0, TypeEncryptedFile, 4, -1, 0 }, // file
+    // EncryptedMessageService
+    { FieldLong, 0, -1, 0, -1, 0 }, // randomId
+    { FieldInt, 0, -1, 1, -1, 0 }, // chatId
+    { FieldInt, 0, -1, 2, -1, 0 }, // date
+    { FieldBytes, 0, -1, 3, -1, 0 }, // bytes
+    // Error
+    { FieldInt, 0, -1, 0, -1, 0 }, // code
+    { FieldBytes, 0, -1, 1, -1, 0 }, // text
+    // ChatInviteExported
+    { FieldBytes, 0, -1, 0, -1, 0 }, // link
+    // FileLocationUnavailable
+    { FieldLong, 0, -1, 0, -1, 0 }, // volumeId
+    { FieldInt, 0, -1, 1, -1, 0 }, // localId
+    { FieldLong, 0, -1, 2, -1, 0 }, // secret
+    // FileLocation
+    { FieldInt, 0, -1, 3, -1, 0 }, // dcId
+    { FieldLong, 0, -1, 0, -1, 0 }, // volumeId
+    { FieldInt, 0, -1, 1, -1, 0 }, // localId
+    { FieldLong, 0, -1, 2, -1, 0 }, // secret
+    // GeoPoint
+    { FieldDouble, 0, -1, 0, -1, 0 }, // longitude
+    { FieldDouble, 0, -1, 1, -1, 0 }, // latitude
+    // HelpAppUpdate
+    { FieldInt, 0, -1, 0, -1, 0 }, // id
+    { FieldBool, 0, -1, 1, -1, 0 }, // critical
+    { FieldBytes, 0, -1, 2, -1, 0 }, // url
+    { FieldBytes, 0, -1, 3, -1, 0 }, // text
+    // HelpInviteText
+    { FieldBytes, 0, -1, 0, -1, 0 }, // message
+    // ImportedContact
+    { FieldInt, 0, -1, 0, -1, 0 }, // userId
+    { FieldLong, 0, -1, 1, -1, 0 }, // clientId
+    // InputAppEvent
+    { FieldDouble, 0, -1, 0, -1, 0 }, // time
+    { FieldBytes, 0, -1, 1, -1, 0 }, // type
+    { FieldLong, 0, -1, 2, -1, 0 }, // peer
+    { FieldBytes, 0, -1, 3, -1, 0 }, // data
+    // InputAudio
+    { FieldLong, 0, -1, 0, -1, 0 }, // id
+    { FieldLong, 0, -1, 1, -1, 0 }, // accessHash
+    // InputPhoneContact
+    { FieldLong, 0, -1, 0, -1, 0 }, // clientId
+    { FieldBytes, 0, -1, 1, -1, 0 }, // phone
+    { FieldBytes, 0, -1, 2, -1, 0 }, // firstName
+    { FieldBytes, 0, -1, 3, -1, 0 }, // lastName
+    // InputDocument
+    { FieldLong, 0, -1, 0, -1, 0 }, // id
+    { FieldLong, 0, -1, 1, -1, 0 }, // accessHash
+    // InputEncryptedChat
+    { FieldInt, 0, -1, 0, -1, 0 }, // chatId
+    { FieldLong, 0, -1, 1, -1, 0 }, // accessHash
+    // InputEncryptedFileUploaded
+    { FieldLong, 0, -1, 0, -1, 0 }, // id
+    { FieldInt, 0, -1, 1, -1, 0 }, // parts
+    { FieldBytes, 0, -1, 2, -1, 0 }, // md5Checksum
+    { FieldInt, 0, -1, 3, -1, 0 }, // keyFingerprint
+    // InputEncryptedFile
+    { FieldLong, 0, -1, 0, -1, 0 }, // id
+    { FieldLong, 0, -1, 4, -1, 0 }, // accessHash
+    // InputEncryptedFileBigUploaded
+    { FieldLong, 0, -1, 0, -1, 0 }, // id
+    { FieldInt, 0, -1, 1, -1, 0 }, // parts
+    { FieldInt, 0, -1, 3, -1, 0 }, // keyFingerprint
+    // InputFile
+    { FieldLong, 0, -1, 0, -1, 0 }, // id
+    { FieldInt, 0, -1, 1, -1, 0 }, // parts
+    { FieldBytes, 0, -1, 2, -1, 0 }, // name
+    { FieldBytes, 0, -1, 3, -1, 0 }, // md5Checksum
+    // InputFileBig
+    { FieldLong, 0, -1, 0, -1, 0 }, // id
+    { FieldInt, 0, -1, 1, -1, 0 }, // parts
+    { FieldBytes, 0, -1, 2, -1, 0 }, // name
+    // InputFileLocation
+    { FieldLong, 0, -1, 0, -1, 0 }, // volumeId
+    { FieldInt, 0, -1, 1, -1, 0 }, // localId
+    { FieldLong, 0, -1, 2, -1, 0 }, // secret
+    // InputVideoFileLocation
+    { FieldLong, 0, -1, 3, -1, 0 }, // id
+    { FieldLong, 0, -1, 4, -1, 0 }, // accessHash
+    // InputEncryptedFileLocation
+    { FieldLong, 0, -1, 3, -1, 0 }, // id
+    { FieldLong, 0, -1, 4, -1, 0 }, // accessHash
+    // InputAudioFileLocation
+    { FieldLong, 0, -1, 3, -1, 0 }, // id
+    { FieldLong, 0, -1, 4, -1, 0 }, // accessHash
+    // InputDocumentFileLocation
+    { FieldLong, 0, -1, 3, -1, 0 }, // id
+    { FieldLong, 0, -1, 4, -1, 0 }, // accessHash
+    // InputGeoChat
+    { FieldInt, 0, -1, 0, -1, 0 }, // chatId
+    { FieldLong, 0, -1, 1, -1, 0 }, // accessHash
+    // InputGeoPoint
+    { FieldDouble, 0, -1, 0, -1, 0 }, // latitude
+    { FieldDouble, 0, -1, 1, -1, 0 }, // longitude
+    // InputPeerContact
+    { FieldInt, 0, -1, 0, -1, 0 }, // userId
+    // InputPeerForeign
+    { FieldInt, 0, -1, 0, -1, 0 }, // userId
+    { FieldLong, 0, -1, 1, -1, 0 }, // accessHash
+    // InputPeerChat
+    { FieldInt, 0, -1, 2, -1, 0 }, // chatId
+    // InputPeerNotifySettings
+    { FieldInt, 0, -1, 0, -1, 0 }, // muteUntil
+    { FieldBytes, 0, -1, 1, -1, 0 }, // sound
+    { FieldBool, 0, -1, 2, -1, 0 }, // showPreviews
+    { FieldInt, 0, -1, 3, -1, 0 }, // eventsMask
+    // InputPhoto
+    { FieldLong, 0, -1, 0, -1, 0 }, // id
+    { FieldLong, 0, -1, 1, -1, 0 }, // accessHash
+    // InputPhotoCrop
+    { FieldDouble, 0, -1, 0, -1, 0 }, // cropLeft
+    { FieldDouble, 0, -1, 1, -1, 0 }, // cropTop
+    { FieldDouble, 0, -1, 2, -1, 0 }, // cropWidth
+    // InputStickerSetID
+    { FieldLong, 0, -1, 0, -1, 0 }, // id
+    { FieldLong, 0, -1, 1, -1, 0 }, // accessHash
+    // InputStickerSetShortName
+    { FieldBytes, 0, -1, 2, -1, 0 }, // shortName
+    // InputUserContact
+    { FieldInt, 0, -1, 0, -1, 0 }, // userId
+    // InputUserForeign
+    { FieldInt, 0, -1, 0, -1, 0 }, // userId
+    { FieldLong, 0, -1, 1, -1, 0 }, // accessHash
+    // InputVideo
+    { FieldLong, 0, -1, 0, -1, 0 }, // id
+    { FieldLong, 0, -1, 1, -1, 0 }, // accessHash
+    // MessagesAffectedHistory
+    { FieldInt, 0, -1, 0, -1, 0 }, // pts
+    { FieldInt, 0, -1, 1, -1, 0 }, // ptsCount
+    { FieldInt, 0, -1, 2, -1, 0 }, // offset
+    // MessagesAffectedMessages
+    { FieldInt, 0, -1, 0, -1, 0 }, // pts
+    { FieldInt, 0, -1, 1, -1, 0 }, // ptsCount
+    // MessagesDhConfigNotModified
+    { FieldBytes, 0, -1, 0, -1, 0 }, // random
+    // MessagesDhConfig
+    { FieldInt, 0, -1, 1, -1, 0 }, // g
+    { FieldBytes, 0, -1, 2, -1, 0 }, // p
+    { FieldInt, 0, -1, 3, -1, 0 }, // version
+    { FieldBytes, 0, -1, 0, -1, 0 }, // random
+    // MessagesSentEncryptedMessage
+    { FieldInt, 0, -1, 0, -1, 0 }, // date
+    // MessagesSentEncryptedFile
+    { FieldInt, 0, -1, 0, -1, 0 }, // date
+    { FieldObject, 0, TypeEncryptedFile, 1, -1, 0 }, // file
+    // NearestDc
+    { FieldBytes, 0, -1, 0, -1, 0 }, // country
+    { FieldInt, 0, -1, 1, -1, 0 }, // thisDc
+    { FieldInt, 0, -1, 2, -1, 0 }, // nearestDc
+    // PeerUser
+    { FieldInt, 0, -1, 0, -1, 0 }, // userId
+    // PeerChat
+    { FieldInt, 0, -1, 1, -1, 0 }, // chatId
+    // PeerNotifySettings
+    { FieldInt, 0, -1, 0, -1, 0 }, // muteUntil
+    { FieldBytes, 0, -1, 1, -1, 0 }, // sound
+    { FieldBool, 0, -1, 2, -1, 0 }, // showPreviews
+    { FieldInt, 0, -1, 3, -1, 0 }, // eventsMask
+    // PhotoSizeEmpty
+    { FieldBytes, 0, -1, 0, -1, 0 }, // type
+    // PhotoSize
+    { FieldBytes, 0, -1, 0, -1, 0 }, // type
+    { FieldObject, 0, TypeFileLocation, 1, -1, 0 }, // location
+    { FieldInt, 0, -1, 2, -1, 0 }, // w
+    { FieldInt, 0, -1, 3, -1, 0 }, // h
+    { FieldInt, 0, -1, 4, -1, 0 }, // size
+    // PhotoCachedSize
+    { FieldBytes, 0, -1, 0, -1, 0 }, // type
+    { FieldObject, 0, TypeFileLocation, 1, -1, 0 }, // location
+    { FieldInt, 0, -1, 2, -1, 0 }, // w
+    { FieldInt, 0, -1, 3, -1, 0 }, // h
+    { FieldBytes, 0, -1, 5, -1, 0 }, // bytes
+    // PrivacyValueAllowUsers
+    { FieldVector, FieldInt, -1, 0, -1, 0 }, // users
+    // PrivacyValueDisallowUsers
+    { FieldVector, FieldInt, -1, 0, -1, 0 }, // users
+    // ReceivedNotifyMessage
+    { FieldInt, 0, -1, 0, -1, 0 }, // id
+    { FieldInt, 0, -1, 1, -1, 0 }, // flags
+    // SendMessageUploadVideoAction
+    { FieldInt, 0, -1, 0, -1, 0 }, // progress
+    // SendMessageUploadAudioAction
+    { FieldInt, 0, -1, 0, -1, 0 }, // progress
+    // SendMessageUploadPhotoAction
+    { FieldInt, 0, -1, 0, -1, 0 }, // progress
+    // SendMessageUploadDocumentAction
+    { FieldInt, 0, -1, 0, -1, 0 }, // progress
+    // StickerPack
+    { FieldBytes, 0, -1, 0, -1, 0 }, // emoticon
+    { FieldVector, FieldLong, -1, 1, -1, 0 }, // documents
+    // StickerSet
+    { FieldLong, 0, -1, 0, -1, 0 }, // id
+    { FieldLong, 0, -1, 1, -1, 0 }, // accessHash
+    { FieldBytes, 0, -1, 2, -1, 0 }, // title
+    { FieldBytes, 0, -1, 3, -1, 0 }, // shortName
+    // UpdatesState
+    { FieldInt, 0, -1, 0, -1, 0 }, // pts
+    { FieldInt, 0, -1, 1, -1, 0 }, // qts
+    { FieldInt, 0, -1, 2, -1, 0 }, // date
+    { FieldInt, 0, -1, 3, -1, 0 }, // seq
+    { FieldInt, 0, -1, 4, -1, 0 }, // unreadCount
+    // UploadFile
+    { FieldObject, 0, TypeStorageFileType, 0, -1, 0 }, // type
+    { FieldInt, 0, -1, 1, -1, 0 }, // mtime
+    { FieldBytes, 0, -1, 2, -1, 0 }, // bytes
+    // UserProfilePhoto
+    { FieldLong, 0, -1, 0, -1, 0 }, // photoId
+    { FieldObject, 0, TypeFileLocation, 1, -1, 0 }, // photoSmall
+    { FieldObject, 0, TypeFileLocation, 2, -1, 0 }, // photoBig
+    // UserStatusOnline
+    { FieldInt, 0, -1, 0, -1, 0 }, // expires
+    // UserStatusOffline
+    { FieldInt, 0, -1, 1, -1, 0 }, // wasOnline
+    // VideoEmpty
+    { FieldLong, 0, -1, 0, -1, 0 }, // id
+    // Video
+    { FieldLong, 0, -1, 0, -1, 0 }, // id
+    { FieldLong, 0, -1, 1, -1, 0 }, // accessHash
+    { FieldInt, 0, -1, 2, -1, 0 }, // userId
+    { FieldInt, 0, -1, 3, -1, 0 }, // date
+    { FieldInt, 0, -1, 4, -1, 0 }, // duration
+    { FieldInt, 0, -1, 5, -1, 0 }, // size
+    { FieldObject, 0, TypePhotoSize, 6, -1, 0 }, // thumb
+    { FieldInt, 0, -1, 7, -1, 0 }, // dcId
+    { FieldInt, 0, -1, 8, -1, 0 }, // w
+    { FieldInt, 0, -1, 9, -1, 0 }, // h
+    // WallPaper
+    { FieldInt, 0, -1, 0, -1, 0 }, // id
+    { FieldBytes, 0, -1, 1, -1, 0 }, // title
+    { FieldVector, FieldObject, TypePhotoSize, 2, -1, 0 }, // sizes
+    { FieldInt, 0, -1, 3, -1, 0 }, // color
+    // WallPaperSolid
+    { FieldInt, 0, -1, 0, -1, 0 }, // id
+    { FieldBytes, 0, -1, 1, -1, 0 }, // title
+    { FieldInt, 0, -1, 4, -1, 0 }, // bgColor
+    { FieldInt, 0, -1, 3, -1, 0 }, // color
+    // AccountAuthorizations
+    { FieldVector, FieldObject, TypeAuthorization, 0, -1, 0 }, // authorizations
+    // ChatPhoto
+    { FieldObject, 0, TypeFileLocation, 0, -1, 0 }, // photoSmall
+    { FieldObject, 0, TypeFileLocation, 1, -1, 0 }, // photoBig
+    // Config
+    { FieldInt, 0, -1, 0, -1, 0 }, // date
+    { FieldInt, 0, -1, 1, -1, 0 }, // expires
+    { FieldBool, 0, -1, 2, -1, 0 }, // testMode
+    { FieldInt, 0, -1, 3, -1, 0 }, // thisDc
+    { FieldVector, FieldObject, TypeDcOption, 4, -1, 0 }, // dcOptions
+    { FieldInt, 0, -1, 5, -1, 0 }, // chatSizeMax
+    { FieldInt, 0, -1, 6, -1, 0 }, // broadcastSizeMax
+    { FieldInt, 0, -1, 7, -1, 0 }, // forwardedCountMax
+    { FieldInt, 0, -1, 8, -1, 0 }, // onlineUpdatePeriodMs
+    { FieldInt, 0, -1, 9, -1, 0 }, // offlineBlurTimeoutMs
+    { FieldInt, 0, -1, 10, -1, 0 }, // offlineIdleTimeoutMs
+    { FieldInt, 0, -1, 11, -1, 0 }, // onlineCloudTimeoutMs
+    { FieldInt, 0, -1, 12, -1, 0 }, // notifyCloudDelayMs
+    { FieldInt, 0, -1, 13, -1, 0 }, // notifyDefaultDelayMs
+    { FieldInt, 0, -1, 14, -1, 0 }, // chatBigSize
+    { FieldInt, 0, -1, 15, -1, 0 }, // pushChatPeriodMs
+    { FieldInt, 0, -1, 16, -1, 0 }, // pushChatLimit
+    { FieldVector, FieldObject, TypeDisabledFeature, 17, -1, 0 }, // disabledFeatures
+    // ContactStatus
+    { FieldInt, 0, -1, 0, -1, 0 }, // userId
+    { FieldObject, 0, TypeUserStatus, 1, -1, 0 }, // status
+    // Dialog
+    { FieldObject, 0, TypePeer, 0, -1, 0 }, // peer
+    { FieldInt, 0, -1, 1, -1, 0 }, // topMessage
+    { FieldInt, 0, -1, 2, -1, 0 }, // readInboxMaxId
+    { FieldInt, 0, -1, 3, -1, 0 }, // unreadCount
+    { FieldObject, 0, TypePeerNotifySettings, 4, -1, 0 }, // notifySettings
+    // DocumentAttributeImageSize
+    { FieldInt, 0, -1, 0, -1, 0 }, // w
+    { FieldInt, 0, -1, 1, -1, 0 }, // h
+    // DocumentAttributeSticker
+    { FieldBytes, 0, -1, 2, -1, 0 }, // alt
+    { FieldObject, 0, TypeInputStickerSet, 3, -1, 0 }, // stickerset
+    // DocumentAttributeVideo
+    { FieldInt, 0, -1, 4, -1, 0 }, // duration
+    { FieldInt, 0, -1, 0, -1, 0 }, // w
+    { FieldInt, 0, -1, 1, -1, 0 }, // h
+    // DocumentAttributeAudio
+    { FieldInt, 0, -1, 4, -1, 0 }, // duration
+    // DocumentAttributeFilename
+    { FieldBytes, 0, -1, 5, -1, 0 }, // fileName
+    // InputChatUploadedPhoto
+    { FieldObject, 0, TypeInputFile, 0, -1, 0 }, // file
+    { FieldObject, 0, TypeInputPhotoCrop, 1, -1, 0 }, // crop
+    // InputChatPhoto
+    { FieldObject, 0, TypeInputPhoto, 2, -1, 0 }, // id
+    { FieldObject, 0, TypeInputPhotoCrop, 1, -1, 0 }, // crop
+    // InputMediaUploadedPhoto
+    { FieldObject, 0, TypeInputFile, 0, -1, 0 }, // file
+    { FieldBytes, 0, -1, 1, -1, 0 }, // caption
+    // InputMediaPhoto
+    { FieldObject, 0, TypeInputPhoto, 2, -1, 0 }, // idInputPhoto
+    { FieldBytes, 0, -1, 1, -1, 0 }, // caption
+    // InputMediaGeoPoint
+    { FieldObject, 0, TypeInputGeoPoint, 3, -1, 0 }, // geoPoint
+    // InputMediaContact
+    { FieldBytes, 0, -1, 4, -1, 0 }, // phoneNumber
+    { FieldBytes, 0, -1, 5, -1, 0 }, // firstName
+    { FieldBytes, 0, -1, 6, -1, 0 }, // lastName
+    // InputMediaUploadedVideo
+    { FieldObject, 0, TypeInputFile, 0, -1, 0 }, // file
+    { FieldInt, 0, -1, 7, -1, 0 }, // duration
+    { FieldInt, 0, -1, 8, -1, 0 }, // w
+    { FieldInt, 0, -1, 9, -1, 0 }, // h
+    { FieldBytes, 0, -1, 1, -1, 0 }, // caption
+    // InputMediaUploadedThumbVideo
+    { FieldObject, 0, TypeInputFile, 0, -1, 0 }, // file
+    { FieldObject, 0, TypeInputFile, 10, -1, 0 }, // thumb
+    { FieldInt, 0, -1, 7, -1, 0 }, // duration
+    { FieldInt, 0, -1, 8, -1, 0 }, // w
+    { FieldInt, 0, -1, 9, -1, 0 }, // h
+    { FieldBytes, 0, -1, 1, -1, 0 }, // caption
+    // InputMediaVideo
+    { FieldObject, 0, TypeInputVideo, 11, -1, 0 }, // idInputVeo
+    { FieldBytes, 0, -1, 1, -1, 0 }, // caption
+    // InputMediaUploadedAudio
+    { FieldObject, 0, TypeInputFile, 0, -1, 0 }, // file
+    { FieldInt, 0, -1, 7, -1, 0 }, // duration
+    { FieldBytes, 0, -1, 12, -1, 0 }, // mimeType
+    // InputMediaAudio
+    { FieldObject, 0, TypeInputAudio, 13, -1, 0 }, // idInputAudio
+    // InputMediaUploadedDocument
+    { FieldObject, 0, TypeInputFile, 0, -1, 0 }, // file
+    { FieldBytes, 0, -1, 12, -1, 0 }, // mimeType
+    { FieldVector, FieldObject, TypeDocumentAttribute, 14, -1, 0 }, // attributes
+    // InputMediaUploadedThumbDocument
+    { FieldObject, 0, TypeInputFile, 0, -1, 0 }, // file
+    { FieldObject, 0, TypeInputFile, 10, -1, 0 }, // thumb
+    { FieldBytes, 0, -1, 12, -1, 0 }, // mimeType
+    { FieldVector, FieldObject, TypeDocumentAttribute, 14, -1, 0 }, // attributes
+    // InputMediaDocument
+    { FieldObject, 0, TypeInputDocument, 15, -1, 0 }, // idInputDocument
+    // InputMediaVenue
+    { FieldObject, 0, TypeInputGeoPoint, 3, -1, 0 }, // geoPoint
+    { FieldBytes, 0, -1, 16, -1, 0 }, // title
+    { FieldBytes, 0, -1, 17, -1, 0 }, // address
+    { FieldBytes, 0, -1, 18, -1, 0 }, // provider
+    { FieldBytes, 0, -1, 19, -1, 0 }, // venueId
+    // InputNotifyPeer
+    { FieldObject, 0, TypeInputPeer, 0, -1, 0 }, // peerInput
+    // InputNotifyGeoChatPeer
+    { FieldObject, 0, TypeInputGeoChat, 1, -1, 0 }, // peerInputGeoChat
+    // InputPrivacyValueAllowUsers
+    { FieldVector, FieldObject, TypeInputUser, 0, -1, 0 }, // users
+    // InputPrivacyValueDisallowUsers
+    { FieldVector, FieldObject, TypeInputUser, 0, -1, 0 }, // users
+    // NotifyPeer
+    { FieldObject, 0, TypePeer, 0, -1, 0 }, // peer
+    // PhotoEmpty
+    { FieldLong, 0, -1, 0, -1, 0 }, // id
+    // Photo
+    { FieldLong, 0, -1, 0, -1, 0 }, // id
+    { FieldLong, 0, -1, 1, -1, 0 }, // accessHash
+    { FieldInt, 0, -1, 2, -1, 0 }, // userId
+    { FieldInt, 0, -1, 3, -1, 0 }, // date
+    { FieldObject, 0, TypeGeoPoint, 4, -1, 0 }, // geo
+    { FieldVector, FieldObject, TypePhotoSize, 5, -1, 0 }, // sizes
+    // UserEmpty
+    { FieldInt, 0, -1, 0, -1, 0 }, // id
+    // UserSelf
+    { FieldInt, 0, -1, 0, -1, 0 }, // id
+    { FieldBytes, 0, -1, 1, -1, 0 }, // firstName
+    { FieldBytes, 0, -1, 2, -1, 0 }, // lastName
+    { FieldBytes, 0, -1, 3, -1, 0 }, // username
+    { FieldBytes, 0, -1, 4, -1, 0 }, // phone
+    { FieldObject, 0, TypeUserProfilePhoto, 5, -1, 0 }, // photo
+    { FieldObject, 0, TypeUserStatus, 6, -1, 0 }, // status
+    // UserContact
+    { FieldInt, 0, -1, 0, -1, 0 }, // id
+    { FieldBytes, 0, -1, 1, -1, 0 }, // firstName
+    { FieldBytes, 0, -1, 2, -1, 0 }, // lastName
+    { FieldBytes, 0, -1, 3, -1, 0 }, // username
+    { FieldLong, 0, -1, 7, -1, 0 }, // accessHash
+    { FieldBytes, 0, -1, 4, -1, 0 }, // phone
+    { FieldObject, 0, TypeUserProfilePhoto, 5, -1, 0 }, // photo
+    { FieldObject, 0, TypeUserStatus, 6, -1, 0 }, // status
+    // UserRequest
+    { FieldInt, 0, -1, 0, -1, 0 }, // id
+    { FieldBytes, 0, -1, 1, -1, 0 }, // firstName
+    { FieldBytes, 0, -1, 2, -1, 0 }, // lastName
+    { FieldBytes, 0, -1, 3, -1, 0 }, // username
+    { FieldLong, 0, -1, 7, -1, 0 }, // accessHash
+    { FieldBytes, 0, -1, 4, -1, 0 }, // phone
+    { FieldObject, 0, TypeUserProfilePhoto, 5, -1, 0 }, // photo
+    { FieldObject, 0, TypeUserStatus, 6, -1, 0 }, // status
+    // UserForeign
+    { FieldInt, 0, -1, 0, -1, 0 }, // id
+    { FieldBytes, 0, -1, 1, -1, 0 }, // firstName
+    { FieldBytes, 0, -1, 2, -1, 0 }, // lastName
+    { FieldBytes, 0, -1, 3, -1, 0 }, // username
+    { FieldLong, 0, -1, 7, -1, 0 }, // accessHash
+    { FieldObject, 0, TypeUserProfilePhoto, 5, -1, 0 }, // photo
+    { FieldObject, 0, TypeUserStatus, 6, -1, 0 }, // status
+    // UserDeleted
+    { FieldInt, 0, -1, 0, -1, 0 }, // id
+    { FieldBytes, 0, -1, 1, -1, 0 }, // firstName
+    { FieldBytes, 0, -1, 2, -1, 0 }, // lastName
+    { FieldBytes, 0, -1, 3, -1, 0 }, // username
+    // WebPageEmpty
+    { FieldLong, 0, -1, 0, -1, 0 }, // id
+    // WebPagePending
+    { FieldLong, 0, -1, 0, -1, 0 }, // id
+    { FieldInt, 0, -1, 1, -1, 0 }, // date
+    // WebPage
+    { FieldInt, 0, -1, 2, -1, 0 }, // flags
+    { FieldLong, 0, -1, 0, -1, 0 }, // id
+    { FieldBytes, 0, -1, 3, -1, 0 }, // url
+    { FieldBytes, 0, -1, 4, -1, 0 }, // displayUrl
+    { FieldBytes, 0, -1, 5, 0, 0 }, // type
+    { FieldBytes, 0, -1, 6, 1, 0 }, // siteName
+    { FieldBytes, 0, -1, 7, 2, 0 }, // title
+    { FieldBytes, 0, -1, 8, 3, 0 }, // description
+    { FieldObject, 0, TypePhoto, 9, 4, 0 }, // photo
+    { FieldBytes, 0, -1, 10, 5, 0 }, // embedUrl
+    { FieldBytes, 0, -1, 11, 5, 0 }, // embedType
+    { FieldInt, 0, -1, 12, 6, 0 }, // embedWidth
+    { FieldInt, 0, -1, 13, 6, 0 }, // embedHeight
+    { FieldInt, 0, -1, 14, 7, 0 }, // duration
+    { FieldBytes, 0, -1, 15, 8, 0 }, // author
+    // AccountPrivacyRules
+    { FieldVector, FieldObject, TypePrivacyRule, 0, -1, 0 }, // rules
+    { FieldVector, FieldObject, TypeUser, 1, -1, 0 }, // users
+    // AuthAuthorization
+    { FieldInt, 0, -1, 0, -1, 0 }, // expires
+    { FieldObject, 0, TypeUser, 1, -1, 0 }, // user
+    // ChatEmpty
+    { FieldInt, 0, -1, 0, -1, 0 }, // id
+    // Chat
+    { FieldInt, 0, -1, 0, -1, 0 }, // id
+    { FieldBytes, 0, -1, 1, -1, 0 }, // title
+    { FieldObject, 0, TypeChatPhoto, 2, -1, 0 }, // photo
+    { FieldInt, 0, -1, 3, -1, 0 }, // participantsCount
+    { FieldInt, 0, -1, 4, -1, 0 }, // date
+    { FieldBool, 0, -1, 5, -1, 0 }, // left
+    { FieldInt, 0, -1, 6, -1, 0 }, // version
+    // ChatForbidden
+    { FieldInt, 0, -1, 0, -1, 0 }, // id
+    { FieldBytes, 0, -1, 1, -1, 0 }, // title
+    { FieldInt, 0, -1, 4, -1, 0 }, // date
+    // GeoChat
+    { FieldInt, 0, -1, 0, -1, 0 }, // id
+    { FieldLong, 0, -1, 7, -1, 0 }, // accessHash
+    { FieldBytes, 0, -1, 1, -1, 0 }, // title
+    { FieldBytes, 0, -1, 8, -1, 0 }, // address
+    { FieldBytes, 0, -1, 9, -1, 0 }, // venue
+    { FieldObject, 0, TypeGeoPoint, 10, -1, 0 }, // geo
+    { FieldObject, 0, TypeChatPhoto, 2, -1, 0 }, // photo
+    { FieldInt, 0, -1, 3, -1, 0 }, // participantsCount
+    { FieldInt, 0, -1, 4, -1, 0 }, // date
+    { FieldBool, 0, -1, 11, -1, 0 }, // checkedIn
+    { FieldInt, 0, -1, 6, -1, 0 }, // version
+    // ChatFull
+    { FieldInt, 0, -1, 0, -1, 0 }, // id
+    { FieldObject, 0, TypeChatParticipants, 1, -1, 0 }, // participants
+    { FieldObject, 0, TypePhoto, 2, -1, 0 }, // chatPhoto
+    { FieldObject, 0, TypePeerNotifySettings, 3, -1, 0 }, // notifySettings
+    { FieldObject, 0, TypeExportedChatInvite, 4, -1, 0 }, // exportedInvite
+    // ChatInviteAlready
+    { FieldObject, 0, TypeChat, 0, -1, 0 }, // chat
+    // ChatInvite
+    { FieldBytes, 0, -1, 1, -1, 0 }, // title
+    // ContactsBlocked
+    { FieldVector, FieldObject, TypeContactBlocked, 0, -1, 0 }, // blocked
+    { FieldVector, FieldObject, TypeUser, 1, -1, 0 }, // users
+    // ContactsBlockedSlice
+    { FieldInt, 0, -1, 2, -1, 0 }, // count
+    { FieldVector, FieldObject, TypeContactBlocked, 0, -1, 0 }, // blocked
+    { FieldVector, FieldObject, TypeUser, 1, -1, 0 }, // users
+    // ContactsContacts
+    { FieldVector, FieldObject, TypeContact, 0, -1, 0 }, // contacts
+    { FieldVector, FieldObject, TypeUser, 1, -1, 0 }, // users
+    // ContactsFound
+    { FieldVector, FieldObject, TypeContactFound, 0, -1, 0 }, // results
+    { FieldVector, FieldObject, TypeUser, 1, -1, 0 }, // users
+    // ContactsImportedContacts
+    { FieldVector, FieldObject, TypeImportedContact, 0, -1, 0 }, // imported
+    { FieldVector, FieldLong, -1, 1, -1, 0 }, // retryContacts
+    { FieldVector, FieldObject, TypeUser, 2, -1, 0 }, // users
+    // ContactsLink
+    { FieldObject, 0, TypeContactLink, 0, -1, 0 }, // myLink
+    { FieldObject, 0, TypeContactLink, 1, -1, 0 }, // foreignLink
+    { FieldObject, 0, TypeUser, 2, -1, 0 }, // user
+    // ContactsSuggested
+    { FieldVector, FieldObject, TypeContactSuggested, 0, -1, 0 }, // results
+    { FieldVector, FieldObject, TypeUser, 1, -1, 0 }, // users
+    // DocumentEmpty
+    { FieldLong, 0, -1, 0, -1, 0 }, // id
+    // Document
+    { FieldLong, 0, -1, 0, -1, 0 }, // id
+    { FieldLong, 0, -1, 1, -1, 0 }, // accessHash
+    { FieldInt, 0, -1, 2, -1, 0 }, // date
+    { FieldBytes, 0, -1, 3, -1, 0 }, // mimeType
+    { FieldInt, 0, -1, 4, -1, 0 }, // size
+    { FieldObject, 0, TypePhotoSize, 5, -1, 0 }, // thumb
+    { FieldInt, 0, -1, 6, -1, 0 }, // dcId
+    { FieldVector, FieldObject, TypeDocumentAttribute, 7, -1, 0 }, // attributes
+    // HelpSupport
+    { FieldBytes, 0, -1, 0, -1, 0 }, // phoneNumber
+    { FieldObject, 0, TypeUser, 1, -1, 0 }, // user
+    // MessageActionChatCreate
+    { FieldBytes, 0, -1, 0, -1, 0 }, // title
+    { FieldVector, FieldInt, -1, 1, -1, 0 }, // users
+    // MessageActionChatEditTitle
+    { FieldBytes, 0, -1, 0, -1, 0 }, // title
+    // MessageActionChatEditPhoto
+    { FieldObject, 0, TypePhoto, 2, -1, 0 }, // photo
+    // MessageActionChatAddUser
+    { FieldInt, 0, -1, 3, -1, 0 }, // userId
+    // MessageActionChatDeleteUser
+    { FieldInt, 0, -1, 3, -1, 0 }, // userId
+    // MessageActionGeoChatCreate
+    { FieldBytes, 0, -1, 0, -1, 0 }, // title
+    { FieldBytes, 0, -1, 4, -1, 0 }, // address
+    // MessageActionChatJoinedByLink
+    { FieldInt, 0, -1, 5, -1, 0 }, // inviterId
+    // MessageMediaPhoto
+    { FieldObject, 0, TypePhoto, 0, -1, 0 }, // photo
+    { FieldBytes, 0, -1, 1, -1, 0 }, // caption
+    // MessageMediaVideo
+    { FieldObject, 0, TypeVideo, 2, -1, 0 }, // video
+    { FieldBytes, 0, -1, 1, -1, 0 }, // caption
+    // MessageMediaGeo
+    { FieldObject, 0, TypeGeoPoint, 3, -1, 0 }, // geo
+    // MessageMediaContact
+    { FieldBytes, 0, -1, 4, -1, 0 }, // phoneNumber
+    { FieldBytes, 0, -1, 5, -1, 0 }, // firstName
+    { FieldBytes, 0, -1, 6, -1, 0 }, // lastName
+    { FieldInt, 0, -1, 7, -1, 0 }, // userId
+    // MessageMediaDocument
+    { FieldObject, 0, TypeDocument, 8, -1, 0 }, // document
+    // MessageMediaAudio
+    { FieldObject, 0, TypeAudio, 9, -1, 0 }, // audio
+    // MessageMediaWebPage
+    { FieldObject, 0, TypeWebPage, 10, -1, 0 }, // webpage
+    // MessageMediaVenue
+    { FieldObject, 0, TypeGeoPoint, 3, -1, 0 }, // geo
+    { FieldBytes, 0, -1, 11, -1, 0 }, // title
+    { FieldBytes, 0, -1, 12, -1, 0 }, // address
+    { FieldBytes, 0, -1, 13, -1, 0 }, // provider
+    { FieldBytes, 0, -1, 14, -1, 0 }, // venueId
+    // MessagesAllStickers
+    { FieldBytes, 0, -1, 0, -1, 0 }, // hash
+    { FieldVector, FieldObject, TypeStickerPack, 1, -1, 0 }, // packs
+    { FieldVector, FieldObject, TypeStickerSet, 2, -1, 0 }, // sets
+    { FieldVector, FieldObject, TypeDocument, 3, -1, 0 }, // documents
+    // MessagesChatFull
+    { FieldObject, 0, TypeChatFull, 0, -1, 0 }, // fullChat
+    { FieldVector, FieldObject, TypeChat, 1, -1, 0 }, // chats
+    { FieldVector, FieldObject, TypeUser, 2, -1, 0 }, // users
+    // MessagesChats
+    { FieldVector, FieldObject, TypeChat, 0, -1, 0 }, // chats
+    // MessagesSentMessage
+    { FieldInt, 0, -1, 0, -1, 0 }, // id
+    { FieldInt, 0, -1, 1, -1, 0 }, // date
+    { FieldObject, 0, TypeMessageMedia, 2, -1, 0 }, // media
+    { FieldInt, 0, -1, 3, -1, 0 }, // pts
+    { FieldInt, 0, -1, 4, -1, 0 }, // ptsCount
+    // MessagesSentMessageLink
+    { FieldInt, 0, -1, 0, -1, 0 }, // id
+    { FieldInt, 0, -1, 1, -1, 0 }, // date
+    { FieldObject, 0, TypeMessageMedia, 2, -1, 0 }, // media
+    { FieldInt, 0, -1, 3, -1, 0 }, // pts
+    { FieldInt, 0, -1, 4, -1, 0 }, // ptsCount
+    { FieldVector, FieldObject, TypeContactsLink, 5, -1, 0 }, // links
+    { FieldInt, 0, -1, 6, -1, 0 }, // seq
+    // MessagesStickerSet
+    { FieldObject, 0, TypeStickerSet, 0, -1, 0 }, // set
+    { FieldVector, FieldObject, TypeStickerPack, 1, -1, 0 }, // packs
+    { FieldVector, FieldObject, TypeDocument, 2, -1, 0 }, // documents
+    // MessagesStickers
+    { FieldBytes, 0, -1, 0, -1, 0 }, // hash
+    { FieldVector, FieldObject, TypeDocument, 1, -1, 0 }, // stickers
+    // PhotosPhoto
+    { FieldObject, 0, TypePhoto, 0, -1, 0 }, // photo
+    { FieldVector, FieldObject, TypeUser, 1, -1, 0 }, // users
+    // PhotosPhotos
+    { FieldVector, FieldObject, TypePhoto, 0, -1, 0 }, // photos
+    { FieldVector, FieldObject, TypeUser, 1, -1, 0 }, // users
+    // PhotosPhotosSlice
+    { FieldInt, 0, -1, 2, -1, 0 }, // count
+    { FieldVector, FieldObject, TypePhoto, 0, -1, 0 }, // photos
+    { FieldVector, FieldObject, TypeUser, 1, -1, 0 }, // users
+    // UserFull
+    { FieldObject, 0, TypeUser, 0, -1, 0 }, // user
+    { FieldObject, 0, TypeContactsLink, 1, -1, 0 }, // link
+    { FieldObject, 0, TypePhoto, 2, -1, 0 }, // profilePhoto
+    { FieldObject, 0, TypePeerNotifySettings, 3, -1, 0 }, // notifySettings
+    { FieldBool, 0, -1, 4, -1, 0 }, // blocked
+    { FieldBytes, 0, -1, 5, -1, 0 }, // realFirstName
+    { FieldBytes, 0, -1, 6, -1, 0 }, // realLastName
+    // GeoChatMessageEmpty
+    { FieldInt, 0, -1, 0, -1, 0 }, // chatId
+    { FieldInt, 0, -1, 1, -1, 0 }, // id
+    // GeoChatMessage
+    { FieldInt, 0, -1, 0, -1, 0 }, // chatId
+    { FieldInt, 0, -1, 1, -1, 0 }, // id
+    { FieldInt, 0, -1, 2, -1, 0 }, // fromId
+    { FieldInt, 0, -1, 3, -1, 0 }, // date
+    { FieldBytes, 0, -1, 4, -1, 0 }, // message
+    { FieldObject, 0, TypeMessageMedia, 5, -1, 0 }, // media
+    // GeoChatMessageService
+    { FieldInt, 0, -1, 0, -1, 0 }, // chatId
+    { FieldInt, 0, -1, 1, -1, 0 }, // id
+    { FieldInt, 0, -1, 2, -1, 0 }, // fromId
+    { FieldInt, 0, -1, 3, -1, 0 }, // date
+    { FieldObject, 0, TypeMessageAction, 6, -1, 0 }, // action
+    // GeochatsLocated
+    { FieldVector, FieldObject, TypeChatLocated, 0, -1, 0 }, // results
+    { FieldVector, FieldObject, TypeGeoChatMessage, 1, -1, 0 }, // messages
+    { FieldVector, FieldObject, TypeChat, 2, -1, 0 }, // chats
+    { FieldVector, FieldObject, TypeUser, 3, -1, 0 }, // users
+    // GeochatsMessages
+    { FieldVector, FieldObject, TypeGeoChatMessage, 0, -1, 0 }, // messages
+    { FieldVector, FieldObject, TypeChat, 1, -1, 0 }, // chats
+    { FieldVector, FieldObject, TypeUser, 2, -1, 0 }, // users
+    // GeochatsMessagesSlice
+    { FieldInt, 0, -1, 3, -1, 0 }, // count
+    { FieldVector, FieldObject, TypeGeoChatMessage, 0, -1, 0 }, // messages
+    { FieldVector, FieldObject, TypeChat, 1, -1, 0 }, // chats
+    { FieldVector, FieldObject, TypeUser, 2, -1, 0 }, // users
+    // GeochatsStatedMessage
+    { FieldObject, 0, TypeGeoChatMessage, 0, -1, 0 }, // message
+    { FieldVector, FieldObject, TypeChat, 1, -1, 0 }, // chats
+    { FieldVector, FieldObject, TypeUser, 2, -1, 0 }, // users
+    { FieldInt, 0, -1, 3, -1, 0 }, // seq
+    // MessageEmpty
+    { FieldInt, 0, -1, 0, -1, 0 }, // id
+    // Message
+    { FieldInt, 0, -1, 1, -1, 0 }, // flags
+    { FieldInt, 0, -1, 0, -1, 0 }, // id
+    { FieldInt, 0, -1, 2, -1, 0 }, // fromId
+    { FieldObject, 0, TypePeer, 3, -1, 0 }, // toId
+    { FieldInt, 0, -1, 4, 2, 0 }, // fwdFromId
+    { FieldInt, 0, -1, 5, 2, 0 }, // fwdDate
+    { FieldInt, 0, -1, 6, 3, 0 }, // replyToMsgId
+    { FieldInt, 0, -1, 7, -1, 0 }, // date
+    { FieldBytes, 0, -1, 8, -1, 0 }, // message
+    { FieldObject, 0, TypeMessageMedia, 9, -1, 0 }, // media
+    // MessageService
+    { FieldInt, 0, -1, 1, -1, 0 }, // flags
+    { FieldInt, 0, -1, 0, -1, 0 }, // id
+    { FieldInt, 0, -1, 2, -1, 0 }, // fromId
+    { FieldObject, 0, TypePeer, 3, -1, 0 }, // toId
+    { FieldInt, 0, -1, 7, -1, 0 }, // date
+    { FieldObject, 0, TypeMessageAction, 10, -1, 0 }, // action
+    // MessagesDialogs
+    { FieldVector, FieldObject, TypeDialog, 0, -1, 0 }, // dialogs
+    { FieldVector, FieldObject, TypeMessage, 1, -1, 0 }, // messages
+    { FieldVector, FieldObject, TypeChat, 2, -1, 0 }, // chats
+    { FieldVector, FieldObject, TypeUser, 3, -1, 0 }, // users
+    // MessagesDialogsSlice
+    { FieldInt, 0, -1, 4, -1, 0 }, // count
+    { FieldVector, FieldObject, TypeDialog, 0, -1, 0 }, // dialogs
+    { FieldVector, FieldObject, TypeMessage, 1, -1, 0 }, // messages
+    { FieldVector, FieldObject, TypeChat, 2, -1, 0 }, // chats
+    { FieldVector, FieldObject, TypeUser, 3, -1, 0 }, // users
+    // MessagesMessages
+    { FieldVector, FieldObject, TypeMessage, 0, -1, 0 }, // messages
+    { FieldVector, FieldObject, TypeChat, 1, -1, 0 }, // chats
+    { FieldVector, FieldObject, TypeUser, 2, -1, 0 }, // users
+    // MessagesMessagesSlice
+    { FieldInt, 0, -1, 3, -1, 0 }, // count
+    { FieldVector, FieldObject, TypeMessage, 0, -1, 0 }, // messages
+    { FieldVector, FieldObject, TypeChat, 1, -1, 0 }, // chats
+    { FieldVector, FieldObject, TypeUser, 2, -1, 0 }, // users
+    // UpdateNewMessage
+    { FieldObject, 0, TypeMessage, 0, -1, 0 }, // message
+    { FieldInt, 0, -1, 1, -1, 0 }, // pts
+    { FieldInt, 0, -1, 2, -1, 0 }, // ptsCount
+    // UpdateMessageID
+    { FieldInt, 0, -1, 3, -1, 0 }, // id
+    { FieldLong, 0, -1, 4, -1, 0 }, // randomId
+    // UpdateDeleteMessages
+    { FieldVector, FieldInt, -1, 5, -1, 0 }, // messages
+    { FieldInt, 0, -1, 1, -1, 0 }, // pts
+    { FieldInt, 0, -1, 2, -1, 0 }, // ptsCount
+    // UpdateUserTyping
+    { FieldInt, 0, -1, 6, -1, 0 }, // userId
+    { FieldObject, 0, TypeSendMessageAction, 7, -1, 0 }, // action
+    // UpdateChatUserTyping
+    { FieldInt, 0, -1, 8, -1, 0 }, // chatId
+    { FieldInt, 0, -1, 6, -1, 0 }, // userId
+    { FieldObject, 0, TypeSendMessageAction, 7, -1, 0 }, // action
+    // UpdateChatParticipants
+    { FieldObject, 0, TypeChatParticipants, 9, -1, 0 }, // participants
+    // UpdateUserStatus
+    { FieldInt, 0, -1, 6, -1, 0 }, // userId
+    { FieldObject, 0, TypeUserStatus, 10, -1, 0 }, // status
+    // UpdateUserName
+    { FieldInt, 0, -1, 6, -1, 0 }, // userId
+    { FieldBytes, 0, -1, 11, -1, 0 }, // firstName
+    { FieldBytes, 0, -1, 12, -1, 0 }, // lastName
+    { FieldBytes, 0, -1, 13, -1, 0 }, // username
+    // UpdateUserPhoto
+    { FieldInt, 0, -1, 6, -1, 0 }, // userId
+    { FieldInt, 0, -1, 14, -1, 0 }, // date
+    { FieldObject, 0, TypeUserProfilePhoto, 15, -1, 0 }, // photo
+    { FieldBool, 0, -1, 16, -1, 0 }, // previous
+    // UpdateContactRegistered
+    { FieldInt, 0, -1, 6, -1, 0 }, // userId
+    { FieldInt, 0, -1, 14, -1, 0 }, // date
+    // UpdateContactLink
+    { FieldInt, 0, -1, 6, -1, 0 }, // userId
+    { FieldObject, 0, TypeContactLink, 17, -1, 0 }, // myLink
+    { FieldObject, 0, TypeContactLink, 18, -1, 0 }, // foreignLink
+    // UpdateNewAuthorization
+    { FieldLong, 0, -1, 19, -1, 0 }, // authKeyId
+    { FieldInt, 0, -1, 14, -1, 0 }, // date
+    { FieldBytes, 0, -1, 20, -1, 0 }, // device
+    { FieldBytes, 0, -1, 21, -1, 0 }, // location
+    // UpdateNewGeoChatMessage
+    { FieldObject, 0, TypeGeoChatMessage, 22, -1, 0 }, // messageGeoChat
+    // UpdateNewEncryptedMessage
+    { FieldObject, 0, TypeEncryptedMessage, 23, -1, 0 }, // messageEncrypted
+    { FieldInt, 0, -1, 24, -1, 0 }, // qts
+    // UpdateEncryptedChatTyping
+    { FieldInt, 0, -1, 8, -1, 0 }, // chatId
+    // UpdateEncryption
+    { FieldObject, 0, TypeEncryptedChat, 25, -1, 0 }, // chat
+    { FieldInt, 0, -1, 14, -1, 0 }, // date
+    // UpdateEncryptedMessagesRead
+    { FieldInt, 0, -1, 8, -1, 0 }, // chatId
+    { FieldInt, 0, -1, 26, -1, 0 }, // maxDate
+    { FieldInt, 0, -1, 14, -1, 0 }, // date
+    // UpdateChatParticipantAdd
+    { FieldInt, 0, -1, 8, -1, 0 }, // chatId
+    { FieldInt, 0, -1, 6, -1, 0 }, // userId
+    { FieldInt, 0, -1, 27, -1, 0 }, // inviterId
+    { FieldInt, 0, -1, 28, -1, 0 }, // version
+    // UpdateChatParticipantDelete
+    { FieldInt, 0, -1, 8, -1, 0 }, // chatId
+    { FieldInt, 0, -1, 6, -1, 0 }, // userId
+    { FieldInt, 0, -1, 28, -1, 0 }, // version
+    // UpdateDcOptions
+    { FieldVector, FieldObject, TypeDcOption, 29, -1, 0 }, // dcOptions
+    // UpdateUserBlocked
+    { FieldInt, 0, -1, 6, -1, 0 }, // userId
+    { FieldBool, 0, -1, 30, -1, 0 }, // blocked
+    // UpdateNotifySettings
+    { FieldObject, 0, TypeNotifyPeer, 31, -1, 0 }, // peerNotify
+    { FieldObject, 0, TypePeerNotifySettings, 32, -1, 0 }, // notifySettings
+    // UpdateServiceNotification
+    { FieldBytes, 0, -1, 33, -1, 0 }, // type
+    { FieldBytes, 0, -1, 34, -1, 0 }, // messageQString
+    { FieldObject, 0, TypeMessageMedia, 35, -1, 0 }, // media
+    { FieldBool, 0, -1, 36, -1, 0 }, // popup
+    // UpdatePrivacy
+    { FieldObject, 0, TypePrivacyKey, 37, -1, 0 }, // key
+    { FieldVector, FieldObject, TypePrivacyRule, 38, -1, 0 }, // rules
+    // UpdateUserPhone
+    { FieldInt, 0, -1, 6, -1, 0 }, // userId
+    { FieldBytes, 0, -1, 39, -1, 0 }, // phone
+    // UpdateReadHistoryInbox
+    { FieldObject, 0, TypePeer, 40, -1, 0 }, // peer
+    { FieldInt, 0, -1, 41, -1, 0 }, // maxId
+    { FieldInt, 0, -1, 1, -1, 0 }, // pts
+    { FieldInt, 0, -1, 2, -1, 0 }, // ptsCount
+    // UpdateReadHistoryOutbox
+    { FieldObject, 0, TypePeer, 40, -1, 0 }, // peer
+    { FieldInt, 0, -1, 41, -1, 0 }, // maxId
+    { FieldInt, 0, -1, 1, -1, 0 }, // pts
+    { FieldInt, 0, -1, 2, -1, 0 }, // ptsCount
+    // UpdateWebPage
+    { FieldObject, 0, TypeWebPage, 42, -1, 0 }, // webpage
+    // UpdateReadMessagesContents
+    { FieldVector, FieldInt, -1, 5, -1, 0 }, // messages
+    { FieldInt, 0, -1, 1, -1, 0 }, // pts
+    { FieldInt, 0, -1, 2, -1, 0 }, // ptsCount
+    // UpdateShortMessage
+    { FieldInt, 0, -1, 0, -1, 0 }, // flags
+    { FieldInt, 0, -1, 1, -1, 0 }, // id
+    { FieldInt, 0, -1, 2, -1, 0 }, // userId
+    { FieldBytes, 0, -1, 3, -1, 0 }, // message
+    { FieldInt, 0, -1, 4, -1, 0 }, // pts
+    { FieldInt, 0, -1, 5, -1, 0 }, // ptsCount
+    { FieldInt, 0, -1, 6, -1, 0 }, // date
+    { FieldInt, 0, -1, 7, 2, 0 }, // fwdFromId
+    { FieldInt, 0, -1, 8, 2, 0 }, // fwdDate
+    { FieldInt, 0, -1, 9, 3, 0 }, // replyToMsgId
+    // UpdateShortChatMessage
+    { FieldInt, 0, -1, 0, -1, 0 }, // flags
+    { FieldInt, 0, -1, 1, -1, 0 }, // id
+    { FieldInt, 0, -1, 10, -1, 0 }, // fromId
+    { FieldInt, 0, -1, 11, -1, 0 }, // chatId
+    { FieldBytes, 0, -1, 3, -1, 0 }, // message
+    { FieldInt, 0, -1, 4, -1, 0 }, // pts
+    { FieldInt, 0, -1, 5, -1, 0 }, // ptsCount
+    { FieldInt, 0, -1, 6, -1, 0 }, // date
+    { FieldInt, 0, -1, 7, 2, 0 }, // fwdFromId
+    { FieldInt, 0, -1, 8, 2, 0 }, // fwdDate
+    { FieldInt, 0, -1, 9, 3, 0 }, // replyToMsgId
+    // UpdateShort
+    { FieldObject, 0, TypeUpdate, 12, -1, 0 }, // update
+    { FieldInt, 0, -1, 6, -1, 0 }, // date
+    // UpdatesCombined
+    { FieldVector, FieldObject, TypeUpdate, 13, -1, 0 }, // updates
+    { FieldVector, FieldObject, TypeUser, 14, -1, 0 }, // users
+    { FieldVector, FieldObject, TypeChat, 15, -1, 0 }, // chats
+    { FieldInt, 0, -1, 6, -1, 0 }, // date
+    { FieldInt, 0, -1, 16, -1, 0 }, // seqStart
+    { FieldInt, 0, -1, 17, -1, 0 }, // seq
+    // Updates
+    { FieldVector, FieldObject, TypeUpdate, 13, -1, 0 }, // updates
+    { FieldVector, FieldObject, TypeUser, 14, -1, 0 }, // users
+    { FieldVector, FieldObject, TypeChat, 15, -1, 0 }, // chats
+    { FieldInt, 0, -1, 6, -1, 0 }, // date
+    { FieldInt, 0, -1, 17, -1, 0 }, // seq
+    // UpdatesDifferenceEmpty
+    { FieldInt, 0, -1, 0, -1, 0 }, // date
+    { FieldInt, 0, -1, 1, -1, 0 }, // seq
+    // UpdatesDifference
+    { FieldVector, FieldObject, TypeMessage, 2, -1, 0 }, // newMessages
+    { FieldVector, FieldObject, TypeEncryptedMessage, 3, -1, 0 }, // newEncryptedMessages
+    { FieldVector, FieldObject, TypeUpdate, 4, -1, 0 }, // otherUpdates
+    { FieldVector, FieldObject, TypeChat, 5, -1, 0 }, // chats
+    { FieldVector, FieldObject, TypeUser, 6, -1, 0 }, // users
+    { FieldObject, 0, TypeUpdatesState, 7, -1, 0 }, // state
+    // UpdatesDifferenceSlice
+    { FieldVector, FieldObject, TypeMessage, 2, -1, 0 }, // newMessages
+    { FieldVector, FieldObject, TypeEncryptedMessage, 3, -1, 0 }, // newEncryptedMessages
+    { FieldVector, FieldObject, TypeUpdate, 4, -1, 0 }, // otherUpdates
+    { FieldVector, FieldObject, TypeChat, 5, -1, 0 }, // chats
+    { FieldVector, FieldObject, TypeUser, 6, -1, 0 }, // users
+    { FieldObject, 0, TypeUpdatesState, 8, -1, 0 }, // intermediateState
+};
+
+static const TLSchemaConstructor s_schemaConstructors[] = {
+    { TLValue::AccountDaysTTL, 0, 1 },
+    { TLValue::AccountNoPassword, 1, 2 },
+    { TLValue::AccountPassword, 3, 5 },
+    { TLValue::AccountPasswordInputSettings, 8, 5 },
+    { TLValue::AccountPasswordSettings, 13, 1 },
+    { TLValue::AccountSentChangePhoneCode, 14, 2 },
+    { TLValue::AudioEmpty, 16, 1 },
+    { TLValue::Audio, 17, 8 },
+    { TLValue::AuthCheckedPhone, 25, 1 },
+    { TLValue::AuthExportedAuthorization, 26, 2 },
+    { TLValue::AuthPasswordRecovery, 28, 1 },
+    { TLValue::AuthSentCode, 29, 4 },
+    { TLValue::AuthSentAppCode, 33, 4 },
+    { TLValue::Authorization, 37, 13 },
+    { TLValue::ChatLocated, 50, 2 },
+    { TLValue::ChatParticipant, 52, 3 },
+    { TLValue::ChatParticipantsForbidden, 55, 1 },
+    { TLValue::ChatParticipants, 56, 4 },
+    { TLValue::Contact, 60, 2 },
+    { TLValue::ContactBlocked, 62, 2 },
+    { TLValue::ContactFound, 64, 1 },
+    { TLValue::ContactLinkUnknown, 65, 0 },
+    { TLValue::ContactLinkNone, 65, 0 },
+    { TLValue::ContactLinkHasPhone, 65, 0 },
+    { TLValue::ContactLinkContact, 65, 0 },
+    { TLValue::ContactSuggested, 65, 2 },
+    { TLValue::DcOption, 67, 4 },
+    { TLValue::DisabledFeature, 71, 2 },
+    { TLValue::EncryptedChatEmpty, 73, 1 },
+    { TLValue::EncryptedChatWaiting, 74, 5 },
+    { TLValue::EncryptedChatRequested, 79, 6 },
+    { TLValue::EncryptedChat, 85, 7 },
+    { TLValue::EncryptedChatDiscarded, 92, 1 },
+    { TLValue::EncryptedFileEmpty, 93, 0 },
+    { TLValue::EncryptedFile, 93, 5 },
+    { TLValue::EncryptedMessage, 98, 5 },
+    { TLValue::EncryptedMessageService, 103, 4 },
+    { TLValue::Error, 107, 2 },
+    { TLValue::ChatInviteEmpty, 109, 0 },
+    { TLValue::ChatInviteExported, 109, 1 },
+    { TLValue::FileLocationUnavailable, 110, 3 },
+    { TLValue::FileLocation, 113, 4 },
+    { TLValue::GeoPointEmpty, 117, 0 },
+    { TLValue::GeoPoint, 117, 2 },
+    { TLValue::HelpAppUpdate, 119, 4 },
+    { TLValue::HelpNoAppUpdate, 123, 0 },
+    { TLValue::HelpInviteText, 123, 1 },
+    { TLValue::ImportedContact, 124, 2 },
+    { TLValue::InputAppEvent, 126, 4 },
+    { TLValue::InputAudioEmpty, 130, 0 },
+    { TLValue::InputAudio, 130, 2 },
+    { TLValue::InputPhoneContact, 132, 4 },
+    { TLValue::InputDocumentEmpty, 136, 0 },
+    { TLValue::InputDocument, 136, 2 },
+    { TLValue::InputEncryptedChat, 138, 2 },
+    { TLValue::InputEncryptedFileEmpty, 140, 0 },
+    { TLValue::InputEncryptedFileUploaded, 140, 4 },
+    { TLValue::InputEncryptedFile, 144, 2 },
+    { TLValue::InputEncryptedFileBigUploaded, 146, 3 },
+    { TLValue::InputFile, 149, 4 },
+    { TLValue::InputFileBig, 153, 3 },
+    { TLValue::InputFileLocation, 156, 3 },
+    { TLValue::InputVideoFileLocation, 159, 2 },
+    { TLValue::InputEncryptedFileLocation, 161, 2 },
+    { TLValue::InputAudioFileLocation, 163, 2 },
+    { TLValue::InputDocumentFileLocation, 165, 2 },
+    { TLValue::InputGeoChat, 167, 2 },
+    { TLValue::InputGeoPointEmpty, 169, 0 },
+    { TLValue::InputGeoPoint, 169, 2 },
+    { TLValue::InputPeerEmpty, 171, 0 },
+    { TLValue::InputPeerSelf, 171, 0 },
+    { TLValue::InputPeerContact, 171, 1 },
+    { TLValue::InputPeerForeign, 172, 2 },
+    { TLValue::InputPeerChat, 174, 1 },
+    { TLValue::InputPeerNotifyEventsEmpty, 175, 0 },
+    { TLValue::InputPeerNotifyEventsAll, 175, 0 },
+    { TLValue::InputPeerNotifySettings, 175, 4 },
+    { TLValue::InputPhotoEmpty, 179, 0 },
+    { TLValue::InputPhoto, 179, 2 },
+    { TLValue::InputPhotoCropAuto, 181, 0 },
+    { TLValue::InputPhotoCrop, 181, 3 },
+    { TLValue::InputPrivacyKeyStatusTimestamp, 184, 0 },
+    { TLValue::InputStickerSetEmpty, 184, 0 },
+    { TLValue::InputStickerSetID, 184, 2 },
+    { TLValue::InputStickerSetShortName, 186, 1 },
+    { TLValue::InputUserEmpty, 187, 0 },
+    { TLValue::InputUserSelf, 187, 0 },
+    { TLValue::InputUserContact, 187, 1 },
+    { TLValue::InputUserForeign, 188, 2 },
+    { TLValue::InputVideoEmpty, 190, 0 },
+    { TLValue::InputVideo, 190, 2 },
+    { TLValue::MessagesAffectedHistory, 192, 3 },
+    { TLValue::MessagesAffectedMessages, 195, 2 },
+    { TLValue::MessagesDhConfigNotModified, 197, 1 },
+    { TLValue::MessagesDhConfig, 198, 4 },
+    { TLValue::InputMessagesFilterEmpty, 202, 0 },
+    { TLValue::InputMessagesFilterPhotos, 202, 0 },
+    { TLValue::InputMessagesFilterVideo, 202, 0 },
+    { TLValue::InputMessagesFilterPhotoVideo, 202, 0 },
+    { TLValue::InputMessagesFilterPhotoVideoDocuments, 202, 0 },
+    { TLValue::InputMessagesFilterDocument, 202, 0 },
+    { TLValue::InputMessagesFilterAudio, 202, 0 },
+    { TLValue::MessagesSentEncryptedMessage, 202, 1 },
+    { TLValue::MessagesSentEncryptedFile, 203, 2 },
+    { TLValue::NearestDc, 205, 3 },
+    { TLValue::PeerUser, 208, 1 },
+    { TLValue::PeerChat, 209, 1 },
+    { TLValue::PeerNotifyEventsEmpty, 210, 0 },
+    { TLValue::PeerNotifyEventsAll, 210, 0 },
+    { TLValue::PeerNotifySettingsEmpty, 210, 0 },
+    { TLValue::PeerNotifySettings, 210, 4 },
+    { TLValue::PhotoSizeEmpty, 214, 1 },
+    { TLValue::PhotoSize, 215, 5 },
+    { TLValue::PhotoCachedSize, 220, 5 },
+    { TLValue::PrivacyKeyStatusTimestamp, 225, 0 },
+    { TLValue::PrivacyValueAllowContacts, 225, 0 },
+    { TLValue::PrivacyValueAllowAll, 225, 0 },
+    { TLValue::PrivacyValueAllowUsers, 225, 1 },
+    { TLValue::PrivacyValueDisallowContacts, 226, 0 },
+    { TLValue::PrivacyValueDisallowAll, 226, 0 },
+    { TLValue::PrivacyValueDisallowUsers, 226, 1 },
+    { TLValue::ReceivedNotifyMessage, 227, 2 },
+    { TLValue::SendMessageTypingAction, 229, 0 },
+    { TLValue::SendMessageCancelAction, 229, 0 },
+    { TLValue::SendMessageRecordVideoAction, 229, 0 },
+    { TLValue::SendMessageUploadVideoAction, 229, 1 },
+    { TLValue::SendMessageRecordAudioAction, 230, 0 },
+    { TLValue::SendMessageUploadAudioAction, 230, 1 },
+    { TLValue::SendMessageUploadPhotoAction, 231, 1 },
+    { TLValue::SendMessageUploadDocumentAction, 232, 1 },
+    { TLValue::SendMessageGeoLocationAction, 233, 0 },
+    { TLValue::SendMessageChooseContactAction, 233, 0 },
+    { TLValue::StickerPack, 233, 2 },
+    { TLValue::StickerSet, 235, 4 },
+    { TLValue::StorageFileUnknown, 239, 0 },
+    { TLValue::StorageFileJpeg, 239, 0 },
+    { TLValue::StorageFileGif, 239, 0 },
+    { TLValue::StorageFilePng, 239, 0 },
+    { TLValue::StorageFilePdf, 239, 0 },
+    { TLValue::StorageFileMp3, 239, 0 },
+    { TLValue::StorageFileMov, 239, 0 },
+    { TLValue::StorageFilePartial, 239, 0 },
+    { TLValue::StorageFileMp4, 239, 0 },
+    { TLValue::StorageFileWebp, 239, 0 },
+    { TLValue::UpdatesState, 239, 5 },
+    { TLValue::UploadFile, 244, 3 },
+    { TLValue::UserProfilePhotoEmpty, 247, 0 },
+    { TLValue::UserProfilePhoto, 247, 3 },
+    { TLValue::UserStatusEmpty, 250, 0 },
+    { TLValue::UserStatusOnline, 250, 1 },
+    { TLValue::UserStatusOffline, 251, 1 },
+    { TLValue::UserStatusRecently, 252, 0 },
+    { TLValue::UserStatusLastWeek, 252, 0 },
+    { TLValue::UserStatusLastMonth, 252, 0 },
+    { TLValue::VideoEmpty, 252, 1 },
+    { TLValue::Video, 253, 10 },
+    { TLValue::WallPaper, 263, 4 },
+    { TLValue::WallPaperSolid, 267, 4 },
+    { TLValue::AccountAuthorizations, 271, 1 },
+    { TLValue::ChatPhotoEmpty, 272, 0 },
+    { TLValue::ChatPhoto, 272, 2 },
+    { TLValue::Config, 274, 18 },
+    { TLValue::ContactStatus, 292, 2 },
+    { TLValue::Dialog, 294, 5 },
+    { TLValue::DocumentAttributeImageSize, 299, 2 },
+    { TLValue::DocumentAttributeAnimated, 301, 0 },
+    { TLValue::DocumentAttributeSticker, 301, 2 },
+    { TLValue::DocumentAttributeVideo, 303, 3 },
+    { TLValue::DocumentAttributeAudio, 306, 1 },
+    { TLValue::DocumentAttributeFilename, 307, 1 },
+    { TLValue::InputChatPhotoEmpty, 308, 0 },
+    { TLValue::InputChatUploadedPhoto, 308, 2 },
+    { TLValue::InputChatPhoto, 310, 2 },
+    { TLValue::InputMediaEmpty, 312, 0 },
+    { TLValue::InputMediaUploadedPhoto, 312, 2 },
+    { TLValue::InputMediaPhoto, 314, 2 },
+    { TLValue::InputMediaGeoPoint, 316, 1 },
+    { TLValue::InputMediaContact, 317, 3 },
+    { TLValue::InputMediaUploadedVideo, 320, 5 },
+    { TLValue::InputMediaUploadedThumbVideo, 325, 6 },
+    { TLValue::InputMediaVideo, 331, 2 },
+    { TLValue::InputMediaUploadedAudio, 333, 3 },
+    { TLValue::InputMediaAudio, 336, 1 },
+    { TLValue::InputMediaUploadedDocument, 337, 3 },
+    { TLValue::InputMediaUploadedThumbDocument, 340, 4 },
+    { TLValue::InputMediaDocument, 344, 1 },
+    { TLValue::InputMediaVenue, 345, 5 },
+    { TLValue::InputNotifyPeer, 350, 1 },
+    { TLValue::InputNotifyUsers, 351, 0 },
+    { TLValue::InputNotifyChats, 351, 0 },
+    { TLValue::InputNotifyAll, 351, 0 },
+    { TLValue::InputNotifyGeoChatPeer, 351, 1 },
+    { TLValue::InputPrivacyValueAllowContacts, 352, 0 },
+    { TLValue::InputPrivacyValueAllowAll, 352, 0 },
+    { TLValue::InputPrivacyValueAllowUsers, 352, 1 },
+    { TLValue::InputPrivacyValueDisallowContacts, 353, 0 },
+    { TLValue::InputPrivacyValueDisallowAll, 353, 0 },
+    { TLValue::InputPrivacyValueDisallowUsers, 353, 1 },
+    { TLValue::NotifyPeer, 354, 1 },
+    { TLValue::NotifyUsers, 355, 0 },
+    { TLValue::NotifyChats, 355, 0 },
+    { TLValue::NotifyAll, 355, 0 },
+    { TLValue::PhotoEmpty, 355, 1 },
+    { TLValue::Photo, 356, 6 },
+    { TLValue::UserEmpty, 362, 1 },
+    { TLValue::UserSelf, 363, 7 },
+    { TLValue::UserContact, 370, 8 },
+    { TLValue::UserRequest, 378, 8 },
+    { TLValue::UserForeign, 386, 7 },
+    { TLValue::UserDeleted, 393, 4 },
+    { TLValue::WebPageEmpty, 397, 1 },
+    { TLValue::WebPagePending, 398, 2 },
+    { TLValue::WebPage, 400, 15 },
+    { TLValue::AccountPrivacyRules, 415, 2 },
+    { TLValue::AuthAuthorization, 417, 2 },
+    { TLValue::ChatEmpty, 419, 1 },
+    { TLValue::Chat, 420, 7 },
+    { TLValue::ChatForbidden, 427, 3 },
+    { TLValue::GeoChat, 430, 11 },
+    { TLValue::ChatFull, 441, 5 },
+    { TLValue::ChatInviteAlready, 446, 1 },
+    { TLValue::ChatInvite, 447, 1 },
+    { TLValue::ContactsBlocked, 448, 2 },
+    { TLValue::ContactsBlockedSlice, 450, 3 },
+    { TLValue::ContactsContactsNotModified, 453, 0 },
+    { TLValue::ContactsContacts, 453, 2 },
+    { TLValue::ContactsFound, 455, 2 },
+    { TLValue::ContactsImportedContacts, 457, 3 },
+    { TLValue::ContactsLink, 460, 3 },
+    { TLValue::ContactsSuggested, 463, 2 },
+    { TLValue::DocumentEmpty, 465, 1 },
+    { TLValue::Document, 466, 8 },
+    { TLValue::HelpSupport, 474, 2 },
+    { TLValue::MessageActionEmpty, 476, 0 },
+    { TLValue::MessageActionChatCreate, 476, 2 },
+    { TLValue::MessageActionChatEditTitle, 478, 1 },
+    { TLValue::MessageActionChatEditPhoto, 479, 1 },
+    { TLValue::MessageActionChatDeletePhoto, 480, 0 },
+    { TLValue::MessageActionChatAddUser, 480, 1 },
+    { TLValue::MessageActionChatDeleteUser, 481, 1 },
+    { TLValue::MessageActionGeoChatCreate, 482, 2 },
+    { TLValue::MessageActionGeoChatCheckin, 484, 0 },
+    { TLValue::MessageActionChatJoinedByLink, 484, 1 },
+    { TLValue::MessageMediaEmpty, 485, 0 },
+    { TLValue::MessageMediaPhoto, 485, 2 },
+    { TLValue::MessageMediaVideo, 487, 2 },
+    { TLValue::MessageMediaGeo, 489, 1 },
+    { TLValue::MessageMediaContact, 490, 4 },
+    { TLValue::MessageMediaUnsupported, 494, 0 },
+    { TLValue::MessageMediaDocument, 494, 1 },
+    { TLValue::MessageMediaAudio, 495, 1 },
+    { TLValue::MessageMediaWebPage, 496, 1 },
+    { TLValue::MessageMediaVenue, 497, 5 },
+    { TLValue::MessagesAllStickersNotModified, 502, 0 },
+    { TLValue::MessagesAllStickers, 502, 4 },
+    { TLValue::MessagesChatFull, 506, 3 },
+    { TLValue::MessagesChats, 509, 1 },
+    { TLValue::MessagesSentMessage, 510, 5 },
+    { TLValue::MessagesSentMessageLink, 515, 7 },
+    { TLValue::MessagesStickerSet, 522, 3 },
+    { TLValue::MessagesStickersNotModified, 525, 0 },
+    { TLValue::MessagesStickers, 525, 2 },
+    { TLValue::PhotosPhoto, 527, 2 },
+    { TLValue::PhotosPhotos, 529, 2 },
+    { TLValue::PhotosPhotosSlice, 531, 3 },
+    { TLValue::UserFull, 534, 7 },
+    { TLValue::GeoChatMessageEmpty, 541, 2 },
+    { TLValue::GeoChatMessage, 543, 6 },
+    { TLValue::GeoChatMessageService, 549, 5 },
+    { TLValue::GeochatsLocated, 554, 4 },
+    { TLValue::GeochatsMessages, 558, 3 },
+    { TLValue::GeochatsMessagesSlice, 561, 4 },
+    { TLValue::GeochatsStatedMessage, 565, 4 },
+    { TLValue::MessageEmpty, 569, 1 },
+    { TLValue::Message, 570, 10 },
+    { TLValue::MessageService, 580, 6 },
+    { TLValue::MessagesDialogs, 586, 4 },
+    { TLValue::MessagesDialogsSlice, 590, 5 },
+    { TLValue::MessagesMessages, 595, 3 },
+    { TLValue::MessagesMessagesSlice, 598, 4 },
+    { TLValue::UpdateNewMessage, 602, 3 },
+    { TLValue::UpdateMessageID, 605, 2 },
+    { TLValue::UpdateDeleteMessages, 607, 3 },
+    { TLValue::UpdateUserTyping, 610, 2 },
+    { TLValue::UpdateChatUserTyping, 612, 3 },
+    { TLValue::UpdateChatParticipants, 615, 1 },
+    { TLValue::UpdateUserStatus, 616, 2 },
+    { TLValue::UpdateUserName, 618, 4 },
+    { TLValue::UpdateUserPhoto, 622, 4 },
+    { TLValue::UpdateContactRegistered, 626, 2 },
+    { TLValue::UpdateContactLink, 628, 3 },
+    { TLValue::UpdateNewAuthorization, 631, 4 },
+    { TLValue::UpdateNewGeoChatMessage, 635, 1 },
+    { TLValue::UpdateNewEncryptedMessage, 636, 2 },
+    { TLValue::UpdateEncryptedChatTyping, 638, 1 },
+    { TLValue::UpdateEncryption, 639, 2 },
+    { TLValue::UpdateEncryptedMessagesRead, 641, 3 },
+    { TLValue::UpdateChatParticipantAdd, 644, 4 },
+    { TLValue::UpdateChatParticipantDelete, 648, 3 },
+    { TLValue::UpdateDcOptions, 651, 1 },
+    { TLValue::UpdateUserBlocked, 652, 2 },
+    { TLValue::UpdateNotifySettings, 654, 2 },
+    { TLValue::UpdateServiceNotification, 656, 4 },
+    { TLValue::UpdatePrivacy, 660, 2 },
+    { TLValue::UpdateUserPhone, 662, 2 },
+    { TLValue::UpdateReadHistoryInbox, 664, 4 },
+    { TLValue::UpdateReadHistoryOutbox, 668, 4 },
+    { TLValue::UpdateWebPage, 672, 1 },
+    { TLValue::UpdateReadMessagesContents, 673, 3 },
+    { TLValue::UpdatesTooLong, 676, 0 },
+    { TLValue::UpdateShortMessage, 676, 10 },
+    { TLValue::UpdateShortChatMessage, 686, 11 },
+    { TLValue::UpdateShort, 697, 2 },
+    { TLValue::UpdatesCombined, 699, 6 },
+    { TLValue::Updates, 705, 5 },
+    { TLValue::UpdatesDifferenceEmpty, 710, 2 },
+    { TLValue::UpdatesDifference, 712, 6 },
+    { TLValue::UpdatesDifferenceSlice, 718, 6 },
+};
+
+static const TLSchemaType s_schemaTypes[] = {
+    { 0, 1, 1 }, // TLAccountDaysTTL
+    { 1, 2, 5 }, // TLAccountPassword
+    { 3, 1, 5 }, // TLAccountPasswordInputSettings
+    { 4, 1, 1 }, // TLAccountPasswordSettings
+    { 5, 1, 2 }, // TLAccountSentChangePhoneCode
+    { 6, 2, 8 }, // TLAudio
+    { 8, 1, 1 }, // TLAuthCheckedPhone
+    { 9, 1, 2 }, // TLAuthExportedAuthorization
+    { 10, 1, 1 }, // TLAuthPasswordRecovery
+    { 11, 2, 4 }, // TLAuthSentCode
+    { 13, 1, 13 }, // TLAuthorization
+    { 14, 1, 2 }, // TLChatLocated
+    { 15, 1, 3 }, // TLChatParticipant
+    { 16, 2, 4 }, // TLChatParticipants
+    { 18, 1, 2 }, // TLContact
+    { 19, 1, 2 }, // TLContactBlocked
+    { 20, 1, 1 }, // TLContactFound
+    { 21, 4, 0 }, // TLContactLink
+    { 25, 1, 2 }, // TLContactSuggested
+    { 26, 1, 4 }, // TLDcOption
+    { 27, 1, 2 }, // TLDisabledFeature
+    { 28, 5, 8 }, // TLEncryptedChat
+    { 33, 2, 5 }, // TLEncryptedFile
+    { 35, 2, 5 }, // TLEncryptedMessage
+    { 37, 1, 2 }, // TLError
+    { 38, 2, 1 }, // TLExportedChatInvite
+    { 40, 2, 4 }, // TLFileLocation
+    { 42, 2, 2 }, // TLGeoPoint
+    { 44, 2, 4 }, // TLHelpAppUpdate
+    { 46, 1, 1 }, // TLHelpInviteText
+    { 47, 1, 2 }, // TLImportedContact
+    { 48, 1, 4 }, // TLInputAppEvent
+    { 49, 2, 2 }, // TLInputAudio
+    { 51, 1, 4 }, // TLInputContact
+    { 52, 2, 2 }, // TLInputDocument
+    { 54, 1, 2 }, // TLInputEncryptedChat
+    { 55, 4, 5 }, // TLInputEncryptedFile
+    { 59, 2, 4 }, // TLInputFile
+    { 61, 5, 5 }, // TLInputFileLocation
+    { 66, 1, 2 }, // TLInputGeoChat
+    { 67, 2, 2 }, // TLInputGeoPoint
+    { 69, 5, 3 }, // TLInputPeer
+    { 74, 2, 0 }, // TLInputPeerNotifyEvents
+    { 76, 1, 4 }, // TLInputPeerNotifySettings
+    { 77, 2, 2 }, // TLInputPhoto
+    { 79, 2, 3 }, // TLInputPhotoCrop
+    { 81, 1, 0 }, // TLInputPrivacyKey
+    { 82, 3, 3 }, // TLInputStickerSet
+    { 85, 4, 2 }, // TLInputUser
+    { 89, 2, 2 }, // TLInputVideo
+    { 91, 1, 3 }, // TLMessagesAffectedHistory
+    { 92, 1, 2 }, // TLMessagesAffectedMessages
+    { 93, 2, 4 }, // TLMessagesDhConfig
+    { 95, 7, 0 }, // TLMessagesFilter
+    { 102, 2, 2 }, // TLMessagesSentEncryptedMessage
+    { 104, 1, 3 }, // TLNearestDc
+    { 105, 2, 2 }, // TLPeer
+    { 107, 2, 0 }, // TLPeerNotifyEvents
+    { 109, 2, 4 }, // TLPeerNotifySettings
+    { 111, 3, 6 }, // TLPhotoSize
+    { 114, 1, 0 }, // TLPrivacyKey
+    { 115, 6, 1 }, // TLPrivacyRule
+    { 121, 1, 2 }, // TLReceivedNotifyMessage
+    { 122, 10, 1 }, // TLSendMessageAction
+    { 132, 1, 2 }, // TLStickerPack
+    { 133, 1, 4 }, // TLStickerSet
+    { 134, 10, 0 }, // TLStorageFileType
+    { 144, 1, 5 }, // TLUpdatesState
+    { 145, 1, 3 }, // TLUploadFile
+    { 146, 2, 3 }, // TLUserProfilePhoto
+    { 148, 6, 2 }, // TLUserStatus
+    { 154, 2, 10 }, // TLVideo
+    { 156, 2, 5 }, // TLWallPaper
+    { 158, 1, 1 }, // TLAccountAuthorizations
+    { 159, 2, 2 }, // TLChatPhoto
+    { 161, 1, 18 }, // TLConfig
+    { 162, 1, 2 }, // TLContactStatus
+    { 163, 1, 5 }, // TLDialog
+    { 164, 6, 6 }, // TLDocumentAttribute
+    { 170, 3, 3 }, // TLInputChatPhoto
+    { 173, 14, 20 }, // TLInputMedia
+    { 187, 5, 2 }, // TLInputNotifyPeer
+    { 192, 6, 1 }, // TLInputPrivacyRule
+    { 198, 4, 1 }, // TLNotifyPeer
+    { 202, 2, 6 }, // TLPhoto
+    { 204, 6, 8 }, // TLUser
+    { 210, 3, 16 }, // TLWebPage
+    { 213, 1, 2 }, // TLAccountPrivacyRules
+    { 214, 1, 2 }, // TLAuthAuthorization
+    { 215, 4, 12 }, // TLChat
+    { 219, 1, 5 }, // TLChatFull
+    { 220, 2, 2 }, // TLChatInvite
+    { 222, 2, 3 }, // TLContactsBlocked
+    { 224, 2, 2 }, // TLContactsContacts
+    { 226, 1, 2 }, // TLContactsFound
+    { 227, 1, 3 }, // TLContactsImportedContacts
+    { 228, 1, 3 }, // TLContactsLink
+    { 229, 1, 2 }, // TLContactsSuggested
+    { 230, 2, 8 }, // TLDocument
+    { 232, 1, 2 }, // TLHelpSupport
+    { 233, 10, 6 }, // TLMessageAction
+    { 243, 10, 15 }, // TLMessageMedia
+    { 253, 2, 4 }, // TLMessagesAllStickers
+    { 255, 1, 3 }, // TLMessagesChatFull
+    { 256, 1, 1 }, // TLMessagesChats
+    { 257, 2, 7 }, // TLMessagesSentMessage
+    { 259, 1, 3 }, // TLMessagesStickerSet
+    { 260, 2, 2 }, // TLMessagesStickers
+    { 262, 1, 2 }, // TLPhotosPhoto
+    { 263, 2, 3 }, // TLPhotosPhotos
+    { 265, 1, 7 }, // TLUserFull
+    { 266, 3, 7 }, // TLGeoChatMessage
+    { 269, 1, 4 }, // TLGeochatsLocated
+    { 270, 2, 4 }, // TLGeochatsMessages
+    { 272, 1, 4 }, // TLGeochatsStatedMessage
+    { 273, 3, 11 }, // TLMessage
+    { 276, 2, 5 }, // TLMessagesDialogs
+    { 278, 2, 4 }, // TLMessagesMessages
+    { 280, 29, 43 }, // TLUpdate
+    { 309, 6, 18 }, // TLUpdates
+    { 315, 3, 9 }, // TLUpdatesDifference
+};
+// End of generated TL schema
+
+static bool readUInt32(const char *data, int size, int *position, quint32 *value)
+{
+    if (size - *position < 4) {
+        return false;
+    }
+
+    *value = qFromLittleEndian<quint32>((const uchar *) data + *position);
+    *position += 4;
+
+    return true;
+}
+
+static bool skipObject(const char *data, int size, int *position, int typeIndex, int *memberOffsets, TLValue *tlType);
+
+static bool skipValue(const char *data, int size, int *position, quint8 kind, int typeIndex)
+{
+    int length = 0;
+
+    switch (kind) {
+    case FieldBool:
+    case FieldInt:
+        length = 4;
+        break;
+    case FieldLong:
+    case FieldDouble:
+        length = 8;
+        break;
+    case FieldBytes:
+        if (*position >= size) {
+            return false;
+        }
+
+        length = uchar(data[*position]);
+
+        if (length < 0xfe) {
+            length += 1;
+        } else {
+            if (size - *position < 4) {
+                return false;
+            }
+
+            length = qFromLittleEndian<quint32>((const uchar *) data + *position) >> 8;
+            length += 4;
+        }
+
+        length = (length + 3) & ~3; // Padding
+        break;
+    case FieldObject:
+        return skipObject(data, size, position, typeIndex, 0, 0);
+    default:
+        return false;
+    }
+
+    if (size - *position < length) {
+        return false;
+    }
+
+    *position += length;
+
+    return true;
+}
+
+static bool skipField(const char *data, int size, int *position, const TLSchemaField &field)
+{
+    if (field.kind != FieldVector) {
+        return skipValue(data, size, position, field.kind, field.typeIndex);
+    }
+
+    quint32 vectorType;
+    quint32 count;
+
+    if (!readUInt32(data, size, position, &vectorType) || (vectorType != TLValue::Vector)) {
+        return false;
+    }
+
+    if (!readUInt32(data, size, position, &count)) {
+        return false;
+    }
+
+    for (quint32 i = 0; i < count; ++i) {
+        if (!skipValue(data, size, position, field.elementKind, field.typeIndex)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static bool skipObject(const char *data, int size, int *position, int typeIndex, int *memberOffsets, TLValue *tlType)
+{
+    quint32 id;
+
+    if (!readUInt32(data, size, position, &id)) {
+        return false;
+    }
+
+    const TLSchemaType &type = s_schemaTypes[typeIndex];
+    const TLSchemaConstructor *constructor = 0;
+
+    for (int i = type.firstConstructor; i < type.firstConstructor + type.constructorsCount; ++i) {
+        if (s_schemaConstructors[i].id == id) {
+            constructor = &s_schemaConstructors[i];
+            break;
+        }
+    }
+
+    if (!constructor) {
+        return false;
+    }
+
+    if (tlType) {
+        *tlType = TLValue(id);
+    }
+
+    // Values of the integer fields (needed for the flags)
+    QVarLengthArray<quint32, 16> values(constructor->fieldsCount);
+
+    for (int i = 0; i < constructor->fieldsCount; ++i) {
+        const TLSchemaField &field = s_schemaFields[constructor->firstField + i];
+
+        if ((field.flagBit >= 0) && !(values.at(field.flagFieldIndex) & (1 << field.flagBit))) {
+            continue;
+        }
+
+        if (memberOffsets) {
+            memberOffsets[field.memberIndex] = *position;
+        }
+
+        if (field.kind == FieldInt) {
+            if (!readUInt32(data, size, position, &values[i])) {
+                return false;
+            }
+        } else if (!skipField(data, size, position, field)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+TLView::TLView(int typeIndex) :
+    m_offset(0),
+    m_size(0),
+    m_typeIndex(typeIndex),
+    m_valid(false)
+{
+}
+
+bool TLView::readFrom(CTelegramStream &stream)
+{
+    int offset = 0;
+    QByteArray data = stream.sharedData(&offset);
+    const bool shared = !data.isNull();
+
+    if (!shared) {
+        data = stream.peekRemainingBytes();
+    }
+
+    if (!setData(data, offset)) {
+        stream.skipBytes(stream.bytesRemaining() + 1); // The object is broken or incomplete: read past the end to set the stream error.
+        return false;
+    }
+
+    if (!shared) {
+        // The stream reads a view (such as the reused package buffer), which may be not valid after the read,
+        // so the view keeps its own copy of the object data.
+        m_data = QByteArray(data.constData(), m_size);
+    }
+
+    stream.skipBytes(m_size);
+
+    return true;
+}
+
+bool TLView::setData(const QByteArray &data, int offset)
+{
+    m_data = data;
+    m_offset = offset;
+    m_memberOffsets.resize(s_schemaTypes[m_typeIndex].membersCount);
+
+    for (int i = 0; i < m_memberOffsets.count(); ++i) {
+        m_memberOffsets[i] = -1;
+    }
+
+    int position = offset;
+    m_valid = skipObject(m_data.constData(), m_data.size(), &position, m_typeIndex, m_memberOffsets.data(), &m_tlType);
+    m_size = m_valid ? position - offset : 0;
+
+    return m_valid;
+}
+
+int TLView::beginVector(int offset, int *position) const
+{
+    quint32 vectorType = 0;
+    quint32 count = 0;
+
+    *position = offset;
+
+    if (!readUInt32(m_data.constData(), m_data.size(), position, &vectorType) || (vectorType != TLValue::Vector)) {
+        return 0;
+    }
+
+    if (!readUInt32(m_data.constData(), m_data.size(), position, &count)) {
+        return 0;
+    }
+
+    // The vector is already validated, so the count is sane.
+    return count;
+}
+
+// Generated TL views implementation
+TLMessageView::TLMessageView() :
+    TLView(TypeMessage)
+{
+}
+
+TLMessage TLMessageView::toStruct() const
+{
+    return object<TLMessage>();
+}
+
+quint32 TLMessageView::id() const
+{
+    return member<quint32>(MemberId);
+}
+
+quint32 TLMessageView::flags() const
+{
+    return member<quint32>(MemberFlags);
+}
+
+quint32 TLMessageView::fromId() const
+{
+    return member<quint32>(MemberFromId);
+}
+
+TLPeer TLMessageView::toId() const
+{
+    return member<TLPeer>(MemberToId);
+}
+
+quint32 TLMessageView::fwdFromId() const
+{
+    return member<quint32>(MemberFwdFromId);
+}
+
+quint32 TLMessageView::fwdDate() const
+{
+    return member<quint32>(MemberFwdDate);
+}
+
+quint32 TLMessageView::replyToMsgId() const
+{
+    return member<quint32>(MemberReplyToMsgId);
+}
+
+quint32 TLMessageView::date() const
+{
+    return member<quint32>(MemberDate);
+}
+
+QString TLMessageView::message() const
+{
+    return member<QString>(MemberMessage);
+}
+
+TLMessageMedia TLMessageView::media() const
+{
+    return member<TLMessageMedia>(MemberMedia);
+}
+
+TLMessageAction TLMessageView::action() const
+{
+    return member<TLMessageAction>(MemberAction);
+}
+
+TLUpdatesDifferenceView::TLUpdatesDifferenceView() :
+    TLView(TypeUpdatesDifference)
+{
+}
+
+TLUpdatesDifference TLUpdatesDifferenceView::toStruct() const
+{
+    return object<TLUpdatesDifference>();
+}
+
+quint32 TLUpdatesDifferenceView::date() const
+{
+    return member<quint32>(MemberDate);
+}
+
+quint32 TLUpdatesDifferenceView::seq() const
+{
+    return member<quint32>(MemberSeq);
+}
+
+TLVector<TLMessageView> TLUpdatesDifferenceView::newMessages() const
+{
+    return memberViews<TLMessageView>(MemberNewMessages);
+}
+
+TLVector<TLEncryptedMessage> TLUpdatesDifferenceView::newEncryptedMessages() const
+{
+    return member<TLVector<TLEncryptedMessage> >(MemberNewEncryptedMessages);
+}
+
+TLVector<TLUpdate> TLUpdatesDifferenceView::otherUpdates() const
+{
+    return member<TLVector<TLUpdate> >(MemberOtherUpdates);
+}
+
+TLVector<TLChat> TLUpdatesDifferenceView::chats() const
+{
+    return member<TLVector<TLChat> >(MemberChats);
+}
+
+TLVector<TLUser> TLUpdatesDifferenceView::users() const
+{
+    return member<TLVector<TLUser> >(MemberUsers);
+}
+
+TLUpdatesState TLUpdatesDifferenceView::state() const
+{
+    return member<TLUpdatesState>(MemberState);
+}
+
+TLUpdatesState TLUpdatesDifferenceView::intermediateState() const
+{
+    return member<TLUpdatesState>(MemberIntermediateState);
+}
+
+// End of generated TL views implementation
@@ -0,0 +1,219 @@
+/*
+   Copyright (C) 2014-2015 Alexandr Akulich <akulichalexander@gmail.com>
+
+   This file is a part of TelegramQt library.
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+ */
+
+#ifndef TLVIEWS_HPP
+#define TLVIEWS_HPP
+
+#include <QByteArray>
+#include <QVarLengthArray>
+
+#include "CTelegramStream.hpp"
+#include "TLTypes.hpp"
+
+// Read-only view of a serialized TL object. The offsets of the members are found with one validation pass,
+// and the members are decoded only on access.
+class TLView
+{
+public:
+    bool isValid() const { return m_valid; }
+    TLValue tlType() const { return m_tlType; }
+    int size() const { return m_size; }
+
+    bool readFrom(CTelegramStream &stream);
+
+protected:
+    explicit TLView(int typeIndex);
+
+    bool setData(const QByteArray &data, int offset);
+
+    bool hasMember(int index) const;
+
+    template <typename T>
+    T member(int index) const;
+
+    template <typename View>
+    View memberView(int index) const;
+
+    template <typename View>
+    TLVector<View> memberViews(int index) const;
+
+    template <typename T>
+    T object() const;
+
+private:
+    int beginVector(int offset, int *position) const;
+
+    QByteArray m_data;
+    QVarLengthArray<int, 16> m_memberOffsets; // Offsets in m_data, -1 for the absent members
+    int m_offset;
+    int m_size;
+    int m_typeIndex;
+    TLValue m_tlType;
+    bool m_valid;
+
+};
+
+inline CTelegramStream &operator>>(CTelegramStream &stream, TLView &view)
+{
+    view.readFrom(stream);
+    return stream;
+}
+
+inline bool TLView::hasMember(int index) const
+{
+    return m_valid && (m_memberOffsets.at(index) >= 0);
+}
+
+template <typename T>
+T TLView::member(int index) const
+{
+    T result = T();
+
+    if (hasMember(index)) {
+        const int offset = m_memberOffsets.at(index);
+        CTelegramStream stream(m_data.constData() + offset, m_offset + m_size - offset);
+        stream >> result;
+    }
+
+    return result;
+}
+
+template <typename View>
+View TLView::memberView(int index) const
+{
+    View result;
+
+    if (hasMember(index)) {
+        result.setData(m_data, m_memberOffsets.at(index));
+    }
+
+    return result;
+}
+
+template <typename View>
+TLVector<View> TLView::memberViews(int index) const
+{
+    TLVector<View> result;
+
+    if (!hasMember(index)) {
+        return result;
+    }
+
+    int position = 0;
+    const int count = beginVector(m_memberOffsets.at(index), &position);
+
+    result.reserve(count);
+
+    for (int i = 0; i < count; ++i) {
+        View view;
+
+        if (!view.setData(m_data, position)) {
+            break;
+        }
+
+        position += view.size();
+        result.append(view);
+    }
+
+    return result;
+}
+
+template <typename T>
+T TLView::object() const
+{
+    T result;
+
+    if (m_valid) {
+        CTelegramStream stream(m_data.constData() + m_offset, m_size);
+        stream >> result;
+    }
+
+    return result;
+}
+
+// Generated TL views
+class TLMessageView : public TLView
+{
+public:
+    TLMessageView();
+
+    TLMessage toStruct() const;
+
+    quint32 id() const;
+    quint32 flags() const;
+    quint32 fromId() const;
+    TLPeer toId() const;
+    quint32 fwdFromId() const;
+    quint32 fwdDate() const;
+    quint32 replyToMsgId() const;
+    quint32 date() const;
+    QString message() const;
+    TLMessageMedia media() const;
+    TLMessageAction action() const;
+
+private:
+    enum Member {
+        MemberId,
+        MemberFlags,
+        MemberFromId,
+        MemberToId,
+        MemberFwdFromId,
+        MemberFwdDate,
+        MemberReplyToMsgId,
+        MemberDate,
+        MemberMessage,
+        MemberMedia,
+        MemberAction,
+    };
+
+};
+
+class TLUpdatesDifferenceView : public TLView
+{
+public:
+    TLUpdatesDifferenceView();
+
+    TLUpdatesDifference toStruct() const;
+
+    quint32 date() const;
+    quint32 seq() const;
+    TLVector<TLMessageView> newMessages() const;
+    TLVector<TLEncryptedMessage> newEncryptedMessages() const;
+    TLVector<TLUpdate> otherUpdates() const;
+    TLVector<TLChat> chats() const;
+    TLVector<TLUser> users() const;
+    TLUpdatesState state() const;
+    TLUpdatesState intermediateState() const;
+
+private:
+    enum Member {
+        MemberDate,
+        MemberSeq,
+        MemberNewMessages,
+        MemberNewEncryptedMessages,
+        MemberOtherUpdates,
+        MemberChats,
+        MemberUsers,
+        MemberState,
+        MemberIntermediateState,
+    };
+
+};
+
+// End of generated TL views
+
+#endif // TLVIEWS_HPP
@@ -61,18 +61,18 @@ QString TelegramNamespace::MessageMediaInfo::caption() const
 
 double TelegramNamespace::MessageMediaInfo::latitude() const
 {
-    return d->geo.latitude;
+    return d->geo->latitude;
 }
 
 double TelegramNamespace::MessageMediaInfo::longitude() const
 {
-    return d->geo.longitude;
+    return d->geo->longitude;
 }
 
 void TelegramNamespace::MessageMediaInfo::setGeoPoint(double latitude, double longitude)
 {
     d->tlType = TLValue::MessageMediaGeo;
-    d->geo.tlType = TLValue::GeoPoint;
-    d->geo.longitude = longitude;
-    d->geo.latitude = latitude;
+    d->geo->tlType = TLValue::GeoPoint;
+    d->geo->longitude = longitude;
+    d->geo->latitude = latitude;
 }
@@ -41,7 +41,8 @@ public:
         MessageDeliveryStatusUnknown,
         MessageDeliveryStatusSent,
         MessageDeliveryStatusRead,
-        MessageDeliveryStatusDeleted
+        MessageDeliveryStatusDeleted,
+        MessageDeliveryStatusFailed // The message is not sent (e.g. it is dropped by the flood limit)
     };
 
     enum MessageFlag {
@@ -17,17 +17,24 @@
 
 #include "Utils.hpp"
 
+#include "CRandomGenerator.hpp"
+
 #include <openssl/aes.h>
 #include <openssl/bn.h>
 #include <openssl/pem.h>
-#include <openssl/rand.h>
 #include <openssl/rsa.h>
 
 #include <zlib.h>
 
+#ifdef HAVE_LIBDEFLATE
+#include <libdeflate.h>
+#endif
+
 #include <QBuffer>
 #include <QCryptographicHash>
 #include <QDebug>
+#include <QThreadStorage>
+#include <QtEndian>
 
 static const QByteArray s_hardcodedRsaDataKey("0c150023e2f70db7985ded064759cfecf0af328e69a41daf4d6f01b53813"
                                               "5a6f91f8f8b2a0ec9ba9720ce352efcf6c5680ffc424bd634864902de0b4"
@@ -43,7 +50,20 @@ static const quint64 s_hardcodedRsaDataFingersprint(0xc3b42b026ce86b21);
 
 int Utils::randomBytes(char *buffer, int count)
 {
-    return RAND_bytes((unsigned char *) buffer, count);
+    return CRandomGenerator::instance()->generate(buffer, count);
+}
+
+int Utils::appendRandomPadding(QByteArray *array, int alignment)
+{
+    const int size = array->size();
+    const int paddingSize = (alignment - size % alignment) % alignment;
+
+    if (paddingSize) {
+        array->resize(size + paddingSize);
+        randomBytes(array->data() + size, paddingSize);
+    }
+
+    return paddingSize;
 }
 
 // Slightly modified version of Euclidean algorithm. Once we are looking for prime numbers, we can drop parity of asked numbers.
@@ -219,15 +239,23 @@ QByteArray Utils::binaryNumberModExp(const QByteArray &data, const QByteArray &m
 
 QByteArray Utils::aesDecrypt(const QByteArray &data, const SAesKey &key)
 {
-    QByteArray result = data;
+    QByteArray result;
+    aesDecrypt(data, key, &result);
+    return result;
+}
+
+// The output buffer is reused, if it is big enough and not shared.
+void Utils::aesDecrypt(const QByteArray &data, const SAesKey &key, QByteArray *output)
+{
+    // The output is completely overwritten, so there is no need to copy the data there (the data can be a raw data view).
+    output->resize(data.size());
 
     QByteArray initVector = key.iv;
 
     AES_KEY dec_key;
     AES_set_decrypt_key((const uchar *) key.key.constData(), key.key.length() * 8, &dec_key);
 
-    AES_ige_encrypt((const uchar *) data.constData(), (uchar *) result.data(), data.length(), &dec_key, (uchar *) initVector.data(), AES_DECRYPT);
-    return result;
+    AES_ige_encrypt((const uchar *) data.constData(), (uchar *) output->data(), data.length(), &dec_key, (uchar *) initVector.data(), AES_DECRYPT);
 }
 
 QByteArray Utils::aesEncrypt(const QByteArray &data, const SAesKey &key)
@@ -243,55 +271,232 @@ QByteArray Utils::aesEncrypt(const QByteArray &data, const SAesKey &key)
     return result;
 }
 
-QByteArray Utils::unpackGZip(const QByteArray &data)
+// In-place version (AES IGE allows the same input and output buffer)
+void Utils::aesEncrypt(char *data, int size, const SAesKey &key)
 {
-    if (data.size() <= 4) {
-        qDebug() << Q_FUNC_INFO << "Input data is too small to be gzip package";
-        return QByteArray();
+    QByteArray initVector = key.iv;
+
+    AES_KEY enc_key;
+    AES_set_encrypt_key((const uchar *) key.key.constData(), key.key.length() * 8, &enc_key);
+
+    AES_ige_encrypt((const uchar *) data, (uchar *) data, size, &enc_key, (uchar *) initVector.data(), AES_ENCRYPT);
+}
+
+// The requests are small and sent often, so the speed is preferred over the ratio.
+static const int s_gzipCompressionLevel = Z_BEST_SPEED;
+
+// Deflate state is quite expensive to set up (about 256 KB of the buffers), so it is kept per thread and reset for each package.
+class CGZipDeflater
+{
+public:
+    CGZipDeflater()
+    {
+        m_stream.zalloc = Z_NULL;
+        m_stream.zfree = Z_NULL;
+        m_stream.opaque = Z_NULL;
+
+        m_valid = deflateInit2(&m_stream, s_gzipCompressionLevel, Z_DEFLATED, 15 + 16 /* gzip encoding */, 8, Z_DEFAULT_STRATEGY) == Z_OK;
     }
 
-    QByteArray result;
+    ~CGZipDeflater()
+    {
+        if (m_valid) {
+            deflateEnd(&m_stream);
+        }
+    }
 
-    int inflateResult;
-    z_stream stream;
-    static const int CHUNK_SIZE = 1024;
-    char out[CHUNK_SIZE];
+    QByteArray pack(const QByteArray &data)
+    {
+        if (!m_valid || (deflateReset(&m_stream) != Z_OK)) {
+            return QByteArray();
+        }
 
-    /* allocate inflate state */
-    stream.zalloc = Z_NULL;
-    stream.zfree = Z_NULL;
-    stream.opaque = Z_NULL;
-    stream.avail_in = data.size();
-    stream.next_in = (Bytef*)(data.data());
+        QByteArray result;
+        result.resize(deflateBound(&m_stream, data.size()));
 
-    inflateResult = inflateInit2(&stream, 15 + 32); // gzip decoding
+        m_stream.avail_in = data.size();
+        m_stream.next_in = (Bytef*)(data.constData());
+        m_stream.avail_out = result.size();
+        m_stream.next_out = (Bytef*)(result.data());
 
-    if (inflateResult != Z_OK) {
-        return QByteArray();
+        if (deflate(&m_stream, Z_FINISH) != Z_STREAM_END) {
+            return QByteArray();
+        }
+
+        result.resize(result.size() - m_stream.avail_out);
+
+        return result;
+    }
+
+private:
+    z_stream m_stream;
+    bool m_valid;
+
+};
+
+static QThreadStorage<CGZipDeflater *> s_deflaters;
+
+QByteArray Utils::packGZip(const QByteArray &data)
+{
+    if (!s_deflaters.hasLocalData()) {
+        s_deflaters.setLocalData(new CGZipDeflater());
+    }
+
+    return s_deflaters.localData()->pack(data);
+}
+
+static const int s_gzipMaximumExpectedSize = 64 * 1024 * 1024;
+static const int s_gzipMaximumUnpackedSize = s_gzipMaximumExpectedSize * 4; // Bigger data is considered as a broken (or a malicious) package.
+
+// Inflate state is kept per thread as well. The output is allocated at once: the gzip trailer (ISIZE) holds
+// the size of the unpacked data, so the big answers (such as updates difference) do not grow the buffer chunk by chunk.
+class CGZipInflater
+{
+public:
+    CGZipInflater()
+    {
+#ifdef HAVE_LIBDEFLATE
+        m_decompressor = libdeflate_alloc_decompressor();
+#else
+        m_stream.zalloc = Z_NULL;
+        m_stream.zfree = Z_NULL;
+        m_stream.opaque = Z_NULL;
+        m_stream.avail_in = 0;
+        m_stream.next_in = Z_NULL;
+
+        m_valid = inflateInit2(&m_stream, 15 + 32 /* gzip decoding */) == Z_OK;
+#endif
     }
 
-    do {
-        stream.avail_out = CHUNK_SIZE;
-        stream.next_out = (Bytef*)(out);
+    ~CGZipInflater()
+    {
+#ifdef HAVE_LIBDEFLATE
+        if (m_decompressor) {
+            libdeflate_free_decompressor(m_decompressor);
+        }
+#else
+        if (m_valid) {
+            inflateEnd(&m_stream);
+        }
+#endif
+    }
 
-        inflateResult = inflate(&stream, Z_NO_FLUSH);
+    QByteArray unpack(const QByteArray &data)
+    {
+        QByteArray result;
+        result.resize(expectedSize(data));
 
-        switch (inflateResult) {
-        case Z_NEED_DICT:
-            inflateResult = Z_DATA_ERROR;     // and fall through
-        case Z_DATA_ERROR:
-        case Z_MEM_ERROR:
-        case Z_STREAM_ERROR:
-            inflateEnd(&stream);
+#ifdef HAVE_LIBDEFLATE
+        if (!m_decompressor) {
             return QByteArray();
-        default:
-            break;
         }
 
-        result.append(out, CHUNK_SIZE - stream.avail_out);
-    } while (stream.avail_out == 0);
+        while (true) {
+            size_t unpackedSize = 0;
+            const libdeflate_result decompressResult = libdeflate_gzip_decompress(m_decompressor, data.constData(), data.size(),
+                                                                                  result.data(), result.size(), &unpackedSize);
 
-    inflateEnd(&stream);
+            if (decompressResult == LIBDEFLATE_SUCCESS) {
+                result.resize(unpackedSize);
+                return result;
+            }
 
-    return result;
+            if ((decompressResult != LIBDEFLATE_INSUFFICIENT_SPACE) || !grow(&result)) {
+                return QByteArray();
+            }
+        }
+#else
+        if (!m_valid || (inflateReset(&m_stream) != Z_OK)) {
+            return QByteArray();
+        }
+
+        m_stream.avail_in = data.size();
+        m_stream.next_in = (Bytef*)(data.constData());
+
+        int unpackedSize = 0;
+
+        while (true) {
+            m_stream.avail_out = result.size() - unpackedSize;
+            m_stream.next_out = (Bytef*)(result.data() + unpackedSize);
+
+            // Z_FINISH lets zlib to inflate right into the output, without the sliding window copy.
+            const int inflateResult = inflate(&m_stream, Z_FINISH);
+
+            unpackedSize = result.size() - m_stream.avail_out;
+
+            if (inflateResult == Z_STREAM_END) {
+                break;
+            }
+
+            if (((inflateResult != Z_OK) && (inflateResult != Z_BUF_ERROR)) || m_stream.avail_out) {
+                // Broken or truncated data
+                return QByteArray();
+            }
+
+            // The trailer lies (the data is bigger than 4 GB or there are several gzip members)
+            if (!grow(&result)) {
+                return QByteArray();
+            }
+        }
+
+        result.resize(unpackedSize);
+
+        return result;
+#endif
+    }
+
+private:
+    static int expectedSize(const QByteArray &data)
+    {
+        static const int maximumRatio = 1032; // The greatest possible deflate compression ratio
+
+        int size = 0;
+
+        if ((uchar(data.at(0)) == 0x1f) && (uchar(data.at(1)) == 0x8b)) { // gzip magic
+            size = qFromLittleEndian<quint32>((const uchar *) data.constData() + data.size() - 4);
+        }
+
+        if ((size <= 0) || (size > s_gzipMaximumExpectedSize) || (size / maximumRatio > data.size())) {
+            // No (or a doubtful) hint
+            size = qMin(data.size(), s_gzipMaximumUnpackedSize / 4) * 4;
+        }
+
+        return size;
+    }
+
+    static bool grow(QByteArray *buffer)
+    {
+        if (buffer->size() >= s_gzipMaximumUnpackedSize) {
+            qDebug() << Q_FUNC_INFO << "Unpacked data exceeds" << s_gzipMaximumUnpackedSize << "bytes";
+            return false;
+        }
+
+        buffer->resize(qMin(buffer->size(), s_gzipMaximumUnpackedSize / 2) * 2);
+
+        return true;
+    }
+
+#ifdef HAVE_LIBDEFLATE
+    libdeflate_decompressor *m_decompressor;
+#else
+    z_stream m_stream;
+    bool m_valid;
+#endif
+
+};
+
+static QThreadStorage<CGZipInflater *> s_inflaters;
+
+QByteArray Utils::unpackGZip(const QByteArray &data)
+{
+    if (data.size() <= 4) {
+        qDebug() << Q_FUNC_INFO << "Input data is too small to be gzip package";
+        return QByteArray();
+    }
+
+    if (!s_inflaters.hasLocalData()) {
+        s_inflaters.setLocalData(new CGZipInflater());
+    }
+
+    return s_inflaters.localData()->unpack(data);
 }
@@ -29,6 +29,7 @@ public:
     static int randomBytes(QByteArray *array);
     static int randomBytes(quint64 *number);
     static int randomBytes(char *buffer, int count);
+    static int appendRandomPadding(QByteArray *array, int alignment);
     static quint64 greatestCommonOddDivisor(quint64 a, quint64 b);
     static quint64 findDivider(quint64 number);
     static QByteArray sha1(const QByteArray &data);
@@ -38,7 +39,10 @@ public:
     static QByteArray binaryNumberModExp(const QByteArray &data, const QByteArray &mod, const QByteArray &exp);
     static QByteArray rsa(const QByteArray &data, const SRsaKey &key);
     static QByteArray aesDecrypt(const QByteArray &data, const SAesKey &key);
+    static void aesDecrypt(const QByteArray &data, const SAesKey &key, QByteArray *output);
     static QByteArray aesEncrypt(const QByteArray &data, const SAesKey &key);
+    static void aesEncrypt(char *data, int size, const SAesKey &key);
+    static QByteArray packGZip(const QByteArray &data);
     static QByteArray unpackGZip(const QByteArray &data);
 
 };
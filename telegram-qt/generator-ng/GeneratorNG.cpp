@@ -27,6 +27,8 @@ static const QString tlPrefix = QLatin1String("TL");
 static const QString tlValueName = tlPrefix + QLatin1String("Value");
 static const QString tlTypeMember = QLatin1String("tlType");
 static const QString tlVectorType = QLatin1String("TLVector");
+static const QString tlOptionalType = QLatin1String("TLOptional");
+static const QString tlSharedType = QLatin1String("TLShared");
 static const QStringList podTypes = QStringList() << "bool" << "quint32" << "quint64" << "double" << tlValueName;
 static const QStringList initTypesValues = QStringList() << "false" << "0" << "0" << "0" << "0";
 static const QStringList plainTypes = QStringList() << "Bool" << "#" << "int" << "long" << "double" << "string" << "bytes";
@@ -41,6 +43,15 @@ static const QString doubleSpacing = spacing + spacing;
 static const QString streamClassName = QLatin1String("CTelegramStream");
 static const QString methodsClassName = QLatin1String("CTelegramConnection");
 
+// Vectors of these types are instanced by hand in the stream implementation
+static const QStringList nativeVectorTypes = QStringList() << "quint32" << "quint64" << "QString";
+
+// Types with the generated read-only views (see TLViews.hpp)
+static const QStringList viewTypes = QStringList()
+        << QLatin1String("TLMessage")
+        << QLatin1String("TLUpdatesDifference")
+           ;
+
 static const QStringList typesBlackList = QStringList()
         << QLatin1String("TLVector t")
         << QLatin1String("TLNull")
@@ -258,6 +269,7 @@ static QMap<QString, TLMethod> readFunctionsJson(const QJsonDocument &document)
         TLMethod tlMethod;
         tlMethod.name = methodName;
         tlMethod.id = methodId;
+        tlMethod.type = formatType(obj.value("type").toString());
 
         const QJsonArray params = obj.value("params").toArray();
 
@@ -299,6 +311,36 @@ QString GeneratorNG::generateTLValuesDefinition(const TLMethod &method)
     return QString("        %1 = 0x%2,\n").arg(nameFirstCapital).arg(method.id, 8, 0x10, QLatin1Char('0'));
 }
 
+// The object members, which are not a part of every constructor or depend on flags, are the alternatives
+// of the type. They are kept in TLOptional to not carry all of them in every object.
+static bool isOptionalMember(const TLType &type, const TLParam &member)
+{
+    if (nativeTypes.contains(member.type) || podTypes.contains(member.type) || member.type.startsWith(tlVectorType)) {
+        return false;
+    }
+
+    foreach (const TLSubType &subType, type.subTypes) {
+        bool found = false;
+
+        foreach (const TLParam &subTypeMember, subType.members) {
+            if (subTypeMember.name == member.name) {
+                if (subTypeMember.dependOnFlag()) {
+                    return true;
+                }
+
+                found = true;
+                break;
+            }
+        }
+
+        if (!found) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
 QString GeneratorNG::generateTLTypeDefinition(const TLType &type)
 {
     QString code;
@@ -326,7 +368,11 @@ QString GeneratorNG::generateTLTypeDefinition(const TLType &type)
 //            copyConstructor += QString("%1%2(%3.%2),\n").arg(doubleSpacing).arg(member.name).arg(anotherName);
 //            copyOperator += QString("%1%2 = %3.%2;\n").arg(doubleSpacing).arg(member.name).arg(anotherName);
 
-            membersCode.append(QString("%1%2 %3;\n").arg(spacing).arg(member.type).arg(member.name));
+            if (isOptionalMember(type, member)) {
+                membersCode.append(QString("%1%2<%3> %4;\n").arg(spacing).arg(tlOptionalType).arg(member.type).arg(member.name));
+            } else {
+                membersCode.append(QString("%1%2 %3;\n").arg(spacing).arg(member.type).arg(member.name));
+            }
 
             if (!podTypes.contains(member.type)) {
                 continue;
@@ -383,20 +429,22 @@ QString GeneratorNG::generateStreamReadOperatorDefinition(const TLType &type)
     QString argName = removePrefix(type.name);
     argName[0] = argName.at(0).toLower();
 
+    // The members are read in place (without a temporary object and its copy),
+    // so the target is reset first to clear the members of the previous value.
     code.append(QString("%1 &%1::operator>>(%2 &%3)\n{\n").arg(streamClassName).arg(type.name).arg(argName));
-    code.append(QString("%1%2 result;\n\n").arg(spacing).arg(type.name));
-    code.append(QString("%1*this >> result.tlType;\n\n%1switch (result.tlType) {\n").arg(spacing));
+    code.append(QString("%1%2 = %3();\n\n").arg(spacing).arg(argName).arg(type.name));
+    code.append(QString("%1*this >> %2.tlType;\n\n%1switch (%2.tlType) {\n").arg(spacing).arg(argName));
 
     foreach (const TLSubType &subType, type.subTypes) {
         code.append(QString("%1case %2::%3:\n").arg(spacing).arg(tlValueName).arg(subType.name));
 
         foreach (const TLParam &member, subType.members) {
             if (member.dependOnFlag()) {
-                code.append(doubleSpacing + QString("if (result.%1 & 1 << %2) {\n").arg(member.flagMember).arg(member.flagBit));
-                code.append(doubleSpacing + spacing + QString("*this >> result.%1;\n").arg(member.name));
+                code.append(doubleSpacing + QString("if (%1.%2 & 1 << %3) {\n").arg(argName).arg(member.flagMember).arg(member.flagBit));
+                code.append(doubleSpacing + spacing + QString("*this >> %1.%2;\n").arg(argName).arg(member.name));
                 code.append(doubleSpacing + QLatin1Literal("}\n"));
             } else {
-                code.append(doubleSpacing + QString("*this >> result.%1;\n").arg(member.name));
+                code.append(doubleSpacing + QString("*this >> %1.%2;\n").arg(argName).arg(member.name));
             }
         }
 
@@ -404,7 +452,7 @@ QString GeneratorNG::generateStreamReadOperatorDefinition(const TLType &type)
     }
 
     code.append(QString("%1default:\n%1%1break;\n%1}\n\n").arg(spacing));
-    code.append(QString("%1%2 = result;\n\n%1return *this;\n}\n\n").arg(spacing).arg(argName));
+    code.append(QString("%1return *this;\n}\n\n").arg(spacing));
 
     return code;
 }
@@ -451,6 +499,272 @@ QString GeneratorNG::generateStreamWriteVectorTemplate(const QString &type)
     return QString(QLatin1String("template %1 &%1::operator<<(const TLVector<%2> &v);\n")).arg(streamClassName).arg(type);
 }
 
+QString GeneratorNG::generateStreamSizeFunctionDeclaration(const TLType &type)
+{
+    QString argName = removePrefix(type.name);
+    argName[0] = argName.at(0).toLower();
+    return spacing + QString("static int serializedSize(const %1 &%2);\n").arg(type.name).arg(argName);
+}
+
+QString GeneratorNG::generateStreamSizeFunctionDefinition(const TLType &type)
+{
+    QString code;
+
+    QString argName = removePrefix(type.name);
+    argName[0] = argName.at(0).toLower();
+
+    code.append(QString("int %1::serializedSize(const %2 &%3)\n{\n").arg(streamClassName).arg(type.name).arg(argName));
+    code.append(QString("%1int size = serializedSize(%2.tlType);\n\n%1switch (%2.tlType) {\n").arg(spacing).arg(argName));
+
+    foreach (const TLSubType &subType, type.subTypes) {
+        code.append(QString("%1case %2::%3:\n").arg(spacing).arg(tlValueName).arg(subType.name));
+
+        foreach (const TLParam &member, subType.members) {
+            if (member.dependOnFlag()) {
+                code.append(doubleSpacing + QString("if (%1.%2 & 1 << %3) {\n").arg(argName).arg(member.flagMember).arg(member.flagBit));
+                code.append(doubleSpacing + spacing + QString("size += serializedSize(%1.%2);\n").arg(argName).arg(member.name));
+                code.append(doubleSpacing + QLatin1Literal("}\n"));
+            } else {
+                code.append(doubleSpacing + QString("size += serializedSize(%1.%2);\n").arg(argName).arg(member.name));
+            }
+        }
+
+        code.append(QString("%1break;\n").arg(doubleSpacing));
+    }
+
+    code.append(QString("%1default:\n%1%1break;\n%1}\n\n").arg(spacing));
+    code.append(spacing + QString("return size;\n}\n\n"));
+
+    return code;
+}
+
+static QStringList typeMembers(const TLType &type)
+{
+    // The same order as in the type definition
+    QStringList members;
+
+    foreach (const TLSubType &subType, type.subTypes) {
+        foreach (const TLParam &member, subType.members) {
+            if (!members.contains(member.name)) {
+                members.append(member.name);
+            }
+        }
+    }
+
+    return members;
+}
+
+static QString schemaFieldKind(const QString &type)
+{
+    if (type == QLatin1String("bool")) {
+        return QLatin1String("FieldBool");
+    } else if (type == QLatin1String("quint32")) {
+        return QLatin1String("FieldInt");
+    } else if (type == QLatin1String("quint64")) {
+        return QLatin1String("FieldLong");
+    } else if (type == QLatin1String("double")) {
+        return QLatin1String("FieldDouble");
+    } else if ((type == QLatin1String("QString")) || (type == QLatin1String("QByteArray"))) {
+        return QLatin1String("FieldBytes");
+    }
+
+    return QLatin1String("FieldObject");
+}
+
+static QString schemaTypeIndex(const QString &type)
+{
+    return QLatin1String("Type") + removePrefix(type);
+}
+
+static QString viewMemberIndex(const QString &member)
+{
+    return QLatin1String("Member") + formatName1stCapital(member);
+}
+
+QString GeneratorNG::generateTLSchema(const QList<TLType> &types)
+{
+    QString code;
+    QString fieldsCode;
+    QString constructorsCode;
+    QString typesCode;
+
+    QStringList typeNames;
+    foreach (const TLType &type, types) {
+        typeNames.append(type.name);
+    }
+
+    code.append(QLatin1String("enum TLSchemaTypeIndex {\n"));
+
+    foreach (const TLType &type, types) {
+        code.append(spacing + schemaTypeIndex(type.name) + QLatin1String(",\n"));
+    }
+
+    code.append(QLatin1String("};\n\n"));
+
+    int fieldsCount = 0;
+    int constructorsCount = 0;
+
+    foreach (const TLType &type, types) {
+        const QStringList members = typeMembers(type);
+
+        typesCode.append(spacing + QString("{ %1, %2, %3 }, // %4\n").arg(constructorsCount).arg(type.subTypes.count()).arg(members.count()).arg(type.name));
+
+        foreach (const TLSubType &subType, type.subTypes) {
+            constructorsCode.append(spacing + QString("{ %1::%2, %3, %4 },\n").arg(tlValueName).arg(subType.name).arg(fieldsCount).arg(subType.members.count()));
+            ++constructorsCount;
+
+            if (!subType.members.isEmpty()) {
+                fieldsCode.append(spacing + QString("// %1\n").arg(subType.name));
+            }
+
+            QStringList subTypeMembers;
+            foreach (const TLParam &member, subType.members) {
+                subTypeMembers.append(member.name);
+            }
+
+            foreach (const TLParam &member, subType.members) {
+                const QString elementType = getTypeOrVectorType(member.type);
+                const QString elementKind = schemaFieldKind(elementType);
+
+                QString kind = elementKind;
+                QString vectorElementKind = QLatin1String("0");
+
+                if (elementType != member.type) {
+                    kind = QLatin1String("FieldVector");
+                    vectorElementKind = elementKind;
+                }
+
+                QString typeIndex = QLatin1String("-1");
+
+                if (elementKind == QLatin1String("FieldObject")) {
+                    if (!typeNames.contains(elementType)) {
+                        qDebug() << Q_FUNC_INFO << "Unknown type" << elementType << "of member" << member.name;
+                    }
+
+                    typeIndex = schemaTypeIndex(elementType);
+                }
+
+                QString flagBit = QLatin1String("-1");
+                int flagFieldIndex = 0;
+
+                if (member.dependOnFlag()) {
+                    flagBit = QString::number(member.flagBit);
+                    flagFieldIndex = subTypeMembers.indexOf(member.flagMember);
+                }
+
+                fieldsCode.append(spacing + QString("{ %1, %2, %3, %4, %5, %6 }, // %7\n")
+                                  .arg(kind).arg(vectorElementKind).arg(typeIndex)
+                                  .arg(members.indexOf(member.name)).arg(flagBit).arg(flagFieldIndex).arg(member.name));
+                ++fieldsCount;
+            }
+        }
+    }
+
+    code.append(QLatin1String("static const TLSchemaField s_schemaFields[] = {\n"));
+    code.append(fieldsCode);
+    code.append(QLatin1String("};\n\n"));
+
+    code.append(QLatin1String("static const TLSchemaConstructor s_schemaConstructors[] = {\n"));
+    code.append(constructorsCode);
+    code.append(QLatin1String("};\n\n"));
+
+    code.append(QLatin1String("static const TLSchemaType s_schemaTypes[] = {\n"));
+    code.append(typesCode);
+    code.append(QLatin1String("};\n"));
+
+    return code;
+}
+
+static QString viewMemberType(const QString &type)
+{
+    const QString elementType = getTypeOrVectorType(type);
+
+    if (!viewTypes.contains(elementType)) {
+        return type;
+    }
+
+    if (elementType == type) {
+        return type + QLatin1String("View");
+    }
+
+    return QString("%1<%2View>").arg(tlVectorType).arg(elementType);
+}
+
+QString GeneratorNG::generateTLViewDeclaration(const TLType &type)
+{
+    QString code;
+    const QString viewName = type.name + QLatin1String("View");
+
+    code.append(QString("class %1 : public TLView\n{\npublic:\n").arg(viewName));
+    code.append(spacing + QString("%1();\n\n").arg(viewName));
+    code.append(spacing + QString("%1 toStruct() const;\n\n").arg(type.name));
+
+    QString membersCode;
+    QStringList addedMembers;
+
+    foreach (const TLSubType &subType, type.subTypes) {
+        foreach (const TLParam &member, subType.members) {
+            if (addedMembers.contains(member.name)) {
+                continue;
+            }
+
+            addedMembers.append(member.name);
+            code.append(spacing + QString("%1 %2() const;\n").arg(viewMemberType(member.type)).arg(member.name));
+            membersCode.append(doubleSpacing + viewMemberIndex(member.name) + QLatin1String(",\n"));
+        }
+    }
+
+    code.append(QLatin1String("\nprivate:\n"));
+    code.append(spacing + QLatin1String("enum Member {\n"));
+    code.append(membersCode);
+    code.append(spacing + QLatin1String("};\n\n};\n\n"));
+
+    return code;
+}
+
+QString GeneratorNG::generateTLViewDefinition(const TLType &type)
+{
+    QString code;
+    const QString viewName = type.name + QLatin1String("View");
+
+    code.append(QString("%1::%1() :\n%2TLView(%3)\n{\n}\n\n").arg(viewName).arg(spacing).arg(schemaTypeIndex(type.name)));
+    code.append(QString("%1 %2::toStruct() const\n{\n%3return object<%1>();\n}\n\n").arg(type.name).arg(viewName).arg(spacing));
+
+    foreach (const QString &memberName, typeMembers(type)) {
+        QString memberType;
+
+        foreach (const TLSubType &subType, type.subTypes) {
+            foreach (const TLParam &member, subType.members) {
+                if (member.name == memberName) {
+                    memberType = member.type;
+                    break;
+                }
+            }
+
+            if (!memberType.isEmpty()) {
+                break;
+            }
+        }
+
+        const QString elementType = getTypeOrVectorType(memberType);
+        QString reader;
+
+        if (!viewTypes.contains(elementType)) {
+            // The space keeps the nested template argument C++98 compatible ("> >").
+            reader = QString("member<%1%2>").arg(memberType).arg(memberType.endsWith(QLatin1Char('>')) ? QLatin1String(" ") : QLatin1String(""));
+        } else if (elementType == memberType) {
+            reader = QString("memberView<%1View>").arg(elementType);
+        } else {
+            reader = QString("memberViews<%1View>").arg(elementType);
+        }
+
+        code.append(QString("%1 %2::%3() const\n{\n").arg(viewMemberType(memberType)).arg(viewName).arg(memberName));
+        code.append(spacing + QString("return %1(%2);\n}\n\n").arg(reader).arg(viewMemberIndex(memberName)));
+    }
+
+    return code;
+}
+
 QString GeneratorNG::generateDebugWriteOperatorDeclaration(const TLType &type)
 {
     QString argName = removePrefix(type.name);
@@ -504,6 +818,23 @@ QString GeneratorNG::generateDebugWriteOperatorDefinition(const TLType &type)
 //    }
 }
 
+// Vectors are implicitly shared already, so only the objects are wrapped into the shared handle.
+static bool isSharedResult(const TLMethod &method, bool sharedResults)
+{
+    return sharedResults && (method.type != QLatin1String("bool")) && !method.type.startsWith(tlVectorType);
+}
+
+QString formatResultParam(const TLMethod &method, bool sharedResult)
+{
+    if (method.type == QLatin1String("bool")) {
+        return QLatin1String("bool result");
+    } else if (sharedResult) {
+        return QString("const %1<%2> &result").arg(tlSharedType).arg(method.type);
+    } else {
+        return QString("const %1 &result").arg(method.type);
+    }
+}
+
 QString GeneratorNG::generateConnectionMethodDeclaration(const TLMethod &method)
 {
     return spacing + QString("quint64 %1(%2);\n").arg(method.name).arg(formatMethodParams(method));
@@ -513,7 +844,23 @@ QString GeneratorNG::generateConnectionMethodDefinition(const TLMethod &method,
 {
     QString result;
     result += QString("quint64 %1::%2(%3)\n{\n").arg(methodsClassName).arg(method.name).arg(formatMethodParams(method));
+
+    // The exact size of the request is known in advance, so the output is allocated once.
+    result += spacing + QString("int outputSize = %1::serializedSize(%2::%3);\n").arg(streamClassName).arg(tlValueName).arg(formatName1stCapital(method.name));
+
+    foreach (const TLParam &param, method.params) {
+        if (param.dependOnFlag()) {
+            result += spacing + QString("if (%1 & 1 << %2) {\n").arg(param.flagMember).arg(param.flagBit);
+            result += spacing + spacing + QString("outputSize += %1::serializedSize(%2);\n").arg(streamClassName).arg(param.name);
+            result += spacing + QLatin1String("}\n");
+        } else {
+            result += spacing + QString("outputSize += %1::serializedSize(%2);\n").arg(streamClassName).arg(param.name);
+        }
+    }
+
+    result += QLatin1Char('\n');
     result += spacing + QLatin1String("QByteArray output;\n");
+    result += spacing + QLatin1String("output.reserve(outputSize);\n");
     result += spacing + streamClassName + QLatin1String(" outputStream(&output, /* write */ true);\n\n");
 
     result += spacing + QString("outputStream << %1::%2;\n").arg(tlValueName).arg(formatName1stCapital(method.name));
@@ -538,6 +885,73 @@ QString GeneratorNG::generateConnectionMethodDefinition(const TLMethod &method,
     return result;
 }
 
+QString GeneratorNG::generateRpcResultSignalDeclaration(const TLMethod &method, bool sharedResult)
+{
+    return spacing + QString("void %1ResultReceived(quint64 requestId, %2);\n").arg(method.name).arg(formatResultParam(method, sharedResult));
+}
+
+QString GeneratorNG::generateRpcResultReaderDeclaration(const TLMethod &method)
+{
+    return spacing + QString("TLValue read%1Result(%2 &stream, quint64 id);\n").arg(formatName1stCapital(method.name)).arg(streamClassName);
+}
+
+QString GeneratorNG::generateRpcResultReaderDefinition(const TLMethod &method, bool sharedResult)
+{
+    QString result;
+    result += QString("TLValue %1::read%2Result(%3 &stream, quint64 id)\n{\n").arg(methodsClassName).arg(formatName1stCapital(method.name)).arg(streamClassName);
+
+    if (method.type == QLatin1String("bool")) {
+        result += spacing + tlValueName + QLatin1String(" result;\n");
+        result += spacing + QLatin1String("stream >> result;\n\n");
+        result += spacing + QString("if ((result == %1::BoolTrue) || (result == %1::BoolFalse)) {\n").arg(tlValueName);
+        result += doubleSpacing + QString("emit %1ResultReceived(id, result == %2::BoolTrue);\n").arg(method.name).arg(tlValueName);
+        result += spacing + QLatin1String("}\n\n");
+        result += spacing + QLatin1String("return result;\n}\n\n");
+    } else if (sharedResult) {
+        // The result is shared with the receivers after the emission, so the type is taken before it
+        result += spacing + QString("%1<%2> result;\n").arg(tlSharedType).arg(method.type);
+        result += spacing + QLatin1String("stream >> result;\n");
+        result += spacing + QString("const %1 resultType = result->%2;\n\n").arg(tlValueName).arg(tlTypeMember);
+        result += spacing + QLatin1String("if (isRpcResultPayload(resultType) && !stream.error()) {\n");
+        result += doubleSpacing + QString("emit %1ResultReceived(id, result);\n").arg(method.name);
+        result += spacing + QLatin1String("}\n\n");
+        result += spacing + QLatin1String("return resultType;\n}\n\n");
+    } else {
+        result += spacing + QString("%1 result;\n").arg(method.type);
+        result += spacing + QLatin1String("stream >> result;\n\n");
+        result += spacing + QString("if (isRpcResultPayload(result.%1) && !stream.error()) {\n").arg(tlTypeMember);
+        result += doubleSpacing + QString("emit %1ResultReceived(id, result);\n").arg(method.name);
+        result += spacing + QLatin1String("}\n\n");
+        result += spacing + QString("return result.%1;\n}\n\n").arg(tlTypeMember);
+    }
+
+    return result;
+}
+
+QString GeneratorNG::generateRpcResultReadersTable(const QList<TLMethod> &methods, const QStringList &customHandlers)
+{
+    QString result;
+    result += QString("const %1::RpcResultReader %1::s_rpcResultReaders[] = {\n").arg(methodsClassName);
+
+    foreach (const TLMethod &method, methods) {
+        const QString name = formatName1stCapital(method.name);
+        QString reader;
+
+        if (customHandlers.contains(name)) {
+            reader = QString("process%1").arg(name);
+        } else {
+            reader = QString("read%1Result").arg(name);
+        }
+
+        result += spacing + QString("{ %1::%2, &%3::%4 },\n").arg(tlValueName).arg(name).arg(methodsClassName).arg(reader);
+    }
+
+    result += QLatin1String("};\n\n");
+    result += QString("const int %1::s_rpcResultReadersCount = sizeof(%1::s_rpcResultReaders) / sizeof(%1::s_rpcResultReaders[0]);\n").arg(methodsClassName);
+
+    return result;
+}
+
 QList<TLType> GeneratorNG::solveTypes(QMap<QString, TLType> types)
 {
     QList<TLType> solvedTypes;
@@ -751,6 +1165,7 @@ bool GeneratorNG::loadDataFromText(const QByteArray &data)
             tlMethod.name = functionName;
             tlMethod.id = predicateId;
             tlMethod.params.append(tlParams);
+            tlMethod.type = formatType(typePart.trimmed().toString());
 
             m_functions.insert(functionName, tlMethod);
         }
@@ -770,8 +1185,18 @@ void GeneratorNG::generate()
     codeStreamWriteDeclarations.clear();
     codeStreamWriteDefinitions.clear();
     codeStreamWriteTemplateInstancing.clear();
+    codeStreamSizeDeclarations.clear();
+    codeStreamSizeDefinitions.clear();
     codeConnectionDeclarations.clear();
     codeConnectionDefinitions.clear();
+    codeConnectionRpcResultSignals.clear();
+    codeOfSharedResultsMetaTypes.clear();
+    codeConnectionRpcResultReadersDeclarations.clear();
+    codeConnectionRpcResultReadersDefinitions.clear();
+    codeConnectionRpcResultReadersTable.clear();
+    codeOfTLSchema.clear();
+    codeOfTLViewsDeclarations.clear();
+    codeOfTLViewsDefinitions.clear();
     codeDebugWriteDeclarations.clear();
     codeDebugWriteDefinitions.clear();
 
@@ -830,6 +1255,66 @@ void GeneratorNG::generate()
 
     QStringList vectorUsedForRead;
     getUsedAndVectorTypes(usedTypes, vectorUsedForRead);
+
+    // Methods sorted by id: the connection looks up the result reader with the binary search.
+    QMap<quint32, TLMethod> resultReaders;
+    QStringList sharedResultTypes;
+
+    foreach (const TLMethod &method, m_functions) {
+        if (rpcResultHandlers.contains(formatName1stCapital(method.name))) {
+            resultReaders.insert(method.id, method);
+            continue;
+        }
+
+        bool addReader = false;
+        foreach (const QString &white, whiteList) {
+            if (method.name.startsWith(white)) {
+                addReader = true;
+                break;
+            }
+        }
+
+        if (!addReader) {
+            continue;
+        }
+
+        const QString resultType = getTypeOrVectorType(method.type);
+
+        if (resultType == method.type) {
+            addReader = (resultType == QLatin1String("bool")) || usedTypes.contains(resultType);
+        } else {
+            addReader = nativeVectorTypes.contains(resultType) || usedTypes.contains(resultType);
+
+            if (addReader && !nativeVectorTypes.contains(resultType) && !vectorUsedForRead.contains(resultType)) {
+                vectorUsedForRead.append(resultType);
+            }
+        }
+
+        if (!addReader) {
+            continue;
+        }
+
+        resultReaders.insert(method.id, method);
+
+        const bool sharedResult = isSharedResult(method, sharedResults);
+
+        if (sharedResult && !sharedResultTypes.contains(method.type)) {
+            sharedResultTypes.append(method.type);
+        }
+
+        codeConnectionRpcResultSignals.append(generateRpcResultSignalDeclaration(method, sharedResult));
+        codeConnectionRpcResultReadersDeclarations.append(generateRpcResultReaderDeclaration(method));
+        codeConnectionRpcResultReadersDefinitions.append(generateRpcResultReaderDefinition(method, sharedResult));
+    }
+
+    // The shared results are passed in signals, so the handles are declared as the meta types
+    sharedResultTypes.sort();
+    foreach (const QString &type, sharedResultTypes) {
+        codeOfSharedResultsMetaTypes.append(QString("Q_DECLARE_METATYPE(%1<%2>)\n").arg(tlSharedType).arg(type));
+    }
+
+    codeConnectionRpcResultReadersTable = generateRpcResultReadersTable(resultReaders.values(), rpcResultHandlers);
+
     foreach (const QString &str, vectorUsedForRead) {
         codeStreamReadTemplateInstancing.append(generateStreamReadVectorTemplate(str));
     }
@@ -849,6 +1334,8 @@ void GeneratorNG::generate()
         codeOfTLValues.append(generateTLValuesDefinition(method));
     }
 
+    QList<TLType> schemaTypes;
+
     foreach (const TLType &type, m_solvedTypes) {
         if (nativeTypes.contains(type.name)) {
             continue;
@@ -866,10 +1353,22 @@ void GeneratorNG::generate()
         if (typesUsedForWrite.contains(type.name)) {
             codeStreamWriteDeclarations.append(generateStreamWriteOperatorDeclaration(type));
             codeStreamWriteDefinitions.append(generateStreamWriteOperatorDefinition(type));
+
+            codeStreamSizeDeclarations.append(generateStreamSizeFunctionDeclaration(type));
+            codeStreamSizeDefinitions.append(generateStreamSizeFunctionDefinition(type));
         }
 
         codeDebugWriteDeclarations.append(generateDebugWriteOperatorDeclaration(type));
         codeDebugWriteDefinitions .append(generateDebugWriteOperatorDefinition(type));
+
+        schemaTypes.append(type);
+
+        if (viewTypes.contains(type.name)) {
+            codeOfTLViewsDeclarations.append(generateTLViewDeclaration(type));
+            codeOfTLViewsDefinitions.append(generateTLViewDefinition(type));
+        }
     }
 
+    codeOfTLSchema = generateTLSchema(schemaTypes);
+
 }
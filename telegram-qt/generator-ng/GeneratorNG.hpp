@@ -62,11 +62,14 @@ struct TLMethod {
     QString name;
     quint32 id;
     QList< TLParam > params;
+    QString type;
 };
 
 class GeneratorNG
 {
 public:
+    GeneratorNG() : sharedResults(false) { }
+
     bool loadDataFromJson(const QByteArray &data);
     bool loadDataFromText(const QByteArray &data);
     void generate();
@@ -80,6 +83,12 @@ public:
     static QString generateStreamWriteOperatorDeclaration(const TLType &type);
     static QString generateStreamWriteOperatorDefinition(const TLType &type);
     static QString generateStreamWriteVectorTemplate(const QString &type);
+    static QString generateStreamSizeFunctionDeclaration(const TLType &type);
+    static QString generateStreamSizeFunctionDefinition(const TLType &type);
+
+    static QString generateTLSchema(const QList<TLType> &types);
+    static QString generateTLViewDeclaration(const TLType &type);
+    static QString generateTLViewDefinition(const TLType &type);
 
     static QString generateDebugWriteOperatorDeclaration(const TLType &type);
     static QString generateDebugWriteOperatorDefinition(const TLType &type);
@@ -87,23 +96,41 @@ public:
     static QString generateConnectionMethodDeclaration(const TLMethod &method);
     static QString generateConnectionMethodDefinition(const TLMethod &method, QStringList &usedTypes);
 
+    static QString generateRpcResultSignalDeclaration(const TLMethod &method, bool sharedResult);
+    static QString generateRpcResultReaderDeclaration(const TLMethod &method);
+    static QString generateRpcResultReaderDefinition(const TLMethod &method, bool sharedResult);
+    static QString generateRpcResultReadersTable(const QList<TLMethod> &methods, const QStringList &customHandlers);
+
     static QList<TLType> solveTypes(QMap<QString, TLType> types);
 
     void getUsedAndVectorTypes(QStringList &usedTypes, QStringList &vectors) const;
 
     QString codeOfTLValues;
     QString codeOfTLTypes;
+    QString codeOfSharedResultsMetaTypes;
     QString codeStreamReadDeclarations;
     QString codeStreamReadDefinitions;
     QString codeStreamReadTemplateInstancing;
     QString codeStreamWriteDeclarations;
     QString codeStreamWriteDefinitions;
     QString codeStreamWriteTemplateInstancing;
+    QString codeStreamSizeDeclarations;
+    QString codeStreamSizeDefinitions;
     QString codeConnectionDeclarations;
     QString codeConnectionDefinitions;
+    QString codeConnectionRpcResultSignals;
+    QString codeConnectionRpcResultReadersDeclarations;
+    QString codeConnectionRpcResultReadersDefinitions;
+    QString codeConnectionRpcResultReadersTable;
+    QString codeOfTLSchema;
+    QString codeOfTLViewsDeclarations;
+    QString codeOfTLViewsDefinitions;
     QString codeDebugWriteDeclarations;
     QString codeDebugWriteDefinitions;
 
+    QStringList rpcResultHandlers; // Methods (in TLValue notation) with the hand-written process<Method>() result handler
+    bool sharedResults; // Pass the RPC results in the signals as implicitly shared TLShared<T> handles
+
 private:
     QMap<QString, TLType> m_types;
     QList<TLType> m_solvedTypes;
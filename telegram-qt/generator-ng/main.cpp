@@ -18,6 +18,7 @@
 #include <QCoreApplication>
 #include <QDebug>
 #include <QFile>
+#include <QRegExp>
 #include <QNetworkAccessManager>
 #include <QNetworkReply>
 
@@ -115,6 +116,29 @@ bool replacingHelper(const QString &fileName, int spacing, const QString &marker
 
 /* End of replacing helper */
 
+QStringList readRpcResultHandlers(const QString &fileName)
+{
+    QFile connectionHeader(fileName);
+
+    if (!connectionHeader.open(QIODevice::ReadOnly)) {
+        printf("Can not read file %s.\n", fileName.toLatin1().constData());
+        return QStringList();
+    }
+
+    const QString content = QString::fromLatin1(connectionHeader.readAll());
+    QRegExp handlerRegExp(QLatin1String("TLValue process(\\w+)\\(CTelegramStream &stream, quint64 id\\)"));
+
+    QStringList handlers;
+    int position = 0;
+
+    while ((position = handlerRegExp.indexIn(content, position)) >= 0) {
+        handlers.append(handlerRegExp.cap(1));
+        position += handlerRegExp.matchedLength();
+    }
+
+    return handlers;
+}
+
 void debugType(const TLType &type)
 {
     qDebug() << type.name;
@@ -185,7 +209,7 @@ StatusCode format(const QString &specFileName)
     return NoError;
 }
 
-StatusCode generate(SchemaFormat format, const QString &specFileName)
+StatusCode generate(SchemaFormat format, const QString &specFileName, bool sharedResults)
 {
     QFile specsFile(specFileName);
     specsFile.open(QIODevice::ReadOnly);
@@ -200,6 +224,7 @@ StatusCode generate(SchemaFormat format, const QString &specFileName)
     specsFile.close();
 
     GeneratorNG generator;
+    generator.sharedResults = sharedResults;
 
     bool success = true;
 
@@ -217,18 +242,30 @@ StatusCode generate(SchemaFormat format, const QString &specFileName)
         return SchemaReadError;
     }
 
+    generator.rpcResultHandlers = readRpcResultHandlers(QLatin1String("../CTelegramConnection.hpp"));
     generator.generate();
 
     replacingHelper(QLatin1String("../TLValues.hpp"), 8, QLatin1String("TLValues"), generator.codeOfTLValues);
     replacingHelper(QLatin1String("../TLTypes.hpp"), 0, QLatin1String("TLTypes"), generator.codeOfTLTypes);
+    replacingHelper(QLatin1String("../TLTypes.hpp"), 0, QLatin1String("shared results meta types"), generator.codeOfSharedResultsMetaTypes);
     replacingHelper(QLatin1String("../CTelegramStream.hpp"), 4, QLatin1String("read operators"), generator.codeStreamReadDeclarations);
     replacingHelper(QLatin1String("../CTelegramStream.cpp"), 0, QLatin1String("read operators implementation"), generator.codeStreamReadDefinitions);
     replacingHelper(QLatin1String("../CTelegramStream.cpp"), 0, QLatin1String("vector read templates instancing"), generator.codeStreamReadTemplateInstancing);
     replacingHelper(QLatin1String("../CTelegramStream.hpp"), 4, QLatin1String("write operators"), generator.codeStreamWriteDeclarations);
     replacingHelper(QLatin1String("../CTelegramStream.cpp"), 0, QLatin1String("write operators implementation"), generator.codeStreamWriteDefinitions);
     replacingHelper(QLatin1String("../CTelegramStream.cpp"), 0, QLatin1String("vector write templates instancing"), generator.codeStreamWriteTemplateInstancing);
+    replacingHelper(QLatin1String("../CTelegramStream.hpp"), 4, QLatin1String("serialized size functions"), generator.codeStreamSizeDeclarations);
+    replacingHelper(QLatin1String("../CTelegramStream.cpp"), 0, QLatin1String("serialized size functions implementation"), generator.codeStreamSizeDefinitions);
     replacingHelper(QLatin1String("../CTelegramConnection.hpp"), 4, QLatin1String("Telegram API methods declaration"), generator.codeConnectionDeclarations);
     replacingHelper(QLatin1String("../CTelegramConnection.cpp"), 0, QLatin1String("Telegram API methods implementation"), generator.codeConnectionDefinitions);
+    replacingHelper(QLatin1String("../CTelegramConnection.hpp"), 4, QLatin1String("RPC result signals"), generator.codeConnectionRpcResultSignals);
+    replacingHelper(QLatin1String("../CTelegramConnection.hpp"), 4, QLatin1String("RPC result readers declaration"), generator.codeConnectionRpcResultReadersDeclarations);
+    replacingHelper(QLatin1String("../CTelegramConnection.cpp"), 0, QLatin1String("RPC result readers implementation"), generator.codeConnectionRpcResultReadersDefinitions);
+    replacingHelper(QLatin1String("../CTelegramConnection.cpp"), 0, QLatin1String("RPC result readers table"), generator.codeConnectionRpcResultReadersTable);
+
+    replacingHelper(QLatin1String("../TLViews.cpp"), 0, QLatin1String("TL schema"), generator.codeOfTLSchema);
+    replacingHelper(QLatin1String("../TLViews.hpp"), 0, QLatin1String("TL views"), generator.codeOfTLViewsDeclarations);
+    replacingHelper(QLatin1String("../TLViews.cpp"), 0, QLatin1String("TL views implementation"), generator.codeOfTLViewsDefinitions);
 
     replacingHelper(QLatin1String("../TLTypesDebug.hpp"), 0, QLatin1String("TLTypes debug operators"), generator.codeDebugWriteDeclarations);
     replacingHelper(QLatin1String("../TLTypesDebug.cpp"), 0, QLatin1String("TLTypes debug operators"), generator.codeDebugWriteDefinitions);
@@ -253,6 +290,9 @@ StatusCode main2(const QStringList &arguments)
 
     StatusCode code = NoError;
 
+    // Emit the RPC result signals with the implicitly shared (copy-on-write) handles of the results
+    const bool sharedResults = arguments.contains(QLatin1String("--shared-results"));
+
     if (arguments.contains(QLatin1String("--fetch-json"))) {
         code = fetchJson(fileName);
         if (code != NoError) {
@@ -268,14 +308,14 @@ StatusCode main2(const QStringList &arguments)
     }
 
     if (arguments.contains(QLatin1String("--generate-from-json"))) {
-        code = generate(JsonFormat, fileName);
+        code = generate(JsonFormat, fileName, sharedResults);
         if (code != NoError) {
             return code;
         }
     }
 
     if (arguments.contains(QLatin1String("--generate-from-text"))) {
-        code = generate(TextFormat, fileName);
+        code = generate(TextFormat, fileName, sharedResults);
         if (code != NoError) {
             return code;
         }
@@ -22,23 +22,33 @@ SOURCES = CTelegramCore.cpp \
     CTelegramDispatcher.cpp \
     CRawStream.cpp \
     CTelegramStream.cpp \
+    CRandomGenerator.cpp \
+    CMessageIdWindow.cpp \
+    CConnectionScheduler.cpp \
+    CFloodWaitLimiter.cpp \
     Utils.cpp \
     TelegramUtils.cpp \
     CTcpTransport.cpp \
     TelegramNamespace.cpp \
     CTelegramConnection.cpp \
-    TLValues.cpp
+    TLValues.cpp \
+    TLViews.cpp
 
 HEADERS = CTelegramCore.hpp \
     CAppInformation.hpp \
     CTelegramDispatcher.hpp \
     CTelegramStream.hpp \
     CRawStream.hpp \
+    CRandomGenerator.hpp \
+    CMessageIdWindow.hpp \
+    CConnectionScheduler.hpp \
+    CFloodWaitLimiter.hpp \
     Utils.hpp \
     TelegramUtils.hpp \
     CTelegramTransport.hpp \
     CTcpTransport.hpp \
     TLTypes.hpp \
+    TLViews.hpp \
     TLNumbers.hpp \
     crypto-aes.hpp \
     crypto-rsa.hpp \
@@ -54,6 +64,11 @@ contains(options, developer-build) {
     DEFINES += DEVELOPER_BUILD
 }
 
+contains(options, libdeflate) {
+    DEFINES += HAVE_LIBDEFLATE
+    LIBS += -ldeflate
+}
+
 OTHER_FILES += CMakeLists.txt
 
 LIBS += -lssl -lcrypto
@@ -5,3 +5,10 @@ TEMPLATE = app
 INCLUDEPATH += $$PWD/..
 
 LIBS += -lssl -lcrypto
+
+include($$PWD/../../options.pri)
+
+contains(options, libdeflate) {
+    DEFINES += HAVE_LIBDEFLATE
+    LIBS += -ldeflate
+}
@@ -1,4 +1,8 @@
 TEMPLATE = subdirs
 SUBDIRS += tst_CTelegramConnection
 SUBDIRS += tst_CTelegramStream
+SUBDIRS += tst_CRandomGenerator
+SUBDIRS += tst_Utils
+SUBDIRS += tst_CMessageIdWindow
+SUBDIRS += tst_CFloodWaitLimiter
 #SUBDIRS += tst_CTelegramDispatcher
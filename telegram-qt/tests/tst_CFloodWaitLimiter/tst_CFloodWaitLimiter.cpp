@@ -0,0 +1,153 @@
+/*
+   Copyright (C) 2015 Alexandr Akulich <akulichalexander@gmail.com>
+
+   This file is a part of TelegramQt library.
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+ */
+#include <QObject>
+
+#include "CFloodWaitLimiter.hpp"
+
+#include <QTest>
+#include <QDebug>
+
+class tst_CFloodWaitLimiter : public QObject
+{
+    Q_OBJECT
+public:
+    explicit tst_CFloodWaitLimiter(QObject *parent = 0);
+
+private slots:
+    void unlimitedByDefault();
+    void floodWait();
+    void intervalLearning();
+    void relaxation();
+    void peerKeys();
+
+};
+
+static const quint32 c_method = 0x4cde0aab;
+static const quint32 c_otherMethod = 0x2a4e3a1d;
+static const quint32 c_peerType = 0x1023dbe8;
+static const qint64 c_startTime = Q_INT64_C(1420070400000);
+
+tst_CFloodWaitLimiter::tst_CFloodWaitLimiter(QObject *parent) :
+    QObject(parent)
+{
+}
+
+void tst_CFloodWaitLimiter::unlimitedByDefault()
+{
+    CFloodWaitLimiter limiter;
+    const quint64 key = CFloodWaitLimiter::methodKey(c_method);
+
+    for (int i = 0; i < 100; ++i) {
+        QCOMPARE(limiter.acquire(key, 0, c_startTime), quint32(0));
+    }
+
+    QVERIFY(!limiter.isLimited(key));
+    QCOMPARE(limiter.floodWaitTime(c_startTime), quint32(0));
+}
+
+void tst_CFloodWaitLimiter::floodWait()
+{
+    CFloodWaitLimiter limiter;
+    const quint64 key = CFloodWaitLimiter::methodKey(c_method);
+    const quint64 otherKey = CFloodWaitLimiter::methodKey(c_otherMethod);
+
+    limiter.processFloodWait(key, 10, c_startTime);
+
+    QVERIFY(limiter.isLimited(key));
+    QCOMPARE(limiter.floodWaitTime(c_startTime), quint32(10000));
+    QCOMPARE(limiter.acquire(key, 0, c_startTime), quint32(10000));
+    QCOMPARE(limiter.acquire(key, 0, c_startTime + 4000), quint32(6000));
+    QCOMPARE(limiter.acquire(otherKey, 0, c_startTime), quint32(0));
+
+    // No burst right after the block.
+    const qint64 unblockTime = c_startTime + 10000;
+    QCOMPARE(limiter.acquire(key, 0, unblockTime), quint32(0));
+    QCOMPARE(limiter.acquire(key, 0, unblockTime), quint32(CFloodWaitLimiter::MinimumTokenInterval));
+    QCOMPARE(limiter.acquire(key, 0, unblockTime + CFloodWaitLimiter::MinimumTokenInterval), quint32(0));
+
+    // The burst is restored by the quiet time.
+    const qint64 quietTime = unblockTime + CFloodWaitLimiter::MinimumTokenInterval * (CFloodWaitLimiter::Burst + 1);
+    for (int i = 0; i < CFloodWaitLimiter::Burst; ++i) {
+        QCOMPARE(limiter.acquire(key, 0, quietTime), quint32(0));
+    }
+    QVERIFY(limiter.acquire(key, 0, quietTime) > 0);
+}
+
+void tst_CFloodWaitLimiter::intervalLearning()
+{
+    CFloodWaitLimiter limiter;
+    const quint64 key = CFloodWaitLimiter::methodKey(c_method);
+
+    limiter.processFloodWait(key, 1, c_startTime);
+    QCOMPARE(limiter.tokenInterval(key), quint32(CFloodWaitLimiter::MinimumTokenInterval));
+
+    limiter.processFloodWait(key, 1, c_startTime + 5000);
+    QCOMPARE(limiter.tokenInterval(key), quint32(CFloodWaitLimiter::MinimumTokenInterval * 2));
+
+    for (int i = 0; i < 20; ++i) {
+        limiter.processFloodWait(key, 1, c_startTime + 10000);
+    }
+    QCOMPARE(limiter.tokenInterval(key), quint32(CFloodWaitLimiter::MaximumTokenInterval));
+
+    // The shorter wait does not cut the current block.
+    limiter.processFloodWait(key, 100, c_startTime);
+    limiter.processFloodWait(key, 1, c_startTime);
+    QCOMPARE(limiter.floodWaitTime(c_startTime), quint32(100000));
+}
+
+void tst_CFloodWaitLimiter::relaxation()
+{
+    CFloodWaitLimiter limiter;
+    const quint64 key = CFloodWaitLimiter::methodKey(c_method);
+
+    limiter.processFloodWait(key, 1, c_startTime);
+    limiter.processFloodWait(key, 1, c_startTime);
+    QCOMPARE(limiter.tokenInterval(key), quint32(CFloodWaitLimiter::MinimumTokenInterval * 2));
+
+    const qint64 relaxedTime = c_startTime + CFloodWaitLimiter::RelaxationPeriod;
+    QCOMPARE(limiter.acquire(key, 0, relaxedTime), quint32(0));
+    QVERIFY(limiter.isLimited(key));
+    QCOMPARE(limiter.tokenInterval(key), quint32(CFloodWaitLimiter::MinimumTokenInterval));
+
+    QCOMPARE(limiter.acquire(key, 0, relaxedTime + CFloodWaitLimiter::RelaxationPeriod), quint32(0));
+    QVERIFY(!limiter.isLimited(key));
+}
+
+void tst_CFloodWaitLimiter::peerKeys()
+{
+    CFloodWaitLimiter limiter;
+    const quint64 methodKey = CFloodWaitLimiter::methodKey(c_method);
+    const quint64 peerKey = CFloodWaitLimiter::peerKey(c_method, c_peerType, 1);
+    const quint64 otherPeerKey = CFloodWaitLimiter::peerKey(c_method, c_peerType, 2);
+
+    QVERIFY(peerKey != otherPeerKey);
+    QVERIFY(peerKey != methodKey);
+
+    limiter.processFloodWait(peerKey, 30, c_startTime);
+
+    QCOMPARE(limiter.acquire(methodKey, peerKey, c_startTime), quint32(30000));
+    QCOMPARE(limiter.acquire(methodKey, otherPeerKey, c_startTime), quint32(0));
+
+    // The method limit applies to all peers.
+    limiter.processFloodWait(methodKey, 5, c_startTime);
+    QCOMPARE(limiter.acquire(methodKey, otherPeerKey, c_startTime), quint32(5000));
+    QCOMPARE(limiter.acquire(methodKey, peerKey, c_startTime), quint32(30000));
+}
+
+QTEST_MAIN(tst_CFloodWaitLimiter)
+
+#include "tst_CFloodWaitLimiter.moc"
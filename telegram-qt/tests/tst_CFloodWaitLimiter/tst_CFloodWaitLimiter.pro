@@ -0,0 +1,8 @@
+include(../tests.pri)
+
+TARGET = tst_floodwaitlimiter
+SOURCES = tst_CFloodWaitLimiter.cpp \
+    ../../CFloodWaitLimiter.cpp
+
+HEADERS = \
+    ../../CFloodWaitLimiter.hpp
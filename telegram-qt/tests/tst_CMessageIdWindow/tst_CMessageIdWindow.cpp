@@ -0,0 +1,162 @@
+/*
+   Copyright (C) 2015 Alexandr Akulich <akulichalexander@gmail.com>
+
+   This file is a part of TelegramQt library.
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+ */
+#include <QObject>
+
+#include "CMessageIdWindow.hpp"
+
+#include <QTest>
+#include <QDebug>
+
+class tst_CMessageIdWindow : public QObject
+{
+    Q_OBJECT
+public:
+    explicit tst_CMessageIdWindow(QObject *parent = 0);
+
+private slots:
+    void duplicates();
+    void reordering();
+    void lateMessages();
+    void serviceMessages();
+    void sessionRestart();
+    void reusedCounter();
+
+};
+
+// Server message ids are odd and grow with the sequence number.
+static quint64 messageId(quint32 counter)
+{
+    return (quint64(0x55000000) << 32) + quint64(counter) * 4 + 1;
+}
+
+static quint32 contentSeqNo(quint32 counter)
+{
+    return counter * 2 + 1;
+}
+
+tst_CMessageIdWindow::tst_CMessageIdWindow(QObject *parent) :
+    QObject(parent)
+{
+}
+
+void tst_CMessageIdWindow::duplicates()
+{
+    CMessageIdWindow window;
+
+    for (quint32 i = 10; i < 20; ++i) {
+        QVERIFY(window.accept(messageId(i), contentSeqNo(i)));
+    }
+
+    for (quint32 i = 10; i < 20; ++i) {
+        QVERIFY(!window.accept(messageId(i), contentSeqNo(i)));
+    }
+}
+
+void tst_CMessageIdWindow::reordering()
+{
+    CMessageIdWindow window;
+
+    QVERIFY(window.accept(messageId(1), contentSeqNo(1)));
+    QVERIFY(window.accept(messageId(5), contentSeqNo(5)));
+    QVERIFY(window.accept(messageId(3), contentSeqNo(3)));
+    QVERIFY(window.accept(messageId(2), contentSeqNo(2)));
+    QVERIFY(!window.accept(messageId(3), contentSeqNo(3)));
+    QVERIFY(window.accept(messageId(4), contentSeqNo(4)));
+    QVERIFY(!window.accept(messageId(5), contentSeqNo(5)));
+
+    // Far jump ahead
+    const quint32 far = 5 + CMessageIdWindow::WindowSize * 3;
+    QVERIFY(window.accept(messageId(far), contentSeqNo(far)));
+    QVERIFY(!window.accept(messageId(far), contentSeqNo(far)));
+    QVERIFY(window.accept(messageId(far - 1), contentSeqNo(far - 1)));
+    QVERIFY(window.accept(messageId(far - CMessageIdWindow::WindowSize + 1), contentSeqNo(far - CMessageIdWindow::WindowSize + 1)));
+}
+
+void tst_CMessageIdWindow::lateMessages()
+{
+    CMessageIdWindow window;
+
+    QVERIFY(window.accept(messageId(0), contentSeqNo(0)));
+    // Message 1 is delayed
+    for (quint32 i = 2; i < 2 + CMessageIdWindow::WindowSize * 2; ++i) {
+        QVERIFY(window.accept(messageId(i), contentSeqNo(i)));
+    }
+
+    // Counter 1 is out of the bitmap, but it was not received, so it should be accepted once.
+    QVERIFY(window.accept(messageId(1), contentSeqNo(1)));
+    QVERIFY(!window.accept(messageId(1), contentSeqNo(1)));
+
+    // Received messages out of the bitmap are considered as duplicates.
+    QVERIFY(!window.accept(messageId(2), contentSeqNo(2)));
+}
+
+void tst_CMessageIdWindow::serviceMessages()
+{
+    CMessageIdWindow window;
+
+    // Containers and acks have even sequence numbers and are not tracked.
+    QVERIFY(window.accept(messageId(1), 2));
+    QVERIFY(window.accept(messageId(1), 2));
+    QVERIFY(!CMessageIdWindow::isContentRelated(2));
+    QVERIFY(CMessageIdWindow::isContentRelated(3));
+}
+
+void tst_CMessageIdWindow::sessionRestart()
+{
+    CMessageIdWindow window;
+
+    for (quint32 i = 100; i < 110; ++i) {
+        QVERIFY(window.accept(messageId(i), contentSeqNo(i)));
+    }
+
+    // The new messages of a new server session start with the low sequence numbers.
+    QVERIFY(window.accept(messageId(200), contentSeqNo(0)));
+    QVERIFY(window.accept(messageId(201), contentSeqNo(1)));
+    QVERIFY(!window.accept(messageId(201), contentSeqNo(1)));
+
+    // The counters far behind the bitmap start the window over.
+    const quint32 far = CMessageIdWindow::WindowSize * 2;
+    QVERIFY(window.accept(messageId(300), contentSeqNo(far)));
+    QVERIFY(window.accept(messageId(301), contentSeqNo(2)));
+    QVERIFY(!window.accept(messageId(301), contentSeqNo(2)));
+}
+
+void tst_CMessageIdWindow::reusedCounter()
+{
+    CMessageIdWindow window;
+
+    for (quint32 i = 10; i < 20; ++i) {
+        QVERIFY(window.accept(messageId(i), contentSeqNo(i)));
+    }
+
+    // A new message id with an already received counter is a new message.
+    QVERIFY(window.accept(messageId(30), contentSeqNo(19)));
+    QVERIFY(window.accept(messageId(31), contentSeqNo(15)));
+
+    // The duplicates match both the message id and the counter.
+    QVERIFY(!window.accept(messageId(30), contentSeqNo(19)));
+    QVERIFY(!window.accept(messageId(31), contentSeqNo(15)));
+
+    // The messages, which had the counter before, are still the duplicates.
+    QVERIFY(!window.accept(messageId(19), contentSeqNo(19)));
+    QVERIFY(!window.accept(messageId(15), contentSeqNo(15)));
+    QVERIFY(!window.accept(messageId(14), contentSeqNo(14)));
+}
+
+QTEST_MAIN(tst_CMessageIdWindow)
+
+#include "tst_CMessageIdWindow.moc"
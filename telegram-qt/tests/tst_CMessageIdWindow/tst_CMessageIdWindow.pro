@@ -0,0 +1,8 @@
+include(../tests.pri)
+
+TARGET = tst_messageidwindow
+SOURCES = tst_CMessageIdWindow.cpp \
+    ../../CMessageIdWindow.cpp
+
+HEADERS = \
+    ../../CMessageIdWindow.hpp
@@ -0,0 +1,103 @@
+/*
+   Copyright (C) 2015 Alexandr Akulich <akulichalexander@gmail.com>
+
+   This file is a part of TelegramQt library.
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+ */
+
+#include <QObject>
+
+#include "CRandomGenerator.hpp"
+#include "Utils.hpp"
+
+#include <QTest>
+#include <QDebug>
+#include <QtEndian>
+
+class tst_CRandomGenerator : public QObject
+{
+    Q_OBJECT
+public:
+    explicit tst_CRandomGenerator(QObject *parent = 0);
+
+private slots:
+    void chaCha20BlockFunction();
+    void generatorOutput();
+    void randomPadding();
+
+};
+
+tst_CRandomGenerator::tst_CRandomGenerator(QObject *parent) :
+    QObject(parent)
+{
+}
+
+void tst_CRandomGenerator::chaCha20BlockFunction()
+{
+    // Test vector from RFC 7539, section 2.3.2
+    quint32 key[8];
+    for (int i = 0; i < 8; ++i) {
+        const uchar keyBytes[4] = { uchar(i * 4), uchar(i * 4 + 1), uchar(i * 4 + 2), uchar(i * 4 + 3) };
+        key[i] = qFromLittleEndian<quint32>(keyBytes);
+    }
+
+    const quint32 nonce[3] = { 0x09000000, 0x4a000000, 0x00000000 };
+
+    QByteArray output(CRandomGenerator::BlockSize, char(0));
+    CRandomGenerator::chaCha20Block(key, 1, nonce, (uchar *) output.data());
+
+    const QByteArray expected = QByteArray::fromHex("10f1e7e4d13b5915500fdd1fa32071c4c7d1f4c733c068030422aa9ac3d46c4e"
+                                                    "d2826446079faa0914c2d705d98b02a2b5129cd1de164eb9cbd083e8a2503c4e");
+
+    QCOMPARE(output.toHex(), expected.toHex());
+}
+
+void tst_CRandomGenerator::generatorOutput()
+{
+    CRandomGenerator *generator = CRandomGenerator::instance();
+    QVERIFY(generator);
+    QCOMPARE(CRandomGenerator::instance(), generator);
+
+    // Bigger than the generator buffer to check the refill.
+    QByteArray first(CRandomGenerator::BufferSize * 3 + 5, char(0));
+    QByteArray second(first.size(), char(0));
+
+    QCOMPARE(generator->generate(first.data(), first.size()), 1);
+    QCOMPARE(generator->generate(second.data(), second.size()), 1);
+
+    QVERIFY(first != second);
+    QVERIFY(first != QByteArray(first.size(), char(0)));
+
+    quint64 firstNumber = 0;
+    quint64 secondNumber = 0;
+    Utils::randomBytes(&firstNumber);
+    Utils::randomBytes(&secondNumber);
+    QVERIFY(firstNumber != secondNumber);
+}
+
+void tst_CRandomGenerator::randomPadding()
+{
+    for (int i = 0; i < 40; ++i) {
+        QByteArray data(i, char(0x55));
+        const int paddingSize = Utils::appendRandomPadding(&data, 16);
+
+        QCOMPARE(data.size() % 16, 0);
+        QCOMPARE(data.size(), i + paddingSize);
+        QVERIFY(paddingSize < 16);
+        QCOMPARE(data.left(i), QByteArray(i, char(0x55)));
+    }
+}
+
+QTEST_MAIN(tst_CRandomGenerator)
+
+#include "tst_CRandomGenerator.moc"
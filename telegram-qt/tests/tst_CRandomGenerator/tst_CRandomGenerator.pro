@@ -0,0 +1,12 @@
+include(../tests.pri)
+
+TARGET = tst_randomgenerator
+SOURCES = tst_CRandomGenerator.cpp \
+    ../../CRandomGenerator.cpp \
+    ../../Utils.cpp
+
+HEADERS = \
+    ../../CRandomGenerator.hpp \
+    ../../Utils.hpp
+
+LIBS += -lz
@@ -22,6 +22,11 @@ CTestConnection::CTestConnection(QObject *parent) :
 {
 }
 
+CTestConnection::CTestConnection(const CAppInformation *appInfo, QObject *parent) :
+    CTelegramConnection(appInfo, parent)
+{
+}
+
 void CTestConnection::setClientNonce(TLNumber128 newClientNonce)
 {
     m_clientNonce = newClientNonce;
@@ -66,3 +71,29 @@ quint64 CTestConnection::testNewMessageId()
 {
     return newMessageId();
 }
+
+void CTestConnection::testUpdateClockOffset(quint64 serverMessageId)
+{
+    updateClockOffset(serverMessageId);
+}
+
+void CTestConnection::testKeepAliveProbeResult(bool success)
+{
+    processKeepAliveProbeResult(success);
+}
+
+int CTestConnection::rpcResultReadersCount()
+{
+    return s_rpcResultReadersCount;
+}
+
+quint32 CTestConnection::rpcResultReaderMethod(int index)
+{
+    return s_rpcResultReaders[index].method;
+}
+
+bool CTestConnection::haveRpcResultReader(quint32 method)
+{
+    const RpcResultReader *reader = rpcResultReader(TLValue(method));
+    return reader && (reader->method == method);
+}
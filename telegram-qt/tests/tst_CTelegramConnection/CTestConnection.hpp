@@ -25,8 +25,10 @@ class CTestConnection : public CTelegramConnection
     Q_OBJECT
 public:
     explicit CTestConnection(QObject *parent = 0);
+    explicit CTestConnection(const CAppInformation *appInfo, QObject *parent = 0);
 
     inline CTelegramTransport *transport() const { return m_transport; }
+    void testSetTransport(CTelegramTransport *newTransport) { setTransport(newTransport); }
 
     void setClientNonce(TLNumber128 newClientNonce);
     void setServerNonce(TLNumber128 newServerNonce);
@@ -37,7 +39,37 @@ public:
     void setB(const QByteArray &newB);
 
     SAesKey testGenerateClientToServerAesKey(const QByteArray &messageKey) const;
+    SAesKey testGenerateServerToClientAesKey(const QByteArray &messageKey) const { return generateServerToClientAesKey(messageKey); }
     quint64 testNewMessageId();
+    void testUpdateClockOffset(quint64 serverMessageId);
+    void testKeepAliveProbeResult(bool success);
+    void testProcessFutureSalts(CTelegramStream &stream) { processFutureSalts(stream); }
+    void testUpdateServerSalt() { whenItsTimeToUpdateServerSalt(); }
+
+    inline int pendingPackagesCount() const { return m_pendingPackages.count(); }
+    static PackagePriority testPackagePriority(const QByteArray &buffer) { return packagePriority(buffer); }
+
+    inline bool isSubmittedPackage(quint64 id) const { return m_submittedPackages.contains(id); }
+    inline quint64 packageMessageId(quint64 id) const { return m_packageMessageIds.value(id); }
+    TLValue testProcessRpcQuery(const QByteArray &data) { return processRpcQuery(data); }
+    bool testAcceptReceivedMessage(quint64 id, quint32 sequenceNumber) { return acceptReceivedMessage(id, sequenceNumber); }
+    static void testFloodWaitKeys(const QByteArray &buffer, quint64 *methodKey, quint64 *peerKey) { getFloodWaitKeys(buffer, methodKey, peerKey); }
+    bool testProcessFloodWait(const QString &errorMessage, quint64 id) { return processFloodWait(errorMessage, id); }
+
+    inline bool isIdleTimerActive() const { return m_idleTimer->isActive(); }
+    inline void stopIdleTimer() { m_idleTimer->stop(); }
+    void testCloseIdleConnection() { whenConnectionIsIdle(); }
+
+    inline QList<quint64> packageDependencies(quint64 id) const { return m_packageDependencies.value(id); }
+    QByteArray testInvokeAfterHeader(const QList<quint64> &dependencies) const { return invokeAfterHeader(dependencies); }
+
+    inline int requestedFilesCount() const { return m_requestedFilesIds.count(); }
+
+    QByteArray testCompressedPackage(const QByteArray &buffer) const { return compressedPackage(buffer); }
+
+    static int rpcResultReadersCount();
+    static quint32 rpcResultReaderMethod(int index);
+    static bool haveRpcResultReader(quint32 method);
 
 };
 
@@ -0,0 +1,54 @@
+/*
+   Copyright (C) 2015 Alexandr Akulich <akulichalexander@gmail.com>
+
+   This file is a part of TelegramQt library.
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+ */
+
+#ifndef CTESTTRANSPORT_HPP
+#define CTESTTRANSPORT_HPP
+
+#include "CTelegramTransport.hpp"
+
+#include <QList>
+
+// The transport connects immediately, keeps the sent packages and delivers the given ones.
+class CTestTransport : public CTelegramTransport
+{
+    Q_OBJECT
+public:
+    explicit CTestTransport(QObject *parent = 0) : CTelegramTransport(parent) { }
+
+    void connectToHost(const QString &ipAddress, quint32 port) { Q_UNUSED(ipAddress); Q_UNUSED(port); setState(QAbstractSocket::ConnectedState); }
+    void disconnectFromHost() { setState(QAbstractSocket::UnconnectedState); }
+
+    bool isConnected() const { return state() == QAbstractSocket::ConnectedState; }
+
+    QByteArray getPackage() { return m_receivedPackage; }
+
+    void receivePackage(const QByteArray &package) { m_receivedPackage = package; emit readyRead(); }
+
+    QByteArray lastPackage() const { return m_packages.isEmpty() ? QByteArray() : m_packages.last(); }
+
+    QList<QByteArray> takePackages() { const QList<QByteArray> packages = m_packages; m_packages.clear(); return packages; }
+
+public slots:
+    void sendPackage(const QByteArray &package) { m_packages.append(package); }
+
+private:
+    QList<QByteArray> m_packages;
+    QByteArray m_receivedPackage;
+
+};
+
+#endif // CTESTTRANSPORT_HPP
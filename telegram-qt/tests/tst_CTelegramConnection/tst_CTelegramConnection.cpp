@@ -18,9 +18,15 @@
 #include <QObject>
 
 #include "CTestConnection.hpp"
+#include "CTestTransport.hpp"
+#include "CAppInformation.hpp"
+#include "CConnectionScheduler.hpp"
+#include "CTelegramStream.hpp"
 #include "CTelegramTransport.hpp"
+#include "Utils.hpp"
 
 #include <QTest>
+#include <QSignalSpy>
 #include <QDebug>
 
 #include <QDateTime>
@@ -36,6 +42,23 @@ private slots:
     void testNewMessageId();
     void testClientTimestampNeverOdd();
     void testTimestampConversion();
+    void testClockOffsetEstimation();
+    void testServerSaltsSchedule();
+    void testRpcResultReadersTable();
+    void testReconnectionDelay();
+    void testConnectionScheduler();
+    void testKeepAliveAdaptation();
+    void testPendingPackages();
+    void testFloodWait();
+    void testInvokeAfter();
+    void testSendAgainAfterReconnect();
+    void testRpcResultSignals();
+    void testIdleConnection();
+    void testSessionStateRestoration();
+    void testReceiveBrokenPackage();
+    void testCancelFileRequest();
+    void testRequestCompression();
+    void testAesDecrypt();
     void testPQAuthRequest();
     void testAuth();
     void testAesKeyGeneration();
@@ -110,6 +133,859 @@ void tst_CTelegramConnection::testTimestampConversion()
     QCOMPARE(CTelegramConnection::timeStampToMSecsSinceEpoch(ts), time);
 }
 
+void tst_CTelegramConnection::testClockOffsetEstimation()
+{
+    CTestConnection connection;
+    connection.setDeltaTime(-3600); // Restored value is outdated
+
+    const qint64 serverAhead = 5000;
+    connection.testUpdateClockOffset(CTelegramConnection::formatTimeStamp(QDateTime::currentMSecsSinceEpoch() + serverAhead) | 1);
+
+    // The first sample should be applied as is, so the message id is right from the first request.
+    QVERIFY(qAbs(connection.clockOffset() - serverAhead) < 100);
+
+    const quint64 messageTime = CTelegramConnection::timeStampToMSecsSinceEpoch(connection.testNewMessageId());
+    QVERIFY(qAbs(qint64(messageTime) - QDateTime::currentMSecsSinceEpoch() - serverAhead) < 100);
+
+    // A delayed message should not throw the estimation back.
+    connection.testUpdateClockOffset(CTelegramConnection::formatTimeStamp(QDateTime::currentMSecsSinceEpoch() - 10000) | 1);
+    QVERIFY(connection.clockOffset() > serverAhead - 1500);
+    QVERIFY(connection.clockOffset() < serverAhead);
+
+    QCOMPARE(connection.deltaTime(), qint32(connection.clockOffset() / 1000));
+}
+
+inline TLFutureSalt constructFutureSalt(quint32 validSince, quint32 validUntil, quint64 salt)
+{
+    TLFutureSalt result;
+    result.validSince = validSince;
+    result.validUntil = validUntil;
+    result.salt = salt;
+    return result;
+}
+
+void tst_CTelegramConnection::testServerSaltsSchedule()
+{
+    CTestConnection connection;
+    connection.setServerSalt(1);
+
+    const quint32 now = QDateTime::currentMSecsSinceEpoch() / 1000;
+
+    TLVector<TLFutureSalt> salts;
+    salts << constructFutureSalt(now - 3600, now + 30, 2); // Expires within the switch margin
+    salts << constructFutureSalt(now - 60, now + 1800, 3);
+    salts << constructFutureSalt(now + 1740, now + 3600, 4);
+
+    QByteArray data;
+    CTelegramStream output(&data, /* write */ true);
+    output << quint64(0); // Request id
+    output << now;
+    output << quint32(salts.count()); // Bare vector
+
+    foreach (const TLFutureSalt &salt, salts) {
+        output << salt;
+    }
+
+    // The expired salt is dropped and the actual one is used
+    CTelegramStream input(data);
+    connection.testProcessFutureSalts(input);
+    QCOMPARE(connection.serverSalt(), quint64(3));
+    QCOMPARE(connection.serverSalts().count(), 2);
+
+    // Nothing to change yet
+    connection.testUpdateServerSalt();
+    QCOMPARE(connection.serverSalt(), quint64(3));
+    QCOMPARE(connection.serverSalts().count(), 2);
+
+    // The next salt is used a minute before the current one expires
+    connection.setDeltaTime(1740);
+    connection.testUpdateServerSalt();
+    QCOMPARE(connection.serverSalt(), quint64(4));
+    QCOMPARE(connection.serverSalts().count(), 1);
+
+    // The schedule is over, the last known salt is kept
+    connection.setDeltaTime(3600);
+    connection.testUpdateServerSalt();
+    QCOMPARE(connection.serverSalt(), quint64(4));
+    QVERIFY(connection.serverSalts().isEmpty());
+
+    // Broken answers do not change the schedule
+    connection.setDeltaTime(0);
+    connection.setServerSalts(salts);
+
+    CTelegramStream truncatedInput(data.left(data.size() - 4));
+    connection.testProcessFutureSalts(truncatedInput);
+    QCOMPARE(connection.serverSalts().count(), 3);
+
+    QByteArray tooManySaltsData;
+    CTelegramStream tooManySaltsOutput(&tooManySaltsData, /* write */ true);
+    tooManySaltsOutput << quint64(0);
+    tooManySaltsOutput << now;
+    tooManySaltsOutput << quint32(0x10000000);
+
+    CTelegramStream tooManySaltsInput(tooManySaltsData);
+    connection.testProcessFutureSalts(tooManySaltsInput);
+    QCOMPARE(connection.serverSalts().count(), 3);
+    QCOMPARE(connection.serverSalt(), quint64(4));
+}
+
+void tst_CTelegramConnection::testRpcResultReadersTable()
+{
+    QVERIFY(CTestConnection::rpcResultReadersCount() > 0);
+
+    // The table is looked up with the binary search, so it have to be sorted and free of duplicates.
+    for (int i = 1; i < CTestConnection::rpcResultReadersCount(); ++i) {
+        QVERIFY(CTestConnection::rpcResultReaderMethod(i - 1) < CTestConnection::rpcResultReaderMethod(i));
+    }
+
+    for (int i = 0; i < CTestConnection::rpcResultReadersCount(); ++i) {
+        QVERIFY(CTestConnection::haveRpcResultReader(CTestConnection::rpcResultReaderMethod(i)));
+    }
+
+    QVERIFY(CTestConnection::haveRpcResultReader(TLValue::HelpGetConfig));
+    QVERIFY(CTestConnection::haveRpcResultReader(TLValue::AuthSignIn));
+    QVERIFY(CTestConnection::haveRpcResultReader(TLValue::UploadSaveBigFilePart));
+    QVERIFY(CTestConnection::haveRpcResultReader(TLValue::MessagesGetDialogs));
+    QVERIFY(!CTestConnection::haveRpcResultReader(TLValue::Ping));
+    QVERIFY(!CTestConnection::haveRpcResultReader(TLValue::InvokeWithLayer));
+}
+
+void tst_CTelegramConnection::testReconnectionDelay()
+{
+    quint32 delay = CConnectionScheduler::nextReconnectionDelay(0);
+    QVERIFY(delay <= CConnectionScheduler::BaseReconnectionDelay);
+
+    for (int i = 0; i < 100; ++i) {
+        const quint32 previousDelay = delay;
+        delay = CConnectionScheduler::nextReconnectionDelay(previousDelay);
+
+        QVERIFY(delay >= CConnectionScheduler::BaseReconnectionDelay);
+        QVERIFY(delay <= CConnectionScheduler::MaximumReconnectionDelay);
+        QVERIFY(delay <= qMax<quint32>(CConnectionScheduler::BaseReconnectionDelay, previousDelay * 3));
+    }
+}
+
+void tst_CTelegramConnection::testConnectionScheduler()
+{
+    CConnectionScheduler *scheduler = CConnectionScheduler::instance();
+    const int maximumAttempts = scheduler->maximumAttempts();
+    scheduler->setMaximumAttempts(2);
+
+    CTestConnection connection1;
+    CTestConnection connection2;
+    CTestConnection connection3;
+
+    QVERIFY(scheduler->acquire(&connection1));
+    QVERIFY(scheduler->acquire(&connection2));
+    QVERIFY(!scheduler->acquire(&connection3));
+    QVERIFY(!scheduler->acquire(&connection3)); // Queued only once
+    QCOMPARE(scheduler->activeAttempts(), 2);
+    QCOMPARE(scheduler->pendingAttempts(), 1);
+
+    // The slot of the finished attempt goes to the queued connection
+    scheduler->release(&connection1);
+    QCOMPARE(scheduler->activeAttempts(), 2);
+    QCOMPARE(scheduler->pendingAttempts(), 0);
+    QVERIFY(scheduler->acquire(&connection3));
+    QVERIFY(!scheduler->acquire(&connection1));
+
+    scheduler->release(&connection1);
+    scheduler->release(&connection2);
+    scheduler->release(&connection3);
+    QCOMPARE(scheduler->activeAttempts(), 0);
+    QCOMPARE(scheduler->pendingAttempts(), 0);
+
+    scheduler->setMaximumAttempts(maximumAttempts);
+}
+
+void tst_CTelegramConnection::testKeepAliveAdaptation()
+{
+    CTestConnection connection;
+    connection.setKeepAliveSettings(15000, 500);
+    QCOMPARE(connection.keepAliveInterval(), quint32(15000));
+
+    // The interval is not changed until a few probes succeed.
+    connection.testKeepAliveProbeResult(true);
+    connection.testKeepAliveProbeResult(true);
+    QCOMPARE(connection.keepAliveInterval(), quint32(15000));
+    connection.testKeepAliveProbeResult(true);
+    QCOMPARE(connection.keepAliveInterval(), quint32(22500));
+
+    for (int i = 0; i < 3; ++i) {
+        connection.testKeepAliveProbeResult(true);
+    }
+    QCOMPARE(connection.keepAliveInterval(), quint32(33750));
+
+    // The dropped probe returns to the last good interval, which becomes the limit.
+    connection.testKeepAliveProbeResult(false);
+    QCOMPARE(connection.keepAliveInterval(), quint32(22500));
+
+    for (int i = 0; i < 6; ++i) {
+        connection.testKeepAliveProbeResult(true);
+    }
+    QCOMPARE(connection.keepAliveInterval(), quint32(22500));
+
+    // A drop with the good interval backs off, but never below the configured one.
+    connection.testKeepAliveProbeResult(false);
+    QCOMPARE(connection.keepAliveInterval(), quint32(15000));
+    connection.testKeepAliveProbeResult(false);
+    QCOMPARE(connection.keepAliveInterval(), quint32(15000));
+
+    // New settings reset the adaptation.
+    connection.setKeepAliveSettings(10000, 500);
+    QCOMPARE(connection.keepAliveInterval(), quint32(10000));
+}
+
+void tst_CTelegramConnection::testPendingPackages()
+{
+    CTestConnection connection;
+
+    // The connection is not established, so the requests are queued instead of the write into the socket.
+    const quint64 pingId = connection.ping();
+    const quint64 fileRequestId = connection.uploadGetFile(TLInputFileLocation(), 0, 1024);
+
+    QVERIFY(pingId);
+    QVERIFY(fileRequestId > pingId);
+    QCOMPARE(connection.pendingPackagesCount(), 2);
+    QVERIFY(connection.transport()->lastPackage().isEmpty());
+
+    // Acks make no sense for the next connection
+    QCOMPARE(connection.acknowledgeMessages(TLVector<quint64>() << pingId), quint64(0));
+    QCOMPARE(connection.pendingPackagesCount(), 2);
+
+    QByteArray getFileRequest;
+    CTelegramStream getFileStream(&getFileRequest, /* write */ true);
+    getFileStream << TLValue::UploadGetFile;
+
+    QByteArray getStateRequest;
+    CTelegramStream getStateStream(&getStateRequest, /* write */ true);
+    getStateStream << TLValue::UpdatesGetState;
+
+    QByteArray sendMessageRequest;
+    CTelegramStream sendMessageStream(&sendMessageRequest, /* write */ true);
+    sendMessageStream << TLValue::MessagesSendMessage;
+
+    QCOMPARE(CTestConnection::testPackagePriority(getStateRequest), CTelegramConnection::PackagePriorityHigh);
+    QCOMPARE(CTestConnection::testPackagePriority(sendMessageRequest), CTelegramConnection::PackagePriorityNormal);
+    QCOMPARE(CTestConnection::testPackagePriority(getFileRequest), CTelegramConnection::PackagePriorityLow);
+}
+
+void tst_CTelegramConnection::testFloodWait()
+{
+    CTestConnection connection;
+
+    TLInputPeer peer;
+    peer.tlType = TLValue::InputPeerContact;
+    peer.userId = 1234;
+
+    const QString message = QLatin1String("Hello");
+
+    QByteArray sendMessageRequest;
+    CTelegramStream sendMessageStream(&sendMessageRequest, /* write */ true);
+    sendMessageStream << TLValue::MessagesSendMessage;
+    sendMessageStream << quint32(0);
+    sendMessageStream << peer;
+    sendMessageStream << quint32(0);
+    sendMessageStream << message;
+    sendMessageStream << quint64(1);
+
+    QByteArray getHistoryRequest;
+    CTelegramStream getHistoryStream(&getHistoryRequest, /* write */ true);
+    getHistoryStream << TLValue::MessagesGetHistory;
+    getHistoryStream << peer;
+
+    QByteArray getStateRequest;
+    CTelegramStream getStateStream(&getStateRequest, /* write */ true);
+    getStateStream << TLValue::UpdatesGetState;
+
+    quint64 methodKey;
+    quint64 peerKey;
+
+    // The peer is found after the flags as well as the first argument.
+    CTestConnection::testFloodWaitKeys(sendMessageRequest, &methodKey, &peerKey);
+    QCOMPARE(methodKey, CFloodWaitLimiter::methodKey(TLValue::MessagesSendMessage));
+    QCOMPARE(peerKey, CFloodWaitLimiter::peerKey(TLValue::MessagesSendMessage, TLValue::InputPeerContact, 1234));
+
+    CTestConnection::testFloodWaitKeys(getHistoryRequest, &methodKey, &peerKey);
+    QCOMPARE(peerKey, CFloodWaitLimiter::peerKey(TLValue::MessagesGetHistory, TLValue::InputPeerContact, 1234));
+
+    CTestConnection::testFloodWaitKeys(getStateRequest, &methodKey, &peerKey);
+    QCOMPARE(methodKey, CFloodWaitLimiter::methodKey(TLValue::UpdatesGetState));
+    QCOMPARE(peerKey, quint64(0));
+
+    const quint64 sendMessageId = connection.messagesSendMessage(0, peer, 0, message, 1);
+    const quint64 getFileId = connection.uploadGetFile(TLInputFileLocation(), 0, 1024);
+    QCOMPARE(connection.pendingPackagesCount(), 2);
+
+    QSignalSpy floodWaitSpy(&connection, SIGNAL(floodWaitReceived(quint64,quint32,quint32,bool)));
+
+    QVERIFY(!connection.testProcessFloodWait(QLatin1String("FLOOD_WAIT_"), sendMessageId));
+    QCOMPARE(connection.delayedPackagesCount(), 0);
+
+    // The request is kept and delayed.
+    QVERIFY(connection.testProcessFloodWait(QLatin1String("FLOOD_WAIT_30"), sendMessageId));
+    QVERIFY(connection.isSubmittedPackage(sendMessageId));
+    QCOMPARE(connection.delayedPackagesCount(), 1);
+    QCOMPARE(connection.pendingPackagesCount(), 1);
+    QVERIFY(connection.floodWaitTime() > 29000);
+    QVERIFY(connection.floodWaitTime() <= 30000);
+
+    QCOMPARE(floodWaitSpy.count(), 1);
+    QCOMPARE(floodWaitSpy.at(0).at(0).toULongLong(), sendMessageId);
+    QCOMPARE(floodWaitSpy.at(0).at(1).toUInt(), quint32(TLValue::MessagesSendMessage));
+    QCOMPARE(floodWaitSpy.at(0).at(2).toUInt(), quint32(30));
+    QCOMPARE(floodWaitSpy.at(0).at(3).toBool(), false);
+
+    // Too long wait drops the request.
+    QVERIFY(connection.testProcessFloodWait(QLatin1String("FLOOD_WAIT_86400"), getFileId));
+    QVERIFY(!connection.isSubmittedPackage(getFileId));
+    QCOMPARE(connection.delayedPackagesCount(), 1);
+    QCOMPARE(connection.pendingPackagesCount(), 0);
+    QVERIFY(connection.floodWaitTime() > 86000 * 1000);
+
+    // The drop is reported for the request.
+    QCOMPARE(floodWaitSpy.count(), 2);
+    QCOMPARE(floodWaitSpy.at(1).at(0).toULongLong(), getFileId);
+    QCOMPARE(floodWaitSpy.at(1).at(1).toUInt(), quint32(TLValue::UploadGetFile));
+    QCOMPARE(floodWaitSpy.at(1).at(3).toBool(), true);
+
+    // A dropped message is reported with its random id, so the caller can send it again.
+    qRegisterMetaType<TLInputPeer>("TLInputPeer");
+    QSignalSpy sendingFailedSpy(&connection, SIGNAL(messageSendingFailed(TLInputPeer,quint64)));
+
+    QVERIFY(connection.testProcessFloodWait(QLatin1String("FLOOD_WAIT_86400"), sendMessageId));
+    QVERIFY(!connection.isSubmittedPackage(sendMessageId));
+    QCOMPARE(connection.delayedPackagesCount(), 0);
+
+    QCOMPARE(floodWaitSpy.count(), 3);
+    QCOMPARE(floodWaitSpy.at(2).at(0).toULongLong(), sendMessageId);
+    QCOMPARE(floodWaitSpy.at(2).at(3).toBool(), true);
+
+    QCOMPARE(sendingFailedSpy.count(), 1);
+    QCOMPARE(sendingFailedSpy.at(0).at(0).value<TLInputPeer>().userId, quint32(1234));
+    QCOMPARE(sendingFailedSpy.at(0).at(1).toULongLong(), quint64(1));
+}
+
+static CTestTransport *setUpSignedConnection(CTestConnection *connection)
+{
+    // The auth key is known, so the connection is signed in as soon as the transport is connected.
+    CTestTransport *transport = new CTestTransport(connection);
+    connection->testSetTransport(transport);
+    connection->setAuthKey(QByteArray(256, char(0x11)));
+
+    // The salts schedule is long enough to not request the future salts among the tested requests.
+    const quint32 now = QDateTime::currentMSecsSinceEpoch() / 1000;
+
+    TLVector<TLFutureSalt> salts;
+    for (quint32 i = 0; i < 8; ++i) {
+        salts << constructFutureSalt(now - 60 + i * 1800, now + (i + 1) * 1800, i + 1);
+    }
+
+    connection->setServerSalts(salts);
+
+    return transport;
+}
+
+static QMap<quint64, QByteArray> sentMessages(const CTestConnection &connection, CTestTransport *transport)
+{
+    // Message id to the message body; the container items are taken as separate messages.
+    QMap<quint64, QByteArray> messages;
+
+    foreach (const QByteArray &package, transport->takePackages()) {
+        const SAesKey key = connection.testGenerateClientToServerAesKey(package.mid(8, 16));
+        const QByteArray data = Utils::aesDecrypt(package.mid(24), key);
+
+        CTelegramStream stream(data);
+        quint64 salt;
+        quint64 sessionId;
+        quint64 messageId;
+        quint32 sequenceNumber;
+        quint32 length;
+
+        stream >> salt;
+        stream >> sessionId;
+        stream >> messageId;
+        stream >> sequenceNumber;
+        stream >> length;
+
+        const QByteArray body = data.mid(32, length);
+
+        if (TLValue::firstFromArray(body) != TLValue::MsgContainer) {
+            messages.insert(messageId, body);
+            continue;
+        }
+
+        CTelegramStream containerStream(body);
+        TLValue container;
+        quint32 count;
+
+        containerStream >> container;
+        containerStream >> count;
+
+        for (quint32 i = 0; i < count; ++i) {
+            containerStream >> messageId;
+            containerStream >> sequenceNumber;
+            containerStream >> length;
+            messages.insert(messageId, containerStream.readBytes(length));
+        }
+    }
+
+    return messages;
+}
+
+static QByteArray rpcResult(quint64 messageId, TLValue::Value result)
+{
+    QByteArray data;
+    CTelegramStream stream(&data, /* write */ true);
+    stream << TLValue::RpcResult;
+    stream << messageId;
+    stream << result;
+
+    return data;
+}
+
+static QByteArray serverPackage(const CTestConnection &connection, quint64 messageId, quint32 sequenceNumber,
+                                const QByteArray &body, quint32 contentLength)
+{
+    // The content length is given separately to write a broken one.
+    QByteArray data;
+    CTelegramStream stream(&data, /* write */ true);
+    stream << connection.serverSalt();
+    stream << connection.sessionId();
+    stream << messageId;
+    stream << sequenceNumber;
+    stream << contentLength;
+    data.append(body);
+
+    const QByteArray messageKey = Utils::sha1(data).mid(4);
+    data.append(QByteArray((16 - data.size() % 16) % 16, char(0)));
+
+    QByteArray package;
+    CTelegramStream packageStream(&package, /* write */ true);
+    packageStream << connection.authId();
+    package.append(messageKey);
+    package.append(Utils::aesEncrypt(data, connection.testGenerateServerToClientAesKey(messageKey)));
+
+    return package;
+}
+
+void tst_CTelegramConnection::testInvokeAfter()
+{
+    CAppInformation appInfo;
+    CTestConnection connection(&appInfo);
+    CTestTransport *transport = setUpSignedConnection(&connection);
+
+    const quint64 usersId = connection.usersGetUsers(TLVector<TLInputUser>());
+    const quint64 contactsId = connection.contactsGetContacts(QString());
+
+    // The answered (or unknown) requests are not waited for.
+    connection.invokeNextRequestAfter(QList<quint64>() << usersId << 12345);
+    const quint64 stateId = connection.updatesGetState();
+    QCOMPARE(connection.packageDependencies(stateId), QList<quint64>() << usersId);
+
+    // The dependencies are applied to the next request only.
+    const quint64 pingId = connection.ping();
+    QVERIFY(connection.packageDependencies(pingId).isEmpty());
+
+    // The requests are not sent yet, so the server has nothing to wait for.
+    QVERIFY(connection.testInvokeAfterHeader(connection.packageDependencies(stateId)).isEmpty());
+
+    connection.connectToDc();
+    QCOMPARE(connection.pendingPackagesCount(), 0);
+
+    // The server knows the requests by the ids of the messages they are sent in.
+    const quint64 usersMessageId = connection.packageMessageId(usersId);
+    const quint64 contactsMessageId = connection.packageMessageId(contactsId);
+    QVERIFY(usersMessageId);
+    QVERIFY(contactsMessageId);
+
+    QByteArray expectedHeader;
+    CTelegramStream expectedStream(&expectedHeader, /* write */ true);
+    expectedStream << TLValue::InvokeAfterMsg;
+    expectedStream << usersMessageId;
+
+    QCOMPARE(connection.testInvokeAfterHeader(connection.packageDependencies(stateId)), expectedHeader);
+
+    const QMap<quint64, QByteArray> messages = sentMessages(connection, transport);
+    QCOMPARE(messages.count(), 4);
+    QVERIFY(messages.value(connection.packageMessageId(stateId)).startsWith(expectedHeader));
+
+    TLVector<quint64> ids;
+    ids << usersMessageId << contactsMessageId;
+
+    QByteArray expectedVectorHeader;
+    CTelegramStream expectedVectorStream(&expectedVectorHeader, /* write */ true);
+    expectedVectorStream << TLValue::InvokeAfterMsgs;
+    expectedVectorStream << ids;
+
+    QCOMPARE(connection.testInvokeAfterHeader(QList<quint64>() << usersId << contactsId << 12345), expectedVectorHeader);
+    QVERIFY(connection.testInvokeAfterHeader(QList<quint64>() << 12345).isEmpty());
+}
+
+void tst_CTelegramConnection::testSendAgainAfterReconnect()
+{
+    CAppInformation appInfo;
+    CTestConnection connection(&appInfo);
+    CTestTransport *transport = setUpSignedConnection(&connection);
+
+    // The request is queued and keeps its id after the send.
+    const quint64 firstId = connection.accountUpdateStatus(false);
+    QCOMPARE(connection.pendingPackagesCount(), 1);
+
+    connection.connectToDc();
+    QCOMPARE(connection.status(), CTelegramConnection::ConnectionStatusConnected);
+    QCOMPARE(connection.pendingPackagesCount(), 0);
+    QVERIFY(connection.isSubmittedPackage(firstId));
+
+    const quint64 firstMessageId = connection.packageMessageId(firstId);
+    QVERIFY(firstMessageId > firstId);
+
+    QMap<quint64, QByteArray> messages = sentMessages(connection, transport);
+    QCOMPARE(messages.keys(), QList<quint64>() << firstMessageId);
+    const QByteArray firstMessage = messages.value(firstMessageId);
+
+    // The connection is lost before the answer.
+    transport->disconnectFromHost();
+    QCOMPARE(connection.status(), CTelegramConnection::ConnectionStatusDisconnected);
+
+    const quint64 secondId = connection.accountUpdateStatus(true);
+    QCOMPARE(connection.pendingPackagesCount(), 1);
+    QCOMPARE(connection.packageMessageId(secondId), quint64(0));
+
+    // The sent request goes again in the same message (so the server does not process it twice), the queued one follows.
+    connection.connectToDc();
+    QCOMPARE(connection.packageMessageId(firstId), firstMessageId);
+
+    const quint64 secondMessageId = connection.packageMessageId(secondId);
+    QVERIFY(secondMessageId > firstMessageId);
+
+    messages = sentMessages(connection, transport);
+    QCOMPARE(messages.keys(), QList<quint64>() << firstMessageId << secondMessageId);
+    QCOMPARE(messages.value(firstMessageId), firstMessage);
+
+    // The message is ignored by the server, so the request is sent in a new one.
+    QByteArray badMessage;
+    CTelegramStream badMessageStream(&badMessage, /* write */ true);
+    badMessageStream << TLValue::BadServerSalt;
+    badMessageStream << secondMessageId;
+    badMessageStream << quint32(3);
+    badMessageStream << quint32(48); // Incorrect server salt
+    badMessageStream << quint64(5);
+
+    connection.testProcessRpcQuery(badMessage);
+    const quint64 newSecondMessageId = connection.packageMessageId(secondId);
+    QVERIFY(newSecondMessageId > secondMessageId);
+    QVERIFY(sentMessages(connection, transport).contains(newSecondMessageId)); // Along with the future salts request
+
+    // The answers are matched by the message ids, the callers get the request ids.
+    connection.testProcessRpcQuery(rpcResult(firstMessageId, TLValue::BoolTrue));
+    QVERIFY(!connection.isSubmittedPackage(firstId));
+    QCOMPARE(connection.packageMessageId(firstId), quint64(0));
+
+    // The ignored message has no answer.
+    connection.testProcessRpcQuery(rpcResult(secondMessageId, TLValue::BoolTrue));
+    QVERIFY(connection.isSubmittedPackage(secondId));
+
+    connection.testProcessRpcQuery(rpcResult(newSecondMessageId, TLValue::BoolTrue));
+    QVERIFY(!connection.isSubmittedPackage(secondId));
+
+    // The answered requests are not sent again.
+    transport->disconnectFromHost();
+    connection.connectToDc();
+
+    messages = sentMessages(connection, transport);
+    QVERIFY(!messages.contains(firstMessageId));
+    QVERIFY(!messages.contains(secondMessageId));
+    QVERIFY(!messages.contains(newSecondMessageId));
+}
+
+void tst_CTelegramConnection::testRpcResultSignals()
+{
+    CAppInformation appInfo;
+    CTestConnection connection(&appInfo);
+    setUpSignedConnection(&connection);
+
+    const quint64 deleteAccountId = connection.accountDeleteAccount(QLatin1String("Test"));
+    connection.connectToDc();
+
+    QSignalSpy resultSpy(&connection, SIGNAL(accountDeleteAccountResultReceived(quint64,bool)));
+
+    // The result of a method without the hand-written handler is read by the generated reader and emitted with the request id.
+    connection.testProcessRpcQuery(rpcResult(connection.packageMessageId(deleteAccountId), TLValue::BoolFalse));
+    QVERIFY(!connection.isSubmittedPackage(deleteAccountId));
+
+    QCOMPARE(resultSpy.count(), 1);
+    QCOMPARE(resultSpy.at(0).at(0).toULongLong(), deleteAccountId);
+    QCOMPARE(resultSpy.at(0).at(1).toBool(), false);
+
+    // The object results are passed in the shared handles.
+    const quint64 accountTtlId = connection.accountGetAccountTTL();
+
+    QByteArray accountTtlResult;
+    CTelegramStream accountTtlStream(&accountTtlResult, /* write */ true);
+    accountTtlStream << TLValue::RpcResult;
+    accountTtlStream << connection.packageMessageId(accountTtlId);
+    accountTtlStream << TLValue::AccountDaysTTL;
+    accountTtlStream << quint32(180);
+
+    QSignalSpy sharedResultSpy(&connection, SIGNAL(accountGetAccountTTLResultReceived(quint64,TLShared<TLAccountDaysTTL>)));
+
+    connection.testProcessRpcQuery(accountTtlResult);
+    QVERIFY(!connection.isSubmittedPackage(accountTtlId));
+
+    QCOMPARE(sharedResultSpy.count(), 1);
+    QCOMPARE(sharedResultSpy.at(0).at(0).toULongLong(), accountTtlId);
+
+    const TLShared<TLAccountDaysTTL> accountTtl = sharedResultSpy.at(0).at(1).value<TLShared<TLAccountDaysTTL> >();
+    QCOMPARE(accountTtl->days, quint32(180));
+}
+
+void tst_CTelegramConnection::testIdleConnection()
+{
+    CAppInformation appInfo;
+    CTestConnection connection(&appInfo);
+    CTestTransport *transport = setUpSignedConnection(&connection);
+
+    connection.setIdleTimeout(60000);
+    connection.connectToDc();
+    QVERIFY(connection.isIdleTimerActive());
+
+    // The keep-alive traffic does not keep the connection open.
+    connection.stopIdleTimer();
+    const quint64 pingId = connection.ping();
+    QVERIFY(connection.isSubmittedPackage(pingId));
+    QVERIFY(!connection.isIdleTimerActive());
+
+    // The requests and their results do.
+    const quint64 statusId = connection.accountUpdateStatus(false);
+    QVERIFY(connection.isIdleTimerActive());
+
+    connection.stopIdleTimer();
+    connection.testProcessRpcQuery(rpcResult(connection.packageMessageId(statusId), TLValue::BoolTrue));
+    QVERIFY(!connection.isSubmittedPackage(statusId));
+    QVERIFY(connection.isIdleTimerActive());
+
+    // The unanswered requests are kept over the idle close and sent again in the same messages.
+    const quint64 unansweredId = connection.accountUpdateStatus(true);
+    const quint64 unansweredMessageId = connection.packageMessageId(unansweredId);
+    sentMessages(connection, transport);
+
+    connection.testCloseIdleConnection();
+    QCOMPARE(connection.status(), CTelegramConnection::ConnectionStatusDisconnected);
+    QVERIFY(connection.isSubmittedPackage(unansweredId));
+    QVERIFY(!connection.isSubmittedPackage(pingId));
+
+    connection.connectToDc();
+    QCOMPARE(connection.packageMessageId(unansweredId), unansweredMessageId);
+    QVERIFY(sentMessages(connection, transport).contains(unansweredMessageId));
+}
+
+void tst_CTelegramConnection::testSessionStateRestoration()
+{
+    CAppInformation appInfo;
+    CTestConnection connection(&appInfo);
+    CTestTransport *transport = setUpSignedConnection(&connection);
+
+    const quint64 sentId = connection.accountUpdateStatus(false);
+    connection.connectToDc();
+
+    const quint64 sentMessageId = connection.packageMessageId(sentId);
+    QVERIFY(sentMessageId);
+
+    const QByteArray sentMessage = sentMessages(connection, transport).value(sentMessageId);
+    QVERIFY(!sentMessage.isEmpty());
+
+    // The received message is not acknowledged yet.
+    const quint64 serverMessageId = connection.testNewMessageId() | 1;
+    QVERIFY(connection.testAcceptReceivedMessage(serverMessageId, 3));
+
+    transport->disconnectFromHost();
+    const quint64 queuedId = connection.accountUpdateStatus(true);
+
+    const QByteArray state = connection.sessionState();
+    QVERIFY(!state.isEmpty());
+
+    CTestConnection restoredConnection(&appInfo);
+    CTestTransport *restoredTransport = setUpSignedConnection(&restoredConnection);
+    QVERIFY(restoredConnection.restoreSessionState(state));
+    QCOMPARE(restoredConnection.sessionState(), state);
+
+    // The sent request keeps its message, the queued one is still pending.
+    QCOMPARE(restoredConnection.packageMessageId(sentId), sentMessageId);
+    QCOMPARE(restoredConnection.packageMessageId(queuedId), quint64(0));
+    QCOMPARE(restoredConnection.pendingPackagesCount(), 1);
+
+    // The server resends the unacknowledged message, so it is a duplicate.
+    QVERIFY(!restoredConnection.testAcceptReceivedMessage(serverMessageId, 3));
+    QVERIFY(restoredConnection.testAcceptReceivedMessage(serverMessageId + 4, 5));
+
+    restoredConnection.connectToDc();
+    QCOMPARE(restoredConnection.pendingPackagesCount(), 0);
+
+    const quint64 queuedMessageId = restoredConnection.packageMessageId(queuedId);
+    QVERIFY(queuedMessageId > sentMessageId);
+
+    const QMap<quint64, QByteArray> messages = sentMessages(restoredConnection, restoredTransport);
+    QCOMPARE(messages.value(sentMessageId), sentMessage);
+    QVERIFY(messages.contains(queuedMessageId));
+
+    // The result for the message, sent before the restoration, is matched to the request.
+    restoredConnection.testProcessRpcQuery(rpcResult(sentMessageId, TLValue::BoolTrue));
+    QVERIFY(!restoredConnection.isSubmittedPackage(sentId));
+    QVERIFY(restoredConnection.isSubmittedPackage(queuedId));
+
+    restoredConnection.testProcessRpcQuery(rpcResult(queuedMessageId, TLValue::BoolTrue));
+    QVERIFY(!restoredConnection.isSubmittedPackage(queuedId));
+
+    // Invalid data is rejected.
+    QVERIFY(!restoredConnection.restoreSessionState(state.left(state.size() / 2)));
+}
+
+void tst_CTelegramConnection::testReceiveBrokenPackage()
+{
+    CAppInformation appInfo;
+    CTestConnection connection(&appInfo);
+    CTestTransport *transport = setUpSignedConnection(&connection);
+
+    // The received packages are checked against the auth id of the key.
+    connection.CTelegramConnection::setAuthKey(QByteArray(256, char(0x11)));
+
+    const quint64 requestId = connection.accountUpdateStatus(false);
+    connection.connectToDc();
+
+    const QByteArray result = rpcResult(connection.packageMessageId(requestId), TLValue::BoolTrue);
+    const quint64 serverMessageId = connection.testNewMessageId() | 1;
+
+    // The content length is garbage, so it must not be used for the message key check.
+    transport->receivePackage(serverPackage(connection, serverMessageId, 1, result, 0xffffff00));
+    QVERIFY(connection.isSubmittedPackage(requestId));
+
+    transport->receivePackage(serverPackage(connection, serverMessageId, 1, result, result.size() + 64));
+    QVERIFY(connection.isSubmittedPackage(requestId));
+
+    // The encrypted data is shorter than the message header.
+    QByteArray shortPackage;
+    CTelegramStream shortPackageStream(&shortPackage, /* write */ true);
+    shortPackageStream << connection.authId();
+    shortPackage.append(QByteArray(32, char(0x55)));
+
+    transport->receivePackage(shortPackage);
+    QVERIFY(connection.isSubmittedPackage(requestId));
+    QCOMPARE(connection.status(), CTelegramConnection::ConnectionStatusConnected);
+
+    // The connection still processes the valid packages.
+    transport->receivePackage(serverPackage(connection, serverMessageId, 1, result, result.size()));
+    QVERIFY(!connection.isSubmittedPackage(requestId));
+}
+
+void tst_CTelegramConnection::testCancelFileRequest()
+{
+    CTestConnection connection;
+
+    connection.downloadFile(TLInputFileLocation(), 0, 1024, /* requestId */ 1);
+    connection.uploadFile(/* fileId */ 10, /* filePart */ 0, QByteArray(1024, char(1)), /* requestId */ 2);
+    connection.uploadFile(/* fileId */ 10, /* filePart */ 1, QByteArray(1024, char(2)), /* requestId */ 2);
+
+    QCOMPARE(connection.requestedFilesCount(), 3);
+    QCOMPARE(connection.pendingPackagesCount(), 3);
+
+    // Not sent requests are just dropped, there is no answer to drop.
+    connection.cancelFileRequest(2);
+    QCOMPARE(connection.requestedFilesCount(), 1);
+    QCOMPARE(connection.pendingPackagesCount(), 1);
+
+    connection.cancelFileRequest(1);
+    QCOMPARE(connection.requestedFilesCount(), 0);
+    QCOMPARE(connection.pendingPackagesCount(), 0);
+
+    // Unknown request
+    connection.cancelFileRequest(1);
+    QCOMPARE(connection.pendingPackagesCount(), 0);
+}
+
+void tst_CTelegramConnection::testRequestCompression()
+{
+    CTestConnection connection;
+
+    TLVector<TLInputContact> contacts;
+    for (int i = 0; i < 100; ++i) {
+        TLInputContact contact;
+        contact.clientId = i;
+        contact.phone = QString(QLatin1String("+7900000%1")).arg(i, 4, 10, QLatin1Char('0'));
+        contact.firstName = QLatin1String("First");
+        contact.lastName = QLatin1String("Last");
+        contacts.append(contact);
+    }
+
+    QByteArray importRequest;
+    CTelegramStream importStream(&importRequest, /* write */ true);
+    importStream << TLValue::ContactsImportContacts;
+    importStream << contacts;
+    importStream << false;
+
+    // Disabled by default
+    QCOMPARE(connection.testCompressedPackage(importRequest), importRequest);
+
+    connection.setCompressionThreshold(1024);
+
+    const QByteArray packedRequest = connection.testCompressedPackage(importRequest);
+    QVERIFY(packedRequest.size() < importRequest.size());
+
+    CTelegramStream packedStream(packedRequest);
+    TLValue packedValue;
+    QByteArray packedData;
+    packedStream >> packedValue;
+    packedStream >> packedData;
+
+    QVERIFY(packedValue == TLValue::GzipPacked);
+    QCOMPARE(Utils::unpackGZip(packedData), importRequest);
+
+    // Small requests
+    QByteArray getStateRequest;
+    CTelegramStream getStateStream(&getStateRequest, /* write */ true);
+    getStateStream << TLValue::UpdatesGetState;
+    QCOMPARE(connection.testCompressedPackage(getStateRequest), getStateRequest);
+
+    // File parts are never compressed
+    QByteArray filePartRequest;
+    CTelegramStream filePartStream(&filePartRequest, /* write */ true);
+    filePartStream << TLValue::UploadSaveFilePart;
+    filePartStream << quint64(1);
+    filePartStream << quint32(0);
+    filePartStream << QByteArray(4096, char(0));
+    QCOMPARE(connection.testCompressedPackage(filePartRequest), filePartRequest);
+
+    // Not compressible data is sent as is
+    QByteArray randomData(4096, char(0));
+    Utils::randomBytes(&randomData);
+
+    QByteArray randomRequest;
+    CTelegramStream randomStream(&randomRequest, /* write */ true);
+    randomStream << TLValue::MessagesSendMessage;
+    randomStream << randomData;
+    QCOMPARE(connection.testCompressedPackage(randomRequest), randomRequest);
+}
+
+void tst_CTelegramConnection::testAesDecrypt()
+{
+    const SAesKey key(QByteArray(32, char(0x42)), QByteArray(32, char(0x24)));
+
+    QByteArray data;
+    for (int i = 0; i < 1024; ++i) {
+        data.append(char(i % 251));
+    }
+
+    const QByteArray encrypted = Utils::aesEncrypt(data, key);
+    QVERIFY(encrypted != data);
+
+    // The encrypted package is usually a raw data view of the received package.
+    const QByteArray encryptedView = QByteArray::fromRawData(encrypted.constData(), encrypted.size());
+    const QByteArray decrypted = Utils::aesDecrypt(encryptedView, key);
+
+    QCOMPARE(decrypted, data);
+    QCOMPARE(encryptedView, encrypted);
+}
+
 void tst_CTelegramConnection::testPQAuthRequest()
 {
     CTestConnection connection;
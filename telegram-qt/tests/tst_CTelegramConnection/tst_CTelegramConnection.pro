@@ -2,6 +2,11 @@ include(../tests.pri)
 
 TARGET = tst_telegramconnection
 SOURCES = tst_CTelegramConnection.cpp \
+    ../../CAppInformation.cpp \
+    ../../CRandomGenerator.cpp \
+    ../../CMessageIdWindow.cpp \
+    ../../CConnectionScheduler.cpp \
+    ../../CFloodWaitLimiter.cpp \
     ../../Utils.cpp \
     ../../TelegramUtils.cpp \
     ../../CTcpTransport.cpp \
@@ -9,9 +14,15 @@ SOURCES = tst_CTelegramConnection.cpp \
     ../../CTelegramStream.cpp \
     ../../CRawStream.cpp \
     ../../TLValues.cpp \
+    ../../TLViews.cpp \
     CTestConnection.cpp
 
 HEADERS += \
+    ../../CAppInformation.hpp \
+    ../../CRandomGenerator.hpp \
+    ../../CMessageIdWindow.hpp \
+    ../../CConnectionScheduler.hpp \
+    ../../CFloodWaitLimiter.hpp \
     ../../Utils.hpp \
     ../../TelegramUtils.hpp \
     ../../CTelegramConnection.hpp \
@@ -20,6 +31,8 @@ HEADERS += \
     ../../CTelegramStream.hpp \
     ../../CRawStream.hpp \
     ../../TLValues.hpp \
-    CTestConnection.hpp
+    ../../TLViews.hpp \
+    CTestConnection.hpp \
+    CTestTransport.hpp
 
 LIBS += -lz
@@ -18,8 +18,11 @@
 #include <QObject>
 
 #include "CTestDispatcher.hpp"
+#include "CTelegramStream.hpp"
+#include "Utils.hpp"
 
 #include <QBuffer>
+#include <QDateTime>
 #include <QTest>
 #include <QDebug>
 
@@ -31,6 +34,10 @@ public:
 
 private slots:
     void testUpdateDcOptions();
+    void testSecretKeepsServerSalts();
+    void testSecretRoundTrip();
+    void testLegacySecret_data();
+    void testLegacySecret();
 
 };
 
@@ -88,6 +95,199 @@ void tst_CTelegramDispatcher::testUpdateDcOptions()
     }
 }
 
+static QByteArray constructAuthKey(char seed)
+{
+    QByteArray result;
+
+    for (int i = 0; i < 256; ++i) {
+        result.append(char(seed + i));
+    }
+
+    return result;
+}
+
+static QByteArray constructConnectionRecord(quint32 flags, const TLDcOption &dcInfo, const QByteArray &authKey, quint64 serverSalt,
+                                            const TLVector<TLFutureSalt> &serverSalts, qint64 clockOffset)
+{
+    QByteArray output;
+    CTelegramStream outputStream(&output, /* write */ true);
+
+    outputStream << flags;
+    outputStream << dcInfo;
+    outputStream << authKey;
+    outputStream << Utils::getFingersprint(authKey);
+    outputStream << serverSalt;
+    outputStream << serverSalts;
+    outputStream << clockOffset;
+
+    return output;
+}
+
+static const quint32 signedInRecord = 1 << 0;
+
+static QByteArray constructSecret(quint32 activeDc, const QList<QByteArray> &records,
+                                  quint32 pts = 10, quint32 qts = 20, quint32 date = 30, const TLVector<quint32> &chatIds = TLVector<quint32>())
+{
+    QByteArray output;
+    CTelegramStream outputStream(&output, /* write */ true);
+
+    outputStream << quint32(5); // Format
+    outputStream << activeDc;
+    outputStream << pts;
+    outputStream << qts;
+    outputStream << date;
+    outputStream << chatIds;
+    outputStream << quint32(records.count());
+
+    foreach (const QByteArray &record, records) {
+        outputStream << record;
+    }
+
+    return output;
+}
+
+void tst_CTelegramDispatcher::testSecretKeepsServerSalts()
+{
+    const quint32 now = QDateTime::currentMSecsSinceEpoch() / 1000;
+
+    TLVector<TLFutureSalt> salts;
+
+    for (int i = 0; i < 3; ++i) {
+        TLFutureSalt salt;
+        salt.validSince = now + i * 1800;
+        salt.validUntil = now + (i + 1) * 1800;
+        salt.salt = 100 + i;
+        salts.append(salt);
+    }
+
+    const QByteArray secret = constructSecret(2, QList<QByteArray>()
+                                              << constructConnectionRecord(signedInRecord, constructDcOption(2, QString(), QLatin1String("127.0.0.1"), 443),
+                                                                           constructAuthKey(1), 99, salts, -1500));
+
+    CTestDispatcher dispatcher;
+    QVERIFY(dispatcher.restoreConnection(secret));
+
+    // The connection is not established yet, so the schedule is exactly the same
+    QCOMPARE(dispatcher.connectionSecretInfo(), secret);
+}
+
+void tst_CTelegramDispatcher::testSecretRoundTrip()
+{
+    const TLDcOption dc2 = constructDcOption(2, QString(), QLatin1String("127.0.0.1"), 443);
+    const TLDcOption dc4 = constructDcOption(4, QString(), QLatin1String("127.0.0.2"), 443);
+    const TLDcOption dc5 = constructDcOption(5, QString(), QLatin1String("127.0.0.3"), 443);
+
+    const QByteArray activeRecord = constructConnectionRecord(signedInRecord, dc2, constructAuthKey(1), 21, TLVector<TLFutureSalt>(), 1000);
+    const QByteArray extraRecord = constructConnectionRecord(signedInRecord, dc4, constructAuthKey(2), 41, TLVector<TLFutureSalt>(), -2000);
+    const QByteArray notSignedInRecord = constructConnectionRecord(0, dc5, constructAuthKey(3), 51, TLVector<TLFutureSalt>(), 0);
+
+    TLVector<quint32> chatIds;
+    chatIds << 7 << 8;
+
+    // The extra DC is kept, even if it is not connected yet
+    const QByteArray secret = constructSecret(2, QList<QByteArray>() << activeRecord << extraRecord, 10, 20, 30, chatIds);
+
+    CTestDispatcher dispatcher;
+    QVERIFY(dispatcher.restoreConnection(secret));
+    QCOMPARE(dispatcher.connectionSecretInfo(), secret);
+
+    // Not authorized and broken records are skipped
+    const QByteArray secretWithBrokenRecords = constructSecret(2, QList<QByteArray>() << activeRecord << notSignedInRecord
+                                                               << extraRecord.left(extraRecord.size() / 2), 10, 20, 30, chatIds);
+
+    CTestDispatcher anotherDispatcher;
+    QVERIFY(anotherDispatcher.restoreConnection(secretWithBrokenRecords));
+    QCOMPARE(anotherDispatcher.connectionSecretInfo(), constructSecret(2, QList<QByteArray>() << activeRecord, 10, 20, 30, chatIds));
+
+    // There is no record for the active DC
+    CTestDispatcher brokenDispatcher;
+    QVERIFY(!brokenDispatcher.restoreConnection(constructSecret(2, QList<QByteArray>() << extraRecord)));
+}
+
+void tst_CTelegramDispatcher::testLegacySecret_data()
+{
+    QTest::addColumn<quint32>("format");
+
+    QTest::newRow("Format 0") << quint32(0);
+    QTest::newRow("Format 1") << quint32(1);
+    QTest::newRow("Format 2") << quint32(2);
+    QTest::newRow("Format 3") << quint32(3);
+    QTest::newRow("Format 4") << quint32(4);
+}
+
+void tst_CTelegramDispatcher::testLegacySecret()
+{
+    QFETCH(quint32, format);
+
+    const TLDcOption dcInfo = constructDcOption(2, QString(), QLatin1String("127.0.0.1"), 443);
+    const QByteArray authKey = constructAuthKey(1);
+    const qint32 deltaTime = -15;
+
+    TLVector<quint32> chatIds;
+    chatIds << 7 << 8;
+
+    TLFutureSalt salt;
+    salt.validSince = QDateTime::currentMSecsSinceEpoch() / 1000;
+    salt.validUntil = salt.validSince + 1800;
+    salt.salt = 22;
+
+    TLVector<TLFutureSalt> salts;
+    salts << salt;
+
+    QByteArray secret;
+    CTelegramStream outputStream(&secret, /* write */ true);
+
+    outputStream << format;
+    outputStream << deltaTime;
+    outputStream << dcInfo;
+
+    if (format < 3) {
+        outputStream << QString(QLatin1String("+71234567890"));
+    }
+
+    outputStream << authKey;
+    outputStream << Utils::getFingersprint(authKey);
+    outputStream << quint64(21);
+
+    if (format >= 1) {
+        outputStream << quint32(10);
+        outputStream << quint32(20);
+        outputStream << quint32(30);
+    }
+
+    if (format >= 2) {
+        outputStream << chatIds;
+    }
+
+    if (format >= 4) {
+        outputStream << salts;
+    }
+
+    CTestDispatcher dispatcher;
+    QVERIFY(dispatcher.restoreConnection(secret));
+
+    // The legacy secret is saved in the current format with the same data
+    const QByteArray record = constructConnectionRecord(signedInRecord, dcInfo, authKey, 21,
+                                                        format >= 4 ? salts : TLVector<TLFutureSalt>(), qint64(deltaTime) * 1000);
+
+    QByteArray expectedSecret;
+
+    if (format >= 1) {
+        expectedSecret = constructSecret(2, QList<QByteArray>() << record, 10, 20, 30, format >= 2 ? chatIds : TLVector<quint32>());
+    } else {
+        expectedSecret = constructSecret(2, QList<QByteArray>() << record, 1, 1, 1);
+    }
+
+    QCOMPARE(dispatcher.connectionSecretInfo(), expectedSecret);
+
+    // Broken auth id
+    QByteArray brokenSecret = secret;
+    brokenSecret[brokenSecret.indexOf(authKey) + authKey.size()] = char(brokenSecret.at(brokenSecret.indexOf(authKey) + authKey.size()) + 1);
+
+    CTestDispatcher brokenDispatcher;
+    QVERIFY(!brokenDispatcher.restoreConnection(brokenSecret));
+}
+
 QTEST_MAIN(tst_CTelegramDispatcher)
 
 #include "tst_CTelegramDispatcher.moc"
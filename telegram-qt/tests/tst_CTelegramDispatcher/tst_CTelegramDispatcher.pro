@@ -3,6 +3,10 @@ include(../tests.pri)
 TARGET = tst_telegramdispatcher
 SOURCES = tst_CTelegramDispatcher.cpp \
     CTestDispatcher.cpp \
+    ../../CRandomGenerator.cpp \
+    ../../CMessageIdWindow.cpp \
+    ../../CConnectionScheduler.cpp \
+    ../../CFloodWaitLimiter.cpp \
     ../../Utils.cpp \
     ../../TelegramUtils.cpp \
     ../../CTcpTransport.cpp \
@@ -10,10 +14,15 @@ SOURCES = tst_CTelegramDispatcher.cpp \
     ../../CTelegramStream.cpp \
     ../../CTelegramDispatcher.cpp \
     ../../CRawStream.cpp \
-    ../../TLValues.cpp
+    ../../TLValues.cpp \
+    ../../TLViews.cpp
 
 HEADERS += \
     CTestDispatcher.hpp \
+    ../../CRandomGenerator.hpp \
+    ../../CMessageIdWindow.hpp \
+    ../../CConnectionScheduler.hpp \
+    ../../CFloodWaitLimiter.hpp \
     ../../Utils.hpp \
     ../../TelegramUtils.hpp \
     ../../CTelegramConnection.hpp \
@@ -22,6 +31,7 @@ HEADERS += \
     ../../CTelegramStream.hpp \
     ../../CTelegramDispatcher.hpp \
     ../../CRawStream.hpp \
-    ../../TLValues.hpp
+    ../../TLValues.hpp \
+    ../../TLViews.hpp
 
 LIBS += -lz
@@ -18,6 +18,7 @@
 #include <QObject>
 
 #include "CTelegramStream.hpp"
+#include "TLViews.hpp"
 
 #include <QBuffer>
 #include <QTest>
@@ -41,10 +42,26 @@ private slots:
     void longStringSerialization();
     void intSerialization();
     void vectorOfIntsSerialization();
+    void bigVectorOfIntsSerialization();
     void vectorDeserializationError();
+    void readToExistingValue();
+    void optionalMembers();
+    void sharedValue();
     void tlNumbersSerialization();
     void tlDcOptionDeserialization();
     void readError();
+    void serializedSize();
+    void memoryBlockRead();
+    void parseUpdatesDifference_data();
+    void parseUpdatesDifference();
+    void updatesDifferenceView();
+    void messageViewFlags();
+    void parseUpdatesDifferenceView();
+    void utf8Strings();
+    void stringDecoding_data();
+    void stringDecoding();
+    void stringEncoding_data();
+    void stringEncoding();
 
 };
 
@@ -53,6 +70,63 @@ tst_CTelegramStream::tst_CTelegramStream(QObject *parent) :
 {
 }
 
+static QByteArray recordedUpdatesDifference()
+{
+    // The same layout as the difference received after a day of being offline.
+    static const int messagesCount = 100;
+    static const int usersCount = 20;
+
+    QByteArray data;
+    CTelegramStream stream(&data, /* write */ true);
+
+    stream << TLValue::UpdatesDifference;
+
+    stream << TLValue::Vector;
+    stream << quint32(messagesCount);
+    for (int i = 0; i < messagesCount; ++i) {
+        stream << TLValue::Message;
+        stream << quint32(0); // flags
+        stream << quint32(100000 + i); // id
+        stream << quint32(1000 + i % usersCount); // fromId
+        stream << TLValue::PeerUser;
+        stream << quint32(1000); // toId.userId
+        stream << quint32(1420000000 + i); // date
+        stream << QString(QLatin1String("Message text number %1, which is a bit longer than a short answer.")).arg(i);
+        stream << TLValue::MessageMediaEmpty;
+    }
+
+    stream << TLValue::Vector; // newEncryptedMessages
+    stream << quint32(0);
+    stream << TLValue::Vector; // otherUpdates
+    stream << quint32(0);
+    stream << TLValue::Vector; // chats
+    stream << quint32(0);
+
+    stream << TLValue::Vector;
+    stream << quint32(usersCount);
+    for (int i = 0; i < usersCount; ++i) {
+        stream << TLValue::UserContact;
+        stream << quint32(1000 + i); // id
+        stream << QString(QLatin1String("First%1")).arg(i);
+        stream << QString(QLatin1String("Last%1")).arg(i);
+        stream << QString(QLatin1String("username%1")).arg(i);
+        stream << quint64(0x1234567890abcdefull + i); // accessHash
+        stream << QString(QLatin1String("7900000%1")).arg(i, 4, 10, QLatin1Char('0'));
+        stream << TLValue::UserProfilePhotoEmpty;
+        stream << TLValue::UserStatusOffline;
+        stream << quint32(1420000000 + i); // wasOnline
+    }
+
+    stream << TLValue::UpdatesState;
+    stream << quint32(200); // pts
+    stream << quint32(0); // qts
+    stream << quint32(1420000100); // date
+    stream << quint32(300); // seq
+    stream << quint32(5); // unreadCount
+
+    return data;
+}
+
 void tst_CTelegramStream::shortStringSerialization()
 {
     QList<STestData> data;
@@ -300,6 +374,56 @@ void tst_CTelegramStream::vectorOfIntsSerialization()
     }
 }
 
+void tst_CTelegramStream::bigVectorOfIntsSerialization()
+{
+    // Ids and acks vectors are written and read as one block of memory.
+    TLVector<quint32> ids;
+    TLVector<quint64> acks;
+
+    for (int i = 0; i < 1000; ++i) {
+        ids.append(0x10000 + i);
+        acks.append(Q_UINT64_C(0x5000000000000000) + i * 4);
+    }
+
+    QByteArray data;
+    CTelegramStream output(&data, /* write */ true);
+
+    output << ids;
+    output << acks;
+
+    QCOMPARE(data.size(), CTelegramStream::serializedSize(ids) + CTelegramStream::serializedSize(acks));
+    QCOMPARE(data.size(), 4 + 4 + 1000 * 4 + 4 + 4 + 1000 * 8);
+
+    // The same encoding, as the element by element one
+    CTelegramStream elementsInput(data);
+    TLValue vectorType;
+    quint32 count;
+    quint32 firstId;
+    elementsInput >> vectorType;
+    elementsInput >> count;
+    elementsInput >> firstId;
+    QCOMPARE(quint32(vectorType), quint32(TLValue::Vector));
+    QCOMPARE(count, quint32(1000));
+    QCOMPARE(firstId, quint32(0x10000));
+
+    CTelegramStream input(data);
+    TLVector<quint32> readIds;
+    TLVector<quint64> readAcks;
+
+    input >> readIds;
+    input >> readAcks;
+
+    QVERIFY(!input.error());
+    QVERIFY(input.atEnd());
+    QCOMPARE(readIds, ids);
+    QCOMPARE(readAcks, acks);
+
+    // Truncated block
+    CTelegramStream truncatedInput(data.left(4 + 4 + 999 * 4));
+    truncatedInput >> readIds;
+    QVERIFY2(truncatedInput.error(), "Partial read, error should be set.");
+}
+
 void tst_CTelegramStream::vectorDeserializationError()
 {
     TLVector<quint32> vector;
@@ -314,6 +438,143 @@ void tst_CTelegramStream::vectorDeserializationError()
     }
 }
 
+void tst_CTelegramStream::readToExistingValue()
+{
+    // The values are read in place, so nothing should be left from the previous values.
+    TLMessage message;
+    message.tlType = TLValue::Message;
+    message.id = 1;
+    message.fromId = 2;
+    message.message = QLatin1String("Previous message");
+    message.media->tlType = TLValue::MessageMediaPhoto;
+
+    TLVector<quint32> vector;
+    vector << 1 << 2 << 3;
+
+    QByteArray data;
+    CTelegramStream output(&data, /* write */ true);
+    output << TLValue::MessageEmpty;
+    output << quint32(10); // id
+    output << TLValue::Vector;
+    output << quint32(1);
+    output << quint32(20);
+
+    CTelegramStream input(data);
+    input >> message;
+    input >> vector;
+
+    QVERIFY(!input.error());
+    QCOMPARE(quint32(message.tlType), quint32(TLValue::MessageEmpty));
+    QCOMPARE(message.id, quint32(10));
+    QCOMPARE(message.fromId, quint32(0));
+    QVERIFY(message.message.isEmpty());
+    QCOMPARE(quint32(message.media->tlType), quint32(TLMessageMedia().tlType));
+    QCOMPARE(vector.count(), 1);
+    QCOMPARE(vector.at(0), quint32(20));
+
+    // Broken vector length
+    QByteArray brokenData;
+    CTelegramStream brokenOutput(&brokenData, /* write */ true);
+    brokenOutput << TLValue::Vector;
+    brokenOutput << quint32(0x10000000);
+    brokenOutput << quint32(20);
+
+    CTelegramStream brokenInput(brokenData);
+    brokenInput >> vector;
+
+    QVERIFY2(brokenInput.error(), "The vector length is more than the data, error should be set.");
+    QVERIFY(vector.isEmpty());
+}
+
+void tst_CTelegramStream::optionalMembers()
+{
+    QCOMPARE(sizeof(TLOptional<TLPhoto>), sizeof(void *));
+
+    // A null member reads as a default one and the const access does not allocate it
+    const TLMessage emptyMessage;
+    QVERIFY(emptyMessage.media.isNull());
+    QCOMPARE(quint32(emptyMessage.media->tlType), quint32(TLMessageMedia().tlType));
+    QVERIFY(emptyMessage.media->caption.isEmpty());
+    QVERIFY(emptyMessage.media.isNull());
+
+    // Copies share the member until one of them is changed
+    TLMessage message;
+    message.media->caption = QLatin1String("Caption");
+    TLMessage messageCopy = message;
+    messageCopy.media->caption = QLatin1String("Another caption");
+    QCOMPARE(message.media->caption, QLatin1String("Caption"));
+    QCOMPARE(messageCopy.media->caption, QLatin1String("Another caption"));
+
+    // Only the members of the read constructor are allocated
+    QByteArray data;
+    CTelegramStream output(&data, /* write */ true);
+    output << TLValue::MessageMediaGeo;
+    output << TLValue::GeoPoint;
+    output << double(27.5);
+    output << double(53.9);
+
+    CTelegramStream input(data);
+    TLMessageMedia media;
+    input >> media;
+
+    QVERIFY(!input.error());
+    QVERIFY(input.atEnd());
+    QCOMPARE(quint32(media.tlType), quint32(TLValue::MessageMediaGeo));
+    QCOMPARE(media.geo->longitude, 27.5);
+    QCOMPARE(media.geo->latitude, 53.9);
+    QVERIFY(media.photo.isNull());
+    QVERIFY(media.video.isNull());
+    QVERIFY(media.document.isNull());
+
+    // Null members are written as the default ones
+    TLInputMedia inputMedia;
+    inputMedia.tlType = TLValue::InputMediaGeoPoint;
+
+    QByteArray inputMediaData;
+    CTelegramStream inputMediaOutput(&inputMediaData, /* write */ true);
+    inputMediaOutput << inputMedia;
+
+    QCOMPARE(inputMediaData.size(), CTelegramStream::serializedSize(inputMedia));
+    QCOMPARE(inputMediaData.size(), 8);
+    QVERIFY(inputMedia.geoPoint.isNull());
+}
+
+void tst_CTelegramStream::sharedValue()
+{
+    QByteArray data;
+    CTelegramStream output(&data, /* write */ true);
+    output << TLValue::UpdateShortMessage;
+    output << quint32(0); // flags
+    output << quint32(10); // id
+    output << quint32(20); // userId
+    output << QString(QLatin1String("Message"));
+    output << quint32(30); // pts
+    output << quint32(1); // ptsCount
+    output << quint32(40); // date
+
+    TLShared<TLUpdates> updates;
+    CTelegramStream input(data);
+    input >> updates;
+
+    QVERIFY(!input.error());
+    QVERIFY(input.atEnd());
+    QCOMPARE(quint32(updates->tlType), quint32(TLValue::UpdateShortMessage));
+    QCOMPARE(updates->message, QLatin1String("Message"));
+
+    // A copy shares the value
+    const TLShared<TLUpdates> original = updates;
+    const TLShared<TLUpdates> copy = original;
+    QCOMPARE(&*copy, &*original);
+
+    // ... until it is changed
+    TLShared<TLUpdates> changedCopy = original;
+    changedCopy->message = QLatin1String("Another message");
+    QVERIFY(&*changedCopy != &*original);
+    QCOMPARE(original->message, QLatin1String("Message"));
+    QCOMPARE(changedCopy->message, QLatin1String("Another message"));
+    QCOMPARE(changedCopy->pts, quint32(30));
+}
+
 void tst_CTelegramStream::tlNumbersSerialization()
 {
     QVector<TLNumber128> vector128;
@@ -461,6 +722,411 @@ void tst_CTelegramStream::readError()
 
 }
 
+void tst_CTelegramStream::serializedSize()
+{
+    QList<QByteArray> arrays;
+    for (int length = 0; length < 300; ++length) {
+        arrays.append(QByteArray(length, char('b')));
+    }
+
+    foreach (const QByteArray &array, arrays) {
+        QByteArray output;
+        CTelegramStream stream(&output, /* write */ true);
+        stream << array;
+
+        QCOMPARE(CTelegramStream::serializedSize(array), output.size());
+    }
+
+    QStringList strings;
+    strings << QString();
+    strings << QLatin1String("Hello");
+    strings << QString::fromUtf8("\xd0\x9f\xd1\x80\xd0\xb8\xd0\xb2\xd0\xb5\xd1\x82"); // Cyrillic
+    strings << QString::fromUtf8("\xe4\xbd\xa0\xe5\xa5\xbd"); // CJK
+    strings << QString::fromUtf8("Smile \xf0\x9f\x98\x80"); // Surrogate pair
+    strings << QString(300, QChar(0x44f));
+
+    foreach (const QString &string, strings) {
+        QByteArray output;
+        CTelegramStream stream(&output, /* write */ true);
+        stream << string;
+
+        QCOMPARE(CTelegramStream::serializedSize(string), output.size());
+    }
+
+    TLInputPeer peer;
+    peer.tlType = TLValue::InputPeerForeign;
+    peer.userId = 1000;
+    peer.accessHash = 0x1234567890abcdefull;
+
+    TLVector<quint64> ids;
+    ids << 1 << 2 << 3;
+
+    TLVector<TLInputUser> users;
+    TLInputUser user;
+    user.tlType = TLValue::InputUserContact;
+    user.userId = 1000;
+    users.append(user);
+    user.tlType = TLValue::InputUserSelf;
+    users.append(user);
+
+    QByteArray output;
+    CTelegramStream stream(&output, /* write */ true);
+    stream << peer;
+    stream << ids;
+    stream << users;
+
+    QCOMPARE(CTelegramStream::serializedSize(peer) + CTelegramStream::serializedSize(ids) + CTelegramStream::serializedSize(users), output.size());
+}
+
+void tst_CTelegramStream::memoryBlockRead()
+{
+    static const char input[16] = { char(5), 't', 'e', 's', 't', '5', 0, 0,
+                                    char(0xef), char(0xbe), char(0xad), char(0xde), 1, 2, 3, 4 };
+
+    CTelegramStream stream(input, sizeof(input));
+
+    QCOMPARE(stream.bytesRemaining(), 16);
+
+    const QByteArray view = stream.readByteArrayView();
+    QCOMPARE(view, QByteArray("test5"));
+    QVERIFY2(view.constData() == input + 1, "The view should point to the source data");
+    QCOMPARE(stream.bytesRemaining(), 8);
+
+    quint32 value;
+    stream >> value;
+    QCOMPARE(value, quint32(0xdeadbeef));
+
+    QCOMPARE(stream.readBytesView(2), QByteArray("\x01\x02"));
+    QVERIFY(!stream.error());
+
+    QCOMPARE(stream.readBytesView(4), QByteArray("\x03\x04"));
+    QVERIFY2(stream.error(), "Partial read, error should be set.");
+    QVERIFY(stream.atEnd());
+
+    // The bytes members must not refer to the source data, which can be released right after the read.
+    char source[sizeof(input)];
+    memcpy(source, input, sizeof(input));
+
+    QByteArray bytes;
+    CTelegramStream sourceStream(source, sizeof(source));
+    sourceStream >> bytes;
+    memset(source, 0, sizeof(source));
+
+    QCOMPARE(bytes, QByteArray("test5"));
+}
+
+void tst_CTelegramStream::parseUpdatesDifference_data()
+{
+    QTest::addColumn<bool>("useDevice");
+
+    QTest::newRow("QIODevice") << true;
+    QTest::newRow("Memory block") << false;
+}
+
+void tst_CTelegramStream::parseUpdatesDifference()
+{
+    QFETCH(bool, useDevice);
+
+    const QByteArray data = recordedUpdatesDifference();
+
+    TLUpdatesDifference difference;
+
+    QBENCHMARK {
+        if (useDevice) {
+            QBuffer device;
+            device.setData(data);
+            device.open(QBuffer::ReadOnly);
+
+            CTelegramStream stream(&device);
+            stream >> difference;
+            QVERIFY(!stream.error());
+        } else {
+            CTelegramStream stream(data);
+            stream >> difference;
+            QVERIFY(!stream.error());
+        }
+    }
+
+    QCOMPARE(quint32(difference.tlType), quint32(TLValue::UpdatesDifference));
+    QCOMPARE(difference.newMessages.count(), 100);
+    QCOMPARE(difference.newMessages.at(99).id, quint32(100099));
+    QCOMPARE(difference.newMessages.at(99).toId->userId, quint32(1000));
+    QCOMPARE(difference.newMessages.at(99).message, QString(QLatin1String("Message text number 99, which is a bit longer than a short answer.")));
+    QCOMPARE(difference.users.count(), 20);
+    QCOMPARE(difference.users.at(19).phone, QString(QLatin1String("79000000019")));
+    QCOMPARE(difference.users.at(19).status->wasOnline, quint32(1420000019));
+    QCOMPARE(difference.state->seq, quint32(300));
+}
+
+void tst_CTelegramStream::updatesDifferenceView()
+{
+    const QByteArray data = recordedUpdatesDifference();
+
+    TLUpdatesDifference difference;
+    TLUpdatesDifferenceView view;
+
+    {
+        CTelegramStream stream(data);
+        stream >> difference;
+        QVERIFY(!stream.error());
+    }
+
+    {
+        CTelegramStream stream(data);
+        stream >> view;
+        QVERIFY(!stream.error());
+        QVERIFY(stream.atEnd());
+    }
+
+    QVERIFY(view.isValid());
+    QCOMPARE(view.size(), data.size());
+    QCOMPARE(quint32(view.tlType()), quint32(TLValue::UpdatesDifference));
+
+    const TLVector<TLMessageView> messages = view.newMessages();
+    QCOMPARE(messages.count(), difference.newMessages.count());
+
+    for (int i = 0; i < messages.count(); ++i) {
+        const TLMessage &message = difference.newMessages.at(i);
+        QCOMPARE(quint32(messages.at(i).tlType()), quint32(message.tlType));
+        QCOMPARE(messages.at(i).id(), message.id);
+        QCOMPARE(messages.at(i).fromId(), message.fromId);
+        QCOMPARE(messages.at(i).date(), message.date);
+        QCOMPARE(messages.at(i).message(), message.message);
+        QCOMPARE(messages.at(i).toId().userId, message.toId->userId);
+        QCOMPARE(messages.at(i).toStruct().message, message.message);
+    }
+
+    QCOMPARE(view.users().count(), difference.users.count());
+    QCOMPARE(view.users().at(19).phone, difference.users.at(19).phone);
+    QCOMPARE(view.state().seq, difference.state->seq);
+    QCOMPARE(view.toStruct().state->pts, difference.state->pts);
+
+    {
+        // The stream reads a view of a buffer, which is reused later, so the view keeps a copy of the data.
+        QByteArray buffer(data.constData(), data.size());
+        TLUpdatesDifferenceView copiedView;
+
+        {
+            CTelegramStream stream(QByteArray::fromRawData(buffer.constData(), buffer.size()));
+            stream >> copiedView;
+            QVERIFY(stream.atEnd());
+        }
+
+        buffer.fill(char(0));
+
+        QVERIFY(copiedView.isValid());
+        QCOMPARE(copiedView.users().at(19).phone, difference.users.at(19).phone);
+        QCOMPARE(copiedView.state().seq, difference.state->seq);
+    }
+
+    {
+        // The stream owns the data, so it is shared with the view; the object starts at the stream position.
+        QByteArray buffer;
+        CTelegramStream prefixStream(&buffer, /* write */ true);
+        prefixStream << quint32(0xdeadbeef);
+        buffer.append(data);
+
+        TLUpdatesDifferenceView sharedView;
+        CTelegramStream stream(buffer);
+        quint32 prefix;
+        stream >> prefix;
+        stream >> sharedView;
+
+        QVERIFY(!stream.error());
+        QVERIFY(stream.atEnd());
+        QVERIFY(sharedView.isValid());
+        QCOMPARE(sharedView.size(), data.size());
+        QCOMPARE(sharedView.newMessages().count(), difference.newMessages.count());
+        QCOMPARE(sharedView.users().at(19).phone, difference.users.at(19).phone);
+        QCOMPARE(sharedView.toStruct().state->pts, difference.state->pts);
+    }
+
+    {
+        CTelegramStream stream(data.left(data.size() - 4));
+        TLUpdatesDifferenceView brokenView;
+        stream >> brokenView;
+        QVERIFY2(stream.error(), "Incomplete data, error should be set.");
+        QVERIFY(!brokenView.isValid());
+        QVERIFY(brokenView.newMessages().isEmpty());
+    }
+}
+
+void tst_CTelegramStream::messageViewFlags()
+{
+    QByteArray data;
+    CTelegramStream output(&data, /* write */ true);
+
+    output << TLValue::Message;
+    output << quint32(1 << 2 | 1 << 3); // flags: forwarded reply
+    output << quint32(10); // id
+    output << quint32(20); // fromId
+    output << TLValue::PeerChat;
+    output << quint32(30); // toId.chatId
+    output << quint32(40); // fwdFromId
+    output << quint32(50); // fwdDate
+    output << quint32(9); // replyToMsgId
+    output << quint32(60); // date
+    output << QString(QLatin1String("text"));
+    output << TLValue::MessageMediaEmpty;
+
+    CTelegramStream stream(data);
+    TLMessageView view;
+    stream >> view;
+
+    QVERIFY(!stream.error());
+    QVERIFY(view.isValid());
+    QCOMPARE(view.toId().chatId, quint32(30));
+    QCOMPARE(view.fwdFromId(), quint32(40));
+    QCOMPARE(view.replyToMsgId(), quint32(9));
+    QCOMPARE(view.date(), quint32(60));
+    QCOMPARE(view.message(), QString(QLatin1String("text")));
+    QCOMPARE(quint32(view.media().tlType), quint32(TLValue::MessageMediaEmpty));
+    QCOMPARE(quint32(view.action().tlType), quint32(TLMessageAction().tlType));
+}
+
+void tst_CTelegramStream::parseUpdatesDifferenceView()
+{
+    const QByteArray data = recordedUpdatesDifference();
+
+    int outgoingMessages = 0;
+
+    QBENCHMARK {
+        CTelegramStream stream(data);
+        TLUpdatesDifferenceView view;
+        stream >> view;
+        QVERIFY(!stream.error());
+
+        outgoingMessages = 0;
+
+        // Decode only the fields, which are needed to filter the messages.
+        foreach (const TLMessageView &message, view.newMessages()) {
+            if (message.fromId() == 1000) {
+                ++outgoingMessages;
+            }
+        }
+    }
+
+    QCOMPARE(outgoingMessages, 5);
+}
+
+void tst_CTelegramStream::utf8Strings()
+{
+    QStringList strings;
+    strings << QString()
+            << QLatin1String("a")
+            << QLatin1String("Exactly sixteen!")
+            << QLatin1String("A bit longer ASCII string, which takes a few SIMD blocks.")
+            << QString::fromUtf8("\xd0\x9f\xd1\x80\xd0\xb8\xd0\xb2\xd0\xb5\xd1\x82")
+            << QString::fromUtf8("ASCII prefix, which is long enough, then \xe4\xb8\xad\xe6\x96\x87")
+            << QString::fromUtf8("\xf0\x9f\x98\x80 \xf0\x9f\x91\x8d")
+            << (QString(QLatin1String("lone surrogate ")) + QChar(0xd800))
+            << (QString(QLatin1String("nul")) + QChar(0) + QLatin1String("inside"));
+
+    foreach (const QString &string, strings) {
+        QByteArray data;
+        CTelegramStream output(&data, /* write */ true);
+        output << string;
+
+        QByteArray expectedData;
+        CTelegramStream expectedOutput(&expectedData, /* write */ true);
+        expectedOutput << string.toUtf8();
+
+        QCOMPARE(data, expectedData);
+
+        CTelegramStream input(data);
+        QString result;
+        input >> result;
+
+        QCOMPARE(result, QString::fromUtf8(string.toUtf8()));
+    }
+
+    QList<QByteArray> encodedStrings;
+    encodedStrings << QByteArray("\xc0\xaf overlong")
+                   << QByteArray("truncated \xe4\xb8")
+                   << QByteArray("\xed\xa0\x80 encoded surrogate")
+                   << QByteArray("\xf4\x90\x80\x80 out of range")
+                   << QByteArray("\xef\xbb\xbf" "BOM")
+                   << QByteArray("\x80 continuation byte");
+
+    foreach (const QByteArray &encoded, encodedStrings) {
+        QByteArray data;
+        CTelegramStream output(&data, /* write */ true);
+        output << encoded;
+
+        CTelegramStream input(data);
+        QString result;
+        input >> result;
+
+        QCOMPARE(result, QString::fromUtf8(encoded));
+    }
+}
+
+void tst_CTelegramStream::stringDecoding_data()
+{
+    QTest::addColumn<QString>("text");
+
+    QTest::newRow("English") << QString::fromUtf8("See you tomorrow at six near the station, don't be late!");
+    QTest::newRow("Russian") << QString::fromUtf8("\xd0\xa3\xd0\xb2\xd0\xb8\xd0\xb4\xd0\xb8\xd0\xbc\xd1\x81\xd1\x8f \xd0\xb7\xd0\xb0\xd0\xb2\xd1\x82\xd1\x80\xd0\xb0 \xd0\xb2 \xd1\x88\xd0\xb5\xd1\x81\xd1\x82\xd1\x8c \xd1\x83 \xd0\xbc\xd0\xb5\xd1\x82\xd1\x80\xd0\xbe, \xd0\xbd\xd0\xb5 \xd0\xbe\xd0\xbf\xd0\xb0\xd0\xb7\xd0\xb4\xd1\x8b\xd0\xb2\xd0\xb0\xd0\xb9!");
+    QTest::newRow("Chinese") << QString::fromUtf8("\xe6\x98\x8e\xe5\xa4\xa9\xe5\x85\xad\xe7\x82\xb9\xe5\x9c\xa8\xe8\xbd\xa6\xe7\xab\x99\xe9\x99\x84\xe8\xbf\x91\xe8\xa7\x81\xef\xbc\x8c\xe5\x88\xab\xe8\xbf\x9f\xe5\x88\xb0\xef\xbc\x81");
+    QTest::newRow("Mixed with emoji") << QString::fromUtf8("Ok \xf0\x9f\x91\x8d \xd0\xb7\xd0\xb0\xd0\xb2\xd1\x82\xd1\x80\xd0\xb0 \xd0\xb2 6, \xe8\xbd\xa6\xe7\xab\x99 \xf0\x9f\x98\x80");
+}
+
+static TLVector<QString> messagesCorpus(const QString &text)
+{
+    // Message texts, names and usernames of a history page
+    TLVector<QString> corpus;
+
+    for (int i = 0; i < 100; ++i) {
+        corpus.append(QString(QLatin1String("%1 (%2)")).arg(text).arg(i));
+        corpus.append(text.left(i % 16));
+        corpus.append(QString(QLatin1String("username%1")).arg(i));
+    }
+
+    return corpus;
+}
+
+void tst_CTelegramStream::stringDecoding()
+{
+    QFETCH(QString, text);
+
+    const TLVector<QString> corpus = messagesCorpus(text);
+
+    QByteArray data;
+    CTelegramStream output(&data, /* write */ true);
+    output << corpus;
+
+    TLVector<QString> result;
+
+    QBENCHMARK {
+        CTelegramStream stream(data);
+        stream >> result;
+    }
+
+    QCOMPARE(result, corpus);
+}
+
+void tst_CTelegramStream::stringEncoding_data()
+{
+    stringDecoding_data();
+}
+
+void tst_CTelegramStream::stringEncoding()
+{
+    QFETCH(QString, text);
+
+    const TLVector<QString> corpus = messagesCorpus(text);
+
+    QByteArray data;
+
+    QBENCHMARK {
+        data.clear();
+        CTelegramStream stream(&data, /* write */ true);
+        stream << corpus;
+    }
+
+    QCOMPARE(data.size(), CTelegramStream::serializedSize(corpus));
+}
+
 QTEST_MAIN(tst_CTelegramStream)
 
 #include "tst_CTelegramStream.moc"
@@ -3,8 +3,10 @@ include(../tests.pri)
 TARGET = tst_telegramsteam
 SOURCES = tst_CTelegramStream.cpp \
     ../../CTelegramStream.cpp \
-    ../../CRawStream.cpp
+    ../../CRawStream.cpp \
+    ../../TLViews.cpp
 
 HEADERS = \
     ../../CTelegramStream.hpp \
-    ../../CRawStream.hpp
+    ../../CRawStream.hpp \
+    ../../TLViews.hpp
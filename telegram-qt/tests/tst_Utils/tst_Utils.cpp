@@ -0,0 +1,66 @@
+/*
+   Copyright (C) 2015 Alexandr Akulich <akulichalexander@gmail.com>
+
+   This file is a part of TelegramQt library.
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+ */
+
+#include <QObject>
+
+#include "Utils.hpp"
+
+#include <QTest>
+#include <QDebug>
+
+class tst_Utils : public QObject
+{
+    Q_OBJECT
+public:
+    explicit tst_Utils(QObject *parent = 0);
+
+private slots:
+    void testUnpackGZip();
+
+};
+
+tst_Utils::tst_Utils(QObject *parent) :
+    QObject(parent)
+{
+}
+
+void tst_Utils::testUnpackGZip()
+{
+    QByteArray data;
+    for (int i = 0; i < 100000; ++i) {
+        data.append(QByteArray::number(i % 1000));
+    }
+
+    const QByteArray packedData = Utils::packGZip(data);
+    QVERIFY(packedData.size() < data.size());
+
+    QCOMPARE(Utils::unpackGZip(packedData), data);
+
+    // The inflate state is reused for the next package
+    const QByteArray smallData("Hello, world!");
+    QCOMPARE(Utils::unpackGZip(Utils::packGZip(smallData)), smallData);
+
+    // Truncated package
+    QVERIFY(Utils::unpackGZip(packedData.left(packedData.size() / 2)).isEmpty());
+
+    // Not a gzip package
+    QVERIFY(Utils::unpackGZip(data.left(1024)).isEmpty());
+}
+
+QTEST_MAIN(tst_Utils)
+
+#include "tst_Utils.moc"
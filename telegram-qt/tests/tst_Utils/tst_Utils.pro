@@ -0,0 +1,12 @@
+include(../tests.pri)
+
+TARGET = tst_utils
+SOURCES = tst_Utils.cpp \
+    ../../CRandomGenerator.cpp \
+    ../../Utils.cpp
+
+HEADERS = \
+    ../../CRandomGenerator.hpp \
+    ../../Utils.hpp
+
+LIBS += -lz
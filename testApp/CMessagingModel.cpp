@@ -30,6 +30,8 @@ QString messageDeliveryStatusStr(TelegramNamespace::MessageDeliveryStatus status
         return QLatin1String("Read");
     case TelegramNamespace::MessageDeliveryStatusDeleted:
         return QLatin1String("Deleted");
+    case TelegramNamespace::MessageDeliveryStatusFailed:
+        return QLatin1String("Failed");
     default:
         return QString();
     }